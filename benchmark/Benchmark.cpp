@@ -0,0 +1,482 @@
+#include "Generators.h"
+#include <matrec/Graphic.h>
+#include <matrec/Network.h>
+#include <cmr/graphic.h>
+#include <cmr/network.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+///Compares the time and the peak memory of CMR's and matrec's graphic and network recognition on the same instances.
+///Every run is done in a forked process, so that its peak memory can be measured separately. Only runs on Linux.
+
+enum class Algorithm {
+    CMR_GRAPHIC,
+    CMR_NETWORK,
+    MATREC_GRAPHIC_COLUMNS,
+    MATREC_GRAPHIC_ROWS,
+    MATREC_NETWORK_COLUMNS,
+    MATREC_NETWORK_ROWS
+};
+
+const Algorithm algorithms[] = {Algorithm::CMR_GRAPHIC, Algorithm::MATREC_GRAPHIC_COLUMNS,
+                                Algorithm::MATREC_GRAPHIC_ROWS, Algorithm::CMR_NETWORK,
+                                Algorithm::MATREC_NETWORK_COLUMNS, Algorithm::MATREC_NETWORK_ROWS};
+
+static const char * algorithmName(Algorithm algorithm){
+    switch(algorithm){
+        case Algorithm::CMR_GRAPHIC:
+            return "cmr-graphic";
+        case Algorithm::CMR_NETWORK:
+            return "cmr-network";
+        case Algorithm::MATREC_GRAPHIC_COLUMNS:
+            return "matrec-graphic-columns";
+        case Algorithm::MATREC_GRAPHIC_ROWS:
+            return "matrec-graphic-rows";
+        case Algorithm::MATREC_NETWORK_COLUMNS:
+            return "matrec-network-columns";
+        case Algorithm::MATREC_NETWORK_ROWS:
+            return "matrec-network-rows";
+    }
+    return "";
+}
+
+static bool isNetworkAlgorithm(Algorithm algorithm){
+    return algorithm == Algorithm::CMR_NETWORK || algorithm == Algorithm::MATREC_NETWORK_COLUMNS ||
+           algorithm == Algorithm::MATREC_NETWORK_ROWS;
+}
+
+struct Instance {
+    std::string name;
+    DirectedTestCase matrix;
+};
+
+struct Measurement {
+    int recognized;       ///1 if the matrix is graphic or network, 0 if not, and -1 if the run failed
+    double seconds;       ///Time of the recognition, without creating its input
+    long peakKB;          ///Peak resident memory of the run, minus the memory that was used before it started
+};
+
+struct Result {
+    const Instance * instance;
+    Algorithm algorithm;
+    int recognized;
+    double seconds;
+    long peakKB;          ///-1 if the peak memory could not be measured
+};
+
+static std::size_t numNonzeros(const DirectedTestCase & matrix){
+    std::size_t nonzeros = 0;
+    for(const auto & row : matrix.matrix){
+        nonzeros += row.size();
+    }
+    return nonzeros;
+}
+
+///Returns the value of a field of /proc/self/status in kilobytes, or -1 if it can not be read
+static long statusKB(const char * field){
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    std::size_t length = strlen(field);
+    while(std::getline(status, line)){
+        if(line.compare(0, length, field) == 0 && line.size() > length && line[length] == ':'){
+            return std::stol(line.substr(length + 1));
+        }
+    }
+    return -1;
+}
+
+///Measures the peak resident memory from the moment start() is called
+struct PeakMemory {
+    bool valid = false;
+    long baselineKB = 0;
+
+    ///Releases the free memory of the process and resets its peak resident memory
+    void start(){
+        malloc_trim(0);
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        clearRefs.close();
+        baselineKB = statusKB("VmRSS");
+        valid = !clearRefs.fail() && baselineKB >= 0;
+    }
+
+    ///Returns the peak memory since start() in kilobytes, or -1 if it could not be measured
+    long peakKB() const{
+        long peak = statusKB("VmHWM");
+        return valid && peak >= 0 ? std::max(0L, peak - baselineKB) : -1;
+    }
+};
+
+static CMR_ERROR runCMR(const DirectedTestCase & testCase, bool network, bool & recognized, double & seconds,
+                        PeakMemory & memory){
+    CMR * cmr = NULL;
+    CMR_CALL(CMRcreateEnvironment(&cmr));
+    CMR_CHRMAT * matrix = NULL;
+    CMR_CALL(CMRchrmatCreate(cmr, &matrix, testCase.rows, testCase.cols, numNonzeros(testCase)));
+    std::size_t entry = 0;
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        matrix->rowSlice[row] = entry;
+        for(const auto & nonzero : testCase.matrix[row]){
+            matrix->entryColumns[entry] = nonzero.index;
+            matrix->entryValues[entry] = network && nonzero.value < 0.0 ? -1 : 1;
+            ++entry;
+        }
+    }
+    matrix->rowSlice[testCase.rows] = entry;
+
+    memory.start();
+    auto start = std::chrono::steady_clock::now();
+    if(network){
+        CMR_NETWORK_STATISTICS stats;
+        CMR_CALL(CMRnetworkStatsInit(&stats));
+        CMR_CALL(CMRnetworkTestMatrix(cmr, matrix, &recognized, NULL, NULL, NULL, NULL, NULL, NULL, &stats,
+                                      std::numeric_limits<double>::infinity()));
+    }else{
+        CMR_GRAPHIC_STATISTICS stats;
+        CMR_CALL(CMRgraphicStatsInit(&stats));
+        CMR_CALL(CMRgraphicTestMatrix(cmr, matrix, &recognized, NULL, NULL, NULL, NULL, &stats,
+                                      std::numeric_limits<double>::infinity()));
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    CMR_CALL(CMRchrmatFree(cmr, &matrix));
+    CMR_CALL(CMRfreeEnvironment(&cmr));
+    return CMR_OKAY;
+}
+
+///Adds the columns or the rows one by one, until one of them can not be added
+static MATREC_ERROR runMatrec(const DirectedTestCase & testCase, Algorithm algorithm, bool & recognized,
+                              double & seconds, PeakMemory & memory){
+    //The nonzeros of the rows or columns which are added, in the order in which they are added
+    std::vector<std::vector<Nonzero>> lines;
+    if(algorithm == Algorithm::MATREC_GRAPHIC_COLUMNS || algorithm == Algorithm::MATREC_NETWORK_COLUMNS){
+        lines = DirectedColTestCase(testCase).matrix;
+    }else{
+        lines = testCase.matrix;
+    }
+    std::vector<std::vector<MATREC_matrix_size>> indices(lines.size());
+    std::vector<std::vector<double>> values(lines.size());
+    for(std::size_t line = 0; line < lines.size(); ++line){
+        for(const auto & nonzero : lines[line]){
+            indices[line].push_back(nonzero.index);
+            values[line].push_back(nonzero.value);
+        }
+    }
+    lines.clear();
+    lines.shrink_to_fit();
+
+    memory.start();
+    MATREC * env = NULL;
+    MATREC_CALL(MATRECcreateEnvironment(&env));
+    recognized = true;
+    auto start = std::chrono::steady_clock::now();
+    switch(algorithm){
+        case Algorithm::MATREC_GRAPHIC_COLUMNS:{
+            MATRECGraphicDecomposition * dec = NULL;
+            MATRECGraphicColumnAddition * newCol = NULL;
+            MATREC_CALL(MATRECGraphicDecompositionCreate(env, &dec, testCase.rows, testCase.cols));
+            MATREC_CALL(MATRECcreateGraphicColumnAddition(env, &newCol));
+            for(std::size_t col = 0; col < indices.size() && recognized; ++col){
+                MATREC_CALL(MATRECGraphicColumnAdditionCheck(dec, newCol, col, indices[col].data(), indices[col].size()));
+                recognized = MATRECGraphicColumnAdditionRemainsGraphic(newCol);
+                if(recognized){
+                    MATREC_CALL(MATRECGraphicColumnAdditionAdd(dec, newCol));
+                }
+            }
+            MATRECfreeGraphicColumnAddition(env, &newCol);
+            MATRECGraphicDecompositionFree(&dec);
+            break;
+        }
+        case Algorithm::MATREC_GRAPHIC_ROWS:{
+            MATRECGraphicDecomposition * dec = NULL;
+            MATRECGraphicRowAddition * newRow = NULL;
+            MATREC_CALL(MATRECGraphicDecompositionCreate(env, &dec, testCase.rows, testCase.cols));
+            MATREC_CALL(MATRECcreateGraphicRowAddition(env, &newRow));
+            for(std::size_t row = 0; row < indices.size() && recognized; ++row){
+                MATREC_CALL(MATRECGraphicRowAdditionCheck(dec, newRow, row, indices[row].data(), indices[row].size()));
+                recognized = MATRECGraphicRowAdditionRemainsGraphic(newRow);
+                if(recognized){
+                    MATREC_CALL(MATRECGraphicRowAdditionAdd(dec, newRow));
+                }
+            }
+            MATRECfreeGraphicRowAddition(env, &newRow);
+            MATRECGraphicDecompositionFree(&dec);
+            break;
+        }
+        case Algorithm::MATREC_NETWORK_COLUMNS:{
+            MATRECNetworkDecomposition * dec = NULL;
+            MATRECNetworkColumnAddition * newCol = NULL;
+            MATREC_CALL(MATRECNetworkDecompositionCreate(env, &dec, testCase.rows, testCase.cols));
+            MATREC_CALL(MATRECcreateNetworkColumnAddition(env, &newCol));
+            for(std::size_t col = 0; col < indices.size() && recognized; ++col){
+                MATREC_CALL(MATRECNetworkColumnAdditionCheck(dec, newCol, col, indices[col].data(), values[col].data(),
+                                                             indices[col].size()));
+                recognized = MATRECNetworkColumnAdditionRemainsNetwork(newCol);
+                if(recognized){
+                    MATREC_CALL(MATRECNetworkColumnAdditionAdd(dec, newCol));
+                }
+            }
+            MATRECfreeNetworkColumnAddition(env, &newCol);
+            MATRECNetworkDecompositionFree(&dec);
+            break;
+        }
+        case Algorithm::MATREC_NETWORK_ROWS:{
+            MATRECNetworkDecomposition * dec = NULL;
+            MATRECNetworkRowAddition * newRow = NULL;
+            MATREC_CALL(MATRECNetworkDecompositionCreate(env, &dec, testCase.rows, testCase.cols));
+            MATREC_CALL(MATRECcreateNetworkRowAddition(env, &newRow));
+            for(std::size_t row = 0; row < indices.size() && recognized; ++row){
+                MATREC_CALL(MATRECNetworkRowAdditionCheck(dec, newRow, row, indices[row].data(), values[row].data(),
+                                                          indices[row].size()));
+                recognized = MATRECNetworkRowAdditionRemainsNetwork(newRow);
+                if(recognized){
+                    MATREC_CALL(MATRECNetworkRowAdditionAdd(dec, newRow));
+                }
+            }
+            MATRECfreeNetworkRowAddition(env, &newRow);
+            MATRECNetworkDecompositionFree(&dec);
+            break;
+        }
+        default:
+            break;
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    MATREC_CALL(MATRECfreeEnvironment(&env));
+    return MATREC_OKAY;
+}
+
+///Runs the algorithm in a child process, and measures the peak memory of the child. Both the time and the peak memory
+///are measured after the input of the algorithm has been created
+static Result measure(const Instance & instance, Algorithm algorithm){
+    Result result{&instance, algorithm, -1, 0.0, -1};
+    int pipeEnds[2];
+    if(pipe(pipeEnds) != 0){
+        return result;
+    }
+    pid_t child = fork();
+    if(child < 0){
+        close(pipeEnds[0]);
+        close(pipeEnds[1]);
+        return result;
+    }
+    if(child == 0){
+        close(pipeEnds[0]);
+        PeakMemory memory;
+        Measurement measurement{-1, 0.0, -1};
+        bool recognized = false;
+        if(algorithm == Algorithm::CMR_GRAPHIC || algorithm == Algorithm::CMR_NETWORK){
+            if(runCMR(instance.matrix, algorithm == Algorithm::CMR_NETWORK, recognized, measurement.seconds,
+                      memory) == CMR_OKAY){
+                measurement.recognized = recognized ? 1 : 0;
+            }
+        }else if(runMatrec(instance.matrix, algorithm, recognized, measurement.seconds, memory) == MATREC_OKAY){
+            measurement.recognized = recognized ? 1 : 0;
+        }
+        measurement.peakKB = memory.peakKB();
+        ssize_t written = write(pipeEnds[1], &measurement, sizeof(measurement));
+        _exit(written == (ssize_t) sizeof(measurement) ? 0 : 1);
+    }
+    close(pipeEnds[1]);
+    Measurement measurement{-1, 0.0, -1};
+    bool received = read(pipeEnds[0], &measurement, sizeof(measurement)) == (ssize_t) sizeof(measurement);
+    close(pipeEnds[0]);
+    int status = 0;
+    if(waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || !received){
+        return result;
+    }
+    result.recognized = measurement.recognized;
+    result.seconds = measurement.seconds;
+    result.peakKB = measurement.peakKB;
+    return result;
+}
+
+///Reads a matrix in the sparse format which is also used by CMR: the numbers of rows, columns and nonzeros, followed
+///by the row, the column (both starting at 1) and the value of every nonzero
+static bool readSparseMatrix(const std::string & filename, std::vector<Instance> & instances){
+    std::ifstream stream(filename);
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t nonzeros = 0;
+    if(!(stream >> rows >> cols >> nonzeros)){
+        return false;
+    }
+    std::vector<std::vector<Nonzero>> matrix(rows);
+    for(std::size_t i = 0; i < nonzeros; ++i){
+        std::size_t row = 0;
+        std::size_t col = 0;
+        double value = 0.0;
+        if(!(stream >> row >> col >> value) || row < 1 || row > rows || col < 1 || col > cols){
+            return false;
+        }
+        if(value != 0.0){
+            matrix[row - 1].push_back(Nonzero{.index = col - 1, .value = value});
+        }
+    }
+    for(auto & nonzerosOfRow : matrix){
+        std::sort(nonzerosOfRow.begin(), nonzerosOfRow.end(), [](const Nonzero & first, const Nonzero & second){
+            return first.index < second.index;
+        });
+    }
+    std::string name = filename.substr(filename.find_last_of('/') + 1);
+    instances.push_back(Instance{name, DirectedTestCase(matrix, rows, cols)});
+    return true;
+}
+
+static void generateInstances(std::size_t scale, std::vector<Instance> & instances){
+    auto add = [&](const std::string & name, const TestGraph & graph, SpanningTree tree, TestOrdering ordering){
+        DirectedTestCase testCase = graphToDirectedTestCase(graph, tree, 1);
+        instances.push_back(Instance{name, reorderTestCase(testCase, ordering, ordering, 1)});
+    };
+    std::string size = std::to_string(scale);
+    add("grid-" + size, gridGraph(50 * scale, 50 * scale), SpanningTree::RANDOM, TestOrdering::SHUFFLED);
+    add("grid-dfs-" + size, gridGraph(30 * scale, 30 * scale), SpanningTree::DFS, TestOrdering::ORIGINAL);
+    add("wheel-" + size, wheelGraph(1000 * scale), SpanningTree::DFS, TestOrdering::SHUFFLED);
+    add("planar-" + size, planarTriangulationGraph(5000 * scale, 1), SpanningTree::RANDOM, TestOrdering::SHUFFLED);
+    add("chain-" + size, seriesParallelChainGraph(1000 * scale), SpanningTree::BFS, TestOrdering::SHUFFLED);
+    add("chain-long-first-" + size, seriesParallelChainGraph(5000 * scale), SpanningTree::DFS,
+        TestOrdering::LONG_FIRST);
+    add("components-" + size, tinyComponentsGraph(10000 * scale, 1), SpanningTree::RANDOM, TestOrdering::SHUFFLED);
+    instances.push_back(Instance{"erdos-renyi-" + size, erdosRenyiDirectedTestCase(300 * scale, 0.02, 1)});
+    //Random signs make the matrix graphic but almost never network
+    DirectedTestCase randomSigns = erdosRenyiDirectedTestCase(300 * scale, 0.02, 2);
+    std::minstd_rand gen(2);
+    for(auto & row : randomSigns.matrix){
+        for(auto & nonzero : row){
+            nonzero.value = gen() % 2 == 0 ? 1.0 : -1.0;
+        }
+    }
+    instances.push_back(Instance{"erdos-renyi-random-signs-" + size, randomSigns});
+}
+
+static void usage(const char * program){
+    std::cerr << "Usage: " << program << " [OPTIONS] [MATRIX...]\n"
+              << "Compares CMR and matrec on generated instances and on the given matrices in CMR's sparse format.\n"
+              << "  --scale S       Multiplies the size of the generated instances by S (default 1)\n"
+              << "  --repeat N      Runs every algorithm N times and reports the fastest run (default 1)\n"
+              << "  --no-generated  Only uses the given matrices\n"
+              << "  --csv FILE      Writes the results to FILE as CSV\n"
+              << "  --json FILE     Writes the results to FILE as JSON\n"
+              << "  --max-ratio R   Fails if a matrec algorithm is more than R times slower than CMR\n";
+}
+
+int main(int argc, char ** argv){
+    std::size_t scale = 1;
+    std::size_t repeat = 1;
+    bool generated = true;
+    std::string csvFile;
+    std::string jsonFile;
+    double maxRatio = 0.0;
+    std::vector<std::string> files;
+    for(int i = 1; i < argc; ++i){
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(argument == "--scale" && hasValue){
+            scale = std::stoul(argv[++i]);
+        }else if(argument == "--repeat" && hasValue){
+            repeat = std::max(1ul, std::stoul(argv[++i]));
+        }else if(argument == "--no-generated"){
+            generated = false;
+        }else if(argument == "--csv" && hasValue){
+            csvFile = argv[++i];
+        }else if(argument == "--json" && hasValue){
+            jsonFile = argv[++i];
+        }else if(argument == "--max-ratio" && hasValue){
+            maxRatio = std::stod(argv[++i]);
+        }else if(argument.rfind("--", 0) == 0){
+            usage(argv[0]);
+            return 2;
+        }else{
+            files.push_back(argument);
+        }
+    }
+
+    std::vector<Instance> instances;
+    if(generated){
+        generateInstances(scale, instances);
+    }
+    for(const auto & file : files){
+        if(!readSparseMatrix(file, instances)){
+            std::cerr << "Could not read matrix " << file << "\n";
+            return 2;
+        }
+    }
+
+    std::vector<Result> results;
+    printf("%-28s %9s %9s %10s %-24s %5s %12s %12s\n", "instance", "rows", "columns", "nonzeros", "algorithm",
+           "yes", "seconds", "peak (KB)");
+    for(const auto & instance : instances){
+        for(Algorithm algorithm : algorithms){
+            Result best = measure(instance, algorithm);
+            for(std::size_t run = 1; run < repeat && best.recognized >= 0; ++run){
+                Result result = measure(instance, algorithm);
+                best.seconds = std::min(best.seconds, result.seconds);
+                best.peakKB = std::max(best.peakKB, result.peakKB);
+            }
+            printf("%-28s %9zu %9zu %10zu %-24s %5s %12.6f %12ld\n", instance.name.c_str(), instance.matrix.rows,
+                   instance.matrix.cols, numNonzeros(instance.matrix), algorithmName(algorithm),
+                   best.recognized < 0 ? "error" : best.recognized ? "yes" : "no", best.seconds, best.peakKB);
+            fflush(stdout);
+            results.push_back(best);
+        }
+    }
+
+    if(!csvFile.empty()){
+        std::ofstream csv(csvFile);
+        csv << "instance,rows,columns,nonzeros,algorithm,recognized,seconds,peak_kb\n";
+        for(const auto & result : results){
+            csv << result.instance->name << "," << result.instance->matrix.rows << "," << result.instance->matrix.cols
+                << "," << numNonzeros(result.instance->matrix) << "," << algorithmName(result.algorithm) << ","
+                << result.recognized << "," << result.seconds << "," << result.peakKB << "\n";
+        }
+    }
+    if(!jsonFile.empty()){
+        std::ofstream json(jsonFile);
+        json << "[\n";
+        for(std::size_t i = 0; i < results.size(); ++i){
+            const Result & result = results[i];
+            json << "  {\"instance\": \"" << result.instance->name << "\", \"rows\": " << result.instance->matrix.rows
+                 << ", \"columns\": " << result.instance->matrix.cols << ", \"nonzeros\": "
+                 << numNonzeros(result.instance->matrix) << ", \"algorithm\": \"" << algorithmName(result.algorithm)
+                 << "\", \"recognized\": " << result.recognized << ", \"seconds\": " << result.seconds
+                 << ", \"peak_kb\": " << result.peakKB << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        json << "]\n";
+    }
+
+    //Every algorithm must agree with CMR, and with the regression threshold it may not be much slower than CMR.
+    //A millisecond of slack keeps the timing noise of tiny instances from failing the comparison.
+    int status = 0;
+    for(const auto & result : results){
+        if(result.algorithm == Algorithm::CMR_GRAPHIC || result.algorithm == Algorithm::CMR_NETWORK){
+            continue;
+        }
+        Algorithm reference = isNetworkAlgorithm(result.algorithm) ? Algorithm::CMR_NETWORK : Algorithm::CMR_GRAPHIC;
+        const Result * cmr = NULL;
+        for(const auto & other : results){
+            if(other.instance == result.instance && other.algorithm == reference){
+                cmr = &other;
+            }
+        }
+        if(result.recognized < 0 || cmr->recognized < 0){
+            fprintf(stderr, "%s: %s or %s failed\n", result.instance->name.c_str(), algorithmName(result.algorithm),
+                    algorithmName(reference));
+            status = 1;
+        }else if(result.recognized != cmr->recognized){
+            fprintf(stderr, "%s: %s and %s disagree\n", result.instance->name.c_str(), algorithmName(result.algorithm),
+                    algorithmName(reference));
+            status = 1;
+        }else if(maxRatio > 0.0 && result.seconds > maxRatio * cmr->seconds + 1e-3){
+            fprintf(stderr, "%s: %s took %.6f s, which is more than %g times the %.6f s of %s\n",
+                    result.instance->name.c_str(), algorithmName(result.algorithm), result.seconds, maxRatio,
+                    cmr->seconds, algorithmName(reference));
+            status = 1;
+        }
+    }
+    return status;
+}
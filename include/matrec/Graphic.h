@@ -2,6 +2,7 @@
 #define MATREC_GRAPHIC_H
 
 #include "Shared.h"
+#include "Matrix.h"
 
 #ifdef __cplusplus
 extern "C"{
@@ -13,10 +14,49 @@ extern "C"{
 typedef struct MATRECGraphicDecompositionImpl MATRECGraphicDecomposition;
 
 
-MATREC_ERROR MATRECGraphicDecompositionCreate(MATREC * env, MATRECGraphicDecomposition **pDecomposition, int numRows, int numColumns);
+/**
+ * Creates an empty decomposition. Rows and columns with indices beyond numRows and numColumns may still be added,
+ * in which case the mapping from rows and columns to the decomposition grows.
+ */
+MATREC_ERROR MATRECGraphicDecompositionCreate(MATREC * env, MATRECGraphicDecomposition **pDecomposition, MATREC_matrix_size numRows, MATREC_matrix_size numColumns);
+
+/**
+ * Creates an empty decomposition with the given storage for the mapping of rows and columns.
+ * MATREC_IDS_HASHED is useful if the indices are sparse, e.g. global ids in column generation, as the memory used then
+ * scales with the number of rows or columns in the decomposition, instead of with the largest index.
+ * In that case, numRows and numColumns are the expected number of rows and columns.
+ */
+MATREC_ERROR MATRECGraphicDecompositionCreateWithStorage(MATREC * env, MATRECGraphicDecomposition **pDecomposition,
+                                                        MATREC_matrix_size numRows, MATREC_matrix_size numColumns,
+                                                        MATRECIdStorage rowStorage, MATRECIdStorage columnStorage);
 
 void MATRECGraphicDecompositionFree(MATRECGraphicDecomposition **pDecomposition);
 
+/**
+ * Reports the memory of the decomposition, broken down by array. The arrays keep their size when rows or columns
+ * are removed, so the used bytes can be much lower than the allocated bytes after a reset.
+ */
+void MATRECGraphicDecompositionMemory(const MATRECGraphicDecomposition * decomposition, MATRECMemoryReport * report);
+
+/**
+ * Shrinks the arrays of the decomposition to the nodes, members and edges in use, and frees the lookup structures
+ * which are rebuilt on demand.
+ * On failure, the decomposition remains valid, but not all of its arrays may have been shrunk.
+ */
+MATREC_ERROR MATRECGraphicDecompositionShrink(MATRECGraphicDecomposition * decomposition);
+
+/**
+ * Path-compresses all union-find structures of the decomposition in one linear sweep, so that afterwards the
+ * representative of every node, member and edge is found in a single step. Useful before many read-only queries.
+ */
+void MATRECGraphicDecompositionFlatten(MATRECGraphicDecomposition * decomposition);
+
+/**
+ * Enables automatic flattening: after adding a row or column, the decomposition is flattened if the union-find lookups
+ * since the last check needed more than averageChainLength steps on average. A value of 0 (the default) disables it.
+ */
+void MATRECGraphicDecompositionSetAutoFlatten(MATRECGraphicDecomposition * decomposition, double averageChainLength);
+
 /**
  * Returns if the MATREC decomposition contains the given row
  */
@@ -31,6 +71,19 @@ bool MATRECGraphicDecompositionContainsColumn(const MATRECGraphicDecomposition *
  */
 bool MATRECGraphicDecompositionIsMinimal(const MATRECGraphicDecomposition * decomposition);
 
+/**
+ * Returns the type of the member which contains the row or column, or MATREC_MEMBER_NOT_CONTAINED if it is not in the
+ * decomposition. Takes amortized O(α) time and does not allocate memory.
+ */
+MATRECMemberType MATRECGraphicDecompositionMemberType(const MATRECGraphicDecomposition * decomposition, MATRECElement element);
+
+/**
+ * Returns true if both elements are in the decomposition and in the same connected component of the matrix.
+ * Takes amortized O(α) time and does not allocate memory.
+ */
+bool MATRECGraphicDecompositionSameComponent(const MATRECGraphicDecomposition * decomposition, MATRECElement first,
+                                             MATRECElement second);
+
 //TODO: method to convert decomposition into a graphic realization
 //TODO: method to remove complete components of the SPQR tree
 
@@ -38,7 +91,44 @@ bool MATRECGraphicDecompositionIsMinimal(const MATRECGraphicDecomposition * deco
  * A method to check if the cycle stored in the SPQR cycle matches the given array. Mostly useful in testing.
  */
 bool MATRECGraphicDecompositionVerifyCycle(const MATRECGraphicDecomposition * dec, MATREC_col column, MATREC_row * column_rows,
-                                           int num_rows, MATREC_row * computed_column_storage);
+                                           MATREC_matrix_size num_rows, MATREC_row * computed_column_storage);
+
+/**
+ * Creates the binary matrix which the decomposition represents, in a single pass over the fundamental cycles of all
+ * columns. Takes time linear in the number of nonzeros and the largest row and column index. The matrix has one more
+ * row and column than the largest row and column in the decomposition, and the columns of each row are sorted.
+ */
+MATREC_ERROR MATRECGraphicDecompositionCreateMatrix(const MATRECGraphicDecomposition * dec, MATRECCSMatrixInt ** pMatrix);
+
+/**
+ * Creates the decomposition of the graphic matrix of a graph, whose row edges form a spanning forest. The nonzeros of a
+ * column are the row edges on the path between the endpoints of its edge. The decomposition is built directly from the
+ * triconnected components of the graph, in time linear in the size of the graph. Returns MATREC_ERROR_INPUT if an
+ * element occurs twice, if the row edges contain a cycle or if the endpoints of a column edge are not joined by row
+ * edges.
+ */
+MATREC_ERROR MATRECGraphicDecompositionCreateFromGraph(MATREC * env, MATRECGraphicDecomposition ** pDecomposition,
+                                                       MATREC_matrix_size numNodes, MATREC_matrix_size numEdges,
+                                                       const MATREC_matrix_size * edgeTails,
+                                                       const MATREC_matrix_size * edgeHeads,
+                                                       const MATRECElement * edgeElements);
+
+/**
+ * Scratch memory which is only used during the Check functions of row and column additions.
+ * One scratch object can be shared by a row addition and a column addition working on the same decomposition, so that
+ * interleaving row and column additions does not grow two separate copies of it.
+ */
+typedef struct MATRECGraphicAdditionScratchImpl MATRECGraphicAdditionScratch;
+
+MATREC_ERROR MATRECcreateGraphicAdditionScratch(MATREC* env, MATRECGraphicAdditionScratch** pScratch);
+/**
+ * @brief Frees the scratch memory. Must be called after all additions which use it are freed.
+ */
+void MATRECfreeGraphicAdditionScratch(MATREC* env, MATRECGraphicAdditionScratch** pScratch);
+/**
+ * @brief Reports the memory of the scratch object. None of it is in use outside of the Check functions.
+ */
+void MATRECGraphicAdditionScratchMemory(const MATRECGraphicAdditionScratch* scratch, MATRECMemoryReport* report);
 
 /**
  * This class stores all data for performing sequential column additions to a matrix and checking if it is graphic or not.
@@ -49,10 +139,30 @@ typedef struct MATRECGraphicColumnAdditionImpl MATRECGraphicColumnAddition;
  * @brief Creates the data structure for managing column-addition for an SPQR decomposition
  */
 MATREC_ERROR MATRECcreateGraphicColumnAddition(MATREC* env, MATRECGraphicColumnAddition** pNewCol );
+/**
+ * @brief Creates the data structure for managing column-addition, which uses the given shared scratch memory.
+ */
+MATREC_ERROR MATRECcreateGraphicColumnAdditionWithScratch(MATREC* env, MATRECGraphicColumnAddition** pNewCol,
+                                                   MATRECGraphicAdditionScratch* scratch);
 /**
  * @brief Destroys the data structure for managing column-addition for SPQR decomposition
  */
 void MATRECfreeGraphicColumnAddition(MATREC* env, MATRECGraphicColumnAddition ** pNewCol);
+/**
+ * @brief Reports the memory of the column addition, including its scratch memory unless it is shared.
+ */
+void MATRECGraphicColumnAdditionMemory(const MATRECGraphicColumnAddition* newCol, MATRECMemoryReport* report);
+/**
+ * @brief Frees the memory of the column addition and of its scratch memory, also if the scratch memory is shared.
+ * The next Check allocates what it needs again. Must not be called between a Check and the corresponding Add.
+ */
+void MATRECGraphicColumnAdditionShrink(MATREC* env, MATRECGraphicColumnAddition* newCol);
+/**
+ * @brief Enables automatic shrinking: the column addition is shrunk once numCalls consecutive checks are made on a
+ * decomposition with less than a quarter of the edges that its arrays were grown for. A value of 0 (the default)
+ * disables it.
+ */
+void MATRECGraphicColumnAdditionSetAutoShrink(MATRECGraphicColumnAddition* newCol, size_t numCalls);
 
 /**
  * Checks if adding a column of the given matrix creates a graphic SPQR decomposition.
@@ -63,10 +173,12 @@ void MATRECfreeGraphicColumnAddition(MATREC* env, MATRECGraphicColumnAddition **
  * @param rows An array with the row indices of the nonzero entries of the column.
  * @param numRows The number of nonzero entries of the column
  */
-MATREC_ERROR MATRECGraphicColumnAdditionCheck(MATRECGraphicDecomposition * dec, MATRECGraphicColumnAddition * newCol, MATREC_col column, const MATREC_row * rows, size_t numRows);
+MATREC_ERROR MATRECGraphicColumnAdditionCheck(MATRECGraphicDecomposition * dec, MATRECGraphicColumnAddition * newCol, MATREC_col column, const MATREC_row * rows, MATREC_matrix_size numRows);
 /**
  * @brief Adds the most recently checked column from checkNewRow() to the Decomposition.
- * //TODO: specify (and implement) behavior in special cases (e.g. zero columns, columns with a single entry)
+ * A column without nonzeros in the decomposition forms a loop or a new series member with its new rows. A column with a
+ * single nonzero in the decomposition, or whose rows are those of an earlier added column, is placed in parallel with
+ * that row or column edge.
  * In Debug mode, adding a column for which MATRECGraphicColumnAdditionRemainsGraphic() returns false will exit the program.
  * In Release mode, adding a column for which MATRECGraphicColumnAdditionRemainsGraphic() return false is undefined behavior
  * @param dec Current SPQR-decomposition
@@ -75,7 +187,7 @@ MATREC_ERROR MATRECGraphicColumnAdditionCheck(MATRECGraphicDecomposition * dec,
 MATREC_ERROR MATRECGraphicColumnAdditionAdd(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol);
 
 /**
- * TODO: specify (and implement) behavior in special cases (e.g. zero columns, columns with a single entry)
+ * Columns without nonzeros in the decomposition, or with a single one, always remain graphic.
  * @param newColumn
  * @return True if the most recently checked column is addable to the SPQR decomposition passed to it, i.e. the submatrix
  * given by both remains graphic.
@@ -92,10 +204,30 @@ typedef struct MATRECGraphicRowAdditionImpl MATRECGraphicRowAddition;
  * @brief Creates the data structure for managing row-addition for an SPQR decomposition
  */
 MATREC_ERROR MATRECcreateGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition** pNewRow );
+/**
+ * @brief Creates the data structure for managing row-addition, which uses the given shared scratch memory.
+ */
+MATREC_ERROR MATRECcreateGraphicRowAdditionWithScratch(MATREC* env, MATRECGraphicRowAddition** pNewRow,
+                                                   MATRECGraphicAdditionScratch* scratch);
 /**
  * @brief Destroys the data structure for managing row-addition for SPQR decomposition
  */
 void MATRECfreeGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition ** pNewRow);
+/**
+ * @brief Reports the memory of the row addition, including its scratch memory unless it is shared.
+ */
+void MATRECGraphicRowAdditionMemory(const MATRECGraphicRowAddition* newRow, MATRECMemoryReport* report);
+/**
+ * @brief Frees the memory of the row addition and of its scratch memory, also if the scratch memory is shared.
+ * The next Check allocates what it needs again. Must not be called between a Check and the corresponding Add.
+ */
+void MATRECGraphicRowAdditionShrink(MATREC* env, MATRECGraphicRowAddition* newRow);
+/**
+ * @brief Enables automatic shrinking: the row addition is shrunk once numCalls consecutive checks are made on a
+ * decomposition with less than a quarter of the edges that its arrays were grown for. A value of 0 (the default)
+ * disables it.
+ */
+void MATRECGraphicRowAdditionSetAutoShrink(MATRECGraphicRowAddition* newRow, size_t numCalls);
 
 /**
  * Checks if adding a row of the given matrix creates a graphic SPQR decomposition.
@@ -106,7 +238,7 @@ void MATRECfreeGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition ** pNewR
  * @param columns An array with the column indices of the nonzero entries of the row.
  * @param numColumns The number of nonzero entries of the row
  */
-MATREC_ERROR MATRECGraphicRowAdditionCheck(MATRECGraphicDecomposition * dec, MATRECGraphicRowAddition * newRow, MATREC_row row, const MATREC_col * columns, size_t numColumns);
+MATREC_ERROR MATRECGraphicRowAdditionCheck(MATRECGraphicDecomposition * dec, MATRECGraphicRowAddition * newRow, MATREC_row row, const MATREC_col * columns, MATREC_matrix_size numColumns);
 /**
  * @brief Adds the most recently checked column from checkNewRow() to the Decomposition.
  * //TODO: specify (and implement) behavior in special cases (e.g. zero rows, rows with a single entry?)
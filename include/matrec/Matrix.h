@@ -8,6 +8,10 @@
 extern "C"{
 #endif
 
+///Packs the signs of the values into MATREC_SIGN_WORDS(numValues) words, where bit i % 64 of word i / 64 is set if value i
+///is negative. Returns false if a value differs more than tolerance from -1 or 1, in which case the signs are incomplete
+bool MATRECpackSigns(const double * values, MATREC_matrix_size numValues, double tolerance, uint64_t * negativeBits);
+
 ///A standard Compressed Storage Row (CSR) matrix
 typedef struct {
     MATREC_matrix_size numRows;
@@ -172,7 +176,8 @@ void MATRECfreeMatrixPairDouble(MATREC *env,
                                 MATRECCompressedSparseMatrixPairDouble **matrixPair
                           );
 
-///Represents a submatrix by keeping two arrays with the rows and columns in the submatrix
+///Represents a submatrix by keeping two arrays with the rows and columns in the submatrix. The rows and columns are
+///0-based indices into the matrix, in all functions which take a submatrix
 typedef struct{
     MATREC_matrix_size numRows;     /**< \brief Number of rows. */
     MATREC_row *rows;       /**< \brief Array with row indices. */
@@ -223,6 +228,11 @@ MATREC_ERROR MATRECreadSubMatrixFromStream(
         FILE *stream                /**< File stream to save submatrix to. */
 );
 
+/**
+ * \brief Counts the nonzeros of the row matrix in the submatrix, whose columns must be sorted.
+ *
+ * Takes time in the number of rows of the submatrix times the number of its columns and the nonzeros of its rows.
+ */
 MATREC_matrix_size MATRECcountIntSubMatrixNonzeros(const MATRECSubMatrix* subMatrix,
                                                    const MATRECCSMatrixInt *rowMatrix
 );
@@ -231,6 +241,23 @@ MATREC_matrix_size MATRECcountDoubleSubMatrixNonzeros(const MATRECSubMatrix* sub
                                                       const MATRECCSMatrixDouble * rowMatrix
                                          );
 
+/**
+ * \brief Counts the nonzeros of the row matrix in the submatrix, whose columns may be in any order.
+ *
+ * The columns of the submatrix are marked in columnMarks, which must hold MATREC_SIGN_WORDS(numColumns) zeroed words for
+ * the columns of the row matrix. The marks are zeroed again before returning, so they can be reused for many
+ * submatrices without clearing them. The time is linear in the number of nonzeros of the selected rows.
+ */
+MATREC_matrix_size MATRECcountIntSubMatrixNonzerosMarked(const MATRECSubMatrix* subMatrix,
+                                                         const MATRECCSMatrixInt *rowMatrix,
+                                                         uint64_t * columnMarks
+);
+
+MATREC_matrix_size MATRECcountDoubleSubMatrixNonzerosMarked(const MATRECSubMatrix* subMatrix,
+                                                            const MATRECCSMatrixDouble * rowMatrix,
+                                                            uint64_t * columnMarks
+);
+
 void MATRECtransposeSubmatrix(MATRECSubMatrix * submatrix);
 
 #ifdef __cplusplus
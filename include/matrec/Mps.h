@@ -0,0 +1,64 @@
+#ifndef MATREC_MPS_H
+#define MATREC_MPS_H
+
+#include "Shared.h"
+#include "Matrix.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+typedef enum{
+    MATREC_MPS_FREE = 0, ///Whitespace separated fields; names may not contain spaces
+    MATREC_MPS_FIXED = 1 ///Fields at the fixed column positions of the original MPS format
+} MATRECMpsFormat;
+
+///Optional parts of the model which are only stored when explicitly requested
+typedef enum{
+    MATREC_MPS_READ_MATRIX = 0,    ///Only read the constraint matrix, the row senses and the names
+    MATREC_MPS_READ_OBJECTIVE = 1, ///Also store the objective coefficients
+    MATREC_MPS_READ_BOUNDS = 2     ///Also store the column bounds and integrality information
+} MATRECMpsReadParts;
+
+///The constraint matrix of an MPS model. Objective (N) rows are not part of the constraint matrix.
+typedef struct{
+    MATRECCSMatrixDouble * matrix; /**< \brief The constraint matrix in row-major form. */
+    char * name;                   /**< \brief Name of the model, possibly empty. */
+    char ** rowNames;              /**< \brief Name of each row of the constraint matrix. */
+    char ** columnNames;           /**< \brief Name of each column of the constraint matrix. */
+    char * rowSenses;              /**< \brief Sense of each constraint row, either 'E', 'L' or 'G'. */
+    double * objective;            /**< \brief Objective coefficients; \c NULL unless requested. */
+    double * lowerBounds;          /**< \brief Column lower bounds; \c NULL unless requested. */
+    double * upperBounds;          /**< \brief Column upper bounds; \c NULL unless requested. */
+    bool * isInteger;              /**< \brief Column integrality; \c NULL unless requested. */
+    char * nameStorage;            /**< \brief Storage of all names; the name pointers point into this array. */
+} MATRECMpsModel;
+
+/**
+ * \brief Reads an MPS model from the file \p stream.
+ *
+ * The file is read line by line, and the constraint matrix is built while the COLUMNS section is read, so that the
+ * model is never stored in an intermediate format. Columns must be given contiguously, as the MPS format requires.
+ * Right hand sides and ranges are skipped. Returns MATREC_ERROR_INPUT if the file is not a valid MPS file.
+ */
+MATREC_ERROR MATRECreadMpsFromStream(
+        MATREC * env,               /**< MATREC environment. */
+        MATRECMpsModel ** pModel,   /**< Pointer to where the model is to be stored. */
+        FILE * stream,              /**< File stream to read the model from. */
+        MATRECMpsFormat format,     /**< Whether the file is in free or fixed format. */
+        int parts                   /**< Bitwise or of \ref MATRECMpsReadParts indicating what else to store. */
+);
+
+/**
+ * \brief Frees an MPS model, including its constraint matrix.
+ */
+void MATRECfreeMpsModel(
+        MATREC * env,               /**< MATREC environment. */
+        MATRECMpsModel ** pModel    /**< Pointer to the model. */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MATREC_MPS_H
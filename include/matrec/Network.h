@@ -6,6 +6,7 @@ extern "C"{
 #endif
 
 #include "Shared.h"
+#include "Matrix.h"
 
 /**
  * This class stores the SPQR decomposition
@@ -13,10 +14,61 @@ extern "C"{
 typedef struct MATRECNetworkDecompositionImpl MATRECNetworkDecomposition;
 
 
-MATREC_ERROR MATRECNetworkDecompositionCreate(MATREC * env, MATRECNetworkDecomposition **pDecomposition, int numRows, int numColumns);
+/**
+ * Creates an empty decomposition. Rows and columns with indices beyond numRows and numColumns may still be added,
+ * in which case the mapping from rows and columns to the decomposition grows.
+ */
+MATREC_ERROR MATRECNetworkDecompositionCreate(MATREC * env, MATRECNetworkDecomposition **pDecomposition, MATREC_matrix_size numRows, MATREC_matrix_size numColumns);
+
+/**
+ * Creates an empty decomposition with the given storage for the mapping of rows and columns.
+ * MATREC_IDS_HASHED is useful if the indices are sparse, e.g. global ids in column generation, as the memory used then
+ * scales with the number of rows or columns in the decomposition, instead of with the largest index.
+ * In that case, numRows and numColumns are the expected number of rows and columns.
+ */
+MATREC_ERROR MATRECNetworkDecompositionCreateWithStorage(MATREC * env, MATRECNetworkDecomposition **pDecomposition,
+                                                        MATREC_matrix_size numRows, MATREC_matrix_size numColumns,
+                                                        MATRECIdStorage rowStorage, MATRECIdStorage columnStorage);
 
 void MATRECNetworkDecompositionFree(MATRECNetworkDecomposition **pDecomposition);
 
+/**
+ * Reports the memory of the decomposition, broken down by array. The arrays keep their size when rows or columns
+ * are removed, so the used bytes can be much lower than the allocated bytes after a reset.
+ */
+void MATRECNetworkDecompositionMemory(const MATRECNetworkDecomposition * decomposition, MATRECMemoryReport * report);
+
+/**
+ * Shrinks the arrays of the decomposition to the nodes, members and arcs in use, and frees the lookup structures
+ * which are rebuilt on demand.
+ * On failure, the decomposition remains valid, but not all of its arrays may have been shrunk.
+ */
+MATREC_ERROR MATRECNetworkDecompositionShrink(MATRECNetworkDecomposition * decomposition);
+
+/**
+ * Enables automatic shrinking: after numResets consecutive resets of a decomposition of which less than a quarter
+ * of the arcs were in use, the decomposition is shrunk. A value of 0 (the default) disables it.
+ */
+void MATRECNetworkDecompositionSetAutoShrink(MATRECNetworkDecomposition * decomposition, size_t numResets);
+
+/**
+ * Removes all rows and columns from the decomposition, but keeps its memory, so that it can be reused for another matrix.
+ * Row and column additions can be used with the decomposition again after it is reset.
+ */
+void MATRECNetworkDecompositionReset(MATRECNetworkDecomposition * decomposition);
+
+/**
+ * Path-compresses all union-find structures of the decomposition in one linear sweep, so that afterwards the
+ * representative of every node, member and arc is found in a single step. Useful before many read-only queries.
+ */
+void MATRECNetworkDecompositionFlatten(MATRECNetworkDecomposition * decomposition);
+
+/**
+ * Enables automatic flattening: after adding a row or column, the decomposition is flattened if the union-find lookups
+ * since the last check needed more than averageChainLength steps on average. A value of 0 (the default) disables it.
+ */
+void MATRECNetworkDecompositionSetAutoFlatten(MATRECNetworkDecomposition * decomposition, double averageChainLength);
+
 /**
  * Returns if the MATREC decomposition contains the given row
  */
@@ -31,6 +83,28 @@ bool MATRECNetworkDecompositionContainsColumn(const MATRECNetworkDecomposition *
  */
 bool MATRECNetworkDecompositionIsMinimal(const MATRECNetworkDecomposition * decomposition);
 
+/**
+ * Returns the type of the member which contains the row or column, or MATREC_MEMBER_NOT_CONTAINED if it is not in the
+ * decomposition. Takes amortized O(α) time and does not allocate memory.
+ */
+MATRECMemberType MATRECNetworkDecompositionMemberType(const MATRECNetworkDecomposition * decomposition, MATRECElement element);
+
+/**
+ * Returns true if both elements are in the decomposition and in the same connected component of the matrix.
+ * Takes amortized O(α) time and does not allocate memory.
+ */
+bool MATRECNetworkDecompositionSameComponent(const MATRECNetworkDecomposition * decomposition, MATRECElement first,
+                                             MATRECElement second);
+
+/**
+ * If both elements are arcs of the same rigid member, sets reversed to whether their orientations in the graph of the
+ * member are reflected relative to each other, and returns true. The graph of a rigid member is only defined up to
+ * reversing all of its arcs, so only this relative orientation is meaningful. Returns false otherwise.
+ * Takes amortized O(α) time and does not allocate memory.
+ */
+bool MATRECNetworkDecompositionRelativeOrientation(const MATRECNetworkDecomposition * decomposition, MATRECElement first,
+                                                   MATRECElement second, bool * reversed);
+
 //TODO: method to convert decomposition into a realization
 //TODO: method to remove complete components of the MATREC tree
 
@@ -38,10 +112,80 @@ bool MATRECNetworkDecompositionIsMinimal(const MATRECNetworkDecomposition * deco
  * A method to check if the cycle stored in the MATREC cycle matches the given array. Mostly useful in testing.
  */
 bool MATRECNetworkDecompositionVerifyCycle(const MATRECNetworkDecomposition * dec, MATREC_col column, MATREC_row * column_rows,
-                                           double * column_values, int num_rows,
+                                           double * column_values, MATREC_matrix_size num_rows,
                                            MATREC_row * computed_column_storage,
                                            bool * computedSignStorage);
 
+/**
+ * Computes the fundamental cycle of a column in the decomposition, i.e. the rows of its nonzeros and whether they are
+ * negative. rows and reversed must have space for all rows in the decomposition. A column which is not in the
+ * decomposition has an empty cycle. Does not change the decomposition.
+ */
+MATREC_ERROR MATRECNetworkDecompositionFundamentalCycle(const MATRECNetworkDecomposition * dec, MATREC_col column,
+                                                       MATREC_row * rows, bool * reversed, MATREC_matrix_size * numRows);
+
+/**
+ * Creates the signed matrix which the decomposition represents, in a single pass over the fundamental cycles of all
+ * columns. Takes time linear in the number of nonzeros and the largest row and column index. The matrix has one more
+ * row and column than the largest row and column in the decomposition, and the columns of each row are sorted.
+ */
+MATREC_ERROR MATRECNetworkDecompositionCreateMatrix(const MATRECNetworkDecomposition * dec, MATRECCSMatrixInt ** pMatrix);
+
+/**
+ * Creates the decomposition of the network matrix of a directed graph, whose row edges form a spanning forest. The
+ * nonzeros of a column are the row edges on the path from the tail to the head of its edge, which are 1 if the path
+ * uses the edge from its tail to its head and -1 otherwise. The decomposition is built directly from the triconnected
+ * components of the graph, in time linear in the size of the graph. Returns MATREC_ERROR_INPUT if an element occurs
+ * twice, if the row edges contain a cycle or if the endpoints of a column edge are not joined by row edges.
+ */
+MATREC_ERROR MATRECNetworkDecompositionCreateFromGraph(MATREC * env, MATRECNetworkDecomposition ** pDecomposition,
+                                                       MATREC_matrix_size numNodes, MATREC_matrix_size numEdges,
+                                                       const MATREC_matrix_size * edgeTails,
+                                                       const MATREC_matrix_size * edgeHeads,
+                                                       const MATRECElement * edgeElements);
+
+/**
+ * Enables queries from other threads while a single thread changes the decomposition. The decomposition then keeps
+ * two read-only replicas. Every successful MATRECNetworkColumnAdditionAdd() and MATRECNetworkRowAdditionAdd()
+ * publishes the changed decomposition by copying the elements it changed into the replica which is not published, and
+ * then switching the published replica atomically. This costs time linear in the size of the members which the
+ * addition changed, except when the storage of the replicas grows, which copies the whole decomposition.
+ */
+MATREC_ERROR MATRECNetworkDecompositionEnableReaders(MATRECNetworkDecomposition * dec);
+
+/**
+ * Publishes the current state of the decomposition to readers by copying all of it. Only needed after changes other
+ * than additions. Sleeps until the readers of the replica which is overwritten are done.
+ */
+MATREC_ERROR MATRECNetworkDecompositionPublish(MATRECNetworkDecomposition * dec);
+
+/**
+ * Returns the most recently published replica of the decomposition, which is not changed until it is released with
+ * MATRECNetworkDecompositionEndRead(). Never blocks, and may be called from any thread while the decomposition is
+ * changed. The replica may only be passed to the functions which take a const decomposition, such as
+ * MATRECNetworkDecompositionContainsRow() and MATRECNetworkDecompositionFundamentalCycle().
+ */
+const MATRECNetworkDecomposition * MATRECNetworkDecompositionBeginRead(MATRECNetworkDecomposition * dec);
+
+void MATRECNetworkDecompositionEndRead(MATRECNetworkDecomposition * dec, const MATRECNetworkDecomposition * replica);
+
+/**
+ * Scratch memory which is only used during the Check functions of row and column additions.
+ * One scratch object can be shared by a row addition and a column addition working on the same decomposition, so that
+ * interleaving row and column additions does not grow two separate copies of it.
+ */
+typedef struct MATRECNetworkAdditionScratchImpl MATRECNetworkAdditionScratch;
+
+MATREC_ERROR MATRECcreateNetworkAdditionScratch(MATREC* env, MATRECNetworkAdditionScratch** pScratch);
+/**
+ * @brief Frees the scratch memory. Must be called after all additions which use it are freed.
+ */
+void MATRECfreeNetworkAdditionScratch(MATREC* env, MATRECNetworkAdditionScratch** pScratch);
+/**
+ * @brief Reports the memory of the scratch object. None of it is in use outside of the Check functions.
+ */
+void MATRECNetworkAdditionScratchMemory(const MATRECNetworkAdditionScratch* scratch, MATRECMemoryReport* report);
+
 /**
  * This class stores all data for performing sequential column additions to a matrix and checking if it is network or not.
  */
@@ -51,10 +195,30 @@ typedef struct MATRECNetworkColumnAdditionImpl MATRECNetworkColumnAddition;
  * @brief Creates the data structure for managing column-addition for an MATREC decomposition
  */
 MATREC_ERROR MATRECcreateNetworkColumnAddition(MATREC* env, MATRECNetworkColumnAddition** pNewCol );
+/**
+ * @brief Creates the data structure for managing column-addition, which uses the given shared scratch memory.
+ */
+MATREC_ERROR MATRECcreateNetworkColumnAdditionWithScratch(MATREC* env, MATRECNetworkColumnAddition** pNewCol,
+                                                   MATRECNetworkAdditionScratch* scratch);
 /**
  * @brief Destroys the data structure for managing column-addition for MATREC decomposition
  */
 void MATRECfreeNetworkColumnAddition(MATREC* env, MATRECNetworkColumnAddition ** pNewCol);
+/**
+ * @brief Reports the memory of the column addition, including its scratch memory unless it is shared.
+ */
+void MATRECNetworkColumnAdditionMemory(const MATRECNetworkColumnAddition* newCol, MATRECMemoryReport* report);
+/**
+ * @brief Frees the memory of the column addition and of its scratch memory, also if the scratch memory is shared.
+ * The next Check allocates what it needs again. Must not be called between a Check and the corresponding Add.
+ */
+void MATRECNetworkColumnAdditionShrink(MATREC* env, MATRECNetworkColumnAddition* newCol);
+/**
+ * @brief Enables automatic shrinking: the column addition is shrunk once numCalls consecutive checks are made on a
+ * decomposition with less than a quarter of the arcs that its arrays were grown for. A value of 0 (the default)
+ * disables it.
+ */
+void MATRECNetworkColumnAdditionSetAutoShrink(MATRECNetworkColumnAddition* newCol, size_t numCalls);
 
 /**
  * Checks if adding a column of the given matrix creates a network MATREC decomposition.
@@ -66,10 +230,23 @@ void MATRECfreeNetworkColumnAddition(MATREC* env, MATRECNetworkColumnAddition **
  * @param numRows The number of nonzero entries of the column
  */
 MATREC_ERROR MATRECNetworkColumnAdditionCheck(MATRECNetworkDecomposition * dec, MATRECNetworkColumnAddition * newCol, MATREC_col column,
-                                              const MATREC_row * nonzeroRows, const double * nonzeroValues, size_t numNonzeros);
+                                              const MATREC_row * nonzeroRows, const double * nonzeroValues, MATREC_matrix_size numNonzeros);
+/**
+ * Same as MATRECNetworkColumnAdditionCheck(), but with the signs of the nonzeros given as -1 or 1.
+ */
+MATREC_ERROR MATRECNetworkColumnAdditionCheckSigns(MATRECNetworkDecomposition * dec, MATRECNetworkColumnAddition * newCol, MATREC_col column,
+                                                   const MATREC_row * nonzeroRows, const int8_t * nonzeroSigns, MATREC_matrix_size numNonzeros);
+/**
+ * Same as MATRECNetworkColumnAdditionCheck(), but with the signs of the nonzeros packed into MATREC_SIGN_WORDS(numNonzeros)
+ * words, as computed by MATRECpackSigns().
+ */
+MATREC_ERROR MATRECNetworkColumnAdditionCheckPacked(MATRECNetworkDecomposition * dec, MATRECNetworkColumnAddition * newCol, MATREC_col column,
+                                                    const MATREC_row * nonzeroRows, const uint64_t * negativeBits, MATREC_matrix_size numNonzeros);
 /**
  * @brief Adds the most recently checked column from checkNewRow() to the Decomposition.
- * //TODO: specify (and implement) behavior in special cases (e.g. zero columns, columns with a single entry)
+ * A column without nonzeros in the decomposition forms a loop or a new series member with its new rows. A column with a
+ * single nonzero in the decomposition, or whose nonzeros equal those of an earlier added column up to negation, is placed
+ * in parallel with that row or column arc.
  * In Debug mode, adding a column for which MATRECNetworkColumnAdditionRemainsNetwork() returns false will exit the program.
  * In Release mode, adding a column for which MATRECNetworkColumnAdditionRemainsNetwork() return false is undefined behavior
  * @param dec Current MATREC-decomposition
@@ -78,13 +255,68 @@ MATREC_ERROR MATRECNetworkColumnAdditionCheck(MATRECNetworkDecomposition * dec,
 MATREC_ERROR MATRECNetworkColumnAdditionAdd(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol);
 
 /**
- * TODO: specify (and implement) behavior in special cases (e.g. zero columns, columns with a single entry)
+ * Columns without nonzeros in the decomposition, or with a single one, always remain network.
  * @param newColumn
  * @return True if the most recently checked column is addable to the MATREC decomposition passed to it, i.e. the submatrix
  * given by both remains network.
  */
 bool MATRECNetworkColumnAdditionRemainsNetwork(MATRECNetworkColumnAddition *newCol);
 
+/**
+ * A pool of candidate columns, for greedily growing a network submatrix by adding candidates to a decomposition.
+ * The pool caches the outcome of checking each candidate. After a candidate is added, only the candidates whose last
+ * check touched a member changed by the addition, that have a nonzero in a row which the addition introduced, or that
+ * spanned several components or touched a member whose parent was reversed when the addition joined components, are
+ * checked again. Rejected candidates are never checked again, as a column which can not be added to a matrix can also
+ * not be added after more columns are added.
+ * While the pool is in use, the decomposition may only be changed through MATRECNetworkCandidatePoolAdd().
+ */
+typedef struct MATRECNetworkCandidatePoolImpl MATRECNetworkCandidatePool;
+
+MATREC_ERROR MATRECcreateNetworkCandidatePool(MATREC* env, MATRECNetworkCandidatePool** pPool,
+                                              MATRECNetworkDecomposition * dec);
+
+void MATRECfreeNetworkCandidatePool(MATREC* env, MATRECNetworkCandidatePool** pPool);
+
+/**
+ * Adds a column which is neither in the decomposition nor in the pool as a candidate. The nonzeros are copied.
+ */
+MATREC_ERROR MATRECNetworkCandidatePoolInsert(MATRECNetworkCandidatePool * pool, MATREC_col column,
+                                              const MATREC_row * nonzeroRows, const double * nonzeroValues,
+                                              MATREC_matrix_size numNonzeros);
+
+/**
+ * Sets isAddable to whether the candidate can be added to the decomposition. The candidate is only checked if the
+ * cached outcome was invalidated by an addition, or if it was never checked.
+ */
+MATREC_ERROR MATRECNetworkCandidatePoolIsAddable(MATRECNetworkCandidatePool * pool, MATREC_col column, bool * isAddable);
+
+/**
+ * Adds a candidate for which MATRECNetworkCandidatePoolIsAddable() returned true to the decomposition, and invalidates
+ * the cached outcomes of the candidates which are affected by it.
+ */
+MATREC_ERROR MATRECNetworkCandidatePoolAdd(MATRECNetworkCandidatePool * pool, MATREC_col column);
+
+/**
+ * Returns the number of column checks done by the pool.
+ */
+size_t MATRECNetworkCandidatePoolNumChecks(const MATRECNetworkCandidatePool * pool);
+
+/**
+ * Checks and adds the columns 0..numColumns-1 in order, stopping at the first column which can not be added, and
+ * stores the number of added columns in numAdded. The nonzeros of column i are at positions
+ * columnStarts[i]..columnStarts[i+1]-1 of nonzeroRows and nonzeroValues.
+ * The next windowSize columns are checked speculatively on numThreads threads (including the calling thread) against
+ * the current decomposition. The calling thread then adds them in order, and only checks a column again if an earlier
+ * addition in the window changed a member which its check touched, introduced one of its new rows, or joined
+ * components. Thus, the same columns are added as when checking and adding the columns one by one.
+ */
+MATREC_ERROR MATRECNetworkSpeculativeColumnAddition(MATRECNetworkDecomposition * dec, MATREC_matrix_size numColumns,
+                                                    const MATREC_matrix_size * columnStarts,
+                                                    const MATREC_row * nonzeroRows, const double * nonzeroValues,
+                                                    MATREC_index windowSize, MATREC_index numThreads,
+                                                    MATREC_matrix_size * numAdded);
+
 
 /**
  * This class stores all data for performing sequential row-additions to a matrix and checking if it is network or not.
@@ -95,10 +327,30 @@ typedef struct MATRECNetworkRowAdditionImpl MATRECNetworkRowAddition;
  * @brief Creates the data structure for managing row-addition for an MATREC decomposition
  */
 MATREC_ERROR MATRECcreateNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition** pNewRow );
+/**
+ * @brief Creates the data structure for managing row-addition, which uses the given shared scratch memory.
+ */
+MATREC_ERROR MATRECcreateNetworkRowAdditionWithScratch(MATREC* env, MATRECNetworkRowAddition** pNewRow,
+                                                   MATRECNetworkAdditionScratch* scratch);
 /**
  * @brief Destroys the data structure for managing row-addition for MATREC decomposition
  */
 void MATRECfreeNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition ** pNewRow);
+/**
+ * @brief Reports the memory of the row addition, including its scratch memory unless it is shared.
+ */
+void MATRECNetworkRowAdditionMemory(const MATRECNetworkRowAddition* newRow, MATRECMemoryReport* report);
+/**
+ * @brief Frees the memory of the row addition and of its scratch memory, also if the scratch memory is shared.
+ * The next Check allocates what it needs again. Must not be called between a Check and the corresponding Add.
+ */
+void MATRECNetworkRowAdditionShrink(MATREC* env, MATRECNetworkRowAddition* newRow);
+/**
+ * @brief Enables automatic shrinking: the row addition is shrunk once numCalls consecutive checks are made on a
+ * decomposition with less than a quarter of the arcs that its arrays were grown for. A value of 0 (the default)
+ * disables it.
+ */
+void MATRECNetworkRowAdditionSetAutoShrink(MATRECNetworkRowAddition* newRow, size_t numCalls);
 
 /**
  * Checks if adding a row of the given matrix creates a network MATREC decomposition.
@@ -110,7 +362,18 @@ void MATRECfreeNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition ** pNewR
  * @param numColumns The number of nonzero entries of the row
  */
 MATREC_ERROR MATRECNetworkRowAdditionCheck(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow, MATREC_row row,
-                                           const MATREC_col * nonzeroCols, const double * nonzeroValues, size_t numNonzeros);
+                                           const MATREC_col * nonzeroCols, const double * nonzeroValues, MATREC_matrix_size numNonzeros);
+/**
+ * Same as MATRECNetworkRowAdditionCheck(), but with the signs of the nonzeros given as -1 or 1.
+ */
+MATREC_ERROR MATRECNetworkRowAdditionCheckSigns(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow, MATREC_row row,
+                                                const MATREC_col * nonzeroCols, const int8_t * nonzeroSigns, MATREC_matrix_size numNonzeros);
+/**
+ * Same as MATRECNetworkRowAdditionCheck(), but with the signs of the nonzeros packed into MATREC_SIGN_WORDS(numNonzeros)
+ * words, as computed by MATRECpackSigns().
+ */
+MATREC_ERROR MATRECNetworkRowAdditionCheckPacked(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow, MATREC_row row,
+                                                 const MATREC_col * nonzeroCols, const uint64_t * negativeBits, MATREC_matrix_size numNonzeros);
 /**
  * @brief Adds the most recently checked column from checkNewRow() to the Decomposition.
  * //TODO: specify (and implement) behavior in special cases (e.g. zero rows, rows with a single entry?)
@@ -129,6 +392,32 @@ MATREC_ERROR MATRECNetworkRowAdditionAdd(MATRECNetworkDecomposition *dec, MATREC
  */
 bool MATRECNetworkRowAdditionRemainsNetwork(const MATRECNetworkRowAddition *newRow);
 
+/**
+ * Determines for each of the given row matrices whether it is a network matrix. Bit i % 64 of isNetwork[i / 64] is set
+ * if matrix i is network, so isNetwork must hold MATREC_SIGN_WORDS(numMatrices) words. Matrices with an entry other than
+ * -1 or 1 are not network.
+ * The matrices are recognized on numThreads threads (including the calling thread), which steal groups of 64 matrices
+ * from each other when they run out of work. Each thread reuses a single decomposition and row addition, which are
+ * reset between the matrices.
+ */
+MATREC_ERROR MATRECNetworkRecognizeMatrices(MATREC * env, const MATRECCSMatrixInt * const * matrices,
+                                            MATREC_matrix_size numMatrices, MATREC_index numThreads,
+                                            uint64_t * isNetwork);
+
+/**
+ * Same as MATRECNetworkRecognizeMatrices(), but for submatrices of a single row matrix. The nonzeros of the submatrices
+ * are read from the matrix without being copied.
+ */
+MATREC_ERROR MATRECNetworkRecognizeSubMatrices(MATREC * env, const MATRECCSMatrixInt * matrix,
+                                               const MATRECSubMatrix * const * subMatrices,
+                                               MATREC_matrix_size numSubMatrices, MATREC_index numThreads,
+                                               uint64_t * isNetwork);
+/**
+ * Determines whether a submatrix of the given matrix is network, without copying it. The columns of the submatrix are
+ * added one by one, where a membership bitmap of the rows of the submatrix filters their nonzeros. The decomposition uses the row and column indices of the matrix directly.
+ */
+MATREC_ERROR MATRECNetworkRecognizeSubMatrix(MATREC * env, const MATRECCompressedSparseMatrixPairInt * matrix,
+                                             const MATRECSubMatrix * subMatrix, bool * isNetwork);
 
 #ifdef __cplusplus
 }
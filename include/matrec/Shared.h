@@ -6,6 +6,8 @@
 #include <assert.h>
 #include <stdbool.h> //defines bool when c++ is not defined
 #include <limits.h>
+#include <stdint.h>
+#include <inttypes.h>
 
 #ifdef __cplusplus
 extern "C"{
@@ -39,8 +41,14 @@ do                                                  \
     }                                               \
 } while(false)                                      \
 
+typedef struct MATRECTraceImpl MATRECTrace;
+
 struct MATREC_ENVIRONMENT{
 FILE * output;
+MATRECTrace * trace; ///Records the calls on this environment if it is not NULL, see matrec/Trace.h
+size_t memoryInUse; ///Bytes allocated through the environment which are not freed yet
+size_t memoryPeak; ///Largest value that memoryInUse reached
+size_t memoryLimit; ///If not 0, allocations which would make memoryInUse exceed it fail with MATREC_ERROR_MEMORY
 };
 
 typedef struct MATREC_ENVIRONMENT MATREC;
@@ -48,6 +56,17 @@ typedef struct MATREC_ENVIRONMENT MATREC;
 MATREC_ERROR MATRECcreateEnvironment(MATREC** pSpqr);
 MATREC_ERROR MATRECfreeEnvironment(MATREC** pSpqr);
 
+///Returns the number of bytes allocated by all objects created with the environment, which are not freed yet
+size_t MATRECmemoryInUse(const MATREC * env);
+
+///Returns the largest number of bytes that were in use at the same time
+size_t MATRECmemoryPeak(const MATREC * env);
+
+///Limits the number of bytes in use, so that allocations which would exceed the limit fail with MATREC_ERROR_MEMORY
+///instead of exhausting the memory of the machine. A limit of 0 (the default) removes the limit. After an allocation
+///failed, the object on which the failing call was made may only be freed.
+void MATRECsetMemoryLimit(MATREC * env, size_t limit);
+
 #define MATRECallocBlockArray(spqr, ptr, length) \
     MATRECimplAllocBlockArray(spqr,(void **) (ptr), sizeof(**(ptr)),length)
 
@@ -74,12 +93,38 @@ void MATRECimplFreeBlock(MATREC * env, void **ptr);
 
 ///Types which define matrix sizes
 ///Aliased so that switching is much easier if ever desired
+///The index width is chosen at build time by defining MATREC_INDEX_WIDTH as 32 or 64 (the default).
+///The 32-bit variant halves the memory used for indices, whereas the 64-bit variant supports matrices with more than
+///2^31 rows, columns or nonzeros. MATREC_index is the signed counterpart used inside the decompositions.
+#ifndef MATREC_INDEX_WIDTH
+#define MATREC_INDEX_WIDTH 64
+#endif
+
+#if MATREC_INDEX_WIDTH == 32
+typedef uint32_t MATREC_matrix_size;
+typedef int32_t MATREC_index;
+#define MATREC_INVALID UINT32_MAX
+#define MATREC_INDEX_MIN INT32_MIN
+#define MATREC_INDEX_MAX INT32_MAX
+#define MATREC_PRIsize PRIu32
+#define MATREC_SCNsize SCNu32
+#define MATREC_PRIindex PRId32
+#elif MATREC_INDEX_WIDTH == 64
+typedef uint64_t MATREC_matrix_size;
+typedef int64_t MATREC_index;
+#define MATREC_INVALID UINT64_MAX
+#define MATREC_INDEX_MIN INT64_MIN
+#define MATREC_INDEX_MAX INT64_MAX
+#define MATREC_PRIsize PRIu64
+#define MATREC_SCNsize SCNu64
+#define MATREC_PRIindex PRId64
+#else
+#error "MATREC_INDEX_WIDTH must be either 32 or 64"
+#endif
 
-typedef size_t MATREC_matrix_size;
 typedef MATREC_matrix_size MATREC_row;
 typedef MATREC_matrix_size MATREC_col;
 
-#define MATREC_INVALID ULLONG_MAX //TODO: this should maybe be ULLONG_MAX or SSIZE_MAX? Check...
 #define MATREC_INVALID_ROW MATREC_INVALID
 #define MATREC_INVALID_COL MATREC_INVALID
 
@@ -88,6 +133,51 @@ bool MATRECrowIsValid(MATREC_row row);
 bool MATRECcolIsInvalid(MATREC_col col);
 bool MATRECcolIsValid(MATREC_col col);
 
+///The number of 64-bit words needed to store the packed signs of the given number of nonzeros
+#define MATREC_SIGN_WORDS(numNonzeros) (((size_t) (numNonzeros) + 63) / 64)
+
+///A row or a column of a matrix
+typedef struct{
+    MATREC_matrix_size index;
+    bool isRow;
+} MATRECElement;
+
+///The type of the member of a decomposition which contains an element
+typedef enum{
+    MATREC_MEMBER_RIGID = 0, ///A 3-connected graph
+    MATREC_MEMBER_PARALLEL = 1, ///A bond, which consists of parallel edges
+    MATREC_MEMBER_SERIES = 2, ///A polygon, which consists of edges in series
+    MATREC_MEMBER_LOOP = 3,
+    MATREC_MEMBER_NOT_CONTAINED = 4 ///The element is not in the decomposition
+} MATRECMemberType;
+
+///The maximal number of arrays in a MATRECMemoryReport
+#define MATREC_MEMORY_MAX_ARRAYS 48
+
+///The memory of a single array of a decomposition or an addition
+typedef struct{
+    const char * name;
+    size_t allocatedBytes; ///Bytes allocated for the array
+    size_t usedBytes; ///Bytes of the array which hold data that is currently in use
+} MATRECArrayMemory;
+
+///The memory of a decomposition or an addition, broken down by array. Arrays indexed by the nodes, members or arcs of
+///the decomposition count as fully used, while call stacks and scratch memory count as unused, as they only hold data
+///during a Check call
+typedef struct{
+    size_t allocatedBytes; ///Sum of the allocated bytes of all arrays
+    size_t usedBytes; ///Sum of the used bytes of all arrays
+    size_t peakBytes; ///Largest number of allocated bytes since the object was created
+    size_t numArrays;
+    MATRECArrayMemory arrays[MATREC_MEMORY_MAX_ARRAYS];
+} MATRECMemoryReport;
+
+///How a decomposition stores the mapping from rows and columns to its elements
+typedef enum{
+    MATREC_IDS_DENSE = 0, ///An array indexed by the row or column, which grows to fit the largest index that is added
+    MATREC_IDS_HASHED = 1 ///A hash table, whose size is proportional to the number of rows or columns that are added
+} MATRECIdStorage;
+
 
 
 
@@ -0,0 +1,44 @@
+#ifndef MATREC_STREAM_H
+#define MATREC_STREAM_H
+
+#include "Shared.h"
+#include "Network.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+typedef enum{
+    MATREC_STREAM_COLUMNS = 0, ///Consecutive nonzeros in the same column form a column, which is added as a column
+    MATREC_STREAM_ROWS = 1     ///Consecutive nonzeros in the same row form a row, which is added as a row
+} MATRECStreamOrientation;
+
+typedef struct{
+    bool isNetwork;                 /**< \brief Whether all rows or columns in the stream could be added. */
+    MATREC_matrix_size numAdded;    /**< \brief Number of rows or columns which were added to the decomposition. */
+    MATREC_matrix_size failedIndex; /**< \brief The row or column which could not be added, or MATREC_INVALID. */
+} MATRECStreamResult;
+
+/**
+ * \brief Checks if the matrix in the file \p stream is network, while it is being read.
+ *
+ * The stream has the same text format as MATRECreadDoubleMatrixFromStream(), but the nonzeros of each column (or row,
+ * depending on \p orientation) must be consecutive. A producer thread parses the stream and places the columns into a
+ * ring buffer holding at most \p bufferCapacity columns, from which the calling thread adds them to the decomposition.
+ * Thus, parsing and recognition overlap and the full matrix is never stored. Stops reading at the first column which
+ * can not be added. Works on any stream, including stdin.
+ */
+MATREC_ERROR MATRECNetworkStreamRecognize(
+        MATREC * env,                                   /**< MATREC environment. */
+        FILE * stream,                                  /**< File stream to read the matrix from. */
+        MATRECStreamOrientation orientation,            /**< Whether to add the matrix column-wise or row-wise. */
+        MATREC_matrix_size bufferCapacity,              /**< Maximal number of parsed columns waiting to be added. */
+        MATRECStreamResult * result,                    /**< Pointer to where the result is to be stored. */
+        MATRECNetworkDecomposition ** pDecomposition    /**< If not \c NULL, stores the final decomposition here. */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MATREC_STREAM_H
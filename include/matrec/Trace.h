@@ -0,0 +1,84 @@
+#ifndef MATREC_TRACE_H
+#define MATREC_TRACE_H
+
+#include "Shared.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+///The calls which are recorded in a trace
+typedef enum{
+    MATREC_TRACE_NETWORK_CREATE = 0,             ///Creating an empty network decomposition
+    MATREC_TRACE_GRAPHIC_CREATE = 1,             ///Creating an empty graphic decomposition
+    MATREC_TRACE_NETWORK_CREATE_FROM_GRAPH = 2,  ///Creating a network decomposition from a graph
+    MATREC_TRACE_GRAPHIC_CREATE_FROM_GRAPH = 3,  ///Creating a graphic decomposition from a graph
+    MATREC_TRACE_FREE = 4,                       ///Freeing a decomposition
+    MATREC_TRACE_RESET = 5,                      ///Resetting a network decomposition
+    MATREC_TRACE_FLATTEN = 6,                    ///Flattening a decomposition
+    MATREC_TRACE_SET_AUTO_FLATTEN = 7,           ///Setting the automatic flattening threshold of a decomposition
+    MATREC_TRACE_COLUMN_CHECK = 8,               ///A column check, with its nonzeros and its outcome
+    MATREC_TRACE_COLUMN_ADD = 9,                 ///Adding the last checked column of a column addition
+    MATREC_TRACE_ROW_CHECK = 10,                 ///A row check, with its nonzeros and its outcome
+    MATREC_TRACE_ROW_ADD = 11,                   ///Adding the last checked row of a row addition
+    MATREC_TRACE_FREE_ADDITION = 12,             ///Freeing a row or column addition
+    MATREC_TRACE_NUM_CALLS = 13
+} MATRECTraceCall;
+
+typedef struct{
+    size_t numCalls[MATREC_TRACE_NUM_CALLS];    /**< \brief Number of replayed calls of each type. */
+    double totalSeconds[MATREC_TRACE_NUM_CALLS]; /**< \brief Total time spent in the calls of each type. */
+    double maxSeconds[MATREC_TRACE_NUM_CALLS];   /**< \brief Time of the slowest call of each type. */
+    size_t numMismatches;                        /**< \brief Number of checks whose outcome differs from the trace. */
+} MATRECTraceStatistics;
+
+/**
+ * \brief Starts recording the calls on decompositions created with \p env to the file \p trace.
+ *
+ * Records every creation, check, addition and free of the decompositions which are created while the trace is active,
+ * and of the row and column additions used with them, in a compact binary format. A check is recorded with its
+ * nonzeros and with whether the row or column can be added. Only indices and signs are recorded, so traces contain no
+ * names. Calls from several threads are recorded in the order in which they finish. Must not be called concurrently
+ * with other calls on the environment.
+ */
+MATREC_ERROR MATRECtraceStart(
+        MATREC * env,       /**< MATREC environment. */
+        FILE * trace        /**< File stream to write the trace to, which must be opened in binary mode. */
+);
+
+/**
+ * \brief Stops recording calls and flushes the trace, without closing it.
+ *
+ * Returns MATREC_ERROR_INPUT if the trace could not be written. Freeing the environment also stops the trace.
+ */
+MATREC_ERROR MATRECtraceStop(
+        MATREC * env        /**< MATREC environment. */
+);
+
+/**
+ * \brief Replays the calls in the file \p trace, and measures the time of each call.
+ *
+ * Only the time spent in the replayed call itself is measured. Checks whose outcome differs from the recorded outcome
+ * are counted as mismatches, and their additions are skipped. If \p callTimes is not \c NULL, a line with the name
+ * and the time in seconds of every call is written to it. Decompositions and additions which are not freed in the
+ * trace are freed at the end. Returns MATREC_ERROR_INPUT if the trace is not a valid trace.
+ */
+MATREC_ERROR MATRECtraceReplay(
+        MATREC * env,                           /**< MATREC environment. */
+        FILE * trace,                           /**< File stream to read the trace from. */
+        FILE * callTimes,                       /**< If not \c NULL, file stream to write the time of each call to. */
+        MATRECTraceStatistics * statistics      /**< Pointer to where the statistics are to be stored. */
+);
+
+/**
+ * \brief Returns a short name of the call, for printing.
+ */
+const char * MATRECtraceCallName(
+        MATRECTraceCall call /**< The call. */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MATREC_TRACE_H
@@ -0,0 +1,225 @@
+#include "AncestorIndex.h"
+
+static MATREC_index maxIndex(MATREC_index a, MATREC_index b){
+    return a > b ? a : b;
+}
+
+static MATREC_index ancestorAt(const MATRECAncestorIndex * index, MATREC_index level, MATREC_index node){
+    return index->ancestors[level * index->memNodes + node];
+}
+
+static void setAncestor(MATRECAncestorIndex * index, MATREC_index level, MATREC_index node, MATREC_index ancestor){
+    index->ancestors[level * index->memNodes + node] = ancestor;
+}
+
+///Returns the ancestor which is distance levels above the node
+static MATREC_index ancestorAbove(const MATRECAncestorIndex * index, MATREC_index node, MATREC_index distance){
+    for (MATREC_index level = 0; distance > 0 && node >= 0; ++level, distance >>= 1) {
+        if(distance & 1){
+            node = ancestorAt(index,level,node);
+        }
+    }
+    return node;
+}
+
+void MATRECancestorIndexCreate(MATRECAncestorIndex * index){
+    assert(index);
+    index->valid = false;
+    index->numNodes = 0;
+    index->numLevels = 0;
+    index->memNodes = 0;
+    index->memAncestors = 0;
+    index->depth = NULL;
+    index->ancestors = NULL;
+    index->stack = NULL;
+    index->walkSteps = 0;
+    index->repairSteps = 0;
+}
+
+void MATRECancestorIndexFree(MATREC * env, MATRECAncestorIndex * index){
+    assert(env);
+    assert(index);
+    //A failed build may leave arrays which are allocated but not yet counted in memNodes
+    MATRECfreeBlockArray(env,&index->stack);
+    MATRECfreeBlockArray(env,&index->depth);
+    MATRECfreeBlockArray(env,&index->ancestors);
+    index->memNodes = 0;
+    index->memAncestors = 0;
+    index->valid = false;
+}
+
+static MATREC_ERROR reserveAncestors(MATREC * env, MATRECAncestorIndex * index, MATREC_index size){
+    if(size > index->memAncestors){
+        MATREC_index newSize = maxIndex(2 * index->memAncestors, size);
+        MATREC_CALL(MATRECreallocBlockArray(env,&index->ancestors,(size_t) newSize));
+        index->memAncestors = newSize;
+    }
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECancestorIndexBuild(MATREC * env, MATRECAncestorIndex * index, MATREC_index numNodes,
+                                      MATRECAncestorIndexParent parent, void * data){
+    assert(env);
+    assert(index);
+    assert(parent);
+    index->valid = false;
+    if(numNodes > index->memNodes){
+        //Leave room for the nodes which are added while the index is repaired
+        MATREC_index newSize = maxIndex(2 * index->memNodes, 2 * numNodes);
+        //Reallocating also allocates arrays which are still NULL. If the second array fails, memNodes keeps the
+        //size that both arrays have
+        MATREC_CALL(MATRECreallocBlockArray(env,&index->depth,(size_t) newSize));
+        MATREC_CALL(MATRECreallocBlockArray(env,&index->stack,(size_t) newSize));
+        index->memNodes = newSize;
+    }
+    MATREC_CALL(reserveAncestors(env,index,maxIndex(index->memNodes,1)));
+    index->numNodes = numNodes;
+
+    //The first level holds the parents
+    for (MATREC_index node = 0; node < numNodes; ++node) {
+        MATREC_index nodeParent = parent(data,node);
+        setAncestor(index,0,node,nodeParent < 0 ? -1 : nodeParent);
+        index->depth[node] = -1;
+    }
+
+    //Compute the depths by walking up to the first node with a known depth
+    MATREC_index maxDepth = 0;
+    for (MATREC_index node = 0; node < numNodes; ++node) {
+        MATREC_index stackSize = 0;
+        MATREC_index current = node;
+        while(current >= 0 && index->depth[current] < 0){
+            index->stack[stackSize] = current;
+            ++stackSize;
+            current = ancestorAt(index,0,current);
+        }
+        MATREC_index depth = current < 0 ? -1 : index->depth[current];
+        while(stackSize > 0){
+            --stackSize;
+            ++depth;
+            index->depth[index->stack[stackSize]] = depth;
+        }
+        maxDepth = maxIndex(maxDepth,depth);
+    }
+
+    index->numLevels = 1;
+    while(((MATREC_index) 1 << index->numLevels) <= maxDepth){
+        ++index->numLevels;
+    }
+    MATREC_CALL(reserveAncestors(env,index,index->numLevels * maxIndex(index->memNodes,1)));
+    for (MATREC_index level = 1; level < index->numLevels; ++level) {
+        for (MATREC_index node = 0; node < numNodes; ++node) {
+            MATREC_index half = ancestorAt(index,level - 1,node);
+            setAncestor(index,level,node,half < 0 ? -1 : ancestorAt(index,level - 1,half));
+        }
+    }
+    index->valid = true;
+    index->walkSteps = 0;
+    index->repairSteps = 0;
+    return MATREC_OKAY;
+}
+
+///Invalidates the index such that it is rebuilt the next time it is needed
+static void invalidateAndRebuild(MATRECAncestorIndex * index, MATREC_index numNodes){
+    index->valid = false;
+    index->walkSteps = (size_t) numNodes * (size_t) maxIndex(index->numLevels,1) + 1;
+}
+
+void MATRECancestorIndexRepair(MATRECAncestorIndex * index, MATREC_index numNodes, MATREC_index node,
+                               MATRECAncestorIndexParent parent, MATRECAncestorIndexChildren children, void * data){
+    assert(index);
+    assert(parent);
+    assert(children);
+    assert(node >= 0 && node < numNodes);
+    if(!index->valid){
+        return;
+    }
+    if(numNodes > index->memNodes){
+        invalidateAndRebuild(index,numNodes);
+        return;
+    }
+    index->numNodes = numNodes;
+
+    //Visit the subtree in breadth first order, so that the entries of the parent of each node are computed first
+    MATREC_index * queue = index->stack;
+    queue[0] = node;
+    MATREC_index queueEnd = 1;
+    for (MATREC_index queueStart = 0; queueStart < queueEnd; ++queueStart) {
+        MATREC_index current = queue[queueStart];
+        MATREC_index currentParent = parent(data,current);
+        if(currentParent < 0){
+            index->depth[current] = 0;
+            for (MATREC_index level = 0; level < index->numLevels; ++level) {
+                setAncestor(index,level,current,-1);
+            }
+        }else{
+            MATREC_index depth = index->depth[currentParent] + 1;
+            if(depth >= ((MATREC_index) 1 << index->numLevels)){
+                //The index has too few levels for the deeper tree
+                invalidateAndRebuild(index,numNodes);
+                return;
+            }
+            index->depth[current] = depth;
+            setAncestor(index,0,current,currentParent);
+            for (MATREC_index level = 1; level < index->numLevels; ++level) {
+                MATREC_index half = ancestorAt(index,level - 1,current);
+                setAncestor(index,level,current,half < 0 ? -1 : ancestorAt(index,level - 1,half));
+            }
+        }
+        queueEnd += children(data,current,&queue[queueEnd]);
+        assert(queueEnd <= numNodes);
+    }
+
+    //Once repairs have cost as much as a rebuild, leave it to the walks to decide when the index pays off again
+    index->repairSteps += (size_t) queueEnd;
+    if(index->repairSteps > (size_t) numNodes * (size_t) index->numLevels){
+        index->valid = false;
+        index->walkSteps = 0;
+    }
+}
+
+bool MATRECancestorIndexShouldBuild(const MATRECAncestorIndex * index, MATREC_index numNodes){
+    assert(index);
+    return !index->valid &&
+           index->walkSteps > (size_t) numNodes * (size_t) maxIndex(index->numLevels,1);
+}
+
+MATREC_index MATRECancestorIndexRoot(const MATRECAncestorIndex * index, MATREC_index node){
+    assert(index);
+    assert(index->valid);
+    assert(node >= 0 && node < index->numNodes);
+    return ancestorAbove(index,node,index->depth[node]);
+}
+
+MATREC_index MATRECancestorIndexLCA(const MATRECAncestorIndex * index, MATREC_index first, MATREC_index second){
+    assert(index);
+    assert(index->valid);
+    assert(first >= 0 && first < index->numNodes);
+    assert(second >= 0 && second < index->numNodes);
+    if(index->depth[first] < index->depth[second]){
+        MATREC_index temp = first;
+        first = second;
+        second = temp;
+    }
+    first = ancestorAbove(index,first,index->depth[first] - index->depth[second]);
+    if(first == second){
+        return first;
+    }
+    for (MATREC_index level = index->numLevels - 1; level >= 0; --level) {
+        MATREC_index firstAncestor = ancestorAt(index,level,first);
+        MATREC_index secondAncestor = ancestorAt(index,level,second);
+        if(firstAncestor != secondAncestor){
+            first = firstAncestor;
+            second = secondAncestor;
+        }
+    }
+    //If the nodes are in different trees, both are roots at this point
+    return ancestorAt(index,0,first);
+}
+
+void MATRECancestorIndexMemory(const MATRECAncestorIndex * index, const char * name, MATRECMemoryReport * report){
+    assert(index);
+    size_t allocated = sizeof(MATREC_index) * (size_t) (2 * index->memNodes + index->memAncestors);
+    //The stack is only used while building the index
+    size_t used = index->valid ? sizeof(MATREC_index) * (size_t) (index->numNodes * (index->numLevels + 1)) : 0;
+    MATRECmemoryReportAddBytes(report, name, allocated, used);
+}
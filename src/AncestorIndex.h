@@ -0,0 +1,56 @@
+#ifndef MATREC_ANCESTORINDEX_H
+#define MATREC_ANCESTORINDEX_H
+
+#include "matrec/Shared.h"
+#include "Memory.h"
+
+///Binary lifting index over a forest given by parent pointers. Not part of the public interface.
+///Once built, the depth, the k-th ancestor and the lowest common ancestor of nodes are found in O(log n) steps,
+///independent of the depth of the forest. When a subtree of the forest changes, the index is repaired in place by
+///recomputing the entries of that subtree only.
+typedef struct {
+    bool valid;
+    MATREC_index numNodes;
+    MATREC_index numLevels;
+    MATREC_index memNodes;
+    MATREC_index memAncestors;
+    MATREC_index * depth;
+    MATREC_index * ancestors; ///ancestors[level * memNodes + node] is the 2^level-th ancestor of node, or -1
+    MATREC_index * stack;
+    size_t walkSteps; ///Steps walked through the forest while the index was invalid, used to decide when to build it
+    size_t repairSteps; ///Nodes recomputed by repairs since the index was built
+} MATRECAncestorIndex;
+
+///Returns the parent of the given node, or a negative value if it is a root
+typedef MATREC_index (*MATRECAncestorIndexParent)(void * data, MATREC_index node);
+
+///Writes the children of the given node to children, and returns how many there are
+typedef MATREC_index (*MATRECAncestorIndexChildren)(void * data, MATREC_index node, MATREC_index * children);
+
+void MATRECancestorIndexCreate(MATRECAncestorIndex * index);
+
+void MATRECancestorIndexFree(MATREC * env, MATRECAncestorIndex * index);
+
+///Builds the index over nodes 0..numNodes-1 in O(n log d) time, where d is the depth of the forest
+MATREC_ERROR MATRECancestorIndexBuild(MATREC * env, MATRECAncestorIndex * index, MATREC_index numNodes,
+                                      MATRECAncestorIndexParent parent, void * data);
+
+///Recomputes the entries of the given node and of all its descendants, after the forest changed only within that
+///subtree. The entries of the parent of the node must still be correct. Nodes numbered from the old number of nodes
+///up to numNodes may be added to the subtree. This takes O(s log d) time for a subtree of s nodes. If the index can not
+///be repaired in place, or repairs have cost more than building it, it is invalidated and rebuilt when it is needed
+void MATRECancestorIndexRepair(MATRECAncestorIndex * index, MATREC_index numNodes, MATREC_index node,
+                               MATRECAncestorIndexParent parent, MATRECAncestorIndexChildren children, void * data);
+
+///Returns true if the steps walked without the index since it was invalidated exceed the cost of building it
+bool MATRECancestorIndexShouldBuild(const MATRECAncestorIndex * index, MATREC_index numNodes);
+
+MATREC_index MATRECancestorIndexRoot(const MATRECAncestorIndex * index, MATREC_index node);
+
+///Returns the lowest common ancestor of both nodes, or -1 if they are in different trees
+MATREC_index MATRECancestorIndexLCA(const MATRECAncestorIndex * index, MATREC_index first, MATREC_index second);
+
+///Adds the arrays of the index to the report as one array
+void MATRECancestorIndexMemory(const MATRECAncestorIndex * index, const char * name, MATRECMemoryReport * report);
+
+#endif //MATREC_ANCESTORINDEX_H
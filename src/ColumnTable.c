@@ -0,0 +1,146 @@
+#include "ColumnTable.h"
+
+///Returns the slot which holds the first column with the given hash, or the empty slot where it should be inserted
+static MATREC_index firstSlot(const MATRECColumnTable * table, uint64_t hash){
+    return (MATREC_index) ((hash ^ (hash >> 32)) & (uint64_t) (table->memSlots - 1));
+}
+
+static bool slotIsEmpty(const MATRECColumnTable * table, MATREC_index slot){
+    return table->slots[slot].epoch != table->epoch;
+}
+
+static MATREC_index findEmptySlot(const MATRECColumnTable * table, uint64_t hash){
+    MATREC_index mask = table->memSlots - 1;
+    MATREC_index slot = firstSlot(table,hash);
+    while(!slotIsEmpty(table,slot)){
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+///Marks all slots as empty for every epoch other than zero
+static void resetSlots(MATRECColumnTable * table){
+    for (MATREC_index i = 0; i < table->memSlots; ++i) {
+        table->slots[i].epoch = 0;
+    }
+}
+
+///Doubles the number of slots. On failure, the table is left unchanged
+static MATREC_ERROR growSlots(MATREC * env, MATRECColumnTable * table){
+    MATREC_index oldMemSlots = table->memSlots;
+    MATREC_index newMemSlots = oldMemSlots == 0 ? 16 : 2 * oldMemSlots;
+    MATRECColumnTableSlot * newSlots = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&newSlots,(size_t) newMemSlots));
+    MATRECColumnTableSlot * oldSlots = table->slots;
+    table->slots = newSlots;
+    table->memSlots = newMemSlots;
+    resetSlots(table);
+    for (MATREC_index i = 0; i < oldMemSlots; ++i) {
+        if(oldSlots[i].epoch == table->epoch){
+            table->slots[findEmptySlot(table,oldSlots[i].hash)] = oldSlots[i];
+        }
+    }
+    MATRECfreeBlockArray(env,&oldSlots);
+    return MATREC_OKAY;
+}
+
+void MATRECcolumnTableCreate(MATRECColumnTable * table){
+    assert(table);
+    table->slots = NULL;
+    table->memSlots = 0;
+    table->numUsedSlots = 0;
+    table->epoch = 1;
+}
+
+void MATRECcolumnTableFree(MATREC * env, MATRECColumnTable * table){
+    assert(env);
+    assert(table);
+    MATRECfreeBlockArray(env,&table->slots);
+    table->memSlots = 0;
+}
+
+void MATRECcolumnTableClear(MATRECColumnTable * table){
+    assert(table);
+    if(table->numUsedSlots == 0){
+        return;
+    }
+    ++table->epoch;
+    //Only when the epoch wraps around, the slots of old epochs need to be emptied
+    if(table->epoch == 0){
+        resetSlots(table);
+        table->epoch = 1;
+    }
+    table->numUsedSlots = 0;
+}
+
+void MATRECcolumnTableShrink(MATREC * env, MATRECColumnTable * table){
+    assert(env);
+    assert(table);
+    if(table->numUsedSlots == 0){
+        MATRECcolumnTableFree(env,table);
+        MATRECcolumnTableCreate(table);
+    }
+}
+
+uint64_t MATRECcolumnTableEntryHash(MATREC_row row, bool negative){
+    //splitmix64 finalizer, so that sums of the hashes of different sets of entries rarely collide
+    uint64_t hash = 2 * (uint64_t) row + (negative ? 1 : 0);
+    hash += 0x9E3779B97F4A7C15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+    return hash ^ (hash >> 31);
+}
+
+MATREC_ERROR MATRECcolumnTableReserve(MATREC * env, MATRECColumnTable * table){
+    assert(env);
+    assert(table);
+    if(2 * (table->numUsedSlots + 1) > table->memSlots){
+        MATREC_CALL(growSlots(env,table));
+    }
+    return MATREC_OKAY;
+}
+
+void MATRECcolumnTableInsert(MATRECColumnTable * table, uint64_t hash, MATREC_col column, MATREC_index numEntries){
+    assert(table);
+    assert(MATRECcolIsValid(column));
+    if(2 * (table->numUsedSlots + 1) > table->memSlots){
+        return;
+    }
+    MATRECColumnTableSlot * slot = &table->slots[findEmptySlot(table,hash)];
+    slot->hash = hash;
+    slot->column = column;
+    slot->numEntries = numEntries;
+    slot->epoch = table->epoch;
+    ++table->numUsedSlots;
+}
+
+MATREC_ERROR MATRECcolumnTableFind(const MATRECColumnTable * table, uint64_t hash, MATREC_index numEntries, bool negated,
+                                   MATRECColumnTableMatch match, void * data, MATREC_col * pColumn){
+    assert(table);
+    assert(match);
+    assert(pColumn);
+    *pColumn = MATREC_INVALID_COL;
+    if(table->numUsedSlots == 0){
+        return MATREC_OKAY;
+    }
+    MATREC_index mask = table->memSlots - 1;
+    for (MATREC_index slot = firstSlot(table,hash); !slotIsEmpty(table,slot); slot = (slot + 1) & mask) {
+        const MATRECColumnTableSlot * candidate = &table->slots[slot];
+        if(candidate->hash != hash || candidate->numEntries != numEntries){
+            continue;
+        }
+        bool matches = false;
+        MATREC_CALL(match(data,candidate->column,negated,&matches));
+        if(matches){
+            *pColumn = candidate->column;
+            return MATREC_OKAY;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+void MATRECcolumnTableMemory(const MATRECColumnTable * table, MATRECMemoryReport * report){
+    assert(table);
+    MATRECmemoryReportAdd(report, "columnTableSlots", sizeof(MATRECColumnTableSlot), table->memSlots,
+                          table->numUsedSlots);
+}
@@ -0,0 +1,62 @@
+#ifndef MATREC_COLUMNTABLE_H
+#define MATREC_COLUMNTABLE_H
+
+#include "matrec/Shared.h"
+#include "Memory.h"
+
+///Hashes of the signed row supports of columns, used to recognize duplicate columns. Not part of the public interface.
+///The hash of a column is the sum of the hashes of its entries, so that it does not depend on the order of the
+///nonzeros. Only the hash and the number of nonzeros of each column are stored. Candidates with an equal hash are
+///passed to a function which compares them with the decomposition, so hash collisions never lead to false matches.
+typedef struct {
+    MATREC_row row;
+    bool negative;
+} MATRECColumnTableEntry;
+
+typedef struct {
+    uint64_t hash;
+    MATREC_col column;
+    MATREC_index numEntries;
+    uint32_t epoch; ///The slot is empty unless this is the epoch of the table
+} MATRECColumnTableSlot;
+
+typedef struct {
+    MATRECColumnTableSlot * slots;
+    MATREC_index memSlots; ///Always zero or a power of two
+    MATREC_index numUsedSlots;
+    uint32_t epoch; ///Incremented by every clear, which makes all slots empty at once
+} MATRECColumnTable;
+
+///Sets *pMatches to true if the given column has exactly the entries that are being looked up, with opposite signs if
+///negated
+typedef MATREC_ERROR (*MATRECColumnTableMatch)(void * data, MATREC_col column, bool negated, bool * pMatches);
+
+void MATRECcolumnTableCreate(MATRECColumnTable * table);
+
+void MATRECcolumnTableFree(MATREC * env, MATRECColumnTable * table);
+
+///Removes all columns from the table in constant time, but keeps the memory
+void MATRECcolumnTableClear(MATRECColumnTable * table);
+
+///Frees the memory of the table if it is empty
+void MATRECcolumnTableShrink(MATREC * env, MATRECColumnTable * table);
+
+///Returns the hash of a single entry. The hash of a column is the sum of the hashes of its entries
+uint64_t MATRECcolumnTableEntryHash(MATREC_row row, bool negative);
+
+///Makes room for one more column, so that the next insert does not need to allocate
+MATREC_ERROR MATRECcolumnTableReserve(MATREC * env, MATRECColumnTable * table);
+
+///Stores the hash of a column with the given number of entries. Never fails: if there is no room, because no room was
+///reserved for the column, it is not stored and duplicates of it are simply not recognized
+void MATRECcolumnTableInsert(MATRECColumnTable * table, uint64_t hash, MATREC_col column, MATREC_index numEntries);
+
+///Finds the first column with the given hash and number of entries which matches, or MATREC_INVALID_COL if there is
+///none. If negated is true, hash must be the hash of the negated entries
+MATREC_ERROR MATRECcolumnTableFind(const MATRECColumnTable * table, uint64_t hash, MATREC_index numEntries, bool negated,
+                                   MATRECColumnTableMatch match, void * data, MATREC_col * pColumn);
+
+///Adds the slots of the table to the report
+void MATRECcolumnTableMemory(const MATRECColumnTable * table, MATRECMemoryReport * report);
+
+#endif //MATREC_COLUMNTABLE_H
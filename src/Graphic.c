@@ -1,11 +1,18 @@
 #include "matrec/Graphic.h"
+#include "IdMap.h"
+#include "AncestorIndex.h"
+#include "ColumnTable.h"
+#include "Memory.h"
+#include "Storage.h"
+#include "Triconnected.h"
+#include "Trace.h"
 #include <assert.h>
 
 //Columns 0..x correspond to elements 0..x
 //Rows 0..y correspond to elements -1.. -y-1
-#define MARKER_ROW_ELEMENT (INT_MIN)
-#define MARKER_COLUMN_ELEMENT (INT_MAX)
-typedef int spqr_element;
+#define MARKER_ROW_ELEMENT (MATREC_INDEX_MIN)
+#define MARKER_COLUMN_ELEMENT (MATREC_INDEX_MAX)
+typedef MATREC_index spqr_element;
 
 static bool SPQRelementIsRow(spqr_element element){
     return element < 0;
@@ -31,7 +38,7 @@ static spqr_element MATRECcolumnToElement(MATREC_col column){
     return (spqr_element) column;
 }
 
-typedef int spqr_node;
+typedef MATREC_index spqr_node;
 #define SPQR_INVALID_NODE (-1)
 
 static bool SPQRnodeIsInvalid(spqr_node node){
@@ -41,7 +48,7 @@ static bool SPQRnodeIsValid(spqr_node node){
     return !SPQRnodeIsInvalid(node);
 }
 
-typedef int spqr_member;
+typedef MATREC_index spqr_member;
 #define SPQR_INVALID_MEMBER (-1)
 
 static bool SPQRmemberIsInvalid(spqr_member member){
@@ -51,8 +58,8 @@ static bool SPQRmemberIsValid(spqr_member member){
     return !SPQRmemberIsInvalid(member);
 }
 
-typedef int spqr_edge;
-#define SPQR_INVALID_EDGE (INT_MAX)
+typedef MATREC_index spqr_edge;
+#define SPQR_INVALID_EDGE (MATREC_INDEX_MAX)
 
 static bool SPQRedgeIsInvalid(spqr_edge edge){
     return edge == SPQR_INVALID_EDGE;
@@ -78,9 +85,15 @@ typedef struct{
 typedef struct {
     spqr_node representativeNode;
     spqr_edge firstEdge;//first edge of the neighbouring edges
-    int numEdges;
+    MATREC_index numEdges;
+    MATREC_index adjacencyStart; //First entry of this node in the adjacency snapshot of its member, if it has one
 } SPQRGraphicDecompositionNode;
 
+typedef struct {
+    spqr_edge edge;
+    spqr_node node; //The other endpoint of the edge
+} SPQRGraphicAdjacencyEntry;
+
 typedef struct {
     spqr_node head;
     spqr_node tail;
@@ -103,38 +116,68 @@ typedef struct {
     spqr_edge markerOfParent;
 
     spqr_edge firstEdge; //First of the members' linked-list edge array
-    int num_edges;
+    MATREC_index num_edges;
+
+    size_t adjacencyVersion; //Equal to the adjacency version of the decomposition if the adjacency snapshot is valid
+
+    //Union-find of the members of each connected component. Components are only ever joined, so two members are
+    //united whenever one becomes the parent of the other
+    spqr_member componentRepresentative;
+    MATREC_index componentSize;
 } SPQRGraphicDecompositionMember;
 
 struct MATRECGraphicDecompositionImpl {
-    int numEdges;
-    int memEdges;
-    SPQRGraphicDecompositionEdge *edges;
+    MATREC_index numEdges;
+    MATREC_index memEdges;
+    MATRECStorage edges;
     spqr_edge firstFreeEdge;
 
-    int memMembers;
-    int numMembers;
-    SPQRGraphicDecompositionMember *members;
+    MATREC_index memMembers;
+    MATREC_index numMembers;
+    MATRECStorage members;
 
-    int memNodes;
-    int numNodes;
-    SPQRGraphicDecompositionNode *nodes;
+    MATREC_index memNodes;
+    MATREC_index numNodes;
+    MATRECStorage nodes;
 
-    int memRows;
-    int numRows;
-    spqr_edge * rowEdges;
-
-    int memColumns;
-    int numColumns;
-    spqr_edge * columnEdges;
+    MATRECIdMap rowEdges;
+    MATRECIdMap columnEdges;
 
     MATREC * env;
 
-    int numConnectedComponents;
+    MATREC_index numConnectedComponents;
+
+    //Ancestor index of the member tree, which is invalidated whenever a row or column is added
+    MATRECAncestorIndex memberAncestors;
+
+    //Adjacency snapshots of rigid members, which store the edges around each node consecutively.
+    //A snapshot is built when a row check first searches the member, and is kept until the member is modified.
+    SPQRGraphicAdjacencyEntry *adjacencyEntries;
+    MATREC_index memAdjacencyEntries;
+    MATREC_index numAdjacencyEntries;
+    size_t adjacencyVersion; //Incremented when the snapshot storage is cleared, which invalidates all snapshots
+
+    //Rows of the added columns, used to place duplicate columns in parallel. Cleared when a row is added,
+    //as this changes the fundamental cycles of the columns
+    MATRECColumnTable columns;
+
+    //Statistics of the compressing union-find lookups since the last check, used for automatic flattening
+    size_t numFindCalls;
+    size_t numFindSteps;
+    double autoFlattenThreshold; //Maximal average chain length before flattening; 0 disables automatic flattening
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+
+    MATRECTraceId traceId;
 };
 
-static void swap_ints(int* a, int* b){
-    int temp = *a;
+//The elements are accessed through these, as they are stored in chunks if MATREC_SEGMENTED_STORAGE is defined
+#define EDGE(dec, index) MATRECstorageAt(SPQRGraphicDecompositionEdge, (dec)->edges, index)
+#define MEMBER(dec, index) MATRECstorageAt(SPQRGraphicDecompositionMember, (dec)->members, index)
+#define NODE(dec, index) MATRECstorageAt(SPQRGraphicDecompositionNode, (dec)->nodes, index)
+
+static void swap_indices(MATREC_index* a, MATREC_index* b){
+    MATREC_index temp = *a;
     *a = *b;
     *b = temp;
 }
@@ -144,7 +187,7 @@ static bool nodeIsRepresentative(const MATRECGraphicDecomposition *dec, spqr_nod
     assert(node < dec->memNodes);
     assert(SPQRnodeIsValid(node));
 
-    return SPQRnodeIsInvalid(dec->nodes[node].representativeNode);
+    return SPQRnodeIsInvalid(NODE(dec, node).representativeNode);
 }
 
 static spqr_node findNode(MATRECGraphicDecomposition *dec, spqr_node node) {
@@ -156,17 +199,24 @@ static spqr_node findNode(MATRECGraphicDecomposition *dec, spqr_node node) {
     spqr_node next;
 
     //traverse down tree to find the root
-    while (SPQRnodeIsValid(next = dec->nodes[current].representativeNode)) {
+    size_t steps = 0;
+    while (SPQRnodeIsValid(next = NODE(dec, current).representativeNode)) {
         current = next;
+        ++steps;
         assert(current < dec->memNodes);
     }
+    //The lookups are only counted when auto-flattening needs them
+    if(dec->autoFlattenThreshold > 0.0){
+        ++dec->numFindCalls;
+        dec->numFindSteps += steps;
+    }
 
     spqr_node root = current;
     current = node;
 
     //update all pointers along path to point to root, flattening the tree
-    while (SPQRnodeIsValid(next = dec->nodes[current].representativeNode)) {
-        dec->nodes[current].representativeNode = root;
+    while (SPQRnodeIsValid(next = NODE(dec, current).representativeNode)) {
+        NODE(dec, current).representativeNode = root;
         current = next;
         assert(current < dec->memNodes);
     }
@@ -182,7 +232,7 @@ static spqr_node findNodeNoCompression(const MATRECGraphicDecomposition *dec, sp
     spqr_node next;
 
     //traverse down tree to find the root
-    while (SPQRnodeIsValid(next = dec->nodes[current].representativeNode)) {
+    while (SPQRnodeIsValid(next = NODE(dec, current).representativeNode)) {
         current = next;
         assert(current < dec->memNodes);
     }
@@ -195,8 +245,8 @@ static spqr_node findEdgeTail(MATRECGraphicDecomposition *dec, spqr_edge edge) {
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_node representative = findNode(dec, dec->edges[edge].tail);
-    dec->edges[edge].tail = representative; //update the edge information
+    spqr_node representative = findNode(dec, EDGE(dec, edge).tail);
+    EDGE(dec, edge).tail = representative; //update the edge information
 
     return representative;
 }
@@ -205,8 +255,8 @@ static spqr_node findEdgeHead(MATRECGraphicDecomposition *dec, spqr_edge edge) {
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_node representative = findNode(dec, dec->edges[edge].head);
-    dec->edges[edge].head = representative;//update the edge information
+    spqr_node representative = findNode(dec, EDGE(dec, edge).head);
+    EDGE(dec, edge).head = representative;//update the edge information
 
     return representative;
 }
@@ -215,7 +265,7 @@ static spqr_node findEdgeHeadNoCompression(const MATRECGraphicDecomposition *dec
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_node representative = findNodeNoCompression(dec, dec->edges[edge].head);
+    spqr_node representative = findNodeNoCompression(dec, EDGE(dec, edge).head);
     return representative;
 }
 static spqr_node findEdgeTailNoCompression(const MATRECGraphicDecomposition *dec, spqr_edge edge) {
@@ -223,7 +273,7 @@ static spqr_node findEdgeTailNoCompression(const MATRECGraphicDecomposition *dec
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_node representative = findNodeNoCompression(dec, dec->edges[edge].tail);
+    spqr_node representative = findNodeNoCompression(dec, EDGE(dec, edge).tail);
     return representative;
 }
 
@@ -231,7 +281,7 @@ static spqr_edge getFirstNodeEdge(const MATRECGraphicDecomposition * dec, spqr_n
     assert(dec);
     assert(SPQRnodeIsValid(node));
     assert(node < dec->memNodes);
-    return dec->nodes[node].firstEdge;
+    return NODE(dec, node).firstEdge;
 }
 static spqr_edge getNextNodeEdgeNoCompression(const MATRECGraphicDecomposition * dec, spqr_edge edge, spqr_node node){
     assert(dec);
@@ -240,10 +290,10 @@ static spqr_edge getNextNodeEdgeNoCompression(const MATRECGraphicDecomposition *
     assert(nodeIsRepresentative(dec,node));
 
     if(findEdgeHeadNoCompression(dec,edge) == node){
-        edge = dec->edges[edge].headEdgeListNode.next;
+        edge = EDGE(dec, edge).headEdgeListNode.next;
     }else{
         assert(findEdgeTailNoCompression(dec,edge) == node);
-        edge = dec->edges[edge].tailEdgeListNode.next;
+        edge = EDGE(dec, edge).tailEdgeListNode.next;
     }
     return edge;
 }
@@ -254,11 +304,11 @@ static spqr_edge getNextNodeEdge(MATRECGraphicDecomposition * dec, spqr_edge edg
     assert(nodeIsRepresentative(dec,node));
 
     if(findEdgeHead(dec,edge) == node){
-        edge = dec->edges[edge].headEdgeListNode.next;
+        edge = EDGE(dec, edge).headEdgeListNode.next;
     }else{
         assert(findEdgeTailNoCompression(dec,edge) == node);
-        dec->edges[edge].tail = node; //This assignment is not necessary but speeds up future queries.
-        edge = dec->edges[edge].tailEdgeListNode.next;
+        EDGE(dec, edge).tail = node; //This assignment is not necessary but speeds up future queries.
+        edge = EDGE(dec, edge).tailEdgeListNode.next;
     }
     return edge;
 }
@@ -269,11 +319,11 @@ static spqr_edge getPreviousNodeEdge(MATRECGraphicDecomposition *dec, spqr_edge
     assert(nodeIsRepresentative(dec,node));
 
     if(findEdgeHead(dec,edge) == node){
-        edge = dec->edges[edge].headEdgeListNode.previous;
+        edge = EDGE(dec, edge).headEdgeListNode.previous;
     }else{
         assert(findEdgeTailNoCompression(dec,edge) == node);
-        dec->edges[edge].tail = node; //This assignment is not necessary but speeds up future queries.
-        edge = dec->edges[edge].tailEdgeListNode.previous;
+        EDGE(dec, edge).tail = node; //This assignment is not necessary but speeds up future queries.
+        edge = EDGE(dec, edge).tailEdgeListNode.previous;
     }
     return edge;
 }
@@ -284,11 +334,11 @@ static void mergeNodeEdgeList(MATRECGraphicDecomposition *dec, spqr_node toMerge
     spqr_edge firstFromEdge = getFirstNodeEdge(dec, toRemove);
     if(SPQRedgeIsInvalid(firstIntoEdge)){
         //new node has no edges
-        dec->nodes[toMergeInto].numEdges += dec->nodes[toRemove].numEdges;
-        dec->nodes[toRemove].numEdges = 0;
+        NODE(dec, toMergeInto).numEdges += NODE(dec, toRemove).numEdges;
+        NODE(dec, toRemove).numEdges = 0;
 
-        dec->nodes[toMergeInto].firstEdge = dec->nodes[toRemove].firstEdge;
-        dec->nodes[toRemove].firstEdge = SPQR_INVALID_EDGE;
+        NODE(dec, toMergeInto).firstEdge = NODE(dec, toRemove).firstEdge;
+        NODE(dec, toRemove).firstEdge = SPQR_INVALID_EDGE;
 
         return;
     }else if (SPQRedgeIsInvalid(firstFromEdge)){
@@ -303,27 +353,27 @@ static void mergeNodeEdgeList(MATRECGraphicDecomposition *dec, spqr_node toMerge
 
 
     SPQRGraphicDecompositionEdgeListNode * firstIntoNode = findEdgeHead(dec, firstIntoEdge) == toMergeInto ?
-                                                           &dec->edges[firstIntoEdge].headEdgeListNode :
-                                                           &dec->edges[firstIntoEdge].tailEdgeListNode;
+                                                           &EDGE(dec, firstIntoEdge).headEdgeListNode :
+                                                           &EDGE(dec, firstIntoEdge).tailEdgeListNode;
     SPQRGraphicDecompositionEdgeListNode * lastIntoNode = findEdgeHead(dec, lastIntoEdge) == toMergeInto ?
-                                                          &dec->edges[lastIntoEdge].headEdgeListNode :
-                                                          &dec->edges[lastIntoEdge].tailEdgeListNode;
+                                                          &EDGE(dec, lastIntoEdge).headEdgeListNode :
+                                                          &EDGE(dec, lastIntoEdge).tailEdgeListNode;
 
     SPQRGraphicDecompositionEdgeListNode * firstFromNode = findEdgeHead(dec, firstFromEdge) == toRemove ?
-                                                           &dec->edges[firstFromEdge].headEdgeListNode :
-                                                           &dec->edges[firstFromEdge].tailEdgeListNode;
+                                                           &EDGE(dec, firstFromEdge).headEdgeListNode :
+                                                           &EDGE(dec, firstFromEdge).tailEdgeListNode;
     SPQRGraphicDecompositionEdgeListNode * lastFromNode = findEdgeHead(dec, lastFromEdge) == toRemove ?
-                                                          &dec->edges[lastFromEdge].headEdgeListNode :
-                                                          &dec->edges[lastFromEdge].tailEdgeListNode;
+                                                          &EDGE(dec, lastFromEdge).headEdgeListNode :
+                                                          &EDGE(dec, lastFromEdge).tailEdgeListNode;
 
     firstIntoNode->previous = lastFromEdge;
     lastIntoNode->next = firstFromEdge;
     firstFromNode->previous = lastIntoEdge;
     lastFromNode->next = firstIntoEdge;
 
-    dec->nodes[toMergeInto].numEdges += dec->nodes[toRemove].numEdges;
-    dec->nodes[toRemove].numEdges = 0;
-    dec->nodes[toRemove].firstEdge = SPQR_INVALID_EDGE;
+    NODE(dec, toMergeInto).numEdges += NODE(dec, toRemove).numEdges;
+    NODE(dec, toRemove).numEdges = 0;
+    NODE(dec, toRemove).firstEdge = SPQR_INVALID_EDGE;
 }
 
 static spqr_node mergeNodes(MATRECGraphicDecomposition *dec, spqr_node first, spqr_node second) {
@@ -336,16 +386,16 @@ static spqr_node mergeNodes(MATRECGraphicDecomposition *dec, spqr_node first, sp
 
     //The rank is stored as a negative number: we decrement it making the negative number larger.
     // We want the new root to be the one with 'largest' rank, so smallest number. If they are equal, we decrement.
-    spqr_node firstRank = dec->nodes[first].representativeNode;
-    spqr_node secondRank = dec->nodes[second].representativeNode;
+    spqr_node firstRank = NODE(dec, first).representativeNode;
+    spqr_node secondRank = NODE(dec, second).representativeNode;
     if (firstRank > secondRank) {
-        swap_ints(&first, &second);
+        swap_indices(&first, &second);
     }
     //first becomes representative; we merge all of the edges of second into first
     mergeNodeEdgeList(dec,first,second);
-    dec->nodes[second].representativeNode = first;
+    NODE(dec, second).representativeNode = first;
     if (firstRank == secondRank) {
-        --dec->nodes[first].representativeNode;
+        --NODE(dec, first).representativeNode;
     }
     return first;
 }
@@ -355,7 +405,7 @@ static bool memberIsRepresentative(const MATRECGraphicDecomposition *dec, spqr_m
     assert(member < dec->memMembers);
     assert(SPQRmemberIsValid(member));
 
-    return SPQRmemberIsInvalid(dec->members[member].representativeMember);
+    return SPQRmemberIsInvalid(MEMBER(dec, member).representativeMember);
 }
 
 static spqr_member findMember(MATRECGraphicDecomposition *dec, spqr_member member) {
@@ -367,17 +417,24 @@ static spqr_member findMember(MATRECGraphicDecomposition *dec, spqr_member membe
     spqr_member next;
 
     //traverse down tree to find the root
-    while (SPQRmemberIsValid(next = dec->members[current].representativeMember)) {
+    size_t steps = 0;
+    while (SPQRmemberIsValid(next = MEMBER(dec, current).representativeMember)) {
         current = next;
+        ++steps;
         assert(current < dec->memMembers);
     }
+    //The lookups are only counted when auto-flattening needs them
+    if(dec->autoFlattenThreshold > 0.0){
+        ++dec->numFindCalls;
+        dec->numFindSteps += steps;
+    }
 
     spqr_member root = current;
     current = member;
 
     //update all pointers along path to point to root, flattening the tree
-    while (SPQRmemberIsValid(next = dec->members[current].representativeMember)) {
-        dec->members[current].representativeMember = root;
+    while (SPQRmemberIsValid(next = MEMBER(dec, current).representativeMember)) {
+        MEMBER(dec, current).representativeMember = root;
         current = next;
         assert(current < dec->memMembers);
     }
@@ -393,7 +450,7 @@ static spqr_member findMemberNoCompression(const MATRECGraphicDecomposition *dec
     spqr_member next;
 
     //traverse down tree to find the root
-    while (SPQRmemberIsValid(next = dec->members[current].representativeMember)) {
+    while (SPQRmemberIsValid(next = MEMBER(dec, current).representativeMember)) {
         current = next;
         assert(current < dec->memMembers);
     }
@@ -412,14 +469,14 @@ static spqr_member mergeMembers(MATRECGraphicDecomposition *dec, spqr_member fir
 
     //The rank is stored as a negative number: we decrement it making the negative number larger.
     // We want the new root to be the one with 'largest' rank, so smallest number. If they are equal, we decrement.
-    spqr_member firstRank = dec->members[first].representativeMember;
-    spqr_member secondRank = dec->members[second].representativeMember;
+    spqr_member firstRank = MEMBER(dec, first).representativeMember;
+    spqr_member secondRank = MEMBER(dec, second).representativeMember;
     if (firstRank > secondRank) {
-        swap_ints(&first, &second);
+        swap_indices(&first, &second);
     }
-    dec->members[second].representativeMember = first;
+    MEMBER(dec, second).representativeMember = first;
     if (firstRank == secondRank) {
-        --dec->members[first].representativeMember;
+        --MEMBER(dec, first).representativeMember;
     }
     return first;
 }
@@ -433,8 +490,8 @@ static spqr_member findEdgeMember(MATRECGraphicDecomposition *dec, spqr_edge edg
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_member representative = findMember(dec, dec->edges[edge].member);
-    dec->edges[edge].member = representative;
+    spqr_member representative = findMember(dec, EDGE(dec, edge).member);
+    EDGE(dec, edge).member = representative;
     return representative;
 }
 
@@ -443,7 +500,7 @@ static spqr_member findEdgeMemberNoCompression(const MATRECGraphicDecomposition
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_member representative = findMemberNoCompression(dec, dec->edges[edge].member);
+    spqr_member representative = findMemberNoCompression(dec, EDGE(dec, edge).member);
     return representative;
 }
 
@@ -454,11 +511,11 @@ static spqr_member findMemberParent(MATRECGraphicDecomposition *dec, spqr_member
     assert(memberIsRepresentative(dec,member));
 
 
-    if(SPQRmemberIsInvalid(dec->members[member].parentMember)){
-        return dec->members[member].parentMember;
+    if(SPQRmemberIsInvalid(MEMBER(dec, member).parentMember)){
+        return MEMBER(dec, member).parentMember;
     }
-    spqr_member parent_representative = findMember(dec, dec->members[member].parentMember);
-    dec->members[member].parentMember = parent_representative;
+    spqr_member parent_representative = findMember(dec, MEMBER(dec, member).parentMember);
+    MEMBER(dec, member).parentMember = parent_representative;
 
     return parent_representative;
 }
@@ -469,10 +526,10 @@ static spqr_member findMemberParentNoCompression(const MATRECGraphicDecompositio
     assert(SPQRmemberIsValid(member));
     assert(memberIsRepresentative(dec,member));
 
-    if(SPQRmemberIsInvalid(dec->members[member].parentMember)){
-        return dec->members[member].parentMember;
+    if(SPQRmemberIsInvalid(MEMBER(dec, member).parentMember)){
+        return MEMBER(dec, member).parentMember;
     }
-    spqr_member parent_representative = findMemberNoCompression(dec, dec->members[member].parentMember);
+    spqr_member parent_representative = findMemberNoCompression(dec, MEMBER(dec, member).parentMember);
     return parent_representative;
 }
 
@@ -481,8 +538,8 @@ static spqr_member findEdgeChildMember(MATRECGraphicDecomposition *dec, spqr_edg
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_member representative = findMember(dec, dec->edges[edge].childMember);
-    dec->edges[edge].childMember = representative;
+    spqr_member representative = findMember(dec, EDGE(dec, edge).childMember);
+    EDGE(dec, edge).childMember = representative;
     return representative;
 }
 
@@ -491,7 +548,7 @@ static spqr_member findEdgeChildMemberNoCompression(const MATRECGraphicDecomposi
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    spqr_member representative = findMemberNoCompression(dec, dec->edges[edge].childMember);
+    spqr_member representative = findMemberNoCompression(dec, EDGE(dec, edge).childMember);
     return representative;
 }
 
@@ -501,7 +558,7 @@ static bool edgeIsMarker(const MATRECGraphicDecomposition *dec, spqr_edge edge)
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    return SPQRmemberIsValid(dec->edges[edge].childMember);
+    return SPQRmemberIsValid(EDGE(dec, edge).childMember);
 }
 
 static bool edgeIsTree(const MATRECGraphicDecomposition *dec, spqr_edge edge) {
@@ -509,7 +566,7 @@ static bool edgeIsTree(const MATRECGraphicDecomposition *dec, spqr_edge edge) {
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    return SPQRelementIsRow(dec->edges[edge].element);
+    return SPQRelementIsRow(EDGE(dec, edge).element);
 }
 
 static spqr_element edgeGetElement(const MATRECGraphicDecomposition * dec, spqr_edge edge){
@@ -517,42 +574,71 @@ static spqr_element edgeGetElement(const MATRECGraphicDecomposition * dec, spqr_
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
 
-    return dec->edges[edge].element;
+    return EDGE(dec, edge).element;
 }
 bool MATRECGraphicDecompositionContainsRow(const MATRECGraphicDecomposition * dec, MATREC_row row){
-    assert(MATRECrowIsValid(row) && (int) row < dec->memRows);
+    assert(MATRECrowIsValid(row));
     assert(dec);
-    return SPQRedgeIsValid(dec->rowEdges[row]);
+    return SPQRedgeIsValid(MATRECidMapGet(&dec->rowEdges,row));
 }
 bool MATRECGraphicDecompositionContainsColumn(const MATRECGraphicDecomposition *dec, MATREC_col col){
-    assert(MATRECcolIsValid(col) && (int) col < dec->memColumns);
+    assert(MATRECcolIsValid(col));
     assert(dec);
-    return SPQRedgeIsValid(dec->columnEdges[col]);
+    return SPQRedgeIsValid(MATRECidMapGet(&dec->columnEdges,col));
 }
-static void setDecompositionColumnEdge(MATRECGraphicDecomposition *dec, MATREC_col col, spqr_edge edge){
-    assert(MATRECcolIsValid(col) && (int)col < dec->memColumns);
+static MATREC_ERROR setDecompositionColumnEdge(MATRECGraphicDecomposition *dec, MATREC_col col, spqr_edge edge){
+    assert(MATRECcolIsValid(col));
     assert(dec);
     assert(SPQRedgeIsValid(edge));
-    dec->columnEdges[col] = edge;
+    return MATRECidMapSet(dec->env,&dec->columnEdges,col,edge);
 }
-static void setDecompositionRowEdge(MATRECGraphicDecomposition *dec, MATREC_row row, spqr_edge edge){
-    assert(MATRECrowIsValid(row) && (int) row < dec->memRows);
+static MATREC_ERROR setDecompositionRowEdge(MATRECGraphicDecomposition *dec, MATREC_row row, spqr_edge edge){
+    assert(MATRECrowIsValid(row));
     assert(dec);
     assert(SPQRedgeIsValid(edge));
-    dec->rowEdges[row] = edge;
+    return MATRECidMapSet(dec->env,&dec->rowEdges,row,edge);
 }
+///Returns an invalid edge if the column is not in the decomposition, including columns beyond the current capacity
 static spqr_edge getDecompositionColumnEdge(const MATRECGraphicDecomposition *dec, MATREC_col col){
-    assert(MATRECcolIsValid(col) && (int) col < dec->memColumns);
+    assert(MATRECcolIsValid(col));
     assert(dec);
-    return dec->columnEdges[col];
+    return MATRECidMapGet(&dec->columnEdges,col);
 }
+///Returns an invalid edge if the row is not in the decomposition, including rows beyond the current capacity
 static spqr_edge getDecompositionRowEdge(const MATRECGraphicDecomposition *dec, MATREC_row row){
-    assert(MATRECrowIsValid(row) && (int) row < dec->memRows);
+    assert(MATRECrowIsValid(row));
     assert(dec);
-    return dec->rowEdges[row];
+    return MATRECidMapGet(&dec->rowEdges,row);
 }
 
-MATREC_ERROR MATRECGraphicDecompositionCreate(MATREC * env, MATRECGraphicDecomposition **pDecomposition, int numRows, int numColumns){
+///Records a call which only has the decomposition as argument, if the decomposition is in the trace
+static void traceDecompositionCall(MATRECGraphicDecomposition *dec, MATRECTraceCall call){
+    if(MATRECtraceContains(dec->env, &dec->traceId)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(dec->env, &writer, call);
+        MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+        MATRECtraceEnd(&writer);
+    }
+}
+
+///Records that an addition is freed, if it is in the trace
+static void traceFreeAddition(MATREC *env, MATRECTraceId *addition){
+    if(MATRECtraceContains(env, addition)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(env, &writer, MATREC_TRACE_FREE_ADDITION);
+        MATRECtraceWriteAddition(&writer, addition);
+        MATRECtraceEnd(&writer);
+    }
+}
+
+MATREC_ERROR MATRECGraphicDecompositionCreate(MATREC * env, MATRECGraphicDecomposition **pDecomposition, MATREC_matrix_size numRows, MATREC_matrix_size numColumns){
+    return MATRECGraphicDecompositionCreateWithStorage(env,pDecomposition,numRows,numColumns,MATREC_IDS_DENSE,MATREC_IDS_DENSE);
+}
+
+///Creates a decomposition without recording it in the trace, which is used for creating a decomposition from a graph
+static MATREC_ERROR createDecomposition(MATREC * env, MATRECGraphicDecomposition **pDecomposition,
+                                        MATREC_matrix_size numRows, MATREC_matrix_size numColumns,
+                                        MATRECIdStorage rowStorage, MATRECIdStorage columnStorage){
     assert(env);
     assert(pDecomposition);
     assert(!*pDecomposition);
@@ -562,57 +648,71 @@ MATREC_ERROR MATRECGraphicDecompositionCreate(MATREC * env, MATRECGraphicDecompo
     dec->env = env;
 
     //Initialize edge array data
-    int initialMemEdges = 8;
+    MATREC_index initialMemEdges = 8;
     {
         assert(initialMemEdges > 0);
-        dec->memEdges = initialMemEdges;
         dec->numEdges = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->edges, (size_t) dec->memEdges));
+        MATREC_CALL(MATRECstorageCreate(env, &dec->edges, sizeof(SPQRGraphicDecompositionEdge),
+                                        &dec->memEdges, initialMemEdges));
         for (spqr_edge i = 0; i < dec->memEdges; ++i) {
-            dec->edges[i].edgeListNode.next = i + 1;
-            dec->edges[i].member = SPQR_INVALID_MEMBER;
+            EDGE(dec, i).edgeListNode.next = i + 1;
+            EDGE(dec, i).member = SPQR_INVALID_MEMBER;
         }
-        dec->edges[dec->memEdges - 1].edgeListNode.next = SPQR_INVALID_EDGE;
+        EDGE(dec, dec->memEdges - 1).edgeListNode.next = SPQR_INVALID_EDGE;
         dec->firstFreeEdge = 0;
     }
 
     //Initialize member array data
-    int initialMemMembers = 8;
+    MATREC_index initialMemMembers = 8;
     {
         assert(initialMemMembers > 0);
-        dec->memMembers = initialMemMembers;
         dec->numMembers = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->members, (size_t) dec->memMembers));
+        MATREC_CALL(MATRECstorageCreate(env, &dec->members, sizeof(SPQRGraphicDecompositionMember), &dec->memMembers,
+                                        initialMemMembers));
     }
 
     //Initialize node array data
-    int initialMemNodes = 8;
+    MATREC_index initialMemNodes = 8;
     {
         assert(initialMemNodes > 0);
-        dec->memNodes = initialMemNodes;
         dec->numNodes = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->nodes, (size_t) dec->memNodes));
+        MATREC_CALL(MATRECstorageCreate(env, &dec->nodes, sizeof(SPQRGraphicDecompositionNode),
+                                        &dec->memNodes, initialMemNodes));
     }
 
-    //Initialize mappings for rows
-    {
-        dec->memRows = numRows;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->rowEdges, (size_t) dec->memRows));
-        for (int i = 0; i < dec->memRows; ++i) {
-            dec->rowEdges[i] = SPQR_INVALID_EDGE;
-        }
-    }
-    //Initialize mappings for columns
-    {
-        dec->memColumns = numColumns;
-        dec->numColumns = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->columnEdges, (size_t) dec->memColumns));
-        for (int i = 0; i < dec->memColumns; ++i) {
-            dec->columnEdges[i] = SPQR_INVALID_EDGE;
-        }
-    }
+    //Initialize mappings for rows and columns. These grow when rows or columns beyond the initial size are added
+    MATREC_CALL(MATRECidMapCreate(env, &dec->rowEdges, rowStorage, numRows, SPQR_INVALID_EDGE));
+    MATREC_CALL(MATRECidMapCreate(env, &dec->columnEdges, columnStorage, numColumns, SPQR_INVALID_EDGE));
 
     dec->numConnectedComponents = 0;
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+    dec->autoFlattenThreshold = 0.0;
+    MATRECancestorIndexCreate(&dec->memberAncestors);
+    dec->adjacencyEntries = NULL;
+    dec->memAdjacencyEntries = 0;
+    dec->numAdjacencyEntries = 0;
+    dec->adjacencyVersion = 1;
+    MATRECcolumnTableCreate(&dec->columns);
+    dec->peakMemory = 0;
+    MATRECtraceIdInit(&dec->traceId);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECGraphicDecompositionCreateWithStorage(MATREC * env, MATRECGraphicDecomposition **pDecomposition,
+                                                        MATREC_matrix_size numRows, MATREC_matrix_size numColumns,
+                                                        MATRECIdStorage rowStorage, MATRECIdStorage columnStorage){
+    MATREC_CALL(createDecomposition(env,pDecomposition,numRows,numColumns,rowStorage,columnStorage));
+    if(MATRECtraceIsActive(env)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(env, &writer, MATREC_TRACE_GRAPHIC_CREATE);
+        MATRECtraceWriteDecomposition(&writer, &(*pDecomposition)->traceId);
+        MATRECtraceWriteNumber(&writer, numRows);
+        MATRECtraceWriteNumber(&writer, numColumns);
+        MATRECtraceWriteNumber(&writer, (uint64_t) rowStorage);
+        MATRECtraceWriteNumber(&writer, (uint64_t) columnStorage);
+        MATRECtraceEnd(&writer);
+    }
     return MATREC_OKAY;
 }
 
@@ -621,33 +721,167 @@ void MATRECGraphicDecompositionFree(MATRECGraphicDecomposition **pDec){
     assert(*pDec);
 
     MATRECGraphicDecomposition *dec = *pDec;
-    MATRECfreeBlockArray(dec->env, &dec->columnEdges);
-    MATRECfreeBlockArray(dec->env, &dec->rowEdges);
-    MATRECfreeBlockArray(dec->env, &dec->nodes);
-    MATRECfreeBlockArray(dec->env, &dec->members);
-    MATRECfreeBlockArray(dec->env, &dec->edges);
+    traceDecompositionCall(dec, MATREC_TRACE_FREE);
+    MATRECidMapFree(dec->env, &dec->columnEdges);
+    MATRECidMapFree(dec->env, &dec->rowEdges);
+    MATRECancestorIndexFree(dec->env, &dec->memberAncestors);
+    MATRECcolumnTableFree(dec->env, &dec->columns);
+    MATRECfreeBlockArray(dec->env, &dec->adjacencyEntries);
+    MATRECstorageFree(dec->env, &dec->nodes);
+    MATRECstorageFree(dec->env, &dec->members);
+    MATRECstorageFree(dec->env, &dec->edges);
 
     MATRECfreeBlock(dec->env, pDec);
 
 }
+
+void MATRECGraphicDecompositionMemory(const MATRECGraphicDecomposition *dec, MATRECMemoryReport *report){
+    assert(dec);
+    assert(report);
+    MATRECmemoryReportInit(report);
+    MATRECmemoryReportAddBytes(report, "decomposition", sizeof(MATRECGraphicDecomposition),
+                               sizeof(MATRECGraphicDecomposition));
+    MATRECstorageMemory(&dec->edges, "edges", sizeof(SPQRGraphicDecompositionEdge),
+                        dec->memEdges, dec->numEdges, report);
+    MATRECstorageMemory(&dec->members, "members", sizeof(SPQRGraphicDecompositionMember),
+                        dec->memMembers, dec->numMembers, report);
+    MATRECstorageMemory(&dec->nodes, "nodes", sizeof(SPQRGraphicDecompositionNode),
+                        dec->memNodes, dec->numNodes, report);
+    MATRECidMapMemory(&dec->rowEdges, "rowEdges", report);
+    MATRECidMapMemory(&dec->columnEdges, "columnEdges", report);
+    MATRECancestorIndexMemory(&dec->memberAncestors, "memberAncestors", report);
+    MATRECmemoryReportAdd(report, "adjacencyEntries", sizeof(SPQRGraphicAdjacencyEntry), dec->memAdjacencyEntries,
+                          dec->numAdjacencyEntries);
+    MATRECcolumnTableMemory(&dec->columns, report);
+    MATRECmemoryReportFinish(report, dec->peakMemory);
+}
+
+MATREC_ERROR MATRECGraphicDecompositionShrink(MATRECGraphicDecomposition *dec){
+    assert(dec);
+    MATRECMemoryReport report;
+    MATRECGraphicDecompositionMemory(dec, &report);
+    dec->peakMemory = report.peakBytes;
+
+    //Edges are never freed, so the edges in use are the first numEdges edges and the free list holds the rest
+    assert(dec->firstFreeEdge == (dec->numEdges < dec->memEdges ? dec->numEdges : SPQR_INVALID_EDGE));
+    //Growing the array assumes that it gains room for at least two new edges
+    MATREC_index memEdges = dec->numEdges > 2 ? dec->numEdges : 2;
+    if(memEdges < dec->memEdges){
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->edges, sizeof(SPQRGraphicDecompositionEdge),
+                                        &dec->memEdges, memEdges));
+        if(dec->numEdges < dec->memEdges){
+            EDGE(dec, dec->memEdges - 1).edgeListNode.next = SPQR_INVALID_EDGE;
+        }else{
+            dec->firstFreeEdge = SPQR_INVALID_EDGE;
+        }
+    }
+    MATREC_index memMembers = dec->numMembers > 0 ? dec->numMembers : 1;
+    if(memMembers < dec->memMembers){
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->members, sizeof(SPQRGraphicDecompositionMember),
+                                        &dec->memMembers, memMembers));
+    }
+    MATREC_index memNodes = dec->numNodes > 0 ? dec->numNodes : 1;
+    if(memNodes < dec->memNodes){
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->nodes, sizeof(SPQRGraphicDecompositionNode),
+                                        &dec->memNodes, memNodes));
+    }
+    MATREC_CALL(MATRECidMapShrink(dec->env, &dec->rowEdges));
+    MATREC_CALL(MATRECidMapShrink(dec->env, &dec->columnEdges));
+
+    //The adjacency snapshots and the ancestor index are rebuilt when they are needed
+    MATRECfreeBlockArray(dec->env, &dec->adjacencyEntries);
+    dec->memAdjacencyEntries = 0;
+    dec->numAdjacencyEntries = 0;
+    ++dec->adjacencyVersion;
+    MATRECancestorIndexFree(dec->env, &dec->memberAncestors);
+    MATRECancestorIndexCreate(&dec->memberAncestors);
+    MATRECcolumnTableShrink(dec->env, &dec->columns);
+    return MATREC_OKAY;
+}
+
+void MATRECGraphicDecompositionFlatten(MATRECGraphicDecomposition *dec){
+    assert(dec);
+    traceDecompositionCall(dec, MATREC_TRACE_FLATTEN);
+    for (spqr_node node = 0; node < dec->numNodes; ++node) {
+        findNode(dec,node);
+    }
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(memberIsRepresentative(dec,member)){
+            findMemberParent(dec,member);
+        }else{
+            findMember(dec,member);
+        }
+    }
+    //Walk over the edges of each member, since edges which were removed from their member keep stale data
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(!memberIsRepresentative(dec,member) || SPQRedgeIsInvalid(MEMBER(dec, member).firstEdge)){
+            continue;
+        }
+        bool isRigid = MEMBER(dec, member).type == SPQR_MEMBERTYPE_RIGID;
+        spqr_edge first = MEMBER(dec, member).firstEdge;
+        spqr_edge edge = first;
+        do{
+            findEdgeMember(dec,edge);
+            if(SPQRmemberIsValid(EDGE(dec, edge).childMember)){
+                findEdgeChildMember(dec,edge);
+            }
+            //Only edges of rigid members have nodes
+            if(isRigid){
+                findEdgeHead(dec,edge);
+                findEdgeTail(dec,edge);
+            }
+            edge = EDGE(dec, edge).edgeListNode.next;
+        }while(edge != first);
+    }
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+}
+
+void MATRECGraphicDecompositionSetAutoFlatten(MATRECGraphicDecomposition *dec, double averageChainLength){
+    assert(dec);
+    assert(averageChainLength >= 0.0);
+    if(MATRECtraceContains(dec->env, &dec->traceId)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(dec->env, &writer, MATREC_TRACE_SET_AUTO_FLATTEN);
+        MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+        MATRECtraceWriteDouble(&writer, averageChainLength);
+        MATRECtraceEnd(&writer);
+    }
+    dec->autoFlattenThreshold = averageChainLength;
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+}
+
+///Flattens the decomposition if automatic flattening is enabled and the lookups since the last check were too long.
+///Only checks once enough lookups were done to pay for the linear sweep.
+static void autoFlatten(MATRECGraphicDecomposition *dec){
+    if(dec->autoFlattenThreshold <= 0.0 || dec->numFindCalls < (size_t) dec->numMembers + 1){
+        return;
+    }
+    if((double) dec->numFindSteps > dec->autoFlattenThreshold * (double) dec->numFindCalls){
+        MATRECGraphicDecompositionFlatten(dec);
+    }
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+}
 static spqr_edge getFirstMemberEdge(const MATRECGraphicDecomposition * dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
-    return dec->members[member].firstEdge;
+    return MEMBER(dec, member).firstEdge;
 }
 static spqr_edge getNextMemberEdge(const MATRECGraphicDecomposition * dec, spqr_edge edge){
     assert(dec);
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
-    edge = dec->edges[edge].edgeListNode.next;
+    edge = EDGE(dec, edge).edgeListNode.next;
     return edge;
 }
 static spqr_edge getPreviousMemberEdge(const MATRECGraphicDecomposition *dec, spqr_edge edge){
     assert(dec);
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
-    edge = dec->edges[edge].edgeListNode.previous;
+    edge = EDGE(dec, edge).edgeListNode.previous;
     return edge;
 }
 
@@ -656,17 +890,17 @@ static void addEdgeToMemberEdgeList(MATRECGraphicDecomposition *dec, spqr_edge e
 
     if(SPQRedgeIsValid(firstMemberEdge)){
         spqr_edge lastMemberEdge = getPreviousMemberEdge(dec, firstMemberEdge);
-        dec->edges[edge].edgeListNode.next = firstMemberEdge;
-        dec->edges[edge].edgeListNode.previous = lastMemberEdge;
-        dec->edges[firstMemberEdge].edgeListNode.previous = edge;
-        dec->edges[lastMemberEdge].edgeListNode.next = edge;
+        EDGE(dec, edge).edgeListNode.next = firstMemberEdge;
+        EDGE(dec, edge).edgeListNode.previous = lastMemberEdge;
+        EDGE(dec, firstMemberEdge).edgeListNode.previous = edge;
+        EDGE(dec, lastMemberEdge).edgeListNode.next = edge;
     }else{
-        assert(dec->members[member].num_edges == 0);
-        dec->edges[edge].edgeListNode.next = edge;
-        dec->edges[edge].edgeListNode.previous = edge;
+        assert(MEMBER(dec, member).num_edges == 0);
+        EDGE(dec, edge).edgeListNode.next = edge;
+        EDGE(dec, edge).edgeListNode.previous = edge;
     }
-    dec->members[member].firstEdge = edge;//TODO: update this in case of row/column edges to make memory ordering nicer?
-    ++(dec->members[member].num_edges);
+    MEMBER(dec, member).firstEdge = edge;//TODO: update this in case of row/column edges to make memory ordering nicer?
+    ++(MEMBER(dec, member).num_edges);
 }
 static MATREC_ERROR createEdge(MATRECGraphicDecomposition *dec, spqr_member member, spqr_edge *pEdge) {
     assert(dec);
@@ -675,30 +909,30 @@ static MATREC_ERROR createEdge(MATRECGraphicDecomposition *dec, spqr_member memb
 
     spqr_edge index = dec->firstFreeEdge;
     if (SPQRedgeIsValid(index)) {
-        dec->firstFreeEdge = dec->edges[index].edgeListNode.next;
+        dec->firstFreeEdge = EDGE(dec, index).edgeListNode.next;
     } else {
         //Enlarge array, no free nodes in edge list
-        int newSize = 2 * dec->memEdges;
-        MATREC_CALL(MATRECreallocBlockArray(dec->env, &dec->edges, (size_t) newSize));
-        for (int i = dec->memEdges + 1; i < newSize; ++i) {
-            dec->edges[i].edgeListNode.next = i + 1;
-            dec->edges[i].member = SPQR_INVALID_MEMBER;
+        MATREC_index oldSize = dec->memEdges;
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->edges, sizeof(SPQRGraphicDecompositionEdge),
+                                        &dec->memEdges, MATRECstorageGrowSize(oldSize)));
+        for (MATREC_index i = oldSize + 1; i < dec->memEdges; ++i) {
+            EDGE(dec, i).edgeListNode.next = i + 1;
+            EDGE(dec, i).member = SPQR_INVALID_MEMBER;
         }
-        dec->edges[newSize - 1].edgeListNode.next = SPQR_INVALID_EDGE;
-        dec->firstFreeEdge = dec->memEdges + 1;
-        index = dec->memEdges;
-        dec->memEdges = newSize;
+        EDGE(dec, dec->memEdges - 1).edgeListNode.next = SPQR_INVALID_EDGE;
+        dec->firstFreeEdge = oldSize + 1;
+        index = oldSize;
     }
     //TODO: Is defaulting these here necessary?
-    dec->edges[index].tail = SPQR_INVALID_NODE;
-    dec->edges[index].head = SPQR_INVALID_NODE;
-    dec->edges[index].member = member;
-    dec->edges[index].childMember = SPQR_INVALID_MEMBER;
+    EDGE(dec, index).tail = SPQR_INVALID_NODE;
+    EDGE(dec, index).head = SPQR_INVALID_NODE;
+    EDGE(dec, index).member = member;
+    EDGE(dec, index).childMember = SPQR_INVALID_MEMBER;
 
-    dec->edges[index].headEdgeListNode.next = SPQR_INVALID_EDGE;
-    dec->edges[index].headEdgeListNode.previous = SPQR_INVALID_EDGE;
-    dec->edges[index].tailEdgeListNode.next = SPQR_INVALID_EDGE;
-    dec->edges[index].tailEdgeListNode.previous = SPQR_INVALID_EDGE;
+    EDGE(dec, index).headEdgeListNode.next = SPQR_INVALID_EDGE;
+    EDGE(dec, index).headEdgeListNode.previous = SPQR_INVALID_EDGE;
+    EDGE(dec, index).tailEdgeListNode.next = SPQR_INVALID_EDGE;
+    EDGE(dec, index).tailEdgeListNode.previous = SPQR_INVALID_EDGE;
 
     dec->numEdges++;
 
@@ -708,17 +942,17 @@ static MATREC_ERROR createEdge(MATRECGraphicDecomposition *dec, spqr_member memb
 }
 static MATREC_ERROR createRowEdge(MATRECGraphicDecomposition *dec, spqr_member member, spqr_edge *pEdge, MATREC_row row){
     MATREC_CALL(createEdge(dec,member,pEdge));
-    setDecompositionRowEdge(dec,row,*pEdge);
+    MATREC_CALL(setDecompositionRowEdge(dec,row,*pEdge));
     addEdgeToMemberEdgeList(dec,*pEdge,member);
-    dec->edges[*pEdge].element = MATRECrowToElement(row);
+    EDGE(dec, *pEdge).element = MATRECrowToElement(row);
 
     return MATREC_OKAY;
 }
 static MATREC_ERROR createColumnEdge(MATRECGraphicDecomposition *dec, spqr_member member, spqr_edge *pEdge, MATREC_col column){
     MATREC_CALL(createEdge(dec,member,pEdge));
-    setDecompositionColumnEdge(dec,column,*pEdge);
+    MATREC_CALL(setDecompositionColumnEdge(dec,column,*pEdge));
     addEdgeToMemberEdgeList(dec,*pEdge,member);
-    dec->edges[*pEdge].element = MATRECcolumnToElement(column);
+    EDGE(dec, *pEdge).element = MATRECcolumnToElement(column);
 
     return MATREC_OKAY;
 }
@@ -727,10 +961,10 @@ static MATREC_ERROR createMember(MATRECGraphicDecomposition *dec, SPQRMemberType
     assert(pMember);
 
     if(dec->numMembers == dec->memMembers){
-        dec->memMembers *= 2;
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&dec->members,(size_t) dec->memMembers));
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->members, sizeof(SPQRGraphicDecompositionMember),
+                                        &dec->memMembers, MATRECstorageGrowSize(dec->memMembers)));
     }
-    SPQRGraphicDecompositionMember *data = &dec->members[dec->numMembers];
+    SPQRGraphicDecompositionMember *data = &MEMBER(dec, dec->numMembers);
     data->markerOfParent = SPQR_INVALID_EDGE;
     data->markerToParent = SPQR_INVALID_EDGE;
     data->firstEdge = SPQR_INVALID_EDGE;
@@ -738,6 +972,9 @@ static MATREC_ERROR createMember(MATRECGraphicDecomposition *dec, SPQRMemberType
     data->num_edges = 0;
     data->parentMember = SPQR_INVALID_MEMBER;
     data->type = type;
+    data->adjacencyVersion = 0;
+    data->componentRepresentative = SPQR_INVALID_MEMBER;
+    data->componentSize = 1;
 
     *pMember = dec->numMembers;
 
@@ -745,50 +982,86 @@ static MATREC_ERROR createMember(MATRECGraphicDecomposition *dec, SPQRMemberType
     return MATREC_OKAY;
 }
 
+static spqr_member findMemberComponent(MATRECGraphicDecomposition *dec, spqr_member member){
+    assert(dec);
+    assert(SPQRmemberIsValid(member) && member < dec->numMembers);
+    spqr_member root = member;
+    while(SPQRmemberIsValid(MEMBER(dec, root).componentRepresentative)){
+        root = MEMBER(dec, root).componentRepresentative;
+    }
+    while(member != root){
+        spqr_member next = MEMBER(dec, member).componentRepresentative;
+        MEMBER(dec, member).componentRepresentative = root;
+        member = next;
+    }
+    return root;
+}
+
+///Sets the parent of a member in the member tree, which joins the components of both
+static void setMemberParent(MATRECGraphicDecomposition *dec, spqr_member member, spqr_member parent){
+    MEMBER(dec, member).parentMember = parent;
+    if(SPQRmemberIsInvalid(parent)){
+        return;
+    }
+    spqr_member first = findMemberComponent(dec,member);
+    spqr_member second = findMemberComponent(dec,parent);
+    if(first == second){
+        return;
+    }
+    if(MEMBER(dec, first).componentSize < MEMBER(dec, second).componentSize){
+        spqr_member temp = first;
+        first = second;
+        second = temp;
+    }
+    MEMBER(dec, second).componentRepresentative = first;
+    MEMBER(dec, first).componentSize += MEMBER(dec, second).componentSize;
+}
+
 static MATREC_ERROR createNode(MATRECGraphicDecomposition *dec, spqr_node * pNode){
 
     if(dec->numNodes == dec->memNodes){
-        dec->memNodes*=2;
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&dec->nodes,(size_t) dec->memNodes));
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->nodes, sizeof(SPQRGraphicDecompositionNode),
+                                        &dec->memNodes, MATRECstorageGrowSize(dec->memNodes)));
     }
     *pNode = dec->numNodes;
-    dec->nodes[dec->numNodes].representativeNode = SPQR_INVALID_NODE;
-    dec->nodes[dec->numNodes].firstEdge = SPQR_INVALID_EDGE;
-    dec->nodes[dec->numNodes].numEdges = 0;
+    NODE(dec, dec->numNodes).representativeNode = SPQR_INVALID_NODE;
+    NODE(dec, dec->numNodes).firstEdge = SPQR_INVALID_EDGE;
+    NODE(dec, dec->numNodes).numEdges = 0;
+    NODE(dec, dec->numNodes).adjacencyStart = -1;
     dec->numNodes++;
 
     return MATREC_OKAY;
 }
 static void removeEdgeFromNodeEdgeList(MATRECGraphicDecomposition *dec, spqr_edge edge, spqr_node node, bool nodeIsHead){
-    SPQRGraphicDecompositionEdgeListNode * edgeListNode = nodeIsHead ? &dec->edges[edge].headEdgeListNode : &dec->edges[edge].tailEdgeListNode;
+    SPQRGraphicDecompositionEdgeListNode * edgeListNode = nodeIsHead ? &EDGE(dec, edge).headEdgeListNode : &EDGE(dec, edge).tailEdgeListNode;
 
-    if(dec->nodes[node].numEdges == 1){
-        dec->nodes[node].firstEdge = SPQR_INVALID_EDGE;
+    if(NODE(dec, node).numEdges == 1){
+        NODE(dec, node).firstEdge = SPQR_INVALID_EDGE;
     }else{
         spqr_edge next_edge = edgeListNode->next;
         spqr_edge prev_edge = edgeListNode->previous;
-        SPQRGraphicDecompositionEdgeListNode * nextListNode = findEdgeHead(dec, next_edge) == node ? &dec->edges[next_edge].headEdgeListNode : &dec->edges[next_edge].tailEdgeListNode;//TODO: finds necessary?
-        SPQRGraphicDecompositionEdgeListNode * prevListNode = findEdgeHead(dec, prev_edge) == node ? &dec->edges[prev_edge].headEdgeListNode : &dec->edges[prev_edge].tailEdgeListNode;//TODO: finds necessary?
+        SPQRGraphicDecompositionEdgeListNode * nextListNode = findEdgeHead(dec, next_edge) == node ? &EDGE(dec, next_edge).headEdgeListNode : &EDGE(dec, next_edge).tailEdgeListNode;//TODO: finds necessary?
+        SPQRGraphicDecompositionEdgeListNode * prevListNode = findEdgeHead(dec, prev_edge) == node ? &EDGE(dec, prev_edge).headEdgeListNode : &EDGE(dec, prev_edge).tailEdgeListNode;//TODO: finds necessary?
 
         nextListNode->previous = prev_edge;
         prevListNode->next = next_edge;
 
-        if(dec->nodes[node].firstEdge == edge){
-            dec->nodes[node].firstEdge = next_edge; //TODO: fix this if we want fixed ordering for tree/nontree edges in memory
+        if(NODE(dec, node).firstEdge == edge){
+            NODE(dec, node).firstEdge = next_edge; //TODO: fix this if we want fixed ordering for tree/nontree edges in memory
         }
     }
     //TODO: empty edgeListNode's data? Might not be all that relevant
-    --(dec->nodes[node].numEdges);
+    --(NODE(dec, node).numEdges);
 }
 static void addEdgeToNodeEdgeList(MATRECGraphicDecomposition *dec, spqr_edge edge, spqr_node node, bool nodeIsHead){
     assert(nodeIsRepresentative(dec,node));
 
     spqr_edge firstNodeEdge = getFirstNodeEdge(dec, node);
 
-    SPQRGraphicDecompositionEdgeListNode * edgeListNode = nodeIsHead ? &dec->edges[edge].headEdgeListNode : &dec->edges[edge].tailEdgeListNode;
+    SPQRGraphicDecompositionEdgeListNode * edgeListNode = nodeIsHead ? &EDGE(dec, edge).headEdgeListNode : &EDGE(dec, edge).tailEdgeListNode;
     if(SPQRedgeIsValid(firstNodeEdge)){
         bool nextIsHead = findEdgeHead(dec,firstNodeEdge) == node;
-        SPQRGraphicDecompositionEdgeListNode *nextListNode = nextIsHead ? &dec->edges[firstNodeEdge].headEdgeListNode : &dec->edges[firstNodeEdge].tailEdgeListNode;
+        SPQRGraphicDecompositionEdgeListNode *nextListNode = nextIsHead ? &EDGE(dec, firstNodeEdge).headEdgeListNode : &EDGE(dec, firstNodeEdge).tailEdgeListNode;
         spqr_edge lastNodeEdge = nextListNode->previous;
 
         edgeListNode->next = firstNodeEdge;
@@ -796,7 +1069,7 @@ static void addEdgeToNodeEdgeList(MATRECGraphicDecomposition *dec, spqr_edge edg
 
 
         bool previousIsHead = findEdgeHead(dec,lastNodeEdge) == node;
-        SPQRGraphicDecompositionEdgeListNode *previousListNode = previousIsHead ? &dec->edges[lastNodeEdge].headEdgeListNode : &dec->edges[lastNodeEdge].tailEdgeListNode;
+        SPQRGraphicDecompositionEdgeListNode *previousListNode = previousIsHead ? &EDGE(dec, lastNodeEdge).headEdgeListNode : &EDGE(dec, lastNodeEdge).tailEdgeListNode;
         previousListNode->next = edge;
         nextListNode->previous = edge;
 
@@ -804,12 +1077,12 @@ static void addEdgeToNodeEdgeList(MATRECGraphicDecomposition *dec, spqr_edge edg
         edgeListNode->next = edge;
         edgeListNode->previous = edge;
     }
-    dec->nodes[node].firstEdge = edge; //TODO: update this in case of row/column edges to make memory ordering nicer?er?
-    ++dec->nodes[node].numEdges;
+    NODE(dec, node).firstEdge = edge; //TODO: update this in case of row/column edges to make memory ordering nicer?er?
+    ++NODE(dec, node).numEdges;
     if(nodeIsHead){
-        dec->edges[edge].head = node;
+        EDGE(dec, edge).head = node;
     }else{
-        dec->edges[edge].tail = node;
+        EDGE(dec, edge).tail = node;
     }
 }
 static void setEdgeHeadAndTail(MATRECGraphicDecomposition *dec, spqr_edge edge, spqr_node head, spqr_node tail){
@@ -819,8 +1092,8 @@ static void setEdgeHeadAndTail(MATRECGraphicDecomposition *dec, spqr_edge edge,
 static void clearEdgeHeadAndTail(MATRECGraphicDecomposition *dec, spqr_edge edge){
     removeEdgeFromNodeEdgeList(dec,edge,findEdgeHead(dec,edge),true);
     removeEdgeFromNodeEdgeList(dec,edge,findEdgeTail(dec,edge),false);
-    dec->edges[edge].head = SPQR_INVALID_NODE;
-    dec->edges[edge].tail = SPQR_INVALID_NODE;
+    EDGE(dec, edge).head = SPQR_INVALID_NODE;
+    EDGE(dec, edge).tail = SPQR_INVALID_NODE;
 }
 static void changeEdgeHead(MATRECGraphicDecomposition *dec, spqr_edge edge, spqr_node oldHead, spqr_node newHead){
     assert(nodeIsRepresentative(dec,oldHead));
@@ -835,25 +1108,35 @@ static void changeEdgeTail(MATRECGraphicDecomposition *dec, spqr_edge edge, spqr
     addEdgeToNodeEdgeList(dec,edge,newTail,false);
 }
 static void flipEdge(MATRECGraphicDecomposition *dec, spqr_edge edge){
-    swap_ints(&dec->edges[edge].head,&dec->edges[edge].tail);
+    swap_indices(&EDGE(dec, edge).head,&EDGE(dec, edge).tail);
 
-    SPQRGraphicDecompositionEdgeListNode temp = dec->edges[edge].headEdgeListNode;
-    dec->edges[edge].headEdgeListNode = dec->edges[edge].tailEdgeListNode;
-    dec->edges[edge].tailEdgeListNode = temp;
+    SPQRGraphicDecompositionEdgeListNode temp = EDGE(dec, edge).headEdgeListNode;
+    EDGE(dec, edge).headEdgeListNode = EDGE(dec, edge).tailEdgeListNode;
+    EDGE(dec, edge).tailEdgeListNode = temp;
 
 }
-static int nodeDegree(MATRECGraphicDecomposition *dec, spqr_node node){
+static MATREC_index nodeDegree(MATRECGraphicDecomposition *dec, spqr_node node){
     assert(dec);
     assert(SPQRnodeIsValid(node));
     assert(node < dec->memNodes);
-    return dec->nodes[node].numEdges;
+    return NODE(dec, node).numEdges;
 }
 static SPQRMemberType getMemberType(const MATRECGraphicDecomposition *dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].type;
+    return MEMBER(dec, member).type;
+}
+
+static bool memberHasAdjacency(const MATRECGraphicDecomposition *dec, spqr_member member){
+    assert(SPQRmemberIsValid(member) && member < dec->memMembers);
+    return MEMBER(dec, member).adjacencyVersion == dec->adjacencyVersion;
+}
+
+static void invalidateMemberAdjacency(MATRECGraphicDecomposition *dec, spqr_member member){
+    assert(SPQRmemberIsValid(member) && member < dec->memMembers);
+    MEMBER(dec, member).adjacencyVersion = 0;
 }
 static void updateMemberType(const MATRECGraphicDecomposition *dec, spqr_member member, SPQRMemberType type){
     assert(dec);
@@ -861,14 +1144,14 @@ static void updateMemberType(const MATRECGraphicDecomposition *dec, spqr_member
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
 
-    dec->members[member].type = type;
+    MEMBER(dec, member).type = type;
 }
 static spqr_edge markerToParent(const MATRECGraphicDecomposition *dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].markerToParent;
+    return MEMBER(dec, member).markerToParent;
 }
 static char typeToChar(SPQRMemberType type){
     switch (type) {
@@ -889,41 +1172,41 @@ static void updateMemberParentInformation(MATRECGraphicDecomposition *dec, const
     assert(memberIsRepresentative(dec,newMember));
     assert(findMemberNoCompression(dec,toRemove) == newMember);
 
-    dec->members[newMember].markerOfParent = dec->members[toRemove].markerOfParent;
-    dec->members[newMember].markerToParent = dec->members[toRemove].markerToParent;
-    dec->members[newMember].parentMember = dec->members[toRemove].parentMember;
+    MEMBER(dec, newMember).markerOfParent = MEMBER(dec, toRemove).markerOfParent;
+    MEMBER(dec, newMember).markerToParent = MEMBER(dec, toRemove).markerToParent;
+    setMemberParent(dec,newMember,MEMBER(dec, toRemove).parentMember);
 
-    dec->members[toRemove].markerOfParent = SPQR_INVALID_EDGE;
-    dec->members[toRemove].markerToParent = SPQR_INVALID_EDGE;
-    dec->members[toRemove].parentMember = SPQR_INVALID_MEMBER;
+    MEMBER(dec, toRemove).markerOfParent = SPQR_INVALID_EDGE;
+    MEMBER(dec, toRemove).markerToParent = SPQR_INVALID_EDGE;
+    MEMBER(dec, toRemove).parentMember = SPQR_INVALID_MEMBER;
 }
 static spqr_edge markerOfParent(const MATRECGraphicDecomposition *dec, spqr_member member) {
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].markerOfParent;
+    return MEMBER(dec, member).markerOfParent;
 }
 
 
 
-static int getNumMemberEdges(const MATRECGraphicDecomposition * dec, spqr_member member){
+static MATREC_index getNumMemberEdges(const MATRECGraphicDecomposition * dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].num_edges;
+    return MEMBER(dec, member).num_edges;
 }
 
-static int getNumNodes(const MATRECGraphicDecomposition *dec){
+static MATREC_index getNumNodes(const MATRECGraphicDecomposition *dec){
     assert(dec);
     return dec->numNodes;
 }
-static int getNumMembers(const MATRECGraphicDecomposition *dec){
+static MATREC_index getNumMembers(const MATRECGraphicDecomposition *dec){
     assert(dec);
     return dec->numMembers;
 }
-static MATREC_ERROR createStandaloneParallel(MATRECGraphicDecomposition *dec, MATREC_col * columns, int num_columns, MATREC_row row, spqr_member * pMember){
+static MATREC_ERROR createStandaloneParallel(MATRECGraphicDecomposition *dec, MATREC_col * columns, MATREC_index num_columns, MATREC_row row, spqr_member * pMember){
     spqr_member member;
     SPQRMemberType type = num_columns < 2 ? SPQR_MEMBERTYPE_LOOP : SPQR_MEMBERTYPE_PARALLEL;
     MATREC_CALL(createMember(dec, type, &member));
@@ -932,7 +1215,7 @@ static MATREC_ERROR createStandaloneParallel(MATRECGraphicDecomposition *dec, MA
     MATREC_CALL(createRowEdge(dec,member,&row_edge,row));
 
     spqr_edge col_edge;
-    for (int i = 0; i < num_columns; ++i) {
+    for (MATREC_index i = 0; i < num_columns; ++i) {
         MATREC_CALL(createColumnEdge(dec,member,&col_edge,columns[i]));
     }
     *pMember = member;
@@ -942,7 +1225,7 @@ static MATREC_ERROR createStandaloneParallel(MATRECGraphicDecomposition *dec, MA
 }
 
 //TODO: fix tracking connectivity more cleanly, should not be left up to the algorithms ideally
-static MATREC_ERROR createConnectedParallel(MATRECGraphicDecomposition *dec, MATREC_col * columns, int num_columns, MATREC_row row, spqr_member * pMember){
+static MATREC_ERROR createConnectedParallel(MATRECGraphicDecomposition *dec, MATREC_col * columns, MATREC_index num_columns, MATREC_row row, spqr_member * pMember){
     spqr_member member;
     MATREC_CALL(createMember(dec, SPQR_MEMBERTYPE_PARALLEL, &member));
 
@@ -950,7 +1233,7 @@ static MATREC_ERROR createConnectedParallel(MATRECGraphicDecomposition *dec, MAT
     MATREC_CALL(createRowEdge(dec,member,&row_edge,row));
 
     spqr_edge col_edge;
-    for (int i = 0; i < num_columns; ++i) {
+    for (MATREC_index i = 0; i < num_columns; ++i) {
         MATREC_CALL(createColumnEdge(dec,member,&col_edge,columns[i]));
     }
     *pMember = member;
@@ -958,7 +1241,7 @@ static MATREC_ERROR createConnectedParallel(MATRECGraphicDecomposition *dec, MAT
     return MATREC_OKAY;
 }
 
-static MATREC_ERROR createStandaloneSeries(MATRECGraphicDecomposition *dec, MATREC_row * rows, int numRows, MATREC_col col, spqr_member * pMember){
+static MATREC_ERROR createStandaloneSeries(MATRECGraphicDecomposition *dec, MATREC_row * rows, MATREC_index numRows, MATREC_col col, spqr_member * pMember){
     spqr_member member;
     SPQRMemberType type = numRows < 2 ? SPQR_MEMBERTYPE_LOOP : SPQR_MEMBERTYPE_SERIES;
     MATREC_CALL(createMember(dec, type, &member));
@@ -967,14 +1250,14 @@ static MATREC_ERROR createStandaloneSeries(MATRECGraphicDecomposition *dec, MATR
     MATREC_CALL(createColumnEdge(dec,member,&colEdge,col));
 
     spqr_edge rowEdge;
-    for (int i = 0; i < numRows; ++i) {
+    for (MATREC_index i = 0; i < numRows; ++i) {
         MATREC_CALL(createRowEdge(dec,member,&rowEdge,rows[i]));
     }
     *pMember = member;
     ++dec->numConnectedComponents;
     return MATREC_OKAY;
 }
-static MATREC_ERROR createConnectedSeries(MATRECGraphicDecomposition *dec, MATREC_row * rows, int numRows, MATREC_col col, spqr_member * pMember){
+static MATREC_ERROR createConnectedSeries(MATRECGraphicDecomposition *dec, MATREC_row * rows, MATREC_index numRows, MATREC_col col, spqr_member * pMember){
     spqr_member member;
     MATREC_CALL(createMember(dec, SPQR_MEMBERTYPE_SERIES, &member));
 
@@ -982,7 +1265,7 @@ static MATREC_ERROR createConnectedSeries(MATRECGraphicDecomposition *dec, MATRE
     MATREC_CALL(createColumnEdge(dec,member,&colEdge,col));
 
     spqr_edge rowEdge;
-    for (int i = 0; i < numRows; ++i) {
+    for (MATREC_index i = 0; i < numRows; ++i) {
         MATREC_CALL(createRowEdge(dec,member,&rowEdge,rows[i]));
     }
     *pMember = member;
@@ -993,28 +1276,34 @@ static void removeEdgeFromMemberEdgeList(MATRECGraphicDecomposition *dec, spqr_e
     assert(findEdgeMemberNoCompression(dec,edge) == member);
     assert(memberIsRepresentative(dec,member));
 
-    if(dec->members[member].num_edges == 1){
-        dec->members[member].firstEdge = SPQR_INVALID_EDGE;
+    if(MEMBER(dec, member).num_edges == 1){
+        MEMBER(dec, member).firstEdge = SPQR_INVALID_EDGE;
 
         //TODO: also set edgeListNode to invalid, maybe? Not necessary probably
     }else{
-        spqr_edge nextEdge = dec->edges[edge].edgeListNode.next;
-        spqr_edge prevEdge = dec->edges[edge].edgeListNode.previous;
+        spqr_edge nextEdge = EDGE(dec, edge).edgeListNode.next;
+        spqr_edge prevEdge = EDGE(dec, edge).edgeListNode.previous;
 
-        dec->edges[nextEdge].edgeListNode.previous = prevEdge;
-        dec->edges[prevEdge].edgeListNode.next = nextEdge;
+        EDGE(dec, nextEdge).edgeListNode.previous = prevEdge;
+        EDGE(dec, prevEdge).edgeListNode.next = nextEdge;
 
-        if(dec->members[member].firstEdge == edge){
-            dec->members[member].firstEdge = nextEdge; //TODO: fix this if we want fixed ordering for tree/nontree edges in memory
+        if(MEMBER(dec, member).firstEdge == edge){
+            MEMBER(dec, member).firstEdge = nextEdge; //TODO: fix this if we want fixed ordering for tree/nontree edges in memory
         }
     }
 
 
-    --(dec->members[member].num_edges);
+    --(MEMBER(dec, member).num_edges);
 }
 
 
-static void process_edge(MATREC_row * fundamental_cycle_edges, int * num_cycle_edges, spqr_edge * callStack, int * callStackSize, spqr_edge edge, const MATRECGraphicDecomposition * dec){
+typedef struct {
+    spqr_node node;
+    spqr_edge nodeEdge;
+} FindPathCall;
+
+static void process_edge(MATREC_row * fundamental_cycle_edges, MATREC_index * num_cycle_edges, MATREC_index max_cycle_edges,
+                         spqr_edge * callStack, MATREC_index * callStackSize, spqr_edge edge, const MATRECGraphicDecomposition * dec){
     assert(edgeIsTree(dec,edge));
     if(!edgeIsMarker(dec,edge)){
         spqr_member current_member = findEdgeMemberNoCompression(dec, edge);
@@ -1026,7 +1315,9 @@ static void process_edge(MATREC_row * fundamental_cycle_edges, int * num_cycle_e
         }else{
             spqr_element element = edgeGetElement(dec,edge);
             assert(SPQRelementIsRow(element));
-            fundamental_cycle_edges[*num_cycle_edges] = SPQRelementToRow(element);
+            if(*num_cycle_edges < max_cycle_edges){
+                fundamental_cycle_edges[*num_cycle_edges] = SPQRelementToRow(element);
+            }
             ++(*num_cycle_edges);
         }
     }else{
@@ -1038,43 +1329,26 @@ static void process_edge(MATREC_row * fundamental_cycle_edges, int * num_cycle_e
     }
 }
 
-static int decompositionGetFundamentalCycleRows(const MATRECGraphicDecomposition *dec, MATREC_col column, MATREC_row * output){
+/**
+ * Finds the rows of the fundamental cycle of the column, using call stacks with room for dec->numEdges and
+ * dec->numNodes entries. Only the first maxRows rows are stored; the search stops once more rows are found, and then
+ * returns a number larger than maxRows. Returns -1 if the decomposition is invalid.
+ */
+static MATREC_index findFundamentalCycleRows(const MATRECGraphicDecomposition *dec, MATREC_col column, MATREC_row * output,
+                                             MATREC_index maxRows, spqr_edge * callStack,
+                                             FindPathCall * pathSearchCallStack){
     spqr_edge edge = getDecompositionColumnEdge(dec, column);
     if(SPQRedgeIsInvalid(edge)){
         return 0;
     }
-    int num_rows = 0;
+    MATREC_index num_rows = 0;
 
-    spqr_edge * callStack;
-    //TODO: probably an overkill amount of memory allocated here... How can we allocate just enough?
-    MATREC_ERROR result = MATRECallocBlockArray(dec->env,&callStack,(size_t) dec->memRows);
-    if(result != MATREC_OKAY){
-        return -1;
-    }
-    int callStackSize = 1;
+    MATREC_index callStackSize = 1;
     callStack[0] = edge;
 
-    bool * nodeVisited;
-    result = MATRECallocBlockArray(dec->env,&nodeVisited,(size_t) dec->numNodes);
-    if(result != MATREC_OKAY){
-        return -1;
-    }
-    for (int i = 0; i < dec->numNodes; ++i) {
-        nodeVisited[i] = false;
-    }
-
-    typedef struct {
-        spqr_node node;
-        spqr_edge nodeEdge;
-    } DFSCallData;
-    DFSCallData * pathSearchCallStack;
-    result = MATRECallocBlockArray(dec->env,&pathSearchCallStack,(size_t) dec->numNodes);
-    if(result != MATREC_OKAY){
-        return -1;
-    }
-    int pathSearchCallStackSize = 0;
+    MATREC_index pathSearchCallStackSize = 0;
 
-    while(callStackSize > 0){
+    while(callStackSize > 0 && num_rows <= maxRows){
         spqr_edge column_edge = callStack[callStackSize - 1];
         --callStackSize;
         spqr_member column_edge_member = findEdgeMemberNoCompression(dec, column_edge);
@@ -1090,16 +1364,14 @@ static int decompositionGetFundamentalCycleRows(const MATRECGraphicDecomposition
                 pathSearchCallStack[0].nodeEdge = getFirstNodeEdge(dec,source);
                 pathSearchCallStackSize++;
                 while(pathSearchCallStackSize > 0){
-                    DFSCallData * dfsData  = &pathSearchCallStack[pathSearchCallStackSize-1];
-                    nodeVisited[dfsData->node] = true;
-                    //cannot be a tree edge which is its parent
+                    FindPathCall * dfsData  = &pathSearchCallStack[pathSearchCallStackSize-1];
+                    //cannot be a tree edge which is its parent. As the tree edges form a tree, no node is visited twice
                     if(edgeIsTree(dec,dfsData->nodeEdge) &&
                        (pathSearchCallStackSize <= 1 || dfsData->nodeEdge != pathSearchCallStack[pathSearchCallStackSize-2].nodeEdge)){
                         spqr_node head = findEdgeHeadNoCompression(dec, dfsData->nodeEdge);
                         spqr_node tail = findEdgeTailNoCompression(dec, dfsData->nodeEdge);
                         spqr_node other = head == dfsData->node ? tail : head;
                         assert(other != dfsData->node);
-                        assert(!nodeVisited[other]);
                         if(other == target){
                             break;
                         }
@@ -1120,9 +1392,9 @@ static int decompositionGetFundamentalCycleRows(const MATRECGraphicDecomposition
                         }
                     }while(pathSearchCallStackSize > 0);
                 }
-                for (int i = 0; i < pathSearchCallStackSize; ++i) {
+                for (MATREC_index i = 0; i < pathSearchCallStackSize; ++i) {
                     if(edgeIsTree(dec,pathSearchCallStack[i].nodeEdge)){
-                        process_edge(output,&num_rows,callStack,&callStackSize,pathSearchCallStack[i].nodeEdge,dec);
+                        process_edge(output,&num_rows,maxRows,callStack,&callStackSize,pathSearchCallStack[i].nodeEdge,dec);
                     }
                 }
 
@@ -1134,11 +1406,11 @@ static int decompositionGetFundamentalCycleRows(const MATRECGraphicDecomposition
             {
                 spqr_edge first_edge = getFirstMemberEdge(dec, column_edge_member);
                 spqr_edge iter_edge = first_edge;
-                int tree_count = 0;
+                MATREC_index tree_count = 0;
                 do
                 {
                     if(edgeIsTree(dec,iter_edge)){
-                        process_edge(output,&num_rows,callStack,&callStackSize,iter_edge,dec);
+                        process_edge(output,&num_rows,maxRows,callStack,&callStackSize,iter_edge,dec);
                         tree_count++;
                     }
                     iter_edge = getNextMemberEdge(dec,iter_edge);
@@ -1153,11 +1425,11 @@ static int decompositionGetFundamentalCycleRows(const MATRECGraphicDecomposition
             {
                 spqr_edge first_edge = getFirstMemberEdge(dec, column_edge_member);
                 spqr_edge iter_edge = first_edge;
-                int nontree_count = 0;
+                MATREC_index nontree_count = 0;
                 do
                 {
                     if(edgeIsTree(dec,iter_edge)){
-                        process_edge(output,&num_rows,callStack,&callStackSize,iter_edge,dec);
+                        process_edge(output,&num_rows,maxRows,callStack,&callStackSize,iter_edge,dec);
                     }else{
                         nontree_count++;
                     }
@@ -1173,16 +1445,245 @@ static int decompositionGetFundamentalCycleRows(const MATRECGraphicDecomposition
                 assert(false);
         }
     }
+    return num_rows;
+}
+
+static MATREC_index decompositionGetFundamentalCycleRows(const MATRECGraphicDecomposition *dec, MATREC_col column, MATREC_row * output){
+    spqr_edge * callStack = NULL;
+    FindPathCall * pathSearchCallStack = NULL;
+    if(MATRECallocBlockArray(dec->env,&callStack,(size_t) dec->numEdges + 1) != MATREC_OKAY){
+        return -1;
+    }
+    if(MATRECallocBlockArray(dec->env,&pathSearchCallStack,(size_t) dec->numNodes + 1) != MATREC_OKAY){
+        MATRECfreeBlockArray(dec->env,&callStack);
+        return -1;
+    }
+    MATREC_index num_rows = findFundamentalCycleRows(dec,column,output,dec->numEdges,callStack,pathSearchCallStack);
     MATRECfreeBlockArray(dec->env,&pathSearchCallStack);
-    MATRECfreeBlockArray(dec->env,&nodeVisited);
     MATRECfreeBlockArray(dec->env,&callStack);
     return num_rows;
 }
 
+
+///Roots the spanning tree of the tree edges of a rigid member, storing for each node the tree edge to its parent
+static void rootRigidMember(const MATRECGraphicDecomposition *dec, spqr_member member, spqr_edge * nodeParentEdge,
+                            MATREC_index * nodeDepth, spqr_node * queue){
+    spqr_node root = findEdgeTailNoCompression(dec,getFirstMemberEdge(dec,member));
+    nodeParentEdge[root] = SPQR_INVALID_EDGE;
+    nodeDepth[root] = 0;
+    queue[0] = root;
+    MATREC_index queueSize = 1;
+    for (MATREC_index i = 0; i < queueSize; ++i) {
+        spqr_node node = queue[i];
+        spqr_edge first = getFirstNodeEdge(dec,node);
+        spqr_edge edge = first;
+        do{
+            if(edgeIsTree(dec,edge) && edge != nodeParentEdge[node]){
+                spqr_node head = findEdgeHeadNoCompression(dec,edge);
+                spqr_node other = head == node ? findEdgeTailNoCompression(dec,edge) : head;
+                nodeParentEdge[other] = edge;
+                nodeDepth[other] = nodeDepth[node] + 1;
+                queue[queueSize] = other;
+                ++queueSize;
+            }
+            edge = getNextNodeEdgeNoCompression(dec,edge,node);
+        }while(edge != first);
+    }
+}
+
+MATREC_ERROR MATRECGraphicDecompositionCreateMatrix(const MATRECGraphicDecomposition *dec, MATRECCSMatrixInt **pMatrix){
+    assert(dec);
+    assert(pMatrix);
+    assert(!*pMatrix);
+    MATREC * env = dec->env;
+
+    //Find the dimensions, and sort the column edges by their column using a table of all column indices
+    MATREC_matrix_size numRows = 0;
+    MATREC_matrix_size numColumns = 0;
+    MATREC_index numRowEdges = 0;
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(!memberIsRepresentative(dec,member) || SPQRedgeIsInvalid(getFirstMemberEdge(dec,member))){
+            continue;
+        }
+        spqr_edge first = getFirstMemberEdge(dec,member);
+        spqr_edge edge = first;
+        do{
+            spqr_element element = edgeGetElement(dec,edge);
+            if(element != MARKER_ROW_ELEMENT && SPQRelementIsRow(element)){
+                MATREC_row row = SPQRelementToRow(element);
+                numRows = row + 1 > numRows ? row + 1 : numRows;
+                ++numRowEdges;
+            }else if(element != MARKER_COLUMN_ELEMENT && SPQRelementIsColumn(element)){
+                MATREC_col col = SPQRelementToColumn(element);
+                numColumns = col + 1 > numColumns ? col + 1 : numColumns;
+            }
+            edge = getNextMemberEdge(dec,edge);
+        }while(edge != first);
+    }
+    spqr_edge * columnEdges = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&columnEdges,(size_t) numColumns + 1));
+    for (MATREC_matrix_size col = 0; col < numColumns; ++col) {
+        columnEdges[col] = SPQR_INVALID_EDGE;
+    }
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(!memberIsRepresentative(dec,member) || SPQRedgeIsInvalid(getFirstMemberEdge(dec,member))){
+            continue;
+        }
+        spqr_edge first = getFirstMemberEdge(dec,member);
+        spqr_edge edge = first;
+        do{
+            spqr_element element = edgeGetElement(dec,edge);
+            if(element != MARKER_COLUMN_ELEMENT && SPQRelementIsColumn(element)){
+                columnEdges[SPQRelementToColumn(element)] = edge;
+            }
+            edge = getNextMemberEdge(dec,edge);
+        }while(edge != first);
+    }
+
+    //Rigid members are rooted and parallel members have their tree edge found the first time a cycle passes them,
+    //so that each cycle is traced in time linear in its length
+    spqr_edge * callStack = NULL;
+    spqr_edge * nodeParentEdge = NULL;
+    MATREC_index * nodeDepth = NULL;
+    spqr_node * queue = NULL;
+    spqr_edge * memberTreeEdge = NULL;
+    bool * memberVisited = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&callStack,(size_t) dec->numEdges + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeParentEdge,(size_t) dec->numNodes + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeDepth,(size_t) dec->numNodes + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&queue,(size_t) dec->numNodes + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&memberTreeEdge,(size_t) dec->numMembers + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&memberVisited,(size_t) dec->numMembers + 1));
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        memberVisited[member] = false;
+    }
+
+    //The nonzeros in column order; each cycle has at most one nonzero for every row edge
+    MATREC_index memEntries = numRowEdges + 1;
+    MATREC_index numEntries = 0;
+    MATREC_row * entryRows = NULL;
+    MATREC_col * entryColumns = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&entryRows,(size_t) memEntries));
+    MATREC_CALL(MATRECallocBlockArray(env,&entryColumns,(size_t) memEntries));
+
+    for (MATREC_matrix_size col = 0; col < numColumns; ++col) {
+        if(SPQRedgeIsInvalid(columnEdges[col])){
+            continue;
+        }
+        if(numEntries + numRowEdges > memEntries){
+            memEntries = 2 * memEntries > numEntries + numRowEdges ? 2 * memEntries : numEntries + numRowEdges;
+            MATREC_CALL(MATRECreallocBlockArray(env,&entryRows,(size_t) memEntries));
+            MATREC_CALL(MATRECreallocBlockArray(env,&entryColumns,(size_t) memEntries));
+        }
+        MATREC_index columnStart = numEntries;
+        MATREC_index callStackSize = 1;
+        callStack[0] = columnEdges[col];
+        while(callStackSize > 0){
+            spqr_edge columnEdge = callStack[callStackSize - 1];
+            --callStackSize;
+            spqr_member member = findEdgeMemberNoCompression(dec,columnEdge);
+            switch(getMemberType(dec,member)){
+                case SPQR_MEMBERTYPE_RIGID:
+                {
+                    if(!memberVisited[member]){
+                        rootRigidMember(dec,member,nodeParentEdge,nodeDepth,queue);
+                        memberVisited[member] = true;
+                    }
+                    //Walk up from both ends of the edge until the paths meet
+                    spqr_node source = findEdgeHeadNoCompression(dec,columnEdge);
+                    spqr_node target = findEdgeTailNoCompression(dec,columnEdge);
+                    while(source != target){
+                        spqr_node * deepest = nodeDepth[source] >= nodeDepth[target] ? &source : &target;
+                        spqr_edge edge = nodeParentEdge[*deepest];
+                        process_edge(entryRows,&numEntries,memEntries,callStack,&callStackSize,edge,dec);
+                        spqr_node head = findEdgeHeadNoCompression(dec,edge);
+                        *deepest = head == *deepest ? findEdgeTailNoCompression(dec,edge) : head;
+                    }
+                    break;
+                }
+                case SPQR_MEMBERTYPE_LOOP:
+                case SPQR_MEMBERTYPE_PARALLEL:
+                {
+                    if(!memberVisited[member]){
+                        memberTreeEdge[member] = SPQR_INVALID_EDGE;
+                        spqr_edge first = getFirstMemberEdge(dec,member);
+                        spqr_edge edge = first;
+                        do{
+                            if(edgeIsTree(dec,edge)){
+                                memberTreeEdge[member] = edge;
+                            }
+                            edge = getNextMemberEdge(dec,edge);
+                        }while(edge != first);
+                        memberVisited[member] = true;
+                    }
+                    if(SPQRedgeIsValid(memberTreeEdge[member])){
+                        process_edge(entryRows,&numEntries,memEntries,callStack,&callStackSize,memberTreeEdge[member],dec);
+                    }
+                    break;
+                }
+                case SPQR_MEMBERTYPE_SERIES:
+                {
+                    //All other edges are tree edges, so this is linear in the length of the cycle
+                    spqr_edge first = getFirstMemberEdge(dec,member);
+                    spqr_edge edge = first;
+                    do{
+                        if(edgeIsTree(dec,edge)){
+                            process_edge(entryRows,&numEntries,memEntries,callStack,&callStackSize,edge,dec);
+                        }
+                        edge = getNextMemberEdge(dec,edge);
+                    }while(edge != first);
+                    break;
+                }
+                case SPQR_MEMBERTYPE_UNASSIGNED:
+                    assert(false);
+            }
+        }
+        for (MATREC_index i = columnStart; i < numEntries; ++i) {
+            entryColumns[i] = col;
+        }
+    }
+
+    //Counting sort of the nonzeros by row, which keeps the columns of each row in increasing order
+    MATREC_ERROR result = MATRECcreateIntMatrix(env,pMatrix,numRows,numColumns,(MATREC_matrix_size) numEntries);
+    if(result == MATREC_OKAY){
+        MATRECCSMatrixInt * matrix = *pMatrix;
+        for (MATREC_matrix_size row = 0; row <= numRows; ++row) {
+            matrix->firstRowIndex[row] = 0;
+        }
+        for (MATREC_index i = 0; i < numEntries; ++i) {
+            ++matrix->firstRowIndex[entryRows[i] + 1];
+        }
+        for (MATREC_matrix_size row = 0; row < numRows; ++row) {
+            matrix->firstRowIndex[row + 1] += matrix->firstRowIndex[row];
+        }
+        for (MATREC_index i = 0; i < numEntries; ++i) {
+            MATREC_matrix_size position = matrix->firstRowIndex[entryRows[i]];
+            matrix->entryColumns[position] = entryColumns[i];
+            matrix->entryValues[position] = 1;
+            ++matrix->firstRowIndex[entryRows[i]];
+        }
+        for (MATREC_matrix_size row = numRows; row > 0; --row) {
+            matrix->firstRowIndex[row] = matrix->firstRowIndex[row - 1];
+        }
+        matrix->firstRowIndex[0] = 0;
+    }
+
+    MATRECfreeBlockArray(env,&entryColumns);
+    MATRECfreeBlockArray(env,&entryRows);
+    MATRECfreeBlockArray(env,&memberVisited);
+    MATRECfreeBlockArray(env,&memberTreeEdge);
+    MATRECfreeBlockArray(env,&queue);
+    MATRECfreeBlockArray(env,&nodeDepth);
+    MATRECfreeBlockArray(env,&nodeParentEdge);
+    MATRECfreeBlockArray(env,&callStack);
+    MATRECfreeBlockArray(env,&columnEdges);
+    return result;
+}
+
 static int qsort_integer_comparison (const void * a, const void * b)
 {
-    int *s1 = (int *)a;
-    int *s2 = (int *)b;
+    const MATREC_row *s1 = (const MATREC_row *)a;
+    const MATREC_row *s2 = (const MATREC_row *)b;
 
     if(*s1 > *s2) {
         return 1;
@@ -1195,10 +1696,10 @@ static int qsort_integer_comparison (const void * a, const void * b)
     }
 }
 bool MATRECGraphicDecompositionVerifyCycle(const MATRECGraphicDecomposition * dec, MATREC_col column, MATREC_row * column_rows,
-                                           int num_rows, MATREC_row * computed_column_storage){
-    int num_found_rows = decompositionGetFundamentalCycleRows(dec,column,computed_column_storage);
+                                           MATREC_matrix_size num_rows, MATREC_row * computed_column_storage){
+    MATREC_index num_found_rows = decompositionGetFundamentalCycleRows(dec,column,computed_column_storage);
 
-    if(num_found_rows != num_rows){
+    if(num_found_rows < 0 || (MATREC_matrix_size) num_found_rows != num_rows){
         return false;
     }
     if(num_rows == 0){
@@ -1207,7 +1708,7 @@ bool MATRECGraphicDecompositionVerifyCycle(const MATRECGraphicDecomposition * de
     qsort(computed_column_storage, (size_t) num_rows, sizeof(MATREC_row), qsort_integer_comparison);
     qsort(column_rows            , (size_t) num_rows, sizeof(MATREC_row), qsort_integer_comparison);
 
-    for (int i = 0; i < num_rows; ++i) {
+    for (MATREC_matrix_size i = 0; i < num_rows; ++i) {
         if(column_rows[i] != computed_column_storage[i]){
             return false;
         }
@@ -1224,13 +1725,13 @@ static spqr_edge largestEdgeID(const MATRECGraphicDecomposition *dec){
 static spqr_node largestNodeID(const MATRECGraphicDecomposition *dec){
     return dec->numNodes;
 }
-static int numConnectedComponents(const MATRECGraphicDecomposition *dec){
+static MATREC_index numConnectedComponents(const MATRECGraphicDecomposition *dec){
     return dec->numConnectedComponents;
 }
 static MATREC_ERROR createChildMarker(MATRECGraphicDecomposition *dec, spqr_member member, spqr_member child, bool isTree, spqr_edge * pEdge){
     MATREC_CALL(createEdge(dec,member,pEdge));
-    dec->edges[*pEdge].element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
-    dec->edges[*pEdge].childMember = child;
+    EDGE(dec, *pEdge).element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
+    EDGE(dec, *pEdge).childMember = child;
 
     addEdgeToMemberEdgeList(dec,*pEdge,member);
     return MATREC_OKAY;
@@ -1239,13 +1740,13 @@ static MATREC_ERROR createParentMarker(MATRECGraphicDecomposition *dec, spqr_mem
         , spqr_edge * edge){
 
     MATREC_CALL(createEdge(dec,member,edge));
-    dec->edges[*edge].element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
+    EDGE(dec, *edge).element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
 
     addEdgeToMemberEdgeList(dec,*edge,member);
 
-    dec->members[member].parentMember = parent;
-    dec->members[member].markerOfParent = parentMarker;
-    dec->members[member].markerToParent = *edge;
+    setMemberParent(dec,member,parent);
+    MEMBER(dec, member).markerOfParent = parentMarker;
+    MEMBER(dec, member).markerToParent = *edge;
     return MATREC_OKAY;
 }
 static MATREC_ERROR createMarkerPair(MATRECGraphicDecomposition *dec, spqr_member parentMember, spqr_member childMember, bool parentIsTree){
@@ -1265,6 +1766,125 @@ static MATREC_ERROR createMarkerPairWithReferences(MATRECGraphicDecomposition *d
     return MATREC_OKAY;
 }
 
+///Creates the members of a decomposition from the split components of the graph and their tree
+static MATREC_ERROR createComponentMembers(MATRECGraphicDecomposition *dec, const MATRECSplitComponents *components,
+                                           const MATRECElement *edgeElements){
+    MATREC * env = dec->env;
+    MATREC_index numComponents = components->numComponents;
+    spqr_member * componentMember = NULL;
+    spqr_edge * parentMarker = NULL;
+    spqr_node * nodeOf = NULL;
+    MATREC_index * nodeStamp = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&componentMember,(size_t) (numComponents + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&parentMarker,(size_t) (numComponents + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeOf,(size_t) (components->numNodes + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeStamp,(size_t) (components->numNodes + 1)));
+    for (MATREC_index node = 0; node < components->numNodes; ++node) {
+        nodeStamp[node] = -1;
+    }
+
+    for (MATREC_index component = 0; component < numComponents; ++component) {
+        MATREC_index size = components->componentStarts[component + 1] - components->componentStarts[component];
+        SPQRMemberType type;
+        switch(components->componentTypes[component]){
+            case MATREC_SPLIT_RIGID:
+                type = SPQR_MEMBERTYPE_RIGID;
+                break;
+            case MATREC_SPLIT_BOND:
+                type = SPQR_MEMBERTYPE_PARALLEL;
+                break;
+            case MATREC_SPLIT_POLYGON:
+            default:
+                type = size <= 2 ? SPQR_MEMBERTYPE_LOOP : SPQR_MEMBERTYPE_SERIES;
+                break;
+        }
+        MATREC_CALL(createMember(dec,type,&componentMember[component]));
+    }
+    for (MATREC_index index = 0; index < numComponents; ++index) {
+        MATREC_index component = components->componentOrder[index];
+        spqr_member member = componentMember[component];
+        if(components->componentParent[component] < 0){
+            ++dec->numConnectedComponents;
+        }
+        bool isRigid = components->componentTypes[component] == MATREC_SPLIT_RIGID;
+        for (MATREC_index i = components->componentStarts[component]; i < components->componentStarts[component + 1]; ++i) {
+            MATREC_index graphEdge = components->componentEdges[i];
+            spqr_edge edge = SPQR_INVALID_EDGE;
+            if(graphEdge < components->numGraphEdges){
+                if(edgeElements[graphEdge].isRow){
+                    MATREC_CALL(createRowEdge(dec,member,&edge,edgeElements[graphEdge].index));
+                }else{
+                    MATREC_CALL(createColumnEdge(dec,member,&edge,edgeElements[graphEdge].index));
+                }
+            }else if(graphEdge == components->componentParentEdge[component]){
+                edge = parentMarker[component];
+            }else{
+                MATREC_index child = components->edgeChild[graphEdge];
+                MATREC_CALL(createMarkerPairWithReferences(dec,member,componentMember[child],
+                                                           components->componentTreeInParent[child],
+                                                           &edge,&parentMarker[child]));
+            }
+            if(!isRigid){
+                continue;
+            }
+            MATREC_index endpoints[2] = {components->edgeHeads[graphEdge],components->edgeTails[graphEdge]};
+            for (int j = 0; j < 2; ++j) {
+                if(nodeStamp[endpoints[j]] != component){
+                    nodeStamp[endpoints[j]] = component;
+                    MATREC_CALL(createNode(dec,&nodeOf[endpoints[j]]));
+                }
+            }
+            setEdgeHeadAndTail(dec,edge,nodeOf[endpoints[0]],nodeOf[endpoints[1]]);
+        }
+    }
+
+    MATRECfreeBlockArray(env,&nodeStamp);
+    MATRECfreeBlockArray(env,&nodeOf);
+    MATRECfreeBlockArray(env,&parentMarker);
+    MATRECfreeBlockArray(env,&componentMember);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECGraphicDecompositionCreateFromGraph(MATREC * env, MATRECGraphicDecomposition **pDecomposition,
+                                                       MATREC_matrix_size numNodes, MATREC_matrix_size numEdges,
+                                                       const MATREC_matrix_size * edgeTails,
+                                                       const MATREC_matrix_size * edgeHeads,
+                                                       const MATRECElement * edgeElements){
+    assert(env);
+    assert(pDecomposition && !*pDecomposition);
+    assert(numEdges == 0 || (edgeTails && edgeHeads && edgeElements));
+    if(numNodes >= (MATREC_matrix_size) MATREC_INDEX_MAX || numEdges >= (MATREC_matrix_size) MATREC_INDEX_MAX){
+        return MATREC_ERROR_INPUT;
+    }
+    MATREC_ERROR error = MATRECcheckGraphRealization(env,(MATREC_index) numNodes,(MATREC_index) numEdges,edgeTails,
+                                                     edgeHeads,edgeElements);
+    if(error != MATREC_OKAY){
+        return error;
+    }
+    MATREC_matrix_size numRows = 0;
+    MATREC_matrix_size numColumns = 0;
+    for (MATREC_matrix_size edge = 0; edge < numEdges; ++edge) {
+        MATREC_matrix_size * size = edgeElements[edge].isRow ? &numRows : &numColumns;
+        *size = edgeElements[edge].index + 1 > *size ? edgeElements[edge].index + 1 : *size;
+    }
+
+    MATRECSplitComponents * components = NULL;
+    MATREC_CALL(MATRECsplitComponentsCreate(env,&components,(MATREC_index) numNodes,(MATREC_index) numEdges,
+                                            edgeTails,edgeHeads));
+    MATREC_CALL(MATRECsplitComponentsBuildTree(env,components,edgeElements));
+    MATREC_CALL(createDecomposition(env,pDecomposition,numRows,numColumns,MATREC_IDS_DENSE,MATREC_IDS_DENSE));
+    MATREC_CALL(createComponentMembers(*pDecomposition,components,edgeElements));
+    MATRECsplitComponentsFree(env,&components);
+    if(MATRECtraceIsActive(env)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(env, &writer, MATREC_TRACE_GRAPHIC_CREATE_FROM_GRAPH);
+        MATRECtraceWriteDecomposition(&writer, &(*pDecomposition)->traceId);
+        MATRECtraceWriteGraph(&writer, numNodes, numEdges, edgeTails, edgeHeads, edgeElements);
+        MATRECtraceEnd(&writer);
+    }
+    return MATREC_OKAY;
+}
+
 static void moveEdgeToNewMember(MATRECGraphicDecomposition *dec, spqr_edge edge, spqr_member oldMember, spqr_member newMember){
     assert(SPQRedgeIsValid(edge));
     assert(edge < dec->memEdges);
@@ -1278,22 +1898,22 @@ static void moveEdgeToNewMember(MATRECGraphicDecomposition *dec, spqr_edge edge,
     removeEdgeFromMemberEdgeList(dec,edge,oldMember);
     addEdgeToMemberEdgeList(dec,edge,newMember);
 
-    dec->edges[edge].member = newMember;
+    EDGE(dec, edge).member = newMember;
 
     //If this edge has a childMember, update the information correctly!
-    spqr_member childMember = dec->edges[edge].childMember;
+    spqr_member childMember = EDGE(dec, edge).childMember;
     if(SPQRmemberIsValid(childMember)){
         spqr_member childRepresentative = findEdgeChildMember(dec, edge);
-        dec->members[childRepresentative].parentMember = newMember;
+        setMemberParent(dec,childRepresentative,newMember);
     }
     //If this edge is a marker to the parent, update the child edge marker of the parent to reflect the move
-    if(dec->members[oldMember].markerToParent == edge){
-        dec->members[newMember].markerToParent = edge;
-        dec->members[newMember].parentMember = dec->members[oldMember].parentMember;
-        dec->members[newMember].markerOfParent = dec->members[oldMember].markerOfParent;
+    if(MEMBER(dec, oldMember).markerToParent == edge){
+        MEMBER(dec, newMember).markerToParent = edge;
+        setMemberParent(dec,newMember,MEMBER(dec, oldMember).parentMember);
+        MEMBER(dec, newMember).markerOfParent = MEMBER(dec, oldMember).markerOfParent;
 
-        assert(findEdgeChildMemberNoCompression(dec,dec->members[oldMember].markerOfParent) == oldMember);
-        dec->edges[dec->members[oldMember].markerOfParent].childMember = newMember;
+        assert(findEdgeChildMemberNoCompression(dec,MEMBER(dec, oldMember).markerOfParent) == oldMember);
+        EDGE(dec, MEMBER(dec, oldMember).markerOfParent).childMember = newMember;
     }
 }
 static void mergeMemberEdgeList(MATRECGraphicDecomposition *dec, spqr_member toMergeInto, spqr_member toRemove){
@@ -1306,15 +1926,15 @@ static void mergeMemberEdgeList(MATRECGraphicDecomposition *dec, spqr_member toM
     spqr_edge lastFromEdge = getPreviousMemberEdge(dec, firstFromEdge);
 
     //Relink linked lists to merge them effectively
-    dec->edges[firstIntoEdge].edgeListNode.previous = lastFromEdge;
-    dec->edges[lastIntoEdge].edgeListNode.next = firstFromEdge;
-    dec->edges[firstFromEdge].edgeListNode.previous = lastIntoEdge;
-    dec->edges[lastFromEdge].edgeListNode.next = firstIntoEdge;
+    EDGE(dec, firstIntoEdge).edgeListNode.previous = lastFromEdge;
+    EDGE(dec, lastIntoEdge).edgeListNode.next = firstFromEdge;
+    EDGE(dec, firstFromEdge).edgeListNode.previous = lastIntoEdge;
+    EDGE(dec, lastFromEdge).edgeListNode.next = firstIntoEdge;
 
     //Clean up old
-    dec->members[toMergeInto].num_edges += dec->members[toRemove].num_edges;
-    dec->members[toRemove].num_edges = 0;
-    dec->members[toRemove].firstEdge = SPQR_INVALID_EDGE;
+    MEMBER(dec, toMergeInto).num_edges += MEMBER(dec, toRemove).num_edges;
+    MEMBER(dec, toRemove).num_edges = 0;
+    MEMBER(dec, toRemove).firstEdge = SPQR_INVALID_EDGE;
 
 }
 
@@ -1324,7 +1944,7 @@ static void changeLoopToSeries(MATRECGraphicDecomposition * dec, spqr_member mem
     assert(dec);
     assert((getMemberType(dec,member) == SPQR_MEMBERTYPE_PARALLEL || getMemberType(dec, member) == SPQR_MEMBERTYPE_SERIES || getMemberType(dec,member) == SPQR_MEMBERTYPE_LOOP) && getNumMemberEdges(dec, member) == 2);
     assert(memberIsRepresentative(dec,member));
-    dec->members[member].type = SPQR_MEMBERTYPE_SERIES;
+    MEMBER(dec, member).type = SPQR_MEMBERTYPE_SERIES;
 }
 static void changeLoopToParallel(MATRECGraphicDecomposition * dec, spqr_member member){
     assert(SPQRmemberIsValid(member));
@@ -1334,7 +1954,7 @@ static void changeLoopToParallel(MATRECGraphicDecomposition * dec, spqr_member m
     || getMemberType(dec, member) == SPQR_MEMBERTYPE_SERIES
     || getMemberType(dec,member) == SPQR_MEMBERTYPE_LOOP) && getNumMemberEdges(dec, member) == 2);
     assert(memberIsRepresentative(dec,member));
-    dec->members[member].type = SPQR_MEMBERTYPE_PARALLEL;
+    MEMBER(dec, member).type = SPQR_MEMBERTYPE_PARALLEL;
 }
 bool MATRECGraphicDecompositionIsMinimal(const MATRECGraphicDecomposition * dec){
     //Relies on parents/children etc. being set correctly in the tree
@@ -1365,7 +1985,7 @@ static void mergeLoop(MATRECGraphicDecomposition * dec, spqr_member loopMember){
 
 #ifndef NDEBUG
     {
-        int num_markers = 0;
+        MATREC_index num_markers = 0;
         spqr_edge first_edge = getFirstMemberEdge(dec, loopMember);
         spqr_edge edge = first_edge;
         do {
@@ -1422,44 +2042,44 @@ static void mergeLoop(MATRECGraphicDecomposition * dec, spqr_member loopMember){
     if(seriesIsParent){
         //other member must be a child
         spqr_member seriesChildEdge = markerOfParent(dec,loopMember);
-        dec->members[otherMember].markerOfParent = seriesChildEdge;
-        dec->members[otherMember].parentMember = seriesMember;
-        dec->edges[seriesChildEdge].childMember = otherMember;
+        MEMBER(dec, otherMember).markerOfParent = seriesChildEdge;
+        setMemberParent(dec,otherMember,seriesMember);
+        EDGE(dec, seriesChildEdge).childMember = otherMember;
 
         removeEdgeFromMemberEdgeList(dec,loopSeriesEdge,loopMember);
         removeEdgeFromMemberEdgeList(dec,loopOtherEdge,loopMember);
-        dec->members[loopMember].type = SPQR_MEMBERTYPE_UNASSIGNED;
+        MEMBER(dec, loopMember).type = SPQR_MEMBERTYPE_UNASSIGNED;
     }else if(otherIsParent){
         //series member is a child
         spqr_member otherChildEdge = markerOfParent(dec,loopMember);
-        dec->members[seriesMember].markerOfParent = otherChildEdge;
-        dec->members[seriesMember].parentMember = otherMember;
-        dec->edges[otherChildEdge].childMember = seriesMember;
+        MEMBER(dec, seriesMember).markerOfParent = otherChildEdge;
+        setMemberParent(dec,seriesMember,otherMember);
+        EDGE(dec, otherChildEdge).childMember = seriesMember;
 
         removeEdgeFromMemberEdgeList(dec,loopSeriesEdge,loopMember);
         removeEdgeFromMemberEdgeList(dec,loopOtherEdge,loopMember);
-        dec->members[loopMember].type = SPQR_MEMBERTYPE_UNASSIGNED;
+        MEMBER(dec, loopMember).type = SPQR_MEMBERTYPE_UNASSIGNED;
     }else{
         //The loop member is the root; we make the new series member the root
         spqr_edge seriesArcToLoop = markerToParent(dec,seriesMember);
 
-        dec->members[seriesMember].markerOfParent = SPQR_INVALID_EDGE;
-        dec->members[seriesMember].markerToParent = SPQR_INVALID_EDGE;
-        dec->members[seriesMember].parentMember = SPQR_INVALID_MEMBER;
-        dec->edges[seriesArcToLoop].childMember = otherMember;
+        MEMBER(dec, seriesMember).markerOfParent = SPQR_INVALID_EDGE;
+        MEMBER(dec, seriesMember).markerToParent = SPQR_INVALID_EDGE;
+        MEMBER(dec, seriesMember).parentMember = SPQR_INVALID_MEMBER;
+        EDGE(dec, seriesArcToLoop).childMember = otherMember;
 
-        dec->members[otherMember].parentMember = seriesMember;
-        dec->members[otherMember].markerOfParent = seriesArcToLoop;
+        setMemberParent(dec,otherMember,seriesMember);
+        MEMBER(dec, otherMember).markerOfParent = seriesArcToLoop;
 
         removeEdgeFromMemberEdgeList(dec,loopSeriesEdge,loopMember);
         removeEdgeFromMemberEdgeList(dec,loopOtherEdge,loopMember);
-        dec->members[loopMember].type = SPQR_MEMBERTYPE_UNASSIGNED;
+        MEMBER(dec, loopMember).type = SPQR_MEMBERTYPE_UNASSIGNED;
     }
 
 
 }
 
-static void decreaseNumConnectedComponents(MATRECGraphicDecomposition *dec, int by){
+static void decreaseNumConnectedComponents(MATRECGraphicDecomposition *dec, MATREC_index by){
     dec->numConnectedComponents-= by;
     assert(dec->numConnectedComponents >= 1);
 }
@@ -1468,25 +2088,25 @@ static void reorderComponent(MATRECGraphicDecomposition *dec, spqr_member newRoo
     assert(dec);
     assert(memberIsRepresentative(dec,newRoot));
     //If the newRoot has no parent, it is already the root, so then there's no need to reorder.
-    if(SPQRmemberIsValid(dec->members[newRoot].parentMember)){
+    if(SPQRmemberIsValid(MEMBER(dec, newRoot).parentMember)){
         spqr_member member = findMemberParent(dec, newRoot);
         spqr_member newParent = newRoot;
-        spqr_edge newMarkerToParent = dec->members[newRoot].markerOfParent;
-        spqr_edge markerOfNewParent = dec->members[newRoot].markerToParent;
+        spqr_edge newMarkerToParent = MEMBER(dec, newRoot).markerOfParent;
+        spqr_edge markerOfNewParent = MEMBER(dec, newRoot).markerToParent;
 
         //Recursively update the parent
         do{
             assert(SPQRmemberIsValid(member));
             assert(SPQRmemberIsValid(newParent));
             spqr_member oldParent = findMemberParent(dec, member);
-            spqr_edge oldMarkerToParent = dec->members[member].markerToParent;
-            spqr_edge oldMarkerOfParent = dec->members[member].markerOfParent;
+            spqr_edge oldMarkerToParent = MEMBER(dec, member).markerToParent;
+            spqr_edge oldMarkerOfParent = MEMBER(dec, member).markerOfParent;
 
-            dec->members[member].markerToParent = newMarkerToParent;
-            dec->members[member].markerOfParent = markerOfNewParent;
-            dec->members[member].parentMember = newParent;
-            dec->edges[markerOfNewParent].childMember = member;
-            dec->edges[newMarkerToParent].childMember = -1;
+            MEMBER(dec, member).markerToParent = newMarkerToParent;
+            MEMBER(dec, member).markerOfParent = markerOfNewParent;
+            setMemberParent(dec,member,newParent);
+            EDGE(dec, markerOfNewParent).childMember = member;
+            EDGE(dec, newMarkerToParent).childMember = -1;
 
             if (SPQRmemberIsValid(oldParent)){
                 newParent = member;
@@ -1497,9 +2117,9 @@ static void reorderComponent(MATRECGraphicDecomposition *dec, spqr_member newRoo
                 break;
             }
         }while(true);
-        dec->members[newRoot].parentMember = SPQR_INVALID_MEMBER;
-        dec->members[newRoot].markerToParent = SPQR_INVALID_EDGE;
-        dec->members[newRoot].markerOfParent = SPQR_INVALID_EDGE;
+        MEMBER(dec, newRoot).parentMember = SPQR_INVALID_MEMBER;
+        MEMBER(dec, newRoot).markerToParent = SPQR_INVALID_EDGE;
+        MEMBER(dec, newRoot).markerOfParent = SPQR_INVALID_EDGE;
     }
 }
 
@@ -1511,43 +2131,43 @@ static void edgeToDot(FILE * stream, const MATRECGraphicDecomposition * dec,
     char type = typeToChar(member_type);
     const char* color = edgeIsTree(dec,edge) ? ",color=red" :",color=blue";
 
-    int edge_name = edge;
+    MATREC_index edge_name = edge;
 
     if(markerToParent(dec,member) == edge){
         if(useElementNames){
             edge_name = -1;
         }
-        fprintf(stream, "    %c_%d_%lu -> %c_p_%d [label=\"%d\",style=dashed%s];\n", type, member, dot_head, type, member, edge_name, color);
-        fprintf(stream, "    %c_p_%d -> %c_%d_%lu [label=\"%d\",style=dashed%s];\n", type, member, type, member, dot_tail, edge_name, color);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_head);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_tail);
-        fprintf(stream, "    %c_p_%d [style=dashed];\n", type, member);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu -> %c_p_%" MATREC_PRIindex " [label=\"%" MATREC_PRIindex "\",style=dashed%s];\n", type, member, dot_head, type, member, edge_name, color);
+        fprintf(stream, "    %c_p_%" MATREC_PRIindex " -> %c_%" MATREC_PRIindex "_%lu [label=\"%" MATREC_PRIindex "\",style=dashed%s];\n", type, member, type, member, dot_tail, edge_name, color);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_head);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_tail);
+        fprintf(stream, "    %c_p_%" MATREC_PRIindex " [style=dashed];\n", type, member);
     }else if(edgeIsMarker(dec,edge)){
         spqr_member child = findEdgeChildMemberNoCompression(dec, edge);
         char childType = typeToChar(getMemberType(dec,child));
         if(useElementNames){
             edge_name = -1;
         }
-        fprintf(stream, "    %c_%d_%lu -> %c_c_%d [label=\"%d\",style=dotted%s];\n", type, member, dot_head, type, child, edge_name, color);
-        fprintf(stream, "    %c_c_%d -> %c_%d_%lu [label=\"%d\",style=dotted%s];\n", type, child, type, member, dot_tail, edge_name, color);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_head);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_tail);
-        fprintf(stream, "    %c_c_%d [style=dotted];\n", type, child);
-        fprintf(stream, "    %c_p_%d -> %c_c_%d [style=dashed,dir=forward];\n", childType, child, type, child);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu -> %c_c_%" MATREC_PRIindex " [label=\"%" MATREC_PRIindex "\",style=dotted%s];\n", type, member, dot_head, type, child, edge_name, color);
+        fprintf(stream, "    %c_c_%" MATREC_PRIindex " -> %c_%" MATREC_PRIindex "_%lu [label=\"%" MATREC_PRIindex "\",style=dotted%s];\n", type, child, type, member, dot_tail, edge_name, color);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_head);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_tail);
+        fprintf(stream, "    %c_c_%" MATREC_PRIindex " [style=dotted];\n", type, child);
+        fprintf(stream, "    %c_p_%" MATREC_PRIindex " -> %c_c_%" MATREC_PRIindex " [style=dashed,dir=forward];\n", childType, child, type, child);
     }else{
         if(useElementNames){
-            spqr_element element = dec->edges[edge].element;
+            spqr_element element = EDGE(dec, edge).element;
             if(SPQRelementIsRow(element)){
-                edge_name = (int) SPQRelementToRow(element);
+                edge_name = (MATREC_index) SPQRelementToRow(element);
             }else{
-                edge_name = (int) SPQRelementToColumn(element);
+                edge_name = (MATREC_index) SPQRelementToColumn(element);
             }
         }
 
-        fprintf(stream, "    %c_%d_%lu -> %c_%d_%lu [label=\"%d \",style=bold%s];\n", type, member, dot_head, type, member, dot_tail,
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu -> %c_%" MATREC_PRIindex "_%lu [label=\"%" MATREC_PRIindex " \",style=bold%s];\n", type, member, dot_head, type, member, dot_tail,
                 edge_name, color);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_head);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_tail);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_head);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_tail);
     }
 }
 
@@ -1555,7 +2175,7 @@ static void decompositionToDot(FILE * stream, const MATRECGraphicDecomposition *
     fprintf(stream, "//decomposition\ndigraph decomposition{\n   compound = true;\n");
     for (spqr_member member = 0; member < dec->numMembers; ++member){
         if(!memberIsRepresentative(dec,member)) continue;
-        fprintf(stream,"   subgraph member_%d{\n",member);
+        fprintf(stream,"   subgraph member_%" MATREC_PRIindex "{\n",member);
         switch(getMemberType(dec,member)){
             case SPQR_MEMBERTYPE_RIGID:
             {
@@ -1605,11 +2225,11 @@ static void decompositionToDot(FILE * stream, const MATRECGraphicDecomposition *
     fprintf(stream,"}\n");
 }
 
-static int max(int a, int b){
+static MATREC_index max(MATREC_index a, MATREC_index b){
     return (a > b) ? a : b;
 }
 
-typedef int path_edge_id;
+typedef MATREC_index path_edge_id;
 #define INVALID_PATH_EDGE (-1)
 
 static bool pathEdgeIsInvalid(const path_edge_id edge) {
@@ -1628,7 +2248,7 @@ typedef struct {
     path_edge_id nextOverall;
 } PathEdgeListNode;
 
-typedef int reduced_member_id;
+typedef MATREC_index reduced_member_id;
 #define INVALID_REDUCED_MEMBER (-1)
 
 static bool reducedMemberIsInvalid(const reduced_member_id id) {
@@ -1638,7 +2258,7 @@ static bool reducedMemberIsValid(const reduced_member_id id){
     return !reducedMemberIsInvalid(id);
 }
 
-typedef int children_idx;
+typedef MATREC_index children_idx;
 
 typedef enum {
     TYPE_INVALID = 1,
@@ -1652,7 +2272,7 @@ typedef enum {
 typedef struct {
     spqr_member member;
     spqr_member rootMember;
-    int depth;
+    MATREC_index depth;
     ReducedMemberType type;
     reduced_member_id parent;
 
@@ -1660,70 +2280,189 @@ typedef struct {
     children_idx numChildren;
 
     path_edge_id firstPathEdge;
-    int numPathEdges;
+    MATREC_index numPathEdges;
 
-    int numOneEnd;
-    int numTwoEnds;
+    MATREC_index numOneEnd;
+    MATREC_index numTwoEnds;
     spqr_edge childMarkerEdges[2];
     spqr_node rigidEndNodes[4];
 } MATRECColReducedMember;
 
 typedef struct {
-    int rootDepth;
+    MATREC_index rootDepth;
     reduced_member_id root;
 } MATRECColReducedComponent;
 
 typedef struct {
     reduced_member_id reducedMember;
     reduced_member_id rootDepthMinimizer;
+    spqr_member componentLCA; ///Lowest common ancestor of the touched members in the tree of which this member is the root
 } MemberInfo;
 
 typedef struct {
     spqr_member member;
 } CreateReducedMembersCallstack;
 
+///Memory which is only used within a single call to a Check function. Both before and after the call, each
+///memberInformation entry is invalid. Thus, it can be shared between a row addition and a column addition.
+struct MATRECGraphicAdditionScratchImpl {
+    MemberInfo *memberInformation;
+    MATREC_index memMemberInformation;
+    MATREC_index numMemberInformation;
+
+    CreateReducedMembersCallstack * createReducedMembersCallStack;
+    MATREC_index memCreateReducedMembersCallStack;
+
+    spqr_edge * nonzeroEdges; ///The edges of the nonzeros of the checked row or column, looked up at once
+    MATREC_index memNonzeroEdges;
+
+    ///Used to compare the fundamental cycles of the columns in the column table with a new column
+    spqr_edge * cycleCallStack;
+    MATREC_index memCycleCallStack;
+    FindPathCall * cyclePathCallStack;
+    MATREC_index memCyclePathCallStack;
+    MATREC_row * cycleRows;
+    MATREC_index memCycleRows;
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+};
+
+///Looks up the edges of all nonzeros in the scratch memory, which is faster than looking them up one by one
+static MATREC_ERROR lookupNonzeroEdges(MATREC *env, MATRECGraphicAdditionScratch *scratch, const MATRECIdMap * map,
+                                      const MATREC_matrix_size * ids, MATREC_matrix_size numIds){
+    if((MATREC_index) numIds > scratch->memNonzeroEdges){
+        MATREC_index newSize = max(2 * scratch->memNonzeroEdges, (MATREC_index) numIds);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->nonzeroEdges, (size_t) newSize));
+        scratch->memNonzeroEdges = newSize;
+    }
+    MATRECidMapGetMany(map, ids, (size_t) numIds, scratch->nonzeroEdges);
+    return MATREC_OKAY;
+}
+
+static void initializeScratchArrays(MATRECGraphicAdditionScratch *scratch){
+    scratch->memberInformation = NULL;
+    scratch->memMemberInformation = 0;
+    scratch->numMemberInformation = 0;
+
+    scratch->createReducedMembersCallStack = NULL;
+    scratch->memCreateReducedMembersCallStack = 0;
+
+    scratch->nonzeroEdges = NULL;
+    scratch->memNonzeroEdges = 0;
+
+    scratch->cycleCallStack = NULL;
+    scratch->memCycleCallStack = 0;
+    scratch->cyclePathCallStack = NULL;
+    scratch->memCyclePathCallStack = 0;
+    scratch->cycleRows = NULL;
+    scratch->memCycleRows = 0;
+}
+
+static void freeScratchArrays(MATREC *env, MATRECGraphicAdditionScratch *scratch){
+    MATRECfreeBlockArray(env, &scratch->cycleRows);
+    MATRECfreeBlockArray(env, &scratch->cyclePathCallStack);
+    MATRECfreeBlockArray(env, &scratch->cycleCallStack);
+    MATRECfreeBlockArray(env, &scratch->nonzeroEdges);
+    MATRECfreeBlockArray(env, &scratch->createReducedMembersCallStack);
+    MATRECfreeBlockArray(env, &scratch->memberInformation);
+}
+
+MATREC_ERROR MATRECcreateGraphicAdditionScratch(MATREC *env, MATRECGraphicAdditionScratch **pScratch){
+    assert(env);
+    MATREC_CALL(MATRECallocBlock(env, pScratch));
+    MATRECGraphicAdditionScratch *scratch = *pScratch;
+    initializeScratchArrays(scratch);
+    scratch->peakMemory = 0;
+    return MATREC_OKAY;
+}
+
+void MATRECfreeGraphicAdditionScratch(MATREC *env, MATRECGraphicAdditionScratch **pScratch){
+    assert(env);
+    assert(*pScratch);
+    freeScratchArrays(env, *pScratch);
+    MATRECfreeBlock(env, pScratch);
+}
+
+static void addScratchMemory(const MATRECGraphicAdditionScratch *scratch, MATRECMemoryReport *report){
+    //All scratch memory is unused outside of the Check functions
+    MATRECmemoryReportAddBytes(report, "scratch", sizeof(MATRECGraphicAdditionScratch), 0);
+    MATRECmemoryReportAdd(report, "memberInformation", sizeof(MemberInfo), scratch->memMemberInformation, 0);
+    MATRECmemoryReportAdd(report, "createReducedMembersCallStack", sizeof(CreateReducedMembersCallstack),
+                          scratch->memCreateReducedMembersCallStack, 0);
+    MATRECmemoryReportAdd(report, "nonzeroEdges", sizeof(spqr_edge), scratch->memNonzeroEdges, 0);
+    MATRECmemoryReportAdd(report, "cycleCallStack", sizeof(spqr_edge), scratch->memCycleCallStack, 0);
+    MATRECmemoryReportAdd(report, "cyclePathCallStack", sizeof(FindPathCall), scratch->memCyclePathCallStack, 0);
+    MATRECmemoryReportAdd(report, "cycleRows", sizeof(MATREC_row), scratch->memCycleRows, 0);
+}
+
+void MATRECGraphicAdditionScratchMemory(const MATRECGraphicAdditionScratch *scratch, MATRECMemoryReport *report){
+    assert(scratch);
+    assert(report);
+    MATRECmemoryReportInit(report);
+    addScratchMemory(scratch, report);
+    MATRECmemoryReportFinish(report, scratch->peakMemory);
+}
+
+///Frees all scratch memory, which the next Check call allocates again as needed
+static void shrinkScratch(MATREC *env, MATRECGraphicAdditionScratch *scratch){
+    MATRECMemoryReport report;
+    MATRECGraphicAdditionScratchMemory(scratch, &report);
+    scratch->peakMemory = report.peakBytes;
+    freeScratchArrays(env, scratch);
+    initializeScratchArrays(scratch);
+}
+
 struct MATRECGraphicColumnAdditionImpl {
     bool remainsGraphic;
 
     MATRECColReducedMember *reducedMembers;
-    int memReducedMembers;
-    int numReducedMembers;
+    MATREC_index memReducedMembers;
+    MATREC_index numReducedMembers;
 
     MATRECColReducedComponent *reducedComponents;
-    int memReducedComponents;
-    int numReducedComponents;
+    MATREC_index memReducedComponents;
+    MATREC_index numReducedComponents;
 
-    MemberInfo *memberInformation;
-    int memMemberInformation;
-    int numMemberInformation;
+    MATRECGraphicAdditionScratch *scratch;
+    bool ownsScratch; ///Whether the scratch memory is freed together with this object
 
     reduced_member_id *childrenStorage;
-    int memChildrenStorage;
-    int numChildrenStorage;
+    MATREC_index memChildrenStorage;
+    MATREC_index numChildrenStorage;
 
     PathEdgeListNode *pathEdges;
-    int memPathEdges;
-    int numPathEdges;
+    MATREC_index memPathEdges;
+    MATREC_index numPathEdges;
     path_edge_id firstOverallPathEdge;
 
-    int *nodePathDegree;
-    int memNodePathDegree;
+    MATREC_index *nodePathDegree;
+    MATREC_index memNodePathDegree;
 
     bool *edgeInPath;
-    int memEdgesInPath;
-
-    CreateReducedMembersCallstack * createReducedMembersCallStack;
-    int memCreateReducedMembersCallStack;
+    MATREC_index memEdgesInPath;
 
     MATREC_col newColIndex;
 
     MATREC_row *newRowEdges;
-    int memNewRowEdges;
-    int numNewRowEdges;
+    MATREC_index memNewRowEdges;
+    MATREC_index numNewRowEdges;
 
     spqr_edge *decompositionRowEdges;
-    int memDecompositionRowEdges;
-    int numDecompositionRowEdges;
+    MATREC_index memDecompositionRowEdges;
+    MATREC_index numDecompositionRowEdges;
+
+    MATRECColumnTableEntry *columnEntries;
+    MATREC_index memColumnEntries;
+    MATREC_index numColumnEntries;
+    uint64_t columnHash;
+    bool isDuplicate; ///Whether the path was replaced by the edge of an existing column with the same rows
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+    //If not 0, the arrays are freed after this many consecutive checks on a much smaller decomposition
+    size_t autoShrinkCalls;
+    size_t numUnderusedCalls;
+
+    MATRECTraceId traceId;
 };
 
 static void cleanupPreviousIteration(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol) {
@@ -1748,11 +2487,11 @@ static void cleanupPreviousIteration(MATRECGraphicDecomposition *dec, MATRECGrap
         pathEdge = newCol->pathEdges[pathEdge].nextOverall;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newCol->memEdgesInPath; ++i) {
+    for (MATREC_index i = 0; i < newCol->memEdgesInPath; ++i) {
         assert(newCol->edgeInPath[i] == false);
     }
 
-    for (int i = 0; i < newCol->memNodePathDegree; ++i) {
+    for (MATREC_index i = 0; i < newCol->memNodePathDegree; ++i) {
         assert(newCol->nodePathDegree[i] == 0);
     }
 #endif
@@ -1761,13 +2500,7 @@ static void cleanupPreviousIteration(MATRECGraphicDecomposition *dec, MATRECGrap
     newCol->numPathEdges = 0;
 }
 
-MATREC_ERROR MATRECcreateGraphicColumnAddition(MATREC *env, MATRECGraphicColumnAddition **pNewCol) {
-    assert(env);
-
-    MATREC_CALL(MATRECallocBlock(env, pNewCol));
-    MATRECGraphicColumnAddition *newCol = *pNewCol;
-
-    newCol->remainsGraphic = false;
+static void initializeColumnAdditionArrays(MATRECGraphicColumnAddition *newCol){
     newCol->reducedMembers = NULL;
     newCol->memReducedMembers = 0;
     newCol->numReducedMembers = 0;
@@ -1776,10 +2509,6 @@ MATREC_ERROR MATRECcreateGraphicColumnAddition(MATREC *env, MATRECGraphicColumnA
     newCol->memReducedComponents = 0;
     newCol->numReducedComponents = 0;
 
-    newCol->memberInformation = NULL;
-    newCol->memMemberInformation = 0;
-    newCol->numMemberInformation = 0;
-
     newCol->childrenStorage = NULL;
     newCol->memChildrenStorage = 0;
     newCol->numChildrenStorage = 0;
@@ -1795,50 +2524,196 @@ MATREC_ERROR MATRECcreateGraphicColumnAddition(MATREC *env, MATRECGraphicColumnA
     newCol->edgeInPath = NULL;
     newCol->memEdgesInPath = 0;
 
-    newCol->createReducedMembersCallStack = NULL;
-    newCol->memCreateReducedMembersCallStack = 0;
-
-    newCol->newColIndex = MATREC_INVALID_COL;
-
     newCol->newRowEdges = NULL;
     newCol->memNewRowEdges = 0;
     newCol->numNewRowEdges = 0;
 
-    newCol->decompositionRowEdges = NULL;
-    newCol->memDecompositionRowEdges = 0;
-    newCol->numDecompositionRowEdges = 0;
+    newCol->decompositionRowEdges = NULL;
+    newCol->memDecompositionRowEdges = 0;
+    newCol->numDecompositionRowEdges = 0;
+
+    newCol->columnEntries = NULL;
+    newCol->memColumnEntries = 0;
+    newCol->numColumnEntries = 0;
+}
+
+static void freeColumnAdditionArrays(MATREC *env, MATRECGraphicColumnAddition *newCol){
+    MATRECfreeBlockArray(env, &newCol->columnEntries);
+    MATRECfreeBlockArray(env, &newCol->decompositionRowEdges);
+    MATRECfreeBlockArray(env, &newCol->newRowEdges);
+    MATRECfreeBlockArray(env, &newCol->edgeInPath);
+    MATRECfreeBlockArray(env, &newCol->nodePathDegree);
+    MATRECfreeBlockArray(env, &newCol->pathEdges);
+    MATRECfreeBlockArray(env, &newCol->childrenStorage);
+    MATRECfreeBlockArray(env, &newCol->reducedComponents);
+    MATRECfreeBlockArray(env, &newCol->reducedMembers);
+}
+
+MATREC_ERROR MATRECcreateGraphicColumnAddition(MATREC *env, MATRECGraphicColumnAddition **pNewCol) {
+    return MATRECcreateGraphicColumnAdditionWithScratch(env, pNewCol, NULL);
+}
+
+MATREC_ERROR MATRECcreateGraphicColumnAdditionWithScratch(MATREC *env, MATRECGraphicColumnAddition **pNewCol, MATRECGraphicAdditionScratch *scratch) {
+    assert(env);
+
+    MATREC_CALL(MATRECallocBlock(env, pNewCol));
+    MATRECGraphicColumnAddition *newCol = *pNewCol;
+
+    newCol->ownsScratch = scratch == NULL;
+    if(newCol->ownsScratch){
+        MATREC_CALL(MATRECcreateGraphicAdditionScratch(env, &scratch));
+    }
+    newCol->scratch = scratch;
+
+    newCol->remainsGraphic = false;
+    newCol->newColIndex = MATREC_INVALID_COL;
+    newCol->columnHash = 0;
+    newCol->isDuplicate = false;
+    initializeColumnAdditionArrays(newCol);
+
+    newCol->peakMemory = 0;
+    newCol->autoShrinkCalls = 0;
+    newCol->numUnderusedCalls = 0;
+    MATRECtraceIdInit(&newCol->traceId);
+    return MATREC_OKAY;
+}
+
+void MATRECfreeGraphicColumnAddition(MATREC *env, MATRECGraphicColumnAddition **pNewCol) {
+    assert(env);
+    MATRECGraphicColumnAddition *newCol = *pNewCol;
+    traceFreeAddition(env, &newCol->traceId);
+    freeColumnAdditionArrays(env, newCol);
+
+    if(newCol->ownsScratch){
+        MATRECfreeGraphicAdditionScratch(env, &newCol->scratch);
+    }
+    MATRECfreeBlock(env, pNewCol);
+}
+
+void MATRECGraphicColumnAdditionMemory(const MATRECGraphicColumnAddition *newCol, MATRECMemoryReport *report){
+    assert(newCol);
+    assert(report);
+    MATRECmemoryReportInit(report);
+    MATRECmemoryReportAddBytes(report, "columnAddition", sizeof(MATRECGraphicColumnAddition),
+                               sizeof(MATRECGraphicColumnAddition));
+    MATRECmemoryReportAdd(report, "reducedMembers", sizeof(MATRECColReducedMember), newCol->memReducedMembers,
+                          newCol->numReducedMembers);
+    MATRECmemoryReportAdd(report, "reducedComponents", sizeof(MATRECColReducedComponent),
+                          newCol->memReducedComponents, newCol->numReducedComponents);
+    MATRECmemoryReportAdd(report, "childrenStorage", sizeof(reduced_member_id), newCol->memChildrenStorage,
+                          newCol->numChildrenStorage);
+    MATRECmemoryReportAdd(report, "pathEdges", sizeof(PathEdgeListNode), newCol->memPathEdges,
+                          newCol->numPathEdges);
+    //Arrays indexed by the nodes and edges of the decomposition are always fully in use
+    MATRECmemoryReportAdd(report, "nodePathDegree", sizeof(MATREC_index), newCol->memNodePathDegree,
+                          newCol->memNodePathDegree);
+    MATRECmemoryReportAdd(report, "edgeInPath", sizeof(bool), newCol->memEdgesInPath, newCol->memEdgesInPath);
+    MATRECmemoryReportAdd(report, "newRowEdges", sizeof(MATREC_row), newCol->memNewRowEdges,
+                          newCol->numNewRowEdges);
+    MATRECmemoryReportAdd(report, "decompositionRowEdges", sizeof(spqr_edge), newCol->memDecompositionRowEdges,
+                          newCol->numDecompositionRowEdges);
+    MATRECmemoryReportAdd(report, "columnEntries", sizeof(MATRECColumnTableEntry), newCol->memColumnEntries,
+                          newCol->numColumnEntries);
+    if(newCol->ownsScratch){
+        addScratchMemory(newCol->scratch, report);
+    }
+    MATRECmemoryReportFinish(report, newCol->peakMemory);
+}
+
+void MATRECGraphicColumnAdditionShrink(MATREC *env, MATRECGraphicColumnAddition *newCol){
+    assert(env);
+    assert(newCol);
+    MATRECMemoryReport report;
+    MATRECGraphicColumnAdditionMemory(newCol, &report);
+    newCol->peakMemory = report.peakBytes;
+    freeColumnAdditionArrays(env, newCol);
+    initializeColumnAdditionArrays(newCol);
+    newCol->numUnderusedCalls = 0;
+    shrinkScratch(env, newCol->scratch);
+}
+
+void MATRECGraphicColumnAdditionSetAutoShrink(MATRECGraphicColumnAddition *newCol, size_t numCalls){
+    assert(newCol);
+    newCol->autoShrinkCalls = numCalls;
+    newCol->numUnderusedCalls = 0;
+}
+
+///Counts the consecutive checks on a decomposition with fewer than a quarter of the edges that the arrays were grown
+///for, and shrinks the addition once there are enough of them
+static void autoShrinkColumnAddition(const MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol){
+    if(4 * largestEdgeID(dec) >= newCol->memEdgesInPath){
+        newCol->numUnderusedCalls = 0;
+        return;
+    }
+    ++newCol->numUnderusedCalls;
+    if(newCol->numUnderusedCalls >= newCol->autoShrinkCalls){
+        MATRECGraphicColumnAdditionShrink(dec->env, newCol);
+    }
+}
+
+
+static MATREC_index ancestorIndexMemberParent(void * data, MATREC_index member){
+    MATRECGraphicDecomposition * dec = (MATRECGraphicDecomposition *) data;
+    if(!memberIsRepresentative(dec, member)){
+        return SPQR_INVALID_MEMBER;
+    }
+    return findMemberParent(dec, member);
+}
 
+///Builds the ancestor index of the member tree once walking the tree without it has cost more than building it
+static MATREC_ERROR updateMemberAncestorIndex(MATRECGraphicDecomposition *dec){
+    if(MATRECancestorIndexShouldBuild(&dec->memberAncestors, dec->numMembers)){
+        MATREC_CALL(MATRECancestorIndexBuild(dec->env, &dec->memberAncestors, dec->numMembers,
+                                             ancestorIndexMemberParent, dec));
+    }
     return MATREC_OKAY;
 }
 
-void MATRECfreeGraphicColumnAddition(MATREC *env, MATRECGraphicColumnAddition **pNewCol) {
-    assert(env);
-    MATRECGraphicColumnAddition *newCol = *pNewCol;
-    MATRECfreeBlockArray(env, &newCol->decompositionRowEdges);
-    MATRECfreeBlockArray(env, &newCol->newRowEdges);
-    MATRECfreeBlockArray(env, &newCol->createReducedMembersCallStack);
-    MATRECfreeBlockArray(env, &newCol->edgeInPath);
-    MATRECfreeBlockArray(env, &newCol->nodePathDegree);
-    MATRECfreeBlockArray(env, &newCol->pathEdges);
-    MATRECfreeBlockArray(env, &newCol->childrenStorage);
-    MATRECfreeBlockArray(env, &newCol->memberInformation);
-    MATRECfreeBlockArray(env, &newCol->reducedComponents);
-    MATRECfreeBlockArray(env, &newCol->reducedMembers);
-
-    MATRECfreeBlock(env, pNewCol);
+static MATREC_index ancestorIndexMemberChildren(void * data, MATREC_index member, MATREC_index * children){
+    MATRECGraphicDecomposition * dec = (MATRECGraphicDecomposition *) data;
+    MATREC_index numChildren = 0;
+    spqr_edge firstEdge = getFirstMemberEdge(dec, member);
+    spqr_edge edge = firstEdge;
+    do{
+        if(edge != markerToParent(dec, member) && edgeIsMarker(dec, edge)){
+            children[numChildren] = findEdgeChildMember(dec, edge);
+            ++numChildren;
+        }
+        edge = getNextMemberEdge(dec, edge);
+    }while(edge != firstEdge);
+    return numChildren;
 }
 
+///Repairs the ancestor index after an addition, which only changed the subtree of the member top. If top is invalid,
+///the addition reached the root of the tree, and the whole tree containing the changed member is repaired
+static void repairMemberAncestorIndex(MATRECGraphicDecomposition *dec, spqr_member top, spqr_member changed){
+    if(!dec->memberAncestors.valid){
+        return;
+    }
+    if(SPQRmemberIsValid(top)){
+        top = findMember(dec, top);
+    }else{
+        top = findMember(dec, changed);
+        for (spqr_member parent = findMemberParent(dec, top); SPQRmemberIsValid(parent);
+             parent = findMemberParent(dec, top)) {
+            top = parent;
+        }
+    }
+    MATRECancestorIndexRepair(&dec->memberAncestors, dec->numMembers, top, ancestorIndexMemberParent,
+                              ancestorIndexMemberChildren, dec);
+}
 
-static reduced_member_id createReducedMembersToRoot(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition * newCol, const spqr_member firstMember ){
+static reduced_member_id createReducedMembersToRoot(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition * newCol, const spqr_member firstMember,
+                                                    const spqr_member stopMember){
     assert(SPQRmemberIsValid(firstMember));
 
-    CreateReducedMembersCallstack * callstack = newCol->createReducedMembersCallStack;
+    CreateReducedMembersCallstack * callstack = newCol->scratch->createReducedMembersCallStack;
     callstack[0].member = firstMember;
-    int callDepth = 0;
+    MATREC_index callDepth = 0;
 
     while(callDepth >= 0){
         spqr_member member = callstack[callDepth].member;
-        reduced_member_id reducedMember = newCol->memberInformation[member].reducedMember;
+        reduced_member_id reducedMember = newCol->scratch->memberInformation[member].reducedMember;
 
         bool reducedValid = reducedMemberIsValid(reducedMember);
         if(!reducedValid) {
@@ -1854,19 +2729,20 @@ static reduced_member_id createReducedMembersToRoot(MATRECGraphicDecomposition *
             reducedMemberData->type = TYPE_INVALID;
             reducedMemberData->firstPathEdge = INVALID_PATH_EDGE;
             reducedMemberData->numPathEdges = 0;
-            for (int i = 0; i < 4; ++i) {
+            for (MATREC_index i = 0; i < 4; ++i) {
                 reducedMemberData->rigidEndNodes[i] = SPQR_INVALID_NODE;
             }
             //The children are set later
 
-            newCol->memberInformation[member].reducedMember = reducedMember;
+            newCol->scratch->memberInformation[member].reducedMember = reducedMember;
             assert(memberIsRepresentative(dec, member));
-            spqr_member parentMember = findMemberParent(dec, member);
+            //The stop member is the root of the reduced component, so we do not need to walk further up the tree
+            spqr_member parentMember = member == stopMember ? SPQR_INVALID_MEMBER : findMemberParent(dec, member);
 
             if (SPQRmemberIsValid(parentMember)) {
                 //recursive call to parent member
                 ++callDepth;
-                assert(callDepth < newCol->memCreateReducedMembersCallStack);
+                assert(callDepth < newCol->scratch->memCreateReducedMembersCallStack);
                 callstack[callDepth].member = parentMember;
                 continue;
 
@@ -1886,7 +2762,7 @@ static reduced_member_id createReducedMembersToRoot(MATRECGraphicDecomposition *
             assert(reducedMember < newCol->numReducedMembers);
             //Reduced member was already created in earlier call
             //update the depth of the root if appropriate
-            reduced_member_id * depthMinimizer = &newCol->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+            reduced_member_id * depthMinimizer = &newCol->scratch->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
             if(reducedMemberIsInvalid(*depthMinimizer) ||
                newCol->reducedMembers[reducedMember].depth < newCol->reducedMembers[*depthMinimizer].depth){
                 *depthMinimizer = reducedMember;
@@ -1896,9 +2772,9 @@ static reduced_member_id createReducedMembersToRoot(MATRECGraphicDecomposition *
             --callDepth;
             if(callDepth < 0 ) break;
             spqr_member parentMember = callstack[callDepth + 1].member;
-            reduced_member_id parentReducedMember = newCol->memberInformation[parentMember].reducedMember;
+            reduced_member_id parentReducedMember = newCol->scratch->memberInformation[parentMember].reducedMember;
             spqr_member currentMember = callstack[callDepth].member;
-            reduced_member_id currentReducedMember = newCol->memberInformation[currentMember].reducedMember;
+            reduced_member_id currentReducedMember = newCol->scratch->memberInformation[currentMember].reducedMember;
 
             MATRECColReducedMember *parentReducedMemberData = &newCol->reducedMembers[parentReducedMember];
             MATRECColReducedMember *reducedMemberData = &newCol->reducedMembers[currentReducedMember];
@@ -1912,7 +2788,7 @@ static reduced_member_id createReducedMembersToRoot(MATRECGraphicDecomposition *
 
     }
 
-    reduced_member_id returnedMember = newCol->memberInformation[callstack[0].member].reducedMember;
+    reduced_member_id returnedMember = newCol->scratch->memberInformation[callstack[0].member].reducedMember;
     return returnedMember;
 }
 
@@ -1920,8 +2796,8 @@ static MATREC_ERROR constructReducedDecomposition(MATRECGraphicDecomposition *de
     assert(dec);
     assert(newCol);
 #ifndef NDEBUG
-    for (int i = 0; i < newCol->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newCol->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newCol->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newCol->scratch->memberInformation[i].reducedMember));
     }
 #endif
     newCol->numReducedComponents = 0;
@@ -1932,52 +2808,83 @@ static MATREC_ERROR constructReducedDecomposition(MATRECGraphicDecomposition *de
     assert(newCol->numReducedMembers == 0);
     assert(newCol->numReducedComponents == 0);
 
-    int newSize = largestMemberID(dec); //Is this sufficient?
+    MATREC_index newSize = largestMemberID(dec); //Is this sufficient?
     if (newSize > newCol->memReducedMembers) {
         newCol->memReducedMembers = max(2 * newCol->memReducedMembers, newSize);
         MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->reducedMembers, (size_t) newCol->memReducedMembers));
     }
-    if (newSize > newCol->memMemberInformation) {
-        int updatedSize = max(2 * newCol->memMemberInformation, newSize);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->memberInformation, (size_t) updatedSize));
-        for (int i = newCol->memMemberInformation; i < updatedSize; ++i) {
-            newCol->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
-            newCol->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+    if (newSize > newCol->scratch->memMemberInformation) {
+        MATREC_index updatedSize = max(2 * newCol->scratch->memMemberInformation, newSize);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->scratch->memberInformation, (size_t) updatedSize));
+        for (MATREC_index i = newCol->scratch->memMemberInformation; i < updatedSize; ++i) {
+            newCol->scratch->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
+            newCol->scratch->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+            newCol->scratch->memberInformation[i].componentLCA = SPQR_INVALID_MEMBER;
         }
-        newCol->memMemberInformation = updatedSize;
+        newCol->scratch->memMemberInformation = updatedSize;
 
     }
 
-    int numComponents = numConnectedComponents(dec);
+    MATREC_index numComponents = numConnectedComponents(dec);
     if (numComponents > newCol->memReducedComponents) {
         newCol->memReducedComponents = max(2 * newCol->memReducedComponents, numComponents);
         MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->reducedComponents, (size_t) newCol->memReducedComponents));
     }
 
-    int numMembers = getNumMembers(dec);
-    if (newCol->memCreateReducedMembersCallStack < numMembers) {
-        newCol->memCreateReducedMembersCallStack = max(2 * newCol->memCreateReducedMembersCallStack, numMembers);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->createReducedMembersCallStack,
-                                        (size_t) newCol->memCreateReducedMembersCallStack));
+    MATREC_index numMembers = getNumMembers(dec);
+    if (newCol->scratch->memCreateReducedMembersCallStack < numMembers) {
+        newCol->scratch->memCreateReducedMembersCallStack = max(2 * newCol->scratch->memCreateReducedMembersCallStack, numMembers);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->scratch->createReducedMembersCallStack,
+                                        (size_t) newCol->scratch->memCreateReducedMembersCallStack));
     }
 
     //Create the reduced members (recursively)
-    for (int i = 0; i < newCol->numDecompositionRowEdges; ++i) {
+    //With the ancestor index, we only walk up to the lowest common ancestor of the touched members in each tree.
+    //A single edge needs no walk at all, as its member forms the entire reduced decomposition
+    bool singleEdge = newCol->numDecompositionRowEdges == 1;
+    if(!singleEdge){
+        MATREC_CALL(updateMemberAncestorIndex(dec));
+    }
+    const MATRECAncestorIndex * ancestors = &dec->memberAncestors;
+    bool useAncestors = !singleEdge && ancestors->valid;
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newCol->numDecompositionRowEdges; ++i) {
+            spqr_member edgeMember = findEdgeMember(dec, newCol->decompositionRowEdges[i]);
+            spqr_member * lca = &newCol->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,edgeMember)].componentLCA;
+            *lca = SPQRmemberIsValid(*lca) ? MATRECancestorIndexLCA(ancestors,*lca,edgeMember) : edgeMember;
+        }
+    }
+    for (MATREC_index i = 0; i < newCol->numDecompositionRowEdges; ++i) {
         assert(i < newCol->memDecompositionRowEdges);
         spqr_edge edge = newCol->decompositionRowEdges[i];
         spqr_member edgeMember = findEdgeMember(dec, edge);
-        reduced_member_id reducedMember = createReducedMembersToRoot(dec, newCol, edgeMember);
-        reduced_member_id *depthMinimizer = &newCol->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+        spqr_member stopMember = SPQR_INVALID_MEMBER;
+        if(singleEdge){
+            stopMember = edgeMember;
+        }else if(useAncestors){
+            stopMember = newCol->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,edgeMember)].componentLCA;
+        }
+        reduced_member_id reducedMember = createReducedMembersToRoot(dec, newCol, edgeMember, stopMember);
+        reduced_member_id *depthMinimizer = &newCol->scratch->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
         if (reducedMemberIsInvalid(*depthMinimizer)) {
             *depthMinimizer = reducedMember;
         }
     }
 
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newCol->numDecompositionRowEdges; ++i) {
+            spqr_member edgeMember = findEdgeMember(dec, newCol->decompositionRowEdges[i]);
+            newCol->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,edgeMember)].componentLCA = SPQR_INVALID_MEMBER;
+        }
+    }else if(!singleEdge){
+        dec->memberAncestors.walkSteps += (size_t) newCol->numReducedMembers;
+    }
+
     //Set the reduced roots according to the root depth minimizers
-    for (int i = 0; i < newCol->numReducedComponents; ++i) {
+    for (MATREC_index i = 0; i < newCol->numReducedComponents; ++i) {
         MATRECColReducedComponent *component = &newCol->reducedComponents[i];
         spqr_member rootMember = newCol->reducedMembers[component->root].member;
-        reduced_member_id reducedMinimizer = newCol->memberInformation[rootMember].rootDepthMinimizer;
+        reduced_member_id reducedMinimizer = newCol->scratch->memberInformation[rootMember].rootDepthMinimizer;
         component->rootDepth = newCol->reducedMembers[reducedMinimizer].depth;
         component->root = reducedMinimizer;
 
@@ -1987,10 +2894,10 @@ static MATREC_ERROR constructReducedDecomposition(MATRECGraphicDecomposition *de
     }
 
     //update the children array
-    int numTotalChildren = 0;
-    for (int i = 0; i < newCol->numReducedMembers; ++i) {
+    MATREC_index numTotalChildren = 0;
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
         MATRECColReducedMember *reducedMember = &newCol->reducedMembers[i];
-        reduced_member_id minimizer = newCol->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
+        reduced_member_id minimizer = newCol->scratch->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
         if (reducedMember->depth >= newCol->reducedMembers[minimizer].depth) {
             reducedMember->firstChild = numTotalChildren;
             numTotalChildren += reducedMember->numChildren;
@@ -1999,7 +2906,7 @@ static MATREC_ERROR constructReducedDecomposition(MATRECGraphicDecomposition *de
     }
 
     if (newCol->memChildrenStorage < numTotalChildren) {
-        int newMemSize = max(newCol->memChildrenStorage * 2, numTotalChildren);
+        MATREC_index newMemSize = max(newCol->memChildrenStorage * 2, numTotalChildren);
         newCol->memChildrenStorage = newMemSize;
         MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->childrenStorage, (size_t) newCol->memChildrenStorage));
     }
@@ -2009,12 +2916,12 @@ static MATREC_ERROR constructReducedDecomposition(MATRECGraphicDecomposition *de
     for (reduced_member_id reducedMember = 0; reducedMember < newCol->numReducedMembers; ++reducedMember) {
         MATRECColReducedMember *reducedMemberData = &newCol->reducedMembers[reducedMember];
         if (reducedMemberData->depth <=
-            newCol->reducedMembers[newCol->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth) {
+            newCol->reducedMembers[newCol->scratch->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth) {
             continue;
         }
         spqr_member parentMember = findMemberParent(dec, reducedMemberData->member);
         reduced_member_id parentReducedMember = SPQRmemberIsValid(parentMember)
-                                                ? newCol->memberInformation[parentMember].reducedMember
+                                                ? newCol->scratch->memberInformation[parentMember].reducedMember
                                                 : INVALID_REDUCED_MEMBER;
         if (reducedMemberIsValid(parentReducedMember)) {
             //TODO: probably one of these two checks/branches is unnecessary, as there is a single failure case? (Not sure)
@@ -2026,13 +2933,13 @@ static MATREC_ERROR constructReducedDecomposition(MATRECGraphicDecomposition *de
     }
 
     //Clean up the root depth minimizers.
-    for (int i = 0; i < newCol->numReducedMembers; ++i) {
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
         MATRECColReducedMember *reducedMember = &newCol->reducedMembers[i];
         assert(reducedMember);
         spqr_member rootMember = reducedMember->rootMember;
         assert(rootMember >= 0);
         assert(rootMember < dec->memMembers);
-        newCol->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+        newCol->scratch->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
     }
 
     return MATREC_OKAY;
@@ -2041,12 +2948,12 @@ static MATREC_ERROR constructReducedDecomposition(MATRECGraphicDecomposition *de
 static void cleanUpMemberInformation(MATRECGraphicColumnAddition * newCol){
     //This loop is at the end as memberInformation is also used to assign the cut edges during propagation
     //Clean up the memberInformation array
-    for (int i = 0; i < newCol->numReducedMembers; ++i) {
-        newCol->memberInformation[newCol->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
+        newCol->scratch->memberInformation[newCol->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newCol->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newCol->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newCol->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newCol->scratch->memberInformation[i].reducedMember));
     }
 #endif
 }
@@ -2089,33 +2996,33 @@ static void createPathEdge(
 }
 
 static MATREC_ERROR createPathEdges(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol){
-    int maxNumPathEdges = newCol->numDecompositionRowEdges + getNumMembers(dec);
+    MATREC_index maxNumPathEdges = newCol->numDecompositionRowEdges + getNumMembers(dec);
     if(newCol->memPathEdges < maxNumPathEdges){
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->pathEdges,(size_t) maxNumPathEdges)); //TODO: fix reallocation strategy
         newCol->memPathEdges = maxNumPathEdges;
     }
-    int maxPathEdgeIndex = largestEdgeID(dec);
+    MATREC_index maxPathEdgeIndex = largestEdgeID(dec);
     if(newCol->memEdgesInPath < maxPathEdgeIndex){
-        int newSize = maxPathEdgeIndex;
+        MATREC_index newSize = maxPathEdgeIndex;
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->edgeInPath,(size_t) newSize));//TODO: fix reallocation strategy
-        for (int i = newCol->memEdgesInPath; i < newSize; ++i) {
+        for (MATREC_index i = newCol->memEdgesInPath; i < newSize; ++i) {
             newCol->edgeInPath[i] = false;
         }
         newCol->memEdgesInPath = newSize;
     }
-    int maxNumNodes = largestNodeID(dec);
+    MATREC_index maxNumNodes = largestNodeID(dec);
     if(newCol->memNodePathDegree < maxNumNodes){
-        int newSize = maxNumNodes;
+        MATREC_index newSize = maxNumNodes;
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->nodePathDegree,(size_t) newSize));
-        for (int i = newCol->memNodePathDegree; i < newSize; ++i) {
+        for (MATREC_index i = newCol->memNodePathDegree; i < newSize; ++i) {
             newCol->nodePathDegree[i] = 0;
         }
         newCol->memNodePathDegree = newSize;
     }
-    for (int i = 0; i < newCol->numDecompositionRowEdges; ++i) {
+    for (MATREC_index i = 0; i < newCol->numDecompositionRowEdges; ++i) {
         spqr_edge edge = newCol->decompositionRowEdges[i];
         spqr_member member = findEdgeMember(dec, edge);
-        reduced_member_id reducedMember = newCol->memberInformation[member].reducedMember;
+        reduced_member_id reducedMember = newCol->scratch->memberInformation[member].reducedMember;
         createPathEdge(dec,newCol,edge,reducedMember);
     }
 
@@ -2129,17 +3036,18 @@ static MATREC_ERROR createPathEdges(MATRECGraphicDecomposition *dec, MATRECGraph
  */
 static MATREC_ERROR
 newColUpdateColInformation(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, MATREC_col column, const MATREC_row *rows,
-                           size_t numRows) {
+                           MATREC_matrix_size numRows) {
     newCol->newColIndex = column;
 
     newCol->numDecompositionRowEdges = 0;
     newCol->numNewRowEdges = 0;
 
+    MATREC_CALL(lookupNonzeroEdges(dec->env, newCol->scratch, &dec->rowEdges, rows, numRows));
     for (size_t i = 0; i < numRows; ++i) {
-        spqr_edge rowEdge = getDecompositionRowEdge(dec, rows[i]);
+        spqr_edge rowEdge = newCol->scratch->nonzeroEdges[i];
         if (SPQRedgeIsValid(rowEdge)) { //If the edge is the current decomposition: save it in the array
             if (newCol->numDecompositionRowEdges == newCol->memDecompositionRowEdges) {
-                int newNumEdges = newCol->memDecompositionRowEdges == 0 ? 8 : 2 *
+                MATREC_index newNumEdges = newCol->memDecompositionRowEdges == 0 ? 8 : 2 *
                                                                               newCol->memDecompositionRowEdges; //TODO: make reallocation numbers more consistent with rest?
                 newCol->memDecompositionRowEdges = newNumEdges;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->decompositionRowEdges,
@@ -2150,7 +3058,7 @@ newColUpdateColInformation(MATRECGraphicDecomposition *dec, MATRECGraphicColumnA
         } else {
             //Not in the decomposition: add it to the set of edges which are newly added with this row.
             if (newCol->numNewRowEdges == newCol->memNewRowEdges) {
-                int newNumEdges = newCol->memNewRowEdges == 0 ? 8 : 2 *
+                MATREC_index newNumEdges = newCol->memNewRowEdges == 0 ? 8 : 2 *
                                                                     newCol->memNewRowEdges; //TODO: make reallocation numbers more consistent with rest?
                 newCol->memNewRowEdges = newNumEdges;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->newRowEdges,
@@ -2164,13 +3072,127 @@ newColUpdateColInformation(MATRECGraphicDecomposition *dec, MATRECGraphicColumnA
     return MATREC_OKAY;
 }
 
+///The rows of a new column, which are compared with the fundamental cycles of the columns in the column table
+typedef struct {
+    const MATRECGraphicDecomposition * dec;
+    MATRECGraphicAdditionScratch * scratch;
+    MATRECColumnTableEntry * entries;
+    MATREC_index numEntries;
+    bool sorted;
+} DuplicateQuery;
+
+static int compareColumnTableEntries(const void * a, const void * b){
+    MATREC_row first = ((const MATRECColumnTableEntry *) a)->row;
+    MATREC_row second = ((const MATRECColumnTableEntry *) b)->row;
+    return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+///Checks if the fundamental cycle of the column has exactly the rows of the query
+static MATREC_ERROR columnMatchesEntries(void * data, MATREC_col column, bool negated, bool * pMatches){
+    DuplicateQuery * query = (DuplicateQuery *) data;
+    const MATRECGraphicDecomposition * dec = query->dec;
+    MATRECGraphicAdditionScratch * scratch = query->scratch;
+    MATREC * env = dec->env;
+    assert(!negated);
+    (void) negated;
+    if(largestEdgeID(dec) + 1 > scratch->memCycleCallStack){
+        MATREC_index newSize = max(2 * scratch->memCycleCallStack, largestEdgeID(dec) + 1);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->cycleCallStack, (size_t) newSize));
+        scratch->memCycleCallStack = newSize;
+    }
+    if(largestNodeID(dec) + 1 > scratch->memCyclePathCallStack){
+        MATREC_index newSize = max(2 * scratch->memCyclePathCallStack, largestNodeID(dec) + 1);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->cyclePathCallStack, (size_t) newSize));
+        scratch->memCyclePathCallStack = newSize;
+    }
+    if(query->numEntries > scratch->memCycleRows){
+        MATREC_index newSize = max(2 * scratch->memCycleRows, query->numEntries);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->cycleRows, (size_t) newSize));
+        scratch->memCycleRows = newSize;
+    }
+    if(!query->sorted){
+        qsort(query->entries, (size_t) query->numEntries, sizeof(MATRECColumnTableEntry), compareColumnTableEntries);
+        query->sorted = true;
+    }
+
+    *pMatches = false;
+    MATREC_index numRows = findFundamentalCycleRows(dec, column, scratch->cycleRows, query->numEntries,
+                                                    scratch->cycleCallStack, scratch->cyclePathCallStack);
+    if(numRows != query->numEntries){
+        return MATREC_OKAY;
+    }
+    //The rows of the cycle are distinct, so it suffices that each of them is one of the entries
+    for (MATREC_index i = 0; i < numRows; ++i) {
+        MATREC_index low = 0;
+        MATREC_index high = query->numEntries;
+        while(low < high){
+            MATREC_index middle = low + (high - low) / 2;
+            if(query->entries[middle].row < scratch->cycleRows[i]){
+                low = middle + 1;
+            }else{
+                high = middle;
+            }
+        }
+        if(low == query->numEntries || query->entries[low].row != scratch->cycleRows[i]){
+            return MATREC_OKAY;
+        }
+    }
+    *pMatches = true;
+    return MATREC_OKAY;
+}
+
+/**
+ * Stores the rows of the new column. If all its rows are in the decomposition and they are exactly the rows of an
+ * existing column, the new column is parallel to that column. In that case, the path is replaced by the edge of the
+ * existing column.
+ */
+static MATREC_ERROR
+newColFindDuplicate(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, const MATREC_row *rows,
+                    MATREC_matrix_size numRows) {
+    newCol->isDuplicate = false;
+    newCol->numColumnEntries = 0;
+    newCol->columnHash = 0;
+    //Columns with a single nonzero are already placed in parallel without a lookup, so we do not store them
+    if (numRows < 2) {
+        return MATREC_OKAY;
+    }
+    if ((MATREC_index) numRows > newCol->memColumnEntries) {
+        MATREC_index newSize = max(2 * newCol->memColumnEntries, (MATREC_index) numRows);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->columnEntries, (size_t) newSize));
+        newCol->memColumnEntries = newSize;
+    }
+    //Reserve the slot of the column now, so that adding it can not fail after the decomposition has been changed
+    MATREC_CALL(MATRECcolumnTableReserve(dec->env, &dec->columns));
+    for (size_t i = 0; i < numRows; ++i) {
+        newCol->columnEntries[i].row = rows[i];
+        newCol->columnEntries[i].negative = false;
+        newCol->columnHash += MATRECcolumnTableEntryHash(rows[i], false);
+    }
+    newCol->numColumnEntries = (MATREC_index) numRows;
+    if (newCol->numNewRowEdges != 0) {
+        return MATREC_OKAY;
+    }
+
+    DuplicateQuery query = {dec, newCol->scratch, newCol->columnEntries, newCol->numColumnEntries, false};
+    MATREC_col duplicate;
+    MATREC_CALL(MATRECcolumnTableFind(&dec->columns, newCol->columnHash, newCol->numColumnEntries, false,
+                                      columnMatchesEntries, &query, &duplicate));
+    if (MATRECcolIsValid(duplicate)) {
+        assert(newCol->numDecompositionRowEdges >= 2);
+        newCol->decompositionRowEdges[0] = getDecompositionColumnEdge(dec, duplicate);
+        newCol->numDecompositionRowEdges = 1;
+        newCol->isDuplicate = true;
+    }
+    return MATREC_OKAY;
+}
+
 static void countChildrenTypes(MATRECGraphicDecomposition* dec, MATRECGraphicColumnAddition * newCol, reduced_member_id reducedMember){
     newCol->reducedMembers[reducedMember].numOneEnd = 0;
     newCol->reducedMembers[reducedMember].numTwoEnds = 0;
     newCol->reducedMembers[reducedMember].childMarkerEdges[0] = SPQR_INVALID_EDGE;
     newCol->reducedMembers[reducedMember].childMarkerEdges[1] = SPQR_INVALID_EDGE;
 
-    int nextChildMarker = 0;
+    MATREC_index nextChildMarker = 0;
     for (children_idx idx = newCol->reducedMembers[reducedMember].firstChild;
          idx < newCol->reducedMembers[reducedMember].firstChild
                + newCol->reducedMembers[reducedMember].numChildren;
@@ -2194,9 +3216,9 @@ static void countChildrenTypes(MATRECGraphicDecomposition* dec, MATRECGraphicCol
 }
 
 static void determineTypeParallel(
-        MATRECGraphicColumnAddition *newCol, reduced_member_id reducedMemberId, int depth){
-    const int numOneEnd = newCol->reducedMembers[reducedMemberId].numOneEnd;
-    const int numTwoEnds = newCol->reducedMembers[reducedMemberId].numTwoEnds;
+        MATRECGraphicColumnAddition *newCol, reduced_member_id reducedMemberId, MATREC_index depth){
+    const MATREC_index numOneEnd = newCol->reducedMembers[reducedMemberId].numOneEnd;
+    const MATREC_index numTwoEnds = newCol->reducedMembers[reducedMemberId].numTwoEnds;
     assert(numOneEnd >= 0);
     assert(numTwoEnds >= 0);
     assert(numOneEnd + 2*numTwoEnds <= 2);
@@ -2209,7 +3231,7 @@ static void determineTypeParallel(
         }
         return;
     }
-    int numEnds = numOneEnd + 2*numTwoEnds;
+    MATREC_index numEnds = numOneEnd + 2*numTwoEnds;
 
     if(numEnds == 0 && pathEdgeIsValid(reducedMember->firstPathEdge)){
         reducedMember->type = TYPE_CYCLE_CHILD;
@@ -2229,9 +3251,9 @@ static void determineTypeParallel(
     }
 }
 static void determineTypeSeries(MATRECGraphicDecomposition* dec, MATRECGraphicColumnAddition* newCol, reduced_member_id reducedMemberId,
-                         int depth){
-    const int numOneEnd = newCol->reducedMembers[reducedMemberId].numOneEnd;
-    const int numTwoEnds = newCol->reducedMembers[reducedMemberId].numTwoEnds;
+                         MATREC_index depth){
+    const MATREC_index numOneEnd = newCol->reducedMembers[reducedMemberId].numOneEnd;
+    const MATREC_index numTwoEnds = newCol->reducedMembers[reducedMemberId].numTwoEnds;
     assert(dec);
     assert(newCol);
     assert(numOneEnd >= 0);
@@ -2241,12 +3263,12 @@ static void determineTypeSeries(MATRECGraphicDecomposition* dec, MATRECGraphicCo
 
     MATRECColReducedMember *reducedMember =&newCol->reducedMembers[reducedMemberId];
     spqr_member member = findMember(dec, reducedMember->member); //We could also pass this as function argument
-    int countedPathEdges = 0;
+    MATREC_index countedPathEdges = 0;
     for(path_edge_id pathEdge = reducedMember->firstPathEdge; pathEdgeIsValid(pathEdge);
         pathEdge = newCol->pathEdges[pathEdge].nextMember){
         ++countedPathEdges;
     } //TODO: replace loop by count
-    int numMemberEdges = getNumMemberEdges(dec,member);
+    MATREC_index numMemberEdges = getNumMemberEdges(dec,member);
     if(depth == 0){
         if(numTwoEnds != 0){
             if(countedPathEdges == numMemberEdges -1){
@@ -2276,10 +3298,10 @@ static void determineTypeSeries(MATRECGraphicDecomposition* dec, MATRECGraphicCo
     }
 }
 
-static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicColumnAddition* newCol, reduced_member_id reducedMemberId, int depth){
+static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicColumnAddition* newCol, reduced_member_id reducedMemberId, MATREC_index depth){
     //Rough idea; first, we find the
-    const int numOneEnd = newCol->reducedMembers[reducedMemberId].numOneEnd;
-    const int numTwoEnds = newCol->reducedMembers[reducedMemberId].numTwoEnds;
+    const MATREC_index numOneEnd = newCol->reducedMembers[reducedMemberId].numOneEnd;
+    const MATREC_index numTwoEnds = newCol->reducedMembers[reducedMemberId].numTwoEnds;
     assert(dec);
     assert(newCol);
     assert(numOneEnd >= 0);
@@ -2304,15 +3326,15 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
     //First, find the end nodes of the path.
     //If there are too many (>4) or there is some node with degree > 2, we terminate
     spqr_node * pathEndNodes = newCol->reducedMembers[reducedMemberId].rigidEndNodes;
-    for (int i = 0; i < 4; ++i) {
+    for (MATREC_index i = 0; i < 4; ++i) {
         pathEndNodes[i] = SPQR_INVALID_NODE;
     }
-    int numPathEndNodes = 0;
+    MATREC_index numPathEndNodes = 0;
     for (path_edge_id pathEdge = newCol->reducedMembers[reducedMemberId].firstPathEdge; pathEdgeIsValid(pathEdge);
          pathEdge = newCol->pathEdges[pathEdge].nextMember) {
         spqr_edge edge = newCol->pathEdges[pathEdge].edge;
         spqr_node nodes[2] = {findEdgeHead(dec, edge), findEdgeTail(dec, edge)};
-        for (int i = 0; i < 2; ++i) {
+        for (MATREC_index i = 0; i < 2; ++i) {
             spqr_node node = nodes[i];
             assert(newCol->nodePathDegree[node] > 0);
             if(newCol->nodePathDegree[node] > 2){
@@ -2348,7 +3370,7 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
              pathEdge = newCol->pathEdges[pathEdge].nextMember){
             spqr_edge edge = newCol->pathEdges[pathEdge].edge;
             spqr_node nodes[2] = {findEdgeHead(dec, edge), findEdgeTail(dec, edge)};
-            for (int i = 0; i < 2; ++i) {
+            for (MATREC_index i = 0; i < 2; ++i) {
                 spqr_node node = nodes[i];
                 nodeEdges[2*node] = SPQR_INVALID_EDGE;
                 nodeEdges[2*node + 1] = SPQR_INVALID_EDGE;
@@ -2359,7 +3381,7 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
              pathEdge = newCol->pathEdges[pathEdge].nextMember){
             spqr_edge edge = newCol->pathEdges[pathEdge].edge;
             spqr_node nodes[2] = {findEdgeHead(dec, edge), findEdgeTail(dec, edge)};
-            for (int i = 0; i < 2; ++i) {
+            for (MATREC_index i = 0; i < 2; ++i) {
                 spqr_node node = nodes[i];
                 spqr_node index = 2 * node;
                 if(nodeEdges[index] != SPQR_INVALID_EDGE){
@@ -2425,8 +3447,8 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
             if(numOneEnd == 1){
                 bool pathAdjacentToChildMarker = false;
                 bool childMarkerNodeAdjacent[2] = {false,false};
-                for (int i = 0; i < 2; ++i) {
-                    for (int j = 0; j < 2; ++j) {
+                for (MATREC_index i = 0; i < 2; ++i) {
+                    for (MATREC_index j = 0; j < 2; ++j) {
                         if(pathEndNodes[i] == childMarkerNodes[j]){
                             pathAdjacentToChildMarker = true;
                             childMarkerNodeAdjacent[j] = true;
@@ -2448,8 +3470,8 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
             }else if(numOneEnd == 2){
                 bool childMarkerNodesMatched[2] = {false,false};
                 bool endNodesMatched[2] ={false, false};
-                for (int i = 0; i < 2; ++i) {
-                    for (int j = 0; j < 4; ++j) {
+                for (MATREC_index i = 0; i < 2; ++i) {
+                    for (MATREC_index j = 0; j < 4; ++j) {
                         if(pathEndNodes[i] == childMarkerNodes[j]){
                             endNodesMatched[i] = true;
                             childMarkerNodesMatched[j/2] = true;
@@ -2490,7 +3512,7 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
             return;
         }
     }
-    int parentMarkerDegrees[2] = {
+    MATREC_index parentMarkerDegrees[2] = {
             newCol->nodePathDegree[parentMarkerNodes[0]],
             newCol->nodePathDegree[parentMarkerNodes[1]]
     };
@@ -2518,10 +3540,10 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
         }else{
             assert(numOneEnd == 2);
 
-            int childMarkerParentNode[2] = {-1,-1};
+            MATREC_index childMarkerParentNode[2] = {-1,-1};
             bool isParallel = false;
-            for (int i = 0; i < 4; ++i) {
-                for (int j = 0; j < 2; ++j) {
+            for (MATREC_index i = 0; i < 4; ++i) {
+                for (MATREC_index j = 0; j < 2; ++j) {
                     if(childMarkerNodes[i] == parentMarkerNodes[j]){
                         if(childMarkerParentNode[i/2] >= 0){
                             isParallel = true;
@@ -2549,7 +3571,7 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
                 parentMarkerNodes[0] = parentMarkerNodes[1];
                 parentMarkerNodes[1] = tempMarker;
 
-                int tempDegree = parentMarkerDegrees[0];
+                MATREC_index tempDegree = parentMarkerDegrees[0];
                 parentMarkerDegrees[0] = parentMarkerDegrees[1];
                 parentMarkerDegrees[1] = tempDegree;
             }
@@ -2601,7 +3623,7 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
             bool childMatched[2] = {false,false};
             bool pathEndMatched = false;
             bool otherParentMatched = false;
-            for (int i = 0; i < 4; ++i) {
+            for (MATREC_index i = 0; i < 4; ++i) {
                 if(childMarkerNodes[i] == pathEndNodes[1]){
                     childMatched[i/2] = true;
                     pathEndMatched = true;
@@ -2681,8 +3703,8 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
         else if(numOneEnd == 2){
             bool pathConnected[2] = {false,false};
             bool childConnected[2] = {false,false};
-            for (int i = 0; i < 2; ++i) {
-                for (int j = 0; j < 4; ++j) {
+            for (MATREC_index i = 0; i < 2; ++i) {
+                for (MATREC_index j = 0; j < 4; ++j) {
                     if(pathEndNodes[1+2*i] == childMarkerNodes[j]){
                         pathConnected[i] = true;
                         childConnected[j/2] = true;
@@ -2715,7 +3737,7 @@ static void determineTypeRigid(MATRECGraphicDecomposition* dec, MATRECGraphicCol
 }
 static void determineTypes(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, MATRECColReducedComponent * component,
                     reduced_member_id reducedMember,
-                    int depth ){
+                    MATREC_index depth ){
     assert(dec);
     assert(newCol);
 
@@ -2754,7 +3776,7 @@ static void determineTypes(MATRECGraphicDecomposition *dec, MATRECGraphicColumnA
     //Add a marked edge to the path edge of the parent of this
     if(newCol->remainsGraphic && !isRoot && newCol->reducedMembers[reducedMember].type == TYPE_CYCLE_CHILD){
         spqr_member parentMember = findMemberParent(dec, newCol->reducedMembers[reducedMember].member);
-        reduced_member_id reducedParent = newCol->memberInformation[parentMember].reducedMember;
+        reduced_member_id reducedParent = newCol->scratch->memberInformation[parentMember].reducedMember;
         spqr_edge marker = markerOfParent(dec, member);
 
         createPathEdge(dec,newCol,marker,reducedParent);
@@ -2814,8 +3836,8 @@ static void propagateRootCycle(MATRECGraphicDecomposition *dec, MATRECGraphicCol
         }else if (type == SPQR_MEMBERTYPE_RIGID && reducedMemberIsValid(uniqueNonPropagatedChild)){
             spqr_edge rigidMarker = markerOfParent(dec, findMember(dec,newCol->reducedMembers[uniqueNonPropagatedChild].member));
             assert(SPQRmemberIsValid(findEdgeMemberNoCompression(dec,rigidMarker)));
-            int numEndNodes = 0;
-            for (int i = 0; i < 4; ++i) {
+            MATREC_index numEndNodes = 0;
+            for (MATREC_index i = 0; i < 4; ++i) {
                 if(SPQRnodeIsInvalid(newCol->reducedMembers[root].rigidEndNodes[i])){
                    break;
                 }
@@ -2843,25 +3865,68 @@ static void determineComponentTypes(MATRECGraphicDecomposition * dec, MATRECGrap
     }
 }
 
-MATREC_ERROR
-MATRECGraphicColumnAdditionCheck(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, MATREC_col column, const MATREC_row *rows, size_t numRows) {
+///Records a row or column check and its outcome, if the decomposition is in the trace
+static void traceCheck(MATRECGraphicDecomposition *dec, MATRECTraceCall call, MATRECTraceId *addition,
+                       MATREC_matrix_size index, const MATREC_matrix_size * nonzeros, MATREC_matrix_size numNonzeros,
+                       bool remainsGraphic){
+    if(!MATRECtraceContains(dec->env, &dec->traceId)){
+        return;
+    }
+    MATRECTraceWriter writer;
+    MATRECtraceBegin(dec->env, &writer, call);
+    MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+    MATRECtraceWriteAddition(&writer, addition);
+    MATRECtraceWriteNumber(&writer, index);
+    MATRECtraceWriteNumber(&writer, numNonzeros);
+    for (MATREC_matrix_size i = 0; i < numNonzeros; ++i) {
+        MATRECtraceWriteNumber(&writer, nonzeros[i]);
+    }
+    MATRECtraceWriteByte(&writer, remainsGraphic);
+    MATRECtraceEnd(&writer);
+}
+
+///Records a row or column addition, if the decomposition and the addition are in the trace
+static void traceAdd(MATRECGraphicDecomposition *dec, MATRECTraceCall call, MATRECTraceId *addition){
+    if(!MATRECtraceContains(dec->env, &dec->traceId) || !MATRECtraceContains(dec->env, addition)){
+        return;
+    }
+    MATRECTraceWriter writer;
+    MATRECtraceBegin(dec->env, &writer, call);
+    MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+    MATRECtraceWriteAddition(&writer, addition);
+    MATRECtraceEnd(&writer);
+}
+
+static MATREC_ERROR
+columnAdditionCheck(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, MATREC_col column, const MATREC_row *rows, MATREC_matrix_size numRows) {
     assert(dec);
     assert(newCol);
     assert(numRows == 0 || rows);
 
     newCol->remainsGraphic = true;
     cleanupPreviousIteration(dec, newCol);
+    if(newCol->autoShrinkCalls > 0){
+        autoShrinkColumnAddition(dec, newCol);
+    }
     //assert that previous iteration was cleaned up
 
     //Store call data
     MATREC_CALL(newColUpdateColInformation(dec, newCol, column, rows, numRows));
+    MATREC_CALL(newColFindDuplicate(dec, newCol, rows, numRows));
+
+    //A column without nonzeros in the decomposition does not touch it, so there is nothing to check
+    if(newCol->numDecompositionRowEdges == 0){
+        newCol->numReducedMembers = 0;
+        newCol->numReducedComponents = 0;
+        return MATREC_OKAY;
+    }
 
     //compute reduced decomposition
     MATREC_CALL(constructReducedDecomposition(dec, newCol));
     //initialize path edges in reduced decomposition
     MATREC_CALL(createPathEdges(dec,newCol));
     //determine types
-    for (int i = 0; i < newCol->numReducedComponents; ++i) {
+    for (MATREC_index i = 0; i < newCol->numReducedComponents; ++i) {
         determineComponentTypes(dec,newCol,&newCol->reducedComponents[i]);
     }
     //clean up memberInformation
@@ -2870,13 +3935,20 @@ MATRECGraphicColumnAdditionCheck(MATRECGraphicDecomposition *dec, MATRECGraphicC
     return MATREC_OKAY;
 }
 
+MATREC_ERROR
+MATRECGraphicColumnAdditionCheck(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, MATREC_col column, const MATREC_row *rows, MATREC_matrix_size numRows) {
+    MATREC_CALL(columnAdditionCheck(dec, newCol, column, rows, numRows));
+    traceCheck(dec, MATREC_TRACE_COLUMN_CHECK, &newCol->traceId, column, rows, numRows, newCol->remainsGraphic);
+    return MATREC_OKAY;
+}
+
 ///Contains the data which tells us where to store the new column after the graph has been modified
 ///In case member is a parallel or series node, the respective new column and rows are placed in parallel (or series) with it
 ///Otherwise, the rigid member has a free spot between firstNode and secondNode
 typedef struct {
     spqr_member member;
     spqr_node terminalNode[2];
-    int numTerminals;
+    MATREC_index numTerminals;
 } NewColInformation;
 
 static NewColInformation emptyNewColInformation(void){
@@ -2983,7 +4055,7 @@ static MATREC_ERROR splitParallel(MATRECGraphicDecomposition *dec, spqr_member p
     return MATREC_OKAY;
 }
 static MATREC_ERROR transformParallel(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, reduced_member_id reducedMemberId,
-                                    NewColInformation * newColInfo, int depth){
+                                    NewColInformation * newColInfo, MATREC_index depth){
     assert(dec);
     assert(newCol);
     MATRECColReducedMember * reducedMember = &newCol->reducedMembers[reducedMemberId];
@@ -3056,6 +4128,8 @@ static MATREC_ERROR splitSeries(MATRECGraphicDecomposition *dec, MATRECGraphicCo
     MATREC_CALL(createMember(dec, SPQR_MEMBERTYPE_SERIES, &pathMember));
 
     path_edge_id pathEdgeId = reducedMember->firstPathEdge;
+    //A single path edge is a column edge if the new column duplicates it
+    bool pathIsTree = createPathSeries || edgeIsTree(dec,newCol->pathEdges[pathEdgeId].edge);
     bool parentMoved = false;
     while(pathEdgeIsValid(pathEdgeId)){
         spqr_edge pathEdge = newCol->pathEdges[pathEdgeId].edge;
@@ -3067,9 +4141,9 @@ static MATREC_ERROR splitSeries(MATRECGraphicDecomposition *dec, MATRECGraphicCo
     }
     if(convertOriginal == createPathSeries){
         if(parentMoved){
-            MATREC_CALL(createMarkerPair(dec,pathMember,member,false));
+            MATREC_CALL(createMarkerPair(dec,pathMember,member,!pathIsTree));
         }else{
-            MATREC_CALL(createMarkerPair(dec,member,pathMember,true));
+            MATREC_CALL(createMarkerPair(dec,member,pathMember,pathIsTree));
         }
         *loopMember = convertOriginal ? member : pathMember;
         changeLoopToParallel(dec,*loopMember);
@@ -3100,8 +4174,8 @@ static MATREC_ERROR splitSeriesMerging(MATRECGraphicDecomposition *dec, MATRECGr
     assert(SPQRmemberIsValid(member));
     assert(memberIsRepresentative(dec,member));
 
-    int numExceptionEdges = (exceptionEdge1 == SPQR_INVALID_EDGE ? 0 : 1) + (exceptionEdge2 == SPQR_INVALID_EDGE ? 0 : 1);
-    int numNonPathEdges = getNumMemberEdges(dec,member) - reducedMember->numPathEdges - numExceptionEdges;
+    MATREC_index numExceptionEdges = (exceptionEdge1 == SPQR_INVALID_EDGE ? 0 : 1) + (exceptionEdge2 == SPQR_INVALID_EDGE ? 0 : 1);
+    MATREC_index numNonPathEdges = getNumMemberEdges(dec,member) - reducedMember->numPathEdges - numExceptionEdges;
     bool createPathSeries = reducedMember->numPathEdges > 1;
     //If this holds, there are 2 or more non-parent marker non-path edges
     bool createNonPathSeries = numNonPathEdges > 1;
@@ -3188,7 +4262,7 @@ static MATREC_ERROR splitSeriesMerging(MATRECGraphicDecomposition *dec, MATRECGr
 }
 
 static MATREC_ERROR transformSeries(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol, reduced_member_id reducedMemberId,
-                                  NewColInformation * newColInfo, int depth){
+                                  NewColInformation * newColInfo, MATREC_index depth){
     assert(dec);
     assert(newCol);
     assert(newColInfo);
@@ -3409,7 +4483,7 @@ static MATREC_ERROR transformSeries(MATRECGraphicDecomposition *dec, MATRECGraph
     return MATREC_OKAY;
 }
 static MATREC_ERROR transformRigid(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition * newCol, reduced_member_id id,
-                                 NewColInformation * newColInfo, int depth){
+                                 NewColInformation * newColInfo, MATREC_index depth){
     assert(dec);
     assert(newCol);
     assert(reducedMemberIsValid(id));
@@ -3430,9 +4504,9 @@ static MATREC_ERROR transformRigid(MATRECGraphicDecomposition *dec, MATRECGraphi
             childMarkerEdges[1] == SPQR_INVALID_EDGE ? SPQR_INVALID_NODE : findEdgeTail(dec, childMarkerEdges[1]),
     };
     spqr_node * pathEndNodes = newCol->reducedMembers[id].rigidEndNodes;
-    int numPathEndNodes = pathEndNodes[0] == SPQR_INVALID_NODE ? 0 : (pathEndNodes[2] == SPQR_INVALID_NODE ? 2 : 4);
-    const int numOneEnd = newCol->reducedMembers[id].numOneEnd;
-    const int numTwoEnds = newCol->reducedMembers[id].numTwoEnds;
+    MATREC_index numPathEndNodes = pathEndNodes[0] == SPQR_INVALID_NODE ? 0 : (pathEndNodes[2] == SPQR_INVALID_NODE ? 2 : 4);
+    const MATREC_index numOneEnd = newCol->reducedMembers[id].numOneEnd;
+    const MATREC_index numTwoEnds = newCol->reducedMembers[id].numTwoEnds;
     if(depth == 0){
         //modify the endnodes array if the parent marker is a path edge
         if(parentMarker != SPQR_INVALID_EDGE && newCol->edgeInPath[parentMarker]){
@@ -3532,10 +4606,10 @@ static MATREC_ERROR transformRigid(MATRECGraphicDecomposition *dec, MATRECGraphi
                     findEdgeChildMember(dec,childMarkerEdges[1])
             };
             //count to how many path end nodes the child marker is adjacent
-            int numIncidentPathNodes[2] = {0,0};
-            for (int c = 0; c < 2; ++c) {
-                for (int i = 0; i < numPathEndNodes; ++i) {
-                    for (int j = 0; j < 2; ++j) {
+            MATREC_index numIncidentPathNodes[2] = {0,0};
+            for (MATREC_index c = 0; c < 2; ++c) {
+                for (MATREC_index i = 0; i < numPathEndNodes; ++i) {
+                    for (MATREC_index j = 0; j < 2; ++j) {
                         if(pathEndNodes[i] == childMarkerNodes[2*c+j]){
                             numIncidentPathNodes[c] += 1;
                         }
@@ -3640,14 +4714,14 @@ static MATREC_ERROR transformRigid(MATRECGraphicDecomposition *dec, MATRECGraphi
     return MATREC_OKAY;
 }
 static MATREC_ERROR transformLoop(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition * newCol, reduced_member_id id,
-                                 NewColInformation * newColInfo, int depth){
+                                 NewColInformation * newColInfo, MATREC_index depth){
     assert(depth == 0);
     assert(dec);
     assert(newCol);
     assert(newColInfo);
 
     spqr_member member =newCol->reducedMembers[id].member;
-    int numEdges = getNumMemberEdges(dec,member);
+    MATREC_index numEdges = getNumMemberEdges(dec,member);
     assert(numEdges == 1 || numEdges == 2);
     if(getNumMemberEdges(dec,member) == 2){
         changeLoopToParallel(dec,member);
@@ -3657,7 +4731,7 @@ static MATREC_ERROR transformLoop(MATRECGraphicDecomposition *dec, MATRECGraphic
     return MATREC_OKAY;
 }
 static MATREC_ERROR transformReducedMember(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition * newCol, MATRECColReducedComponent * component,
-                                         reduced_member_id reducedMemberId, NewColInformation * newColInfo, int depth){
+                                         reduced_member_id reducedMemberId, NewColInformation * newColInfo, MATREC_index depth){
     MATRECColReducedMember * reducedMember = &newCol->reducedMembers[reducedMemberId];
     if(reducedMember->type == TYPE_CYCLE_CHILD && depth > 0){
         return MATREC_OKAY; //path has been propagated away; no need to do anything
@@ -3750,7 +4824,7 @@ static MATREC_ERROR moveReducedRoot(MATRECGraphicDecomposition *dec, MATRECGraph
                         findEdgeHead(dec, reducedMember->childMarkerEdges[0])
                 };
 
-                int numEndNodes = reducedMember->rigidEndNodes[0] == SPQR_INVALID_NODE ?
+                MATREC_index numEndNodes = reducedMember->rigidEndNodes[0] == SPQR_INVALID_NODE ?
                                   0 : (reducedMember->rigidEndNodes[2] == SPQR_INVALID_NODE ? 2 : 4);
                 if (numEndNodes == 0)
                 {
@@ -3809,17 +4883,27 @@ static MATREC_ERROR transformComponent(MATRECGraphicDecomposition *dec, MATRECGr
     return MATREC_OKAY;
 }
 
-MATREC_ERROR MATRECGraphicColumnAdditionAdd(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol){
+static MATREC_ERROR columnAdditionAdd(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol){
     assert(dec);
     assert(newCol);
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
+        invalidateMemberAdjacency(dec,newCol->reducedMembers[i].member);
+    }
+    //The addition only changes the members below the parent of the reduced root, unless it joins trees
+    spqr_member unchangedParent = SPQR_INVALID_MEMBER;
+    spqr_member changedMember = SPQR_INVALID_MEMBER;
+    if(newCol->numReducedComponents == 1){
+        unchangedParent = findMemberParent(dec,newCol->reducedMembers[newCol->reducedComponents[0].root].member);
+    }
 
     if(newCol->numReducedComponents == 0){
-        spqr_member member;
-        MATREC_CALL(createStandaloneSeries(dec,newCol->newRowEdges,newCol->numNewRowEdges,newCol->newColIndex,&member));
+        MATREC_CALL(createStandaloneSeries(dec,newCol->newRowEdges,newCol->numNewRowEdges,newCol->newColIndex,
+                                           &changedMember));
     }else if(newCol->numReducedComponents == 1){
         NewColInformation information = emptyNewColInformation();
         MATREC_CALL(transformComponent(dec,newCol,&newCol->reducedComponents[0],&information));
         assert(memberIsRepresentative(dec,information.member));
+        changedMember = information.member;
         if(newCol->numNewRowEdges == 0){
             spqr_edge colEdge = SPQR_INVALID_EDGE;
             MATREC_CALL(createColumnEdge(dec,information.member,&colEdge,newCol->newColIndex));
@@ -3846,17 +4930,18 @@ MATREC_ERROR MATRECGraphicColumnAdditionAdd(MATRECGraphicDecomposition *dec, MAT
         }
     }else{
 #ifndef NDEBUG
-        int numDecComponentsBefore = numConnectedComponents(dec);
+        MATREC_index numDecComponentsBefore = numConnectedComponents(dec);
 #endif
         spqr_member newSeries;
         MATREC_CALL(createConnectedSeries(dec,newCol->newRowEdges,newCol->numNewRowEdges,newCol->newColIndex,&newSeries));
-        for (int i = 0; i < newCol->numReducedComponents; ++i) {
+        changedMember = newSeries;
+        for (MATREC_index i = 0; i < newCol->numReducedComponents; ++i) {
             NewColInformation information = emptyNewColInformation();
             MATREC_CALL(transformComponent(dec,newCol,&newCol->reducedComponents[i],&information));
             if(getMemberType(dec,information.member) == SPQR_MEMBERTYPE_LOOP){
                 assert(getNumMemberEdges(dec,information.member) == 1);
                 moveEdgeToNewMember(dec, getFirstMemberEdge(dec,information.member),information.member,newSeries);
-                dec->members[information.member].type = SPQR_MEMBERTYPE_UNASSIGNED;
+                MEMBER(dec, information.member).type = SPQR_MEMBERTYPE_UNASSIGNED;
             }else {
                 reorderComponent(dec,information.member); //reorder the subtree so that the new series member is a parent
                 spqr_edge markerEdge = SPQR_INVALID_EDGE;
@@ -3872,6 +4957,17 @@ MATREC_ERROR MATRECGraphicColumnAdditionAdd(MATRECGraphicDecomposition *dec, MAT
         decreaseNumConnectedComponents(dec,newCol->numReducedComponents-1);
         assert(numConnectedComponents(dec) == (numDecComponentsBefore - newCol->numReducedComponents + 1));
     }
+    if(!newCol->isDuplicate && newCol->numColumnEntries >= 2){
+        MATRECcolumnTableInsert(&dec->columns,newCol->columnHash,newCol->newColIndex,newCol->numColumnEntries);
+    }
+    repairMemberAncestorIndex(dec,unchangedParent,changedMember);
+    autoFlatten(dec);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECGraphicColumnAdditionAdd(MATRECGraphicDecomposition *dec, MATRECGraphicColumnAddition *newCol){
+    MATREC_CALL(columnAdditionAdd(dec, newCol));
+    traceAdd(dec, MATREC_TRACE_COLUMN_ADD, &newCol->traceId);
     return MATREC_OKAY;
 }
 
@@ -3880,11 +4976,11 @@ bool MATRECGraphicColumnAdditionRemainsGraphic(MATRECGraphicColumnAddition *newC
 }
 
 
-static int min(int a, int b){
+static MATREC_index min(MATREC_index a, MATREC_index b){
     return a < b ? a : b;
 }
 
-typedef int cut_edge_id;
+typedef MATREC_index cut_edge_id;
 #define INVALID_CUT_EDGE (-1)
 
 static bool cutEdgeIsInvalid(const cut_edge_id edge){
@@ -3937,7 +5033,7 @@ static void NodePairIntersection(NodePair * toChange, const spqr_node first, con
         toChange->second= SPQR_INVALID_NODE;
     }
     if (SPQRnodeIsInvalid(toChange->first) && SPQRnodeIsValid(toChange->second)) {
-        swap_ints(&toChange->first,&toChange->second);
+        swap_indices(&toChange->first,&toChange->second);
     }
 }
 static void NodePairInsert(NodePair * pair, const spqr_node node){
@@ -3950,8 +5046,8 @@ static void NodePairInsert(NodePair * pair, const spqr_node node){
 }
 
 typedef struct{
-    int low;
-    int discoveryTime;
+    MATREC_index low;
+    MATREC_index discoveryTime;
 } ArticulationNodeInformation;
 
 //We allocate the callstacks of recursive algorithms (usually DFS, bounded by some linear number of calls)
@@ -3960,7 +5056,7 @@ typedef struct{
 //Stack overflows
 typedef struct {
     spqr_node node;
-    spqr_edge nodeEdge;
+    MATREC_index position; //Position in the adjacency snapshot
 } DFSCallData;
 
 typedef struct{
@@ -3971,10 +5067,11 @@ typedef struct{
 typedef struct{
     spqr_node node;
     spqr_edge edge;
+    MATREC_index position; //Position in the adjacency snapshot, used instead of edge when the member has one
 } ColorDFSCallData;
 
 typedef struct{
-    spqr_edge edge;
+    MATREC_index position; //Position in the adjacency snapshot
     spqr_node node;
     spqr_node parent;
     bool isAP;
@@ -3989,7 +5086,7 @@ typedef enum{
 typedef struct {
     spqr_member member;
     spqr_member rootMember;
-    int depth;
+    MATREC_index depth;
     RowReducedMemberType type;
     reduced_member_id parent;
 
@@ -3998,7 +5095,7 @@ typedef struct {
     children_idx numPropagatedChildren;
 
     cut_edge_id firstCutEdge;
-    int numCutEdges;
+    MATREC_index numCutEdges;
 
     NodePair splitting_nodes;
     bool allHaveCommonNode;
@@ -4008,7 +5105,7 @@ typedef struct {
 } MATRECRowReducedMember;
 
 typedef struct {
-    int rootDepth;
+    MATREC_index rootDepth;
     reduced_member_id root;
 } MATRECRowReducedComponent;
 
@@ -4016,78 +5113,80 @@ struct MATRECGraphicRowAdditionImpl{
     bool remainsGraphic;
 
     MATRECRowReducedMember* reducedMembers;
-    int memReducedMembers;
-    int numReducedMembers;
+    MATREC_index memReducedMembers;
+    MATREC_index numReducedMembers;
 
     MATRECRowReducedComponent* reducedComponents;
-    int memReducedComponents;
-    int numReducedComponents;
+    MATREC_index memReducedComponents;
+    MATREC_index numReducedComponents;
 
-    MemberInfo * memberInformation;
-    int memMemberInformation;
-    int numMemberInformation;
+    MATRECGraphicAdditionScratch *scratch;
+    bool ownsScratch; ///Whether the scratch memory is freed together with this object
 
     reduced_member_id * childrenStorage;
-    int memChildrenStorage;
-    int numChildrenStorage;
+    MATREC_index memChildrenStorage;
+    MATREC_index numChildrenStorage;
 
     CutEdgeListNode * cutEdges;
-    int memCutEdges;
-    int numCutEdges;
+    MATREC_index memCutEdges;
+    MATREC_index numCutEdges;
     cut_edge_id firstOverallCutEdge;
 
     MATREC_row newRowIndex;
 
     MATREC_col * newColumnEdges;
-    int memColumnEdges;
-    int numColumnEdges;
+    MATREC_index memColumnEdges;
+    MATREC_index numColumnEdges;
 
     reduced_member_id * leafMembers;
-    int numLeafMembers;
-    int memLeafMembers;
+    MATREC_index numLeafMembers;
+    MATREC_index memLeafMembers;
 
     spqr_edge * decompositionColumnEdges;
-    int memDecompositionColumnEdges;
-    int numDecompositionColumnEdges;
+    MATREC_index memDecompositionColumnEdges;
+    MATREC_index numDecompositionColumnEdges;
 
     bool * isEdgeCut;
-    int numIsEdgeCut;
-    int memIsEdgeCut;
+    MATREC_index numIsEdgeCut;
+    MATREC_index memIsEdgeCut;
 
     COLOR_STATUS * nodeColors;
-    int memNodeColors;
+    MATREC_index memNodeColors;
 
     spqr_node * articulationNodes;
-    int numArticulationNodes;
-    int memArticulationNodes;
+    MATREC_index numArticulationNodes;
+    MATREC_index memArticulationNodes;
 
     ArticulationNodeInformation * articulationNodeSearchInfo;
-    int memNodeSearchInfo;
+    MATREC_index memNodeSearchInfo;
 
-    int * crossingPathCount;
-    int memCrossingPathCount;
+    MATREC_index * crossingPathCount;
+    MATREC_index memCrossingPathCount;
 
     DFSCallData * intersectionDFSData;
-    int memIntersectionDFSData;
+    MATREC_index memIntersectionDFSData;
 
     ColorDFSCallData * colorDFSData;
-    int memColorDFSData;
+    MATREC_index memColorDFSData;
 
     ArticulationPointCallStack * artDFSData;
-    int memArtDFSData;
+    MATREC_index memArtDFSData;
 
-    CreateReducedMembersCallstack * createReducedMembersCallstack;
-    int memCreateReducedMembersCallstack;
-
-    int * intersectionPathDepth;
-    int memIntersectionPathDepth;
+    MATREC_index * intersectionPathDepth;
+    MATREC_index memIntersectionPathDepth;
 
     spqr_node * intersectionPathParent;
-    int memIntersectionPathParent;
+    MATREC_index memIntersectionPathParent;
 
     MergeTreeCallData * mergeTreeCallData;
-    int memMergeTreeCallData;
+    MATREC_index memMergeTreeCallData;
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+    //If not 0, the arrays are freed after this many consecutive checks on a much smaller decomposition
+    size_t autoShrinkCalls;
+    size_t numUnderusedCalls;
 
+    MATRECTraceId traceId;
 };
 
 typedef struct {
@@ -4108,18 +5207,19 @@ static NewRowInformation emptyNewRowInformation(void){
  * Saves the information of the current row and partitions it based on whether or not the given columns are
  * already part of the decomposition.
  */
-static MATREC_ERROR newRowUpdateRowInformation(const MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow, const MATREC_row row, const MATREC_col * columns, const size_t numColumns)
+static MATREC_ERROR newRowUpdateRowInformation(const MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow, const MATREC_row row, const MATREC_col * columns, const MATREC_matrix_size numColumns)
 {
     newRow->newRowIndex = row;
 
     newRow->numDecompositionColumnEdges = 0;
     newRow->numColumnEdges = 0;
 
+    MATREC_CALL(lookupNonzeroEdges(dec->env, newRow->scratch, &dec->columnEdges, columns, numColumns));
     for (size_t i = 0; i < numColumns; ++i) {
-        spqr_edge columnEdge = getDecompositionColumnEdge(dec, columns[i]);
+        spqr_edge columnEdge = newRow->scratch->nonzeroEdges[i];
         if(SPQRedgeIsValid(columnEdge)){ //If the edge is the current decomposition: save it in the array
             if(newRow->numDecompositionColumnEdges == newRow->memDecompositionColumnEdges){
-                int newNumEdges = newRow->memDecompositionColumnEdges == 0 ? 8 : 2*newRow->memDecompositionColumnEdges; //TODO: make reallocation numbers more consistent with rest?
+                MATREC_index newNumEdges = newRow->memDecompositionColumnEdges == 0 ? 8 : 2*newRow->memDecompositionColumnEdges; //TODO: make reallocation numbers more consistent with rest?
                 newRow->memDecompositionColumnEdges = newNumEdges;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->decompositionColumnEdges,
                                                 (size_t) newRow->memDecompositionColumnEdges));
@@ -4129,7 +5229,7 @@ static MATREC_ERROR newRowUpdateRowInformation(const MATRECGraphicDecomposition
         }else{
             //Not in the decomposition: add it to the set of edges which are newly added with this row.
             if(newRow->numColumnEdges == newRow->memColumnEdges){
-                int newNumEdges = newRow->memColumnEdges == 0 ? 8 : 2*newRow->memColumnEdges; //TODO: make reallocation numbers more consistent with rest?
+                MATREC_index newNumEdges = newRow->memColumnEdges == 0 ? 8 : 2*newRow->memColumnEdges; //TODO: make reallocation numbers more consistent with rest?
                 newRow->memColumnEdges = newNumEdges;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->newColumnEdges,
                                                 (size_t)newRow->memColumnEdges));
@@ -4143,22 +5243,24 @@ static MATREC_ERROR newRowUpdateRowInformation(const MATRECGraphicDecomposition
 }
 
 /**
- * Recursively creates reduced members from this member to the root of the decomposition tree.
+ * Recursively creates reduced members from this member to the root of the decomposition tree, or to stopMember if
+ * it is an ancestor of this member.
  * @param dec
  * @param newRow
  * @param member
  * @return
  */
-static reduced_member_id createRowReducedMembersToRoot(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition * newRow, const spqr_member firstMember){
+static reduced_member_id createRowReducedMembersToRoot(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition * newRow, const spqr_member firstMember,
+                                                    const spqr_member stopMember){
     assert(SPQRmemberIsValid(firstMember));
 
-    CreateReducedMembersCallstack * callstack = newRow->createReducedMembersCallstack;
+    CreateReducedMembersCallstack * callstack = newRow->scratch->createReducedMembersCallStack;
     callstack[0].member = firstMember;
-    int callDepth = 0;
+    MATREC_index callDepth = 0;
 
     while(callDepth >= 0){
         spqr_member member = callstack[callDepth].member;
-        reduced_member_id reducedMember = newRow->memberInformation[member].reducedMember;
+        reduced_member_id reducedMember = newRow->scratch->memberInformation[member].reducedMember;
 
         bool reducedValid = reducedMemberIsValid(reducedMember);
         if(!reducedValid) {
@@ -4179,14 +5281,15 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECGraphicDecompositio
             reducedMemberData->coloredNode = SPQR_INVALID_NODE;
             NodePairEmptyInitialize(&reducedMemberData->splitting_nodes);
 
-            newRow->memberInformation[member].reducedMember = reducedMember;
+            newRow->scratch->memberInformation[member].reducedMember = reducedMember;
             assert(memberIsRepresentative(dec, member));
-            spqr_member parentMember = findMemberParent(dec, member);
+            //The stop member is the root of the reduced component, so we do not need to walk further up the tree
+            spqr_member parentMember = member == stopMember ? SPQR_INVALID_MEMBER : findMemberParent(dec, member);
 
             if (SPQRmemberIsValid(parentMember)) {
                 //recursive call to parent member
                 ++callDepth;
-                assert(callDepth < newRow->memCreateReducedMembersCallstack);
+                assert(callDepth < newRow->scratch->memCreateReducedMembersCallStack);
                 callstack[callDepth].member = parentMember;
                 continue;
 
@@ -4206,7 +5309,7 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECGraphicDecompositio
             assert(reducedMember < newRow->numReducedMembers);
             //Reduced member was already created in earlier call
             //update the depth of the root if appropriate
-            reduced_member_id * depthMinimizer = &newRow->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+            reduced_member_id * depthMinimizer = &newRow->scratch->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
             if(reducedMemberIsInvalid(*depthMinimizer) ||
                newRow->reducedMembers[reducedMember].depth < newRow->reducedMembers[*depthMinimizer].depth){
                 *depthMinimizer = reducedMember;
@@ -4216,9 +5319,9 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECGraphicDecompositio
             --callDepth;
             if(callDepth < 0 ) break;
             spqr_member parentMember = callstack[callDepth + 1].member;
-            reduced_member_id parentReducedMember = newRow->memberInformation[parentMember].reducedMember;
+            reduced_member_id parentReducedMember = newRow->scratch->memberInformation[parentMember].reducedMember;
             spqr_member currentMember = callstack[callDepth].member;
-            reduced_member_id currentReducedMember = newRow->memberInformation[currentMember].reducedMember;
+            reduced_member_id currentReducedMember = newRow->scratch->memberInformation[currentMember].reducedMember;
 
             MATRECRowReducedMember *parentReducedMemberData = &newRow->reducedMembers[parentReducedMember];
             MATRECRowReducedMember *reducedMemberData = &newRow->reducedMembers[currentReducedMember];
@@ -4232,7 +5335,7 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECGraphicDecompositio
 
     }
 
-    reduced_member_id returnedMember = newRow->memberInformation[callstack[0].member].reducedMember;
+    reduced_member_id returnedMember = newRow->scratch->memberInformation[callstack[0].member].reducedMember;
     return returnedMember;
 }
 
@@ -4245,8 +5348,8 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECGraphicDecomposition*
     //TODO: chop up into more functions
     //TODO: stricter assertions/array bounds checking in this function
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newRow->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newRow->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newRow->scratch->memberInformation[i].reducedMember));
     }
 #endif
 
@@ -4258,51 +5361,75 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECGraphicDecomposition*
     assert(newRow->numReducedMembers == 0);
     assert(newRow->numReducedComponents == 0);
 
-    int newSize = largestMemberID(dec); //Is this sufficient?
+    MATREC_index newSize = largestMemberID(dec); //Is this sufficient?
     if(newSize > newRow->memReducedMembers){
         newRow->memReducedMembers = max(2*newRow->memReducedMembers,newSize);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->reducedMembers,(size_t) newRow->memReducedMembers));
     }
-    if(newSize > newRow->memMemberInformation){
-        int updatedSize = max(2*newRow->memMemberInformation,newSize);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->memberInformation,(size_t) updatedSize));
-        for (int i = newRow->memMemberInformation; i < updatedSize; ++i) {
-            newRow->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
-            newRow->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+    if(newSize > newRow->scratch->memMemberInformation){
+        MATREC_index updatedSize = max(2*newRow->scratch->memMemberInformation,newSize);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->scratch->memberInformation,(size_t) updatedSize));
+        for (MATREC_index i = newRow->scratch->memMemberInformation; i < updatedSize; ++i) {
+            newRow->scratch->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
+            newRow->scratch->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+            newRow->scratch->memberInformation[i].componentLCA = SPQR_INVALID_MEMBER;
         }
-        newRow->memMemberInformation = updatedSize;
+        newRow->scratch->memMemberInformation = updatedSize;
 
     }
 
-    int numComponents = numConnectedComponents(dec);
+    MATREC_index numComponents = numConnectedComponents(dec);
     if(numComponents > newRow->memReducedComponents){
         newRow->memReducedComponents = max(2*newRow->memReducedComponents,numComponents);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->reducedComponents,(size_t) newRow->memReducedComponents));
     }
 
-    int numMembers = getNumMembers(dec);
-    if(newRow->memCreateReducedMembersCallstack < numMembers){
-        newRow->memCreateReducedMembersCallstack = max(2*newRow->memCreateReducedMembersCallstack,numMembers);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->createReducedMembersCallstack,(size_t) newRow->memCreateReducedMembersCallstack));
+    MATREC_index numMembers = getNumMembers(dec);
+    if(newRow->scratch->memCreateReducedMembersCallStack < numMembers){
+        newRow->scratch->memCreateReducedMembersCallStack = max(2*newRow->scratch->memCreateReducedMembersCallStack,numMembers);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->scratch->createReducedMembersCallStack,(size_t) newRow->scratch->memCreateReducedMembersCallStack));
     }
 
     //Create the reduced members (recursively)
-    for (int i = 0; i < newRow->numDecompositionColumnEdges; ++i) {
+    //With the ancestor index, we only walk up to the lowest common ancestor of the touched members in each tree
+    MATREC_CALL(updateMemberAncestorIndex(dec));
+    const MATRECAncestorIndex * ancestors = &dec->memberAncestors;
+    bool useAncestors = ancestors->valid;
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newRow->numDecompositionColumnEdges; ++i) {
+            spqr_member edgeMember = findEdgeMember(dec, newRow->decompositionColumnEdges[i]);
+            spqr_member * lca = &newRow->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,edgeMember)].componentLCA;
+            *lca = SPQRmemberIsValid(*lca) ? MATRECancestorIndexLCA(ancestors,*lca,edgeMember) : edgeMember;
+        }
+    }
+    for (MATREC_index i = 0; i < newRow->numDecompositionColumnEdges; ++i) {
         assert(i < newRow->memDecompositionColumnEdges);
         spqr_edge edge = newRow->decompositionColumnEdges[i];
         spqr_member edgeMember = findEdgeMember(dec, edge);
-        reduced_member_id reducedMember = createRowReducedMembersToRoot(dec,newRow,edgeMember);
-        reduced_member_id* depthMinimizer = &newRow->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+        spqr_member stopMember = useAncestors
+                ? newRow->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,edgeMember)].componentLCA
+                : SPQR_INVALID_MEMBER;
+        reduced_member_id reducedMember = createRowReducedMembersToRoot(dec, newRow, edgeMember, stopMember);
+        reduced_member_id* depthMinimizer = &newRow->scratch->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
         if(reducedMemberIsInvalid(*depthMinimizer)){
             *depthMinimizer = reducedMember;
         }
     }
 
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newRow->numDecompositionColumnEdges; ++i) {
+            spqr_member edgeMember = findEdgeMember(dec, newRow->decompositionColumnEdges[i]);
+            newRow->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,edgeMember)].componentLCA = SPQR_INVALID_MEMBER;
+        }
+    }else{
+        dec->memberAncestors.walkSteps += (size_t) newRow->numReducedMembers;
+    }
+
     //Set the reduced roots according to the root depth minimizers
-    for (int i = 0; i < newRow->numReducedComponents; ++i) {
+    for (MATREC_index i = 0; i < newRow->numReducedComponents; ++i) {
         MATRECRowReducedComponent * component = &newRow->reducedComponents[i];
         spqr_member rootMember = newRow->reducedMembers[component->root].member;
-        reduced_member_id reducedMinimizer = newRow->memberInformation[rootMember].rootDepthMinimizer;
+        reduced_member_id reducedMinimizer = newRow->scratch->memberInformation[rootMember].rootDepthMinimizer;
         component->rootDepth =  newRow->reducedMembers[reducedMinimizer].depth;
         component->root = reducedMinimizer;
 
@@ -4312,10 +5439,10 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECGraphicDecomposition*
     }
 
     //update the children array
-    int numTotalChildren = 0;
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
+    MATREC_index numTotalChildren = 0;
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
         MATRECRowReducedMember * reducedMember = &newRow->reducedMembers[i];
-        reduced_member_id minimizer = newRow->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
+        reduced_member_id minimizer = newRow->scratch->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
         if(reducedMember->depth >= newRow->reducedMembers[minimizer].depth){
             reducedMember->firstChild = numTotalChildren;
             numTotalChildren += reducedMember->numChildren;
@@ -4324,7 +5451,7 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECGraphicDecomposition*
     }
 
     if(newRow->memChildrenStorage < numTotalChildren){
-        int newMemSize = max(newRow->memChildrenStorage*2, numTotalChildren);
+        MATREC_index newMemSize = max(newRow->memChildrenStorage*2, numTotalChildren);
         newRow->memChildrenStorage = newMemSize;
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->childrenStorage,(size_t) newRow->memChildrenStorage));
     }
@@ -4333,11 +5460,11 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECGraphicDecomposition*
     //Fill up the children array`
     for(reduced_member_id  reducedMember = 0; reducedMember < newRow->numReducedMembers; ++reducedMember){
         MATRECRowReducedMember * reducedMemberData = &newRow->reducedMembers[reducedMember];
-        if(reducedMemberData->depth <= newRow->reducedMembers[newRow->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth){
+        if(reducedMemberData->depth <= newRow->reducedMembers[newRow->scratch->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth){
             continue;
         }
         spqr_member parentMember = findMemberParent(dec, reducedMemberData->member);
-        reduced_member_id parentReducedMember = SPQRmemberIsValid(parentMember) ? newRow->memberInformation[parentMember].reducedMember : INVALID_REDUCED_MEMBER;
+        reduced_member_id parentReducedMember = SPQRmemberIsValid(parentMember) ? newRow->scratch->memberInformation[parentMember].reducedMember : INVALID_REDUCED_MEMBER;
         if(reducedMemberIsValid(parentReducedMember)){ //TODO: probably one of these two checks/branches is unnecessary, as there is a single failure case? (Not sure)
             MATRECRowReducedMember * parentReducedMemberData = &newRow->reducedMembers[parentReducedMember];
             newRow->childrenStorage[parentReducedMemberData->firstChild + parentReducedMemberData->numChildren] = reducedMember;
@@ -4346,13 +5473,13 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECGraphicDecomposition*
     }
 
     //Clean up the root depth minimizers.
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
         MATRECRowReducedMember * reducedMember = &newRow->reducedMembers[i];
         assert(reducedMember);
         spqr_member rootMember = reducedMember->rootMember;
         assert(rootMember >= 0);
         assert(rootMember < dec->memMembers);
-        newRow->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+        newRow->scratch->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
     }
 
     return MATREC_OKAY;
@@ -4393,31 +5520,31 @@ static MATREC_ERROR createReducedDecompositionCutEdges(MATRECGraphicDecompositio
     //Allocate memory for cut edges
     spqr_edge maxEdgeID = largestEdgeID(dec);
     if(maxEdgeID > newRow->memIsEdgeCut){
-        int newSize = max(maxEdgeID,2*newRow->memIsEdgeCut);
+        MATREC_index newSize = max(maxEdgeID,2*newRow->memIsEdgeCut);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->isEdgeCut,(size_t) newSize));
-        for (int i = newRow->memIsEdgeCut; i < newSize ; ++i) {
+        for (MATREC_index i = newRow->memIsEdgeCut; i < newSize ; ++i) {
             newRow->isEdgeCut[i] = false;
         }
         newRow->memIsEdgeCut = newSize;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memIsEdgeCut; ++i) {
+    for (MATREC_index i = 0; i < newRow->memIsEdgeCut; ++i) {
         assert(!newRow->isEdgeCut[i]);
     }
 #endif
 
-    int numNeededEdges = newRow->numDecompositionColumnEdges*4; //3 Is not enough; see tests. Probably 3 + 12 or so is, but cannot be bothered to work that out for now
+    MATREC_index numNeededEdges = newRow->numDecompositionColumnEdges*4; //3 Is not enough; see tests. Probably 3 + 12 or so is, but cannot be bothered to work that out for now
     if(numNeededEdges > newRow->memCutEdges){
-        int newSize = max(newRow->memCutEdges*2, numNeededEdges);
+        MATREC_index newSize = max(newRow->memCutEdges*2, numNeededEdges);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->cutEdges,(size_t) newSize));
         newRow->memCutEdges = newSize;
     }
     newRow->numCutEdges = 0;
     newRow->firstOverallCutEdge = INVALID_CUT_EDGE;
-    for (int i = 0; i < newRow->numDecompositionColumnEdges; ++i) {
+    for (MATREC_index i = 0; i < newRow->numDecompositionColumnEdges; ++i) {
         spqr_edge edge = newRow->decompositionColumnEdges[i];
         spqr_member member = findEdgeMember(dec, edge);
-        reduced_member_id reduced_member = newRow->memberInformation[member].reducedMember;
+        reduced_member_id reduced_member = newRow->scratch->memberInformation[member].reducedMember;
         assert(reducedMemberIsValid(reduced_member));
         createCutEdge(newRow,edge,reduced_member);
     }
@@ -4446,74 +5573,181 @@ static MATREC_ERROR determineLeafReducedMembers(const MATRECGraphicDecomposition
     return MATREC_OKAY;
 }
 
+static MATREC_index getFirstNodeAdjacency(const MATRECGraphicDecomposition *dec, spqr_node node){
+    assert(NODE(dec, node).adjacencyStart >= 0);
+    return NODE(dec, node).adjacencyStart;
+}
+
+static MATREC_index getNodeAdjacencyEnd(const MATRECGraphicDecomposition *dec, spqr_node node){
+    assert(NODE(dec, node).adjacencyStart >= 0);
+    return NODE(dec, node).adjacencyStart + NODE(dec, node).numEdges;
+}
+
+/**
+ * Ensures that the snapshot storage can hold the adjacency of any member, so that snapshots are built without allocating.
+ */
+static MATREC_ERROR reserveAdjacencySnapshots(MATRECGraphicDecomposition *dec){
+    MATREC_index minimalSize = 2 * dec->numEdges;
+    if(minimalSize > dec->memAdjacencyEntries){
+        MATREC_index newSize = max(2 * dec->memAdjacencyEntries, 2 * minimalSize);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env,&dec->adjacencyEntries,(size_t) newSize));
+        dec->memAdjacencyEntries = newSize;
+    }
+    return MATREC_OKAY;
+}
+
+static void addNodeAdjacency(MATRECGraphicDecomposition *dec, spqr_node node){
+    if(NODE(dec, node).adjacencyStart >= 0){
+        return;
+    }
+    MATREC_index position = dec->numAdjacencyEntries;
+    NODE(dec, node).adjacencyStart = position;
+    spqr_edge firstEdge = getFirstNodeEdge(dec,node);
+    spqr_edge edge = firstEdge;
+    do{
+        spqr_node head = findEdgeHead(dec,edge);
+        assert(position < dec->memAdjacencyEntries);
+        dec->adjacencyEntries[position].edge = edge;
+        dec->adjacencyEntries[position].node = head == node ? findEdgeTail(dec,edge) : head;
+        ++position;
+        edge = getNextNodeEdge(dec,edge,node);
+    }while(edge != firstEdge);
+    assert(position - NODE(dec, node).adjacencyStart == nodeDegree(dec,node));
+    dec->numAdjacencyEntries = position;
+}
+
+#ifndef NDEBUG
+static bool memberAdjacencyIsConsistent(MATRECGraphicDecomposition *dec, spqr_member member){
+    spqr_edge firstEdge = getFirstMemberEdge(dec,member);
+    spqr_edge memberEdge = firstEdge;
+    do{
+        spqr_node nodes[2] = {findEdgeHead(dec,memberEdge),findEdgeTail(dec,memberEdge)};
+        for (int i = 0; i < 2; ++i) {
+            spqr_node node = nodes[i];
+            MATREC_index position = getFirstNodeAdjacency(dec,node);
+            spqr_edge firstNodeEdge = getFirstNodeEdge(dec,node);
+            spqr_edge edge = firstNodeEdge;
+            do{
+                spqr_node head = findEdgeHead(dec,edge);
+                if(position == getNodeAdjacencyEnd(dec,node) || dec->adjacencyEntries[position].edge != edge ||
+                   dec->adjacencyEntries[position].node != (head == node ? findEdgeTail(dec,edge) : head)){
+                    return false;
+                }
+                ++position;
+                edge = getNextNodeEdge(dec,edge,node);
+            }while(edge != firstNodeEdge);
+            if(position != getNodeAdjacencyEnd(dec,node)){
+                return false;
+            }
+        }
+        memberEdge = getNextMemberEdge(dec,memberEdge);
+    }while(memberEdge != firstEdge);
+    return true;
+}
+#endif
+
+/**
+ * Builds the adjacency snapshot of a rigid member, unless it has a valid one already.
+ * The edges around each node are stored in the same order as in the node's edge list, so that searches over the snapshot
+ * visit the nodes in the same order as searches over the edge lists.
+ */
+static void buildMemberAdjacency(MATRECGraphicDecomposition *dec, spqr_member member){
+    assert(memberIsRepresentative(dec,member));
+    assert(getMemberType(dec,member) == SPQR_MEMBERTYPE_RIGID);
+    if(memberHasAdjacency(dec,member)){
+        assert(memberAdjacencyIsConsistent(dec,member));
+        return;
+    }
+    MATREC_index numEntries = 2 * getNumMemberEdges(dec,member);
+    assert(numEntries <= dec->memAdjacencyEntries);
+    if(dec->numAdjacencyEntries + numEntries > dec->memAdjacencyEntries){
+        ++dec->adjacencyVersion;
+        dec->numAdjacencyEntries = 0;
+    }
+
+    spqr_edge firstEdge = getFirstMemberEdge(dec,member);
+    spqr_edge edge = firstEdge;
+    do{
+        NODE(dec, findEdgeHead(dec,edge)).adjacencyStart = -1;
+        NODE(dec, findEdgeTail(dec,edge)).adjacencyStart = -1;
+        edge = getNextMemberEdge(dec,edge);
+    }while(edge != firstEdge);
+    do{
+        addNodeAdjacency(dec,findEdgeHead(dec,edge));
+        addNodeAdjacency(dec,findEdgeTail(dec,edge));
+        edge = getNextMemberEdge(dec,edge);
+    }while(edge != firstEdge);
+    MEMBER(dec, member).adjacencyVersion = dec->adjacencyVersion;
+}
+
 /**
  * Preallocates memory arrays necessary for searching rigid components.
  */
 static MATREC_ERROR allocateRigidSearchMemory(const MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow){
-    int totalNumNodes = getNumNodes(dec);
+    MATREC_index totalNumNodes = getNumNodes(dec);
     if(totalNumNodes > newRow->memNodeColors){
-        int newSize = max(2*newRow->memNodeColors,totalNumNodes);
+        MATREC_index newSize = max(2*newRow->memNodeColors,totalNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->nodeColors,(size_t) newSize));
-        for (int i = newRow->memNodeColors; i < newSize; ++i) {
+        for (MATREC_index i = newRow->memNodeColors; i < newSize; ++i) {
             newRow->nodeColors[i] = UNCOLORED;
         }
         newRow->memNodeColors = newSize;
     }
 
     if(totalNumNodes > newRow->memArticulationNodes){
-        int newSize = max(2*newRow->memArticulationNodes,totalNumNodes);
+        MATREC_index newSize = max(2*newRow->memArticulationNodes,totalNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->articulationNodes,(size_t) newSize));
         newRow->memArticulationNodes = newSize;
     }
     if(totalNumNodes > newRow->memNodeSearchInfo){
-        int newSize = max(2*newRow->memNodeSearchInfo,totalNumNodes);
+        MATREC_index newSize = max(2*newRow->memNodeSearchInfo,totalNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->articulationNodeSearchInfo,(size_t) newSize));
         newRow->memNodeSearchInfo = newSize;
     }
     if(totalNumNodes > newRow->memCrossingPathCount){
-        int newSize = max(2*newRow->memCrossingPathCount,totalNumNodes);
+        MATREC_index newSize = max(2*newRow->memCrossingPathCount,totalNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->crossingPathCount,(size_t) newSize));
         newRow->memCrossingPathCount = newSize;
     }
 
     //TODO: see if tradeoff for performance bound by checking max # of nodes of rigid is worth it to reduce size
     //of the following allocations
-    int largestID  = largestNodeID(dec); //TODO: only update the stack sizes of the following when needed? The preallocation might be causing performance problems
+    MATREC_index largestID  = largestNodeID(dec); //TODO: only update the stack sizes of the following when needed? The preallocation might be causing performance problems
     if(largestID > newRow->memIntersectionDFSData){
-        int newSize = max(2*newRow->memIntersectionDFSData,largestID);
+        MATREC_index newSize = max(2*newRow->memIntersectionDFSData,largestID);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->intersectionDFSData,(size_t) newSize));
         newRow->memIntersectionDFSData = newSize;
     }
     if(largestID > newRow->memColorDFSData){
-        int newSize = max(2*newRow->memColorDFSData, largestID);
+        MATREC_index newSize = max(2*newRow->memColorDFSData, largestID);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->colorDFSData,(size_t) newSize));
         newRow->memColorDFSData = newSize;
     }
     if(largestID > newRow->memArtDFSData){
-        int newSize = max(2*newRow->memArtDFSData,largestID);
+        MATREC_index newSize = max(2*newRow->memArtDFSData,largestID);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->artDFSData,(size_t) newSize));
         newRow->memArtDFSData = newSize;
     }
 
-    for (int i = 0; i < newRow->memIntersectionPathDepth; ++i) {
+    for (MATREC_index i = 0; i < newRow->memIntersectionPathDepth; ++i) {
         newRow->intersectionPathDepth[i] = -1;
     }
 
     if(largestID > newRow->memIntersectionPathDepth){
-        int newSize = max(2*newRow->memIntersectionPathDepth,largestID);
-        MATRECreallocBlockArray(dec->env, &newRow->intersectionPathDepth, (size_t) newSize);
-        for (int i = newRow->memIntersectionPathDepth; i < newSize; ++i) {
+        MATREC_index newSize = max(2*newRow->memIntersectionPathDepth,largestID);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newRow->intersectionPathDepth, (size_t) newSize));
+        for (MATREC_index i = newRow->memIntersectionPathDepth; i < newSize; ++i) {
             newRow->intersectionPathDepth[i] = -1;
         }
         newRow->memIntersectionPathDepth = newSize;
     }
-    for (int i = 0; i < newRow->memIntersectionPathParent; ++i) {
+    for (MATREC_index i = 0; i < newRow->memIntersectionPathParent; ++i) {
         newRow->intersectionPathParent[i] = SPQR_INVALID_NODE;
     }
     if(largestID > newRow->memIntersectionPathParent){
-        int newSize = max(2*newRow->memIntersectionPathParent,largestID);
-        MATRECreallocBlockArray(dec->env, &newRow->intersectionPathParent, (size_t) newSize);
-        for (int i = newRow->memIntersectionPathParent; i <newSize; ++i) {
+        MATREC_index newSize = max(2*newRow->memIntersectionPathParent,largestID);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newRow->intersectionPathParent, (size_t) newSize));
+        for (MATREC_index i = newRow->memIntersectionPathParent; i <newSize; ++i) {
             newRow->intersectionPathParent[i] = SPQR_INVALID_NODE;
         }
         newRow->memIntersectionPathParent = newSize;
@@ -4530,7 +5764,7 @@ static void zeroOutColors(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddit
     data[0].node = firstRemoveNode;
     data[0].edge = getFirstNodeEdge(dec,firstRemoveNode);
 
-    int depth = 0;
+    MATREC_index depth = 0;
 
     while(depth >= 0){
         assert(depth < newRow->memColorDFSData);
@@ -4558,16 +5792,48 @@ static void zeroOutColors(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddit
 
 }
 
+///Same as zeroOutColors, but searches over the adjacency snapshot of the member containing the node
+static void zeroOutMemberColors(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow, const spqr_node firstRemoveNode){
+    assert(firstRemoveNode < newRow->memNodeColors);
+    const SPQRGraphicAdjacencyEntry * adjacency = dec->adjacencyEntries;
+
+    newRow->nodeColors[firstRemoveNode] = UNCOLORED;
+    ColorDFSCallData * data = newRow->colorDFSData;
+
+    data[0].node = firstRemoveNode;
+    data[0].position = getFirstNodeAdjacency(dec,firstRemoveNode);
+
+    MATREC_index depth = 0;
+
+    while(depth >= 0){
+        assert(depth < newRow->memColorDFSData);
+        ColorDFSCallData * callData = &data[depth];
+        spqr_node otherNode = adjacency[callData->position].node;
+        assert(otherNode < newRow->memNodeColors);
+        ++callData->position;
+        if(newRow->nodeColors[otherNode] != UNCOLORED){
+            newRow->nodeColors[otherNode] = UNCOLORED;
+            ++depth;
+            data[depth].node = otherNode;
+            data[depth].position = getFirstNodeAdjacency(dec,otherNode);
+            continue;
+        }
+
+        while(depth >= 0 && data[depth].position == getNodeAdjacencyEnd(dec,data[depth].node)){
+            --depth;
+        }
+    }
+}
 static void cleanUpPreviousIteration(MATRECGraphicDecomposition * dec, MATRECGraphicRowAddition * newRow){
     //zero out coloring information from previous check
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
         if(SPQRnodeIsValid(newRow->reducedMembers[i].coloredNode)){
             zeroOutColors(dec,newRow,newRow->reducedMembers[i].coloredNode);
             newRow->reducedMembers[i].coloredNode = SPQR_INVALID_NODE;
         }
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memNodeColors; ++i) {
+    for (MATREC_index i = 0; i < newRow->memNodeColors; ++i) {
         assert(newRow->nodeColors[i] == UNCOLORED);
     }
 #endif
@@ -4635,38 +5901,19 @@ static NodePair rigidDetermineAllAdjacentSplittableNodes(MATRECGraphicDecomposit
 static MATREC_ERROR zeroOutColorsExceptNeighbourhood(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow,
                                                    const spqr_node articulationNode, const spqr_node startRemoveNode){
     COLOR_STATUS * neighbourColors;
-    int degree = nodeDegree(dec,articulationNode);
+    MATREC_index degree = nodeDegree(dec,articulationNode);
     MATREC_CALL(MATRECallocBlockArray(dec->env,&neighbourColors,(size_t) degree));
 
-    {
-        int i = 0;
-        spqr_edge artFirstEdge = getFirstNodeEdge(dec, articulationNode);
-        spqr_edge artItEdge = artFirstEdge;
-        do{
-            spqr_node head = findEdgeHead(dec, artItEdge);
-            spqr_node tail = findEdgeTail(dec, artItEdge);
-            spqr_node otherNode = articulationNode == head ? tail : head;
-            neighbourColors[i] = newRow->nodeColors[otherNode];
-            i++;
-            assert(i <= degree);
-            artItEdge = getNextNodeEdge(dec,artItEdge,articulationNode);
-        }while(artItEdge != artFirstEdge);
+    const SPQRGraphicAdjacencyEntry * adjacency = dec->adjacencyEntries;
+    MATREC_index first = getFirstNodeAdjacency(dec,articulationNode);
+    MATREC_index end = getNodeAdjacencyEnd(dec,articulationNode);
+    for (MATREC_index i = first; i < end; ++i) {
+        neighbourColors[i - first] = newRow->nodeColors[adjacency[i].node];
     }
-    zeroOutColors(dec,newRow,startRemoveNode);
+    zeroOutMemberColors(dec,newRow,startRemoveNode);
 
-    {
-        int i = 0;
-        spqr_edge artFirstEdge = getFirstNodeEdge(dec, articulationNode);
-        spqr_edge artItEdge = artFirstEdge;
-        do{
-            spqr_node head = findEdgeHead(dec, artItEdge);
-            spqr_node tail = findEdgeTail(dec, artItEdge);
-            spqr_node otherNode = articulationNode == head ? tail : head;
-            newRow->nodeColors[otherNode] = neighbourColors[i];
-            i++;
-            assert(i <= degree);
-            artItEdge = getNextNodeEdge(dec,artItEdge,articulationNode);
-        }while(artItEdge != artFirstEdge);
+    for (MATREC_index i = first; i < end; ++i) {
+        newRow->nodeColors[adjacency[i].node] = neighbourColors[i - first];
     }
 
     MATRECfreeBlockArray(dec->env,&neighbourColors);
@@ -4674,9 +5921,10 @@ static MATREC_ERROR zeroOutColorsExceptNeighbourhood(MATRECGraphicDecomposition
 }
 
 static void intersectionOfAllPaths(MATRECGraphicDecomposition * dec, MATRECGraphicRowAddition *newRow,
-                                   const reduced_member_id toCheck, int * const nodeNumPaths){
-    int * intersectionPathDepth = newRow->intersectionPathDepth;
+                                   const reduced_member_id toCheck, MATREC_index * const nodeNumPaths){
+    MATREC_index * intersectionPathDepth = newRow->intersectionPathDepth;
     spqr_node * intersectionPathParent = newRow->intersectionPathParent;
+    const SPQRGraphicAdjacencyEntry * adjacency = dec->adjacencyEntries;
 
     //First do a dfs over the tree, storing all the tree-parents and depths for each node
     //TODO: maybe cache this tree and also update it so we can prevent this DFS call?
@@ -4690,29 +5938,28 @@ static void intersectionOfAllPaths(MATRECGraphicDecomposition * dec, MATRECGraph
         assert(intersectionPathDepth[root] == -1);
         assert(intersectionPathParent[root] == SPQR_INVALID_NODE);
 
-        int pathSearchCallStackSize = 0;
+        MATREC_index pathSearchCallStackSize = 0;
 
         intersectionPathDepth[root] = 0;
         intersectionPathParent[root] = SPQR_INVALID_NODE;
 
         pathSearchCallStack[0].node = root;
-        pathSearchCallStack[0].nodeEdge = getFirstNodeEdge(dec, root);
+        pathSearchCallStack[0].position = getFirstNodeAdjacency(dec, root);
         pathSearchCallStackSize++;
         while (pathSearchCallStackSize > 0) {
             assert(pathSearchCallStackSize <= newRow->memIntersectionDFSData);
             DFSCallData *dfsData = &pathSearchCallStack[pathSearchCallStackSize - 1];
+            const SPQRGraphicAdjacencyEntry *entry = &adjacency[dfsData->position];
             //cannot be a tree edge which is its parent
-            if (edgeIsTree(dec, dfsData->nodeEdge) &&
+            if (edgeIsTree(dec, entry->edge) &&
                 (pathSearchCallStackSize <= 1 ||
-                 dfsData->nodeEdge != pathSearchCallStack[pathSearchCallStackSize - 2].nodeEdge)) {
-                spqr_node head = findEdgeHeadNoCompression(dec, dfsData->nodeEdge);
-                spqr_node tail = findEdgeTailNoCompression(dec, dfsData->nodeEdge);
-                spqr_node other = head == dfsData->node ? tail : head;
+                 entry->edge != adjacency[pathSearchCallStack[pathSearchCallStackSize - 2].position].edge)) {
+                spqr_node other = entry->node;
                 assert(other != dfsData->node);
 
                 //We go up a level: add new node to the call stack
                 pathSearchCallStack[pathSearchCallStackSize].node = other;
-                pathSearchCallStack[pathSearchCallStackSize].nodeEdge = getFirstNodeEdge(dec, other);
+                pathSearchCallStack[pathSearchCallStackSize].position = getFirstNodeAdjacency(dec, other);
                 //Every time a new node is discovered/added, we update its parent and depth information
                 assert(intersectionPathDepth[other] == -1);
                 assert(intersectionPathParent[other] == SPQR_INVALID_NODE);
@@ -4722,8 +5969,8 @@ static void intersectionOfAllPaths(MATRECGraphicDecomposition * dec, MATRECGraph
                 continue;
             }
             do {
-                dfsData->nodeEdge = getNextNodeEdge(dec, dfsData->nodeEdge, dfsData->node);
-                if (dfsData->nodeEdge == getFirstNodeEdge(dec, dfsData->node)) {
+                ++dfsData->position;
+                if (dfsData->position == getNodeAdjacencyEnd(dec, dfsData->node)) {
                     --pathSearchCallStackSize;
                     dfsData = &pathSearchCallStack[pathSearchCallStackSize - 1];
                 } else {
@@ -4742,8 +5989,8 @@ static void intersectionOfAllPaths(MATRECGraphicDecomposition * dec, MATRECGraph
         //Iteratively jump up to the parents until they reach a common parent
         spqr_node source = findEdgeHead(dec, edge);
         spqr_node target = findEdgeTail(dec, edge);
-        int sourceDepth = intersectionPathDepth[source];
-        int targetDepth = intersectionPathDepth[target];
+        MATREC_index sourceDepth = intersectionPathDepth[source];
+        MATREC_index targetDepth = intersectionPathDepth[target];
         nodeNumPaths[source]++;
         nodeNumPaths[target]++;
 
@@ -4777,7 +6024,7 @@ static void intersectionOfAllPaths(MATRECGraphicDecomposition * dec, MATRECGraph
 
 static void addArticulationNode(MATRECGraphicRowAddition *newRow, spqr_node articulationNode){
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->numArticulationNodes; ++i) {
+    for (MATREC_index i = 0; i < newRow->numArticulationNodes; ++i) {
         assert(newRow->articulationNodes[i] != articulationNode);
     }
 #endif
@@ -4786,16 +6033,17 @@ static void addArticulationNode(MATRECGraphicRowAddition *newRow, spqr_node arti
 }
 static void articulationPoints(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition * newRow, ArticulationNodeInformation *nodeInfo, reduced_member_id reducedMember){
     const bool * edgeRemoved = newRow->isEdgeCut;
+    const SPQRGraphicAdjacencyEntry * adjacency = dec->adjacencyEntries;
 
-    int rootChildren = 0;
+    MATREC_index rootChildren = 0;
     spqr_node root_node = findEdgeHead(dec, getFirstMemberEdge(dec, newRow->reducedMembers[reducedMember].member));;
 
     ArticulationPointCallStack * callStack = newRow->artDFSData;
 
-    int depth = 0;
-    int time = 1;
+    MATREC_index depth = 0;
+    MATREC_index time = 1;
 
-    callStack[depth].edge = getFirstNodeEdge(dec,root_node);
+    callStack[depth].position = getFirstNodeAdjacency(dec,root_node);
     callStack[depth].node = root_node;
     callStack[depth].parent = SPQR_INVALID_NODE;
     callStack[depth].isAP = false;
@@ -4804,11 +6052,10 @@ static void articulationPoints(MATRECGraphicDecomposition *dec, MATRECGraphicRow
     nodeInfo[root_node].discoveryTime = time;
 
     while(depth >= 0){
-        if(!edgeRemoved[callStack[depth].edge]){
+        const SPQRGraphicAdjacencyEntry * entry = &adjacency[callStack[depth].position];
+        if(!edgeRemoved[entry->edge]){
             spqr_node node = callStack[depth].node;
-            spqr_node head = findEdgeHead(dec, callStack[depth].edge);
-            spqr_node tail = findEdgeTail(dec, callStack[depth].edge);
-            spqr_node otherNode = node == head ? tail : head;
+            spqr_node otherNode = entry->node;
             if(otherNode != callStack[depth].parent){
                 if(nodeInfo[otherNode].discoveryTime == 0){
                     if(depth == 0){
@@ -4819,7 +6066,7 @@ static void articulationPoints(MATRECGraphicDecomposition *dec, MATRECGraphicRow
                     assert(depth < newRow->memArtDFSData);
                     callStack[depth].parent = node;
                     callStack[depth].node = otherNode;
-                    callStack[depth].edge = getFirstNodeEdge(dec,otherNode);
+                    callStack[depth].position = getFirstNodeAdjacency(dec,otherNode);
                     callStack[depth].isAP = false;
 
                     ++time;
@@ -4834,8 +6081,8 @@ static void articulationPoints(MATRECGraphicDecomposition *dec, MATRECGraphicRow
         }
 
         while(true){
-            callStack[depth].edge = getNextNodeEdge(dec,callStack[depth].edge,callStack[depth].node);
-            if(callStack[depth].edge != getFirstNodeEdge(dec,callStack[depth].node)) break;
+            ++callStack[depth].position;
+            if(callStack[depth].position != getNodeAdjacencyEnd(dec,callStack[depth].node)) break;
             --depth;
             if (depth < 0) break;
 
@@ -4862,41 +6109,41 @@ static void rigidConnectedColoringRecursive(MATRECGraphicDecomposition *dec, MAT
     const bool * isEdgeCut = newRow->isEdgeCut;
     COLOR_STATUS * nodeColors = newRow->nodeColors;
     ColorDFSCallData * data = newRow->colorDFSData;
+    const SPQRGraphicAdjacencyEntry * adjacency = dec->adjacencyEntries;
 
     data[0].node = firstProcessNode;
-    data[0].edge = getFirstNodeEdge(dec,firstProcessNode);
+    data[0].position = getFirstNodeAdjacency(dec,firstProcessNode);
     newRow->nodeColors[firstProcessNode] = COLOR_FIRST;
 
-    int depth = 0;
+    MATREC_index depth = 0;
     while(depth >= 0){
         assert(depth < newRow->memColorDFSData);
         ColorDFSCallData * callData = &data[depth];
-        spqr_node head = findEdgeHead(dec, callData->edge);
-        spqr_node tail = findEdgeTail(dec, callData->edge);
-        spqr_node otherNode = callData->node == head ? tail : head;
+        spqr_edge edge = adjacency[callData->position].edge;
+        spqr_node otherNode = adjacency[callData->position].node;
         if(otherNode != articulationNode){
             COLOR_STATUS currentColor = nodeColors[callData->node];
             COLOR_STATUS otherColor = nodeColors[otherNode];
             if(otherColor == UNCOLORED){
-                if(isEdgeCut[callData->edge]){
+                if(isEdgeCut[edge]){
                     nodeColors[otherNode] = currentColor == COLOR_FIRST ? COLOR_SECOND : COLOR_FIRST; //reverse the colors
                 }else{
                     nodeColors[otherNode] = currentColor;
                 }
-                callData->edge = getNextNodeEdge(dec,callData->edge,callData->node);
+                ++callData->position;
 
                 depth++;
                 assert(depth < newRow->memColorDFSData);
                 data[depth].node = otherNode;
-                data[depth].edge = getFirstNodeEdge(dec,otherNode);
+                data[depth].position = getFirstNodeAdjacency(dec,otherNode);
                 continue;
-            }else if(isEdgeCut[callData->edge] ^ (otherColor != currentColor)){
+            }else if(isEdgeCut[edge] ^ (otherColor != currentColor)){
                 *isGood = false;
                 break;
             }
         }
-        callData->edge = getNextNodeEdge(dec,callData->edge,callData->node);
-        while(depth >= 0 && data[depth].edge == getFirstNodeEdge(dec,data[depth].node)){
+        ++callData->position;
+        while(depth >= 0 && data[depth].position == getNodeAdjacencyEnd(dec,data[depth].node)){
             --depth;
         }
     }
@@ -4935,7 +6182,7 @@ static void rigidConnectedColoring(MATRECGraphicDecomposition *dec, MATRECGraphi
 
     // Need to zero all colors for next attempts if we failed
     if(!(*isGood)){
-        zeroOutColors(dec,newRow,firstProcessNode);
+        zeroOutMemberColors(dec,newRow,firstProcessNode);
         newRow->reducedMembers[reducedMember].coloredNode = SPQR_INVALID_NODE;
     }else{
         zeroOutColorsExceptNeighbourhood(dec,newRow,node, firstProcessNode);
@@ -4949,15 +6196,14 @@ static spqr_node checkNeighbourColoringArticulationNode(MATRECGraphicDecompositi
     spqr_node secondSideCandidate = SPQR_INVALID_NODE;
     spqr_edge firstSideEdge = SPQR_INVALID_EDGE;
     spqr_edge secondSideEdge = SPQR_INVALID_EDGE;
-    int numFirstSide = 0;
-    int numSecondSide = 0;
-
-    spqr_edge firstEdge = getFirstNodeEdge(dec, articulationNode);
-    spqr_edge moveEdge = firstEdge;
-    do{
-        spqr_node head = findEdgeHead(dec, moveEdge);
-        spqr_node tail = findEdgeTail(dec, moveEdge);
-        spqr_node otherNode = articulationNode == head ? tail : head;
+    MATREC_index numFirstSide = 0;
+    MATREC_index numSecondSide = 0;
+
+    const SPQRGraphicAdjacencyEntry * adjacency = dec->adjacencyEntries;
+    MATREC_index end = getNodeAdjacencyEnd(dec,articulationNode);
+    for (MATREC_index position = getFirstNodeAdjacency(dec,articulationNode); position < end; ++position) {
+        spqr_edge moveEdge = adjacency[position].edge;
+        spqr_node otherNode = adjacency[position].node;
         assert(newRow->nodeColors[otherNode] != UNCOLORED);
         //TODO: bit duplicate logic here? Maybe a nice way to fix?
         if((newRow->nodeColors[otherNode] == COLOR_FIRST) ^ newRow->isEdgeCut[moveEdge] ){
@@ -4977,8 +6223,7 @@ static spqr_node checkNeighbourColoringArticulationNode(MATRECGraphicDecompositi
             }
             ++numSecondSide;
         }
-        moveEdge = getNextNodeEdge(dec,moveEdge,articulationNode);
-    }while(moveEdge != firstEdge);
+    }
 
     if(numFirstSide == 1){
         *adjacentSplittingEdge = firstSideEdge;
@@ -4993,28 +6238,31 @@ static spqr_node checkNeighbourColoringArticulationNode(MATRECGraphicDecompositi
 
 static void rigidGetSplittableArticulationPointsOnPath(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow,
                                                        const reduced_member_id toCheck, NodePair * const pair){
-    int totalNumNodes = getNumNodes(dec);
-    int * nodeNumPaths = newRow->crossingPathCount;
+    MATREC_index totalNumNodes = getNumNodes(dec);
+    MATREC_index * nodeNumPaths = newRow->crossingPathCount;
 
-    for (int i = 0; i < totalNumNodes; ++i) {
+    for (MATREC_index i = 0; i < totalNumNodes; ++i) {
         nodeNumPaths[i] = 0;
     }
 
+    //The searches below all run over the adjacency snapshot of the member
+    buildMemberAdjacency(dec,newRow->reducedMembers[toCheck].member);
+
     intersectionOfAllPaths(dec,newRow,toCheck,nodeNumPaths);
 
     newRow->numArticulationNodes = 0;
 
     ArticulationNodeInformation * artNodeInfo = newRow->articulationNodeSearchInfo;
-    for (int i = 0; i < totalNumNodes; ++i) { //clean up can not easily be done in the search, unfortunately
+    for (MATREC_index i = 0; i < totalNumNodes; ++i) { //clean up can not easily be done in the search, unfortunately
         artNodeInfo[i].low = 0 ;
         artNodeInfo[i].discoveryTime = 0;
     }
 
     articulationPoints(dec,newRow,artNodeInfo,toCheck);
 
-    int numCutEdges = newRow->reducedMembers[toCheck].numCutEdges;
+    MATREC_index numCutEdges = newRow->reducedMembers[toCheck].numCutEdges;
     NodePairEmptyInitialize(&newRow->reducedMembers[toCheck].splitting_nodes);
-    for (int i = 0; i < newRow->numArticulationNodes; i++) {
+    for (MATREC_index i = 0; i < newRow->numArticulationNodes; i++) {
         spqr_node articulationNode = newRow->articulationNodes[i];
         assert(nodeIsRepresentative(dec, articulationNode));
         bool isOnPath = nodeNumPaths[articulationNode] == numCutEdges;
@@ -5031,7 +6279,7 @@ static void rigidGetSplittableArticulationPointsOnPath(MATRECGraphicDecompositio
                     (NodePairIsEmpty(pair) || pair->first == adjacentSplittingNode ||
                      pair->second == adjacentSplittingNode)) {
                     bool isArticulationNode = false;
-                    for (int j = 0; j < newRow->numArticulationNodes; ++j) {
+                    for (MATREC_index j = 0; j < newRow->numArticulationNodes; ++j) {
                         if (newRow->articulationNodes[j] == adjacentSplittingNode) {
                             isArticulationNode = true;
                             break;
@@ -5042,17 +6290,9 @@ static void rigidGetSplittableArticulationPointsOnPath(MATRECGraphicDecompositio
                         assert(NodePairHasTwo(&newRow->reducedMembers[toCheck].splitting_nodes));
                         newRow->reducedMembers[toCheck].articulationEdge = adjacentSplittingEdge;
                         //Cleaning up the colors for next iterations...
-                        {
-                            spqr_edge firstNodeEdge = getFirstNodeEdge(dec, articulationNode);
-                            spqr_edge itEdge = firstNodeEdge;
-                            do {
-                                spqr_node head = findEdgeHead(dec, itEdge);
-                                spqr_node tail = findEdgeTail(dec, itEdge);
-                                spqr_node otherNode = articulationNode == head ? tail : head;
-                                newRow->nodeColors[otherNode] = UNCOLORED;
-                                itEdge = getNextNodeEdge(dec, itEdge, articulationNode);
-                            } while (itEdge != firstNodeEdge);
-
+                        MATREC_index end = getNodeAdjacencyEnd(dec,articulationNode);
+                        for (MATREC_index position = getFirstNodeAdjacency(dec,articulationNode); position < end; ++position) {
+                            newRow->nodeColors[dec->adjacencyEntries[position].node] = UNCOLORED;
                         }
                     }
                 }
@@ -5194,7 +6434,7 @@ static RowReducedMemberType determineType(MATRECGraphicDecomposition *dec, MATRE
 }
 
 static void propagateComponents(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow){
-    int leafArrayIndex = 0;
+    MATREC_index leafArrayIndex = 0;
 
     reduced_member_id leaf;
     reduced_member_id next;
@@ -5227,7 +6467,7 @@ static void propagateComponents(MATRECGraphicDecomposition *dec, MATRECGraphicRo
 
     }
 
-    for (int j = 0; j < newRow->numReducedComponents; ++j) {
+    for (MATREC_index j = 0; j < newRow->numReducedComponents; ++j) {
         //The reduced root might be a leaf as well: we propagate it last
         reduced_member_id root = newRow->reducedComponents[j].root;
 
@@ -5428,7 +6668,7 @@ static RowReducedMemberType determineTypeMerging(MATRECGraphicDecomposition *dec
         }
         case SPQR_MEMBERTYPE_SERIES:
         {
-            int numNonPropagatedAdjacent = newRow->reducedMembers[toCheck].numChildren-newRow->reducedMembers[toCheck].numPropagatedChildren;
+            MATREC_index numNonPropagatedAdjacent = newRow->reducedMembers[toCheck].numChildren-newRow->reducedMembers[toCheck].numPropagatedChildren;
             if(reducedMemberIsValid(newRow->reducedMembers[toCheck].parent) &&
                newRow->reducedMembers[newRow->reducedMembers[toCheck].parent].type != TYPE_PROPAGATED){
                 ++numNonPropagatedAdjacent;
@@ -5454,7 +6694,7 @@ static RowReducedMemberType determineTypeMerging(MATRECGraphicDecomposition *dec
 }
 
 static MATREC_ERROR allocateTreeSearchMemory(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow){
-    int necessarySpace = newRow->numReducedMembers;
+    MATREC_index necessarySpace = newRow->numReducedMembers;
     if( necessarySpace > newRow->memMergeTreeCallData ){
         newRow->memMergeTreeCallData = max(2*newRow->memMergeTreeCallData,necessarySpace);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->mergeTreeCallData,(size_t) newRow->memMergeTreeCallData));
@@ -5465,7 +6705,7 @@ static MATREC_ERROR allocateTreeSearchMemory(MATRECGraphicDecomposition *dec, MA
 static void determineMergeableTypes(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow, reduced_member_id root){
     assert(newRow->numReducedMembers <= newRow->memMergeTreeCallData);
 
-    int depth = 0;
+    MATREC_index depth = 0;
     MergeTreeCallData * stack = newRow->mergeTreeCallData;
 
     stack[0].currentChild = newRow->reducedMembers[root].firstChild;
@@ -5500,12 +6740,12 @@ static void determineMergeableTypes(MATRECGraphicDecomposition *dec, MATRECGraph
 static void cleanUpRowMemberInformation(MATRECGraphicRowAddition * newRow){
     //This loop is at the end as memberInformation is also used to assign the cut edges during propagation
     //Clean up the memberInformation array
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
-        newRow->memberInformation[newRow->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
+        newRow->scratch->memberInformation[newRow->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newRow->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newRow->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newRow->scratch->memberInformation[i].reducedMember));
     }
 #endif
 }
@@ -5629,8 +6869,8 @@ static MATREC_ERROR transformSingleRigid(MATRECGraphicDecomposition *dec, MATREC
     }
     assert(!NodePairIsEmpty(&newRow->reducedMembers[reducedMember].splitting_nodes));
     //Multiple edges without a common end: need to use coloring information
-    int numFirstColor = 0;
-    int numSecondColor = 0;
+    MATREC_index numFirstColor = 0;
+    MATREC_index numSecondColor = 0;
 
     spqr_edge firstNodeEdge = getFirstNodeEdge(dec, splitNode);
     spqr_edge iterEdge = firstNodeEdge;
@@ -5699,8 +6939,8 @@ static MATREC_ERROR splitParallelRowAddition(MATRECGraphicDecomposition *dec, MA
                                 spqr_member * const loopMember){
     assert(newRow->reducedMembers[reducedMember].numCutEdges > 0);
 
-    int numCutEdges = newRow->reducedMembers[reducedMember].numCutEdges;
-    int numParallelEdges = getNumMemberEdges(dec,member);
+    MATREC_index numCutEdges = newRow->reducedMembers[reducedMember].numCutEdges;
+    MATREC_index numParallelEdges = getNumMemberEdges(dec,member);
 
     bool createCutParallel = numCutEdges > 1;
     bool convertOriginalParallel = (numCutEdges + 1) == numParallelEdges;
@@ -5812,15 +7052,15 @@ static MATREC_ERROR splitParallelMerging(MATRECGraphicDecomposition *dec, MATREC
     //When merging, we cannot have propagated members;
     assert(newRow->reducedMembers[reducedMember].numCutEdges < (getNumMemberEdges(dec,member)-1));
 
-    int numMergeableAdjacent = newRow->reducedMembers[reducedMember].numChildren - newRow->reducedMembers[reducedMember].numPropagatedChildren;
+    MATREC_index numMergeableAdjacent = newRow->reducedMembers[reducedMember].numChildren - newRow->reducedMembers[reducedMember].numPropagatedChildren;
     if(reducedMemberIsValid(newRow->reducedMembers[reducedMember].parent) &&
        newRow->reducedMembers[newRow->reducedMembers[reducedMember].parent].type == TYPE_MERGED){
         numMergeableAdjacent++;
     }
 
-    int numCutEdges = newRow->reducedMembers[reducedMember].numCutEdges;
+    MATREC_index numCutEdges = newRow->reducedMembers[reducedMember].numCutEdges;
     //All edges which are not in the mergeable decomposition or cut
-    int numBaseSplitAwayEdges = getNumMemberEdges(dec,member) - numMergeableAdjacent - numCutEdges ;
+    MATREC_index numBaseSplitAwayEdges = getNumMemberEdges(dec,member) - numMergeableAdjacent - numCutEdges ;
 
     bool createCutParallel = numCutEdges > 1;
     bool keepOriginalParallel = numBaseSplitAwayEdges  <= 1;
@@ -6021,8 +7261,8 @@ static MATREC_ERROR transformRoot(MATRECGraphicDecomposition *dec, MATRECGraphic
 
             } else {
                 //TODO: fix duplication here.
-                int numFirstColor = 0;
-                int numSecondColor = 0;
+                MATREC_index numFirstColor = 0;
+                MATREC_index numSecondColor = 0;
 
                 spqr_edge firstNodeEdge = getFirstNodeEdge(dec, splitNode);
                 spqr_edge iterEdge = firstNodeEdge;
@@ -6117,7 +7357,7 @@ static MATREC_ERROR transformRoot(MATRECGraphicDecomposition *dec, MATRECGraphic
             MATREC_CALL(createNode(dec,&thirdNode));
             MATREC_CALL(createNode(dec,&fourthNode));
 
-            int reducedChildIndex = 0;
+            MATREC_index reducedChildIndex = 0;
 
             spqr_edge reducedEdges[2];
             for (children_idx i = newRow->reducedMembers[reducedMember].firstChild;
@@ -6211,7 +7451,7 @@ static MATREC_ERROR mergeRigidIntoParent(MATRECGraphicDecomposition *dec, MATREC
         articulationEdgeTail = findEdgeTail(dec, articulationEdge);
 #endif
         if(articulationEdge == childToParent ){
-            swap_ints(&adjacentSplitNode,&otherSplitNode);
+            swap_indices(&adjacentSplitNode,&otherSplitNode);
         }
     }
 
@@ -6495,7 +7735,7 @@ static MATREC_ERROR mergeTree(MATRECGraphicDecomposition *dec, MATRECGraphicRowA
     //We reuse the data for determining the types, which has similar call stack data and uses more memories
     assert(newRow->memMergeTreeCallData >= newRow->numReducedMembers);
 
-    int depth = 0;
+    MATREC_index depth = 0;
     MergeTreeCallData * stack = newRow->mergeTreeCallData;
 
     stack[0].currentChild = newRow->reducedMembers[root].firstChild;
@@ -6542,7 +7782,7 @@ static MATREC_ERROR transformComponentRowAddition(MATRECGraphicDecomposition *de
                 break;
             }
             case SPQR_MEMBERTYPE_LOOP:{
-                int numEdges = getNumMemberEdges(dec,member);
+                MATREC_index numEdges = getNumMemberEdges(dec,member);
                 if( numEdges == 2){
                     changeLoopToSeries(dec,member);
                 }
@@ -6563,13 +7803,7 @@ static MATREC_ERROR transformComponentRowAddition(MATRECGraphicDecomposition *de
 }
 
 
-MATREC_ERROR MATRECcreateGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition** pNewRow ){
-    assert(env);
-    MATREC_CALL(MATRECallocBlock(env,pNewRow));
-    MATRECGraphicRowAddition * newRow = *pNewRow;
-
-    newRow->remainsGraphic = true;
-
+static void initializeRowAdditionArrays(MATRECGraphicRowAddition *newRow){
     newRow->reducedMembers = NULL;
     newRow->memReducedMembers = 0;
     newRow->numReducedMembers = 0;
@@ -6578,10 +7812,6 @@ MATREC_ERROR MATRECcreateGraphicRowAddition(MATREC* env, MATRECGraphicRowAdditio
     newRow->memReducedComponents = 0;
     newRow->numReducedComponents = 0;
 
-    newRow->memberInformation = NULL;
-    newRow->memMemberInformation = 0;
-    newRow->numMemberInformation = 0;
-
     newRow->cutEdges = NULL;
     newRow->memCutEdges = 0;
     newRow->numCutEdges = 0;
@@ -6591,8 +7821,6 @@ MATREC_ERROR MATRECcreateGraphicRowAddition(MATREC* env, MATRECGraphicRowAdditio
     newRow->memChildrenStorage = 0;
     newRow->numChildrenStorage = 0;
 
-    newRow->newRowIndex = MATREC_INVALID_ROW;
-
     newRow->newColumnEdges = NULL;
     newRow->memColumnEdges = 0;
     newRow->numColumnEdges = 0;
@@ -6631,9 +7859,6 @@ MATREC_ERROR MATRECcreateGraphicRowAddition(MATREC* env, MATRECGraphicRowAdditio
     newRow->artDFSData = NULL;
     newRow->memArtDFSData = 0;
 
-    newRow->createReducedMembersCallstack = NULL;
-    newRow->memCreateReducedMembersCallstack = 0;
-
     newRow->intersectionPathDepth = NULL;
     newRow->memIntersectionPathDepth = 0;
 
@@ -6642,17 +7867,11 @@ MATREC_ERROR MATRECcreateGraphicRowAddition(MATREC* env, MATRECGraphicRowAdditio
 
     newRow->mergeTreeCallData = NULL;
     newRow->memMergeTreeCallData = 0;
-
-    return MATREC_OKAY;
 }
 
-void MATRECfreeGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition ** pNewRow){
-    assert(*pNewRow);
-
-    MATRECGraphicRowAddition * newRow = *pNewRow;
+static void freeRowAdditionArrays(MATREC *env, MATRECGraphicRowAddition *newRow){
     //TODO: check if everything is truly freed in reverse order
 
-    MATRECfreeBlockArray(env,&newRow->createReducedMembersCallstack);
     MATRECfreeBlockArray(env,&newRow->artDFSData);
     MATRECfreeBlockArray(env,&newRow->colorDFSData);
     MATRECfreeBlockArray(env,&newRow->mergeTreeCallData);
@@ -6676,9 +7895,6 @@ void MATRECfreeGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition ** pNewR
     if(newRow->cutEdges){
         MATRECfreeBlockArray(env,&newRow->cutEdges);
     }
-    if(newRow->memberInformation){
-        MATRECfreeBlockArray(env,&newRow->memberInformation);
-    }
     if(newRow->reducedComponents){
         MATRECfreeBlockArray(env,&newRow->reducedComponents);
     }
@@ -6686,16 +7902,130 @@ void MATRECfreeGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition ** pNewR
         MATRECfreeBlockArray(env,&newRow->reducedMembers);
     }
     MATRECfreeBlockArray(env,&newRow->leafMembers);
+}
+
+MATREC_ERROR MATRECcreateGraphicRowAddition(MATREC *env, MATRECGraphicRowAddition **pNewRow) {
+    return MATRECcreateGraphicRowAdditionWithScratch(env, pNewRow, NULL);
+}
+
+MATREC_ERROR MATRECcreateGraphicRowAdditionWithScratch(MATREC *env, MATRECGraphicRowAddition **pNewRow, MATRECGraphicAdditionScratch *scratch) {
+    assert(env);
+    MATREC_CALL(MATRECallocBlock(env,pNewRow));
+    MATRECGraphicRowAddition * newRow = *pNewRow;
+
+    newRow->ownsScratch = scratch == NULL;
+    if(newRow->ownsScratch){
+        MATREC_CALL(MATRECcreateGraphicAdditionScratch(env, &scratch));
+    }
+    newRow->scratch = scratch;
+
+    newRow->remainsGraphic = true;
+    newRow->newRowIndex = MATREC_INVALID_ROW;
+    initializeRowAdditionArrays(newRow);
+
+    newRow->peakMemory = 0;
+    newRow->autoShrinkCalls = 0;
+    newRow->numUnderusedCalls = 0;
+    MATRECtraceIdInit(&newRow->traceId);
+    return MATREC_OKAY;
+}
+
+void MATRECfreeGraphicRowAddition(MATREC* env, MATRECGraphicRowAddition ** pNewRow){
+    assert(*pNewRow);
+
+    MATRECGraphicRowAddition * newRow = *pNewRow;
+    traceFreeAddition(env, &newRow->traceId);
+    freeRowAdditionArrays(env, newRow);
+    if(newRow->ownsScratch){
+        MATRECfreeGraphicAdditionScratch(env, &newRow->scratch);
+    }
     MATRECfreeBlock(env,pNewRow);
 }
 
-MATREC_ERROR MATRECGraphicRowAdditionCheck(MATRECGraphicDecomposition * dec, MATRECGraphicRowAddition * newRow, const MATREC_row row, const MATREC_col * columns, size_t numColumns){
+void MATRECGraphicRowAdditionMemory(const MATRECGraphicRowAddition *newRow, MATRECMemoryReport *report){
+    assert(newRow);
+    assert(report);
+    MATRECmemoryReportInit(report);
+    MATRECmemoryReportAddBytes(report, "rowAddition", sizeof(MATRECGraphicRowAddition),
+                               sizeof(MATRECGraphicRowAddition));
+    MATRECmemoryReportAdd(report, "reducedMembers", sizeof(MATRECRowReducedMember), newRow->memReducedMembers,
+                          newRow->numReducedMembers);
+    MATRECmemoryReportAdd(report, "reducedComponents", sizeof(MATRECRowReducedComponent),
+                          newRow->memReducedComponents, newRow->numReducedComponents);
+    MATRECmemoryReportAdd(report, "childrenStorage", sizeof(reduced_member_id), newRow->memChildrenStorage,
+                          newRow->numChildrenStorage);
+    MATRECmemoryReportAdd(report, "cutEdges", sizeof(CutEdgeListNode), newRow->memCutEdges, newRow->numCutEdges);
+    MATRECmemoryReportAdd(report, "newColumnEdges", sizeof(MATREC_col), newRow->memColumnEdges,
+                          newRow->numColumnEdges);
+    MATRECmemoryReportAdd(report, "leafMembers", sizeof(reduced_member_id), newRow->memLeafMembers,
+                          newRow->numLeafMembers);
+    MATRECmemoryReportAdd(report, "decompositionColumnEdges", sizeof(spqr_edge),
+                          newRow->memDecompositionColumnEdges, newRow->numDecompositionColumnEdges);
+    MATRECmemoryReportAdd(report, "isEdgeCut", sizeof(bool), newRow->memIsEdgeCut, newRow->numIsEdgeCut);
+    MATRECmemoryReportAdd(report, "articulationNodes", sizeof(spqr_node), newRow->memArticulationNodes,
+                          newRow->numArticulationNodes);
+    //Arrays indexed by the nodes of the decomposition are always fully in use, and call stacks are only in use
+    //within the Check functions
+    MATRECmemoryReportAdd(report, "nodeColors", sizeof(COLOR_STATUS), newRow->memNodeColors, newRow->memNodeColors);
+    MATRECmemoryReportAdd(report, "crossingPathCount", sizeof(MATREC_index), newRow->memCrossingPathCount,
+                          newRow->memCrossingPathCount);
+    MATRECmemoryReportAdd(report, "intersectionPathDepth", sizeof(MATREC_index), newRow->memIntersectionPathDepth,
+                          newRow->memIntersectionPathDepth);
+    MATRECmemoryReportAdd(report, "intersectionPathParent", sizeof(spqr_node), newRow->memIntersectionPathParent,
+                          newRow->memIntersectionPathParent);
+    MATRECmemoryReportAdd(report, "articulationNodeSearchInfo", sizeof(ArticulationNodeInformation),
+                          newRow->memNodeSearchInfo, 0);
+    MATRECmemoryReportAdd(report, "intersectionDFSData", sizeof(DFSCallData), newRow->memIntersectionDFSData, 0);
+    MATRECmemoryReportAdd(report, "colorDFSData", sizeof(ColorDFSCallData), newRow->memColorDFSData, 0);
+    MATRECmemoryReportAdd(report, "artDFSData", sizeof(ArticulationPointCallStack), newRow->memArtDFSData, 0);
+    MATRECmemoryReportAdd(report, "mergeTreeCallData", sizeof(MergeTreeCallData), newRow->memMergeTreeCallData, 0);
+    if(newRow->ownsScratch){
+        addScratchMemory(newRow->scratch, report);
+    }
+    MATRECmemoryReportFinish(report, newRow->peakMemory);
+}
+
+void MATRECGraphicRowAdditionShrink(MATREC *env, MATRECGraphicRowAddition *newRow){
+    assert(env);
+    assert(newRow);
+    MATRECMemoryReport report;
+    MATRECGraphicRowAdditionMemory(newRow, &report);
+    newRow->peakMemory = report.peakBytes;
+    freeRowAdditionArrays(env, newRow);
+    initializeRowAdditionArrays(newRow);
+    newRow->numUnderusedCalls = 0;
+    shrinkScratch(env, newRow->scratch);
+}
+
+void MATRECGraphicRowAdditionSetAutoShrink(MATRECGraphicRowAddition *newRow, size_t numCalls){
+    assert(newRow);
+    newRow->autoShrinkCalls = numCalls;
+    newRow->numUnderusedCalls = 0;
+}
+
+///Counts the consecutive checks on a decomposition with fewer than a quarter of the edges that the arrays were grown
+///for, and shrinks the addition once there are enough of them
+static void autoShrinkRowAddition(const MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow){
+    if(4 * largestEdgeID(dec) >= newRow->memIsEdgeCut){
+        newRow->numUnderusedCalls = 0;
+        return;
+    }
+    ++newRow->numUnderusedCalls;
+    if(newRow->numUnderusedCalls >= newRow->autoShrinkCalls){
+        MATRECGraphicRowAdditionShrink(dec->env, newRow);
+    }
+}
+
+static MATREC_ERROR rowAdditionCheck(MATRECGraphicDecomposition * dec, MATRECGraphicRowAddition * newRow, const MATREC_row row, const MATREC_col * columns, MATREC_matrix_size numColumns){
     assert(dec);
     assert(newRow);
     assert(numColumns == 0 || columns );
 
     newRow->remainsGraphic = true;
     cleanUpPreviousIteration(dec,newRow);
+    if(newRow->autoShrinkCalls > 0){
+        autoShrinkRowAddition(dec, newRow);
+    }
 
     MATREC_CALL(newRowUpdateRowInformation(dec,newRow,row,columns,numColumns));
     MATREC_CALL(constructRowReducedDecomposition(dec,newRow));
@@ -6704,13 +8034,14 @@ MATREC_ERROR MATRECGraphicRowAdditionCheck(MATRECGraphicDecomposition * dec, MAT
     MATREC_CALL(determineLeafReducedMembers(dec,newRow));
     MATREC_CALL(allocateRigidSearchMemory(dec,newRow));
     MATREC_CALL(allocateTreeSearchMemory(dec,newRow));
+    MATREC_CALL(reserveAdjacencySnapshots(dec));
     //Check for each component if the cut edges propagate through a row tree marker to a cut edge in another component
     //From the leafs inward.
     propagateComponents(dec,newRow);
     //It can happen that we are not graphic by some of the checked components.
     //In that case, further checking may lead to errors as some invariants that the code assumes will be broken.
     if(newRow->remainsGraphic){
-        for (int i = 0; i < newRow->numReducedComponents; ++i) {
+        for (MATREC_index i = 0; i < newRow->numReducedComponents; ++i) {
             determineMergeableTypes(dec,newRow,newRow->reducedComponents[i].root);
             //exit early if one is not graphic
             if(!newRow->remainsGraphic){
@@ -6721,7 +8052,7 @@ MATREC_ERROR MATRECGraphicRowAdditionCheck(MATRECGraphicDecomposition * dec, MAT
 
     cleanUpRowMemberInformation(newRow);
     if(!newRow->remainsGraphic){
-        for (int i = 0; i < newRow->numReducedMembers; ++i) {
+        for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
             if(SPQRnodeIsValid(newRow->reducedMembers[i].coloredNode)){
                 zeroOutColors(dec,newRow,newRow->reducedMembers[i].coloredNode);
                 newRow->reducedMembers[i].coloredNode = SPQR_INVALID_NODE;
@@ -6732,14 +8063,30 @@ MATREC_ERROR MATRECGraphicRowAdditionCheck(MATRECGraphicDecomposition * dec, MAT
     return MATREC_OKAY;
 }
 
-MATREC_ERROR MATRECGraphicRowAdditionAdd(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow){
+MATREC_ERROR MATRECGraphicRowAdditionCheck(MATRECGraphicDecomposition * dec, MATRECGraphicRowAddition * newRow, const MATREC_row row, const MATREC_col * columns, MATREC_matrix_size numColumns){
+    MATREC_CALL(rowAdditionCheck(dec, newRow, row, columns, numColumns));
+    traceCheck(dec, MATREC_TRACE_ROW_CHECK, &newRow->traceId, row, columns, numColumns, newRow->remainsGraphic);
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR rowAdditionAdd(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow){
     assert(newRow->remainsGraphic);
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
+        invalidateMemberAdjacency(dec,newRow->reducedMembers[i].member);
+    }
+    //The addition only changes the members below the parent of the reduced root, unless it joins trees
+    spqr_member unchangedParent = SPQR_INVALID_MEMBER;
+    spqr_member changedMember = SPQR_INVALID_MEMBER;
+    if(newRow->numReducedComponents == 1){
+        unchangedParent = findMemberParent(dec,newRow->reducedMembers[newRow->reducedComponents[0].root].member);
+    }
     if(newRow->numReducedComponents == 0){
-        spqr_member newMember = SPQR_INVALID_MEMBER;
-        MATREC_CALL(createStandaloneParallel(dec,newRow->newColumnEdges,newRow->numColumnEdges,newRow->newRowIndex,&newMember));
+        MATREC_CALL(createStandaloneParallel(dec,newRow->newColumnEdges,newRow->numColumnEdges,newRow->newRowIndex,
+                                             &changedMember));
     }else if (newRow->numReducedComponents == 1){
         NewRowInformation information = emptyNewRowInformation();
         MATREC_CALL(transformComponentRowAddition(dec,newRow,&newRow->reducedComponents[0],&information));
+        changedMember = information.member;
 
         if(newRow->numColumnEdges == 0){
             spqr_edge row_edge = SPQR_INVALID_EDGE;
@@ -6766,17 +8113,18 @@ MATREC_ERROR MATRECGraphicRowAdditionAdd(MATRECGraphicDecomposition *dec, MATREC
     }else{
 
 #ifndef NDEBUG
-        int numDecComponentsBefore = numConnectedComponents(dec);
+        MATREC_index numDecComponentsBefore = numConnectedComponents(dec);
 #endif
         spqr_member new_row_parallel = SPQR_INVALID_MEMBER;
         MATREC_CALL(createConnectedParallel(dec,newRow->newColumnEdges,newRow->numColumnEdges,newRow->newRowIndex,&new_row_parallel));
-        for (int i = 0; i < newRow->numReducedComponents; ++i) {
+        changedMember = new_row_parallel;
+        for (MATREC_index i = 0; i < newRow->numReducedComponents; ++i) {
             NewRowInformation information = emptyNewRowInformation();
             MATREC_CALL(transformComponentRowAddition(dec,newRow,&newRow->reducedComponents[i],&information));
             if(getMemberType(dec,information.member) == SPQR_MEMBERTYPE_LOOP){
                 assert(getNumMemberEdges(dec,information.member) == 1);
                 moveEdgeToNewMember(dec, getFirstMemberEdge(dec,information.member),information.member,new_row_parallel);
-                dec->members[information.member].type = SPQR_MEMBERTYPE_UNASSIGNED;
+                MEMBER(dec, information.member).type = SPQR_MEMBERTYPE_UNASSIGNED;
             }else{
                 reorderComponent(dec,information.member); //Make sure the new component is the root of the local decomposition tree
                 spqr_edge markerEdge = SPQR_INVALID_EDGE;
@@ -6791,16 +8139,60 @@ MATREC_ERROR MATRECGraphicRowAdditionAdd(MATRECGraphicDecomposition *dec, MATREC
         decreaseNumConnectedComponents(dec,newRow->numReducedComponents-1);
         assert(numConnectedComponents(dec) == (numDecComponentsBefore - newRow->numReducedComponents + 1));
     }
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
         if(SPQRnodeIsValid(newRow->reducedMembers[i].coloredNode)){
             zeroOutColors(dec,newRow,newRow->reducedMembers[i].coloredNode);
             newRow->reducedMembers[i].coloredNode = SPQR_INVALID_NODE;
 
         }
     }
+    //The new row extends the fundamental cycles of the existing columns it has nonzeros in
+    if(newRow->numReducedComponents > 0){
+        MATRECcolumnTableClear(&dec->columns);
+    }
+    repairMemberAncestorIndex(dec,unchangedParent,changedMember);
+    autoFlatten(dec);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECGraphicRowAdditionAdd(MATRECGraphicDecomposition *dec, MATRECGraphicRowAddition *newRow){
+    MATREC_CALL(rowAdditionAdd(dec, newRow));
+    traceAdd(dec, MATREC_TRACE_ROW_ADD, &newRow->traceId);
     return MATREC_OKAY;
 }
 
 bool MATRECGraphicRowAdditionRemainsGraphic(const MATRECGraphicRowAddition *newRow){
     return newRow->remainsGraphic;
 }
+
+static spqr_edge getElementEdge(const MATRECGraphicDecomposition *dec, MATRECElement element){
+    return element.isRow ? getDecompositionRowEdge(dec, element.index) : getDecompositionColumnEdge(dec, element.index);
+}
+
+///The lookups of the queries below only write to the decomposition to compress paths, which does not change what it
+///represents
+static MATRECGraphicDecomposition * queryDecomposition(const MATRECGraphicDecomposition *dec){
+    return (MATRECGraphicDecomposition *) dec;
+}
+
+MATRECMemberType MATRECGraphicDecompositionMemberType(const MATRECGraphicDecomposition *dec, MATRECElement element){
+    assert(dec);
+    spqr_edge edge = getElementEdge(dec, element);
+    if(SPQRedgeIsInvalid(edge)){
+        return MATREC_MEMBER_NOT_CONTAINED;
+    }
+    return (MATRECMemberType) getMemberType(dec, findEdgeMember(queryDecomposition(dec), edge));
+}
+
+bool MATRECGraphicDecompositionSameComponent(const MATRECGraphicDecomposition *dec, MATRECElement first,
+                                             MATRECElement second){
+    assert(dec);
+    spqr_edge firstEdge = getElementEdge(dec, first);
+    spqr_edge secondEdge = getElementEdge(dec, second);
+    if(SPQRedgeIsInvalid(firstEdge) || SPQRedgeIsInvalid(secondEdge)){
+        return false;
+    }
+    MATRECGraphicDecomposition *lookup = queryDecomposition(dec);
+    return findMemberComponent(lookup, findEdgeMember(lookup, firstEdge)) ==
+           findMemberComponent(lookup, findEdgeMember(lookup, secondEdge));
+}
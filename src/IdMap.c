@@ -0,0 +1,231 @@
+#include "IdMap.h"
+#include "Kernels.h"
+#include <string.h>
+
+#define IDMAP_EMPTY_KEY (-1)
+
+static MATREC_index maxIndex(MATREC_index a, MATREC_index b){
+    return a > b ? a : b;
+}
+
+static MATREC_index hashSlot(const MATRECIdMap * map, MATREC_matrix_size id){
+    //Fibonacci hashing; consecutive ids are spread out, so clusters of ids do not lead to long probe sequences
+    uint64_t hash = (uint64_t) id * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 32;
+    return (MATREC_index) (hash & (uint64_t) (map->memSlots - 1));
+}
+
+///Returns the slot which holds the id, or the empty slot where it should be inserted
+static MATREC_index findSlot(const MATRECIdMap * map, MATREC_matrix_size id){
+    MATREC_index mask = map->memSlots - 1;
+    MATREC_index slot = hashSlot(map,id);
+    while(map->keys[slot] != IDMAP_EMPTY_KEY && (MATREC_matrix_size) map->keys[slot] != id){
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static MATREC_ERROR allocateHashedSlots(MATREC * env, MATRECIdMap * map, MATREC_index memSlots){
+    map->memSlots = memSlots;
+    map->numUsedSlots = 0;
+    MATREC_CALL(MATRECallocBlockArray(env,&map->keys,(size_t) memSlots));
+    MATREC_CALL(MATRECallocBlockArray(env,&map->values,(size_t) memSlots));
+    for (MATREC_index i = 0; i < memSlots; ++i) {
+        map->keys[i] = IDMAP_EMPTY_KEY;
+    }
+    return MATREC_OKAY;
+}
+
+///Moves the ids into new arrays with the given number of slots. On failure, the map is left unchanged
+static MATREC_ERROR rehash(MATREC * env, MATRECIdMap * map, MATREC_index memSlots){
+    MATRECIdMap resized = *map;
+    resized.keys = NULL;
+    resized.values = NULL;
+    MATREC_ERROR error = allocateHashedSlots(env,&resized,memSlots);
+    if(error != MATREC_OKAY){
+        if(resized.keys){
+            MATRECfreeBlockArray(env,&resized.keys);
+        }
+        return error;
+    }
+    for (MATREC_index i = 0; i < map->memSlots; ++i) {
+        if(map->keys[i] != IDMAP_EMPTY_KEY){
+            MATREC_index slot = findSlot(&resized,(MATREC_matrix_size) map->keys[i]);
+            resized.keys[slot] = map->keys[i];
+            resized.values[slot] = map->values[i];
+            ++resized.numUsedSlots;
+        }
+    }
+    MATRECfreeBlockArray(env,&map->values);
+    MATRECfreeBlockArray(env,&map->keys);
+    *map = resized;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR growHashed(MATREC * env, MATRECIdMap * map){
+    return rehash(env,map,2 * map->memSlots);
+}
+
+static MATREC_ERROR growDense(MATREC * env, MATRECIdMap * map, MATREC_matrix_size id){
+    MATREC_index newMemSlots = maxIndex(2 * map->memSlots, (MATREC_index) id + 1);
+    MATREC_CALL(MATRECreallocBlockArray(env,&map->values,(size_t) newMemSlots));
+    for (MATREC_index i = map->memSlots; i < newMemSlots; ++i) {
+        map->values[i] = map->missingValue;
+    }
+    map->memSlots = newMemSlots;
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECidMapCreate(MATREC * env, MATRECIdMap * map, MATRECIdStorage storage, MATREC_matrix_size expectedSize,
+                               MATREC_index missingValue){
+    assert(env);
+    assert(map);
+    map->storage = storage;
+    map->missingValue = missingValue;
+    map->keys = NULL;
+    map->values = NULL;
+    if(storage == MATREC_IDS_HASHED){
+        //Keep the load factor below one half
+        MATREC_index memSlots = 16;
+        while((MATREC_matrix_size) memSlots < 2 * expectedSize){
+            memSlots *= 2;
+        }
+        MATREC_CALL(allocateHashedSlots(env,map,memSlots));
+    }else{
+        map->memSlots = maxIndex((MATREC_index) expectedSize, 1);
+        map->numUsedSlots = 0;
+        MATREC_CALL(MATRECallocBlockArray(env,&map->values,(size_t) map->memSlots));
+        for (MATREC_index i = 0; i < map->memSlots; ++i) {
+            map->values[i] = map->missingValue;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+void MATRECidMapFree(MATREC * env, MATRECIdMap * map){
+    assert(env);
+    assert(map);
+    MATRECfreeBlockArray(env,&map->values);
+    if(map->keys){
+        MATRECfreeBlockArray(env,&map->keys);
+    }
+}
+
+MATREC_ERROR MATRECidMapCopy(MATREC * env, MATRECIdMap * target, const MATRECIdMap * source){
+    assert(env);
+    assert(target);
+    assert(source);
+    assert(target->storage == source->storage);
+    if(target->memSlots != source->memSlots){
+        MATREC_CALL(MATRECreallocBlockArray(env,&target->values,(size_t) source->memSlots));
+        if(source->storage == MATREC_IDS_HASHED){
+            MATREC_CALL(MATRECreallocBlockArray(env,&target->keys,(size_t) source->memSlots));
+        }
+        target->memSlots = source->memSlots;
+    }
+    memcpy(target->values,source->values,(size_t) source->memSlots * sizeof(MATREC_index));
+    if(source->storage == MATREC_IDS_HASHED){
+        memcpy(target->keys,source->keys,(size_t) source->memSlots * sizeof(MATREC_index));
+    }
+    target->numUsedSlots = source->numUsedSlots;
+    target->missingValue = source->missingValue;
+    return MATREC_OKAY;
+}
+
+void MATRECidMapClear(MATRECIdMap * map){
+    assert(map);
+    if(map->storage == MATREC_IDS_HASHED){
+        if(map->numUsedSlots == 0){
+            return;
+        }
+        for (MATREC_index i = 0; i < map->memSlots; ++i) {
+            map->keys[i] = IDMAP_EMPTY_KEY;
+        }
+        map->numUsedSlots = 0;
+        return;
+    }
+    for (MATREC_index i = 0; i < map->memSlots; ++i) {
+        map->values[i] = map->missingValue;
+    }
+    map->numUsedSlots = 0;
+}
+
+MATREC_index MATRECidMapGet(const MATRECIdMap * map, MATREC_matrix_size id){
+    assert(map);
+    if(map->storage == MATREC_IDS_HASHED){
+        MATREC_index slot = findSlot(map,id);
+        return map->keys[slot] == IDMAP_EMPTY_KEY ? map->missingValue : map->values[slot];
+    }
+    if(id >= (MATREC_matrix_size) map->memSlots){
+        return map->missingValue;
+    }
+    return map->values[id];
+}
+
+void MATRECidMapGetMany(const MATRECIdMap * map, const MATREC_matrix_size * ids, size_t numIds, MATREC_index * values){
+    assert(map);
+    if(map->storage == MATREC_IDS_HASHED){
+        for (size_t i = 0; i < numIds; ++i) {
+            values[i] = MATRECidMapGet(map,ids[i]);
+        }
+        return;
+    }
+    MATRECkernelGather(map->values,map->memSlots,ids,numIds,map->missingValue,values);
+}
+
+MATREC_ERROR MATRECidMapSet(MATREC * env, MATRECIdMap * map, MATREC_matrix_size id, MATREC_index value){
+    assert(map);
+    assert(value != map->missingValue);
+    assert(id <= (MATREC_matrix_size) MATREC_INDEX_MAX);
+    if(map->storage == MATREC_IDS_HASHED){
+        MATREC_index slot = findSlot(map,id);
+        if(map->keys[slot] == IDMAP_EMPTY_KEY){
+            if(2 * (map->numUsedSlots + 1) > map->memSlots){
+                MATREC_CALL(growHashed(env,map));
+                slot = findSlot(map,id);
+            }
+            map->keys[slot] = (MATREC_index) id;
+            ++map->numUsedSlots;
+        }
+        map->values[slot] = value;
+        return MATREC_OKAY;
+    }
+    if(id >= (MATREC_matrix_size) map->memSlots){
+        MATREC_CALL(growDense(env,map,id));
+    }
+    if(map->values[id] == map->missingValue){
+        ++map->numUsedSlots;
+    }
+    map->values[id] = value;
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECidMapShrink(MATREC * env, MATRECIdMap * map){
+    assert(env);
+    assert(map);
+    if(map->storage == MATREC_IDS_HASHED){
+        MATREC_index memSlots = 16;
+        while(memSlots < 2 * map->numUsedSlots){
+            memSlots *= 2;
+        }
+        if(memSlots < map->memSlots){
+            MATREC_CALL(rehash(env,map,memSlots));
+        }
+        return MATREC_OKAY;
+    }
+    MATREC_index memSlots = map->memSlots;
+    while(memSlots > 1 && map->values[memSlots - 1] == map->missingValue){
+        --memSlots;
+    }
+    if(memSlots < map->memSlots){
+        MATREC_CALL(MATRECreallocBlockArray(env,&map->values,(size_t) memSlots));
+        map->memSlots = memSlots;
+    }
+    return MATREC_OKAY;
+}
+
+void MATRECidMapMemory(const MATRECIdMap * map, const char * name, MATRECMemoryReport * report){
+    assert(map);
+    size_t slotSize = map->storage == MATREC_IDS_HASHED ? 2 * sizeof(MATREC_index) : sizeof(MATREC_index);
+    MATRECmemoryReportAdd(report, name, slotSize, map->memSlots, map->numUsedSlots);
+}
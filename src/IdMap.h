@@ -0,0 +1,46 @@
+#ifndef MATREC_IDMAP_H
+#define MATREC_IDMAP_H
+
+#include "matrec/Shared.h"
+#include "Memory.h"
+
+///Maps row or column indices to indices within a decomposition. Not part of the public interface.
+///In dense storage, the map is an array indexed by the id, which grows on demand to fit the largest id that is set.
+///In hashed storage, the map is an open addressing hash table with linear probing, so that the used memory is
+///proportional to the number of ids that are set, rather than to the largest id.
+typedef struct {
+    MATRECIdStorage storage;
+    MATREC_index memSlots; ///In hashed storage, always a power of two
+    MATREC_index numUsedSlots; ///Number of ids which are set
+    MATREC_index * keys; ///Only used in hashed storage, -1 marks an empty slot
+    MATREC_index * values;
+    MATREC_index missingValue; ///Returned for ids which were never set
+} MATRECIdMap;
+
+MATREC_ERROR MATRECidMapCreate(MATREC * env, MATRECIdMap * map, MATRECIdStorage storage, MATREC_matrix_size expectedSize,
+                               MATREC_index missingValue);
+
+void MATRECidMapFree(MATREC * env, MATRECIdMap * map);
+
+///Makes target equal to source, which must use the same storage. Reuses the memory of target if it has the same size
+MATREC_ERROR MATRECidMapCopy(MATREC * env, MATRECIdMap * target, const MATRECIdMap * source);
+
+///Removes all ids from the map, but keeps the memory
+void MATRECidMapClear(MATRECIdMap * map);
+
+///Returns the missing value of the map if the id was never set
+MATREC_index MATRECidMapGet(const MATRECIdMap * map, MATREC_matrix_size id);
+
+///Looks up the values of several ids at once. In dense storage, the lookups are vectorized where possible
+void MATRECidMapGetMany(const MATRECIdMap * map, const MATREC_matrix_size * ids, size_t numIds, MATREC_index * values);
+
+///Sets the value of the given id, growing the map if necessary. The value may not be the missing value
+MATREC_ERROR MATRECidMapSet(MATREC * env, MATRECIdMap * map, MATREC_matrix_size id, MATREC_index value);
+
+///Shrinks the map to the ids which are set. On failure, the map is left unchanged
+MATREC_ERROR MATRECidMapShrink(MATREC * env, MATRECIdMap * map);
+
+///Adds the keys and values of the map to the report as one array
+void MATRECidMapMemory(const MATRECIdMap * map, const char * name, MATRECMemoryReport * report);
+
+#endif //MATREC_IDMAP_H
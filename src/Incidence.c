@@ -3,13 +3,13 @@
 typedef struct {
     bool picked;
     int numEntries;
-    int lastEntryRow;
+    MATREC_index lastEntryRow;
     int lastEntrySign;
 } ColumnInfo;
 
 typedef struct {
     int edgeSign;
-    int representative;
+    MATREC_index representative;
 } SignedUnionFindInfo;
 
 typedef struct {
@@ -23,8 +23,8 @@ struct MATRECIncidenceAdditionImpl{
 
     //Temporary storage. We allocate this once to prevent reallocations for every call
     RowComponentInfo * rowComponentInfo;
-    int * componentRepresentatives;
-    int numComponentRepresentatives;
+    MATREC_index * componentRepresentatives;
+    MATREC_index numComponentRepresentatives;
 };
 
 MATREC_ERROR MATRECcreateIncidenceAddition(MATREC* env,
@@ -82,16 +82,16 @@ void MATRECfreeIncidenceAddition(MATREC* env,
     MATRECfreeBlockArray(env,&incidenceAddition->unionFind);
     MATRECfreeBlock(env,pIncidenceAddition);
 }
-bool isNegative(int row){
+bool isNegative(MATREC_index row){
     return row < 0;
 }
 
-void findRowRepresentative(MATRECIncidenceAddition * addition, int row,
-                           int * representative, int * sign){
+void findRowRepresentative(MATRECIncidenceAddition * addition, MATREC_index row,
+                           MATREC_index * representative, int * sign){
     assert(addition);
 
-    int current = row;
-    int next;
+    MATREC_index current = row;
+    MATREC_index next;
 
     int totalSign = 1;
     //traverse down tree to find the root
@@ -100,7 +100,7 @@ void findRowRepresentative(MATRECIncidenceAddition * addition, int row,
         current = next;
     }
 
-    int root = current;
+    MATREC_index root = current;
     current = row;
 
     int currentSign = totalSign;
@@ -116,19 +116,19 @@ void findRowRepresentative(MATRECIncidenceAddition * addition, int row,
     *sign = totalSign;
 }
 
-int mergeRowRepresentatives(MATRECIncidenceAddition * addition,
-                            int first,
-                            int second,
+MATREC_index mergeRowRepresentatives(MATRECIncidenceAddition * addition,
+                            MATREC_index first,
+                            MATREC_index second,
                             int sign) {
     assert(first != second); //We cannot merge a member into itself
 
     //The rank is stored as a negative number: we decrement it making the negative number larger.
     // We want the new root to be the one with 'largest' rank, so smallest number. If they are equal, we decrement.
     //This 'rank storing' scheme is necessary to ensure the inverse ackermann time complexity
-    int firstRank = addition->unionFind[first].representative;
-    int secondRank = addition->unionFind[second].representative;
+    MATREC_index firstRank = addition->unionFind[first].representative;
+    MATREC_index secondRank = addition->unionFind[second].representative;
     if (firstRank > secondRank) {
-        int temp = first;
+        MATREC_index temp = first;
         first = second;
         second = temp;
     }
@@ -142,8 +142,8 @@ int mergeRowRepresentatives(MATRECIncidenceAddition * addition,
 }
 
 void cleanUpRowTemporaryStorage(MATRECIncidenceAddition *addition){
-    for (int i = 0; i < addition->numComponentRepresentatives; ++i) {
-        int row = addition->componentRepresentatives[i];
+    for (MATREC_index i = 0; i < addition->numComponentRepresentatives; ++i) {
+        MATREC_index row = addition->componentRepresentatives[i];
         addition->rowComponentInfo[row].numNormal = 0;
         addition->rowComponentInfo[row].numReflected = 0;
     }
@@ -170,10 +170,10 @@ bool MATRECincidenceAdditionAddRow(MATRECIncidenceAddition *addition,
         //Find to which component the columns belong (along with their signs)
         assert((addition->columnInfo[column].numEntries == 0 ) ==
         (addition->columnInfo[column].lastEntryRow == -1));
-        int componentRow = addition->columnInfo[column].lastEntryRow;
+        MATREC_index componentRow = addition->columnInfo[column].lastEntryRow;
         if(componentRow != -1){
             int rowSign;
-            int representative;
+            MATREC_index representative;
             findRowRepresentative(addition,componentRow,&representative,&rowSign);
             if(addition->rowComponentInfo[representative].numNormal == 0 &&
             addition->rowComponentInfo[representative].numReflected == 0){
@@ -191,8 +191,8 @@ bool MATRECincidenceAdditionAddRow(MATRECIncidenceAddition *addition,
             }
         }
     }
-    for (int i = 0; i < addition->numComponentRepresentatives; ++i) {
-        int representative = addition->componentRepresentatives[i];
+    for (MATREC_index i = 0; i < addition->numComponentRepresentatives; ++i) {
+        MATREC_index representative = addition->componentRepresentatives[i];
         assert(addition->rowComponentInfo[representative].numNormal > 0 ||
         addition->rowComponentInfo[representative].numReflected > 0);
         if(addition->rowComponentInfo[representative].numNormal != 0 &&
@@ -208,19 +208,19 @@ bool MATRECincidenceAdditionAddRow(MATRECIncidenceAddition *addition,
     //of the other components during merging. We do this using the following multiplier
     int rootMovedSign = 1;
 
-    int thisRepresentative = (int) row;
-    for (int i = 0; i < addition->numComponentRepresentatives; ++i) {
-        int representative = addition->componentRepresentatives[i];
+    MATREC_index thisRepresentative = (MATREC_index) row;
+    for (MATREC_index i = 0; i < addition->numComponentRepresentatives; ++i) {
+        MATREC_index representative = addition->componentRepresentatives[i];
         assert(addition->rowComponentInfo[representative].numReflected == 0 || addition->rowComponentInfo[representative].numNormal == 0);
         int sign = addition->rowComponentInfo[representative].numNormal == 0 ? -1 : 1;
         sign *= rootMovedSign;
-        int newRepresentative = mergeRowRepresentatives(addition,representative,thisRepresentative,sign);
+        MATREC_index newRepresentative = mergeRowRepresentatives(addition,representative,thisRepresentative,sign);
         if(newRepresentative != thisRepresentative){
             rootMovedSign *= addition->unionFind[thisRepresentative].edgeSign;
         }
         thisRepresentative = newRepresentative;
     }
-    int thisRow = (int) row;
+    MATREC_index thisRow = (MATREC_index) row;
     //If the row could be added;
     //fixup column information
     for(MATREC_matrix_size i = 0; i < nRowNonzeros; ++i){
@@ -240,14 +240,14 @@ bool MATRECincidenceAdditionAddColumn(MATRECIncidenceAddition * addition,
                                       MATREC_matrix_size nColumnNonzeros,
                                       const MATREC_row * columnRows,
                                       const int * columnValues) {
-    int entryRowRepresentative[2];
-    int entryRow = -1;
+    MATREC_index entryRowRepresentative[2];
+    MATREC_index entryRow = -1;
     int entrySign = 0;
 
     int signSum = 0;
     int numEntries = 0;
     for (MATREC_matrix_size i = 0; i < nColumnNonzeros; ++i) {
-        int row = (int) columnRows[i];
+        MATREC_index row = (MATREC_index) columnRows[i];
         if(!addition->rowPicked[row]) continue;
 
         if(numEntries >= 2){
@@ -312,7 +312,8 @@ bool MATRECincidenceContainsRow(MATRECIncidenceAddition * addition, MATREC_row r
 
 ///Returns 1 if the row is not in the incidence submatrix
 int MATRECincidenceRowSign(MATRECIncidenceAddition * addition, MATREC_row row){
-    int sign, representative;
-    findRowRepresentative(addition,(int) row,&representative,&sign);
+    int sign;
+    MATREC_index representative;
+    findRowRepresentative(addition,(MATREC_index) row,&representative,&sign);
     return sign;
 }
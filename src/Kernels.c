@@ -0,0 +1,233 @@
+#include "Kernels.h"
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(MATREC_NO_SIMD)
+#define MATREC_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+static bool allTernaryScalar(const int * values, size_t numValues){
+    for (size_t i = 0; i < numValues; ++i) {
+        if(!(values[i] == 1 || values[i] == -1)){
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool allOneScalar(const int * values, size_t numValues){
+    for (size_t i = 0; i < numValues; ++i) {
+        if(values[i] != 1){
+            return false;
+        }
+    }
+    return true;
+}
+
+static void gatherScalar(const MATREC_index * table, MATREC_index tableSize, const MATREC_matrix_size * ids,
+                         size_t numIds, MATREC_index missing, MATREC_index * result){
+    for (size_t i = 0; i < numIds; ++i) {
+        result[i] = ids[i] < (MATREC_matrix_size) tableSize ? table[ids[i]] : missing;
+    }
+}
+
+#ifdef MATREC_X86_KERNELS
+
+typedef enum {
+    KERNELS_SCALAR,
+    KERNELS_AVX2,
+    KERNELS_AVX512
+} KernelLevel;
+
+static KernelLevel kernelLevel(void){
+    if(__builtin_cpu_supports("avx512f")){
+        return KERNELS_AVX512;
+    }
+    if(__builtin_cpu_supports("avx2")){
+        return KERNELS_AVX2;
+    }
+    return KERNELS_SCALAR;
+}
+
+__attribute__((target("avx2")))
+static bool allTernaryAVX2(const int * values, size_t numValues){
+    const __m256i ones = _mm256_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 8 <= numValues; i += 8) {
+        __m256i block = _mm256_abs_epi32(_mm256_loadu_si256((const __m256i *) &values[i]));
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(block,ones)) != -1){
+            return false;
+        }
+    }
+    return allTernaryScalar(&values[i],numValues - i);
+}
+
+__attribute__((target("avx512f")))
+static bool allTernaryAVX512(const int * values, size_t numValues){
+    const __m512i ones = _mm512_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 16 <= numValues; i += 16) {
+        __m512i block = _mm512_abs_epi32(_mm512_loadu_si512((const void *) &values[i]));
+        if(_mm512_cmpneq_epi32_mask(block,ones) != 0){
+            return false;
+        }
+    }
+    return allTernaryScalar(&values[i],numValues - i);
+}
+
+__attribute__((target("avx2")))
+static bool allOneAVX2(const int * values, size_t numValues){
+    const __m256i ones = _mm256_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 8 <= numValues; i += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) &values[i]);
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(block,ones)) != -1){
+            return false;
+        }
+    }
+    return allOneScalar(&values[i],numValues - i);
+}
+
+__attribute__((target("avx512f")))
+static bool allOneAVX512(const int * values, size_t numValues){
+    const __m512i ones = _mm512_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 16 <= numValues; i += 16) {
+        __m512i block = _mm512_loadu_si512((const void *) &values[i]);
+        if(_mm512_cmpneq_epi32_mask(block,ones) != 0){
+            return false;
+        }
+    }
+    return allOneScalar(&values[i],numValues - i);
+}
+
+#if MATREC_INDEX_WIDTH == 32
+
+__attribute__((target("avx2")))
+static void gatherAVX2(const MATREC_index * table, MATREC_index tableSize, const MATREC_matrix_size * ids,
+                       size_t numIds, MATREC_index missing, MATREC_index * result){
+    //Flipping the sign bits turns the signed comparison into an unsigned one
+    const __m256i signBits = _mm256_set1_epi32(INT32_MIN);
+    const __m256i size = _mm256_xor_si256(_mm256_set1_epi32(tableSize),signBits);
+    const __m256i missingValues = _mm256_set1_epi32(missing);
+    size_t i = 0;
+    for (; i + 8 <= numIds; i += 8) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) &ids[i]);
+        __m256i inTable = _mm256_cmpgt_epi32(size,_mm256_xor_si256(block,signBits));
+        __m256i values = _mm256_mask_i32gather_epi32(missingValues,(const int *) table,block,inTable,4);
+        _mm256_storeu_si256((__m256i *) &result[i],values);
+    }
+    gatherScalar(table,tableSize,&ids[i],numIds - i,missing,&result[i]);
+}
+
+__attribute__((target("avx512f")))
+static void gatherAVX512(const MATREC_index * table, MATREC_index tableSize, const MATREC_matrix_size * ids,
+                         size_t numIds, MATREC_index missing, MATREC_index * result){
+    const __m512i size = _mm512_set1_epi32(tableSize);
+    const __m512i missingValues = _mm512_set1_epi32(missing);
+    size_t i = 0;
+    for (; i + 16 <= numIds; i += 16) {
+        __m512i block = _mm512_loadu_si512((const void *) &ids[i]);
+        __mmask16 inTable = _mm512_cmplt_epu32_mask(block,size);
+        //Without optimization, GCC defines the gather as a macro which converts the mask to short internally
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+        __m512i values = _mm512_mask_i32gather_epi32(missingValues,inTable,block,(const void *) table,4);
+#pragma GCC diagnostic pop
+        _mm512_storeu_si512((void *) &result[i],values);
+    }
+    gatherScalar(table,tableSize,&ids[i],numIds - i,missing,&result[i]);
+}
+
+#else
+
+__attribute__((target("avx2")))
+static void gatherAVX2(const MATREC_index * table, MATREC_index tableSize, const MATREC_matrix_size * ids,
+                       size_t numIds, MATREC_index missing, MATREC_index * result){
+    //Flipping the sign bits turns the signed comparison into an unsigned one
+    const __m256i signBits = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i size = _mm256_xor_si256(_mm256_set1_epi64x(tableSize),signBits);
+    const __m256i missingValues = _mm256_set1_epi64x(missing);
+    size_t i = 0;
+    for (; i + 4 <= numIds; i += 4) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) &ids[i]);
+        __m256i inTable = _mm256_cmpgt_epi64(size,_mm256_xor_si256(block,signBits));
+        __m256i values = _mm256_mask_i64gather_epi64(missingValues,(const long long *) table,block,inTable,8);
+        _mm256_storeu_si256((__m256i *) &result[i],values);
+    }
+    gatherScalar(table,tableSize,&ids[i],numIds - i,missing,&result[i]);
+}
+
+__attribute__((target("avx512f")))
+static void gatherAVX512(const MATREC_index * table, MATREC_index tableSize, const MATREC_matrix_size * ids,
+                         size_t numIds, MATREC_index missing, MATREC_index * result){
+    const __m512i size = _mm512_set1_epi64(tableSize);
+    const __m512i missingValues = _mm512_set1_epi64(missing);
+    size_t i = 0;
+    for (; i + 8 <= numIds; i += 8) {
+        __m512i block = _mm512_loadu_si512((const void *) &ids[i]);
+        __mmask8 inTable = _mm512_cmplt_epu64_mask(block,size);
+        //Without optimization, GCC defines the gather as a macro which converts the mask to char internally
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+        __m512i values = _mm512_mask_i64gather_epi64(missingValues,inTable,block,(const void *) table,8);
+#pragma GCC diagnostic pop
+        _mm512_storeu_si512((void *) &result[i],values);
+    }
+    gatherScalar(table,tableSize,&ids[i],numIds - i,missing,&result[i]);
+}
+
+#endif
+
+#endif
+
+bool MATRECkernelAllTernary(const int * values, size_t numValues){
+    assert(values || numValues == 0);
+#ifdef MATREC_X86_KERNELS
+    switch(kernelLevel()){
+        case KERNELS_AVX512:
+            return allTernaryAVX512(values,numValues);
+        case KERNELS_AVX2:
+            return allTernaryAVX2(values,numValues);
+        case KERNELS_SCALAR:
+            break;
+    }
+#endif
+    return allTernaryScalar(values,numValues);
+}
+
+bool MATRECkernelAllOne(const int * values, size_t numValues){
+    assert(values || numValues == 0);
+#ifdef MATREC_X86_KERNELS
+    switch(kernelLevel()){
+        case KERNELS_AVX512:
+            return allOneAVX512(values,numValues);
+        case KERNELS_AVX2:
+            return allOneAVX2(values,numValues);
+        case KERNELS_SCALAR:
+            break;
+    }
+#endif
+    return allOneScalar(values,numValues);
+}
+
+void MATRECkernelGather(const MATREC_index * table, MATREC_index tableSize, const MATREC_matrix_size * ids,
+                        size_t numIds, MATREC_index missing, MATREC_index * result){
+    assert(table || tableSize == 0);
+    assert(ids || numIds == 0);
+    assert(result || numIds == 0);
+#ifdef MATREC_X86_KERNELS
+    if(tableSize > 0){
+        switch(kernelLevel()){
+            case KERNELS_AVX512:
+                gatherAVX512(table,tableSize,ids,numIds,missing,result);
+                return;
+            case KERNELS_AVX2:
+                gatherAVX2(table,tableSize,ids,numIds,missing,result);
+                return;
+            case KERNELS_SCALAR:
+                break;
+        }
+    }
+#endif
+    gatherScalar(table,tableSize,ids,numIds,missing,result);
+}
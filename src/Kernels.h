@@ -0,0 +1,20 @@
+#ifndef MATREC_KERNELS_H
+#define MATREC_KERNELS_H
+
+#include "matrec/Shared.h"
+
+///Loops over the nonzeros of a matrix or of a new row or column. Not part of the public interface.
+///On x86-64, AVX-512 and AVX2 versions are selected at runtime depending on the processor, and a scalar version is
+///used otherwise. All versions give identical results. Defining MATREC_NO_SIMD disables the vectorized versions.
+
+///Returns true if every value is 1 or -1
+bool MATRECkernelAllTernary(const int * values, size_t numValues);
+
+///Returns true if every value is 1
+bool MATRECkernelAllOne(const int * values, size_t numValues);
+
+///Sets result[i] to table[ids[i]] if ids[i] < tableSize, and to missing otherwise
+void MATRECkernelGather(const MATREC_index * table, MATREC_index tableSize, const MATREC_matrix_size * ids,
+                        size_t numIds, MATREC_index missing, MATREC_index * result);
+
+#endif //MATREC_KERNELS_H
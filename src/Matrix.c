@@ -1,4 +1,5 @@
 #include "matrec/Matrix.h"
+#include "Kernels.h"
 
 bool MATRECrowIsInvalid(MATREC_row row){
     return row == MATREC_INVALID_ROW;
@@ -13,6 +14,28 @@ bool MATRECcolIsValid(MATREC_col col){
     return !MATRECcolIsInvalid(col);
 }
 
+bool MATRECpackSigns(const double * values, MATREC_matrix_size numValues, double tolerance, uint64_t * negativeBits){
+    assert(numValues == 0 || (values && negativeBits));
+    //The inner loop is branch-free, so that compilers can vectorize it
+    bool isSign = true;
+    for (size_t start = 0; start < numValues; start += 64) {
+        size_t blockSize = numValues - start < 64 ? numValues - start : 64;
+        const double * block = &values[start];
+        uint64_t word = 0;
+        bool blockIsSign = true;
+        for (size_t i = 0; i < blockSize; ++i) {
+            double value = block[i];
+            bool negative = value < 0.0;
+            double magnitude = negative ? -value : value;
+            word |= (uint64_t) negative << i;
+            blockIsSign &= (magnitude - 1.0 <= tolerance) & (1.0 - magnitude <= tolerance);
+        }
+        negativeBits[start / 64] = word;
+        isSign &= blockIsSign;
+    }
+    return isSign;
+}
+
 MATREC_ERROR MATRECcreateSubMatrix(
         MATREC* env,
         MATREC_matrix_size numRows,
@@ -61,12 +84,12 @@ void MATRECwriteSubMatrixToStream(
     assert(submatrix);
     assert(stream);
 
-    fprintf(stream, "%lu %lu %lu %lu\n", numRows, numColumns, submatrix->numRows, submatrix->numColumns);
+    fprintf(stream, "%" MATREC_PRIsize " %" MATREC_PRIsize " %" MATREC_PRIsize " %" MATREC_PRIsize "\n", numRows, numColumns, submatrix->numRows, submatrix->numColumns);
     for (MATREC_matrix_size row = 0; row < submatrix->numRows; ++row)
-        fprintf(stream, "%lu ", submatrix->rows[row] + 1);
+        fprintf(stream, "%" MATREC_PRIsize " ", submatrix->rows[row] + 1);
     fputc('\n', stream);
     for (MATREC_matrix_size column = 0; column < submatrix->numColumns; ++column)
-        fprintf(stream, "%lu ", submatrix->columns[column] + 1);
+        fprintf(stream, "%" MATREC_PRIsize " ", submatrix->columns[column] + 1);
     fputc('\n', stream);
 }
 
@@ -85,7 +108,7 @@ MATREC_ERROR MATRECreadSubMatrixFromStream(
     MATREC_matrix_size numOriginalColumns;
     MATREC_matrix_size numRows;
     MATREC_matrix_size numColumns;
-    if (fscanf(stream, "%lu %lu %lu %lu", &numOriginalRows, &numOriginalColumns, &numRows, &numColumns) != 4)
+    if (fscanf(stream, "%" MATREC_SCNsize " %" MATREC_SCNsize " %" MATREC_SCNsize " %" MATREC_SCNsize, &numOriginalRows, &numOriginalColumns, &numRows, &numColumns) != 4)
         return MATREC_ERROR_INPUT;
 
     if (numRows > numOriginalRows || numColumns > numOriginalColumns)
@@ -96,7 +119,7 @@ MATREC_ERROR MATRECreadSubMatrixFromStream(
     for (MATREC_matrix_size r = 0; r < numRows; ++r)
     {
         MATREC_matrix_size row;
-        int numRead = fscanf(stream, "%lu", &row);
+        int numRead = fscanf(stream, "%" MATREC_SCNsize, &row);
         if (numRead != 1)
             return MATREC_ERROR_INPUT;
         submatrix->rows[r] = row - 1;
@@ -104,7 +127,7 @@ MATREC_ERROR MATRECreadSubMatrixFromStream(
     for (MATREC_matrix_size c = 0; c < numColumns; ++c)
     {
         MATREC_matrix_size col;
-        int numRead = fscanf(stream, "%lu", &col);
+        int numRead = fscanf(stream, "%" MATREC_SCNsize, &col);
         if (numRead != 1)
             return MATREC_ERROR_INPUT;
         submatrix->columns[c] = col - 1;
@@ -239,36 +262,24 @@ void MATRECfreeIntMatrixPair(MATREC * env, MATRECCompressedSparseMatrixPairInt *
 }
 
 bool MATRECintMatrixIsTernary(const MATRECCSMatrixInt * matrix){
-    for(MATREC_matrix_size i = 0; i < matrix->numNonzeros; i++){
-        int value = matrix->entryValues[i];
-        if(!(value == 1 || value == -1)){
-            return false;
-        }
-    }
-    return true;
+    return MATRECkernelAllTernary(matrix->entryValues,(size_t) matrix->numNonzeros);
 }
 
 bool MATRECintMatrixIsBinary(const MATRECCSMatrixInt * matrix){
-    for(MATREC_matrix_size i = 0; i < matrix->numNonzeros; i++){
-        int value = matrix->entryValues[i];
-        if(value != 1){
-            return false;
-        }
-    }
-    return true;
+    return MATRECkernelAllOne(matrix->entryValues,(size_t) matrix->numNonzeros);
 }
 
 void MATRECwriteIntMatrixToStream(const MATRECCSMatrixInt *matrix, FILE * file){
     assert(matrix);
     assert(file);
 
-    fprintf(file, "%lu %lu %lu\n\n", matrix->numRows, matrix->numColumns, matrix->numNonzeros);
+    fprintf(file, "%" MATREC_PRIsize " %" MATREC_PRIsize " %" MATREC_PRIsize "\n\n", matrix->numRows, matrix->numColumns, matrix->numNonzeros);
     for (MATREC_matrix_size row = 0; row < matrix->numRows; ++row)
     {
         MATREC_matrix_size first = matrix->firstRowIndex[row];
         MATREC_matrix_size beyond = matrix->firstRowIndex[row + 1];
         for (MATREC_matrix_size entry = first; entry < beyond; ++entry){
-            fprintf(file, "%lu %lu %d\n", row+1, matrix->entryColumns[entry] + 1, matrix->entryValues[entry]);
+            fprintf(file, "%" MATREC_PRIsize " %" MATREC_PRIsize " %d\n", row+1, matrix->entryColumns[entry] + 1, matrix->entryValues[entry]);
         }
     }
 }
@@ -299,7 +310,7 @@ MATREC_ERROR MATRECreadIntMatrixFromStream(MATREC* env, MATRECCSMatrixInt ** pre
     assert(stream);
 
     MATREC_matrix_size numRows, numColumns, numNonzeros;
-    int numRead = fscanf(stream, "%lu %lu %lu", &numRows, &numColumns, &numNonzeros);
+    int numRead = fscanf(stream, "%" MATREC_SCNsize " %" MATREC_SCNsize " %" MATREC_SCNsize, &numRows, &numColumns, &numNonzeros);
     if (numRead < 3)
     {
         return MATREC_ERROR_INPUT;
@@ -317,10 +328,10 @@ MATREC_ERROR MATRECreadIntMatrixFromStream(MATREC* env, MATRECCSMatrixInt ** pre
         MATREC_matrix_size row;
         MATREC_matrix_size column;
         int value;
-        numRead = fscanf(stream, "%lu %lu %d", &row, &column, &value);
+        numRead = fscanf(stream, "%" MATREC_SCNsize " %" MATREC_SCNsize " %d", &row, &column, &value);
         if (numRead < 3 || row == 0 || column == 0 || row > numRows || column > numColumns)
         {
-            MATRECfreeBlockArray(env,&numNonzeros);
+            MATRECfreeBlockArray(env,&nonzeros);
             return MATREC_ERROR_INPUT;
         }
         if (value != 0)
@@ -375,12 +386,12 @@ int * MATRECintMatrixRowColumnValues(MATRECCSMatrixInt * matrix,
 MATREC_matrix_size MATRECcountIntSubMatrixNonzeros(const MATRECSubMatrix* subMatrix, const MATRECCSMatrixInt *rowMatrix){
     MATREC_matrix_size nonZeros = 0;
     for (MATREC_matrix_size i = 0; i < subMatrix->numRows; ++i) {
-        MATREC_row row = (subMatrix->rows[i] - 1); //submatrix rows are stored as 1 higher!!
+        MATREC_row row = subMatrix->rows[i];
         MATREC_matrix_size matrixIndex = rowMatrix->firstRowIndex[row];
         MATREC_matrix_size matrixRowEnd = rowMatrix->firstRowIndex[row + 1];
         assert(matrixRowEnd <= rowMatrix->numNonzeros);
         for(MATREC_matrix_size subMatColIndex = 0; subMatColIndex < subMatrix->numColumns; subMatColIndex++){
-            MATREC_col subMatCol = subMatrix->columns[subMatColIndex] - 1; //submatrix columns are stored as 1 higher!!
+            MATREC_col subMatCol = subMatrix->columns[subMatColIndex];
             while(matrixIndex != matrixRowEnd &&
                   rowMatrix->entryColumns[matrixIndex] < subMatCol){
                 matrixIndex++;
@@ -399,12 +410,12 @@ MATREC_matrix_size MATRECcountIntSubMatrixNonzeros(const MATRECSubMatrix* subMat
 MATREC_matrix_size MATRECcountDoubleSubMatrixNonzeros(const MATRECSubMatrix* subMatrix, const MATRECCSMatrixDouble * rowMatrix){
     MATREC_matrix_size nonZeros = 0;
     for (MATREC_matrix_size i = 0; i < subMatrix->numRows; ++i) {
-        MATREC_row row = (subMatrix->rows[i] - 1); //submatrix rows are stored as 1 higher!!
+        MATREC_row row = subMatrix->rows[i];
         MATREC_matrix_size matrixIndex = rowMatrix->firstRowIndex[row];
         MATREC_matrix_size matrixRowEnd = rowMatrix->firstRowIndex[row + 1];
         assert(matrixRowEnd <= rowMatrix->numNonzeros);
         for(MATREC_matrix_size subMatColIndex = 0; subMatColIndex < subMatrix->numColumns; subMatColIndex++){
-            MATREC_col subMatCol = subMatrix->columns[subMatColIndex] - 1; //submatrix columns are stored as 1 higher!!
+            MATREC_col subMatCol = subMatrix->columns[subMatColIndex];
             while(matrixIndex != matrixRowEnd &&
                   rowMatrix->entryColumns[matrixIndex] < subMatCol){
                 matrixIndex++;
@@ -420,6 +431,71 @@ MATREC_matrix_size MATRECcountDoubleSubMatrixNonzeros(const MATRECSubMatrix* sub
     return nonZeros;
 }
 
+static void setBit(uint64_t * bits, MATREC_matrix_size index){
+    bits[index / 64] |= (uint64_t) 1 << (index % 64);
+}
+
+static bool bitIsSet(const uint64_t * bits, MATREC_matrix_size index){
+    return (bits[index / 64] >> (index % 64)) & 1;
+}
+
+///Counts the nonzeros in the given rows of a row matrix whose column is marked, so that each nonzero is filtered in
+///constant time
+static MATREC_matrix_size countMarkedNonzeros(const MATRECSubMatrix * subMatrix, const MATREC_matrix_size * firstRowIndex,
+                                              const MATREC_matrix_size * entryColumns, const uint64_t * columnMarks){
+    MATREC_matrix_size nonZeros = 0;
+    for (MATREC_matrix_size i = 0; i < subMatrix->numRows; ++i) {
+        MATREC_row row = subMatrix->rows[i];
+        for (MATREC_matrix_size index = firstRowIndex[row]; index < firstRowIndex[row + 1]; ++index) {
+            if(bitIsSet(columnMarks, entryColumns[index])){
+                nonZeros++;
+            }
+        }
+    }
+    return nonZeros;
+}
+
+static void markColumns(const MATRECSubMatrix * subMatrix, MATREC_matrix_size numColumns, uint64_t * columnMarks){
+    for (MATREC_matrix_size i = 0; i < subMatrix->numColumns; ++i) {
+        assert(subMatrix->columns[i] < numColumns);
+        assert(!bitIsSet(columnMarks, subMatrix->columns[i]));
+        setBit(columnMarks, subMatrix->columns[i]);
+    }
+    (void) numColumns;
+}
+
+///Clears the words of the marked columns, so that the marks can be reused without clearing all of them
+static void unmarkColumns(const MATRECSubMatrix * subMatrix, uint64_t * columnMarks){
+    for (MATREC_matrix_size i = 0; i < subMatrix->numColumns; ++i) {
+        columnMarks[subMatrix->columns[i] / 64] = 0;
+    }
+}
+
+MATREC_matrix_size MATRECcountIntSubMatrixNonzerosMarked(const MATRECSubMatrix* subMatrix,
+                                                         const MATRECCSMatrixInt *rowMatrix, uint64_t * columnMarks){
+    assert(subMatrix);
+    assert(rowMatrix);
+    assert(columnMarks);
+    markColumns(subMatrix, rowMatrix->numColumns, columnMarks);
+    MATREC_matrix_size nonZeros = countMarkedNonzeros(subMatrix, rowMatrix->firstRowIndex, rowMatrix->entryColumns,
+                                                      columnMarks);
+    unmarkColumns(subMatrix, columnMarks);
+    return nonZeros;
+}
+
+MATREC_matrix_size MATRECcountDoubleSubMatrixNonzerosMarked(const MATRECSubMatrix* subMatrix,
+                                                            const MATRECCSMatrixDouble *rowMatrix,
+                                                            uint64_t * columnMarks){
+    assert(subMatrix);
+    assert(rowMatrix);
+    assert(columnMarks);
+    markColumns(subMatrix, rowMatrix->numColumns, columnMarks);
+    MATREC_matrix_size nonZeros = countMarkedNonzeros(subMatrix, rowMatrix->firstRowIndex, rowMatrix->entryColumns,
+                                                      columnMarks);
+    unmarkColumns(subMatrix, columnMarks);
+    return nonZeros;
+}
+
 MATREC_ERROR MATRECcreateDoubleMatrix(MATREC *env, MATRECCSMatrixDouble **pmat,
                                       MATREC_matrix_size numRows, MATREC_matrix_size numColumns, MATREC_matrix_size numNonzeros){
     assert(env);
@@ -550,13 +626,13 @@ void MATRECwriteDoubleMatrixToStream(const MATRECCSMatrixDouble * matrix, FILE *
     assert(matrix);
     assert(file);
 
-    fprintf(file, "%lu %lu %lu\n\n", matrix->numRows, matrix->numColumns, matrix->numNonzeros);
+    fprintf(file, "%" MATREC_PRIsize " %" MATREC_PRIsize " %" MATREC_PRIsize "\n\n", matrix->numRows, matrix->numColumns, matrix->numNonzeros);
     for (MATREC_matrix_size row = 0; row < matrix->numRows; ++row)
     {
         MATREC_matrix_size first = matrix->firstRowIndex[row];
         MATREC_matrix_size beyond = matrix->firstRowIndex[row + 1];
         for (MATREC_matrix_size entry = first; entry < beyond; ++entry){
-            fprintf(file, "%lu %lu %lf\n", row+1, matrix->entryColumns[entry] + 1, matrix->entryValues[entry]);
+            fprintf(file, "%" MATREC_PRIsize " %" MATREC_PRIsize " %lf\n", row+1, matrix->entryColumns[entry] + 1, matrix->entryValues[entry]);
         }
     }
 }
@@ -595,7 +671,7 @@ MATREC_ERROR MATRECreadDoubleMatrixFromStream(MATREC* env, MATRECCSMatrixDouble
     assert(stream);
 
     MATREC_matrix_size numRows, numColumns, numNonzeros;
-    int numRead = fscanf(stream, "%lu %lu %lu", &numRows, &numColumns, &numNonzeros);
+    int numRead = fscanf(stream, "%" MATREC_SCNsize " %" MATREC_SCNsize " %" MATREC_SCNsize, &numRows, &numColumns, &numNonzeros);
     if (numRead < 3)
     {
         return MATREC_ERROR_INPUT;
@@ -617,13 +693,13 @@ MATREC_ERROR MATRECreadDoubleMatrixFromStream(MATREC* env, MATRECCSMatrixDouble
         MATREC_matrix_size column;
         double value;
         numRead = fscanf(stream, "%s %s %s", rowString, colString, valueString);
-        numRead += sscanf(rowString,"%lu",&row);
-        numRead += sscanf(colString,"%lu",&column);
+        numRead += sscanf(rowString,"%" MATREC_SCNsize,&row);
+        numRead += sscanf(colString,"%" MATREC_SCNsize,&column);
         value =  strtod(valueString,NULL);
 
         if (numRead < 5  || row == 0 || column == 0 || row > numRows || column > numColumns)
         {
-            MATRECfreeBlockArray(env,&numNonzeros);
+            MATRECfreeBlockArray(env,&nonzeros);
             return MATREC_ERROR_INPUT;
         }
         if (value != 0)
@@ -637,7 +713,7 @@ MATREC_ERROR MATRECreadDoubleMatrixFromStream(MATREC* env, MATRECCSMatrixDouble
     numNonzeros = entry;
 
     /* We sort all nonzeros by row and then by column. */
-    qsort(nonzeros, numNonzeros, sizeof(MATRECIntMatrixTriplet), compareIntNonzeros);
+    qsort(nonzeros, numNonzeros, sizeof(MATRECMatrixTripletDouble), compareIntNonzeros);
 
     MATREC_CALL(MATRECcreateDoubleMatrixWithNonzeros(env, presult, numRows, numColumns, numNonzeros, nonzeros));
 
@@ -0,0 +1,36 @@
+#include "Memory.h"
+
+void MATRECmemoryReportInit(MATRECMemoryReport * report){
+    assert(report);
+    report->allocatedBytes = 0;
+    report->usedBytes = 0;
+    report->peakBytes = 0;
+    report->numArrays = 0;
+}
+
+void MATRECmemoryReportAddBytes(MATRECMemoryReport * report, const char * name, size_t allocatedBytes,
+                                size_t usedBytes){
+    assert(report);
+    assert(usedBytes <= allocatedBytes);
+    report->allocatedBytes += allocatedBytes;
+    report->usedBytes += usedBytes;
+    assert(report->numArrays < MATREC_MEMORY_MAX_ARRAYS);
+    if(report->numArrays < MATREC_MEMORY_MAX_ARRAYS){
+        MATRECArrayMemory * array = &report->arrays[report->numArrays];
+        array->name = name;
+        array->allocatedBytes = allocatedBytes;
+        array->usedBytes = usedBytes;
+        ++report->numArrays;
+    }
+}
+
+void MATRECmemoryReportAdd(MATRECMemoryReport * report, const char * name, size_t elementSize,
+                           MATREC_index numAllocated, MATREC_index numUsed){
+    assert(numAllocated >= 0 && numUsed >= 0);
+    MATRECmemoryReportAddBytes(report, name, elementSize * (size_t) numAllocated, elementSize * (size_t) numUsed);
+}
+
+void MATRECmemoryReportFinish(MATRECMemoryReport * report, size_t recordedPeakBytes){
+    assert(report);
+    report->peakBytes = report->allocatedBytes > recordedPeakBytes ? report->allocatedBytes : recordedPeakBytes;
+}
@@ -0,0 +1,23 @@
+#ifndef MATREC_MEMORY_H
+#define MATREC_MEMORY_H
+
+#include "matrec/Shared.h"
+
+///Helpers to fill in memory reports of decompositions and additions. Not part of the public interface.
+///The arrays of the objects only grow until they are explicitly shrunk, so the peak memory of an object is the largest
+///of its current allocation and the allocations just before it was shrunk, which the objects record themselves.
+
+void MATRECmemoryReportInit(MATRECMemoryReport * report);
+
+///Adds an array with the given number of allocated and used elements to the report
+void MATRECmemoryReportAdd(MATRECMemoryReport * report, const char * name, size_t elementSize,
+                           MATREC_index numAllocated, MATREC_index numUsed);
+
+///Adds an array with the given number of allocated and used bytes to the report
+void MATRECmemoryReportAddBytes(MATRECMemoryReport * report, const char * name, size_t allocatedBytes,
+                                size_t usedBytes);
+
+///Sets the peak of the report, given the largest allocation that the object recorded
+void MATRECmemoryReportFinish(MATRECMemoryReport * report, size_t recordedPeakBytes);
+
+#endif //MATREC_MEMORY_H
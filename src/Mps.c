@@ -0,0 +1,712 @@
+#include "matrec/Mps.h"
+
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+#define MPS_MAX_FIELDS 6
+
+typedef enum{
+    MPS_SECTION_NONE,
+    MPS_SECTION_ROWS,
+    MPS_SECTION_COLUMNS,
+    MPS_SECTION_BOUNDS,
+    MPS_SECTION_SKIP, ///Sections which we do not need, such as RHS and RANGES
+    MPS_SECTION_ENDATA
+} MpsSection;
+
+typedef struct{
+    size_t nameOffset;
+    MATREC_matrix_size index; ///MATREC_INVALID if the slot is empty
+} MpsNameEntry;
+
+///Open addressing hash table mapping names to row or column indices
+typedef struct{
+    MpsNameEntry * entries;
+    size_t memEntries; ///Always a power of two
+    size_t numEntries;
+} MpsNameTable;
+
+typedef struct{
+    MATREC * env;
+    FILE * stream;
+    MATRECMpsFormat format;
+    int parts;
+
+    char * line;
+    size_t memLine;
+    char * fields[MPS_MAX_FIELDS];
+    int numFields;
+
+    char * names;
+    size_t numNameChars;
+    size_t memNameChars;
+    size_t modelNameOffset;
+
+    bool readRows;
+    MpsNameTable rowTable;
+    size_t * rowNameOffsets;
+    char * rowTypes;
+    MATREC_row * rowConstraint; ///Index of the row in the constraint matrix, or MATREC_INVALID for free rows
+    MATREC_col * rowLastColumn; ///Last column with an entry in the row, used to detect duplicate entries
+    MATREC_matrix_size numRows;
+    MATREC_matrix_size memRows;
+    MATREC_matrix_size numConstraints;
+    MATREC_row objectiveRow;
+
+    MpsNameTable columnTable;
+    size_t * columnNameOffsets;
+    MATREC_matrix_size * columnStart;
+    double * objective;
+    bool * isInteger;
+    double * lowerBounds;
+    double * upperBounds;
+    MATREC_matrix_size numColumns;
+    MATREC_matrix_size memColumns;
+    bool inIntegerMarker;
+
+    MATREC_row * entryRows;
+    double * entryValues;
+    MATREC_matrix_size numEntries;
+    MATREC_matrix_size memEntries;
+} MpsReader;
+
+static size_t maxSize(size_t a, size_t b){
+    return a > b ? a : b;
+}
+
+static MATREC_matrix_size maxMatrixSize(MATREC_matrix_size a, MATREC_matrix_size b){
+    return a > b ? a : b;
+}
+
+static uint64_t hashName(const char * name){
+    //FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for(const char * c = name; *c != '\0'; ++c){
+        hash ^= (uint64_t) (unsigned char) *c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static MATREC_ERROR nameTableCreate(MATREC * env, MpsNameTable * table){
+    table->memEntries = 64;
+    table->numEntries = 0;
+    table->entries = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&table->entries,table->memEntries));
+    for (size_t i = 0; i < table->memEntries; ++i) {
+        table->entries[i].index = MATREC_INVALID;
+    }
+    return MATREC_OKAY;
+}
+
+static void nameTableFree(MATREC * env, MpsNameTable * table){
+    if(table->entries){
+        MATRECfreeBlockArray(env,&table->entries);
+    }
+}
+
+///Returns the slot of the name, or the empty slot where it should be inserted
+static size_t nameTableFindSlot(const MpsNameTable * table, const char * names, const char * name){
+    size_t mask = table->memEntries - 1;
+    size_t slot = (size_t) hashName(name) & mask;
+    while(table->entries[slot].index != MATREC_INVALID &&
+          strcmp(names + table->entries[slot].nameOffset,name) != 0){
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static MATREC_matrix_size nameTableFind(const MpsNameTable * table, const char * names, const char * name){
+    return table->entries[nameTableFindSlot(table,names,name)].index;
+}
+
+static MATREC_ERROR nameTableInsert(MATREC * env, MpsNameTable * table, const char * names,
+                                    size_t nameOffset, MATREC_matrix_size index){
+    if(2 * (table->numEntries + 1) > table->memEntries){
+        MpsNameEntry * oldEntries = table->entries;
+        size_t oldMemEntries = table->memEntries;
+        table->memEntries *= 2;
+        table->entries = NULL;
+        MATREC_CALL(MATRECallocBlockArray(env,&table->entries,table->memEntries));
+        for (size_t i = 0; i < table->memEntries; ++i) {
+            table->entries[i].index = MATREC_INVALID;
+        }
+        for (size_t i = 0; i < oldMemEntries; ++i) {
+            if(oldEntries[i].index != MATREC_INVALID){
+                size_t slot = nameTableFindSlot(table,names,names + oldEntries[i].nameOffset);
+                table->entries[slot] = oldEntries[i];
+            }
+        }
+        MATRECfreeBlockArray(env,&oldEntries);
+    }
+    size_t slot = nameTableFindSlot(table,names,names + nameOffset);
+    if(table->entries[slot].index != MATREC_INVALID){
+        return MATREC_ERROR_INPUT; //Duplicate name
+    }
+    table->entries[slot].nameOffset = nameOffset;
+    table->entries[slot].index = index;
+    ++table->numEntries;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR storeName(MpsReader * reader, const char * name, size_t * offset){
+    size_t length = strlen(name) + 1;
+    if(reader->numNameChars + length > reader->memNameChars){
+        reader->memNameChars = maxSize(2 * reader->memNameChars, reader->numNameChars + length);
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->names,reader->memNameChars));
+    }
+    memcpy(reader->names + reader->numNameChars,name,length);
+    *offset = reader->numNameChars;
+    reader->numNameChars += length;
+    return MATREC_OKAY;
+}
+
+static bool isSpace(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+///Removes leading and trailing whitespace in place
+static char * trim(char * string){
+    while(isSpace(*string)){
+        ++string;
+    }
+    size_t length = strlen(string);
+    while(length > 0 && isSpace(string[length - 1])){
+        --length;
+    }
+    string[length] = '\0';
+    return string;
+}
+
+static MATREC_ERROR readLine(MpsReader * reader, bool * endOfFile){
+    size_t length = 0;
+    *endOfFile = false;
+    while(true){
+        if(length + 2 > reader->memLine){
+            reader->memLine = maxSize(2 * reader->memLine, 256);
+            MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->line,reader->memLine));
+        }
+        size_t available = reader->memLine - length;
+        if(available > INT_MAX){
+            available = INT_MAX;
+        }
+        if(!fgets(reader->line + length,(int) available,reader->stream)){
+            if(length == 0){
+                *endOfFile = true;
+            }
+            break;
+        }
+        length += strlen(reader->line + length);
+        if(length > 0 && reader->line[length - 1] == '\n'){
+            break;
+        }
+    }
+    if(!*endOfFile){
+        reader->line[length] = '\0';
+    }
+    return MATREC_OKAY;
+}
+
+///Splits a data line into its nonempty fields. Free format fields are separated by whitespace, whereas fixed format
+///fields are found at fixed positions in the line and may contain spaces.
+static void splitFields(MpsReader * reader){
+    reader->numFields = 0;
+    char * line = reader->line;
+    if(reader->format == MATREC_MPS_FREE){
+        while(reader->numFields < MPS_MAX_FIELDS){
+            while(isSpace(*line)){
+                ++line;
+            }
+            if(*line == '\0'){
+                break;
+            }
+            reader->fields[reader->numFields] = line;
+            ++reader->numFields;
+            while(*line != '\0' && !isSpace(*line)){
+                ++line;
+            }
+            if(*line != '\0'){
+                *line = '\0';
+                ++line;
+            }
+        }
+        return;
+    }
+    static const size_t fieldBegin[MPS_MAX_FIELDS] = {1, 4, 14, 24, 39, 49};
+    static const size_t fieldEnd[MPS_MAX_FIELDS] = {3, 12, 22, 36, 47, 61};
+    size_t length = strlen(line);
+    char * field[MPS_MAX_FIELDS];
+    for (int i = 0; i < MPS_MAX_FIELDS; ++i) {
+        field[i] = fieldBegin[i] < length ? line + fieldBegin[i] : NULL;
+    }
+    //The characters in between the fields are not part of any field, so we can safely terminate the fields there
+    for (int i = 0; i < MPS_MAX_FIELDS; ++i) {
+        if(fieldEnd[i] < length){
+            line[fieldEnd[i]] = '\0';
+        }
+    }
+    for (int i = 0; i < MPS_MAX_FIELDS; ++i) {
+        if(!field[i]){
+            break;
+        }
+        char * trimmed = trim(field[i]);
+        if(*trimmed != '\0'){
+            reader->fields[reader->numFields] = trimmed;
+            ++reader->numFields;
+        }
+    }
+}
+
+static MATREC_ERROR parseValue(const char * string, double * value){
+    char * end = NULL;
+    *value = strtod(string,&end);
+    if(end == string || *end != '\0'){
+        return MATREC_ERROR_INPUT;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readRow(MpsReader * reader){
+    if(reader->numFields != 2 || strlen(reader->fields[0]) != 1){
+        return MATREC_ERROR_INPUT;
+    }
+    char type = reader->fields[0][0];
+    if(type != 'N' && type != 'E' && type != 'L' && type != 'G'){
+        return MATREC_ERROR_INPUT;
+    }
+    if(reader->numRows == reader->memRows){
+        reader->memRows = maxMatrixSize(2 * reader->memRows, 16);
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->rowNameOffsets,reader->memRows));
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->rowTypes,reader->memRows));
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->rowConstraint,reader->memRows));
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->rowLastColumn,reader->memRows));
+    }
+    MATREC_row row = reader->numRows;
+    size_t offset;
+    MATREC_CALL(storeName(reader,reader->fields[1],&offset));
+    MATREC_CALL(nameTableInsert(reader->env,&reader->rowTable,reader->names,offset,row));
+    reader->rowNameOffsets[row] = offset;
+    reader->rowTypes[row] = type;
+    reader->rowLastColumn[row] = MATREC_INVALID;
+    if(type == 'N'){
+        //The first free row is the objective, the other free rows are not part of the model
+        if(MATRECrowIsInvalid(reader->objectiveRow)){
+            reader->objectiveRow = row;
+        }
+        reader->rowConstraint[row] = MATREC_INVALID;
+    }else{
+        reader->rowConstraint[row] = reader->numConstraints;
+        ++reader->numConstraints;
+    }
+    ++reader->numRows;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR newColumn(MpsReader * reader, const char * name){
+    if(reader->numColumns + 1 >= reader->memColumns){
+        reader->memColumns = maxMatrixSize(2 * reader->memColumns, 16);
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->columnNameOffsets,reader->memColumns));
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->columnStart,reader->memColumns));
+        if(reader->parts & MATREC_MPS_READ_OBJECTIVE){
+            MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->objective,reader->memColumns));
+        }
+        if(reader->parts & MATREC_MPS_READ_BOUNDS){
+            MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->isInteger,reader->memColumns));
+        }
+    }
+    MATREC_col column = reader->numColumns;
+    size_t offset;
+    MATREC_CALL(storeName(reader,name,&offset));
+    MATREC_CALL(nameTableInsert(reader->env,&reader->columnTable,reader->names,offset,column));
+    reader->columnNameOffsets[column] = offset;
+    reader->columnStart[column] = reader->numEntries;
+    if(reader->objective){
+        reader->objective[column] = 0.0;
+    }
+    if(reader->isInteger){
+        reader->isInteger[column] = reader->inIntegerMarker;
+    }
+    ++reader->numColumns;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readColumnEntry(MpsReader * reader, const char * rowName, const char * valueString){
+    MATREC_row row = nameTableFind(&reader->rowTable,reader->names,rowName);
+    if(MATRECrowIsInvalid(row)){
+        return MATREC_ERROR_INPUT;
+    }
+    double value;
+    MATREC_CALL(parseValue(valueString,&value));
+    MATREC_col column = reader->numColumns - 1;
+    if(reader->rowLastColumn[row] == column){
+        return MATREC_ERROR_INPUT; //Duplicate entry
+    }
+    reader->rowLastColumn[row] = column;
+    if(row == reader->objectiveRow){
+        if(reader->objective){
+            reader->objective[column] = value;
+        }
+        return MATREC_OKAY;
+    }
+    if(MATRECrowIsInvalid(reader->rowConstraint[row]) || value == 0.0){
+        return MATREC_OKAY;
+    }
+    if(reader->numEntries == reader->memEntries){
+        reader->memEntries = maxMatrixSize(2 * reader->memEntries, 64);
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->entryRows,reader->memEntries));
+        MATREC_CALL(MATRECreallocBlockArray(reader->env,&reader->entryValues,reader->memEntries));
+    }
+    reader->entryRows[reader->numEntries] = reader->rowConstraint[row];
+    reader->entryValues[reader->numEntries] = value;
+    ++reader->numEntries;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readColumn(MpsReader * reader){
+    if(reader->numFields >= 3 && strcmp(reader->fields[1],"'MARKER'") == 0){
+        if(strcmp(reader->fields[2],"'INTORG'") == 0){
+            reader->inIntegerMarker = true;
+        }else if(strcmp(reader->fields[2],"'INTEND'") == 0){
+            reader->inIntegerMarker = false;
+        }else{
+            return MATREC_ERROR_INPUT;
+        }
+        return MATREC_OKAY;
+    }
+    if(reader->numFields != 3 && reader->numFields != 5){
+        return MATREC_ERROR_INPUT;
+    }
+    const char * name = reader->fields[0];
+    if(reader->numColumns == 0 ||
+       strcmp(reader->names + reader->columnNameOffsets[reader->numColumns - 1],name) != 0){
+        if(MATRECcolIsValid(nameTableFind(&reader->columnTable,reader->names,name))){
+            return MATREC_ERROR_INPUT; //Columns must be contiguous
+        }
+        MATREC_CALL(newColumn(reader,name));
+    }
+    MATREC_CALL(readColumnEntry(reader,reader->fields[1],reader->fields[2]));
+    if(reader->numFields == 5){
+        MATREC_CALL(readColumnEntry(reader,reader->fields[3],reader->fields[4]));
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR initializeBounds(MpsReader * reader){
+    MATREC_matrix_size size = maxMatrixSize(reader->numColumns,1);
+    MATREC_CALL(MATRECallocBlockArray(reader->env,&reader->lowerBounds,size));
+    MATREC_CALL(MATRECallocBlockArray(reader->env,&reader->upperBounds,size));
+    for (MATREC_col i = 0; i < reader->numColumns; ++i) {
+        reader->lowerBounds[i] = 0.0;
+        reader->upperBounds[i] = INFINITY;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readBound(MpsReader * reader){
+    if(reader->numFields < 2){
+        return MATREC_ERROR_INPUT;
+    }
+    const char * type = reader->fields[0];
+    bool hasValue = strcmp(type,"FR") != 0 && strcmp(type,"MI") != 0 &&
+                    strcmp(type,"PL") != 0 && strcmp(type,"BV") != 0;
+    //The name of the bound set is optional in free format
+    const char * columnName;
+    const char * valueString = NULL;
+    if(hasValue){
+        if(reader->numFields != 3 && reader->numFields != 4){
+            return MATREC_ERROR_INPUT;
+        }
+        columnName = reader->fields[reader->numFields - 2];
+        valueString = reader->fields[reader->numFields - 1];
+    }else{
+        columnName = reader->fields[reader->numFields >= 3 ? 2 : 1];
+    }
+    MATREC_col column = nameTableFind(&reader->columnTable,reader->names,columnName);
+    if(MATRECcolIsInvalid(column)){
+        return MATREC_ERROR_INPUT;
+    }
+    double value = 0.0;
+    if(valueString){
+        MATREC_CALL(parseValue(valueString,&value));
+    }
+    double * lower = &reader->lowerBounds[column];
+    double * upper = &reader->upperBounds[column];
+    if(strcmp(type,"UP") == 0 || strcmp(type,"UI") == 0){
+        //A negative upper bound on a column with default lower bound makes the column free from below
+        if(value < 0.0 && *lower == 0.0){
+            *lower = -INFINITY;
+        }
+        *upper = value;
+    }else if(strcmp(type,"LO") == 0 || strcmp(type,"LI") == 0){
+        *lower = value;
+    }else if(strcmp(type,"FX") == 0){
+        *lower = value;
+        *upper = value;
+    }else if(strcmp(type,"FR") == 0){
+        *lower = -INFINITY;
+        *upper = INFINITY;
+    }else if(strcmp(type,"MI") == 0){
+        *lower = -INFINITY;
+    }else if(strcmp(type,"PL") == 0){
+        *upper = INFINITY;
+    }else if(strcmp(type,"BV") == 0){
+        *lower = 0.0;
+        *upper = 1.0;
+    }else if(strcmp(type,"SC") == 0){
+        *upper = value;
+    }else{
+        return MATREC_ERROR_INPUT;
+    }
+    if(strcmp(type,"UI") == 0 || strcmp(type,"LI") == 0 || strcmp(type,"BV") == 0){
+        reader->isInteger[column] = true;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readSectionHeader(MpsReader * reader, MpsSection * section){
+    char * line = reader->line;
+    char * keyword = line;
+    while(*line != '\0' && !isSpace(*line)){
+        ++line;
+    }
+    char * rest = line;
+    if(*line != '\0'){
+        *line = '\0';
+        rest = trim(line + 1);
+    }
+
+    if(strcmp(keyword,"NAME") == 0){
+        MATREC_CALL(storeName(reader,rest,&reader->modelNameOffset));
+        *section = MPS_SECTION_NONE;
+    }else if(strcmp(keyword,"ROWS") == 0){
+        *section = MPS_SECTION_ROWS;
+    }else if(strcmp(keyword,"COLUMNS") == 0){
+        *section = MPS_SECTION_COLUMNS;
+    }else if(strcmp(keyword,"BOUNDS") == 0){
+        *section = (reader->parts & MATREC_MPS_READ_BOUNDS) ? MPS_SECTION_BOUNDS : MPS_SECTION_SKIP;
+    }else if(strcmp(keyword,"ENDATA") == 0){
+        *section = MPS_SECTION_ENDATA;
+    }else{
+        //RHS, RANGES, OBJSENSE, SOS and any other sections are not needed for the constraint matrix
+        *section = MPS_SECTION_SKIP;
+    }
+    if(*section == MPS_SECTION_ROWS){
+        reader->readRows = true;
+    }else if(*section != MPS_SECTION_NONE && *section != MPS_SECTION_ENDATA && !reader->readRows){
+        return MATREC_ERROR_INPUT; //The ROWS section must come first
+    }
+    if(*section == MPS_SECTION_COLUMNS && reader->lowerBounds){
+        return MATREC_ERROR_INPUT; //The BOUNDS section must come after the COLUMNS section
+    }
+    if(*section == MPS_SECTION_BOUNDS && !reader->lowerBounds){
+        MATREC_CALL(initializeBounds(reader));
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readSections(MpsReader * reader){
+    MpsSection section = MPS_SECTION_NONE;
+    while(section != MPS_SECTION_ENDATA){
+        bool endOfFile;
+        MATREC_CALL(readLine(reader,&endOfFile));
+        if(endOfFile){
+            return MATREC_ERROR_INPUT;
+        }
+        char first = reader->line[0];
+        if(first == '*'){
+            continue;
+        }
+        if(first != '\0' && !isSpace(first)){
+            MATREC_CALL(readSectionHeader(reader,&section));
+            continue;
+        }
+        if(*trim(reader->line) == '\0' || section == MPS_SECTION_SKIP){
+            continue;
+        }
+        //trim() may have cut off trailing spaces, which does not affect the fixed field positions
+        splitFields(reader);
+        switch(section){
+            case MPS_SECTION_ROWS:
+                MATREC_CALL(readRow(reader));
+                break;
+            case MPS_SECTION_COLUMNS:
+                MATREC_CALL(readColumn(reader));
+                break;
+            case MPS_SECTION_BOUNDS:
+                MATREC_CALL(readBound(reader));
+                break;
+            default:
+                return MATREC_ERROR_INPUT;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR createModel(MpsReader * reader, MATRECMpsModel * model){
+    MATREC * env = reader->env;
+    MATREC_matrix_size numConstraints = reader->numConstraints;
+    MATREC_matrix_size numColumns = reader->numColumns;
+
+    MATREC_CALL(MATRECcreateDoubleMatrix(env,&model->matrix,numConstraints,numColumns,reader->numEntries));
+    MATRECCSMatrixDouble * matrix = model->matrix;
+    for (MATREC_row row = 0; row <= numConstraints; ++row) {
+        matrix->firstRowIndex[row] = 0;
+    }
+    for (MATREC_matrix_size entry = 0; entry < reader->numEntries; ++entry) {
+        ++matrix->firstRowIndex[reader->entryRows[entry] + 1];
+    }
+    for (MATREC_row row = 1; row <= numConstraints; ++row) {
+        matrix->firstRowIndex[row] += matrix->firstRowIndex[row - 1];
+    }
+    //The columns are traversed in increasing order, so every row ends up with increasing column indices
+    reader->columnStart[numColumns] = reader->numEntries;
+    for (MATREC_col column = 0; column < numColumns; ++column) {
+        for (MATREC_matrix_size entry = reader->columnStart[column]; entry < reader->columnStart[column + 1]; ++entry) {
+            MATREC_row row = reader->entryRows[entry];
+            MATREC_matrix_size index = matrix->firstRowIndex[row];
+            matrix->entryColumns[index] = column;
+            matrix->entryValues[index] = reader->entryValues[entry];
+            ++matrix->firstRowIndex[row];
+        }
+    }
+    for (MATREC_row row = numConstraints; row > 0; --row) {
+        matrix->firstRowIndex[row] = matrix->firstRowIndex[row - 1];
+    }
+    matrix->firstRowIndex[0] = 0;
+
+    if(reader->modelNameOffset == SIZE_MAX){
+        MATREC_CALL(storeName(reader,"",&reader->modelNameOffset));
+    }
+    MATREC_CALL(MATRECallocBlockArray(env,&model->rowNames,maxSize(numConstraints,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&model->rowSenses,maxSize(numConstraints,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&model->columnNames,maxSize(numColumns,1)));
+
+    //From here on, the name storage is not reallocated anymore, so we can point into it
+    model->nameStorage = reader->names;
+    reader->names = NULL;
+    model->name = model->nameStorage + reader->modelNameOffset;
+    for (MATREC_row row = 0; row < reader->numRows; ++row) {
+        MATREC_row constraint = reader->rowConstraint[row];
+        if(MATRECrowIsValid(constraint)){
+            model->rowNames[constraint] = model->nameStorage + reader->rowNameOffsets[row];
+            model->rowSenses[constraint] = reader->rowTypes[row];
+        }
+    }
+    for (MATREC_col column = 0; column < numColumns; ++column) {
+        model->columnNames[column] = model->nameStorage + reader->columnNameOffsets[column];
+    }
+
+    if(reader->parts & MATREC_MPS_READ_OBJECTIVE){
+        if(!reader->objective){
+            MATREC_CALL(MATRECallocBlockArray(env,&reader->objective,1));
+        }
+        model->objective = reader->objective;
+        reader->objective = NULL;
+    }
+    if(reader->parts & MATREC_MPS_READ_BOUNDS){
+        if(!reader->lowerBounds){
+            MATREC_CALL(initializeBounds(reader));
+        }
+        if(!reader->isInteger){
+            MATREC_CALL(MATRECallocBlockArray(env,&reader->isInteger,1));
+        }
+        model->lowerBounds = reader->lowerBounds;
+        model->upperBounds = reader->upperBounds;
+        model->isInteger = reader->isInteger;
+        reader->lowerBounds = NULL;
+        reader->upperBounds = NULL;
+        reader->isInteger = NULL;
+    }
+    return MATREC_OKAY;
+}
+
+static void freeReader(MpsReader * reader){
+    MATREC * env = reader->env;
+    nameTableFree(env,&reader->rowTable);
+    nameTableFree(env,&reader->columnTable);
+    //Arrays which were never allocated or whose ownership was passed to the model are NULL
+    MATRECfreeBlockArray(env,&reader->line);
+    MATRECfreeBlockArray(env,&reader->names);
+    MATRECfreeBlockArray(env,&reader->rowNameOffsets);
+    MATRECfreeBlockArray(env,&reader->rowTypes);
+    MATRECfreeBlockArray(env,&reader->rowConstraint);
+    MATRECfreeBlockArray(env,&reader->rowLastColumn);
+    MATRECfreeBlockArray(env,&reader->columnNameOffsets);
+    MATRECfreeBlockArray(env,&reader->columnStart);
+    MATRECfreeBlockArray(env,&reader->objective);
+    MATRECfreeBlockArray(env,&reader->isInteger);
+    MATRECfreeBlockArray(env,&reader->lowerBounds);
+    MATRECfreeBlockArray(env,&reader->upperBounds);
+    MATRECfreeBlockArray(env,&reader->entryRows);
+    MATRECfreeBlockArray(env,&reader->entryValues);
+}
+
+static MATREC_ERROR readModel(MpsReader * reader, MATRECMpsModel * model){
+    MATREC_CALL(nameTableCreate(reader->env,&reader->rowTable));
+    MATREC_CALL(nameTableCreate(reader->env,&reader->columnTable));
+    //Makes sure that the column start array always exists
+    MATREC_CALL(MATRECallocBlockArray(reader->env,&reader->columnStart,1));
+    reader->memColumns = 1;
+
+    MATREC_CALL(readSections(reader));
+    MATREC_CALL(createModel(reader,model));
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECreadMpsFromStream(MATREC * env, MATRECMpsModel ** pModel, FILE * stream,
+                                     MATRECMpsFormat format, int parts){
+    assert(env);
+    assert(pModel);
+    assert(!*pModel);
+    assert(stream);
+
+    MATREC_CALL(MATRECallocBlock(env,pModel));
+    MATRECMpsModel * model = *pModel;
+    model->matrix = NULL;
+    model->name = NULL;
+    model->rowNames = NULL;
+    model->columnNames = NULL;
+    model->rowSenses = NULL;
+    model->objective = NULL;
+    model->lowerBounds = NULL;
+    model->upperBounds = NULL;
+    model->isInteger = NULL;
+    model->nameStorage = NULL;
+
+    MpsReader reader;
+    memset(&reader,0,sizeof(reader));
+    reader.env = env;
+    reader.stream = stream;
+    reader.format = format;
+    reader.parts = parts;
+    reader.modelNameOffset = SIZE_MAX;
+    reader.objectiveRow = MATREC_INVALID;
+
+    MATREC_ERROR error = readModel(&reader,model);
+    freeReader(&reader);
+    if(error != MATREC_OKAY){
+        MATRECfreeMpsModel(env,pModel);
+    }
+    return error;
+}
+
+void MATRECfreeMpsModel(MATREC * env, MATRECMpsModel ** pModel){
+    assert(pModel);
+    MATRECMpsModel * model = *pModel;
+    if(!model){
+        return;
+    }
+    if(model->matrix){
+        MATRECfreeDoubleMatrix(env,&model->matrix);
+    }
+    MATRECfreeBlockArray(env,&model->rowNames);
+    MATRECfreeBlockArray(env,&model->columnNames);
+    MATRECfreeBlockArray(env,&model->rowSenses);
+    MATRECfreeBlockArray(env,&model->objective);
+    MATRECfreeBlockArray(env,&model->lowerBounds);
+    MATRECfreeBlockArray(env,&model->upperBounds);
+    MATRECfreeBlockArray(env,&model->isInteger);
+    MATRECfreeBlockArray(env,&model->nameStorage);
+    MATRECfreeBlock(env,pModel);
+}
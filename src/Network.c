@@ -1,11 +1,20 @@
 #include "matrec/Network.h"
+#include "IdMap.h"
+#include "AncestorIndex.h"
+#include "ColumnTable.h"
+#include "Memory.h"
+#include "Storage.h"
+#include "Triconnected.h"
+#include "Trace.h"
 #include <assert.h>
+#include <pthread.h>
+#include <string.h>
 
 //Columns 0..x correspond to elements 0..x
 //Rows 0..y correspond to elements -1.. -y-1
-#define MARKER_ROW_ELEMENT (INT_MIN)
-#define MARKER_COLUMN_ELEMENT (INT_MAX)
-typedef int spqr_element;
+#define MARKER_ROW_ELEMENT (MATREC_INDEX_MIN)
+#define MARKER_COLUMN_ELEMENT (MATREC_INDEX_MAX)
+typedef MATREC_index spqr_element;
 
 static bool SPQRelementIsRow(spqr_element element){
     return element < 0;
@@ -31,7 +40,7 @@ static spqr_element MATRECcolumnToElement(MATREC_col column){
     return (spqr_element) column;
 }
 
-typedef int spqr_node;
+typedef MATREC_index spqr_node;
 #define SPQR_INVALID_NODE (-1)
 
 static bool SPQRnodeIsInvalid(spqr_node node){
@@ -41,7 +50,7 @@ static bool SPQRnodeIsValid(spqr_node node){
     return !SPQRnodeIsInvalid(node);
 }
 
-typedef int spqr_member;
+typedef MATREC_index spqr_member;
 #define SPQR_INVALID_MEMBER (-1)
 
 static bool SPQRmemberIsInvalid(spqr_member member){
@@ -51,7 +60,7 @@ static bool SPQRmemberIsValid(spqr_member member){
     return !SPQRmemberIsInvalid(member);
 }
 
-typedef int spqr_arc;
+typedef MATREC_index spqr_arc;
 #define SPQR_INVALID_ARC (-1)
 
 static bool SPQRarcIsInvalid(spqr_arc arc){
@@ -77,9 +86,15 @@ typedef struct{
 typedef struct {
     spqr_node representativeNode;
     spqr_arc firstArc;//first arc of the neighbouring arcs
-    int numArcs;
+    MATREC_index numArcs;
+    MATREC_index adjacencyStart; //First entry of this node in the adjacency snapshot of its member, if it has one
 } MATRECNetworkDecompositionNode;
 
+typedef struct {
+    spqr_arc arc;
+    spqr_node node; //The other endpoint of the arc
+} MATRECNetworkAdjacencyEntry;
+
 typedef struct {
     spqr_node head;
     spqr_node tail;
@@ -108,38 +123,147 @@ typedef struct {
     spqr_arc markerOfParent;
 
     spqr_arc firstArc; //First of the members' linked-list arc array
-    int numArcs;
+    MATREC_index numArcs;
+
+    size_t adjacencyVersion; //Equal to the adjacency version of the decomposition if the adjacency snapshot is valid
+
+    //Union-find of the members of each connected component. Components are only ever joined, so two members are
+    //united whenever one becomes the parent of the other
+    spqr_member componentRepresentative;
+    MATREC_index componentSize;
 } MATRECNetworkDecompositionMember;
 
+typedef enum {
+    REPLICA_ARC = 0,
+    REPLICA_MEMBER = 1,
+    REPLICA_NODE = 2,
+    REPLICA_ROW = 3,
+    REPLICA_COLUMN = 4
+} ReplicaElementType;
+
+typedef struct {
+    ReplicaElementType type;
+    MATREC_index index; ///The arc, member or node, or the row or column id
+} ReplicaChange;
+
+///The elements which were changed since a replica was last overwritten, so that only these have to be copied into it
+typedef struct {
+    ReplicaChange *changes;
+    MATREC_index numChanges;
+    MATREC_index memChanges;
+    bool copyAll; ///Set if the changes were not recorded, in which case the replica is copied entirely
+} ReplicaChanges;
+
 struct MATRECNetworkDecompositionImpl {
-    int numArcs;
-    int memArcs;
-    MATRECNetworkDecompositionArc *arcs;
+    MATREC_index numArcs;
+    MATREC_index memArcs;
+    MATRECStorage arcs;
     spqr_arc firstFreeArc;
 
-    int memMembers;
-    int numMembers;
-    MATRECNetworkDecompositionMember *members;
+    MATREC_index memMembers;
+    MATREC_index numMembers;
+    MATRECStorage members;
 
-    int memNodes;
-    int numNodes;
-    MATRECNetworkDecompositionNode *nodes;
+    MATREC_index memNodes;
+    MATREC_index numNodes;
+    MATRECStorage nodes;
 
-    int memRows;
-    int numRows;
-    spqr_arc * rowArcs;
-
-    int memColumns;
-    int numColumns;
-    spqr_arc * columnArcs;
+    MATRECIdMap rowArcs;
+    MATRECIdMap columnArcs;
 
     MATREC * env;
 
-    int numConnectedComponents;
+    MATREC_index numConnectedComponents;
+
+    //Ancestor index of the member tree, which is invalidated whenever a row or column is added
+    MATRECAncestorIndex memberAncestors;
+
+    //Adjacency snapshots of rigid members, which store the arcs around each node consecutively.
+    //A snapshot is built when a row check first searches the member, and is kept until the member is modified.
+    MATRECNetworkAdjacencyEntry *adjacencyEntries;
+    MATREC_index memAdjacencyEntries;
+    MATREC_index numAdjacencyEntries;
+    size_t adjacencyVersion; //Incremented when the snapshot storage is cleared, which invalidates all snapshots
+
+    //Signed rows of the added columns, used to place duplicate columns in parallel. Cleared when a row is added,
+    //as this changes the fundamental cycles of the columns
+    MATRECColumnTable columns;
+
+    //Statistics of the compressing union-find lookups since the last check, used for automatic flattening
+    size_t numFindCalls;
+    size_t numFindSteps;
+    double autoFlattenThreshold; //Maximal average chain length before flattening; 0 disables automatic flattening
+
+    //While set, lookups do not compress paths or update any statistics, so that column checks do not write to the
+    //decomposition and can run concurrently
+    bool readOnly;
+
+    //Copies of the decomposition which concurrent readers query while it is being changed. The published replica is
+    //never written to, and the other replica is only overwritten once its last reader is done
+    MATRECNetworkDecomposition *replicas[2];
+    int publishedReplica; ///-1 if concurrent readers are not enabled
+    size_t numReplicaReaders[2];
+    ReplicaChanges replicaChanges[2];
+    //The writer sleeps on the condition until the last reader of the replica it wants to overwrite is done
+    pthread_mutex_t replicaLock;
+    pthread_cond_t replicaReleased;
+    bool writerWaiting;
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+    //If not 0, the arrays are shrunk after this many consecutive resets of a mostly unused decomposition
+    size_t autoShrinkResets;
+    size_t numUnderusedResets;
+
+    MATRECTraceId traceId;
 };
 
-static void swap_ints(int* a, int* b){
-    int temp = *a;
+//The elements are accessed through these, as they are stored in chunks if MATREC_SEGMENTED_STORAGE is defined
+#define ARC(dec, index) MATRECstorageAt(MATRECNetworkDecompositionArc, (dec)->arcs, index)
+#define MEMBER(dec, index) MATRECstorageAt(MATRECNetworkDecompositionMember, (dec)->members, index)
+#define NODE(dec, index) MATRECstorageAt(MATRECNetworkDecompositionNode, (dec)->nodes, index)
+
+static bool readersEnabled(const MATRECNetworkDecomposition *dec){
+    return dec->publishedReplica >= 0;
+}
+
+///Marks an element which is about to change, so that it is copied into both replicas when they are next overwritten
+static void recordReplicaChange(MATRECNetworkDecomposition *dec, ReplicaElementType type, MATREC_index index){
+    if(!readersEnabled(dec)){
+        return;
+    }
+    //Once more changes are recorded than there are elements, copying everything is cheaper
+    MATREC_index maxChanges = dec->numArcs + dec->numMembers + dec->numNodes + 64;
+    for (int i = 0; i < 2; ++i) {
+        ReplicaChanges *changes = &dec->replicaChanges[i];
+        if(changes->copyAll){
+            continue;
+        }
+        if(changes->numChanges == changes->memChanges){
+            MATREC_index newSize = changes->memChanges == 0 ? 64 : 2 * changes->memChanges;
+            if(changes->numChanges >= maxChanges ||
+               MATRECreallocBlockArray(dec->env, &changes->changes, (size_t) newSize) != MATREC_OKAY){
+                changes->copyAll = true;
+                changes->numChanges = 0;
+                continue;
+            }
+            changes->memChanges = newSize;
+        }
+        changes->changes[changes->numChanges].type = type;
+        changes->changes[changes->numChanges].index = index;
+        ++changes->numChanges;
+    }
+}
+
+///Makes the next update of each replica copy everything, for changes which are not recorded element by element
+static void recordReplicaCopyAll(MATRECNetworkDecomposition *dec){
+    for (int i = 0; i < 2; ++i) {
+        dec->replicaChanges[i].copyAll = true;
+        dec->replicaChanges[i].numChanges = 0;
+    }
+}
+
+static void swap_indices(MATREC_index* a, MATREC_index* b){
+    MATREC_index temp = *a;
     *a = *b;
     *b = temp;
 }
@@ -149,29 +273,41 @@ static bool nodeIsRepresentative(const MATRECNetworkDecomposition *dec, spqr_nod
     assert(node < dec->memNodes);
     assert(SPQRnodeIsValid(node));
 
-    return SPQRnodeIsInvalid(dec->nodes[node].representativeNode);
+    return SPQRnodeIsInvalid(NODE(dec, node).representativeNode);
 }
 
+static spqr_node findNodeNoCompression(const MATRECNetworkDecomposition *dec, spqr_node node);
+
 static spqr_node findNode(MATRECNetworkDecomposition *dec, spqr_node node) {
     assert(dec);
     assert(SPQRnodeIsValid(node));
     assert(node < dec->memNodes);
+    if(dec->readOnly){
+        return findNodeNoCompression(dec, node);
+    }
 
     spqr_node current = node;
     spqr_node next;
 
     //traverse down tree to find the root
-    while (SPQRnodeIsValid(next = dec->nodes[current].representativeNode)) {
+    size_t steps = 0;
+    while (SPQRnodeIsValid(next = NODE(dec, current).representativeNode)) {
         current = next;
+        ++steps;
         assert(current < dec->memNodes);
     }
+    //The lookups are only counted when auto-flattening needs them
+    if(dec->autoFlattenThreshold > 0.0){
+        ++dec->numFindCalls;
+        dec->numFindSteps += steps;
+    }
 
     spqr_node root = current;
     current = node;
 
     //update all pointers along path to point to root, flattening the tree
-    while (SPQRnodeIsValid(next = dec->nodes[current].representativeNode)) {
-        dec->nodes[current].representativeNode = root;
+    while (SPQRnodeIsValid(next = NODE(dec, current).representativeNode)) {
+        NODE(dec, current).representativeNode = root;
         current = next;
         assert(current < dec->memNodes);
     }
@@ -187,7 +323,7 @@ static spqr_node findNodeNoCompression(const MATRECNetworkDecomposition *dec, sp
     spqr_node next;
 
     //traverse down tree to find the root
-    while (SPQRnodeIsValid(next = dec->nodes[current].representativeNode)) {
+    while (SPQRnodeIsValid(next = NODE(dec, current).representativeNode)) {
         current = next;
         assert(current < dec->memNodes);
     }
@@ -200,8 +336,10 @@ static spqr_node findArcTail(MATRECNetworkDecomposition *dec, spqr_arc arc) {
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_node representative = findNode(dec, dec->arcs[arc].tail);
-    dec->arcs[arc].tail = representative; //update the arc information
+    spqr_node representative = findNode(dec, ARC(dec, arc).tail);
+    if(!dec->readOnly){
+        ARC(dec, arc).tail = representative; //update the arc information
+    }
 
     return representative;
 }
@@ -210,8 +348,10 @@ static spqr_node findArcHead(MATRECNetworkDecomposition *dec, spqr_arc arc) {
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_node representative = findNode(dec, dec->arcs[arc].head);
-    dec->arcs[arc].head = representative;//update the arc information
+    spqr_node representative = findNode(dec, ARC(dec, arc).head);
+    if(!dec->readOnly){
+        ARC(dec, arc).head = representative;//update the arc information
+    }
 
     return representative;
 }
@@ -220,7 +360,7 @@ static spqr_node findArcHeadNoCompression(const MATRECNetworkDecomposition *dec,
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_node representative = findNodeNoCompression(dec, dec->arcs[arc].head);
+    spqr_node representative = findNodeNoCompression(dec, ARC(dec, arc).head);
     return representative;
 }
 static spqr_node findArcTailNoCompression(const MATRECNetworkDecomposition *dec, spqr_arc arc) {
@@ -228,7 +368,7 @@ static spqr_node findArcTailNoCompression(const MATRECNetworkDecomposition *dec,
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_node representative = findNodeNoCompression(dec, dec->arcs[arc].tail);
+    spqr_node representative = findNodeNoCompression(dec, ARC(dec, arc).tail);
     return representative;
 }
 
@@ -237,7 +377,7 @@ static spqr_arc getFirstNodeArc(const MATRECNetworkDecomposition * dec, spqr_nod
     assert(dec);
     assert(SPQRnodeIsValid(node));
     assert(node < dec->memNodes);
-    return dec->nodes[node].firstArc;
+    return NODE(dec, node).firstArc;
 }
 static spqr_arc getNextNodeArcNoCompression(const MATRECNetworkDecomposition * dec, spqr_arc arc, spqr_node node){
     assert(dec);
@@ -246,10 +386,10 @@ static spqr_arc getNextNodeArcNoCompression(const MATRECNetworkDecomposition * d
     assert(nodeIsRepresentative(dec,node));
 
     if(findArcHeadNoCompression(dec,arc) == node){
-        arc = dec->arcs[arc].headArcListNode.next;
+        arc = ARC(dec, arc).headArcListNode.next;
     }else{
         assert(findArcTailNoCompression(dec,arc) == node);
-        arc = dec->arcs[arc].tailArcListNode.next;
+        arc = ARC(dec, arc).tailArcListNode.next;
     }
     return arc;
 }
@@ -260,11 +400,13 @@ static spqr_arc getNextNodeArc(MATRECNetworkDecomposition * dec, spqr_arc arc, s
     assert(nodeIsRepresentative(dec,node));
 
     if(findArcHead(dec,arc) == node){
-        arc = dec->arcs[arc].headArcListNode.next;
+        arc = ARC(dec, arc).headArcListNode.next;
     }else{
         assert(findArcTailNoCompression(dec,arc) == node);
-        dec->arcs[arc].tail = node; //This assignment is not necessary but speeds up future queries.
-        arc = dec->arcs[arc].tailArcListNode.next;
+        if(!dec->readOnly){
+            ARC(dec, arc).tail = node; //This assignment is not necessary but speeds up future queries.
+        }
+        arc = ARC(dec, arc).tailArcListNode.next;
     }
     return arc;
 }
@@ -275,11 +417,13 @@ static spqr_arc getPreviousNodeArc(MATRECNetworkDecomposition *dec, spqr_arc arc
     assert(nodeIsRepresentative(dec,node));
 
     if(findArcHead(dec,arc) == node){
-        arc = dec->arcs[arc].headArcListNode.previous;
+        arc = ARC(dec, arc).headArcListNode.previous;
     }else{
         assert(findArcTailNoCompression(dec,arc) == node);
-        dec->arcs[arc].tail = node; //This assignment is not necessary but speeds up future queries.
-        arc = dec->arcs[arc].tailArcListNode.previous;
+        if(!dec->readOnly){
+            ARC(dec, arc).tail = node; //This assignment is not necessary but speeds up future queries.
+        }
+        arc = ARC(dec, arc).tailArcListNode.previous;
     }
     return arc;
 }
@@ -290,11 +434,11 @@ static void mergeNodeArcList(MATRECNetworkDecomposition *dec, spqr_node toMergeI
     spqr_arc firstFromArc = getFirstNodeArc(dec, toRemove);
     if(SPQRarcIsInvalid(firstIntoArc)){
         //new node has no arcs
-        dec->nodes[toMergeInto].numArcs += dec->nodes[toRemove].numArcs;
-        dec->nodes[toRemove].numArcs = 0;
+        NODE(dec, toMergeInto).numArcs += NODE(dec, toRemove).numArcs;
+        NODE(dec, toRemove).numArcs = 0;
 
-        dec->nodes[toMergeInto].firstArc = dec->nodes[toRemove].firstArc;
-        dec->nodes[toRemove].firstArc = SPQR_INVALID_ARC;
+        NODE(dec, toMergeInto).firstArc = NODE(dec, toRemove).firstArc;
+        NODE(dec, toRemove).firstArc = SPQR_INVALID_ARC;
 
         return;
     }else if (SPQRarcIsInvalid(firstFromArc)){
@@ -309,47 +453,50 @@ static void mergeNodeArcList(MATRECNetworkDecomposition *dec, spqr_node toMergeI
 
 
     MATRECNetworkDecompositionArcListNode * firstIntoNode = findArcHead(dec, firstIntoArc) == toMergeInto ?
-                                                           &dec->arcs[firstIntoArc].headArcListNode :
-                                                           &dec->arcs[firstIntoArc].tailArcListNode;
+                                                           &ARC(dec, firstIntoArc).headArcListNode :
+                                                           &ARC(dec, firstIntoArc).tailArcListNode;
     MATRECNetworkDecompositionArcListNode * lastIntoNode = findArcHead(dec, lastIntoArc) == toMergeInto ?
-                                                          &dec->arcs[lastIntoArc].headArcListNode :
-                                                          &dec->arcs[lastIntoArc].tailArcListNode;
+                                                          &ARC(dec, lastIntoArc).headArcListNode :
+                                                          &ARC(dec, lastIntoArc).tailArcListNode;
 
     MATRECNetworkDecompositionArcListNode * firstFromNode = findArcHead(dec, firstFromArc) == toRemove ?
-                                                           &dec->arcs[firstFromArc].headArcListNode :
-                                                           &dec->arcs[firstFromArc].tailArcListNode;
+                                                           &ARC(dec, firstFromArc).headArcListNode :
+                                                           &ARC(dec, firstFromArc).tailArcListNode;
     MATRECNetworkDecompositionArcListNode * lastFromNode = findArcHead(dec, lastFromArc) == toRemove ?
-                                                          &dec->arcs[lastFromArc].headArcListNode :
-                                                          &dec->arcs[lastFromArc].tailArcListNode;
+                                                          &ARC(dec, lastFromArc).headArcListNode :
+                                                          &ARC(dec, lastFromArc).tailArcListNode;
 
     firstIntoNode->previous = lastFromArc;
     lastIntoNode->next = firstFromArc;
     firstFromNode->previous = lastIntoArc;
     lastFromNode->next = firstIntoArc;
 
-    dec->nodes[toMergeInto].numArcs += dec->nodes[toRemove].numArcs;
-    dec->nodes[toRemove].numArcs = 0;
-    dec->nodes[toRemove].firstArc = SPQR_INVALID_ARC;
+    NODE(dec, toMergeInto).numArcs += NODE(dec, toRemove).numArcs;
+    NODE(dec, toRemove).numArcs = 0;
+    NODE(dec, toRemove).firstArc = SPQR_INVALID_ARC;
 }
 
 static void arcFlipReversed(MATRECNetworkDecomposition *dec, spqr_arc arc){
     assert(dec);
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
-    dec->arcs[arc].reversed = !dec->arcs[arc].reversed;
+    recordReplicaChange(dec, REPLICA_ARC, arc);
+    ARC(dec, arc).reversed = !ARC(dec, arc).reversed;
 }
 static void arcSetReversed(MATRECNetworkDecomposition *dec, spqr_arc arc, bool reversed){
     assert(dec);
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
-    dec->arcs[arc].reversed = reversed;
+    recordReplicaChange(dec, REPLICA_ARC, arc);
+    ARC(dec, arc).reversed = reversed;
 }
 static void arcSetRepresentative(MATRECNetworkDecomposition *dec, spqr_arc arc, spqr_arc representative){
     assert(dec);
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
     assert(representative == SPQR_INVALID_ARC || SPQRarcIsValid(representative));
-    dec->arcs[arc].representative = representative;
+    recordReplicaChange(dec, REPLICA_ARC, arc);
+    ARC(dec, arc).representative = representative;
 }
 
 static spqr_node mergeNodes(MATRECNetworkDecomposition *dec, spqr_node first, spqr_node second) {
@@ -362,16 +509,16 @@ static spqr_node mergeNodes(MATRECNetworkDecomposition *dec, spqr_node first, sp
 
     //The rank is stored as a negative number: we decrement it making the negative number larger.
     // We want the new root to be the one with 'largest' rank, so smallest number. If they are equal, we decrement.
-    spqr_node firstRank = dec->nodes[first].representativeNode;
-    spqr_node secondRank = dec->nodes[second].representativeNode;
+    spqr_node firstRank = NODE(dec, first).representativeNode;
+    spqr_node secondRank = NODE(dec, second).representativeNode;
     if (firstRank > secondRank) {
-        swap_ints(&first, &second);
+        swap_indices(&first, &second);
     }
     //first becomes representative; we merge all of the arcs of second into first
     mergeNodeArcList(dec,first,second);
-    dec->nodes[second].representativeNode = first;
+    NODE(dec, second).representativeNode = first;
     if (firstRank == secondRank) {
-        --dec->nodes[first].representativeNode;
+        --NODE(dec, first).representativeNode;
     }
     return first;
 }
@@ -381,29 +528,41 @@ static bool memberIsRepresentative(const MATRECNetworkDecomposition *dec, spqr_m
     assert(member < dec->memMembers);
     assert(SPQRmemberIsValid(member));
 
-    return SPQRmemberIsInvalid(dec->members[member].representativeMember);
+    return SPQRmemberIsInvalid(MEMBER(dec, member).representativeMember);
 }
 
+static spqr_member findMemberNoCompression(const MATRECNetworkDecomposition *dec, spqr_member member);
+
 static spqr_member findMember(MATRECNetworkDecomposition *dec, spqr_member member) {
     assert(dec);
     assert(member < dec->memMembers);
     assert(SPQRmemberIsValid(member));
+    if(dec->readOnly){
+        return findMemberNoCompression(dec, member);
+    }
 
     spqr_member current = member;
     spqr_member next;
 
     //traverse down tree to find the root
-    while (SPQRmemberIsValid(next = dec->members[current].representativeMember)) {
+    size_t steps = 0;
+    while (SPQRmemberIsValid(next = MEMBER(dec, current).representativeMember)) {
         current = next;
+        ++steps;
         assert(current < dec->memMembers);
     }
+    //The lookups are only counted when auto-flattening needs them
+    if(dec->autoFlattenThreshold > 0.0){
+        ++dec->numFindCalls;
+        dec->numFindSteps += steps;
+    }
 
     spqr_member root = current;
     current = member;
 
     //update all pointers along path to point to root, flattening the tree
-    while (SPQRmemberIsValid(next = dec->members[current].representativeMember)) {
-        dec->members[current].representativeMember = root;
+    while (SPQRmemberIsValid(next = MEMBER(dec, current).representativeMember)) {
+        MEMBER(dec, current).representativeMember = root;
         current = next;
         assert(current < dec->memMembers);
     }
@@ -419,7 +578,7 @@ static spqr_member findMemberNoCompression(const MATRECNetworkDecomposition *dec
     spqr_member next;
 
     //traverse down tree to find the root
-    while (SPQRmemberIsValid(next = dec->members[current].representativeMember)) {
+    while (SPQRmemberIsValid(next = MEMBER(dec, current).representativeMember)) {
         current = next;
         assert(current < dec->memMembers);
     }
@@ -438,14 +597,14 @@ static spqr_member mergeMembers(MATRECNetworkDecomposition *dec, spqr_member fir
 
     //The rank is stored as a negative number: we decrement it making the negative number larger.
     // We want the new root to be the one with 'largest' rank, so smallest number. If they are equal, we decrement.
-    spqr_member firstRank = dec->members[first].representativeMember;
-    spqr_member secondRank = dec->members[second].representativeMember;
+    spqr_member firstRank = MEMBER(dec, first).representativeMember;
+    spqr_member secondRank = MEMBER(dec, second).representativeMember;
     if (firstRank > secondRank) {
-        swap_ints(&first, &second);
+        swap_indices(&first, &second);
     }
-    dec->members[second].representativeMember = first;
+    MEMBER(dec, second).representativeMember = first;
     if (firstRank == secondRank) {
-        --dec->members[first].representativeMember;
+        --MEMBER(dec, first).representativeMember;
     }
     return first;
 }
@@ -455,8 +614,10 @@ static spqr_member findArcMember(MATRECNetworkDecomposition *dec, spqr_arc arc)
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_member representative = findMember(dec, dec->arcs[arc].member);
-    dec->arcs[arc].member = representative;
+    spqr_member representative = findMember(dec, ARC(dec, arc).member);
+    if(!dec->readOnly){
+        ARC(dec, arc).member = representative;
+    }
     return representative;
 }
 
@@ -465,7 +626,7 @@ static spqr_member findArcMemberNoCompression(const MATRECNetworkDecomposition *
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_member representative = findMemberNoCompression(dec, dec->arcs[arc].member);
+    spqr_member representative = findMemberNoCompression(dec, ARC(dec, arc).member);
     return representative;
 }
 
@@ -476,11 +637,13 @@ static spqr_member findMemberParent(MATRECNetworkDecomposition *dec, spqr_member
     assert(memberIsRepresentative(dec,member));
 
 
-    if(SPQRmemberIsInvalid(dec->members[member].parentMember)){
-        return dec->members[member].parentMember;
+    if(SPQRmemberIsInvalid(MEMBER(dec, member).parentMember)){
+        return MEMBER(dec, member).parentMember;
+    }
+    spqr_member parent_representative = findMember(dec, MEMBER(dec, member).parentMember);
+    if(!dec->readOnly){
+        MEMBER(dec, member).parentMember = parent_representative;
     }
-    spqr_member parent_representative = findMember(dec, dec->members[member].parentMember);
-    dec->members[member].parentMember = parent_representative;
 
     return parent_representative;
 }
@@ -491,10 +654,10 @@ static spqr_member findMemberParentNoCompression(const MATRECNetworkDecompositio
     assert(SPQRmemberIsValid(member));
     assert(memberIsRepresentative(dec,member));
 
-    if(SPQRmemberIsInvalid(dec->members[member].parentMember)){
-        return dec->members[member].parentMember;
+    if(SPQRmemberIsInvalid(MEMBER(dec, member).parentMember)){
+        return MEMBER(dec, member).parentMember;
     }
-    spqr_member parent_representative = findMemberNoCompression(dec, dec->members[member].parentMember);
+    spqr_member parent_representative = findMemberNoCompression(dec, MEMBER(dec, member).parentMember);
     return parent_representative;
 }
 
@@ -503,8 +666,10 @@ static spqr_member findArcChildMember(MATRECNetworkDecomposition *dec, spqr_arc
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_member representative = findMember(dec, dec->arcs[arc].childMember);
-    dec->arcs[arc].childMember = representative;
+    spqr_member representative = findMember(dec, ARC(dec, arc).childMember);
+    if(!dec->readOnly){
+        ARC(dec, arc).childMember = representative;
+    }
     return representative;
 }
 
@@ -513,7 +678,7 @@ static spqr_member findArcChildMemberNoCompression(const MATRECNetworkDecomposit
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    spqr_member representative = findMemberNoCompression(dec, dec->arcs[arc].childMember);
+    spqr_member representative = findMemberNoCompression(dec, ARC(dec, arc).childMember);
     return representative;
 }
 
@@ -523,7 +688,7 @@ static bool arcIsMarker(const MATRECNetworkDecomposition *dec, spqr_arc arc) {
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    return SPQRmemberIsValid(dec->arcs[arc].childMember);
+    return SPQRmemberIsValid(ARC(dec, arc).childMember);
 }
 
 static bool arcIsTree(const MATRECNetworkDecomposition *dec, spqr_arc arc) {
@@ -531,7 +696,7 @@ static bool arcIsTree(const MATRECNetworkDecomposition *dec, spqr_arc arc) {
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    return SPQRelementIsRow(dec->arcs[arc].element);
+    return SPQRelementIsRow(ARC(dec, arc).element);
 }
 
 typedef struct {
@@ -544,39 +709,51 @@ static bool arcIsRepresentative(const MATRECNetworkDecomposition *dec, spqr_arc
     assert(arc < dec->memArcs);
     assert(SPQRarcIsValid(arc));
 
-    return SPQRarcIsInvalid(dec->arcs[arc].representative);
+    return SPQRarcIsInvalid(ARC(dec, arc).representative);
 }
 
+static ArcSign findArcSignNoCompression(const MATRECNetworkDecomposition *dec, spqr_arc arc);
+
 static ArcSign findArcSign(MATRECNetworkDecomposition *dec, spqr_arc arc) {
     assert(dec);
     assert(arc < dec->memArcs);
     assert(SPQRarcIsValid(arc));
+    if(dec->readOnly){
+        return findArcSignNoCompression(dec, arc);
+    }
 
     spqr_arc current = arc;
     spqr_arc next;
 
-    bool totalReversed = dec->arcs[current].reversed;
+    bool totalReversed = ARC(dec, current).reversed;
     //traverse down tree to find the root
-    while (SPQRarcIsValid(next = dec->arcs[current].representative)) {
+    size_t steps = 0;
+    while (SPQRarcIsValid(next = ARC(dec, current).representative)) {
         current = next;
+        ++steps;
         assert(current < dec->memArcs);
         //swap boolean only if new arc is reversed
-        totalReversed = (totalReversed != dec->arcs[current].reversed);
+        totalReversed = (totalReversed != ARC(dec, current).reversed);
+    }
+    //The lookups are only counted when auto-flattening needs them
+    if(dec->autoFlattenThreshold > 0.0){
+        ++dec->numFindCalls;
+        dec->numFindSteps += steps;
     }
 
     spqr_arc root = current;
     current = arc;
 
-    bool currentReversed = totalReversed != dec->arcs[root].reversed;
+    bool currentReversed = totalReversed != ARC(dec, root).reversed;
     //update all pointers along path to point to root, flattening the tree
 
-    while (SPQRarcIsValid(next = dec->arcs[current].representative)) {
-        bool wasReversed = dec->arcs[current].reversed;
+    while (SPQRarcIsValid(next = ARC(dec, current).representative)) {
+        bool wasReversed = ARC(dec, current).reversed;
 
-        dec->arcs[current].reversed = currentReversed;
+        ARC(dec, current).reversed = currentReversed;
         currentReversed = (currentReversed != wasReversed);
 
-        dec->arcs[current].representative = root;
+        ARC(dec, current).representative = root;
         current = next;
         assert(current < dec->memArcs);
     }
@@ -595,13 +772,13 @@ static ArcSign findArcSignNoCompression(const MATRECNetworkDecomposition *dec, s
     spqr_arc current = arc;
     spqr_arc next;
 
-    bool totalReversed = dec->arcs[current].reversed;
+    bool totalReversed = ARC(dec, current).reversed;
     //traverse down tree to find the root
-    while (SPQRarcIsValid(next = dec->arcs[current].representative)) {
+    while (SPQRarcIsValid(next = ARC(dec, current).representative)) {
         current = next;
         assert(current < dec->memArcs);
         //swap boolean only if new arc is reversed
-        totalReversed = (totalReversed != dec->arcs[current].reversed);
+        totalReversed = (totalReversed != ARC(dec, current).reversed);
     }
     ArcSign sign;
     sign.reversed = totalReversed;
@@ -655,21 +832,23 @@ static spqr_arc mergeArcSigns(MATRECNetworkDecomposition *dec, spqr_arc first, s
 
     //The rank is stored as a negative number: we decrement it making the negative number larger.
     // We want the new root to be the one with 'largest' rank, so smallest number. If they are equal, we decrement.
-    spqr_member firstRank = dec->arcs[first].representative;
-    spqr_member secondRank = dec->arcs[second].representative;
+    spqr_member firstRank = ARC(dec, first).representative;
+    spqr_member secondRank = ARC(dec, second).representative;
 
     if (firstRank > secondRank) {
-        swap_ints(&first, &second);
+        swap_indices(&first, &second);
     }
-    dec->arcs[second].representative = first;
+    recordReplicaChange(dec, REPLICA_ARC, first);
+    recordReplicaChange(dec, REPLICA_ARC, second);
+    ARC(dec, second).representative = first;
     if (firstRank == secondRank) {
-        --dec->arcs[first].representative;
+        --ARC(dec, first).representative;
     }
     //These boolean formula's cover all 16 possible cases, such that the relative orientation of the first is not changed
-    bool equal = dec->arcs[first].reversed == dec->arcs[second].reversed;
-    dec->arcs[second].reversed = (equal == reflectRelative);
+    bool equal = ARC(dec, first).reversed == ARC(dec, second).reversed;
+    ARC(dec, second).reversed = (equal == reflectRelative);
     if(firstRank > secondRank){
-        dec->arcs[first].reversed = (dec->arcs[first].reversed != reflectRelative);
+        ARC(dec, first).reversed = (ARC(dec, first).reversed != reflectRelative);
     }
     return first;
 }
@@ -679,7 +858,7 @@ static bool arcIsReversedNonRigid(const MATRECNetworkDecomposition *dec, spqr_ar
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    return dec->arcs[arc].reversed;
+    return ARC(dec, arc).reversed;
 }
 
 
@@ -688,42 +867,74 @@ static spqr_element arcGetElement(const MATRECNetworkDecomposition * dec, spqr_a
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
 
-    return dec->arcs[arc].element;
+    return ARC(dec, arc).element;
 }
 bool MATRECNetworkDecompositionContainsRow(const MATRECNetworkDecomposition * dec, MATREC_row row){
-    assert(MATRECrowIsValid(row) && (int) row < dec->memRows);
+    assert(MATRECrowIsValid(row));
     assert(dec);
-    return SPQRarcIsValid(dec->rowArcs[row]);
+    return SPQRarcIsValid(MATRECidMapGet(&dec->rowArcs,row));
 }
 bool MATRECNetworkDecompositionContainsColumn(const MATRECNetworkDecomposition *dec, MATREC_col col){
-    assert(MATRECcolIsValid(col) && (int) col < dec->memColumns);
+    assert(MATRECcolIsValid(col));
     assert(dec);
-    return SPQRarcIsValid(dec->columnArcs[col]);
+    return SPQRarcIsValid(MATRECidMapGet(&dec->columnArcs,col));
 }
-static void setDecompositionColumnArc(MATRECNetworkDecomposition *dec, MATREC_col col, spqr_arc arc){
-    assert(MATRECcolIsValid(col) && (int)col < dec->memColumns);
+static MATREC_ERROR setDecompositionColumnArc(MATRECNetworkDecomposition *dec, MATREC_col col, spqr_arc arc){
+    assert(MATRECcolIsValid(col));
     assert(dec);
     assert(SPQRarcIsValid(arc));
-    dec->columnArcs[col] = arc;
+    recordReplicaChange(dec, REPLICA_COLUMN, (MATREC_index) col);
+    return MATRECidMapSet(dec->env,&dec->columnArcs,col,arc);
 }
-static void setDecompositionRowArc(MATRECNetworkDecomposition *dec, MATREC_row row, spqr_arc arc){
-    assert(MATRECrowIsValid(row) && (int) row < dec->memRows);
+static MATREC_ERROR setDecompositionRowArc(MATRECNetworkDecomposition *dec, MATREC_row row, spqr_arc arc){
+    assert(MATRECrowIsValid(row));
     assert(dec);
     assert(SPQRarcIsValid(arc));
-    dec->rowArcs[row] = arc;
+    recordReplicaChange(dec, REPLICA_ROW, (MATREC_index) row);
+    return MATRECidMapSet(dec->env,&dec->rowArcs,row,arc);
 }
+///Returns an invalid arc if the column is not in the decomposition, including columns beyond the current capacity
 static spqr_arc getDecompositionColumnArc(const MATRECNetworkDecomposition *dec, MATREC_col col){
-    assert(MATRECcolIsValid(col) && (int) col < dec->memColumns);
+    assert(MATRECcolIsValid(col));
     assert(dec);
-    return dec->columnArcs[col];
+    return MATRECidMapGet(&dec->columnArcs,col);
 }
+///Returns an invalid arc if the row is not in the decomposition, including rows beyond the current capacity
 static spqr_arc getDecompositionRowArc(const MATRECNetworkDecomposition *dec, MATREC_row row){
-    assert(MATRECrowIsValid(row) && (int) row < dec->memRows);
+    assert(MATRECrowIsValid(row));
     assert(dec);
-    return dec->rowArcs[row];
+    return MATRECidMapGet(&dec->rowArcs,row);
+}
+
+///Records a call which only has the decomposition as argument, if the decomposition is in the trace
+static void traceDecompositionCall(MATRECNetworkDecomposition *dec, MATRECTraceCall call){
+    if(MATRECtraceContains(dec->env, &dec->traceId)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(dec->env, &writer, call);
+        MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+        MATRECtraceEnd(&writer);
+    }
+}
+
+///Records that an addition is freed, if it is in the trace
+static void traceFreeAddition(MATREC *env, MATRECTraceId *addition){
+    if(MATRECtraceContains(env, addition)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(env, &writer, MATREC_TRACE_FREE_ADDITION);
+        MATRECtraceWriteAddition(&writer, addition);
+        MATRECtraceEnd(&writer);
+    }
+}
+
+MATREC_ERROR MATRECNetworkDecompositionCreate(MATREC * env, MATRECNetworkDecomposition **pDecomposition, MATREC_matrix_size numRows, MATREC_matrix_size numColumns){
+    return MATRECNetworkDecompositionCreateWithStorage(env,pDecomposition,numRows,numColumns,MATREC_IDS_DENSE,MATREC_IDS_DENSE);
 }
 
-MATREC_ERROR MATRECNetworkDecompositionCreate(MATREC * env, MATRECNetworkDecomposition **pDecomposition, int numRows, int numColumns){
+///Creates a decomposition without recording it in the trace, which is used for replicas and for creating a
+///decomposition from a graph
+static MATREC_ERROR createDecomposition(MATREC * env, MATRECNetworkDecomposition **pDecomposition,
+                                        MATREC_matrix_size numRows, MATREC_matrix_size numColumns,
+                                        MATRECIdStorage rowStorage, MATRECIdStorage columnStorage){
     assert(env);
     assert(pDecomposition);
     assert(!*pDecomposition);
@@ -733,57 +944,86 @@ MATREC_ERROR MATRECNetworkDecompositionCreate(MATREC * env, MATRECNetworkDecompo
     dec->env = env;
 
     //Initialize arc array data
-    int initialMemArcs = 8;
+    MATREC_index initialMemArcs = 8;
     {
         assert(initialMemArcs > 0);
-        dec->memArcs = initialMemArcs;
         dec->numArcs = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->arcs, (size_t) dec->memArcs));
+        MATREC_CALL(MATRECstorageCreate(env, &dec->arcs, sizeof(MATRECNetworkDecompositionArc),
+                                        &dec->memArcs, initialMemArcs));
         for (spqr_arc i = 0; i < dec->memArcs; ++i) {
-            dec->arcs[i].arcListNode.next = i + 1;
-            dec->arcs[i].member = SPQR_INVALID_MEMBER;
+            ARC(dec, i).arcListNode.next = i + 1;
+            ARC(dec, i).member = SPQR_INVALID_MEMBER;
         }
-        dec->arcs[dec->memArcs - 1].arcListNode.next = SPQR_INVALID_ARC;
+        ARC(dec, dec->memArcs - 1).arcListNode.next = SPQR_INVALID_ARC;
         dec->firstFreeArc = 0;
     }
 
     //Initialize member array data
-    int initialMemMembers = 8;
+    MATREC_index initialMemMembers = 8;
     {
         assert(initialMemMembers > 0);
-        dec->memMembers = initialMemMembers;
         dec->numMembers = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->members, (size_t) dec->memMembers));
+        MATREC_CALL(MATRECstorageCreate(env, &dec->members, sizeof(MATRECNetworkDecompositionMember), &dec->memMembers,
+                                        initialMemMembers));
     }
 
     //Initialize node array data
-    int initialMemNodes = 8;
+    MATREC_index initialMemNodes = 8;
     {
         assert(initialMemNodes > 0);
-        dec->memNodes = initialMemNodes;
         dec->numNodes = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->nodes, (size_t) dec->memNodes));
+        MATREC_CALL(MATRECstorageCreate(env, &dec->nodes, sizeof(MATRECNetworkDecompositionNode),
+                                        &dec->memNodes, initialMemNodes));
     }
 
-    //Initialize mappings for rows
-    {
-        dec->memRows = numRows;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->rowArcs, (size_t) dec->memRows));
-        for (int i = 0; i < dec->memRows; ++i) {
-            dec->rowArcs[i] = SPQR_INVALID_ARC;
-        }
-    }
-    //Initialize mappings for columns
-    {
-        dec->memColumns = numColumns;
-        dec->numColumns = 0;
-        MATREC_CALL(MATRECallocBlockArray(env, &dec->columnArcs, (size_t) dec->memColumns));
-        for (int i = 0; i < dec->memColumns; ++i) {
-            dec->columnArcs[i] = SPQR_INVALID_ARC;
-        }
-    }
+    //Initialize mappings for rows and columns. These grow when rows or columns beyond the initial size are added
+    MATREC_CALL(MATRECidMapCreate(env, &dec->rowArcs, rowStorage, numRows, SPQR_INVALID_ARC));
+    MATREC_CALL(MATRECidMapCreate(env, &dec->columnArcs, columnStorage, numColumns, SPQR_INVALID_ARC));
 
     dec->numConnectedComponents = 0;
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+    dec->autoFlattenThreshold = 0.0;
+    dec->readOnly = false;
+    dec->replicas[0] = NULL;
+    dec->replicas[1] = NULL;
+    dec->publishedReplica = -1;
+    dec->numReplicaReaders[0] = 0;
+    dec->numReplicaReaders[1] = 0;
+    for (int i = 0; i < 2; ++i) {
+        dec->replicaChanges[i].changes = NULL;
+        dec->replicaChanges[i].numChanges = 0;
+        dec->replicaChanges[i].memChanges = 0;
+        dec->replicaChanges[i].copyAll = false;
+    }
+    dec->writerWaiting = false;
+    MATRECancestorIndexCreate(&dec->memberAncestors);
+    dec->adjacencyEntries = NULL;
+    dec->memAdjacencyEntries = 0;
+    dec->numAdjacencyEntries = 0;
+    dec->adjacencyVersion = 1;
+    MATRECcolumnTableCreate(&dec->columns);
+    dec->peakMemory = 0;
+    dec->autoShrinkResets = 0;
+    dec->numUnderusedResets = 0;
+    MATRECtraceIdInit(&dec->traceId);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkDecompositionCreateWithStorage(MATREC * env, MATRECNetworkDecomposition **pDecomposition,
+                                                        MATREC_matrix_size numRows, MATREC_matrix_size numColumns,
+                                                        MATRECIdStorage rowStorage, MATRECIdStorage columnStorage){
+    MATREC_CALL(createDecomposition(env,pDecomposition,numRows,numColumns,rowStorage,columnStorage));
+    if(MATRECtraceIsActive(env)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(env, &writer, MATREC_TRACE_NETWORK_CREATE);
+        MATRECtraceWriteDecomposition(&writer, &(*pDecomposition)->traceId);
+        MATRECtraceWriteNumber(&writer, numRows);
+        MATRECtraceWriteNumber(&writer, numColumns);
+        MATRECtraceWriteNumber(&writer, (uint64_t) rowStorage);
+        MATRECtraceWriteNumber(&writer, (uint64_t) columnStorage);
+        MATRECtraceEnd(&writer);
+    }
     return MATREC_OKAY;
 }
 
@@ -792,33 +1032,396 @@ void MATRECNetworkDecompositionFree(MATRECNetworkDecomposition **pDec){
     assert(*pDec);
 
     MATRECNetworkDecomposition *dec = *pDec;
-    MATRECfreeBlockArray(dec->env, &dec->columnArcs);
-    MATRECfreeBlockArray(dec->env, &dec->rowArcs);
-    MATRECfreeBlockArray(dec->env, &dec->nodes);
-    MATRECfreeBlockArray(dec->env, &dec->members);
-    MATRECfreeBlockArray(dec->env, &dec->arcs);
+    traceDecompositionCall(dec, MATREC_TRACE_FREE);
+    if(readersEnabled(dec)){
+        pthread_cond_destroy(&dec->replicaReleased);
+        pthread_mutex_destroy(&dec->replicaLock);
+    }
+    for (int i = 0; i < 2; ++i) {
+        if(dec->replicas[i]){
+            MATRECNetworkDecompositionFree(&dec->replicas[i]);
+        }
+        if(dec->replicaChanges[i].changes){
+            MATRECfreeBlockArray(dec->env, &dec->replicaChanges[i].changes);
+        }
+    }
+    MATRECidMapFree(dec->env, &dec->columnArcs);
+    MATRECidMapFree(dec->env, &dec->rowArcs);
+    MATRECancestorIndexFree(dec->env, &dec->memberAncestors);
+    MATRECcolumnTableFree(dec->env, &dec->columns);
+    MATRECfreeBlockArray(dec->env, &dec->adjacencyEntries);
+    MATRECstorageFree(dec->env, &dec->nodes);
+    MATRECstorageFree(dec->env, &dec->members);
+    MATRECstorageFree(dec->env, &dec->arcs);
 
     MATRECfreeBlock(dec->env, pDec);
 
 }
+
+void MATRECNetworkDecompositionMemory(const MATRECNetworkDecomposition *dec, MATRECMemoryReport *report){
+    assert(dec);
+    assert(report);
+    MATRECmemoryReportInit(report);
+    MATRECmemoryReportAddBytes(report, "decomposition", sizeof(MATRECNetworkDecomposition),
+                               sizeof(MATRECNetworkDecomposition));
+    MATRECstorageMemory(&dec->arcs, "arcs", sizeof(MATRECNetworkDecompositionArc), dec->memArcs, dec->numArcs, report);
+    MATRECstorageMemory(&dec->members, "members", sizeof(MATRECNetworkDecompositionMember),
+                        dec->memMembers, dec->numMembers, report);
+    MATRECstorageMemory(&dec->nodes, "nodes", sizeof(MATRECNetworkDecompositionNode),
+                        dec->memNodes, dec->numNodes, report);
+    MATRECidMapMemory(&dec->rowArcs, "rowArcs", report);
+    MATRECidMapMemory(&dec->columnArcs, "columnArcs", report);
+    MATRECancestorIndexMemory(&dec->memberAncestors, "memberAncestors", report);
+    MATRECmemoryReportAdd(report, "adjacencyEntries", sizeof(MATRECNetworkAdjacencyEntry), dec->memAdjacencyEntries,
+                          dec->numAdjacencyEntries);
+    MATRECcolumnTableMemory(&dec->columns, report);
+
+    size_t replicaAllocated = 0;
+    size_t replicaUsed = 0;
+    for (int i = 0; i < 2; ++i) {
+        if(dec->replicas[i]){
+            MATRECMemoryReport replicaReport;
+            MATRECNetworkDecompositionMemory(dec->replicas[i], &replicaReport);
+            replicaAllocated += replicaReport.allocatedBytes;
+            replicaUsed += replicaReport.usedBytes;
+        }
+    }
+    if(replicaAllocated > 0){
+        MATRECmemoryReportAddBytes(report, "replicas", replicaAllocated, replicaUsed);
+        MATRECmemoryReportAdd(report, "replicaChanges", sizeof(ReplicaChange),
+                              dec->replicaChanges[0].memChanges + dec->replicaChanges[1].memChanges,
+                              dec->replicaChanges[0].numChanges + dec->replicaChanges[1].numChanges);
+    }
+    MATRECmemoryReportFinish(report, dec->peakMemory);
+}
+
+MATREC_ERROR MATRECNetworkDecompositionShrink(MATRECNetworkDecomposition *dec){
+    assert(dec);
+    assert(!dec->readOnly);
+    MATRECMemoryReport report;
+    MATRECNetworkDecompositionMemory(dec, &report);
+    dec->peakMemory = report.peakBytes;
+
+    //Arcs are only freed by a reset, so the arcs in use are the first numArcs arcs and the free list holds the rest
+    assert(dec->firstFreeArc == (dec->numArcs < dec->memArcs ? dec->numArcs : SPQR_INVALID_ARC));
+    //Growing the array assumes that it gains room for at least two new arcs
+    MATREC_index memArcs = dec->numArcs > 2 ? dec->numArcs : 2;
+    if(memArcs < dec->memArcs){
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->arcs, sizeof(MATRECNetworkDecompositionArc),
+                                        &dec->memArcs, memArcs));
+        if(dec->numArcs < dec->memArcs){
+            ARC(dec, dec->memArcs - 1).arcListNode.next = SPQR_INVALID_ARC;
+        }else{
+            dec->firstFreeArc = SPQR_INVALID_ARC;
+        }
+    }
+    MATREC_index memMembers = dec->numMembers > 0 ? dec->numMembers : 1;
+    if(memMembers < dec->memMembers){
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->members, sizeof(MATRECNetworkDecompositionMember),
+                                        &dec->memMembers, memMembers));
+    }
+    MATREC_index memNodes = dec->numNodes > 0 ? dec->numNodes : 1;
+    if(memNodes < dec->memNodes){
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->nodes, sizeof(MATRECNetworkDecompositionNode),
+                                        &dec->memNodes, memNodes));
+    }
+    MATREC_CALL(MATRECidMapShrink(dec->env, &dec->rowArcs));
+    MATREC_CALL(MATRECidMapShrink(dec->env, &dec->columnArcs));
+
+    //The adjacency snapshots and the ancestor index are rebuilt when they are needed
+    MATRECfreeBlockArray(dec->env, &dec->adjacencyEntries);
+    dec->memAdjacencyEntries = 0;
+    dec->numAdjacencyEntries = 0;
+    ++dec->adjacencyVersion;
+    MATRECancestorIndexFree(dec->env, &dec->memberAncestors);
+    MATRECancestorIndexCreate(&dec->memberAncestors);
+    MATRECcolumnTableShrink(dec->env, &dec->columns);
+    return MATREC_OKAY;
+}
+
+void MATRECNetworkDecompositionSetAutoShrink(MATRECNetworkDecomposition *dec, size_t numResets){
+    assert(dec);
+    dec->autoShrinkResets = numResets;
+    dec->numUnderusedResets = 0;
+}
+
+void MATRECNetworkDecompositionReset(MATRECNetworkDecomposition *dec){
+    assert(dec);
+    assert(!dec->readOnly);
+    traceDecompositionCall(dec, MATREC_TRACE_RESET);
+    bool underused = 4 * dec->numArcs < dec->memArcs;
+    for (spqr_arc i = 0; i < dec->memArcs; ++i) {
+        ARC(dec, i).arcListNode.next = i + 1;
+        ARC(dec, i).member = SPQR_INVALID_MEMBER;
+    }
+    ARC(dec, dec->memArcs - 1).arcListNode.next = SPQR_INVALID_ARC;
+    dec->firstFreeArc = 0;
+    dec->numArcs = 0;
+    dec->numMembers = 0;
+    dec->numNodes = 0;
+
+    MATRECidMapClear(&dec->rowArcs);
+    MATRECidMapClear(&dec->columnArcs);
+    recordReplicaCopyAll(dec);
+
+    dec->numConnectedComponents = 0;
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+    dec->memberAncestors.valid = false;
+    dec->memberAncestors.walkSteps = 0;
+    dec->numAdjacencyEntries = 0;
+    ++dec->adjacencyVersion;
+    MATRECcolumnTableClear(&dec->columns);
+
+    if(dec->autoShrinkResets > 0){
+        dec->numUnderusedResets = underused ? dec->numUnderusedResets + 1 : 0;
+        if(dec->numUnderusedResets >= dec->autoShrinkResets){
+            dec->numUnderusedResets = 0;
+            //If shrinking fails, the arrays which were not shrunk yet keep their size, which is harmless
+            MATRECNetworkDecompositionShrink(dec);
+        }
+    }
+}
+
+///Copies the arcs, members, nodes and row and column mappings into a replica. The lazily built indices of the
+///decomposition are not copied, as readers only use the lookups which do not change the replica
+static MATREC_ERROR copyAllToReplica(const MATRECNetworkDecomposition *dec, MATRECNetworkDecomposition *replica){
+    MATRECstorageCopy(&replica->arcs, &dec->arcs, sizeof(MATRECNetworkDecompositionArc), dec->memArcs);
+    MATRECstorageCopy(&replica->members, &dec->members, sizeof(MATRECNetworkDecompositionMember), dec->numMembers);
+    MATRECstorageCopy(&replica->nodes, &dec->nodes, sizeof(MATRECNetworkDecompositionNode), dec->numNodes);
+    MATREC_CALL(MATRECidMapCopy(dec->env, &replica->rowArcs, &dec->rowArcs));
+    MATREC_CALL(MATRECidMapCopy(dec->env, &replica->columnArcs, &dec->columnArcs));
+    return MATREC_OKAY;
+}
+
+///Copies only the elements which changed since the replica was last overwritten
+static MATREC_ERROR copyChangesToReplica(const MATRECNetworkDecomposition *dec, MATRECNetworkDecomposition *replica,
+                                         const ReplicaChanges *changes){
+    for (MATREC_index i = 0; i < changes->numChanges; ++i) {
+        MATREC_index index = changes->changes[i].index;
+        switch(changes->changes[i].type){
+            case REPLICA_ARC:
+                ARC(replica, index) = ARC(dec, index);
+                break;
+            case REPLICA_MEMBER:
+                MEMBER(replica, index) = MEMBER(dec, index);
+                break;
+            case REPLICA_NODE:
+                NODE(replica, index) = NODE(dec, index);
+                break;
+            case REPLICA_ROW:
+                MATREC_CALL(MATRECidMapSet(dec->env, &replica->rowArcs, (MATREC_row) index,
+                                           MATRECidMapGet(&dec->rowArcs, (MATREC_row) index)));
+                break;
+            case REPLICA_COLUMN:
+                MATREC_CALL(MATRECidMapSet(dec->env, &replica->columnArcs, (MATREC_col) index,
+                                           MATRECidMapGet(&dec->columnArcs, (MATREC_col) index)));
+                break;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+///Brings a replica up to date. If the storage of the replica has to grow, everything is copied, which happens a
+///logarithmic number of times. Otherwise, only the changed elements are copied
+static MATREC_ERROR copyToReplica(MATRECNetworkDecomposition *dec, int target){
+    MATRECNetworkDecomposition *replica = dec->replicas[target];
+    ReplicaChanges *changes = &dec->replicaChanges[target];
+    if(replica->memArcs != dec->memArcs){
+        changes->copyAll = true;
+        MATREC_CALL(MATRECstorageResize(dec->env, &replica->arcs, sizeof(MATRECNetworkDecompositionArc),
+                                        &replica->memArcs, dec->memArcs));
+    }
+    if(replica->memMembers < dec->numMembers){
+        changes->copyAll = true;
+        MATREC_CALL(MATRECstorageResize(dec->env, &replica->members, sizeof(MATRECNetworkDecompositionMember),
+                                        &replica->memMembers, dec->memMembers));
+    }
+    if(replica->memNodes < dec->numNodes){
+        changes->copyAll = true;
+        MATREC_CALL(MATRECstorageResize(dec->env, &replica->nodes, sizeof(MATRECNetworkDecompositionNode),
+                                        &replica->memNodes, dec->memNodes));
+    }
+    if(changes->copyAll){
+        MATREC_CALL(copyAllToReplica(dec, replica));
+    }else{
+        MATREC_ERROR error = copyChangesToReplica(dec, replica, changes);
+        if(error != MATREC_OKAY){
+            //The replica is partially updated, so it is copied entirely next time
+            changes->copyAll = true;
+            return error;
+        }
+    }
+    replica->numArcs = dec->numArcs;
+    replica->firstFreeArc = dec->firstFreeArc;
+    replica->numMembers = dec->numMembers;
+    replica->numNodes = dec->numNodes;
+    replica->numConnectedComponents = dec->numConnectedComponents;
+    changes->numChanges = 0;
+    changes->copyAll = false;
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkDecompositionEnableReaders(MATRECNetworkDecomposition *dec){
+    assert(dec);
+    assert(!readersEnabled(dec));
+    for (int i = 0; i < 2; ++i) {
+        MATREC_CALL(createDecomposition(dec->env, &dec->replicas[i], 0, 0,
+                                        dec->rowArcs.storage, dec->columnArcs.storage));
+        //Readers may query a replica concurrently, so its lookups may not compress paths
+        dec->replicas[i]->readOnly = true;
+    }
+    recordReplicaCopyAll(dec);
+    MATREC_CALL(copyToReplica(dec, 0));
+    pthread_mutex_init(&dec->replicaLock, NULL);
+    pthread_cond_init(&dec->replicaReleased, NULL);
+    dec->writerWaiting = false;
+    __atomic_store_n(&dec->publishedReplica, 0, __ATOMIC_SEQ_CST);
+    return MATREC_OKAY;
+}
+
+///Copies the changes into the replica which is not published and publishes it, after waiting for its readers
+static MATREC_ERROR publishReplica(MATRECNetworkDecomposition *dec){
+    int target = 1 - dec->publishedReplica;
+    //Readers which start from now on use the published replica, so the target only has to be waited for once
+    if(__atomic_load_n(&dec->numReplicaReaders[target], __ATOMIC_SEQ_CST) > 0){
+        pthread_mutex_lock(&dec->replicaLock);
+        __atomic_store_n(&dec->writerWaiting, true, __ATOMIC_SEQ_CST);
+        while(__atomic_load_n(&dec->numReplicaReaders[target], __ATOMIC_SEQ_CST) > 0){
+            pthread_cond_wait(&dec->replicaReleased, &dec->replicaLock);
+        }
+        __atomic_store_n(&dec->writerWaiting, false, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&dec->replicaLock);
+    }
+    MATREC_CALL(copyToReplica(dec, target));
+    __atomic_store_n(&dec->publishedReplica, target, __ATOMIC_SEQ_CST);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkDecompositionPublish(MATRECNetworkDecomposition *dec){
+    assert(dec);
+    assert(readersEnabled(dec));
+    //Only the changes made by additions are recorded, so other changes require copying everything
+    recordReplicaCopyAll(dec);
+    return publishReplica(dec);
+}
+
+///Stops reading a replica. The last reader wakes up the writer if it waits for the replica
+static void releaseReplica(MATRECNetworkDecomposition *dec, int replica){
+    if(__atomic_sub_fetch(&dec->numReplicaReaders[replica], 1, __ATOMIC_SEQ_CST) == 0 &&
+       __atomic_load_n(&dec->writerWaiting, __ATOMIC_SEQ_CST)){
+        pthread_mutex_lock(&dec->replicaLock);
+        pthread_cond_signal(&dec->replicaReleased);
+        pthread_mutex_unlock(&dec->replicaLock);
+    }
+}
+
+const MATRECNetworkDecomposition * MATRECNetworkDecompositionBeginRead(MATRECNetworkDecomposition *dec){
+    assert(dec);
+    while(true){
+        int replica = __atomic_load_n(&dec->publishedReplica, __ATOMIC_SEQ_CST);
+        assert(replica >= 0);
+        __atomic_fetch_add(&dec->numReplicaReaders[replica], 1, __ATOMIC_SEQ_CST);
+        //If another replica was published in the meantime, the writer may be overwriting this one, so try again
+        if(__atomic_load_n(&dec->publishedReplica, __ATOMIC_SEQ_CST) == replica){
+            return dec->replicas[replica];
+        }
+        releaseReplica(dec, replica);
+    }
+}
+
+void MATRECNetworkDecompositionEndRead(MATRECNetworkDecomposition *dec, const MATRECNetworkDecomposition *replica){
+    assert(dec);
+    assert(replica == dec->replicas[0] || replica == dec->replicas[1]);
+    int index = replica == dec->replicas[0] ? 0 : 1;
+    releaseReplica(dec, index);
+}
+
+void MATRECNetworkDecompositionFlatten(MATRECNetworkDecomposition *dec){
+    assert(dec);
+    traceDecompositionCall(dec, MATREC_TRACE_FLATTEN);
+    for (spqr_node node = 0; node < dec->numNodes; ++node) {
+        findNode(dec,node);
+    }
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(memberIsRepresentative(dec,member)){
+            findMemberParent(dec,member);
+        }else{
+            findMember(dec,member);
+        }
+    }
+    //Walk over the arcs of each member, since arcs which were removed from their member keep stale data
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(!memberIsRepresentative(dec,member) || SPQRarcIsInvalid(MEMBER(dec, member).firstArc)){
+            continue;
+        }
+        bool isRigid = MEMBER(dec, member).type == SPQR_MEMBERTYPE_RIGID;
+        spqr_arc first = MEMBER(dec, member).firstArc;
+        spqr_arc arc = first;
+        do{
+            findArcMember(dec,arc);
+            if(SPQRmemberIsValid(ARC(dec, arc).childMember)){
+                findArcChildMember(dec,arc);
+            }
+            //Only arcs of rigid members have nodes and are part of the signed union-find
+            if(isRigid){
+                findArcHead(dec,arc);
+                findArcTail(dec,arc);
+                findArcSign(dec,arc);
+            }
+            arc = ARC(dec, arc).arcListNode.next;
+        }while(arc != first);
+    }
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+}
+
+void MATRECNetworkDecompositionSetAutoFlatten(MATRECNetworkDecomposition *dec, double averageChainLength){
+    assert(dec);
+    assert(averageChainLength >= 0.0);
+    if(MATRECtraceContains(dec->env, &dec->traceId)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(dec->env, &writer, MATREC_TRACE_SET_AUTO_FLATTEN);
+        MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+        MATRECtraceWriteDouble(&writer, averageChainLength);
+        MATRECtraceEnd(&writer);
+    }
+    dec->autoFlattenThreshold = averageChainLength;
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+}
+
+///Flattens the decomposition if automatic flattening is enabled and the lookups since the last check were too long.
+///Only checks once enough lookups were done to pay for the linear sweep.
+static void autoFlatten(MATRECNetworkDecomposition *dec){
+    if(dec->autoFlattenThreshold <= 0.0 || dec->numFindCalls < (size_t) dec->numMembers + 1){
+        return;
+    }
+    if((double) dec->numFindSteps > dec->autoFlattenThreshold * (double) dec->numFindCalls){
+        MATRECNetworkDecompositionFlatten(dec);
+    }
+    dec->numFindCalls = 0;
+    dec->numFindSteps = 0;
+}
+
 static spqr_arc getFirstMemberArc(const MATRECNetworkDecomposition * dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
-    return dec->members[member].firstArc;
+    return MEMBER(dec, member).firstArc;
 }
 static spqr_arc getNextMemberArc(const MATRECNetworkDecomposition * dec, spqr_arc arc){
     assert(dec);
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
-    arc = dec->arcs[arc].arcListNode.next;
+    arc = ARC(dec, arc).arcListNode.next;
     return arc;
 }
 static spqr_arc getPreviousMemberArc(const MATRECNetworkDecomposition *dec, spqr_arc arc){
     assert(dec);
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
-    arc = dec->arcs[arc].arcListNode.previous;
+    arc = ARC(dec, arc).arcListNode.previous;
     return arc;
 }
 
@@ -827,17 +1430,17 @@ static void addArcToMemberArcList(MATRECNetworkDecomposition *dec, spqr_arc arc,
 
     if(SPQRarcIsValid(firstMemberArc)){
         spqr_arc lastMemberArc = getPreviousMemberArc(dec, firstMemberArc);
-        dec->arcs[arc].arcListNode.next = firstMemberArc;
-        dec->arcs[arc].arcListNode.previous = lastMemberArc;
-        dec->arcs[firstMemberArc].arcListNode.previous = arc;
-        dec->arcs[lastMemberArc].arcListNode.next = arc;
+        ARC(dec, arc).arcListNode.next = firstMemberArc;
+        ARC(dec, arc).arcListNode.previous = lastMemberArc;
+        ARC(dec, firstMemberArc).arcListNode.previous = arc;
+        ARC(dec, lastMemberArc).arcListNode.next = arc;
     }else{
-        assert(dec->members[member].numArcs == 0);
-        dec->arcs[arc].arcListNode.next = arc;
-        dec->arcs[arc].arcListNode.previous = arc;
+        assert(MEMBER(dec, member).numArcs == 0);
+        ARC(dec, arc).arcListNode.next = arc;
+        ARC(dec, arc).arcListNode.previous = arc;
     }
-    dec->members[member].firstArc = arc;//TODO: update this in case of row/column arcs to make memory ordering nicer?
-    ++(dec->members[member].numArcs);
+    MEMBER(dec, member).firstArc = arc;//TODO: update this in case of row/column arcs to make memory ordering nicer?
+    ++(MEMBER(dec, member).numArcs);
 }
 static MATREC_ERROR createArc(MATRECNetworkDecomposition *dec, spqr_member member,bool reversed, spqr_arc *pArc) {
     assert(dec);
@@ -846,31 +1449,32 @@ static MATREC_ERROR createArc(MATRECNetworkDecomposition *dec, spqr_member membe
 
     spqr_arc index = dec->firstFreeArc;
     if (SPQRarcIsValid(index)) {
-        dec->firstFreeArc = dec->arcs[index].arcListNode.next;
+        dec->firstFreeArc = ARC(dec, index).arcListNode.next;
     } else {
         //Enlarge array, no free nodes in arc list
-        int newSize = 2 * dec->memArcs;
-        MATREC_CALL(MATRECreallocBlockArray(dec->env, &dec->arcs, (size_t) newSize));
-        for (int i = dec->memArcs + 1; i < newSize; ++i) {
-            dec->arcs[i].arcListNode.next = i + 1;
-            dec->arcs[i].member = SPQR_INVALID_MEMBER;
-        }
-        dec->arcs[newSize - 1].arcListNode.next = SPQR_INVALID_ARC;
-        dec->firstFreeArc = dec->memArcs + 1;
-        index = dec->memArcs;
-        dec->memArcs = newSize;
-    }
+        MATREC_index oldSize = dec->memArcs;
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->arcs, sizeof(MATRECNetworkDecompositionArc),
+                                        &dec->memArcs, MATRECstorageGrowSize(oldSize)));
+        for (MATREC_index i = oldSize + 1; i < dec->memArcs; ++i) {
+            ARC(dec, i).arcListNode.next = i + 1;
+            ARC(dec, i).member = SPQR_INVALID_MEMBER;
+        }
+        ARC(dec, dec->memArcs - 1).arcListNode.next = SPQR_INVALID_ARC;
+        dec->firstFreeArc = oldSize + 1;
+        index = oldSize;
+    }
+    recordReplicaChange(dec, REPLICA_ARC, index);
     //TODO: Is defaulting these here necessary?
-    dec->arcs[index].tail = SPQR_INVALID_NODE;
-    dec->arcs[index].head = SPQR_INVALID_NODE;
-    dec->arcs[index].member = member;
-    dec->arcs[index].childMember = SPQR_INVALID_MEMBER;
-    dec->arcs[index].reversed = reversed;
+    ARC(dec, index).tail = SPQR_INVALID_NODE;
+    ARC(dec, index).head = SPQR_INVALID_NODE;
+    ARC(dec, index).member = member;
+    ARC(dec, index).childMember = SPQR_INVALID_MEMBER;
+    ARC(dec, index).reversed = reversed;
 
-    dec->arcs[index].headArcListNode.next = SPQR_INVALID_ARC;
-    dec->arcs[index].headArcListNode.previous = SPQR_INVALID_ARC;
-    dec->arcs[index].tailArcListNode.next = SPQR_INVALID_ARC;
-    dec->arcs[index].tailArcListNode.previous = SPQR_INVALID_ARC;
+    ARC(dec, index).headArcListNode.next = SPQR_INVALID_ARC;
+    ARC(dec, index).headArcListNode.previous = SPQR_INVALID_ARC;
+    ARC(dec, index).tailArcListNode.next = SPQR_INVALID_ARC;
+    ARC(dec, index).tailArcListNode.previous = SPQR_INVALID_ARC;
 
     dec->numArcs++;
 
@@ -881,18 +1485,18 @@ static MATREC_ERROR createArc(MATRECNetworkDecomposition *dec, spqr_member membe
 static MATREC_ERROR createRowArc(MATRECNetworkDecomposition *dec, spqr_member member, spqr_arc *pArc,
                                  MATREC_row row, bool reversed){
     MATREC_CALL(createArc(dec,member,reversed,pArc));
-    setDecompositionRowArc(dec,row,*pArc);
+    MATREC_CALL(setDecompositionRowArc(dec,row,*pArc));
     addArcToMemberArcList(dec,*pArc,member);
-    dec->arcs[*pArc].element = MATRECrowToElement(row);
+    ARC(dec, *pArc).element = MATRECrowToElement(row);
 
     return MATREC_OKAY;
 }
 static MATREC_ERROR createColumnArc(MATRECNetworkDecomposition *dec, spqr_member member, spqr_arc *pArc,
                                     MATREC_col column, bool reversed){
     MATREC_CALL(createArc(dec,member,reversed,pArc));
-    setDecompositionColumnArc(dec,column,*pArc);
+    MATREC_CALL(setDecompositionColumnArc(dec,column,*pArc));
     addArcToMemberArcList(dec,*pArc,member);
-    dec->arcs[*pArc].element = MATRECcolumnToElement(column);
+    ARC(dec, *pArc).element = MATRECcolumnToElement(column);
 
     return MATREC_OKAY;
 }
@@ -901,10 +1505,11 @@ static MATREC_ERROR createMember(MATRECNetworkDecomposition *dec, SPQRMemberType
     assert(pMember);
 
     if(dec->numMembers == dec->memMembers){
-        dec->memMembers *= 2;
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&dec->members,(size_t) dec->memMembers));
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->members, sizeof(MATRECNetworkDecompositionMember),
+                                        &dec->memMembers, MATRECstorageGrowSize(dec->memMembers)));
     }
-    MATRECNetworkDecompositionMember *data = &dec->members[dec->numMembers];
+    recordReplicaChange(dec, REPLICA_MEMBER, dec->numMembers);
+    MATRECNetworkDecompositionMember *data = &MEMBER(dec, dec->numMembers);
     data->markerOfParent = SPQR_INVALID_ARC;
     data->markerToParent = SPQR_INVALID_ARC;
     data->firstArc = SPQR_INVALID_ARC;
@@ -912,6 +1517,9 @@ static MATREC_ERROR createMember(MATRECNetworkDecomposition *dec, SPQRMemberType
     data->numArcs = 0;
     data->parentMember = SPQR_INVALID_MEMBER;
     data->type = type;
+    data->adjacencyVersion = 0;
+    data->componentRepresentative = SPQR_INVALID_MEMBER;
+    data->componentSize = 1;
 
     *pMember = dec->numMembers;
 
@@ -919,50 +1527,94 @@ static MATREC_ERROR createMember(MATRECNetworkDecomposition *dec, SPQRMemberType
     return MATREC_OKAY;
 }
 
+static spqr_member findMemberComponent(MATRECNetworkDecomposition *dec, spqr_member member){
+    assert(dec);
+    assert(SPQRmemberIsValid(member) && member < dec->numMembers);
+    spqr_member root = member;
+    while(SPQRmemberIsValid(MEMBER(dec, root).componentRepresentative)){
+        root = MEMBER(dec, root).componentRepresentative;
+    }
+    //Lookups during concurrent checks may not write to the decomposition
+    if(dec->readOnly){
+        return root;
+    }
+    while(member != root){
+        spqr_member next = MEMBER(dec, member).componentRepresentative;
+        MEMBER(dec, member).componentRepresentative = root;
+        member = next;
+    }
+    return root;
+}
+
+///Sets the parent of a member in the member tree, which joins the components of both
+static void setMemberParent(MATRECNetworkDecomposition *dec, spqr_member member, spqr_member parent){
+    recordReplicaChange(dec, REPLICA_MEMBER, member);
+    MEMBER(dec, member).parentMember = parent;
+    if(SPQRmemberIsInvalid(parent)){
+        return;
+    }
+    spqr_member first = findMemberComponent(dec,member);
+    spqr_member second = findMemberComponent(dec,parent);
+    if(first == second){
+        return;
+    }
+    recordReplicaChange(dec, REPLICA_MEMBER, first);
+    recordReplicaChange(dec, REPLICA_MEMBER, second);
+    if(MEMBER(dec, first).componentSize < MEMBER(dec, second).componentSize){
+        spqr_member temp = first;
+        first = second;
+        second = temp;
+    }
+    MEMBER(dec, second).componentRepresentative = first;
+    MEMBER(dec, first).componentSize += MEMBER(dec, second).componentSize;
+}
+
 static MATREC_ERROR createNode(MATRECNetworkDecomposition *dec, spqr_node * pNode){
 
     if(dec->numNodes == dec->memNodes){
-        dec->memNodes*=2;
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&dec->nodes,(size_t) dec->memNodes));
+        MATREC_CALL(MATRECstorageResize(dec->env, &dec->nodes, sizeof(MATRECNetworkDecompositionNode),
+                                        &dec->memNodes, MATRECstorageGrowSize(dec->memNodes)));
     }
     *pNode = dec->numNodes;
-    dec->nodes[dec->numNodes].representativeNode = SPQR_INVALID_NODE;
-    dec->nodes[dec->numNodes].firstArc = SPQR_INVALID_ARC;
-    dec->nodes[dec->numNodes].numArcs = 0;
+    recordReplicaChange(dec, REPLICA_NODE, dec->numNodes);
+    NODE(dec, dec->numNodes).representativeNode = SPQR_INVALID_NODE;
+    NODE(dec, dec->numNodes).firstArc = SPQR_INVALID_ARC;
+    NODE(dec, dec->numNodes).numArcs = 0;
+    NODE(dec, dec->numNodes).adjacencyStart = -1;
     dec->numNodes++;
 
     return MATREC_OKAY;
 }
 static void removeArcFromNodeArcList(MATRECNetworkDecomposition *dec, spqr_arc arc, spqr_node node, bool nodeIsHead){
-    MATRECNetworkDecompositionArcListNode * arcListNode = nodeIsHead ? &dec->arcs[arc].headArcListNode : &dec->arcs[arc].tailArcListNode;
+    MATRECNetworkDecompositionArcListNode * arcListNode = nodeIsHead ? &ARC(dec, arc).headArcListNode : &ARC(dec, arc).tailArcListNode;
 
-    if(dec->nodes[node].numArcs == 1){
-        dec->nodes[node].firstArc = SPQR_INVALID_ARC;
+    if(NODE(dec, node).numArcs == 1){
+        NODE(dec, node).firstArc = SPQR_INVALID_ARC;
     }else{
         spqr_arc next_arc = arcListNode->next;
         spqr_arc prev_arc = arcListNode->previous;
-        MATRECNetworkDecompositionArcListNode * nextListNode = findArcHead(dec, next_arc) == node ? &dec->arcs[next_arc].headArcListNode : &dec->arcs[next_arc].tailArcListNode;//TODO: finds necessary?
-        MATRECNetworkDecompositionArcListNode * prevListNode = findArcHead(dec, prev_arc) == node ? &dec->arcs[prev_arc].headArcListNode : &dec->arcs[prev_arc].tailArcListNode;//TODO: finds necessary?
+        MATRECNetworkDecompositionArcListNode * nextListNode = findArcHead(dec, next_arc) == node ? &ARC(dec, next_arc).headArcListNode : &ARC(dec, next_arc).tailArcListNode;//TODO: finds necessary?
+        MATRECNetworkDecompositionArcListNode * prevListNode = findArcHead(dec, prev_arc) == node ? &ARC(dec, prev_arc).headArcListNode : &ARC(dec, prev_arc).tailArcListNode;//TODO: finds necessary?
 
         nextListNode->previous = prev_arc;
         prevListNode->next = next_arc;
 
-        if(dec->nodes[node].firstArc == arc){
-            dec->nodes[node].firstArc = next_arc; //TODO: fix this if we want fixed ordering for tree/nontree arcs in memory
+        if(NODE(dec, node).firstArc == arc){
+            NODE(dec, node).firstArc = next_arc; //TODO: fix this if we want fixed ordering for tree/nontree arcs in memory
         }
     }
     //TODO: empty arcListNode's data? Might not be all that relevant
-    --(dec->nodes[node].numArcs);
+    --(NODE(dec, node).numArcs);
 }
 static void addArcToNodeArcList(MATRECNetworkDecomposition *dec, spqr_arc arc, spqr_node node, bool nodeIsHead){
     assert(nodeIsRepresentative(dec,node));
 
     spqr_arc firstNodeArc = getFirstNodeArc(dec, node);
 
-    MATRECNetworkDecompositionArcListNode * arcListNode = nodeIsHead ? &dec->arcs[arc].headArcListNode : &dec->arcs[arc].tailArcListNode;
+    MATRECNetworkDecompositionArcListNode * arcListNode = nodeIsHead ? &ARC(dec, arc).headArcListNode : &ARC(dec, arc).tailArcListNode;
     if(SPQRarcIsValid(firstNodeArc)){
         bool nextIsHead = findArcHead(dec,firstNodeArc) == node;
-        MATRECNetworkDecompositionArcListNode *nextListNode = nextIsHead ? &dec->arcs[firstNodeArc].headArcListNode : &dec->arcs[firstNodeArc].tailArcListNode;
+        MATRECNetworkDecompositionArcListNode *nextListNode = nextIsHead ? &ARC(dec, firstNodeArc).headArcListNode : &ARC(dec, firstNodeArc).tailArcListNode;
         spqr_arc lastNodeArc = nextListNode->previous;
 
         arcListNode->next = firstNodeArc;
@@ -970,7 +1622,7 @@ static void addArcToNodeArcList(MATRECNetworkDecomposition *dec, spqr_arc arc, s
 
 
         bool previousIsHead = findArcHead(dec,lastNodeArc) == node;
-        MATRECNetworkDecompositionArcListNode *previousListNode = previousIsHead ? &dec->arcs[lastNodeArc].headArcListNode : &dec->arcs[lastNodeArc].tailArcListNode;
+        MATRECNetworkDecompositionArcListNode *previousListNode = previousIsHead ? &ARC(dec, lastNodeArc).headArcListNode : &ARC(dec, lastNodeArc).tailArcListNode;
         previousListNode->next = arc;
         nextListNode->previous = arc;
 
@@ -978,12 +1630,12 @@ static void addArcToNodeArcList(MATRECNetworkDecomposition *dec, spqr_arc arc, s
         arcListNode->next = arc;
         arcListNode->previous = arc;
     }
-    dec->nodes[node].firstArc = arc; //TODO: update this in case of row/column arcs to make memory ordering nicer?er?
-    ++dec->nodes[node].numArcs;
+    NODE(dec, node).firstArc = arc; //TODO: update this in case of row/column arcs to make memory ordering nicer?er?
+    ++NODE(dec, node).numArcs;
     if(nodeIsHead){
-        dec->arcs[arc].head = node;
+        ARC(dec, arc).head = node;
     }else{
-        dec->arcs[arc].tail = node;
+        ARC(dec, arc).tail = node;
     }
 }
 static void setArcHeadAndTail(MATRECNetworkDecomposition *dec, spqr_arc arc, spqr_node head, spqr_node tail){
@@ -993,8 +1645,8 @@ static void setArcHeadAndTail(MATRECNetworkDecomposition *dec, spqr_arc arc, spq
 static void clearArcHeadAndTail(MATRECNetworkDecomposition *dec, spqr_arc arc){
     removeArcFromNodeArcList(dec,arc,findArcHead(dec,arc),true);
     removeArcFromNodeArcList(dec,arc,findArcTail(dec,arc),false);
-    dec->arcs[arc].head = SPQR_INVALID_NODE;
-    dec->arcs[arc].tail = SPQR_INVALID_NODE;
+    ARC(dec, arc).head = SPQR_INVALID_NODE;
+    ARC(dec, arc).tail = SPQR_INVALID_NODE;
 }
 static void changeArcHead(MATRECNetworkDecomposition *dec, spqr_arc arc, spqr_node oldHead, spqr_node newHead){
     assert(nodeIsRepresentative(dec,oldHead));
@@ -1009,18 +1661,28 @@ static void changeArcTail(MATRECNetworkDecomposition *dec, spqr_arc arc, spqr_no
     addArcToNodeArcList(dec,arc,newTail,false);
 }
 
-static int nodeDegree(MATRECNetworkDecomposition *dec, spqr_node node){
+static MATREC_index nodeDegree(MATRECNetworkDecomposition *dec, spqr_node node){
     assert(dec);
     assert(SPQRnodeIsValid(node));
     assert(node < dec->memNodes);
-    return dec->nodes[node].numArcs;
+    return NODE(dec, node).numArcs;
 }
 static SPQRMemberType getMemberType(const MATRECNetworkDecomposition *dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].type;
+    return MEMBER(dec, member).type;
+}
+
+static bool memberHasAdjacency(const MATRECNetworkDecomposition *dec, spqr_member member){
+    assert(SPQRmemberIsValid(member) && member < dec->memMembers);
+    return MEMBER(dec, member).adjacencyVersion == dec->adjacencyVersion;
+}
+
+static void invalidateMemberAdjacency(MATRECNetworkDecomposition *dec, spqr_member member){
+    assert(SPQRmemberIsValid(member) && member < dec->memMembers);
+    MEMBER(dec, member).adjacencyVersion = 0;
 }
 static void updateMemberType(const MATRECNetworkDecomposition *dec, spqr_member member, SPQRMemberType type){
     assert(dec);
@@ -1028,14 +1690,14 @@ static void updateMemberType(const MATRECNetworkDecomposition *dec, spqr_member
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
 
-    dec->members[member].type = type;
+    MEMBER(dec, member).type = type;
 }
 static spqr_arc markerToParent(const MATRECNetworkDecomposition *dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].markerToParent;
+    return MEMBER(dec, member).markerToParent;
 }
 static char typeToChar(SPQRMemberType type){
     switch (type) {
@@ -1056,42 +1718,42 @@ static void updateMemberParentInformation(MATRECNetworkDecomposition *dec, const
     assert(memberIsRepresentative(dec,newMember));
     assert(findMemberNoCompression(dec,toRemove) == newMember);
 
-    dec->members[newMember].markerOfParent = dec->members[toRemove].markerOfParent;
-    dec->members[newMember].markerToParent = dec->members[toRemove].markerToParent;
-    dec->members[newMember].parentMember = dec->members[toRemove].parentMember;
+    MEMBER(dec, newMember).markerOfParent = MEMBER(dec, toRemove).markerOfParent;
+    MEMBER(dec, newMember).markerToParent = MEMBER(dec, toRemove).markerToParent;
+    setMemberParent(dec,newMember,MEMBER(dec, toRemove).parentMember);
 
-    dec->members[toRemove].markerOfParent = SPQR_INVALID_ARC;
-    dec->members[toRemove].markerToParent = SPQR_INVALID_ARC;
-    dec->members[toRemove].parentMember = SPQR_INVALID_MEMBER;
+    MEMBER(dec, toRemove).markerOfParent = SPQR_INVALID_ARC;
+    MEMBER(dec, toRemove).markerToParent = SPQR_INVALID_ARC;
+    MEMBER(dec, toRemove).parentMember = SPQR_INVALID_MEMBER;
 }
 static spqr_arc markerOfParent(const MATRECNetworkDecomposition *dec, spqr_member member) {
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].markerOfParent;
+    return MEMBER(dec, member).markerOfParent;
 }
 
 
 
-static int getNumMemberArcs(const MATRECNetworkDecomposition * dec, spqr_member member){
+static MATREC_index getNumMemberArcs(const MATRECNetworkDecomposition * dec, spqr_member member){
     assert(dec);
     assert(SPQRmemberIsValid(member));
     assert(member < dec->memMembers);
     assert(memberIsRepresentative(dec,member));
-    return dec->members[member].numArcs;
+    return MEMBER(dec, member).numArcs;
 }
 
-static int getNumNodes(const MATRECNetworkDecomposition *dec){
+static MATREC_index getNumNodes(const MATRECNetworkDecomposition *dec){
     assert(dec);
     return dec->numNodes;
 }
-static int getNumMembers(const MATRECNetworkDecomposition *dec){
+static MATREC_index getNumMembers(const MATRECNetworkDecomposition *dec){
     assert(dec);
     return dec->numMembers;
 }
 static MATREC_ERROR createStandaloneParallel(MATRECNetworkDecomposition *dec, MATREC_col * columns, bool * reversed,
-                                             int num_columns, MATREC_row row, spqr_member * pMember){
+                                             MATREC_index num_columns, MATREC_row row, spqr_member * pMember){
     spqr_member member;
     MATREC_CALL(createMember(dec, num_columns <= 1 ? SPQR_MEMBERTYPE_LOOP : SPQR_MEMBERTYPE_PARALLEL, &member));
 
@@ -1099,7 +1761,7 @@ static MATREC_ERROR createStandaloneParallel(MATRECNetworkDecomposition *dec, MA
     MATREC_CALL(createRowArc(dec,member,&row_arc,row,num_columns <= 1));
 
     spqr_arc col_arc;
-    for (int i = 0; i < num_columns; ++i) {
+    for (MATREC_index i = 0; i < num_columns; ++i) {
         MATREC_CALL(createColumnArc(dec,member,&col_arc,columns[i],reversed[i]));
     }
     *pMember = member;
@@ -1111,7 +1773,7 @@ static MATREC_ERROR createStandaloneParallel(MATRECNetworkDecomposition *dec, MA
 
 //TODO: fix tracking connectivity more cleanly, should not be left up to the algorithms ideally
 static MATREC_ERROR createConnectedParallel(MATRECNetworkDecomposition *dec, MATREC_col * columns, bool * reversed,
-                                            int num_columns, MATREC_row row, spqr_member * pMember){
+                                            MATREC_index num_columns, MATREC_row row, spqr_member * pMember){
     spqr_member member;
     MATREC_CALL(createMember(dec, SPQR_MEMBERTYPE_PARALLEL, &member));
 
@@ -1119,7 +1781,7 @@ static MATREC_ERROR createConnectedParallel(MATRECNetworkDecomposition *dec, MAT
     MATREC_CALL(createRowArc(dec,member,&row_arc,row,false));
 
     spqr_arc col_arc;
-    for (int i = 0; i < num_columns; ++i) {
+    for (MATREC_index i = 0; i < num_columns; ++i) {
         MATREC_CALL(createColumnArc(dec,member,&col_arc,columns[i],reversed[i]));
     }
     *pMember = member;
@@ -1128,7 +1790,7 @@ static MATREC_ERROR createConnectedParallel(MATRECNetworkDecomposition *dec, MAT
 }
 
 static MATREC_ERROR createStandaloneSeries(MATRECNetworkDecomposition *dec, MATREC_row * rows, bool *reversed,
-                                           int numRows, MATREC_col col, spqr_member * pMember){
+                                           MATREC_index numRows, MATREC_col col, spqr_member * pMember){
     spqr_member member;
     MATREC_CALL(createMember(dec, numRows <= 1 ? SPQR_MEMBERTYPE_LOOP : SPQR_MEMBERTYPE_SERIES, &member));
 
@@ -1136,7 +1798,7 @@ static MATREC_ERROR createStandaloneSeries(MATRECNetworkDecomposition *dec, MATR
     MATREC_CALL(createColumnArc(dec,member,&colArc,col,false));
 
     spqr_arc rowArc;
-    for (int i = 0; i < numRows; ++i) {
+    for (MATREC_index i = 0; i < numRows; ++i) {
         MATREC_CALL(createRowArc(dec,member,&rowArc,rows[i],!reversed[i]));
     }
     *pMember = member;
@@ -1144,7 +1806,7 @@ static MATREC_ERROR createStandaloneSeries(MATRECNetworkDecomposition *dec, MATR
     return MATREC_OKAY;
 }
 static MATREC_ERROR createConnectedSeries(MATRECNetworkDecomposition *dec, MATREC_row * rows, bool *reversed,
-                                          int numRows, MATREC_col col, spqr_member * pMember){
+                                          MATREC_index numRows, MATREC_col col, spqr_member * pMember){
     spqr_member member;
     MATREC_CALL(createMember(dec, SPQR_MEMBERTYPE_SERIES, &member));//TODO: check type here if numRows <= 1?
 
@@ -1152,7 +1814,7 @@ static MATREC_ERROR createConnectedSeries(MATRECNetworkDecomposition *dec, MATRE
     MATREC_CALL(createColumnArc(dec,member,&colArc,col,false));
 
     spqr_arc rowArc;
-    for (int i = 0; i < numRows; ++i) {
+    for (MATREC_index i = 0; i < numRows; ++i) {
         MATREC_CALL(createRowArc(dec,member,&rowArc,rows[i],!reversed[i]));
     }
     *pMember = member;
@@ -1163,33 +1825,38 @@ static void removeArcFromMemberArcList(MATRECNetworkDecomposition *dec, spqr_arc
     assert(findArcMemberNoCompression(dec,arc) == member);
     assert(memberIsRepresentative(dec,member));
 
-    if(dec->members[member].numArcs == 1){
-        dec->members[member].firstArc = SPQR_INVALID_ARC;
+    if(MEMBER(dec, member).numArcs == 1){
+        MEMBER(dec, member).firstArc = SPQR_INVALID_ARC;
 
         //TODO: also set arcListNode to invalid, maybe? Not necessary probably
     }else{
-        spqr_arc nextArc = dec->arcs[arc].arcListNode.next;
-        spqr_arc prevArc = dec->arcs[arc].arcListNode.previous;
+        spqr_arc nextArc = ARC(dec, arc).arcListNode.next;
+        spqr_arc prevArc = ARC(dec, arc).arcListNode.previous;
 
-        dec->arcs[nextArc].arcListNode.previous = prevArc;
-        dec->arcs[prevArc].arcListNode.next = nextArc;
+        ARC(dec, nextArc).arcListNode.previous = prevArc;
+        ARC(dec, prevArc).arcListNode.next = nextArc;
 
-        if(dec->members[member].firstArc == arc){
-            dec->members[member].firstArc = nextArc; //TODO: fix this if we want fixed ordering for tree/nontree arcs in memory
+        if(MEMBER(dec, member).firstArc == arc){
+            MEMBER(dec, member).firstArc = nextArc; //TODO: fix this if we want fixed ordering for tree/nontree arcs in memory
         }
     }
 
 
-    --(dec->members[member].numArcs);
+    --(MEMBER(dec, member).numArcs);
 }
 
 typedef struct {
     spqr_arc arc;
     bool reversed;
 } FindCycleCall;
-static void process_arc(MATREC_row * fundamental_cycle_arcs, int * num_cycle_arcs,
+typedef struct {
+    spqr_node node;
+    spqr_arc nodeArc;
+} FindPathCall;
+static void process_arc(MATREC_row * fundamental_cycle_arcs, MATREC_index * num_cycle_arcs,
+                        MATREC_index max_cycle_arcs,
                         FindCycleCall * callStack,
-                        int * callStackSize,
+                        MATREC_index * callStackSize,
                         spqr_arc arc,
                         const MATRECNetworkDecomposition * dec,
                         bool * fundamental_cycle_direction,
@@ -1206,9 +1873,10 @@ static void process_arc(MATREC_row * fundamental_cycle_arcs, int * num_cycle_arc
         }else{
             spqr_element element = arcGetElement(dec,arc);
             assert(SPQRelementIsRow(element));
-            MATREC_row row = SPQRelementToRow(element);
-            fundamental_cycle_arcs[*num_cycle_arcs] = row;
-            fundamental_cycle_direction[*num_cycle_arcs] = arcIsReversed;
+            if(*num_cycle_arcs < max_cycle_arcs){
+                fundamental_cycle_arcs[*num_cycle_arcs] = SPQRelementToRow(element);
+                fundamental_cycle_direction[*num_cycle_arcs] = arcIsReversed;
+            }
             ++(*num_cycle_arcs);
         }
     }else{
@@ -1221,45 +1889,27 @@ static void process_arc(MATREC_row * fundamental_cycle_arcs, int * num_cycle_arc
     }
 }
 
-static int decompositionGetFundamentalCycleRows(const MATRECNetworkDecomposition *dec, MATREC_col column, MATREC_row * output,
-                                                bool * computedSignStorage){
+/**
+ * Finds the rows of the fundamental cycle of the column and whether they are reversed, using call stacks with room for
+ * dec->numArcs and dec->numNodes entries. Only the first maxRows rows are stored; the search stops once more rows
+ * are found, and then returns a number larger than maxRows. Returns -1 if the decomposition is invalid.
+ */
+static MATREC_index findFundamentalCycleRows(const MATRECNetworkDecomposition *dec, MATREC_col column, MATREC_row * output,
+                                             bool * computedSignStorage, MATREC_index maxRows,
+                                             FindCycleCall * callStack, FindPathCall * pathSearchCallStack){
     spqr_arc arc = getDecompositionColumnArc(dec, column);
     if(SPQRarcIsInvalid(arc)){
         return 0;
     }
-    int num_rows = 0;
+    MATREC_index num_rows = 0;
 
-    FindCycleCall * callStack;
-    //TODO: probably an overkill amount of memory allocated here... How can we allocate just enough?
-    MATREC_ERROR result = MATRECallocBlockArray(dec->env,&callStack,(size_t) dec->memRows);
-    if(result != MATREC_OKAY){
-        return -1;
-    }
-    int callStackSize = 1;
+    MATREC_index callStackSize = 1;
     callStack[0].arc = arc;
     callStack[0].reversed = false; //TODO: check?
 
-    bool * nodeVisited;
-    result = MATRECallocBlockArray(dec->env,&nodeVisited,(size_t) dec->numNodes);
-    if(result != MATREC_OKAY){
-        return -1;
-    }
-    for (int i = 0; i < dec->numNodes; ++i) {
-        nodeVisited[i] = false;
-    }
+    MATREC_index pathSearchCallStackSize = 0;
 
-    typedef struct {
-        spqr_node node;
-        spqr_arc nodeArc;
-    } DFSCallData;
-    DFSCallData * pathSearchCallStack;
-    result = MATRECallocBlockArray(dec->env,&pathSearchCallStack,(size_t) dec->numNodes);
-    if(result != MATREC_OKAY){
-        return -1;
-    }
-    int pathSearchCallStackSize = 0;
-
-    while(callStackSize > 0){
+    while(callStackSize > 0 && num_rows <= maxRows){
         spqr_arc column_arc = callStack[callStackSize - 1].arc;
         bool reverseEverything = callStack[callStackSize-1].reversed;
         --callStackSize;
@@ -1275,16 +1925,14 @@ static int decompositionGetFundamentalCycleRows(const MATRECNetworkDecomposition
                 pathSearchCallStack[0].nodeArc = getFirstNodeArc(dec,source);
                 pathSearchCallStackSize++;
                 while(pathSearchCallStackSize > 0){
-                    DFSCallData * dfsData  = &pathSearchCallStack[pathSearchCallStackSize-1];
-                    nodeVisited[dfsData->node] = true;
-                    //cannot be a tree arc which is its parent
+                    FindPathCall * dfsData  = &pathSearchCallStack[pathSearchCallStackSize-1];
+                    //cannot be a tree arc which is its parent. As the tree arcs form a tree, no node is visited twice
                     if(arcIsTree(dec,dfsData->nodeArc) &&
                        (pathSearchCallStackSize <= 1 || dfsData->nodeArc != pathSearchCallStack[pathSearchCallStackSize-2].nodeArc)){
                         spqr_node head = findEffectiveArcHeadNoCompression(dec, dfsData->nodeArc);
                         spqr_node tail = findEffectiveArcTailNoCompression(dec, dfsData->nodeArc);
                         spqr_node other = head == dfsData->node ? tail : head;
                         assert(other != dfsData->node);
-                        assert(!nodeVisited[other]);
                         if(other == target){
                             break;
                         }
@@ -1305,11 +1953,11 @@ static int decompositionGetFundamentalCycleRows(const MATRECNetworkDecomposition
                         }
                     }while(pathSearchCallStackSize > 0);
                 }
-                for (int i = 0; i < pathSearchCallStackSize; ++i) {
+                for (MATREC_index i = 0; i < pathSearchCallStackSize; ++i) {
                     if(arcIsTree(dec,pathSearchCallStack[i].nodeArc)){
                         bool arcReversedInPath = findEffectiveArcHeadNoCompression(dec,pathSearchCallStack[i].nodeArc) == pathSearchCallStack[i].node;
                         //TODO: also check 'reversed'
-                        process_arc(output,&num_rows,callStack,&callStackSize,pathSearchCallStack[i].nodeArc,dec,
+                        process_arc(output,&num_rows,maxRows,callStack,&callStackSize,pathSearchCallStack[i].nodeArc,dec,
                                     computedSignStorage,arcReversedInPath != reverseEverything);
                     }
                 }
@@ -1323,12 +1971,12 @@ static int decompositionGetFundamentalCycleRows(const MATRECNetworkDecomposition
 
                 spqr_arc first_arc = getFirstMemberArc(dec, column_arc_member);
                 spqr_arc iter_arc = first_arc;
-                int tree_count = 0;
+                MATREC_index tree_count = 0;
                 do
                 {
                     if(arcIsTree(dec,iter_arc)){
                         bool treeIsReversed = arcIsReversedNonRigid(dec,iter_arc);
-                        process_arc(output,&num_rows,callStack,&callStackSize,iter_arc,dec,
+                        process_arc(output,&num_rows,maxRows,callStack,&callStackSize,iter_arc,dec,
                                     computedSignStorage,(columnReversed != treeIsReversed) != reverseEverything);
                         tree_count++;
                     }
@@ -1346,12 +1994,12 @@ static int decompositionGetFundamentalCycleRows(const MATRECNetworkDecomposition
                 bool columnReversed = arcIsReversedNonRigid(dec,column_arc);
                 spqr_arc first_arc = getFirstMemberArc(dec, column_arc_member);
                 spqr_arc iter_arc = first_arc;
-                int nontree_count = 0;
+                MATREC_index nontree_count = 0;
                 do
                 {
                     if(arcIsTree(dec,iter_arc)){
                         bool treeIsReversed = arcIsReversedNonRigid(dec,iter_arc);
-                        process_arc(output,&num_rows,callStack,&callStackSize,iter_arc,dec,
+                        process_arc(output,&num_rows,maxRows,callStack,&callStackSize,iter_arc,dec,
                                     computedSignStorage,(columnReversed == treeIsReversed) != reverseEverything);
                     }else{
                         nontree_count++;
@@ -1368,8 +2016,23 @@ static int decompositionGetFundamentalCycleRows(const MATRECNetworkDecomposition
                 assert(false);
         }
     }
+    return num_rows;
+}
+
+static MATREC_index decompositionGetFundamentalCycleRows(const MATRECNetworkDecomposition *dec, MATREC_col column, MATREC_row * output,
+                                                bool * computedSignStorage){
+    FindCycleCall * callStack = NULL;
+    FindPathCall * pathSearchCallStack = NULL;
+    if(MATRECallocBlockArray(dec->env,&callStack,(size_t) dec->numArcs + 1) != MATREC_OKAY){
+        return -1;
+    }
+    if(MATRECallocBlockArray(dec->env,&pathSearchCallStack,(size_t) dec->numNodes + 1) != MATREC_OKAY){
+        MATRECfreeBlockArray(dec->env,&callStack);
+        return -1;
+    }
+    MATREC_index num_rows = findFundamentalCycleRows(dec,column,output,computedSignStorage,dec->numArcs,
+                                                     callStack,pathSearchCallStack);
     MATRECfreeBlockArray(dec->env,&pathSearchCallStack);
-    MATRECfreeBlockArray(dec->env,&nodeVisited);
     MATRECfreeBlockArray(dec->env,&callStack);
     return num_rows;
 }
@@ -1393,12 +2056,12 @@ static int qsort_comparison (const void * a, const void * b)
     }
 }
 bool MATRECNetworkDecompositionVerifyCycle(const MATRECNetworkDecomposition * dec, MATREC_col column, MATREC_row * column_rows,
-                                           double * column_values, int num_rows,
+                                           double * column_values, MATREC_matrix_size num_rows,
                                            MATREC_row * computed_column_storage,
                                            bool * computedSignStorage){
-    int num_found_rows = decompositionGetFundamentalCycleRows(dec,column,computed_column_storage,computedSignStorage);
+    MATREC_index num_found_rows = decompositionGetFundamentalCycleRows(dec,column,computed_column_storage,computedSignStorage);
 
-    if(num_found_rows != num_rows){
+    if(num_found_rows < 0 || (MATREC_matrix_size) num_found_rows != num_rows){
         return false;
     }
     if(num_rows == 0){
@@ -1406,21 +2069,21 @@ bool MATRECNetworkDecompositionVerifyCycle(const MATRECNetworkDecomposition * de
     }
 
     Nonzero array[num_rows];
-    for (int i = 0; i < num_rows; ++i) {
+    for (MATREC_matrix_size i = 0; i < num_rows; ++i) {
         array[i].row = computed_column_storage[i];
         array[i].reversed = computedSignStorage[i];
     }
     qsort(array,(size_t) num_rows,sizeof(Nonzero),qsort_comparison);
 
     Nonzero secondArray[num_rows];
-    for (int i = 0; i < num_rows; ++i) {
+    for (MATREC_matrix_size i = 0; i < num_rows; ++i) {
         secondArray[i].row = column_rows[i];
         secondArray[i].reversed = column_values[i] < 0.0;
     }
 
     qsort(secondArray,(size_t) num_rows,sizeof(Nonzero),qsort_comparison);
 
-    for (int i = 0; i < num_rows; ++i) {
+    for (MATREC_matrix_size i = 0; i < num_rows; ++i) {
         if(array[i].row != secondArray[i].row){
             return false;
         }
@@ -1431,6 +2094,248 @@ bool MATRECNetworkDecompositionVerifyCycle(const MATRECNetworkDecomposition * de
     return true;
 }
 
+MATREC_ERROR MATRECNetworkDecompositionFundamentalCycle(const MATRECNetworkDecomposition *dec, MATREC_col column,
+                                                       MATREC_row *rows, bool *reversed, MATREC_matrix_size *numRows){
+    assert(dec);
+    assert(numRows);
+    MATREC_index numFound = decompositionGetFundamentalCycleRows(dec,column,rows,reversed);
+    if(numFound < 0){
+        return MATREC_ERROR_MEMORY;
+    }
+    *numRows = (MATREC_matrix_size) numFound;
+    return MATREC_OKAY;
+}
+
+///Roots the spanning tree of the tree arcs of a rigid member, storing for each node the tree arc to its parent
+static void rootRigidMember(const MATRECNetworkDecomposition *dec, spqr_member member, spqr_arc * nodeParentArc,
+                            MATREC_index * nodeDepth, spqr_node * queue){
+    spqr_node root = findEffectiveArcTailNoCompression(dec,getFirstMemberArc(dec,member));
+    nodeParentArc[root] = SPQR_INVALID_ARC;
+    nodeDepth[root] = 0;
+    queue[0] = root;
+    MATREC_index queueSize = 1;
+    for (MATREC_index i = 0; i < queueSize; ++i) {
+        spqr_node node = queue[i];
+        spqr_arc first = getFirstNodeArc(dec,node);
+        spqr_arc arc = first;
+        do{
+            if(arcIsTree(dec,arc) && arc != nodeParentArc[node]){
+                spqr_node head = findEffectiveArcHeadNoCompression(dec,arc);
+                spqr_node other = head == node ? findEffectiveArcTailNoCompression(dec,arc) : head;
+                nodeParentArc[other] = arc;
+                nodeDepth[other] = nodeDepth[node] + 1;
+                queue[queueSize] = other;
+                ++queueSize;
+            }
+            arc = getNextNodeArcNoCompression(dec,arc,node);
+        }while(arc != first);
+    }
+}
+
+MATREC_ERROR MATRECNetworkDecompositionCreateMatrix(const MATRECNetworkDecomposition *dec, MATRECCSMatrixInt **pMatrix){
+    assert(dec);
+    assert(pMatrix);
+    assert(!*pMatrix);
+    MATREC * env = dec->env;
+
+    //Find the dimensions, and sort the column arcs by their column using a table of all column indices
+    MATREC_matrix_size numRows = 0;
+    MATREC_matrix_size numColumns = 0;
+    MATREC_index numRowArcs = 0;
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(!memberIsRepresentative(dec,member) || SPQRarcIsInvalid(getFirstMemberArc(dec,member))){
+            continue;
+        }
+        spqr_arc first = getFirstMemberArc(dec,member);
+        spqr_arc arc = first;
+        do{
+            spqr_element element = arcGetElement(dec,arc);
+            if(element != MARKER_ROW_ELEMENT && SPQRelementIsRow(element)){
+                MATREC_row row = SPQRelementToRow(element);
+                numRows = row + 1 > numRows ? row + 1 : numRows;
+                ++numRowArcs;
+            }else if(element != MARKER_COLUMN_ELEMENT && SPQRelementIsColumn(element)){
+                MATREC_col col = SPQRelementToColumn(element);
+                numColumns = col + 1 > numColumns ? col + 1 : numColumns;
+            }
+            arc = getNextMemberArc(dec,arc);
+        }while(arc != first);
+    }
+    spqr_arc * columnArcs = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&columnArcs,(size_t) numColumns + 1));
+    for (MATREC_matrix_size col = 0; col < numColumns; ++col) {
+        columnArcs[col] = SPQR_INVALID_ARC;
+    }
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        if(!memberIsRepresentative(dec,member) || SPQRarcIsInvalid(getFirstMemberArc(dec,member))){
+            continue;
+        }
+        spqr_arc first = getFirstMemberArc(dec,member);
+        spqr_arc arc = first;
+        do{
+            spqr_element element = arcGetElement(dec,arc);
+            if(element != MARKER_COLUMN_ELEMENT && SPQRelementIsColumn(element)){
+                columnArcs[SPQRelementToColumn(element)] = arc;
+            }
+            arc = getNextMemberArc(dec,arc);
+        }while(arc != first);
+    }
+
+    //Rigid members are rooted and parallel members have their tree arc found the first time a cycle passes them,
+    //so that each cycle is traced in time linear in its length
+    FindCycleCall * callStack = NULL;
+    spqr_arc * nodeParentArc = NULL;
+    MATREC_index * nodeDepth = NULL;
+    spqr_node * queue = NULL;
+    spqr_arc * memberTreeArc = NULL;
+    bool * memberVisited = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&callStack,(size_t) dec->numArcs + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeParentArc,(size_t) dec->numNodes + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeDepth,(size_t) dec->numNodes + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&queue,(size_t) dec->numNodes + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&memberTreeArc,(size_t) dec->numMembers + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&memberVisited,(size_t) dec->numMembers + 1));
+    for (spqr_member member = 0; member < dec->numMembers; ++member) {
+        memberVisited[member] = false;
+    }
+
+    //The nonzeros in column order; each cycle has at most one nonzero for every row arc
+    MATREC_index memEntries = numRowArcs + 1;
+    MATREC_index numEntries = 0;
+    MATREC_row * entryRows = NULL;
+    bool * entryReversed = NULL;
+    MATREC_col * entryColumns = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&entryRows,(size_t) memEntries));
+    MATREC_CALL(MATRECallocBlockArray(env,&entryReversed,(size_t) memEntries));
+    MATREC_CALL(MATRECallocBlockArray(env,&entryColumns,(size_t) memEntries));
+
+    for (MATREC_matrix_size col = 0; col < numColumns; ++col) {
+        if(SPQRarcIsInvalid(columnArcs[col])){
+            continue;
+        }
+        if(numEntries + numRowArcs > memEntries){
+            memEntries = 2 * memEntries > numEntries + numRowArcs ? 2 * memEntries : numEntries + numRowArcs;
+            MATREC_CALL(MATRECreallocBlockArray(env,&entryRows,(size_t) memEntries));
+            MATREC_CALL(MATRECreallocBlockArray(env,&entryReversed,(size_t) memEntries));
+            MATREC_CALL(MATRECreallocBlockArray(env,&entryColumns,(size_t) memEntries));
+        }
+        MATREC_index columnStart = numEntries;
+        MATREC_index callStackSize = 1;
+        callStack[0].arc = columnArcs[col];
+        callStack[0].reversed = false;
+        while(callStackSize > 0){
+            spqr_arc columnArc = callStack[callStackSize - 1].arc;
+            bool reverseEverything = callStack[callStackSize - 1].reversed;
+            --callStackSize;
+            spqr_member member = findArcMemberNoCompression(dec,columnArc);
+            switch(getMemberType(dec,member)){
+                case SPQR_MEMBERTYPE_RIGID:
+                {
+                    if(!memberVisited[member]){
+                        rootRigidMember(dec,member,nodeParentArc,nodeDepth,queue);
+                        memberVisited[member] = true;
+                    }
+                    //Walk up from both ends of the arc until the paths meet
+                    spqr_node source = findEffectiveArcTailNoCompression(dec,columnArc);
+                    spqr_node target = findEffectiveArcHeadNoCompression(dec,columnArc);
+                    while(source != target){
+                        if(nodeDepth[source] >= nodeDepth[target]){
+                            spqr_arc arc = nodeParentArc[source];
+                            spqr_node head = findEffectiveArcHeadNoCompression(dec,arc);
+                            process_arc(entryRows,&numEntries,memEntries,callStack,&callStackSize,arc,dec,entryReversed,
+                                        (head == source) != reverseEverything);
+                            source = head == source ? findEffectiveArcTailNoCompression(dec,arc) : head;
+                        }else{
+                            spqr_arc arc = nodeParentArc[target];
+                            spqr_node head = findEffectiveArcHeadNoCompression(dec,arc);
+                            process_arc(entryRows,&numEntries,memEntries,callStack,&callStackSize,arc,dec,entryReversed,
+                                        (head != target) != reverseEverything);
+                            target = head == target ? findEffectiveArcTailNoCompression(dec,arc) : head;
+                        }
+                    }
+                    break;
+                }
+                case SPQR_MEMBERTYPE_PARALLEL:
+                {
+                    if(!memberVisited[member]){
+                        spqr_arc first = getFirstMemberArc(dec,member);
+                        spqr_arc arc = first;
+                        do{
+                            if(arcIsTree(dec,arc)){
+                                memberTreeArc[member] = arc;
+                            }
+                            arc = getNextMemberArc(dec,arc);
+                        }while(arc != first);
+                        memberVisited[member] = true;
+                    }
+                    spqr_arc treeArc = memberTreeArc[member];
+                    process_arc(entryRows,&numEntries,memEntries,callStack,&callStackSize,treeArc,dec,entryReversed,
+                                (arcIsReversedNonRigid(dec,columnArc) != arcIsReversedNonRigid(dec,treeArc)) != reverseEverything);
+                    break;
+                }
+                case SPQR_MEMBERTYPE_LOOP:
+                case SPQR_MEMBERTYPE_SERIES:
+                {
+                    //All other arcs are tree arcs, so this is linear in the length of the cycle
+                    bool columnReversed = arcIsReversedNonRigid(dec,columnArc);
+                    spqr_arc first = getFirstMemberArc(dec,member);
+                    spqr_arc arc = first;
+                    do{
+                        if(arcIsTree(dec,arc)){
+                            process_arc(entryRows,&numEntries,memEntries,callStack,&callStackSize,arc,dec,entryReversed,
+                                        (columnReversed == arcIsReversedNonRigid(dec,arc)) != reverseEverything);
+                        }
+                        arc = getNextMemberArc(dec,arc);
+                    }while(arc != first);
+                    break;
+                }
+                case SPQR_MEMBERTYPE_UNASSIGNED:
+                    assert(false);
+            }
+        }
+        for (MATREC_index i = columnStart; i < numEntries; ++i) {
+            entryColumns[i] = col;
+        }
+    }
+
+    //Counting sort of the nonzeros by row, which keeps the columns of each row in increasing order
+    MATREC_ERROR result = MATRECcreateIntMatrix(env,pMatrix,numRows,numColumns,(MATREC_matrix_size) numEntries);
+    if(result == MATREC_OKAY){
+        MATRECCSMatrixInt * matrix = *pMatrix;
+        for (MATREC_matrix_size row = 0; row <= numRows; ++row) {
+            matrix->firstRowIndex[row] = 0;
+        }
+        for (MATREC_index i = 0; i < numEntries; ++i) {
+            ++matrix->firstRowIndex[entryRows[i] + 1];
+        }
+        for (MATREC_matrix_size row = 0; row < numRows; ++row) {
+            matrix->firstRowIndex[row + 1] += matrix->firstRowIndex[row];
+        }
+        for (MATREC_index i = 0; i < numEntries; ++i) {
+            MATREC_matrix_size position = matrix->firstRowIndex[entryRows[i]];
+            matrix->entryColumns[position] = entryColumns[i];
+            matrix->entryValues[position] = entryReversed[i] ? -1 : 1;
+            ++matrix->firstRowIndex[entryRows[i]];
+        }
+        for (MATREC_matrix_size row = numRows; row > 0; --row) {
+            matrix->firstRowIndex[row] = matrix->firstRowIndex[row - 1];
+        }
+        matrix->firstRowIndex[0] = 0;
+    }
+
+    MATRECfreeBlockArray(env,&entryColumns);
+    MATRECfreeBlockArray(env,&entryReversed);
+    MATRECfreeBlockArray(env,&entryRows);
+    MATRECfreeBlockArray(env,&memberVisited);
+    MATRECfreeBlockArray(env,&memberTreeArc);
+    MATRECfreeBlockArray(env,&queue);
+    MATRECfreeBlockArray(env,&nodeDepth);
+    MATRECfreeBlockArray(env,&nodeParentArc);
+    MATRECfreeBlockArray(env,&callStack);
+    MATRECfreeBlockArray(env,&columnArcs);
+    return result;
+}
+
 static spqr_member largestMemberID(const MATRECNetworkDecomposition *dec){
     return dec->numMembers;
 }
@@ -1440,14 +2345,14 @@ static spqr_arc largestArcID(const MATRECNetworkDecomposition *dec){
 static spqr_node largestNodeID(const MATRECNetworkDecomposition *dec){
     return dec->numNodes;
 }
-static int numConnectedComponents(const MATRECNetworkDecomposition *dec){
+static MATREC_index numConnectedComponents(const MATRECNetworkDecomposition *dec){
     return dec->numConnectedComponents;
 }
 static MATREC_ERROR createChildMarker(MATRECNetworkDecomposition *dec, spqr_member member, spqr_member child, bool isTree,
                                     spqr_arc * pArc, bool reversed){
     MATREC_CALL(createArc(dec,member,reversed,pArc)); //TODO: fix
-    dec->arcs[*pArc].element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
-    dec->arcs[*pArc].childMember = child;
+    ARC(dec, *pArc).element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
+    ARC(dec, *pArc).childMember = child;
 
     addArcToMemberArcList(dec,*pArc,member);
     return MATREC_OKAY;
@@ -1456,13 +2361,13 @@ static MATREC_ERROR createParentMarker(MATRECNetworkDecomposition *dec, spqr_mem
         , spqr_arc * arc,bool reversed){
 
     MATREC_CALL(createArc(dec,member,reversed,arc)); //TODO: fix
-    dec->arcs[*arc].element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
+    ARC(dec, *arc).element = isTree ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
 
     addArcToMemberArcList(dec,*arc,member);
 
-    dec->members[member].parentMember = parent;
-    dec->members[member].markerOfParent = parentMarker;
-    dec->members[member].markerToParent = *arc;
+    setMemberParent(dec,member,parent);
+    MEMBER(dec, member).markerOfParent = parentMarker;
+    MEMBER(dec, member).markerToParent = *arc;
     return MATREC_OKAY;
 }
 static MATREC_ERROR createMarkerPair(MATRECNetworkDecomposition *dec, spqr_member parentMember, spqr_member childMember,
@@ -1487,6 +2392,176 @@ static MATREC_ERROR createMarkerPairWithReferences(MATRECNetworkDecomposition *d
     return MATREC_OKAY;
 }
 
+///Orients the arcs of a member which was created from a split component. The arcs of the component are given in the
+///order of the component, and each arc is directed from the tail to the head of the edge of the component.
+static MATREC_ERROR orientComponentArcs(MATRECNetworkDecomposition *dec, const MATRECSplitComponents *components,
+                                        MATREC_index component, const spqr_arc *arcs, spqr_node *nodeOf,
+                                        MATREC_index *nodeStamp){
+    MATREC_index start = components->componentStarts[component];
+    MATREC_index numArcs = components->componentStarts[component + 1] - start;
+    const MATREC_index *edges = &components->componentEdges[start];
+    switch(components->componentTypes[component]){
+        case MATREC_SPLIT_RIGID:{
+            for (MATREC_index i = 0; i < numArcs; ++i) {
+                MATREC_index endpoints[2] = {components->edgeHeads[edges[i]],components->edgeTails[edges[i]]};
+                for (int j = 0; j < 2; ++j) {
+                    if(nodeStamp[endpoints[j]] != component){
+                        nodeStamp[endpoints[j]] = component;
+                        MATREC_CALL(createNode(dec,&nodeOf[endpoints[j]]));
+                    }
+                }
+                setArcHeadAndTail(dec,arcs[i],nodeOf[endpoints[0]],nodeOf[endpoints[1]]);
+                arcSetReversed(dec,arcs[i],false);
+                arcSetRepresentative(dec,arcs[i],i == 0 ? SPQR_INVALID_ARC : arcs[0]);
+            }
+            break;
+        }
+        case MATREC_SPLIT_BOND:{
+            //Unreversed arcs of a parallel member all point in the same direction
+            for (MATREC_index i = 0; i < numArcs; ++i) {
+                arcSetReversed(dec,arcs[i],components->edgeTails[edges[i]] != components->edgeTails[edges[0]]);
+            }
+            break;
+        }
+        case MATREC_SPLIT_POLYGON:{
+            //A single row forms a loop with a reversed row arc, like a row which is added without nonzeros
+            if(numArcs == 1){
+                arcSetReversed(dec,arcs[0],arcIsTree(dec,arcs[0]));
+                break;
+            }
+            //Unreversed arcs of a series member all point in the same direction along the cycle
+            MATREC_index node = components->edgeTails[edges[0]];
+            if(numArcs >= 3 && (node == components->edgeTails[edges[1]] || node == components->edgeHeads[edges[1]])){
+                node = components->edgeHeads[edges[0]];
+            }
+            for (MATREC_index i = 0; i < numArcs; ++i) {
+                bool forward = components->edgeTails[edges[i]] == node;
+                arcSetReversed(dec,arcs[i],!forward);
+                node = forward ? components->edgeHeads[edges[i]] : components->edgeTails[edges[i]];
+            }
+            break;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+///Creates the members of a decomposition from the split components of the graph and their tree
+static MATREC_ERROR createComponentMembers(MATRECNetworkDecomposition *dec, const MATRECSplitComponents *components,
+                                           const MATRECElement *edgeElements){
+    MATREC * env = dec->env;
+    MATREC_index numComponents = components->numComponents;
+    spqr_member * componentMember = NULL;
+    spqr_arc * parentMarker = NULL;
+    spqr_arc * arcs = NULL;
+    spqr_node * nodeOf = NULL;
+    MATREC_index * nodeStamp = NULL;
+    MATREC_index maxComponentSize = 1;
+    for (MATREC_index component = 0; component < numComponents; ++component) {
+        MATREC_index size = components->componentStarts[component + 1] - components->componentStarts[component];
+        maxComponentSize = size > maxComponentSize ? size : maxComponentSize;
+    }
+    MATREC_CALL(MATRECallocBlockArray(env,&componentMember,(size_t) (numComponents + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&parentMarker,(size_t) (numComponents + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&arcs,(size_t) maxComponentSize));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeOf,(size_t) (components->numNodes + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeStamp,(size_t) (components->numNodes + 1)));
+    for (MATREC_index node = 0; node < components->numNodes; ++node) {
+        nodeStamp[node] = -1;
+    }
+
+    for (MATREC_index component = 0; component < numComponents; ++component) {
+        MATREC_index size = components->componentStarts[component + 1] - components->componentStarts[component];
+        SPQRMemberType type;
+        switch(components->componentTypes[component]){
+            case MATREC_SPLIT_RIGID:
+                type = SPQR_MEMBERTYPE_RIGID;
+                break;
+            case MATREC_SPLIT_BOND:
+                type = SPQR_MEMBERTYPE_PARALLEL;
+                break;
+            case MATREC_SPLIT_POLYGON:
+            default:
+                type = size <= 2 ? SPQR_MEMBERTYPE_LOOP : SPQR_MEMBERTYPE_SERIES;
+                break;
+        }
+        MATREC_CALL(createMember(dec,type,&componentMember[component]));
+    }
+    for (MATREC_index index = 0; index < numComponents; ++index) {
+        MATREC_index component = components->componentOrder[index];
+        spqr_member member = componentMember[component];
+        if(components->componentParent[component] < 0){
+            ++dec->numConnectedComponents;
+        }
+        MATREC_index start = components->componentStarts[component];
+        MATREC_index end = components->componentStarts[component + 1];
+        for (MATREC_index i = start; i < end; ++i) {
+            MATREC_index edge = components->componentEdges[i];
+            if(edge < components->numGraphEdges){
+                if(edgeElements[edge].isRow){
+                    MATREC_CALL(createRowArc(dec,member,&arcs[i - start],edgeElements[edge].index,false));
+                }else{
+                    MATREC_CALL(createColumnArc(dec,member,&arcs[i - start],edgeElements[edge].index,false));
+                }
+            }else if(edge == components->componentParentEdge[component]){
+                arcs[i - start] = parentMarker[component];
+            }else{
+                MATREC_index child = components->edgeChild[edge];
+                MATREC_CALL(createMarkerPairWithReferences(dec,member,componentMember[child],
+                                                           components->componentTreeInParent[child],false,false,
+                                                           &arcs[i - start],&parentMarker[child]));
+            }
+        }
+        MATREC_CALL(orientComponentArcs(dec,components,component,arcs,nodeOf,nodeStamp));
+    }
+
+    MATRECfreeBlockArray(env,&nodeStamp);
+    MATRECfreeBlockArray(env,&nodeOf);
+    MATRECfreeBlockArray(env,&arcs);
+    MATRECfreeBlockArray(env,&parentMarker);
+    MATRECfreeBlockArray(env,&componentMember);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkDecompositionCreateFromGraph(MATREC * env, MATRECNetworkDecomposition **pDecomposition,
+                                                       MATREC_matrix_size numNodes, MATREC_matrix_size numEdges,
+                                                       const MATREC_matrix_size * edgeTails,
+                                                       const MATREC_matrix_size * edgeHeads,
+                                                       const MATRECElement * edgeElements){
+    assert(env);
+    assert(pDecomposition && !*pDecomposition);
+    assert(numEdges == 0 || (edgeTails && edgeHeads && edgeElements));
+    if(numNodes >= (MATREC_matrix_size) MATREC_INDEX_MAX || numEdges >= (MATREC_matrix_size) MATREC_INDEX_MAX){
+        return MATREC_ERROR_INPUT;
+    }
+    MATREC_ERROR error = MATRECcheckGraphRealization(env,(MATREC_index) numNodes,(MATREC_index) numEdges,edgeTails,
+                                                     edgeHeads,edgeElements);
+    if(error != MATREC_OKAY){
+        return error;
+    }
+    MATREC_matrix_size numRows = 0;
+    MATREC_matrix_size numColumns = 0;
+    for (MATREC_matrix_size edge = 0; edge < numEdges; ++edge) {
+        MATREC_matrix_size * size = edgeElements[edge].isRow ? &numRows : &numColumns;
+        *size = edgeElements[edge].index + 1 > *size ? edgeElements[edge].index + 1 : *size;
+    }
+
+    MATRECSplitComponents * components = NULL;
+    MATREC_CALL(MATRECsplitComponentsCreate(env,&components,(MATREC_index) numNodes,(MATREC_index) numEdges,
+                                            edgeTails,edgeHeads));
+    MATREC_CALL(MATRECsplitComponentsBuildTree(env,components,edgeElements));
+    MATREC_CALL(createDecomposition(env,pDecomposition,numRows,numColumns,MATREC_IDS_DENSE,MATREC_IDS_DENSE));
+    MATREC_CALL(createComponentMembers(*pDecomposition,components,edgeElements));
+    MATRECsplitComponentsFree(env,&components);
+    if(MATRECtraceIsActive(env)){
+        MATRECTraceWriter writer;
+        MATRECtraceBegin(env, &writer, MATREC_TRACE_NETWORK_CREATE_FROM_GRAPH);
+        MATRECtraceWriteDecomposition(&writer, &(*pDecomposition)->traceId);
+        MATRECtraceWriteGraph(&writer, numNodes, numEdges, edgeTails, edgeHeads, edgeElements);
+        MATRECtraceEnd(&writer);
+    }
+    return MATREC_OKAY;
+}
+
 static void moveArcToNewMember(MATRECNetworkDecomposition *dec, spqr_arc arc, spqr_member oldMember, spqr_member newMember){
     assert(SPQRarcIsValid(arc));
     assert(arc < dec->memArcs);
@@ -1500,22 +2575,22 @@ static void moveArcToNewMember(MATRECNetworkDecomposition *dec, spqr_arc arc, sp
     removeArcFromMemberArcList(dec,arc,oldMember);
     addArcToMemberArcList(dec,arc,newMember);
 
-    dec->arcs[arc].member = newMember;
+    ARC(dec, arc).member = newMember;
 
     //If this arc has a childMember, update the information correctly!
-    spqr_member childMember = dec->arcs[arc].childMember;
+    spqr_member childMember = ARC(dec, arc).childMember;
     if(SPQRmemberIsValid(childMember)){
         spqr_member childRepresentative = findArcChildMember(dec, arc);
-        dec->members[childRepresentative].parentMember = newMember;
+        setMemberParent(dec,childRepresentative,newMember);
     }
     //If this arc is a marker to the parent, update the child arc marker of the parent to reflect the move
-    if(dec->members[oldMember].markerToParent == arc){
-        dec->members[newMember].markerToParent = arc;
-        dec->members[newMember].parentMember = dec->members[oldMember].parentMember;
-        dec->members[newMember].markerOfParent = dec->members[oldMember].markerOfParent;
+    if(MEMBER(dec, oldMember).markerToParent == arc){
+        MEMBER(dec, newMember).markerToParent = arc;
+        setMemberParent(dec,newMember,MEMBER(dec, oldMember).parentMember);
+        MEMBER(dec, newMember).markerOfParent = MEMBER(dec, oldMember).markerOfParent;
 
-        assert(findArcChildMemberNoCompression(dec,dec->members[oldMember].markerOfParent) == oldMember);
-        dec->arcs[dec->members[oldMember].markerOfParent].childMember = newMember;
+        assert(findArcChildMemberNoCompression(dec,MEMBER(dec, oldMember).markerOfParent) == oldMember);
+        ARC(dec, MEMBER(dec, oldMember).markerOfParent).childMember = newMember;
     }
 }
 static void mergeMemberArcList(MATRECNetworkDecomposition *dec, spqr_member toMergeInto, spqr_member toRemove){
@@ -1528,15 +2603,15 @@ static void mergeMemberArcList(MATRECNetworkDecomposition *dec, spqr_member toMe
     spqr_arc lastFromArc = getPreviousMemberArc(dec, firstFromArc);
 
     //Relink linked lists to merge them effectively
-    dec->arcs[firstIntoArc].arcListNode.previous = lastFromArc;
-    dec->arcs[lastIntoArc].arcListNode.next = firstFromArc;
-    dec->arcs[firstFromArc].arcListNode.previous = lastIntoArc;
-    dec->arcs[lastFromArc].arcListNode.next = firstIntoArc;
+    ARC(dec, firstIntoArc).arcListNode.previous = lastFromArc;
+    ARC(dec, lastIntoArc).arcListNode.next = firstFromArc;
+    ARC(dec, firstFromArc).arcListNode.previous = lastIntoArc;
+    ARC(dec, lastFromArc).arcListNode.next = firstIntoArc;
 
     //Clean up old
-    dec->members[toMergeInto].numArcs += dec->members[toRemove].numArcs;
-    dec->members[toRemove].numArcs = 0;
-    dec->members[toRemove].firstArc = SPQR_INVALID_ARC;
+    MEMBER(dec, toMergeInto).numArcs += MEMBER(dec, toRemove).numArcs;
+    MEMBER(dec, toRemove).numArcs = 0;
+    MEMBER(dec, toRemove).firstArc = SPQR_INVALID_ARC;
 
 }
 
@@ -1547,7 +2622,7 @@ static void changeLoopToSeries(MATRECNetworkDecomposition * dec, spqr_member mem
     assert((getMemberType(dec,member) == SPQR_MEMBERTYPE_PARALLEL || getMemberType(dec, member) == SPQR_MEMBERTYPE_SERIES ||
             getMemberType(dec,member) == SPQR_MEMBERTYPE_LOOP) && getNumMemberArcs(dec, member) == 2);
     assert(memberIsRepresentative(dec,member));
-    dec->members[member].type = SPQR_MEMBERTYPE_SERIES;
+    MEMBER(dec, member).type = SPQR_MEMBERTYPE_SERIES;
 }
 static void changeLoopToParallel(MATRECNetworkDecomposition * dec, spqr_member member){
     assert(SPQRmemberIsValid(member));
@@ -1556,7 +2631,7 @@ static void changeLoopToParallel(MATRECNetworkDecomposition * dec, spqr_member m
     assert((getMemberType(dec,member) == SPQR_MEMBERTYPE_PARALLEL || getMemberType(dec, member) == SPQR_MEMBERTYPE_SERIES ||
             getMemberType(dec,member) == SPQR_MEMBERTYPE_LOOP) && getNumMemberArcs(dec, member) == 2);
     assert(memberIsRepresentative(dec,member));
-    dec->members[member].type = SPQR_MEMBERTYPE_PARALLEL;
+    MEMBER(dec, member).type = SPQR_MEMBERTYPE_PARALLEL;
 }
 bool MATRECNetworkDecompositionIsMinimal(const MATRECNetworkDecomposition * dec){
     //Relies on parents/children etc. being set correctly in the tree
@@ -1580,7 +2655,7 @@ bool MATRECNetworkDecompositionIsMinimal(const MATRECNetworkDecomposition * dec)
     return isMinimal;
 }
 
-static void decreaseNumConnectedComponents(MATRECNetworkDecomposition *dec, int by){
+static void decreaseNumConnectedComponents(MATRECNetworkDecomposition *dec, MATREC_index by){
     dec->numConnectedComponents-= by;
     assert(dec->numConnectedComponents >= 1);
 }
@@ -1589,25 +2664,27 @@ static void reorderComponent(MATRECNetworkDecomposition *dec, spqr_member newRoo
     assert(dec);
     assert(memberIsRepresentative(dec,newRoot));
     //If the newRoot has no parent, it is already the root, so then there's no need to reorder.
-    if(SPQRmemberIsValid(dec->members[newRoot].parentMember)){
+    if(SPQRmemberIsValid(MEMBER(dec, newRoot).parentMember)){
         spqr_member member = findMemberParent(dec, newRoot);
         spqr_member newParent = newRoot;
-        spqr_arc newMarkerToParent = dec->members[newRoot].markerOfParent;
-        spqr_arc markerOfNewParent = dec->members[newRoot].markerToParent;
+        spqr_arc newMarkerToParent = MEMBER(dec, newRoot).markerOfParent;
+        spqr_arc markerOfNewParent = MEMBER(dec, newRoot).markerToParent;
 
         //Recursively update the parent
         do{
             assert(SPQRmemberIsValid(member));
             assert(SPQRmemberIsValid(newParent));
             spqr_member oldParent = findMemberParent(dec, member);
-            spqr_arc oldMarkerToParent = dec->members[member].markerToParent;
-            spqr_arc oldMarkerOfParent = dec->members[member].markerOfParent;
+            spqr_arc oldMarkerToParent = MEMBER(dec, member).markerToParent;
+            spqr_arc oldMarkerOfParent = MEMBER(dec, member).markerOfParent;
 
-            dec->members[member].markerToParent = newMarkerToParent;
-            dec->members[member].markerOfParent = markerOfNewParent;
-            dec->members[member].parentMember = newParent;
-            dec->arcs[markerOfNewParent].childMember = member;
-            dec->arcs[newMarkerToParent].childMember = SPQR_INVALID_MEMBER;
+            recordReplicaChange(dec, REPLICA_ARC, markerOfNewParent);
+            recordReplicaChange(dec, REPLICA_ARC, newMarkerToParent);
+            MEMBER(dec, member).markerToParent = newMarkerToParent;
+            MEMBER(dec, member).markerOfParent = markerOfNewParent;
+            setMemberParent(dec,member,newParent);
+            ARC(dec, markerOfNewParent).childMember = member;
+            ARC(dec, newMarkerToParent).childMember = SPQR_INVALID_MEMBER;
 
             if (SPQRmemberIsValid(oldParent)){
                 newParent = member;
@@ -1618,9 +2695,10 @@ static void reorderComponent(MATRECNetworkDecomposition *dec, spqr_member newRoo
                 break;
             }
         }while(true);
-        dec->members[newRoot].parentMember = SPQR_INVALID_MEMBER;
-        dec->members[newRoot].markerToParent = SPQR_INVALID_ARC;
-        dec->members[newRoot].markerOfParent = SPQR_INVALID_ARC;
+        recordReplicaChange(dec, REPLICA_MEMBER, newRoot);
+        MEMBER(dec, newRoot).parentMember = SPQR_INVALID_MEMBER;
+        MEMBER(dec, newRoot).markerToParent = SPQR_INVALID_ARC;
+        MEMBER(dec, newRoot).markerOfParent = SPQR_INVALID_ARC;
 
     }
 }
@@ -1633,43 +2711,43 @@ static void arcToDot(FILE * stream, const MATRECNetworkDecomposition * dec,
     char type = typeToChar(member_type);
     const char* color = arcIsTree(dec,arc) ? ",color=red" :",color=blue";
 
-    int arc_name = arc;
+    MATREC_index arc_name = arc;
 
     if(markerToParent(dec,member) == arc){
         if(useElementNames){
             arc_name = -1;
         }
-        fprintf(stream, "    %c_%d_%lu -> %c_p_%d [label=\"%d\",style=dashed%s];\n", type, member, dot_tail, type, member, arc_name, color);
-        fprintf(stream, "    %c_p_%d -> %c_%d_%lu [label=\"%d\",style=dashed%s];\n", type, member, type, member, dot_head, arc_name, color);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_tail);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_head);
-        fprintf(stream, "    %c_p_%d [style=dashed];\n", type, member);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu -> %c_p_%" MATREC_PRIindex " [label=\"%" MATREC_PRIindex "\",style=dashed%s];\n", type, member, dot_tail, type, member, arc_name, color);
+        fprintf(stream, "    %c_p_%" MATREC_PRIindex " -> %c_%" MATREC_PRIindex "_%lu [label=\"%" MATREC_PRIindex "\",style=dashed%s];\n", type, member, type, member, dot_head, arc_name, color);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_tail);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_head);
+        fprintf(stream, "    %c_p_%" MATREC_PRIindex " [style=dashed];\n", type, member);
     }else if(arcIsMarker(dec,arc)){
         spqr_member child = findArcChildMemberNoCompression(dec, arc);
         char childType = typeToChar(getMemberType(dec,child));
         if(useElementNames){
             arc_name = -1;
         }
-        fprintf(stream, "    %c_%d_%lu -> %c_c_%d [label=\"%d\",style=dotted%s];\n", type, member, dot_tail, type, child, arc_name, color);
-        fprintf(stream, "    %c_c_%d -> %c_%d_%lu [label=\"%d\",style=dotted%s];\n", type, child, type, member, dot_head, arc_name, color);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_tail);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_head);
-        fprintf(stream, "    %c_c_%d [style=dotted];\n", type, child);
-        fprintf(stream, "    %c_p_%d -> %c_c_%d [style=dashed,dir=forward];\n", childType, child, type, child);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu -> %c_c_%" MATREC_PRIindex " [label=\"%" MATREC_PRIindex "\",style=dotted%s];\n", type, member, dot_tail, type, child, arc_name, color);
+        fprintf(stream, "    %c_c_%" MATREC_PRIindex " -> %c_%" MATREC_PRIindex "_%lu [label=\"%" MATREC_PRIindex "\",style=dotted%s];\n", type, child, type, member, dot_head, arc_name, color);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_tail);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_head);
+        fprintf(stream, "    %c_c_%" MATREC_PRIindex " [style=dotted];\n", type, child);
+        fprintf(stream, "    %c_p_%" MATREC_PRIindex " -> %c_c_%" MATREC_PRIindex " [style=dashed,dir=forward];\n", childType, child, type, child);
     }else{
         if(useElementNames){
-            spqr_element element = dec->arcs[arc].element;
+            spqr_element element = ARC(dec, arc).element;
             if(SPQRelementIsRow(element)){
-                arc_name = (int) SPQRelementToRow(element);
+                arc_name = (MATREC_index) SPQRelementToRow(element);
             }else{
-                arc_name = (int) SPQRelementToColumn(element);
+                arc_name = (MATREC_index) SPQRelementToColumn(element);
             }
         }
 
-        fprintf(stream, "    %c_%d_%lu -> %c_%d_%lu [label=\"%d \",style=bold%s];\n", type, member, dot_tail, type, member, dot_head,
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu -> %c_%" MATREC_PRIindex "_%lu [label=\"%" MATREC_PRIindex " \",style=bold%s];\n", type, member, dot_tail, type, member, dot_head,
                 arc_name, color);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_tail);
-        fprintf(stream, "    %c_%d_%lu [shape=box];\n", type, member, dot_head);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_tail);
+        fprintf(stream, "    %c_%" MATREC_PRIindex "_%lu [shape=box];\n", type, member, dot_head);
     }
 }
 
@@ -1677,7 +2755,7 @@ static void decompositionToDot(FILE * stream, const MATRECNetworkDecomposition *
     fprintf(stream, "//decomposition\ndigraph decomposition{\n   compound = true;\n");
     for (spqr_member member = 0; member < dec->numMembers; ++member){
         if(!memberIsRepresentative(dec,member)) continue;
-        fprintf(stream,"   subgraph member_%d{\n",member);
+        fprintf(stream,"   subgraph member_%" MATREC_PRIindex "{\n",member);
         switch(getMemberType(dec,member)){
             case SPQR_MEMBERTYPE_RIGID:
             {
@@ -1789,11 +2867,11 @@ static MATREC_ERROR mergeGivenMemberIntoParent(MATRECNetworkDecomposition *dec,
     return MATREC_OKAY;
 }
 
-static int max(int a, int b){
+static MATREC_index max(MATREC_index a, MATREC_index b){
     return (a > b) ? a : b;
 }
 
-typedef int path_arc_id;
+typedef MATREC_index path_arc_id;
 #define INVALID_PATH_ARC (-1)
 
 static bool pathArcIsInvalid(const path_arc_id arc) {
@@ -1813,7 +2891,7 @@ typedef struct {
     bool reversed;
 } PathArcListNode;
 
-typedef int reduced_member_id;
+typedef MATREC_index reduced_member_id;
 #define INVALID_REDUCED_MEMBER (-1)
 
 static bool reducedMemberIsInvalid(const reduced_member_id id) {
@@ -1823,7 +2901,7 @@ static bool reducedMemberIsValid(const reduced_member_id id){
     return !reducedMemberIsInvalid(id);
 }
 
-typedef int children_idx;
+typedef MATREC_index children_idx;
 
 typedef enum {
     REDUCEDMEMBER_TYPE_UNASSIGNED = 0,
@@ -1850,7 +2928,7 @@ static bool isHead(MemberPathType type){
 typedef struct {
     spqr_member member;
     spqr_member rootMember;
-    int depth;
+    MATREC_index depth;
     ReducedMemberType type;
     reduced_member_id parent;
 
@@ -1858,7 +2936,7 @@ typedef struct {
     children_idx numChildren;
 
     path_arc_id firstPathArc;
-    int numPathArcs;
+    MATREC_index numPathArcs;
 
     bool reverseArcs;
     spqr_node rigidPathStart;
@@ -1866,8 +2944,8 @@ typedef struct {
 
     bool pathBackwards;
 
-    int numPropagatedChildren;
-    int componentIndex;
+    MATREC_index numPropagatedChildren;
+    MATREC_index componentIndex;
 
     MemberPathType pathType;
     reduced_member_id nextPathMember;
@@ -1877,72 +2955,242 @@ typedef struct {
 } MATRECColReducedMember;
 
 typedef struct {
-    int rootDepth;
+    MATREC_index rootDepth;
     reduced_member_id root;
 
     reduced_member_id pathEndMembers[2];
-    int numPathEndMembers;
+    MATREC_index numPathEndMembers;
 } MATRECColReducedComponent;
 
 typedef struct {
     reduced_member_id reducedMember;
     reduced_member_id rootDepthMinimizer;
+    spqr_member componentLCA; ///Lowest common ancestor of the touched members in the tree of which this member is the root
 } MemberInfo;
 
 typedef struct {
     spqr_member member;
 } CreateReducedMembersCallstack;
 
+///Memory which is only used within a single call to a Check function. Both before and after the call, each
+///memberInformation entry is invalid. Thus, it can be shared between a row addition and a column addition.
+struct MATRECNetworkAdditionScratchImpl {
+    MemberInfo *memberInformation;
+    MATREC_index memMemberInformation;
+    MATREC_index numMemberInformation;
+
+    CreateReducedMembersCallstack * createReducedMembersCallStack;
+    MATREC_index memCreateReducedMembersCallStack;
+
+    spqr_arc * nonzeroArcs; ///The arcs of the nonzeros of the checked row or column, looked up at once
+    MATREC_index memNonzeroArcs;
+
+    uint64_t * negativeBits; ///The signs of the nonzeros of the checked row or column, if they were not given packed
+    MATREC_index memNegativeBits;
+
+    ///Used to compare the fundamental cycles of the columns in the column table with a new column
+    FindCycleCall * cycleCallStack;
+    MATREC_index memCycleCallStack;
+    FindPathCall * cyclePathCallStack;
+    MATREC_index memCyclePathCallStack;
+    MATREC_row * cycleRows;
+    bool * cycleRowReversed;
+    MATREC_index memCycleRows;
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+};
+
+///Looks up the arcs of all nonzeros in the scratch memory, which is faster than looking them up one by one
+static MATREC_ERROR lookupNonzeroArcs(MATREC *env, MATRECNetworkAdditionScratch *scratch, const MATRECIdMap * map,
+                                      const MATREC_matrix_size * ids, MATREC_matrix_size numIds){
+    if((MATREC_index) numIds > scratch->memNonzeroArcs){
+        MATREC_index newSize = max(2 * scratch->memNonzeroArcs, (MATREC_index) numIds);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->nonzeroArcs, (size_t) newSize));
+        scratch->memNonzeroArcs = newSize;
+    }
+    MATRECidMapGetMany(map, ids, (size_t) numIds, scratch->nonzeroArcs);
+    return MATREC_OKAY;
+}
+
+///The signs of the nonzeros of a new row or column, as given to a Check function. Exactly one of the arrays is given
+typedef struct {
+    const double * values;
+    const int8_t * signs;
+    const uint64_t * negativeBits; ///Bit i % 64 of word i / 64 is set if nonzero i is negative
+} NonzeroSigns;
+
+///Converts the signs of the nonzeros to packed signs, using the scratch memory unless they are already packed. This is
+///done once per Check call, so that the rest of the check only needs to test bits
+static MATREC_ERROR packNonzeroSigns(MATREC *env, MATRECNetworkAdditionScratch *scratch, const NonzeroSigns * nonzeroSigns,
+                                     MATREC_matrix_size numNonzeros, const uint64_t ** pNegativeBits){
+    if(nonzeroSigns->negativeBits){
+        *pNegativeBits = nonzeroSigns->negativeBits;
+        return MATREC_OKAY;
+    }
+    const double * values = nonzeroSigns->values;
+    const int8_t * signs = nonzeroSigns->signs;
+    MATREC_index numWords = (MATREC_index) MATREC_SIGN_WORDS(numNonzeros);
+    if(numWords > scratch->memNegativeBits){
+        MATREC_index newSize = max(2 * scratch->memNegativeBits, numWords);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->negativeBits, (size_t) newSize));
+        scratch->memNegativeBits = newSize;
+    }
+    if(values){
+        //Only the signs are needed here, so whether the values are all -1 or 1 does not matter
+        (void) MATRECpackSigns(values, numNonzeros, 0.0, scratch->negativeBits);
+    }else{
+        for (size_t start = 0; start < numNonzeros; start += 64) {
+            size_t blockSize = numNonzeros - start < 64 ? numNonzeros - start : 64;
+            uint64_t word = 0;
+            for (size_t i = 0; i < blockSize; ++i) {
+                word |= (uint64_t) (signs[start + i] < 0) << i;
+            }
+            scratch->negativeBits[start / 64] = word;
+        }
+    }
+    *pNegativeBits = scratch->negativeBits;
+    return MATREC_OKAY;
+}
+
+static void initializeScratchArrays(MATRECNetworkAdditionScratch *scratch){
+    scratch->memberInformation = NULL;
+    scratch->memMemberInformation = 0;
+    scratch->numMemberInformation = 0;
+
+    scratch->createReducedMembersCallStack = NULL;
+    scratch->memCreateReducedMembersCallStack = 0;
+
+    scratch->nonzeroArcs = NULL;
+    scratch->memNonzeroArcs = 0;
+
+    scratch->negativeBits = NULL;
+    scratch->memNegativeBits = 0;
+
+    scratch->cycleCallStack = NULL;
+    scratch->memCycleCallStack = 0;
+    scratch->cyclePathCallStack = NULL;
+    scratch->memCyclePathCallStack = 0;
+    scratch->cycleRows = NULL;
+    scratch->cycleRowReversed = NULL;
+    scratch->memCycleRows = 0;
+}
+
+static void freeScratchArrays(MATREC *env, MATRECNetworkAdditionScratch *scratch){
+    MATRECfreeBlockArray(env, &scratch->cycleRowReversed);
+    MATRECfreeBlockArray(env, &scratch->cycleRows);
+    MATRECfreeBlockArray(env, &scratch->cyclePathCallStack);
+    MATRECfreeBlockArray(env, &scratch->cycleCallStack);
+    MATRECfreeBlockArray(env, &scratch->negativeBits);
+    MATRECfreeBlockArray(env, &scratch->nonzeroArcs);
+    MATRECfreeBlockArray(env, &scratch->createReducedMembersCallStack);
+    MATRECfreeBlockArray(env, &scratch->memberInformation);
+}
+
+MATREC_ERROR MATRECcreateNetworkAdditionScratch(MATREC *env, MATRECNetworkAdditionScratch **pScratch){
+    assert(env);
+    MATREC_CALL(MATRECallocBlock(env, pScratch));
+    MATRECNetworkAdditionScratch *scratch = *pScratch;
+    initializeScratchArrays(scratch);
+    scratch->peakMemory = 0;
+    return MATREC_OKAY;
+}
+
+void MATRECfreeNetworkAdditionScratch(MATREC *env, MATRECNetworkAdditionScratch **pScratch){
+    assert(env);
+    assert(*pScratch);
+    freeScratchArrays(env, *pScratch);
+    MATRECfreeBlock(env, pScratch);
+}
+
+static void addScratchMemory(const MATRECNetworkAdditionScratch *scratch, MATRECMemoryReport *report){
+    //All scratch memory is unused outside of the Check functions
+    MATRECmemoryReportAddBytes(report, "scratch", sizeof(MATRECNetworkAdditionScratch), 0);
+    MATRECmemoryReportAdd(report, "memberInformation", sizeof(MemberInfo), scratch->memMemberInformation, 0);
+    MATRECmemoryReportAdd(report, "createReducedMembersCallStack", sizeof(CreateReducedMembersCallstack),
+                          scratch->memCreateReducedMembersCallStack, 0);
+    MATRECmemoryReportAdd(report, "nonzeroArcs", sizeof(spqr_arc), scratch->memNonzeroArcs, 0);
+    MATRECmemoryReportAdd(report, "negativeBits", sizeof(uint64_t), scratch->memNegativeBits, 0);
+    MATRECmemoryReportAdd(report, "cycleCallStack", sizeof(FindCycleCall), scratch->memCycleCallStack, 0);
+    MATRECmemoryReportAdd(report, "cyclePathCallStack", sizeof(FindPathCall), scratch->memCyclePathCallStack, 0);
+    MATRECmemoryReportAdd(report, "cycleRows", sizeof(MATREC_row) + sizeof(bool), scratch->memCycleRows, 0);
+}
+
+void MATRECNetworkAdditionScratchMemory(const MATRECNetworkAdditionScratch *scratch, MATRECMemoryReport *report){
+    assert(scratch);
+    assert(report);
+    MATRECmemoryReportInit(report);
+    addScratchMemory(scratch, report);
+    MATRECmemoryReportFinish(report, scratch->peakMemory);
+}
+
+///Frees all scratch memory, which the next Check call allocates again as needed
+static void shrinkScratch(MATREC *env, MATRECNetworkAdditionScratch *scratch){
+    MATRECMemoryReport report;
+    MATRECNetworkAdditionScratchMemory(scratch, &report);
+    scratch->peakMemory = report.peakBytes;
+    freeScratchArrays(env, scratch);
+    initializeScratchArrays(scratch);
+}
+
 struct MATRECNetworkColumnAdditionImpl {
     bool remainsNetwork;
 
     MATRECColReducedMember *reducedMembers;
-    int memReducedMembers;
-    int numReducedMembers;
+    MATREC_index memReducedMembers;
+    MATREC_index numReducedMembers;
 
     MATRECColReducedComponent *reducedComponents;
-    int memReducedComponents;
-    int numReducedComponents;
+    MATREC_index memReducedComponents;
+    MATREC_index numReducedComponents;
 
-    MemberInfo *memberInformation;
-    int memMemberInformation;
-    int numMemberInformation;
+    MATRECNetworkAdditionScratch *scratch;
+    bool ownsScratch; ///Whether the scratch memory is freed together with this object
 
     reduced_member_id *childrenStorage;
-    int memChildrenStorage;
-    int numChildrenStorage;
+    MATREC_index memChildrenStorage;
+    MATREC_index numChildrenStorage;
 
     PathArcListNode *pathArcs;
-    int memPathArcs;
-    int numPathArcs;
+    MATREC_index memPathArcs;
+    MATREC_index numPathArcs;
     path_arc_id firstOverallPathArc;
 
-    int *nodeInPathDegree;
-    int *nodeOutPathDegree;
-    int memNodePathDegree;
+    MATREC_index *nodeInPathDegree;
+    MATREC_index *nodeOutPathDegree;
+    MATREC_index memNodePathDegree;
 
     bool *arcInPath;
     bool *arcInPathReversed;
-    int memArcsInPath;
-
-    CreateReducedMembersCallstack * createReducedMembersCallStack;
-    int memCreateReducedMembersCallStack;
+    MATREC_index memArcsInPath;
 
     MATREC_col newColIndex;
 
     MATREC_row *newRowArcs;
     bool * newRowArcReversed;
-    int memNewRowArcs;
-    int numNewRowArcs;
+    MATREC_index memNewRowArcs;
+    MATREC_index numNewRowArcs;
 
     spqr_arc *decompositionRowArcs;
     bool *decompositionArcReversed;
-    int memDecompositionRowArcs;
-    int numDecompositionRowArcs;
+    MATREC_index memDecompositionRowArcs;
+    MATREC_index numDecompositionRowArcs;
+
+    MATRECColumnTableEntry *columnEntries;
+    MATREC_index memColumnEntries;
+    MATREC_index numColumnEntries;
+    uint64_t columnHash;
+    bool isDuplicate; ///Whether the path was replaced by the arc of an existing column with the same nonzeros
 
     spqr_member * leafMembers;
-    int numLeafMembers;
-    int memLeafMembers;
+    MATREC_index numLeafMembers;
+    MATREC_index memLeafMembers;
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+    //If not 0, the arrays are freed after this many consecutive checks on a much smaller decomposition
+    size_t autoShrinkCalls;
+    size_t numUnderusedCalls;
+
+    MATRECTraceId traceId;
 };
 
 static void cleanupPreviousIteration(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol) {
@@ -1968,12 +3216,12 @@ static void cleanupPreviousIteration(MATRECNetworkDecomposition *dec, MATRECNetw
         pathArc = newCol->pathArcs[pathArc].nextOverall;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newCol->memArcsInPath; ++i) {
+    for (MATREC_index i = 0; i < newCol->memArcsInPath; ++i) {
         assert(newCol->arcInPath[i] == false);
         assert(newCol->arcInPathReversed[i] == false);
     }
 
-    for (int i = 0; i < newCol->memNodePathDegree; ++i) {
+    for (MATREC_index i = 0; i < newCol->memNodePathDegree; ++i) {
         assert(newCol->nodeInPathDegree[i] == 0);
         assert(newCol->nodeOutPathDegree[i] == 0);
     }
@@ -1983,13 +3231,7 @@ static void cleanupPreviousIteration(MATRECNetworkDecomposition *dec, MATRECNetw
     newCol->numPathArcs = 0;
 }
 
-MATREC_ERROR MATRECcreateNetworkColumnAddition(MATREC *env, MATRECNetworkColumnAddition **pNewCol) {
-    assert(env);
-
-    MATREC_CALL(MATRECallocBlock(env, pNewCol));
-    MATRECNetworkColumnAddition *newCol = *pNewCol;
-
-    newCol->remainsNetwork = false;
+static void initializeColumnAdditionArrays(MATRECNetworkColumnAddition *newCol){
     newCol->reducedMembers = NULL;
     newCol->memReducedMembers = 0;
     newCol->numReducedMembers = 0;
@@ -1998,10 +3240,6 @@ MATREC_ERROR MATRECcreateNetworkColumnAddition(MATREC *env, MATRECNetworkColumnA
     newCol->memReducedComponents = 0;
     newCol->numReducedComponents = 0;
 
-    newCol->memberInformation = NULL;
-    newCol->memMemberInformation = 0;
-    newCol->numMemberInformation = 0;
-
     newCol->childrenStorage = NULL;
     newCol->memChildrenStorage = 0;
     newCol->numChildrenStorage = 0;
@@ -2019,11 +3257,6 @@ MATREC_ERROR MATRECcreateNetworkColumnAddition(MATREC *env, MATRECNetworkColumnA
     newCol->arcInPathReversed = NULL;
     newCol->memArcsInPath = 0;
 
-    newCol->createReducedMembersCallStack = NULL;
-    newCol->memCreateReducedMembersCallStack = 0;
-
-    newCol->newColIndex = MATREC_INVALID_COL;
-
     newCol->newRowArcs = NULL;
     newCol->newRowArcReversed = NULL;
     newCol->memNewRowArcs = 0;
@@ -2034,45 +3267,233 @@ MATREC_ERROR MATRECcreateNetworkColumnAddition(MATREC *env, MATRECNetworkColumnA
     newCol->memDecompositionRowArcs = 0;
     newCol->numDecompositionRowArcs = 0;
 
+    newCol->columnEntries = NULL;
+    newCol->memColumnEntries = 0;
+    newCol->numColumnEntries = 0;
+
     newCol->leafMembers = NULL;
     newCol->numLeafMembers = 0;
     newCol->memLeafMembers = 0;
-
-    return MATREC_OKAY;
 }
 
-void MATRECfreeNetworkColumnAddition(MATREC *env, MATRECNetworkColumnAddition **pNewCol) {
-    assert(env);
-    MATRECNetworkColumnAddition *newCol = *pNewCol;
+static void freeColumnAdditionArrays(MATREC *env, MATRECNetworkColumnAddition *newCol){
+    MATRECfreeBlockArray(env, &newCol->columnEntries);
     MATRECfreeBlockArray(env, &newCol->decompositionRowArcs);
     MATRECfreeBlockArray(env, &newCol->decompositionArcReversed);
     MATRECfreeBlockArray(env, &newCol->newRowArcs);
     MATRECfreeBlockArray(env, &newCol->newRowArcReversed);
-    MATRECfreeBlockArray(env, &newCol->createReducedMembersCallStack);
     MATRECfreeBlockArray(env, &newCol->arcInPath);
     MATRECfreeBlockArray(env, &newCol->arcInPathReversed);
     MATRECfreeBlockArray(env, &newCol->nodeInPathDegree);
     MATRECfreeBlockArray(env, &newCol->nodeOutPathDegree);
     MATRECfreeBlockArray(env, &newCol->pathArcs);
     MATRECfreeBlockArray(env, &newCol->childrenStorage);
-    MATRECfreeBlockArray(env, &newCol->memberInformation);
+    MATRECfreeBlockArray(env, &newCol->leafMembers);
     MATRECfreeBlockArray(env, &newCol->reducedComponents);
     MATRECfreeBlockArray(env, &newCol->reducedMembers);
+}
+
+MATREC_ERROR MATRECcreateNetworkColumnAddition(MATREC *env, MATRECNetworkColumnAddition **pNewCol) {
+    return MATRECcreateNetworkColumnAdditionWithScratch(env, pNewCol, NULL);
+}
+
+MATREC_ERROR MATRECcreateNetworkColumnAdditionWithScratch(MATREC *env, MATRECNetworkColumnAddition **pNewCol, MATRECNetworkAdditionScratch *scratch) {
+    assert(env);
+
+    MATREC_CALL(MATRECallocBlock(env, pNewCol));
+    MATRECNetworkColumnAddition *newCol = *pNewCol;
 
+    newCol->ownsScratch = scratch == NULL;
+    if(newCol->ownsScratch){
+        MATREC_CALL(MATRECcreateNetworkAdditionScratch(env, &scratch));
+    }
+    newCol->scratch = scratch;
+
+    newCol->remainsNetwork = false;
+    newCol->newColIndex = MATREC_INVALID_COL;
+    newCol->columnHash = 0;
+    newCol->isDuplicate = false;
+    initializeColumnAdditionArrays(newCol);
+
+    newCol->peakMemory = 0;
+    newCol->autoShrinkCalls = 0;
+    newCol->numUnderusedCalls = 0;
+    MATRECtraceIdInit(&newCol->traceId);
+    return MATREC_OKAY;
+}
+
+void MATRECfreeNetworkColumnAddition(MATREC *env, MATRECNetworkColumnAddition **pNewCol) {
+    assert(env);
+    MATRECNetworkColumnAddition *newCol = *pNewCol;
+    traceFreeAddition(env, &newCol->traceId);
+    freeColumnAdditionArrays(env, newCol);
+
+    if(newCol->ownsScratch){
+        MATRECfreeNetworkAdditionScratch(env, &newCol->scratch);
+    }
     MATRECfreeBlock(env, pNewCol);
 }
 
+void MATRECNetworkColumnAdditionMemory(const MATRECNetworkColumnAddition *newCol, MATRECMemoryReport *report){
+    assert(newCol);
+    assert(report);
+    MATRECmemoryReportInit(report);
+    MATRECmemoryReportAddBytes(report, "columnAddition", sizeof(MATRECNetworkColumnAddition),
+                               sizeof(MATRECNetworkColumnAddition));
+    MATRECmemoryReportAdd(report, "reducedMembers", sizeof(MATRECColReducedMember), newCol->memReducedMembers,
+                          newCol->numReducedMembers);
+    MATRECmemoryReportAdd(report, "reducedComponents", sizeof(MATRECColReducedComponent),
+                          newCol->memReducedComponents, newCol->numReducedComponents);
+    MATRECmemoryReportAdd(report, "childrenStorage", sizeof(reduced_member_id), newCol->memChildrenStorage,
+                          newCol->numChildrenStorage);
+    MATRECmemoryReportAdd(report, "pathArcs", sizeof(PathArcListNode), newCol->memPathArcs, newCol->numPathArcs);
+    //Arrays indexed by the nodes and arcs of the decomposition are always fully in use
+    MATRECmemoryReportAdd(report, "nodePathDegree", 2 * sizeof(MATREC_index), newCol->memNodePathDegree,
+                          newCol->memNodePathDegree);
+    MATRECmemoryReportAdd(report, "arcInPath", 2 * sizeof(bool), newCol->memArcsInPath, newCol->memArcsInPath);
+    MATRECmemoryReportAdd(report, "newRowArcs", sizeof(MATREC_row) + sizeof(bool), newCol->memNewRowArcs,
+                          newCol->numNewRowArcs);
+    MATRECmemoryReportAdd(report, "decompositionRowArcs", sizeof(spqr_arc) + sizeof(bool),
+                          newCol->memDecompositionRowArcs, newCol->numDecompositionRowArcs);
+    MATRECmemoryReportAdd(report, "columnEntries", sizeof(MATRECColumnTableEntry), newCol->memColumnEntries,
+                          newCol->numColumnEntries);
+    MATRECmemoryReportAdd(report, "leafMembers", sizeof(spqr_member), newCol->memLeafMembers,
+                          newCol->numLeafMembers);
+    if(newCol->ownsScratch){
+        addScratchMemory(newCol->scratch, report);
+    }
+    MATRECmemoryReportFinish(report, newCol->peakMemory);
+}
+
+void MATRECNetworkColumnAdditionShrink(MATREC *env, MATRECNetworkColumnAddition *newCol){
+    assert(env);
+    assert(newCol);
+    MATRECMemoryReport report;
+    MATRECNetworkColumnAdditionMemory(newCol, &report);
+    newCol->peakMemory = report.peakBytes;
+    freeColumnAdditionArrays(env, newCol);
+    initializeColumnAdditionArrays(newCol);
+    newCol->numUnderusedCalls = 0;
+    shrinkScratch(env, newCol->scratch);
+}
 
-static reduced_member_id createReducedMembersToRoot(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition * newCol, const spqr_member firstMember ){
+void MATRECNetworkColumnAdditionSetAutoShrink(MATRECNetworkColumnAddition *newCol, size_t numCalls){
+    assert(newCol);
+    newCol->autoShrinkCalls = numCalls;
+    newCol->numUnderusedCalls = 0;
+}
+
+///Counts the consecutive checks on a decomposition with fewer than a quarter of the arcs that the arrays were grown
+///for, and shrinks the addition once there are enough of them
+static void autoShrinkColumnAddition(const MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol){
+    if(4 * largestArcID(dec) >= newCol->memArcsInPath){
+        newCol->numUnderusedCalls = 0;
+        return;
+    }
+    ++newCol->numUnderusedCalls;
+    if(newCol->numUnderusedCalls >= newCol->autoShrinkCalls){
+        MATRECNetworkColumnAdditionShrink(dec->env, newCol);
+    }
+}
+
+
+static MATREC_index ancestorIndexMemberParent(void * data, MATREC_index member){
+    MATRECNetworkDecomposition * dec = (MATRECNetworkDecomposition *) data;
+    if(!memberIsRepresentative(dec, member)){
+        return SPQR_INVALID_MEMBER;
+    }
+    return findMemberParent(dec, member);
+}
+
+///Builds the ancestor index of the member tree once walking the tree without it has cost more than building it
+static MATREC_ERROR updateMemberAncestorIndex(MATRECNetworkDecomposition *dec){
+    if(!dec->readOnly && MATRECancestorIndexShouldBuild(&dec->memberAncestors, dec->numMembers)){
+        MATREC_CALL(MATRECancestorIndexBuild(dec->env, &dec->memberAncestors, dec->numMembers,
+                                             ancestorIndexMemberParent, dec));
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_index ancestorIndexMemberChildren(void * data, MATREC_index member, MATREC_index * children){
+    MATRECNetworkDecomposition * dec = (MATRECNetworkDecomposition *) data;
+    MATREC_index numChildren = 0;
+    spqr_arc firstArc = getFirstMemberArc(dec, member);
+    spqr_arc arc = firstArc;
+    do{
+        if(arc != markerToParent(dec, member) && arcIsMarker(dec, arc)){
+            children[numChildren] = findArcChildMember(dec, arc);
+            ++numChildren;
+        }
+        arc = getNextMemberArc(dec, arc);
+    }while(arc != firstArc);
+    return numChildren;
+}
+
+///Repairs the ancestor index after an addition, which only changed the subtree of the member top. If top is invalid,
+///the addition reached the root of the tree, and the whole tree containing the changed member is repaired
+static void repairMemberAncestorIndex(MATRECNetworkDecomposition *dec, spqr_member top, spqr_member changed){
+    if(!dec->memberAncestors.valid){
+        return;
+    }
+    if(SPQRmemberIsValid(top)){
+        top = findMember(dec, top);
+    }else{
+        top = findMember(dec, changed);
+        for (spqr_member parent = findMemberParent(dec, top); SPQRmemberIsValid(parent);
+             parent = findMemberParent(dec, top)) {
+            top = parent;
+        }
+    }
+    MATRECancestorIndexRepair(&dec->memberAncestors, dec->numMembers, top, ancestorIndexMemberParent,
+                              ancestorIndexMemberChildren, dec);
+}
+
+///Records the elements which an addition may change when it changes a member: the member and its arcs, the nodes of
+///these arcs, and the members and marker arcs next to it in the member tree
+static void recordMemberChanges(MATRECNetworkDecomposition *dec, spqr_member member){
+    if(!readersEnabled(dec)){
+        return;
+    }
+    member = findMemberNoCompression(dec, member);
+    recordReplicaChange(dec, REPLICA_MEMBER, member);
+    if(getMemberType(dec, member) == SPQR_MEMBERTYPE_UNASSIGNED){
+        return;
+    }
+    if(SPQRmemberIsValid(MEMBER(dec, member).parentMember)){
+        recordReplicaChange(dec, REPLICA_MEMBER, findMemberParentNoCompression(dec, member));
+        recordReplicaChange(dec, REPLICA_ARC, markerToParent(dec, member));
+        recordReplicaChange(dec, REPLICA_ARC, markerOfParent(dec, member));
+    }
+    spqr_arc arc = getFirstMemberArc(dec, member);
+    for (MATREC_index i = 0; i < getNumMemberArcs(dec, member); ++i) {
+        recordReplicaChange(dec, REPLICA_ARC, arc);
+        spqr_node nodes[2] = {ARC(dec, arc).head, ARC(dec, arc).tail};
+        for (int j = 0; j < 2; ++j) {
+            if(SPQRnodeIsValid(nodes[j])){
+                recordReplicaChange(dec, REPLICA_NODE, nodes[j]);
+                recordReplicaChange(dec, REPLICA_NODE, findNodeNoCompression(dec, nodes[j]));
+            }
+        }
+        if(arc != markerToParent(dec, member) && arcIsMarker(dec, arc)){
+            spqr_member child = findArcChildMemberNoCompression(dec, arc);
+            recordReplicaChange(dec, REPLICA_MEMBER, child);
+            recordReplicaChange(dec, REPLICA_ARC, markerToParent(dec, child));
+        }
+        arc = getNextMemberArc(dec, arc);
+    }
+}
+
+static reduced_member_id createReducedMembersToRoot(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition * newCol, const spqr_member firstMember,
+                                                    const spqr_member stopMember){
     assert(SPQRmemberIsValid(firstMember));
 
-    CreateReducedMembersCallstack * callstack = newCol->createReducedMembersCallStack;
+    CreateReducedMembersCallstack * callstack = newCol->scratch->createReducedMembersCallStack;
     callstack[0].member = firstMember;
-    int callDepth = 0;
+    MATREC_index callDepth = 0;
 
     while(callDepth >= 0){
         spqr_member member = callstack[callDepth].member;
-        reduced_member_id reducedMember = newCol->memberInformation[member].reducedMember;
+        reduced_member_id reducedMember = newCol->scratch->memberInformation[member].reducedMember;
 
         bool reducedValid = reducedMemberIsValid(reducedMember);
         if(!reducedValid) {
@@ -2095,14 +3516,15 @@ static reduced_member_id createReducedMembersToRoot(MATRECNetworkDecomposition *
             reducedMemberData->componentIndex = -1;
             //The children are set later
 
-            newCol->memberInformation[member].reducedMember = reducedMember;
+            newCol->scratch->memberInformation[member].reducedMember = reducedMember;
             assert(memberIsRepresentative(dec, member));
-            spqr_member parentMember = findMemberParent(dec, member);
+            //The stop member is the root of the reduced component, so we do not need to walk further up the tree
+            spqr_member parentMember = member == stopMember ? SPQR_INVALID_MEMBER : findMemberParent(dec, member);
 
             if (SPQRmemberIsValid(parentMember)) {
                 //recursive call to parent member
                 ++callDepth;
-                assert(callDepth < newCol->memCreateReducedMembersCallStack);
+                assert(callDepth < newCol->scratch->memCreateReducedMembersCallStack);
                 callstack[callDepth].member = parentMember;
                 continue;
 
@@ -2126,7 +3548,7 @@ static reduced_member_id createReducedMembersToRoot(MATRECNetworkDecomposition *
             assert(reducedMember < newCol->numReducedMembers);
             //Reduced member was already created in earlier call
             //update the depth of the root if appropriate
-            reduced_member_id * depthMinimizer = &newCol->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+            reduced_member_id * depthMinimizer = &newCol->scratch->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
             if(reducedMemberIsInvalid(*depthMinimizer) ||
                newCol->reducedMembers[reducedMember].depth < newCol->reducedMembers[*depthMinimizer].depth){
                 *depthMinimizer = reducedMember;
@@ -2136,9 +3558,9 @@ static reduced_member_id createReducedMembersToRoot(MATRECNetworkDecomposition *
             --callDepth;
             if(callDepth < 0 ) break;
             spqr_member parentMember = callstack[callDepth + 1].member;
-            reduced_member_id parentReducedMember = newCol->memberInformation[parentMember].reducedMember;
+            reduced_member_id parentReducedMember = newCol->scratch->memberInformation[parentMember].reducedMember;
             spqr_member currentMember = callstack[callDepth].member;
-            reduced_member_id currentReducedMember = newCol->memberInformation[currentMember].reducedMember;
+            reduced_member_id currentReducedMember = newCol->scratch->memberInformation[currentMember].reducedMember;
 
             MATRECColReducedMember *parentReducedMemberData = &newCol->reducedMembers[parentReducedMember];
             MATRECColReducedMember *reducedMemberData = &newCol->reducedMembers[currentReducedMember];
@@ -2155,7 +3577,7 @@ static reduced_member_id createReducedMembersToRoot(MATRECNetworkDecomposition *
 
     }
 
-    reduced_member_id returnedMember = newCol->memberInformation[callstack[0].member].reducedMember;
+    reduced_member_id returnedMember = newCol->scratch->memberInformation[callstack[0].member].reducedMember;
     return returnedMember;
 }
 
@@ -2163,8 +3585,8 @@ static MATREC_ERROR constructReducedDecomposition(MATRECNetworkDecomposition *de
     assert(dec);
     assert(newCol);
 #ifndef NDEBUG
-    for (int i = 0; i < newCol->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newCol->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newCol->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newCol->scratch->memberInformation[i].reducedMember));
     }
 #endif
     newCol->numReducedComponents = 0;
@@ -2175,52 +3597,83 @@ static MATREC_ERROR constructReducedDecomposition(MATRECNetworkDecomposition *de
     assert(newCol->numReducedMembers == 0);
     assert(newCol->numReducedComponents == 0);
 
-    int newSize = largestMemberID(dec); //Is this sufficient?
+    MATREC_index newSize = largestMemberID(dec); //Is this sufficient?
     if (newSize > newCol->memReducedMembers) {
         newCol->memReducedMembers = max(2 * newCol->memReducedMembers, newSize);
         MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->reducedMembers, (size_t) newCol->memReducedMembers));
     }
-    if (newSize > newCol->memMemberInformation) {
-        int updatedSize = max(2 * newCol->memMemberInformation, newSize);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->memberInformation, (size_t) updatedSize));
-        for (int i = newCol->memMemberInformation; i < updatedSize; ++i) {
-            newCol->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
-            newCol->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+    if (newSize > newCol->scratch->memMemberInformation) {
+        MATREC_index updatedSize = max(2 * newCol->scratch->memMemberInformation, newSize);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->scratch->memberInformation, (size_t) updatedSize));
+        for (MATREC_index i = newCol->scratch->memMemberInformation; i < updatedSize; ++i) {
+            newCol->scratch->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
+            newCol->scratch->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+            newCol->scratch->memberInformation[i].componentLCA = SPQR_INVALID_MEMBER;
         }
-        newCol->memMemberInformation = updatedSize;
+        newCol->scratch->memMemberInformation = updatedSize;
 
     }
 
-    int numComponents = numConnectedComponents(dec);
+    MATREC_index numComponents = numConnectedComponents(dec);
     if (numComponents > newCol->memReducedComponents) {
         newCol->memReducedComponents = max(2 * newCol->memReducedComponents, numComponents);
         MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->reducedComponents, (size_t) newCol->memReducedComponents));
     }
 
-    int numMembers = getNumMembers(dec);
-    if (newCol->memCreateReducedMembersCallStack < numMembers) {
-        newCol->memCreateReducedMembersCallStack = max(2 * newCol->memCreateReducedMembersCallStack, numMembers);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->createReducedMembersCallStack,
-                                        (size_t) newCol->memCreateReducedMembersCallStack));
+    MATREC_index numMembers = getNumMembers(dec);
+    if (newCol->scratch->memCreateReducedMembersCallStack < numMembers) {
+        newCol->scratch->memCreateReducedMembersCallStack = max(2 * newCol->scratch->memCreateReducedMembersCallStack, numMembers);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->scratch->createReducedMembersCallStack,
+                                        (size_t) newCol->scratch->memCreateReducedMembersCallStack));
     }
 
     //Create the reduced members (recursively)
-    for (int i = 0; i < newCol->numDecompositionRowArcs; ++i) {
+    //With the ancestor index, we only walk up to the lowest common ancestor of the touched members in each tree.
+    //A single arc needs no walk at all, as its member forms the entire reduced decomposition
+    bool singleArc = newCol->numDecompositionRowArcs == 1;
+    if(!singleArc){
+        MATREC_CALL(updateMemberAncestorIndex(dec));
+    }
+    const MATRECAncestorIndex * ancestors = &dec->memberAncestors;
+    bool useAncestors = !singleArc && ancestors->valid;
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newCol->numDecompositionRowArcs; ++i) {
+            spqr_member arcMember = findArcMember(dec, newCol->decompositionRowArcs[i]);
+            spqr_member * lca = &newCol->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,arcMember)].componentLCA;
+            *lca = SPQRmemberIsValid(*lca) ? MATRECancestorIndexLCA(ancestors,*lca,arcMember) : arcMember;
+        }
+    }
+    for (MATREC_index i = 0; i < newCol->numDecompositionRowArcs; ++i) {
         assert(i < newCol->memDecompositionRowArcs);
         spqr_arc arc = newCol->decompositionRowArcs[i];
         spqr_member arcMember = findArcMember(dec, arc);
-        reduced_member_id reducedMember = createReducedMembersToRoot(dec, newCol, arcMember);
-        reduced_member_id *depthMinimizer = &newCol->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+        spqr_member stopMember = SPQR_INVALID_MEMBER;
+        if(singleArc){
+            stopMember = arcMember;
+        }else if(useAncestors){
+            stopMember = newCol->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,arcMember)].componentLCA;
+        }
+        reduced_member_id reducedMember = createReducedMembersToRoot(dec, newCol, arcMember, stopMember);
+        reduced_member_id *depthMinimizer = &newCol->scratch->memberInformation[newCol->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
         if (reducedMemberIsInvalid(*depthMinimizer)) {
             *depthMinimizer = reducedMember;
         }
     }
 
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newCol->numDecompositionRowArcs; ++i) {
+            spqr_member arcMember = findArcMember(dec, newCol->decompositionRowArcs[i]);
+            newCol->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,arcMember)].componentLCA = SPQR_INVALID_MEMBER;
+        }
+    }else if(!singleArc && !dec->readOnly){
+        dec->memberAncestors.walkSteps += (size_t) newCol->numReducedMembers;
+    }
+
     //Set the reduced roots according to the root depth minimizers
-    for (int i = 0; i < newCol->numReducedComponents; ++i) {
+    for (MATREC_index i = 0; i < newCol->numReducedComponents; ++i) {
         MATRECColReducedComponent *component = &newCol->reducedComponents[i];
         spqr_member rootMember = newCol->reducedMembers[component->root].member;
-        reduced_member_id reducedMinimizer = newCol->memberInformation[rootMember].rootDepthMinimizer;
+        reduced_member_id reducedMinimizer = newCol->scratch->memberInformation[rootMember].rootDepthMinimizer;
         component->rootDepth = newCol->reducedMembers[reducedMinimizer].depth;
         component->root = reducedMinimizer;
 
@@ -2230,10 +3683,10 @@ static MATREC_ERROR constructReducedDecomposition(MATRECNetworkDecomposition *de
     }
 
     //update the children array
-    int numTotalChildren = 0;
-    for (int i = 0; i < newCol->numReducedMembers; ++i) {
+    MATREC_index numTotalChildren = 0;
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
         MATRECColReducedMember *reducedMember = &newCol->reducedMembers[i];
-        reduced_member_id minimizer = newCol->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
+        reduced_member_id minimizer = newCol->scratch->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
         if (reducedMember->depth >= newCol->reducedMembers[minimizer].depth) {
             reducedMember->firstChild = numTotalChildren;
             numTotalChildren += reducedMember->numChildren;
@@ -2242,7 +3695,7 @@ static MATREC_ERROR constructReducedDecomposition(MATRECNetworkDecomposition *de
     }
 
     if (newCol->memChildrenStorage < numTotalChildren) {
-        int newMemSize = max(newCol->memChildrenStorage * 2, numTotalChildren);
+        MATREC_index newMemSize = max(newCol->memChildrenStorage * 2, numTotalChildren);
         newCol->memChildrenStorage = newMemSize;
         MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->childrenStorage, (size_t) newCol->memChildrenStorage));
     }
@@ -2252,12 +3705,12 @@ static MATREC_ERROR constructReducedDecomposition(MATRECNetworkDecomposition *de
     for (reduced_member_id reducedMember = 0; reducedMember < newCol->numReducedMembers; ++reducedMember) {
         MATRECColReducedMember *reducedMemberData = &newCol->reducedMembers[reducedMember];
         if (reducedMemberData->depth <=
-            newCol->reducedMembers[newCol->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth) {
+            newCol->reducedMembers[newCol->scratch->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth) {
             continue;
         }
         spqr_member parentMember = findMemberParent(dec, reducedMemberData->member);
         reduced_member_id parentReducedMember = SPQRmemberIsValid(parentMember)
-                                                ? newCol->memberInformation[parentMember].reducedMember
+                                                ? newCol->scratch->memberInformation[parentMember].reducedMember
                                                 : INVALID_REDUCED_MEMBER;
         if (reducedMemberIsValid(parentReducedMember)) {
             //TODO: probably one of these two checks/branches is unnecessary, as there is a single failure case? (Not sure)
@@ -2269,13 +3722,13 @@ static MATREC_ERROR constructReducedDecomposition(MATRECNetworkDecomposition *de
     }
 
     //Clean up the root depth minimizers.
-    for (int i = 0; i < newCol->numReducedMembers; ++i) {
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
         MATRECColReducedMember *reducedMember = &newCol->reducedMembers[i];
         assert(reducedMember);
         spqr_member rootMember = reducedMember->rootMember;
         assert(rootMember >= 0);
         assert(rootMember < dec->memMembers);
-        newCol->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+        newCol->scratch->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
     }
 
     return MATREC_OKAY;
@@ -2284,12 +3737,12 @@ static MATREC_ERROR constructReducedDecomposition(MATRECNetworkDecomposition *de
 static void cleanUpMemberInformation(MATRECNetworkColumnAddition * newCol){
     //This loop is at the end as memberInformation is also used to assign the cut arcs during propagation
     //Clean up the memberInformation array
-    for (int i = 0; i < newCol->numReducedMembers; ++i) {
-        newCol->memberInformation[newCol->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
+        newCol->scratch->memberInformation[newCol->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newCol->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newCol->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newCol->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newCol->scratch->memberInformation[i].reducedMember));
     }
 #endif
 }
@@ -2323,7 +3776,7 @@ static void createPathArc(
         listNode->arcHead = findEffectiveArcHead(dec,arc);
         listNode->arcTail = findEffectiveArcTail(dec,arc);
         if(reversed){
-            swap_ints(&listNode->arcHead,&listNode->arcTail);
+            swap_indices(&listNode->arcHead,&listNode->arcTail);
         }
         assert(SPQRnodeIsValid(listNode->arcHead) && SPQRnodeIsValid(listNode->arcTail));
         assert(listNode->arcHead < newCol->memNodePathDegree && listNode->arcTail < newCol->memNodePathDegree);
@@ -2338,44 +3791,88 @@ static void createPathArc(
 }
 
 static MATREC_ERROR createPathArcs(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol){
-    int maxNumPathArcs = newCol->numDecompositionRowArcs + getNumMembers(dec);
+    MATREC_index maxNumPathArcs = newCol->numDecompositionRowArcs + getNumMembers(dec);
     if(newCol->memPathArcs < maxNumPathArcs){
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->pathArcs,(size_t) maxNumPathArcs)); //TODO: fix reallocation strategy
         newCol->memPathArcs = maxNumPathArcs;
     }
-    int maxPathArcIndex = largestArcID(dec);
+    MATREC_index maxPathArcIndex = largestArcID(dec);
     if(newCol->memArcsInPath < maxPathArcIndex){
-        int newSize = maxPathArcIndex;
+        MATREC_index newSize = maxPathArcIndex;
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->arcInPath,(size_t) newSize));//TODO: fix reallocation strategy
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->arcInPathReversed,(size_t) newSize));//TODO: fix reallocation strategy
 
-        for (int i = newCol->memArcsInPath; i < newSize; ++i) {
+        for (MATREC_index i = newCol->memArcsInPath; i < newSize; ++i) {
             newCol->arcInPath[i] = false;
             newCol->arcInPathReversed[i] = false;
         }
         newCol->memArcsInPath = newSize;
     }
-    int maxNumNodes = largestNodeID(dec);
+    MATREC_index maxNumNodes = largestNodeID(dec);
     if(newCol->memNodePathDegree < maxNumNodes){
-        int newSize = maxNumNodes;
+        MATREC_index newSize = maxNumNodes;
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->nodeInPathDegree,(size_t) newSize));
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newCol->nodeOutPathDegree,(size_t) newSize));
-        for (int i = newCol->memNodePathDegree; i < newSize; ++i) {
+        for (MATREC_index i = newCol->memNodePathDegree; i < newSize; ++i) {
             newCol->nodeInPathDegree[i] = 0;
             newCol->nodeOutPathDegree[i] = 0;
         }
         newCol->memNodePathDegree = newSize;
     }
-    for (int i = 0; i < newCol->numDecompositionRowArcs; ++i) {
+    for (MATREC_index i = 0; i < newCol->numDecompositionRowArcs; ++i) {
         spqr_arc arc = newCol->decompositionRowArcs[i];
         spqr_member member = findArcMember(dec, arc);
-        reduced_member_id reducedMember = newCol->memberInformation[member].reducedMember;
+        reduced_member_id reducedMember = newCol->scratch->memberInformation[member].reducedMember;
         createPathArc(dec,newCol,arc,reducedMember,newCol->decompositionArcReversed[i]);
     }
-
-    return MATREC_OKAY;
+
+    return MATREC_OKAY;
+}
+
+
+///Bit i % 64 of word i / 64 of the packed signs is set if nonzero i is negative
+static bool nonzeroIsNegative(const uint64_t * negativeBits, size_t i){
+    return (negativeBits[i / 64] >> (i % 64)) & 1;
+}
+
+///Records a row or column check and its outcome, if the decomposition is in the trace
+static void traceCheck(MATRECNetworkDecomposition *dec, MATRECTraceCall call, MATRECTraceId *addition,
+                       MATREC_matrix_size index, const MATREC_matrix_size * nonzeros, const uint64_t * negativeBits,
+                       MATREC_matrix_size numNonzeros, bool remainsNetwork){
+    if(!MATRECtraceContains(dec->env, &dec->traceId)){
+        return;
+    }
+    MATRECTraceWriter writer;
+    MATRECtraceBegin(dec->env, &writer, call);
+    MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+    MATRECtraceWriteAddition(&writer, addition);
+    MATRECtraceWriteNumber(&writer, index);
+    MATRECtraceWriteNumber(&writer, numNonzeros);
+    for (MATREC_matrix_size i = 0; i < numNonzeros; ++i) {
+        MATRECtraceWriteNumber(&writer, nonzeros[i]);
+    }
+    for (size_t i = 0; i < numNonzeros; i += 8) {
+        unsigned char byte = 0;
+        for (size_t j = i; j < i + 8 && j < numNonzeros; ++j) {
+            byte = (unsigned char) (byte | (nonzeroIsNegative(negativeBits, j) << (j - i)));
+        }
+        MATRECtraceWriteByte(&writer, byte);
+    }
+    MATRECtraceWriteByte(&writer, remainsNetwork);
+    MATRECtraceEnd(&writer);
 }
 
+///Records a row or column addition, if the decomposition and the addition are in the trace
+static void traceAdd(MATRECNetworkDecomposition *dec, MATRECTraceCall call, MATRECTraceId *addition){
+    if(!MATRECtraceContains(dec->env, &dec->traceId) || !MATRECtraceContains(dec->env, addition)){
+        return;
+    }
+    MATRECTraceWriter writer;
+    MATRECtraceBegin(dec->env, &writer, call);
+    MATRECtraceWriteDecomposition(&writer, &dec->traceId);
+    MATRECtraceWriteAddition(&writer, addition);
+    MATRECtraceEnd(&writer);
+}
 
 /**
  * Saves the information of the current row and partitions it based on whether or not the given columns are
@@ -2383,18 +3880,19 @@ static MATREC_ERROR createPathArcs(MATRECNetworkDecomposition *dec, MATRECNetwor
  */
 static MATREC_ERROR
 newColUpdateColInformation(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol, MATREC_col column,
-                           const MATREC_row * nonzeroRows, const double * nonzeroValues, size_t numNonzeros) {
+                           const MATREC_row * nonzeroRows, const uint64_t * negativeBits, MATREC_matrix_size numNonzeros) {
     newCol->newColIndex = column;
 
     newCol->numDecompositionRowArcs = 0;
     newCol->numNewRowArcs = 0;
 
+    MATREC_CALL(lookupNonzeroArcs(dec->env, newCol->scratch, &dec->rowArcs, nonzeroRows, numNonzeros));
     for (size_t i = 0; i < numNonzeros; ++i) {
-        spqr_arc rowArc = getDecompositionRowArc(dec, nonzeroRows[i]);
-        bool reversed = nonzeroValues[i] < 0.0;
+        spqr_arc rowArc = newCol->scratch->nonzeroArcs[i];
+        bool reversed = nonzeroIsNegative(negativeBits, i);
         if (SPQRarcIsValid(rowArc)) { //If the arc is the current decomposition: save it in the array
             if (newCol->numDecompositionRowArcs == newCol->memDecompositionRowArcs) {
-                int newNumArcs = newCol->memDecompositionRowArcs == 0 ? 8 : 2 *
+                MATREC_index newNumArcs = newCol->memDecompositionRowArcs == 0 ? 8 : 2 *
                                                                               newCol->memDecompositionRowArcs; //TODO: make reallocation numbers more consistent with rest?
                 newCol->memDecompositionRowArcs = newNumArcs;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->decompositionRowArcs,
@@ -2408,7 +3906,7 @@ newColUpdateColInformation(MATRECNetworkDecomposition *dec, MATRECNetworkColumnA
         } else {
             //Not in the decomposition: add it to the set of arcs which are newly added with this row.
             if (newCol->numNewRowArcs == newCol->memNewRowArcs) {
-                int newNumArcs = newCol->memNewRowArcs == 0 ? 8 : 2 *
+                MATREC_index newNumArcs = newCol->memNewRowArcs == 0 ? 8 : 2 *
                                                                     newCol->memNewRowArcs; //TODO: make reallocation numbers more consistent with rest?
                 newCol->memNewRowArcs = newNumArcs;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->newRowArcs,
@@ -2425,6 +3923,131 @@ newColUpdateColInformation(MATRECNetworkDecomposition *dec, MATRECNetworkColumnA
     return MATREC_OKAY;
 }
 
+///The signed rows of a new column, which are compared with the fundamental cycles of the columns in the column table
+typedef struct {
+    const MATRECNetworkDecomposition * dec;
+    MATRECNetworkAdditionScratch * scratch;
+    MATRECColumnTableEntry * entries;
+    MATREC_index numEntries;
+    bool sorted;
+} DuplicateQuery;
+
+static int compareColumnTableEntries(const void * a, const void * b){
+    MATREC_row first = ((const MATRECColumnTableEntry *) a)->row;
+    MATREC_row second = ((const MATRECColumnTableEntry *) b)->row;
+    return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+///Checks if the fundamental cycle of the column has exactly the rows of the query, with equal or opposite signs
+static MATREC_ERROR columnMatchesEntries(void * data, MATREC_col column, bool negated, bool * pMatches){
+    DuplicateQuery * query = (DuplicateQuery *) data;
+    const MATRECNetworkDecomposition * dec = query->dec;
+    MATRECNetworkAdditionScratch * scratch = query->scratch;
+    MATREC * env = dec->env;
+    if(largestArcID(dec) + 1 > scratch->memCycleCallStack){
+        MATREC_index newSize = max(2 * scratch->memCycleCallStack, largestArcID(dec) + 1);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->cycleCallStack, (size_t) newSize));
+        scratch->memCycleCallStack = newSize;
+    }
+    if(largestNodeID(dec) + 1 > scratch->memCyclePathCallStack){
+        MATREC_index newSize = max(2 * scratch->memCyclePathCallStack, largestNodeID(dec) + 1);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->cyclePathCallStack, (size_t) newSize));
+        scratch->memCyclePathCallStack = newSize;
+    }
+    if(query->numEntries > scratch->memCycleRows){
+        MATREC_index newSize = max(2 * scratch->memCycleRows, query->numEntries);
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->cycleRows, (size_t) newSize));
+        MATREC_CALL(MATRECreallocBlockArray(env, &scratch->cycleRowReversed, (size_t) newSize));
+        scratch->memCycleRows = newSize;
+    }
+    if(!query->sorted){
+        qsort(query->entries, (size_t) query->numEntries, sizeof(MATRECColumnTableEntry), compareColumnTableEntries);
+        query->sorted = true;
+    }
+
+    *pMatches = false;
+    MATREC_index numRows = findFundamentalCycleRows(dec, column, scratch->cycleRows, scratch->cycleRowReversed,
+                                                    query->numEntries, scratch->cycleCallStack,
+                                                    scratch->cyclePathCallStack);
+    if(numRows != query->numEntries){
+        return MATREC_OKAY;
+    }
+    //The rows of the cycle are distinct, so it suffices that each of them is one of the entries
+    for (MATREC_index i = 0; i < numRows; ++i) {
+        MATREC_index low = 0;
+        MATREC_index high = query->numEntries;
+        while(low < high){
+            MATREC_index middle = low + (high - low) / 2;
+            if(query->entries[middle].row < scratch->cycleRows[i]){
+                low = middle + 1;
+            }else{
+                high = middle;
+            }
+        }
+        if(low == query->numEntries || query->entries[low].row != scratch->cycleRows[i] ||
+           (query->entries[low].negative != scratch->cycleRowReversed[i]) != negated){
+            return MATREC_OKAY;
+        }
+    }
+    *pMatches = true;
+    return MATREC_OKAY;
+}
+
+/**
+ * Stores the signed rows of the new column. If all its rows are in the decomposition and they are exactly the rows of an
+ * existing column, up to negation, the new column is parallel to that column. In that case, the path is replaced by
+ * the arc of the existing column.
+ */
+static MATREC_ERROR
+newColFindDuplicate(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol,
+                    const MATREC_row * nonzeroRows, const uint64_t * negativeBits, MATREC_matrix_size numNonzeros) {
+    newCol->isDuplicate = false;
+    newCol->numColumnEntries = 0;
+    newCol->columnHash = 0;
+    //Columns with a single nonzero are already placed in parallel without a lookup, so we do not store them
+    if (numNonzeros < 2) {
+        return MATREC_OKAY;
+    }
+    if ((MATREC_index) numNonzeros > newCol->memColumnEntries) {
+        MATREC_index newSize = max(2 * newCol->memColumnEntries, (MATREC_index) numNonzeros);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newCol->columnEntries, (size_t) newSize));
+        newCol->memColumnEntries = newSize;
+    }
+    //Reserve the slot of the column now, so that adding it can not fail after the decomposition has been changed
+    MATREC_CALL(MATRECcolumnTableReserve(dec->env, &dec->columns));
+    uint64_t negatedHash = 0;
+    for (size_t i = 0; i < numNonzeros; ++i) {
+        bool negative = nonzeroIsNegative(negativeBits, i);
+        newCol->columnEntries[i].row = nonzeroRows[i];
+        newCol->columnEntries[i].negative = negative;
+        newCol->columnHash += MATRECcolumnTableEntryHash(nonzeroRows[i], negative);
+        negatedHash += MATRECcolumnTableEntryHash(nonzeroRows[i], !negative);
+    }
+    newCol->numColumnEntries = (MATREC_index) numNonzeros;
+    if (newCol->numNewRowArcs != 0) {
+        return MATREC_OKAY;
+    }
+
+    DuplicateQuery query = {dec, newCol->scratch, newCol->columnEntries, newCol->numColumnEntries, false};
+    bool negated = false;
+    MATREC_col duplicate;
+    MATREC_CALL(MATRECcolumnTableFind(&dec->columns, newCol->columnHash, newCol->numColumnEntries, false,
+                                      columnMatchesEntries, &query, &duplicate));
+    if (MATRECcolIsInvalid(duplicate)) {
+        negated = true;
+        MATREC_CALL(MATRECcolumnTableFind(&dec->columns, negatedHash, newCol->numColumnEntries, true,
+                                          columnMatchesEntries, &query, &duplicate));
+    }
+    if (MATRECcolIsValid(duplicate)) {
+        assert(newCol->numDecompositionRowArcs >= 2);
+        newCol->decompositionRowArcs[0] = getDecompositionColumnArc(dec, duplicate);
+        newCol->decompositionArcReversed[0] = negated;
+        newCol->numDecompositionRowArcs = 1;
+        newCol->isDuplicate = true;
+    }
+    return MATREC_OKAY;
+}
+
 static MATREC_ERROR computeLeafMembers(const MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol) {
     if (newCol->numReducedMembers > newCol->memLeafMembers) {
         newCol->memLeafMembers = max(newCol->numReducedMembers, 2 * newCol->memLeafMembers);
@@ -2505,7 +4128,7 @@ static void determineSingleComponentType(MATRECNetworkDecomposition *dec, MATREC
     assert(dec);
     assert(newCol);
 
-    int numNonPropagatedAdjacent = newCol->reducedMembers[reducedMember].numChildren-newCol->reducedMembers[reducedMember].numPropagatedChildren;
+    MATREC_index numNonPropagatedAdjacent = newCol->reducedMembers[reducedMember].numChildren-newCol->reducedMembers[reducedMember].numPropagatedChildren;
     if(reducedMemberIsValid(newCol->reducedMembers[reducedMember].parent) &&
             newCol->reducedMembers[newCol->reducedMembers[reducedMember].parent].type != REDUCEDMEMBER_TYPE_CYCLE){
         ++numNonPropagatedAdjacent;
@@ -2540,7 +4163,7 @@ static void determineSingleComponentType(MATRECNetworkDecomposition *dec, MATREC
         case SPQR_MEMBERTYPE_LOOP:
         {
             MATRECColReducedMember *redMem =&newCol->reducedMembers[reducedMember];
-            int countedPathArcs = 0;
+            MATREC_index countedPathArcs = 0;
             bool good = true;
             bool passesForwards = true;
             for(path_arc_id pathArc = redMem->firstPathArc; pathArcIsValid(pathArc);
@@ -2589,7 +4212,7 @@ static void determinePathSeriesType(MATRECNetworkDecomposition * dec, MATRECNetw
     assert(getMemberType(dec,member) == SPQR_MEMBERTYPE_SERIES);
 
     MATRECColReducedMember *redMem =&newCol->reducedMembers[reducedMember];
-    int countedPathArcs = 0;
+    MATREC_index countedPathArcs = 0;
 
     bool good = true;
     bool passesForwards = true;
@@ -3025,7 +4648,7 @@ static void determinePathTypes(MATRECNetworkDecomposition *dec, MATRECNetworkCol
         toPrevious = markerOfParent(dec,member);
         member = findMemberParent(dec,newCol->reducedMembers[reducedMember].member);
         previousReducedMember = reducedMember;
-        reducedMember = newCol->memberInformation[member].reducedMember;
+        reducedMember = newCol->scratch->memberInformation[member].reducedMember;
         newCol->reducedMembers[previousReducedMember].nextPathMember = reducedMember;
         newCol->reducedMembers[previousReducedMember].nextPathMemberIsParent = true;
     }
@@ -3117,7 +4740,7 @@ static ReducedMemberType checkLeaf(MATRECNetworkDecomposition * dec,MATRECNetwor
         case SPQR_MEMBERTYPE_LOOP:
         {
             MATRECColReducedMember *reducedMember =&newCol->reducedMembers[leaf];
-            int countedPathArcs = 0;
+            MATREC_index countedPathArcs = 0;
             bool good = true;
             bool passesForwards = true;
             for(path_arc_id pathArc = reducedMember->firstPathArc; pathArcIsValid(pathArc);
@@ -3166,7 +4789,7 @@ static ReducedMemberType checkLeaf(MATRECNetworkDecomposition * dec,MATRECNetwor
 static void propagateCycles(MATRECNetworkDecomposition * dec, MATRECNetworkColumnAddition * newCol){
     assert(dec);
     assert(newCol);
-    int leafArrayIndex = 0;
+    MATREC_index leafArrayIndex = 0;
 
     while(leafArrayIndex != newCol->numLeafMembers){
         reduced_member_id leaf = newCol->leafMembers[leafArrayIndex];
@@ -3189,7 +4812,7 @@ static void propagateCycles(MATRECNetworkDecomposition * dec, MATRECNetworkColum
             }else{
                 assert(type == REDUCEDMEMBER_TYPE_MERGED);
                 ++leafArrayIndex;
-                int component = newCol->reducedMembers[leaf].componentIndex;
+                MATREC_index component = newCol->reducedMembers[leaf].componentIndex;
                 if(newCol->reducedComponents[component].numPathEndMembers >= 2){
                     newCol->remainsNetwork = false;
                     return;
@@ -3200,7 +4823,7 @@ static void propagateCycles(MATRECNetworkDecomposition * dec, MATRECNetworkColum
             }
         }else{
             ++leafArrayIndex;
-            int component = newCol->reducedMembers[leaf].componentIndex;
+            MATREC_index component = newCol->reducedMembers[leaf].componentIndex;
             if(newCol->reducedComponents[component].numPathEndMembers >= 2){
                 newCol->remainsNetwork = false;
                 return;
@@ -3212,7 +4835,7 @@ static void propagateCycles(MATRECNetworkDecomposition * dec, MATRECNetworkColum
 
     }
 
-    for (int j = 0; j < newCol->numReducedComponents; ++j) {
+    for (MATREC_index j = 0; j < newCol->numReducedComponents; ++j) {
         //The reduced root might be a leaf as well: we propagate it last
         reduced_member_id root = newCol->reducedComponents[j].root;
 
@@ -3245,9 +4868,9 @@ static void propagateCycles(MATRECNetworkDecomposition * dec, MATRECNetworkColum
                 }
             }
             //If the root has exactly one neighbour and is not contained, it is also considered a path end member
-            int component = newCol->reducedMembers[root].componentIndex;
+            MATREC_index component = newCol->reducedMembers[root].componentIndex;
             bool rootPresent = false;
-            for (int i = 0; i < newCol->reducedComponents[component].numPathEndMembers; ++i) {
+            for (MATREC_index i = 0; i < newCol->reducedComponents[component].numPathEndMembers; ++i) {
                 rootPresent = rootPresent || (newCol->reducedComponents[component].pathEndMembers[i] == root);
             }
             if(!rootPresent){
@@ -3280,19 +4903,19 @@ static void determineComponentTypes(MATRECNetworkDecomposition * dec, MATRECNetw
     }
 }
 
-MATREC_ERROR
-MATRECNetworkColumnAdditionCheck(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol, MATREC_col column, const MATREC_row * nonzeroRows,
-                                 const double * nonzeroValues, size_t numNonzeros) {
-    assert(dec);
-    assert(newCol);
-    assert(numNonzeros == 0 || (nonzeroRows && nonzeroValues));
-
-    newCol->remainsNetwork = true;
-    cleanupPreviousIteration(dec, newCol);
-    //assert that previous iteration was cleaned up
-
+static MATREC_ERROR
+checkColumn(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol, MATREC_col column,
+            const MATREC_row * nonzeroRows, const uint64_t * negativeBits, MATREC_matrix_size numNonzeros) {
     //Store call data
-    MATREC_CALL(newColUpdateColInformation(dec, newCol, column, nonzeroRows, nonzeroValues, numNonzeros));
+    MATREC_CALL(newColUpdateColInformation(dec, newCol, column, nonzeroRows, negativeBits, numNonzeros));
+    MATREC_CALL(newColFindDuplicate(dec, newCol, nonzeroRows, negativeBits, numNonzeros));
+
+    //A column without nonzeros in the decomposition does not touch it, so there is nothing to check
+    if(newCol->numDecompositionRowArcs == 0){
+        newCol->numReducedMembers = 0;
+        newCol->numReducedComponents = 0;
+        return MATREC_OKAY;
+    }
 
     //compute reduced decomposition
     MATREC_CALL(constructReducedDecomposition(dec, newCol));
@@ -3302,7 +4925,7 @@ MATRECNetworkColumnAdditionCheck(MATRECNetworkDecomposition *dec, MATRECNetworkC
     propagateCycles(dec,newCol);
     //determine types
     if(newCol->remainsNetwork){
-        for (int i = 0; i < newCol->numReducedComponents; ++i) {
+        for (MATREC_index i = 0; i < newCol->numReducedComponents; ++i) {
             determineComponentTypes(dec,newCol,&newCol->reducedComponents[i]);
         }
     }
@@ -3312,6 +4935,53 @@ MATRECNetworkColumnAdditionCheck(MATRECNetworkDecomposition *dec, MATRECNetworkC
     return MATREC_OKAY;
 }
 
+static MATREC_ERROR
+columnAdditionCheck(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol, MATREC_col column,
+                    const MATREC_row * nonzeroRows, const NonzeroSigns * nonzeroSigns, MATREC_matrix_size numNonzeros) {
+    assert(dec);
+    assert(newCol);
+    assert(numNonzeros == 0 || nonzeroRows);
+
+    newCol->remainsNetwork = true;
+    cleanupPreviousIteration(dec, newCol);
+    if(newCol->autoShrinkCalls > 0){
+        autoShrinkColumnAddition(dec, newCol);
+    }
+    //assert that previous iteration was cleaned up
+
+    //Shrinking frees the scratch memory, so the signs are packed afterwards
+    const uint64_t * negativeBits;
+    MATREC_CALL(packNonzeroSigns(dec->env, newCol->scratch, nonzeroSigns, numNonzeros, &negativeBits));
+    MATREC_CALL(checkColumn(dec, newCol, column, nonzeroRows, negativeBits, numNonzeros));
+    traceCheck(dec, MATREC_TRACE_COLUMN_CHECK, &newCol->traceId, column, nonzeroRows, negativeBits, numNonzeros,
+               newCol->remainsNetwork);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR
+MATRECNetworkColumnAdditionCheck(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol, MATREC_col column, const MATREC_row * nonzeroRows,
+                                 const double * nonzeroValues, MATREC_matrix_size numNonzeros) {
+    assert(numNonzeros == 0 || nonzeroValues);
+    NonzeroSigns signs = {nonzeroValues, NULL, NULL};
+    return columnAdditionCheck(dec, newCol, column, nonzeroRows, &signs, numNonzeros);
+}
+
+MATREC_ERROR
+MATRECNetworkColumnAdditionCheckSigns(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol, MATREC_col column,
+                                      const MATREC_row * nonzeroRows, const int8_t * nonzeroSigns, MATREC_matrix_size numNonzeros) {
+    assert(numNonzeros == 0 || nonzeroSigns);
+    NonzeroSigns signs = {NULL, nonzeroSigns, NULL};
+    return columnAdditionCheck(dec, newCol, column, nonzeroRows, &signs, numNonzeros);
+}
+
+MATREC_ERROR
+MATRECNetworkColumnAdditionCheckPacked(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol, MATREC_col column,
+                                       const MATREC_row * nonzeroRows, const uint64_t * negativeBits, MATREC_matrix_size numNonzeros) {
+    assert(numNonzeros == 0 || negativeBits);
+    NonzeroSigns signs = {NULL, NULL, negativeBits};
+    return columnAdditionCheck(dec, newCol, column, nonzeroRows, &signs, numNonzeros);
+}
+
 ///Contains the data which tells us where to store the new column after the graph has been modified
 ///In case member is a parallel or series node, the respective new column and rows are placed in parallel (or series) with it
 ///Otherwise, the rigid member has a free spot between firstNode and secondNode
@@ -3401,9 +5071,11 @@ static MATREC_ERROR splitSeries(MATRECNetworkDecomposition *dec, MATRECNetworkCo
         assert(pathArcIsValid(pathArcId));
         spqr_arc marked = newCol->pathArcs[pathArcId].arc;
         assert(marked != markerToParent(dec,member));//TODO: handle this case later
+        bool markedIsTree = arcIsTree(dec,marked);
         moveArcToNewMember(dec,marked,member,parallel);
         bool reversed = arcIsReversedNonRigid(dec,marked) ;
-        MATREC_CALL(createMarkerPair(dec,member,parallel,true, reversed,reversed));
+        //The marked arc is a column arc if the new column duplicates it
+        MATREC_CALL(createMarkerPair(dec,member,parallel,markedIsTree, reversed,reversed));
         *loopMember = parallel;
 
         if(reversed == reducedMember->pathBackwards){
@@ -3541,8 +5213,8 @@ static MATREC_ERROR splitSeriesMerging(MATRECNetworkDecomposition *dec, MATRECNe
     assert(SPQRmemberIsValid(member));
     assert(memberIsRepresentative(dec,member));
 
-    int numExceptionArcs = (exceptionArc1 == SPQR_INVALID_ARC ? 0 : 1) + (exceptionArc2 == SPQR_INVALID_ARC ? 0 : 1);
-    int numNonPathArcs = getNumMemberArcs(dec,member) - reducedMember->numPathArcs - numExceptionArcs;
+    MATREC_index numExceptionArcs = (exceptionArc1 == SPQR_INVALID_ARC ? 0 : 1) + (exceptionArc2 == SPQR_INVALID_ARC ? 0 : 1);
+    MATREC_index numNonPathArcs = getNumMemberArcs(dec,member) - reducedMember->numPathArcs - numExceptionArcs;
     bool createPathSeries = reducedMember->numPathArcs > 1;
     //If this holds, there are 2 or more non-parent marker non-path arcs
     bool createNonPathSeries = numNonPathArcs > 1;
@@ -4086,8 +5758,8 @@ static MATREC_ERROR columnTransformSingleRigid(MATRECNetworkDecomposition *dec,
                                                  ,&duplicate,false));
                 }else{
                     MATREC_CALL(createChildMarker(dec,adjacentParallel,adjacentMember,arcIsTree(dec,existingArcWithPath),&duplicate,false));
-                    dec->members[adjacentMember].parentMember = adjacentParallel;
-                    dec->members[adjacentMember].markerOfParent = duplicate;
+                    setMemberParent(dec,adjacentMember,adjacentParallel);
+                    MEMBER(dec, adjacentMember).markerOfParent = duplicate;
                 }
                 //Create the other marker edge
                 spqr_arc parallelMarker = SPQR_INVALID_ARC;
@@ -4102,16 +5774,16 @@ static MATREC_ERROR columnTransformSingleRigid(MATRECNetworkDecomposition *dec,
                 //Change the existing edge to a marker
                 if(isParent){
                     assert(markerToParent(dec,member) == existingArcWithPath);
-                    dec->arcs[markerOfParent(dec,member)].childMember = adjacentParallel;
-                    dec->members[member].parentMember = adjacentParallel;
-                    dec->members[member].markerToParent = existingArcWithPath;
-                    dec->members[member].markerOfParent = parallelMarker;
-                    dec->arcs[existingArcWithPath].element =  arcIsTree(dec,existingArcWithPath) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;;
-                    dec->arcs[existingArcWithPath].childMember = adjacentParallel;
+                    ARC(dec, markerOfParent(dec,member)).childMember = adjacentParallel;
+                    setMemberParent(dec,member,adjacentParallel);
+                    MEMBER(dec, member).markerToParent = existingArcWithPath;
+                    MEMBER(dec, member).markerOfParent = parallelMarker;
+                    ARC(dec, existingArcWithPath).element =  arcIsTree(dec,existingArcWithPath) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;;
+                    ARC(dec, existingArcWithPath).childMember = adjacentParallel;
 
                 }else{
-                    dec->arcs[existingArcWithPath].element = arcIsTree(dec,existingArcWithPath) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
-                    dec->arcs[existingArcWithPath].childMember = adjacentParallel;
+                    ARC(dec, existingArcWithPath).element = arcIsTree(dec,existingArcWithPath) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
+                    ARC(dec, existingArcWithPath).childMember = adjacentParallel;
                 }
 
                 setTerminalMember(newColInfo,adjacentParallel);
@@ -4168,18 +5840,29 @@ static MATREC_ERROR transformComponent(MATRECNetworkDecomposition *dec, MATRECNe
     return MATREC_OKAY;
 }
 
-MATREC_ERROR MATRECNetworkColumnAdditionAdd(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol){
+static MATREC_ERROR columnAdditionAdd(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol){
     assert(dec);
     assert(newCol);
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
+        invalidateMemberAdjacency(dec,newCol->reducedMembers[i].member);
+        recordMemberChanges(dec,newCol->reducedMembers[i].member);
+    }
+    MATREC_index numMembersBefore = dec->numMembers;
+    //The addition only changes the members below the parent of the reduced root, unless it joins trees
+    spqr_member unchangedParent = SPQR_INVALID_MEMBER;
+    spqr_member changedMember = SPQR_INVALID_MEMBER;
+    if(newCol->numReducedComponents == 1){
+        unchangedParent = findMemberParent(dec,newCol->reducedMembers[newCol->reducedComponents[0].root].member);
+    }
 
     if(newCol->numReducedComponents == 0){
-        spqr_member member;
         MATREC_CALL(createStandaloneSeries(dec,newCol->newRowArcs,newCol->newRowArcReversed,
-                                         newCol->numNewRowArcs,newCol->newColIndex,&member));
+                                         newCol->numNewRowArcs,newCol->newColIndex,&changedMember));
     }else if(newCol->numReducedComponents == 1){
         NewColInformation information = emptyNewColInformation();
         MATREC_CALL(transformComponent(dec,newCol,&newCol->reducedComponents[0],&information));
         assert(memberIsRepresentative(dec,information.member));
+        changedMember = information.member;
         if(newCol->numNewRowArcs == 0){
             spqr_arc colArc = SPQR_INVALID_ARC;
             MATREC_CALL(createColumnArc(dec,information.member,&colArc,newCol->newColIndex,information.reversed));
@@ -4214,12 +5897,13 @@ MATREC_ERROR MATRECNetworkColumnAdditionAdd(MATRECNetworkDecomposition *dec, MAT
         }
     }else{
 #ifndef NDEBUG
-        int numDecComponentsBefore = numConnectedComponents(dec);
+        MATREC_index numDecComponentsBefore = numConnectedComponents(dec);
 #endif
         spqr_member newSeries = SPQR_INVALID_MEMBER;
         MATREC_CALL(createConnectedSeries(dec,newCol->newRowArcs,newCol->newRowArcReversed,
                                         newCol->numNewRowArcs,newCol->newColIndex,&newSeries));
-        for (int i = 0; i < newCol->numReducedComponents; ++i) {
+        changedMember = newSeries;
+        for (MATREC_index i = 0; i < newCol->numReducedComponents; ++i) {
             NewColInformation information = emptyNewColInformation();
             MATREC_CALL(transformComponent(dec,newCol,&newCol->reducedComponents[i],&information));
             if(getMemberType(dec,information.member) == SPQR_MEMBERTYPE_LOOP){
@@ -4228,7 +5912,7 @@ MATREC_ERROR MATRECNetworkColumnAdditionAdd(MATRECNetworkDecomposition *dec, MAT
                 assert(newCol->arcInPath[arc]);
                 moveArcToNewMember(dec,arc,information.member,newSeries);
                 arcSetReversed(dec,arc, !newCol->arcInPathReversed[arc]);
-                dec->members[information.member].type = SPQR_MEMBERTYPE_UNASSIGNED;
+                MEMBER(dec, information.member).type = SPQR_MEMBERTYPE_UNASSIGNED;
             }else {
                 reorderComponent(dec,
                                  information.member); //reorder the subtree so that the newly series member is a parent
@@ -4252,6 +5936,26 @@ MATREC_ERROR MATRECNetworkColumnAdditionAdd(MATRECNetworkDecomposition *dec, MAT
         assert(numConnectedComponents(dec) == (numDecComponentsBefore - newCol->numReducedComponents + 1));
     }
 //    decompositionToDot(stdout,dec,true);
+    if(!newCol->isDuplicate && newCol->numColumnEntries >= 2){
+        MATRECcolumnTableInsert(&dec->columns,newCol->columnHash,newCol->newColIndex,newCol->numColumnEntries);
+    }
+    repairMemberAncestorIndex(dec,unchangedParent,changedMember);
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
+        recordMemberChanges(dec,newCol->reducedMembers[i].member);
+    }
+    for (spqr_member member = numMembersBefore; member < dec->numMembers; ++member) {
+        recordMemberChanges(dec,member);
+    }
+    autoFlatten(dec);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkColumnAdditionAdd(MATRECNetworkDecomposition *dec, MATRECNetworkColumnAddition *newCol){
+    MATREC_CALL(columnAdditionAdd(dec,newCol));
+    traceAdd(dec, MATREC_TRACE_COLUMN_ADD, &newCol->traceId);
+    if(readersEnabled(dec)){
+        MATREC_CALL(publishReplica(dec));
+    }
     return MATREC_OKAY;
 }
 
@@ -4259,12 +5963,645 @@ bool MATRECNetworkColumnAdditionRemainsNetwork(MATRECNetworkColumnAddition *newC
     return newCol->remainsNetwork;
 }
 
+typedef enum {
+    CANDIDATE_UNCHECKED = 0, ///No valid outcome is cached, so the candidate must be checked before it is used
+    CANDIDATE_ADDABLE = 1,
+    CANDIDATE_REJECTED = 2, ///Final, as a column which is not addable stays so when other columns are added
+    CANDIDATE_ADDED = 3
+} CandidateState;
+
+typedef struct {
+    MATREC_col column;
+    CandidateState state;
+    MATREC_index firstNonzero;
+    MATREC_index numNonzeros;
+    MATREC_index firstWatch; ///The watches of the members in the reduced decomposition of the last check
+    MATREC_index numWatches;
+    bool spansComponents; ///Whether the last check touched more than one component of the decomposition
+} Candidate;
+
+typedef struct {
+    MATREC_index candidate;
+    spqr_member member;
+    MATREC_index next; ///Next watch of the same member, or -1
+} MemberWatch;
+
+typedef struct {
+    MATREC_index candidate;
+    MATREC_index next; ///Next candidate with a nonzero in the same row, or -1
+} RowWatch;
+
+struct MATRECNetworkCandidatePoolImpl {
+    MATRECNetworkDecomposition *dec;
+    MATRECNetworkColumnAddition *newCol;
+    MATREC_index lastChecked; ///The candidate whose check is stored in newCol, or -1
+
+    Candidate *candidates;
+    MATREC_index memCandidates;
+    MATREC_index numCandidates;
+    MATRECIdMap columnCandidates;
+
+    MATREC_row *nonzeroRows;
+    int8_t *nonzeroSigns;
+    MATREC_index memNonzeros;
+    MATREC_index numNonzeros;
+
+    //For every member, a list of the addable candidates whose last check touched it. Watches of candidates which were
+    //checked again since are skipped, and removed when the watches are compacted
+    MATREC_index *memberWatchHeads;
+    MATREC_index memMemberWatchHeads;
+    MemberWatch *memberWatches;
+    MATREC_index memMemberWatches;
+    MATREC_index numMemberWatches;
+    MATREC_index numLiveMemberWatches;
+
+    //For every row, a list of the candidates with a nonzero in it. Does not change after a candidate is inserted
+    MATRECIdMap rowWatchHeads;
+    RowWatch *rowWatches;
+    MATREC_index memRowWatches;
+    MATREC_index numRowWatches;
+
+    MATREC_index *spanningCandidates; ///Candidates whose last check spanned several components, may contain stale ones
+    MATREC_index memSpanningCandidates;
+    MATREC_index numSpanningCandidates;
+
+    size_t numChecks;
+};
+
+MATREC_ERROR MATRECcreateNetworkCandidatePool(MATREC *env, MATRECNetworkCandidatePool **pPool,
+                                              MATRECNetworkDecomposition *dec){
+    assert(env);
+    assert(dec);
+    MATREC_CALL(MATRECallocBlock(env, pPool));
+    MATRECNetworkCandidatePool *pool = *pPool;
+    pool->dec = dec;
+    pool->newCol = NULL;
+    MATREC_CALL(MATRECcreateNetworkColumnAddition(env, &pool->newCol));
+    pool->lastChecked = -1;
+
+    pool->candidates = NULL;
+    pool->memCandidates = 0;
+    pool->numCandidates = 0;
+    MATREC_CALL(MATRECidMapCreate(env, &pool->columnCandidates, dec->columnArcs.storage, 0, -1));
+
+    pool->nonzeroRows = NULL;
+    pool->nonzeroSigns = NULL;
+    pool->memNonzeros = 0;
+    pool->numNonzeros = 0;
+
+    pool->memberWatchHeads = NULL;
+    pool->memMemberWatchHeads = 0;
+    pool->memberWatches = NULL;
+    pool->memMemberWatches = 0;
+    pool->numMemberWatches = 0;
+    pool->numLiveMemberWatches = 0;
+
+    MATREC_CALL(MATRECidMapCreate(env, &pool->rowWatchHeads, dec->rowArcs.storage, 0, -1));
+    pool->rowWatches = NULL;
+    pool->memRowWatches = 0;
+    pool->numRowWatches = 0;
+
+    pool->spanningCandidates = NULL;
+    pool->memSpanningCandidates = 0;
+    pool->numSpanningCandidates = 0;
+
+    pool->numChecks = 0;
+    return MATREC_OKAY;
+}
+
+void MATRECfreeNetworkCandidatePool(MATREC *env, MATRECNetworkCandidatePool **pPool){
+    assert(env);
+    assert(*pPool);
+    MATRECNetworkCandidatePool *pool = *pPool;
+    MATRECfreeBlockArray(env, &pool->spanningCandidates);
+    MATRECfreeBlockArray(env, &pool->rowWatches);
+    MATRECidMapFree(env, &pool->rowWatchHeads);
+    MATRECfreeBlockArray(env, &pool->memberWatches);
+    MATRECfreeBlockArray(env, &pool->memberWatchHeads);
+    MATRECfreeBlockArray(env, &pool->nonzeroSigns);
+    MATRECfreeBlockArray(env, &pool->nonzeroRows);
+    MATRECidMapFree(env, &pool->columnCandidates);
+    MATRECfreeBlockArray(env, &pool->candidates);
+    MATRECfreeNetworkColumnAddition(env, &pool->newCol);
+    MATRECfreeBlock(env, pPool);
+}
+
+MATREC_ERROR MATRECNetworkCandidatePoolInsert(MATRECNetworkCandidatePool *pool, MATREC_col column,
+                                              const MATREC_row *nonzeroRows, const double *nonzeroValues,
+                                              MATREC_matrix_size numNonzeros){
+    assert(pool);
+    assert(numNonzeros == 0 || (nonzeroRows && nonzeroValues));
+    assert(MATRECidMapGet(&pool->columnCandidates, column) < 0);
+    assert(!MATRECNetworkDecompositionContainsColumn(pool->dec, column));
+    MATREC *env = pool->dec->env;
+
+    if(pool->numCandidates == pool->memCandidates){
+        pool->memCandidates = max(2 * pool->memCandidates, 8);
+        MATREC_CALL(MATRECreallocBlockArray(env, &pool->candidates, (size_t) pool->memCandidates));
+    }
+    MATREC_index numNew = (MATREC_index) numNonzeros;
+    if(pool->numNonzeros + numNew > pool->memNonzeros){
+        pool->memNonzeros = max(2 * pool->memNonzeros, pool->numNonzeros + numNew);
+        MATREC_CALL(MATRECreallocBlockArray(env, &pool->nonzeroRows, (size_t) pool->memNonzeros));
+        MATREC_CALL(MATRECreallocBlockArray(env, &pool->nonzeroSigns, (size_t) pool->memNonzeros));
+    }
+    if(pool->numRowWatches + numNew > pool->memRowWatches){
+        pool->memRowWatches = max(2 * pool->memRowWatches, pool->numRowWatches + numNew);
+        MATREC_CALL(MATRECreallocBlockArray(env, &pool->rowWatches, (size_t) pool->memRowWatches));
+    }
+
+    MATREC_index candidate = pool->numCandidates;
+    Candidate *data = &pool->candidates[candidate];
+    data->column = column;
+    data->state = CANDIDATE_UNCHECKED;
+    data->firstNonzero = pool->numNonzeros;
+    data->numNonzeros = numNew;
+    data->firstWatch = 0;
+    data->numWatches = 0;
+    data->spansComponents = false;
+
+    for (MATREC_index i = 0; i < numNew; ++i) {
+        pool->nonzeroRows[pool->numNonzeros + i] = nonzeroRows[i];
+        pool->nonzeroSigns[pool->numNonzeros + i] = (int8_t) (nonzeroValues[i] < 0.0 ? -1 : 1);
+
+        RowWatch *watch = &pool->rowWatches[pool->numRowWatches];
+        watch->candidate = candidate;
+        watch->next = MATRECidMapGet(&pool->rowWatchHeads, nonzeroRows[i]);
+        MATREC_CALL(MATRECidMapSet(env, &pool->rowWatchHeads, nonzeroRows[i], pool->numRowWatches));
+        ++pool->numRowWatches;
+    }
+    pool->numNonzeros += numNew;
+    MATREC_CALL(MATRECidMapSet(env, &pool->columnCandidates, column, candidate));
+    ++pool->numCandidates;
+    return MATREC_OKAY;
+}
+
+static bool memberWatchIsLive(const MATRECNetworkCandidatePool *pool, MATREC_index watch){
+    const Candidate *candidate = &pool->candidates[pool->memberWatches[watch].candidate];
+    return candidate->state == CANDIDATE_ADDABLE && watch >= candidate->firstWatch &&
+           watch < candidate->firstWatch + candidate->numWatches;
+}
+
+static void invalidateCandidate(MATRECNetworkCandidatePool *pool, MATREC_index candidate){
+    Candidate *data = &pool->candidates[candidate];
+    if(data->state == CANDIDATE_ADDABLE){
+        data->state = CANDIDATE_UNCHECKED;
+        pool->numLiveMemberWatches -= data->numWatches;
+        data->numWatches = 0;
+    }
+}
+
+///Removes the watches of candidates which were checked again or invalidated, and relinks the lists of the members.
+///Also removes the candidates which no longer span several components from the list of spanning candidates
+static void compactWatches(MATRECNetworkCandidatePool *pool){
+    for (MATREC_index member = 0; member < pool->memMemberWatchHeads; ++member) {
+        pool->memberWatchHeads[member] = -1;
+    }
+    //The watches of a candidate are consecutive, so the live ones are moved to the front a candidate at a time
+    MATREC_index numWatches = 0;
+    MATREC_index watch = 0;
+    while(watch < pool->numMemberWatches){
+        Candidate *candidate = &pool->candidates[pool->memberWatches[watch].candidate];
+        if(!memberWatchIsLive(pool, watch)){
+            ++watch;
+            continue;
+        }
+        assert(candidate->firstWatch == watch);
+        candidate->firstWatch = numWatches;
+        for (MATREC_index i = 0; i < candidate->numWatches; ++i) {
+            MemberWatch moved = pool->memberWatches[watch + i];
+            moved.next = pool->memberWatchHeads[moved.member];
+            pool->memberWatchHeads[moved.member] = numWatches;
+            pool->memberWatches[numWatches] = moved;
+            ++numWatches;
+        }
+        watch += candidate->numWatches;
+    }
+    assert(numWatches == pool->numLiveMemberWatches);
+    pool->numMemberWatches = numWatches;
+
+    MATREC_index numSpanning = 0;
+    for (MATREC_index i = 0; i < pool->numSpanningCandidates; ++i) {
+        const Candidate *candidate = &pool->candidates[pool->spanningCandidates[i]];
+        if(candidate->state == CANDIDATE_ADDABLE && candidate->spansComponents){
+            pool->spanningCandidates[numSpanning] = pool->spanningCandidates[i];
+            ++numSpanning;
+        }
+    }
+    pool->numSpanningCandidates = numSpanning;
+}
+
+///Stores the outcome of the check which was just done, and for addable candidates, the members it depends on
+static MATREC_ERROR recordCheck(MATRECNetworkCandidatePool *pool, MATREC_index candidate){
+    MATREC *env = pool->dec->env;
+    MATRECNetworkColumnAddition *newCol = pool->newCol;
+    Candidate *data = &pool->candidates[candidate];
+    if(!newCol->remainsNetwork){
+        data->state = CANDIDATE_REJECTED;
+        return MATREC_OKAY;
+    }
+    data->state = CANDIDATE_ADDABLE;
+
+    if(pool->numMemberWatches > 2 * pool->numLiveMemberWatches + 1024){
+        compactWatches(pool);
+    }
+    MATREC_index numWatches = newCol->numReducedMembers;
+    if(pool->numMemberWatches + numWatches > pool->memMemberWatches){
+        pool->memMemberWatches = max(2 * pool->memMemberWatches, pool->numMemberWatches + numWatches);
+        MATREC_CALL(MATRECreallocBlockArray(env, &pool->memberWatches, (size_t) pool->memMemberWatches));
+    }
+    if(pool->dec->numMembers > pool->memMemberWatchHeads){
+        MATREC_index newSize = max(2 * pool->memMemberWatchHeads, pool->dec->numMembers);
+        MATREC_CALL(MATRECreallocBlockArray(env, &pool->memberWatchHeads, (size_t) newSize));
+        for (MATREC_index member = pool->memMemberWatchHeads; member < newSize; ++member) {
+            pool->memberWatchHeads[member] = -1;
+        }
+        pool->memMemberWatchHeads = newSize;
+    }
+    data->firstWatch = pool->numMemberWatches;
+    data->numWatches = numWatches;
+    for (MATREC_index i = 0; i < numWatches; ++i) {
+        spqr_member member = newCol->reducedMembers[i].member;
+        MemberWatch *watch = &pool->memberWatches[pool->numMemberWatches];
+        watch->candidate = candidate;
+        watch->member = member;
+        watch->next = pool->memberWatchHeads[member];
+        pool->memberWatchHeads[member] = pool->numMemberWatches;
+        ++pool->numMemberWatches;
+    }
+    pool->numLiveMemberWatches += numWatches;
+
+    data->spansComponents = newCol->numReducedComponents > 1;
+    if(data->spansComponents){
+        if(pool->numSpanningCandidates == pool->memSpanningCandidates){
+            pool->memSpanningCandidates = max(2 * pool->memSpanningCandidates, 8);
+            MATREC_CALL(MATRECreallocBlockArray(env, &pool->spanningCandidates, (size_t) pool->memSpanningCandidates));
+        }
+        pool->spanningCandidates[pool->numSpanningCandidates] = candidate;
+        ++pool->numSpanningCandidates;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR checkCandidate(MATRECNetworkCandidatePool *pool, MATREC_index candidate){
+    Candidate *data = &pool->candidates[candidate];
+    assert(data->state == CANDIDATE_UNCHECKED);
+    MATREC_CALL(MATRECNetworkColumnAdditionCheckSigns(pool->dec, pool->newCol, data->column,
+                                                      &pool->nonzeroRows[data->firstNonzero],
+                                                      &pool->nonzeroSigns[data->firstNonzero],
+                                                      (MATREC_matrix_size) data->numNonzeros));
+    ++pool->numChecks;
+    pool->lastChecked = candidate;
+    MATREC_CALL(recordCheck(pool, candidate));
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkCandidatePoolIsAddable(MATRECNetworkCandidatePool *pool, MATREC_col column, bool *isAddable){
+    assert(pool);
+    assert(isAddable);
+    MATREC_index candidate = MATRECidMapGet(&pool->columnCandidates, column);
+    assert(candidate >= 0);
+    if(pool->candidates[candidate].state == CANDIDATE_UNCHECKED){
+        MATREC_CALL(checkCandidate(pool, candidate));
+    }
+    *isAddable = pool->candidates[candidate].state == CANDIDATE_ADDABLE;
+    return MATREC_OKAY;
+}
+
+///Invalidates the addable candidates whose last check touched the given member
+static void invalidateMemberWatches(MATRECNetworkCandidatePool *pool, spqr_member member){
+    if(member >= pool->memMemberWatchHeads){
+        return;
+    }
+    for (MATREC_index watch = pool->memberWatchHeads[member]; watch >= 0; watch = pool->memberWatches[watch].next) {
+        if(memberWatchIsLive(pool, watch)){
+            invalidateCandidate(pool, pool->memberWatches[watch].candidate);
+        }
+    }
+    pool->memberWatchHeads[member] = -1;
+}
+
+MATREC_ERROR MATRECNetworkCandidatePoolAdd(MATRECNetworkCandidatePool *pool, MATREC_col column){
+    assert(pool);
+    MATREC_index candidate = MATRECidMapGet(&pool->columnCandidates, column);
+    assert(candidate >= 0);
+    Candidate *data = &pool->candidates[candidate];
+    assert(data->state == CANDIDATE_ADDABLE || data->state == CANDIDATE_UNCHECKED);
+    if(pool->lastChecked != candidate){
+        invalidateCandidate(pool, candidate);
+        MATREC_CALL(checkCandidate(pool, candidate));
+    }
+    assert(data->state == CANDIDATE_ADDABLE);
+    invalidateCandidate(pool, candidate);
+
+    //An addition which joins components re-roots each of them at its reduced decomposition, which reverses the
+    //parents of the members on the path to the old root. The checks which touched these members are repeated, as
+    //their reduced decompositions are built along the new parents
+    MATRECNetworkColumnAddition *newCol = pool->newCol;
+    if(newCol->numReducedComponents > 1){
+        for (MATREC_index i = 0; i < newCol->numReducedComponents; ++i) {
+            spqr_member root = newCol->reducedMembers[newCol->reducedComponents[i].root].member;
+            for (spqr_member member = findMemberParent(pool->dec, root); SPQRmemberIsValid(member);
+                 member = findMemberParent(pool->dec, member)) {
+                invalidateMemberWatches(pool, member);
+            }
+        }
+    }
+    MATREC_CALL(MATRECNetworkColumnAdditionAdd(pool->dec, newCol));
+    data->state = CANDIDATE_ADDED;
+    pool->lastChecked = -1;
+
+    //The addition only changes the members of its reduced decomposition, so the outcome of other checks can only
+    //change if they touched one of these members, if they have a nonzero in one of the new rows, or if they spanned
+    //several components and the addition joined components
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
+        invalidateMemberWatches(pool, newCol->reducedMembers[i].member);
+    }
+    for (MATREC_index i = 0; i < newCol->numNewRowArcs; ++i) {
+        MATREC_index watch = MATRECidMapGet(&pool->rowWatchHeads, newCol->newRowArcs[i]);
+        for (; watch >= 0; watch = pool->rowWatches[watch].next) {
+            invalidateCandidate(pool, pool->rowWatches[watch].candidate);
+        }
+    }
+    if(newCol->numReducedComponents > 1){
+        for (MATREC_index i = 0; i < pool->numSpanningCandidates; ++i) {
+            if(pool->candidates[pool->spanningCandidates[i]].spansComponents){
+                invalidateCandidate(pool, pool->spanningCandidates[i]);
+            }
+        }
+        pool->numSpanningCandidates = 0;
+    }
+    return MATREC_OKAY;
+}
+
+size_t MATRECNetworkCandidatePoolNumChecks(const MATRECNetworkCandidatePool *pool){
+    assert(pool);
+    return pool->numChecks;
+}
+
+///A column of the current window, with the addition in which it is checked and added
+typedef struct {
+    MATRECNetworkColumnAddition *newCol;
+    MATREC_col column;
+    MATREC_ERROR error;
+} SpeculationSlot;
+
+///Threads which check the columns of a window concurrently, while the decomposition is read-only
+typedef struct {
+    MATRECNetworkDecomposition *dec;
+    const MATREC_matrix_size *columnStarts;
+    const MATREC_row *nonzeroRows;
+    const double *nonzeroValues;
+
+    SpeculationSlot *slots;
+    MATREC_index numSlots; ///The number of columns in the current window
+    MATREC_index nextSlot;
+    MATREC_index numDoneSlots;
+    size_t window; ///Incremented when a new window is started
+    bool stop;
+
+    pthread_mutex_t lock;
+    pthread_cond_t windowStarted;
+    pthread_cond_t windowDone;
+} SpeculationWorkers;
+
+///Checks columns of the current window until all of them are taken. Must be called with the lock held
+static void checkWindowSlots(SpeculationWorkers *workers){
+    while(workers->nextSlot < workers->numSlots){
+        SpeculationSlot *slot = &workers->slots[workers->nextSlot];
+        ++workers->nextSlot;
+        pthread_mutex_unlock(&workers->lock);
+
+        MATREC_matrix_size start = workers->columnStarts[slot->column];
+        MATREC_matrix_size numNonzeros = workers->columnStarts[slot->column + 1] - start;
+        slot->error = MATRECNetworkColumnAdditionCheck(workers->dec, slot->newCol, slot->column,
+                                                       &workers->nonzeroRows[start], &workers->nonzeroValues[start],
+                                                       numNonzeros);
+
+        pthread_mutex_lock(&workers->lock);
+        ++workers->numDoneSlots;
+        if(workers->numDoneSlots == workers->numSlots){
+            pthread_cond_signal(&workers->windowDone);
+        }
+    }
+}
+
+static void * speculationWorker(void *data){
+    SpeculationWorkers *workers = (SpeculationWorkers *) data;
+    size_t seenWindow = 0;
+    pthread_mutex_lock(&workers->lock);
+    while(true){
+        while(workers->window == seenWindow && !workers->stop){
+            pthread_cond_wait(&workers->windowStarted, &workers->lock);
+        }
+        if(workers->stop){
+            break;
+        }
+        seenWindow = workers->window;
+        checkWindowSlots(workers);
+    }
+    pthread_mutex_unlock(&workers->lock);
+    return NULL;
+}
+
+///Checks all columns of the window, on the worker threads and on the calling thread
+static void checkWindow(SpeculationWorkers *workers, MATREC_col firstColumn, MATREC_index numSlots){
+    pthread_mutex_lock(&workers->lock);
+    for (MATREC_index i = 0; i < numSlots; ++i) {
+        workers->slots[i].column = firstColumn + (MATREC_col) i;
+    }
+    workers->numSlots = numSlots;
+    workers->nextSlot = 0;
+    workers->numDoneSlots = 0;
+    workers->dec->readOnly = true;
+    ++workers->window;
+    pthread_cond_broadcast(&workers->windowStarted);
+
+    checkWindowSlots(workers);
+    while(workers->numDoneSlots < workers->numSlots){
+        pthread_cond_wait(&workers->windowDone, &workers->lock);
+    }
+    workers->dec->readOnly = false;
+    pthread_mutex_unlock(&workers->lock);
+}
+
+///Returns true if an earlier addition in the window changed something the check of the column depends on
+static bool speculationIsStale(const MATRECNetworkColumnAddition *newCol, const size_t *memberChanged,
+                               MATREC_index numMemberChanged, const MATRECIdMap *rowIntroduced, size_t window){
+    for (MATREC_index i = 0; i < newCol->numReducedMembers; ++i) {
+        spqr_member member = newCol->reducedMembers[i].member;
+        if(member < numMemberChanged && memberChanged[member] == window){
+            return true;
+        }
+    }
+    for (MATREC_index i = 0; i < newCol->numNewRowArcs; ++i) {
+        if(MATRECidMapGet(rowIntroduced, newCol->newRowArcs[i]) == (MATREC_index) window){
+            return true;
+        }
+    }
+    return false;
+}
+
+static MATREC_ERROR speculativeAddColumns(MATRECNetworkDecomposition *dec, SpeculationWorkers *workers,
+                                          MATREC_matrix_size numColumns, MATREC_index windowSize,
+                                          MATREC_matrix_size *numAdded){
+    MATREC *env = dec->env;
+    size_t *memberChanged = NULL; ///The window in which a member was last changed by an addition
+    MATREC_index memMemberChanged = 0;
+    MATRECIdMap rowIntroduced; ///The window in which a row was introduced by an addition
+    MATREC_CALL(MATRECidMapCreate(env, &rowIntroduced, dec->rowArcs.storage, 0, -1));
+
+    MATREC_ERROR error = MATREC_OKAY;
+    *numAdded = 0;
+    MATREC_col firstColumn = 0;
+    bool remainsNetwork = true;
+    while(remainsNetwork && firstColumn < numColumns){
+        MATREC_index numSlots = (MATREC_index) (numColumns - firstColumn) < windowSize ?
+                                (MATREC_index) (numColumns - firstColumn) : windowSize;
+        error = updateMemberAncestorIndex(dec);
+        if(error != MATREC_OKAY){
+            break;
+        }
+        bool walked = !dec->memberAncestors.valid;
+        checkWindow(workers, firstColumn, numSlots);
+        size_t window = workers->window;
+
+        //Commit the columns in order. Rejections are final, as a column which does not fit the decomposition also
+        //does not fit it after more columns are added. After an addition which joins components, the parents of the
+        //members in them change, so all later checks in the window are repeated
+        bool joinedComponents = false;
+        for (MATREC_index i = 0; i < numSlots && error == MATREC_OKAY; ++i) {
+            SpeculationSlot *slot = &workers->slots[i];
+            MATRECNetworkColumnAddition *newCol = slot->newCol;
+            error = slot->error;
+            if(error != MATREC_OKAY){
+                break;
+            }
+            if(walked && newCol->numDecompositionRowArcs > 1){
+                dec->memberAncestors.walkSteps += (size_t) newCol->numReducedMembers;
+            }
+            if(newCol->remainsNetwork && (joinedComponents ||
+               speculationIsStale(newCol, memberChanged, memMemberChanged, &rowIntroduced, window))){
+                MATREC_matrix_size start = workers->columnStarts[slot->column];
+                error = MATRECNetworkColumnAdditionCheck(dec, newCol, slot->column, &workers->nonzeroRows[start],
+                                                         &workers->nonzeroValues[start],
+                                                         workers->columnStarts[slot->column + 1] - start);
+                if(error != MATREC_OKAY){
+                    break;
+                }
+            }
+            if(!newCol->remainsNetwork){
+                remainsNetwork = false;
+                break;
+            }
+
+            if(dec->numMembers > memMemberChanged){
+                MATREC_index newSize = max(2 * memMemberChanged, dec->numMembers);
+                error = MATRECreallocBlockArray(env, &memberChanged, (size_t) newSize);
+                if(error != MATREC_OKAY){
+                    break;
+                }
+                for (MATREC_index member = memMemberChanged; member < newSize; ++member) {
+                    memberChanged[member] = 0;
+                }
+                memMemberChanged = newSize;
+            }
+            for (MATREC_index j = 0; j < newCol->numReducedMembers; ++j) {
+                memberChanged[newCol->reducedMembers[j].member] = window;
+            }
+            for (MATREC_index j = 0; j < newCol->numNewRowArcs && error == MATREC_OKAY; ++j) {
+                error = MATRECidMapSet(env, &rowIntroduced, newCol->newRowArcs[j], (MATREC_index) window);
+            }
+            if(error != MATREC_OKAY){
+                break;
+            }
+            joinedComponents = joinedComponents || newCol->numReducedComponents > 1;
+
+            error = MATRECNetworkColumnAdditionAdd(dec, newCol);
+            ++*numAdded;
+        }
+        firstColumn += (MATREC_col) numSlots;
+    }
+    MATRECidMapFree(env, &rowIntroduced);
+    MATRECfreeBlockArray(env, &memberChanged);
+    return error;
+}
+
+MATREC_ERROR MATRECNetworkSpeculativeColumnAddition(MATRECNetworkDecomposition *dec, MATREC_matrix_size numColumns,
+                                                    const MATREC_matrix_size *columnStarts,
+                                                    const MATREC_row *nonzeroRows, const double *nonzeroValues,
+                                                    MATREC_index windowSize, MATREC_index numThreads,
+                                                    MATREC_matrix_size *numAdded){
+    assert(dec);
+    assert(columnStarts);
+    assert(windowSize > 0);
+    assert(numThreads > 0);
+    assert(numAdded);
+    MATREC *env = dec->env;
+
+    SpeculationWorkers workers;
+    workers.dec = dec;
+    workers.columnStarts = columnStarts;
+    workers.nonzeroRows = nonzeroRows;
+    workers.nonzeroValues = nonzeroValues;
+    workers.numSlots = 0;
+    workers.nextSlot = 0;
+    workers.numDoneSlots = 0;
+    workers.window = 0;
+    workers.stop = false;
+    MATREC_CALL(MATRECallocBlockArray(env, &workers.slots, (size_t) windowSize));
+
+    MATREC_ERROR error = MATREC_OKAY;
+    MATREC_index numSlotsCreated = 0;
+    for (; numSlotsCreated < windowSize && error == MATREC_OKAY; ++numSlotsCreated) {
+        workers.slots[numSlotsCreated].newCol = NULL;
+        error = MATRECcreateNetworkColumnAddition(env, &workers.slots[numSlotsCreated].newCol);
+    }
+
+    pthread_t *threads = NULL;
+    MATREC_index numStarted = 0;
+    if(error == MATREC_OKAY){
+        pthread_mutex_init(&workers.lock, NULL);
+        pthread_cond_init(&workers.windowStarted, NULL);
+        pthread_cond_init(&workers.windowDone, NULL);
+        //The calling thread checks columns too
+        error = numThreads > 1 ? MATRECallocBlockArray(env, &threads, (size_t) (numThreads - 1)) : MATREC_OKAY;
+        for (; error == MATREC_OKAY && numStarted < numThreads - 1; ++numStarted) {
+            if(pthread_create(&threads[numStarted], NULL, speculationWorker, &workers) != 0){
+                break;
+            }
+        }
+        if(error == MATREC_OKAY){
+            error = speculativeAddColumns(dec, &workers, numColumns, windowSize, numAdded);
+        }
+
+        pthread_mutex_lock(&workers.lock);
+        workers.stop = true;
+        pthread_cond_broadcast(&workers.windowStarted);
+        pthread_mutex_unlock(&workers.lock);
+        for (MATREC_index i = 0; i < numStarted; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        MATRECfreeBlockArray(env, &threads);
+        pthread_cond_destroy(&workers.windowDone);
+        pthread_cond_destroy(&workers.windowStarted);
+        pthread_mutex_destroy(&workers.lock);
+    }
+    for (MATREC_index i = 0; i < numSlotsCreated; ++i) {
+        if(workers.slots[i].newCol){
+            MATRECfreeNetworkColumnAddition(env, &workers.slots[i].newCol);
+        }
+    }
+    MATRECfreeBlockArray(env, &workers.slots);
+    return error;
+}
+
 
-static int min(int a, int b){
+static MATREC_index min(MATREC_index a, MATREC_index b){
     return a < b ? a : b;
 }
 
-typedef int cut_arc_id;
+typedef MATREC_index cut_arc_id;
 #define INVALID_CUT_ARC (-1)
 
 static bool cutArcIsInvalid(const cut_arc_id arc){
@@ -4292,8 +6629,8 @@ typedef enum{
 
 
 typedef struct{
-    int low;
-    int discoveryTime;
+    MATREC_index low;
+    MATREC_index discoveryTime;
 } ArticulationNodeInformation;
 
 //We allocate the callstacks of recursive algorithms (usually DFS, bounded by some linear number of calls)
@@ -4302,7 +6639,7 @@ typedef struct{
 //Stack overflows
 typedef struct {
     spqr_node node;
-    spqr_arc nodeArc;
+    MATREC_index position; //Position in the adjacency snapshot
 } DFSCallData;
 
 typedef struct{
@@ -4313,10 +6650,11 @@ typedef struct{
 typedef struct{
     spqr_node node;
     spqr_arc arc;
+    MATREC_index position; //Position in the adjacency snapshot, used instead of arc when the member has one
 } ColorDFSCallData;
 
 typedef struct{
-    spqr_arc arc;
+    MATREC_index position; //Position in the adjacency snapshot
     spqr_node node;
     spqr_node parent;
     bool isAP;
@@ -4331,7 +6669,7 @@ typedef enum{
 typedef struct {
     spqr_member member;
     spqr_member rootMember;
-    int depth;
+    MATREC_index depth;
     RowReducedMemberType type;
     reduced_member_id parent;
 
@@ -4340,7 +6678,7 @@ typedef struct {
     children_idx numPropagatedChildren;
 
     cut_arc_id firstCutArc;
-    int numCutArcs;
+    MATREC_index numCutArcs;
 
     //For non-rigid members
     spqr_arc splitArc;
@@ -4360,7 +6698,7 @@ typedef struct {
 } MATRECRowReducedMember;
 
 typedef struct {
-    int rootDepth;
+    MATREC_index rootDepth;
     reduced_member_id root;
 } MATRECRowReducedComponent;
 
@@ -4368,80 +6706,83 @@ struct MATRECNetworkRowAdditionImpl {
     bool remainsNetwork;
 
     MATRECRowReducedMember *reducedMembers;
-    int memReducedMembers;
-    int numReducedMembers;
+    MATREC_index memReducedMembers;
+    MATREC_index numReducedMembers;
 
     MATRECRowReducedComponent *reducedComponents;
-    int memReducedComponents;
-    int numReducedComponents;
+    MATREC_index memReducedComponents;
+    MATREC_index numReducedComponents;
 
-    MemberInfo *memberInformation;
-    int memMemberInformation;
-    int numMemberInformation;
+    MATRECNetworkAdditionScratch *scratch;
+    bool ownsScratch; ///Whether the scratch memory is freed together with this object
 
     reduced_member_id *childrenStorage;
-    int memChildrenStorage;
-    int numChildrenStorage;
+    MATREC_index memChildrenStorage;
+    MATREC_index numChildrenStorage;
 
     CutArcListNode *cutArcs;
-    int memCutArcs;
-    int numCutArcs;
+    MATREC_index memCutArcs;
+    MATREC_index numCutArcs;
     cut_arc_id firstOverallCutArc;
 
     MATREC_row newRowIndex;
 
     MATREC_col *newColumnArcs;
     bool *newColumnReversed;
-    int memColumnArcs;
-    int numColumnArcs;
+    MATREC_index memColumnArcs;
+    MATREC_index numColumnArcs;
 
     reduced_member_id *leafMembers;
-    int numLeafMembers;
-    int memLeafMembers;
+    MATREC_index numLeafMembers;
+    MATREC_index memLeafMembers;
 
     spqr_arc *decompositionColumnArcs;
     bool *decompositionColumnArcReversed;
-    int memDecompositionColumnArcs;
-    int numDecompositionColumnArcs;
+    MATREC_index memDecompositionColumnArcs;
+    MATREC_index numDecompositionColumnArcs;
 
     bool *isArcCut;
     bool *isArcCutReversed;
-    int numIsArcCut;
-    int memIsArcCut;
+    MATREC_index numIsArcCut;
+    MATREC_index memIsArcCut;
 
     COLOR_STATUS *nodeColors;
-    int memNodeColors;
+    MATREC_index memNodeColors;
 
     spqr_node *articulationNodes;
-    int numArticulationNodes;
-    int memArticulationNodes;
+    MATREC_index numArticulationNodes;
+    MATREC_index memArticulationNodes;
 
     ArticulationNodeInformation *articulationNodeSearchInfo;
-    int memNodeSearchInfo;
+    MATREC_index memNodeSearchInfo;
 
-    int *crossingPathCount;
-    int memCrossingPathCount;
+    MATREC_index *crossingPathCount;
+    MATREC_index memCrossingPathCount;
 
     DFSCallData *intersectionDFSData;
-    int memIntersectionDFSData;
+    MATREC_index memIntersectionDFSData;
 
     ColorDFSCallData *colorDFSData;
-    int memColorDFSData;
+    MATREC_index memColorDFSData;
 
     ArticulationPointCallStack *artDFSData;
-    int memArtDFSData;
-
-    CreateReducedMembersCallstack *createReducedMembersCallstack;
-    int memCreateReducedMembersCallstack;
+    MATREC_index memArtDFSData;
 
-    int *intersectionPathDepth;
-    int memIntersectionPathDepth;
+    MATREC_index *intersectionPathDepth;
+    MATREC_index memIntersectionPathDepth;
 
     spqr_node *intersectionPathParent;
-    int memIntersectionPathParent;
+    MATREC_index memIntersectionPathParent;
 
     MergeTreeCallData *mergeTreeCallData;
-    int memMergeTreeCallData;
+    MATREC_index memMergeTreeCallData;
+
+    size_t peakMemory; ///Largest number of allocated bytes of the arrays before they were last shrunk
+    //If not 0, the arrays are freed after this many consecutive checks on a much smaller decomposition
+    size_t autoShrinkCalls;
+    size_t numUnderusedCalls;
+
+    MATRECTraceId traceId;
 };
 
 typedef struct {
@@ -4467,20 +6808,21 @@ static NewRowInformation emptyNewRowInformation(void){
  * already part of the decomposition.
  */
 static MATREC_ERROR newRowUpdateRowInformation(const MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow,
-                                               const MATREC_row row, const MATREC_col * columns, const double * columnValues,
-                                               const size_t numColumns)
+                                               const MATREC_row row, const MATREC_col * columns, const uint64_t * negativeBits,
+                                               const MATREC_matrix_size numColumns)
 {
     newRow->newRowIndex = row;
 
     newRow->numDecompositionColumnArcs = 0;
     newRow->numColumnArcs = 0;
 
+    MATREC_CALL(lookupNonzeroArcs(dec->env, newRow->scratch, &dec->columnArcs, columns, numColumns));
     for (size_t i = 0; i < numColumns; ++i) {
-        spqr_arc columnArc = getDecompositionColumnArc(dec, columns[i]);
-        bool reversed = columnValues[i] < 0.0;
+        spqr_arc columnArc = newRow->scratch->nonzeroArcs[i];
+        bool reversed = nonzeroIsNegative(negativeBits, i);
         if(SPQRarcIsValid(columnArc)){ //If the arc is the current decomposition: save it in the array
             if(newRow->numDecompositionColumnArcs == newRow->memDecompositionColumnArcs){
-                int newNumArcs = newRow->memDecompositionColumnArcs == 0 ? 8 : 2*newRow->memDecompositionColumnArcs; //TODO: make reallocation numbers more consistent with rest?
+                MATREC_index newNumArcs = newRow->memDecompositionColumnArcs == 0 ? 8 : 2*newRow->memDecompositionColumnArcs; //TODO: make reallocation numbers more consistent with rest?
                 newRow->memDecompositionColumnArcs = newNumArcs;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->decompositionColumnArcs,
                                                 (size_t) newRow->memDecompositionColumnArcs));
@@ -4493,7 +6835,7 @@ static MATREC_ERROR newRowUpdateRowInformation(const MATRECNetworkDecomposition
         }else{
             //Not in the decomposition: add it to the set of arcs which are newly added with this row.
             if(newRow->numColumnArcs == newRow->memColumnArcs){
-                int newNumArcs = newRow->memColumnArcs == 0 ? 8 : 2*newRow->memColumnArcs; //TODO: make reallocation numbers more consistent with rest?
+                MATREC_index newNumArcs = newRow->memColumnArcs == 0 ? 8 : 2*newRow->memColumnArcs; //TODO: make reallocation numbers more consistent with rest?
                 newRow->memColumnArcs = newNumArcs;
                 MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->newColumnArcs,
                                                 (size_t)newRow->memColumnArcs));
@@ -4510,22 +6852,24 @@ static MATREC_ERROR newRowUpdateRowInformation(const MATRECNetworkDecomposition
 }
 
 /**
- * Recursively creates reduced members from this member to the root of the decomposition tree.
+ * Recursively creates reduced members from this member to the root of the decomposition tree, or to stopMember if
+ * it is an ancestor of this member.
  * @param dec
  * @param newRow
  * @param member
  * @return
  */
-static reduced_member_id createRowReducedMembersToRoot(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition * newRow, const spqr_member firstMember){
+static reduced_member_id createRowReducedMembersToRoot(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition * newRow, const spqr_member firstMember,
+                                                    const spqr_member stopMember){
     assert(SPQRmemberIsValid(firstMember));
 
-    CreateReducedMembersCallstack * callstack = newRow->createReducedMembersCallstack;
+    CreateReducedMembersCallstack * callstack = newRow->scratch->createReducedMembersCallStack;
     callstack[0].member = firstMember;
-    int callDepth = 0;
+    MATREC_index callDepth = 0;
 
     while(callDepth >= 0){
         spqr_member member = callstack[callDepth].member;
-        reduced_member_id reducedMember = newRow->memberInformation[member].reducedMember;
+        reduced_member_id reducedMember = newRow->scratch->memberInformation[member].reducedMember;
 
         bool reducedValid = reducedMemberIsValid(reducedMember);
         if(!reducedValid) {
@@ -4551,14 +6895,15 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECNetworkDecompositio
             reducedMemberData->willBeReversed = false;
             reducedMemberData->coloredNode = SPQR_INVALID_NODE;
 
-            newRow->memberInformation[member].reducedMember = reducedMember;
+            newRow->scratch->memberInformation[member].reducedMember = reducedMember;
             assert(memberIsRepresentative(dec, member));
-            spqr_member parentMember = findMemberParent(dec, member);
+            //The stop member is the root of the reduced component, so we do not need to walk further up the tree
+            spqr_member parentMember = member == stopMember ? SPQR_INVALID_MEMBER : findMemberParent(dec, member);
 
             if (SPQRmemberIsValid(parentMember)) {
                 //recursive call to parent member
                 ++callDepth;
-                assert(callDepth < newRow->memCreateReducedMembersCallstack);
+                assert(callDepth < newRow->scratch->memCreateReducedMembersCallStack);
                 callstack[callDepth].member = parentMember;
                 continue;
 
@@ -4578,7 +6923,7 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECNetworkDecompositio
             assert(reducedMember < newRow->numReducedMembers);
             //Reduced member was already created in earlier call
             //update the depth of the root if appropriate
-            reduced_member_id * depthMinimizer = &newRow->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+            reduced_member_id * depthMinimizer = &newRow->scratch->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
             if(reducedMemberIsInvalid(*depthMinimizer) ||
                newRow->reducedMembers[reducedMember].depth < newRow->reducedMembers[*depthMinimizer].depth){
                 *depthMinimizer = reducedMember;
@@ -4588,9 +6933,9 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECNetworkDecompositio
             --callDepth;
             if(callDepth < 0 ) break;
             spqr_member parentMember = callstack[callDepth + 1].member;
-            reduced_member_id parentReducedMember = newRow->memberInformation[parentMember].reducedMember;
+            reduced_member_id parentReducedMember = newRow->scratch->memberInformation[parentMember].reducedMember;
             spqr_member currentMember = callstack[callDepth].member;
-            reduced_member_id currentReducedMember = newRow->memberInformation[currentMember].reducedMember;
+            reduced_member_id currentReducedMember = newRow->scratch->memberInformation[currentMember].reducedMember;
 
             MATRECRowReducedMember *parentReducedMemberData = &newRow->reducedMembers[parentReducedMember];
             MATRECRowReducedMember *reducedMemberData = &newRow->reducedMembers[currentReducedMember];
@@ -4604,7 +6949,7 @@ static reduced_member_id createRowReducedMembersToRoot(MATRECNetworkDecompositio
 
     }
 
-    reduced_member_id returnedMember = newRow->memberInformation[callstack[0].member].reducedMember;
+    reduced_member_id returnedMember = newRow->scratch->memberInformation[callstack[0].member].reducedMember;
     return returnedMember;
 }
 
@@ -4617,8 +6962,8 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECNetworkDecomposition*
     //TODO: chop up into more functions
     //TODO: stricter assertions/array bounds checking in this function
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newRow->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newRow->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newRow->scratch->memberInformation[i].reducedMember));
     }
 #endif
 
@@ -4630,51 +6975,75 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECNetworkDecomposition*
     assert(newRow->numReducedMembers == 0);
     assert(newRow->numReducedComponents == 0);
 
-    int newSize = largestMemberID(dec); //Is this sufficient?
+    MATREC_index newSize = largestMemberID(dec); //Is this sufficient?
     if(newSize > newRow->memReducedMembers){
         newRow->memReducedMembers = max(2*newRow->memReducedMembers,newSize);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->reducedMembers,(size_t) newRow->memReducedMembers));
     }
-    if(newSize > newRow->memMemberInformation){
-        int updatedSize = max(2*newRow->memMemberInformation,newSize);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->memberInformation,(size_t) updatedSize));
-        for (int i = newRow->memMemberInformation; i < updatedSize; ++i) {
-            newRow->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
-            newRow->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+    if(newSize > newRow->scratch->memMemberInformation){
+        MATREC_index updatedSize = max(2*newRow->scratch->memMemberInformation,newSize);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->scratch->memberInformation,(size_t) updatedSize));
+        for (MATREC_index i = newRow->scratch->memMemberInformation; i < updatedSize; ++i) {
+            newRow->scratch->memberInformation[i].reducedMember = INVALID_REDUCED_MEMBER;
+            newRow->scratch->memberInformation[i].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+            newRow->scratch->memberInformation[i].componentLCA = SPQR_INVALID_MEMBER;
         }
-        newRow->memMemberInformation = updatedSize;
+        newRow->scratch->memMemberInformation = updatedSize;
 
     }
 
-    int numComponents = numConnectedComponents(dec);
+    MATREC_index numComponents = numConnectedComponents(dec);
     if(numComponents > newRow->memReducedComponents){
         newRow->memReducedComponents = max(2*newRow->memReducedComponents,numComponents);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->reducedComponents,(size_t) newRow->memReducedComponents));
     }
 
-    int numMembers = getNumMembers(dec);
-    if(newRow->memCreateReducedMembersCallstack < numMembers){
-        newRow->memCreateReducedMembersCallstack = max(2*newRow->memCreateReducedMembersCallstack,numMembers);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->createReducedMembersCallstack,(size_t) newRow->memCreateReducedMembersCallstack));
+    MATREC_index numMembers = getNumMembers(dec);
+    if(newRow->scratch->memCreateReducedMembersCallStack < numMembers){
+        newRow->scratch->memCreateReducedMembersCallStack = max(2*newRow->scratch->memCreateReducedMembersCallStack,numMembers);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->scratch->createReducedMembersCallStack,(size_t) newRow->scratch->memCreateReducedMembersCallStack));
     }
 
     //Create the reduced members (recursively)
-    for (int i = 0; i < newRow->numDecompositionColumnArcs; ++i) {
+    //With the ancestor index, we only walk up to the lowest common ancestor of the touched members in each tree
+    MATREC_CALL(updateMemberAncestorIndex(dec));
+    const MATRECAncestorIndex * ancestors = &dec->memberAncestors;
+    bool useAncestors = ancestors->valid;
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newRow->numDecompositionColumnArcs; ++i) {
+            spqr_member arcMember = findArcMember(dec, newRow->decompositionColumnArcs[i]);
+            spqr_member * lca = &newRow->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,arcMember)].componentLCA;
+            *lca = SPQRmemberIsValid(*lca) ? MATRECancestorIndexLCA(ancestors,*lca,arcMember) : arcMember;
+        }
+    }
+    for (MATREC_index i = 0; i < newRow->numDecompositionColumnArcs; ++i) {
         assert(i < newRow->memDecompositionColumnArcs);
         spqr_arc arc = newRow->decompositionColumnArcs[i];
         spqr_member arcMember = findArcMember(dec, arc);
-        reduced_member_id reducedMember = createRowReducedMembersToRoot(dec,newRow,arcMember);
-        reduced_member_id* depthMinimizer = &newRow->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
+        spqr_member stopMember = useAncestors
+                ? newRow->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,arcMember)].componentLCA
+                : SPQR_INVALID_MEMBER;
+        reduced_member_id reducedMember = createRowReducedMembersToRoot(dec, newRow, arcMember, stopMember);
+        reduced_member_id* depthMinimizer = &newRow->scratch->memberInformation[newRow->reducedMembers[reducedMember].rootMember].rootDepthMinimizer;
         if(reducedMemberIsInvalid(*depthMinimizer)){
             *depthMinimizer = reducedMember;
         }
     }
 
+    if(useAncestors){
+        for (MATREC_index i = 0; i < newRow->numDecompositionColumnArcs; ++i) {
+            spqr_member arcMember = findArcMember(dec, newRow->decompositionColumnArcs[i]);
+            newRow->scratch->memberInformation[MATRECancestorIndexRoot(ancestors,arcMember)].componentLCA = SPQR_INVALID_MEMBER;
+        }
+    }else{
+        dec->memberAncestors.walkSteps += (size_t) newRow->numReducedMembers;
+    }
+
     //Set the reduced roots according to the root depth minimizers
-    for (int i = 0; i < newRow->numReducedComponents; ++i) {
+    for (MATREC_index i = 0; i < newRow->numReducedComponents; ++i) {
         MATRECRowReducedComponent * component = &newRow->reducedComponents[i];
         spqr_member rootMember = newRow->reducedMembers[component->root].member;
-        reduced_member_id reducedMinimizer = newRow->memberInformation[rootMember].rootDepthMinimizer;
+        reduced_member_id reducedMinimizer = newRow->scratch->memberInformation[rootMember].rootDepthMinimizer;
         component->rootDepth =  newRow->reducedMembers[reducedMinimizer].depth;
         component->root = reducedMinimizer;
 
@@ -4684,10 +7053,10 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECNetworkDecomposition*
     }
 
     //update the children array
-    int numTotalChildren = 0;
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
+    MATREC_index numTotalChildren = 0;
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
         MATRECRowReducedMember * reducedMember = &newRow->reducedMembers[i];
-        reduced_member_id minimizer = newRow->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
+        reduced_member_id minimizer = newRow->scratch->memberInformation[reducedMember->rootMember].rootDepthMinimizer;
         if(reducedMember->depth >= newRow->reducedMembers[minimizer].depth){
             reducedMember->firstChild = numTotalChildren;
             numTotalChildren += reducedMember->numChildren;
@@ -4696,7 +7065,7 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECNetworkDecomposition*
     }
 
     if(newRow->memChildrenStorage < numTotalChildren){
-        int newMemSize = max(newRow->memChildrenStorage*2, numTotalChildren);
+        MATREC_index newMemSize = max(newRow->memChildrenStorage*2, numTotalChildren);
         newRow->memChildrenStorage = newMemSize;
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->childrenStorage,(size_t) newRow->memChildrenStorage));
     }
@@ -4705,11 +7074,11 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECNetworkDecomposition*
     //Fill up the children array`
     for(reduced_member_id  reducedMember = 0; reducedMember < newRow->numReducedMembers; ++reducedMember){
         MATRECRowReducedMember * reducedMemberData = &newRow->reducedMembers[reducedMember];
-        if(reducedMemberData->depth <= newRow->reducedMembers[newRow->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth){
+        if(reducedMemberData->depth <= newRow->reducedMembers[newRow->scratch->memberInformation[reducedMemberData->rootMember].rootDepthMinimizer].depth){
             continue;
         }
         spqr_member parentMember = findMemberParent(dec, reducedMemberData->member);
-        reduced_member_id parentReducedMember = SPQRmemberIsValid(parentMember) ? newRow->memberInformation[parentMember].reducedMember : INVALID_REDUCED_MEMBER;
+        reduced_member_id parentReducedMember = SPQRmemberIsValid(parentMember) ? newRow->scratch->memberInformation[parentMember].reducedMember : INVALID_REDUCED_MEMBER;
         if(reducedMemberIsValid(parentReducedMember)){ //TODO: probably one of these two checks/branches is unnecessary, as there is a single failure case? (Not sure)
             MATRECRowReducedMember * parentReducedMemberData = &newRow->reducedMembers[parentReducedMember];
             newRow->childrenStorage[parentReducedMemberData->firstChild + parentReducedMemberData->numChildren] = reducedMember;
@@ -4718,13 +7087,13 @@ static MATREC_ERROR constructRowReducedDecomposition(MATRECNetworkDecomposition*
     }
 
     //Clean up the root depth minimizers.
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
         MATRECRowReducedMember * reducedMember = &newRow->reducedMembers[i];
         assert(reducedMember);
         spqr_member rootMember = reducedMember->rootMember;
         assert(rootMember >= 0);
         assert(rootMember < dec->memMembers);
-        newRow->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
+        newRow->scratch->memberInformation[rootMember].rootDepthMinimizer = INVALID_REDUCED_MEMBER;
     }
 
     return MATREC_OKAY;
@@ -4765,7 +7134,7 @@ static void createCutArc(MATRECNetworkDecomposition  * dec,
         listNode->arcHead = findEffectiveArcHead(dec,arc);
         listNode->arcTail = findEffectiveArcTail(dec,arc);
         if(reversed){
-            swap_ints(&listNode->arcHead,&listNode->arcTail);
+            swap_indices(&listNode->arcHead,&listNode->arcTail);
         }
         assert(SPQRnodeIsValid(listNode->arcHead) && SPQRnodeIsValid(listNode->arcTail));
     }else{
@@ -4784,34 +7153,34 @@ static MATREC_ERROR createReducedDecompositionCutArcs(MATRECNetworkDecomposition
     //Allocate memory for cut arcs
     spqr_arc maxArcID = largestArcID(dec);
     if(maxArcID > newRow->memIsArcCut){
-        int newSize = max(maxArcID,2*newRow->memIsArcCut);
+        MATREC_index newSize = max(maxArcID,2*newRow->memIsArcCut);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->isArcCut,(size_t) newSize));
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->isArcCutReversed,(size_t) newSize));
-        for (int i = newRow->memIsArcCut; i < newSize ; ++i) {
+        for (MATREC_index i = newRow->memIsArcCut; i < newSize ; ++i) {
             newRow->isArcCut[i] = false;
             newRow->isArcCutReversed[i] = false;
         }
         newRow->memIsArcCut = newSize;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memIsArcCut; ++i) {
+    for (MATREC_index i = 0; i < newRow->memIsArcCut; ++i) {
         assert(!newRow->isArcCut[i]);
         assert(!newRow->isArcCutReversed[i]);
     }
 #endif
 
-    int numNeededArcs = newRow->numDecompositionColumnArcs*4;
+    MATREC_index numNeededArcs = newRow->numDecompositionColumnArcs*4;
     if(numNeededArcs > newRow->memCutArcs){
-        int newSize = max(newRow->memCutArcs*2, numNeededArcs);
+        MATREC_index newSize = max(newRow->memCutArcs*2, numNeededArcs);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->cutArcs,(size_t) newSize));
         newRow->memCutArcs = newSize;
     }
     newRow->numCutArcs = 0;
     newRow->firstOverallCutArc = INVALID_CUT_ARC;
-    for (int i = 0; i < newRow->numDecompositionColumnArcs; ++i) {
+    for (MATREC_index i = 0; i < newRow->numDecompositionColumnArcs; ++i) {
         spqr_arc arc = newRow->decompositionColumnArcs[i];
         spqr_member member = findArcMember(dec, arc);
-        reduced_member_id reduced_member = newRow->memberInformation[member].reducedMember;
+        reduced_member_id reduced_member = newRow->scratch->memberInformation[member].reducedMember;
         assert(reducedMemberIsValid(reduced_member));
         createCutArc(dec,newRow,arc,reduced_member,newRow->decompositionColumnArcReversed[i]);
     }
@@ -4820,95 +7189,202 @@ static MATREC_ERROR createReducedDecompositionCutArcs(MATRECNetworkDecomposition
 }
 
 /**
- * Determines the members of the reduced decomposition which are leafs.
- * This is used in propagation to ensure propagation is only checked for components which have at most one neighbour
- * which is not propagated.
+ * Determines the members of the reduced decomposition which are leafs.
+ * This is used in propagation to ensure propagation is only checked for components which have at most one neighbour
+ * which is not propagated.
+ */
+static MATREC_ERROR determineLeafReducedMembers(const MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow) {
+    if (newRow->numDecompositionColumnArcs > newRow->memLeafMembers) {
+        newRow->memLeafMembers = max(newRow->numDecompositionColumnArcs, 2 * newRow->memLeafMembers);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newRow->leafMembers, (size_t) newRow->memLeafMembers));
+    }
+    newRow->numLeafMembers = 0;
+
+    for (reduced_member_id reducedMember = 0; reducedMember < newRow->numReducedMembers; ++reducedMember) {
+        if (newRow->reducedMembers[reducedMember].numChildren == 0) {
+            newRow->leafMembers[newRow->numLeafMembers] = reducedMember;
+            ++newRow->numLeafMembers;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_index getFirstNodeAdjacency(const MATRECNetworkDecomposition *dec, spqr_node node){
+    assert(NODE(dec, node).adjacencyStart >= 0);
+    return NODE(dec, node).adjacencyStart;
+}
+
+static MATREC_index getNodeAdjacencyEnd(const MATRECNetworkDecomposition *dec, spqr_node node){
+    assert(NODE(dec, node).adjacencyStart >= 0);
+    return NODE(dec, node).adjacencyStart + NODE(dec, node).numArcs;
+}
+
+/**
+ * Ensures that the snapshot storage can hold the adjacency of any member, so that snapshots are built without allocating.
+ */
+static MATREC_ERROR reserveAdjacencySnapshots(MATRECNetworkDecomposition *dec){
+    MATREC_index minimalSize = 2 * dec->numArcs;
+    if(minimalSize > dec->memAdjacencyEntries){
+        MATREC_index newSize = max(2 * dec->memAdjacencyEntries, 2 * minimalSize);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env,&dec->adjacencyEntries,(size_t) newSize));
+        dec->memAdjacencyEntries = newSize;
+    }
+    return MATREC_OKAY;
+}
+
+static void addNodeAdjacency(MATRECNetworkDecomposition *dec, spqr_node node){
+    if(NODE(dec, node).adjacencyStart >= 0){
+        return;
+    }
+    MATREC_index position = dec->numAdjacencyEntries;
+    NODE(dec, node).adjacencyStart = position;
+    spqr_arc firstArc = getFirstNodeArc(dec,node);
+    spqr_arc arc = firstArc;
+    do{
+        spqr_node head = findArcHead(dec,arc);
+        assert(position < dec->memAdjacencyEntries);
+        dec->adjacencyEntries[position].arc = arc;
+        dec->adjacencyEntries[position].node = head == node ? findArcTail(dec,arc) : head;
+        ++position;
+        arc = getNextNodeArc(dec,arc,node);
+    }while(arc != firstArc);
+    assert(position - NODE(dec, node).adjacencyStart == nodeDegree(dec,node));
+    dec->numAdjacencyEntries = position;
+}
+
+#ifndef NDEBUG
+static bool memberAdjacencyIsConsistent(MATRECNetworkDecomposition *dec, spqr_member member){
+    spqr_arc firstArc = getFirstMemberArc(dec,member);
+    spqr_arc memberArc = firstArc;
+    do{
+        spqr_node nodes[2] = {findArcHead(dec,memberArc),findArcTail(dec,memberArc)};
+        for (int i = 0; i < 2; ++i) {
+            spqr_node node = nodes[i];
+            MATREC_index position = getFirstNodeAdjacency(dec,node);
+            spqr_arc firstNodeArc = getFirstNodeArc(dec,node);
+            spqr_arc arc = firstNodeArc;
+            do{
+                spqr_node head = findArcHead(dec,arc);
+                if(position == getNodeAdjacencyEnd(dec,node) || dec->adjacencyEntries[position].arc != arc ||
+                   dec->adjacencyEntries[position].node != (head == node ? findArcTail(dec,arc) : head)){
+                    return false;
+                }
+                ++position;
+                arc = getNextNodeArc(dec,arc,node);
+            }while(arc != firstNodeArc);
+            if(position != getNodeAdjacencyEnd(dec,node)){
+                return false;
+            }
+        }
+        memberArc = getNextMemberArc(dec,memberArc);
+    }while(memberArc != firstArc);
+    return true;
+}
+#endif
+
+/**
+ * Builds the adjacency snapshot of a rigid member, unless it has a valid one already.
+ * The arcs around each node are stored in the same order as in the node's arc list, so that searches over the snapshot
+ * visit the nodes in the same order as searches over the arc lists.
  */
-static MATREC_ERROR determineLeafReducedMembers(const MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow) {
-    if (newRow->numDecompositionColumnArcs > newRow->memLeafMembers) {
-        newRow->memLeafMembers = max(newRow->numDecompositionColumnArcs, 2 * newRow->memLeafMembers);
-        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newRow->leafMembers, (size_t) newRow->memLeafMembers));
+static void buildMemberAdjacency(MATRECNetworkDecomposition *dec, spqr_member member){
+    assert(memberIsRepresentative(dec,member));
+    assert(getMemberType(dec,member) == SPQR_MEMBERTYPE_RIGID);
+    if(memberHasAdjacency(dec,member)){
+        assert(memberAdjacencyIsConsistent(dec,member));
+        return;
     }
-    newRow->numLeafMembers = 0;
-
-    for (reduced_member_id reducedMember = 0; reducedMember < newRow->numReducedMembers; ++reducedMember) {
-        if (newRow->reducedMembers[reducedMember].numChildren == 0) {
-            newRow->leafMembers[newRow->numLeafMembers] = reducedMember;
-            ++newRow->numLeafMembers;
-        }
+    MATREC_index numEntries = 2 * getNumMemberArcs(dec,member);
+    assert(numEntries <= dec->memAdjacencyEntries);
+    if(dec->numAdjacencyEntries + numEntries > dec->memAdjacencyEntries){
+        ++dec->adjacencyVersion;
+        dec->numAdjacencyEntries = 0;
     }
-    return MATREC_OKAY;
+
+    spqr_arc firstArc = getFirstMemberArc(dec,member);
+    spqr_arc arc = firstArc;
+    do{
+        NODE(dec, findArcHead(dec,arc)).adjacencyStart = -1;
+        NODE(dec, findArcTail(dec,arc)).adjacencyStart = -1;
+        arc = getNextMemberArc(dec,arc);
+    }while(arc != firstArc);
+    do{
+        addNodeAdjacency(dec,findArcHead(dec,arc));
+        addNodeAdjacency(dec,findArcTail(dec,arc));
+        arc = getNextMemberArc(dec,arc);
+    }while(arc != firstArc);
+    MEMBER(dec, member).adjacencyVersion = dec->adjacencyVersion;
 }
 
 /**
  * Preallocates memory arrays necessary for searching rigid components.
  */
 static MATREC_ERROR allocateRigidSearchMemory(const MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow){
-    int totalNumNodes = getNumNodes(dec);
-    int maxNumNodes = 2*dec->numArcs;
+    MATREC_index totalNumNodes = getNumNodes(dec);
+    MATREC_index maxNumNodes = 2*dec->numArcs;
     if(maxNumNodes > newRow->memNodeColors){
-        int newSize = max(2*newRow->memNodeColors,maxNumNodes);
+        MATREC_index newSize = max(2*newRow->memNodeColors,maxNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->nodeColors,(size_t) newSize));
-        for (int i = newRow->memNodeColors; i < newSize; ++i) {
+        for (MATREC_index i = newRow->memNodeColors; i < newSize; ++i) {
             newRow->nodeColors[i] = UNCOLORED;
         }
         newRow->memNodeColors = newSize;
     }
 
     if(totalNumNodes > newRow->memArticulationNodes){
-        int newSize = max(2*newRow->memArticulationNodes,totalNumNodes);
+        MATREC_index newSize = max(2*newRow->memArticulationNodes,totalNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->articulationNodes,(size_t) newSize));
         newRow->memArticulationNodes = newSize;
     }
     if(totalNumNodes > newRow->memNodeSearchInfo){
-        int newSize = max(2*newRow->memNodeSearchInfo,totalNumNodes);
+        MATREC_index newSize = max(2*newRow->memNodeSearchInfo,totalNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->articulationNodeSearchInfo,(size_t) newSize));
         newRow->memNodeSearchInfo = newSize;
     }
     if(totalNumNodes > newRow->memCrossingPathCount){
-        int newSize = max(2*newRow->memCrossingPathCount,totalNumNodes);
+        MATREC_index newSize = max(2*newRow->memCrossingPathCount,totalNumNodes);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->crossingPathCount,(size_t) newSize));
         newRow->memCrossingPathCount = newSize;
     }
 
     //TODO: see if tradeoff for performance bound by checking max # of nodes of rigid is worth it to reduce size
     //of the following allocations
-    int largestID  = largestNodeID(dec); //TODO: only update the stack sizes of the following when needed? The preallocation might be causing performance problems
+    MATREC_index largestID  = largestNodeID(dec); //TODO: only update the stack sizes of the following when needed? The preallocation might be causing performance problems
     if(largestID > newRow->memIntersectionDFSData){
-        int newSize = max(2*newRow->memIntersectionDFSData,largestID);
+        MATREC_index newSize = max(2*newRow->memIntersectionDFSData,largestID);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->intersectionDFSData,(size_t) newSize));
         newRow->memIntersectionDFSData = newSize;
     }
     if(largestID > newRow->memColorDFSData){
-        int newSize = max(2*newRow->memColorDFSData, largestID);
+        MATREC_index newSize = max(2*newRow->memColorDFSData, largestID);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->colorDFSData,(size_t) newSize));
         newRow->memColorDFSData = newSize;
     }
     if(largestID > newRow->memArtDFSData){
-        int newSize = max(2*newRow->memArtDFSData,largestID);
+        MATREC_index newSize = max(2*newRow->memArtDFSData,largestID);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->artDFSData,(size_t) newSize));
         newRow->memArtDFSData = newSize;
     }
 
-    for (int i = 0; i < newRow->memIntersectionPathDepth; ++i) {
+    for (MATREC_index i = 0; i < newRow->memIntersectionPathDepth; ++i) {
         newRow->intersectionPathDepth[i] = -1;
     }
 
     if(largestID > newRow->memIntersectionPathDepth){
-        int newSize = max(2*newRow->memIntersectionPathDepth,largestID);
-        MATRECreallocBlockArray(dec->env, &newRow->intersectionPathDepth, (size_t) newSize);
-        for (int i = newRow->memIntersectionPathDepth; i < newSize; ++i) {
+        MATREC_index newSize = max(2*newRow->memIntersectionPathDepth,largestID);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newRow->intersectionPathDepth, (size_t) newSize));
+        for (MATREC_index i = newRow->memIntersectionPathDepth; i < newSize; ++i) {
             newRow->intersectionPathDepth[i] = -1;
         }
         newRow->memIntersectionPathDepth = newSize;
     }
-    for (int i = 0; i < newRow->memIntersectionPathParent; ++i) {
+    for (MATREC_index i = 0; i < newRow->memIntersectionPathParent; ++i) {
         newRow->intersectionPathParent[i] = SPQR_INVALID_NODE;
     }
     if(largestID > newRow->memIntersectionPathParent){
-        int newSize = max(2*newRow->memIntersectionPathParent,largestID);
-        MATRECreallocBlockArray(dec->env, &newRow->intersectionPathParent, (size_t) newSize);
-        for (int i = newRow->memIntersectionPathParent; i <newSize; ++i) {
+        MATREC_index newSize = max(2*newRow->memIntersectionPathParent,largestID);
+        MATREC_CALL(MATRECreallocBlockArray(dec->env, &newRow->intersectionPathParent, (size_t) newSize));
+        for (MATREC_index i = newRow->memIntersectionPathParent; i <newSize; ++i) {
             newRow->intersectionPathParent[i] = SPQR_INVALID_NODE;
         }
         newRow->memIntersectionPathParent = newSize;
@@ -4931,7 +7407,7 @@ static void zeroOutColors(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddit
         return;
     }
 
-    int depth = 0;
+    MATREC_index depth = 0;
 
     while(depth >= 0){
         assert(depth < newRow->memColorDFSData);
@@ -4957,17 +7433,49 @@ static void zeroOutColors(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddit
     }
 
 
+}
+///Same as zeroOutColors, but searches over the adjacency snapshot of the member containing the node
+static void zeroOutMemberColors(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow, const spqr_node firstRemoveNode){
+    assert(firstRemoveNode < newRow->memNodeColors);
+    const MATRECNetworkAdjacencyEntry * adjacency = dec->adjacencyEntries;
+
+    newRow->nodeColors[firstRemoveNode] = UNCOLORED;
+    ColorDFSCallData * data = newRow->colorDFSData;
+
+    data[0].node = firstRemoveNode;
+    data[0].position = getFirstNodeAdjacency(dec,firstRemoveNode);
+
+    MATREC_index depth = 0;
+
+    while(depth >= 0){
+        assert(depth < newRow->memColorDFSData);
+        ColorDFSCallData * callData = &data[depth];
+        spqr_node otherNode = adjacency[callData->position].node;
+        assert(otherNode < newRow->memNodeColors);
+        ++callData->position;
+        if(newRow->nodeColors[otherNode] != UNCOLORED){
+            newRow->nodeColors[otherNode] = UNCOLORED;
+            ++depth;
+            data[depth].node = otherNode;
+            data[depth].position = getFirstNodeAdjacency(dec,otherNode);
+            continue;
+        }
+
+        while(depth >= 0 && data[depth].position == getNodeAdjacencyEnd(dec,data[depth].node)){
+            --depth;
+        }
+    }
 }
 static void cleanUpPreviousIteration(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow){
     //zero out coloring information from previous check
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
         if (SPQRnodeIsValid(newRow->reducedMembers[i].coloredNode)) {
             zeroOutColors(dec, newRow, newRow->reducedMembers[i].coloredNode);
         }
     }
 
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memNodeColors; ++i) {
+    for (MATREC_index i = 0; i < newRow->memNodeColors; ++i) {
         assert(newRow->nodeColors[i] == UNCOLORED);
     }
 #endif
@@ -4981,7 +7489,7 @@ static void cleanUpPreviousIteration(MATRECNetworkDecomposition * dec, MATRECNet
         newRow->isArcCutReversed[cutArc] = false;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memIsArcCut; ++i) {
+    for (MATREC_index i = 0; i < newRow->memIsArcCut; ++i) {
       assert(!newRow->isArcCut[i]);
       assert(!newRow->isArcCutReversed[i]);
     }
@@ -5033,7 +7541,7 @@ static void rigidFindStarNodes(MATRECNetworkDecomposition * dec, MATRECNetworkRo
         }
 
         //intersection between intersectionNodes and head and tail
-        for (int i = 0; i < 2; ++i) {
+        for (MATREC_index i = 0; i < 2; ++i) {
             if(intersectionNodes[i] != head && intersectionNodes[i] != tail){
                 intersectionNodes[i] = SPQR_INVALID_NODE;
             }
@@ -5078,38 +7586,19 @@ static void rigidFindStarNodes(MATRECNetworkDecomposition * dec, MATRECNetworkRo
 static MATREC_ERROR zeroOutColorsExceptNeighbourhood(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow,
                                                    const spqr_node articulationNode, const spqr_node startRemoveNode){
     COLOR_STATUS * neighbourColors;
-    int degree = nodeDegree(dec,articulationNode);
+    MATREC_index degree = nodeDegree(dec,articulationNode);
     MATREC_CALL(MATRECallocBlockArray(dec->env,&neighbourColors,(size_t) degree));
 
-    {
-        int i = 0;
-        spqr_arc artFirstArc = getFirstNodeArc(dec, articulationNode);
-        spqr_arc artItArc = artFirstArc;
-        do{
-            spqr_node head = findArcHead(dec, artItArc);
-            spqr_node tail = findArcTail(dec, artItArc);
-            spqr_node otherNode = articulationNode == head ? tail : head;
-            neighbourColors[i] = newRow->nodeColors[otherNode];
-            i++;
-            assert(i <= degree);
-            artItArc = getNextNodeArc(dec,artItArc,articulationNode);
-        }while(artItArc != artFirstArc);
+    const MATRECNetworkAdjacencyEntry * adjacency = dec->adjacencyEntries;
+    MATREC_index first = getFirstNodeAdjacency(dec,articulationNode);
+    MATREC_index end = getNodeAdjacencyEnd(dec,articulationNode);
+    for (MATREC_index i = first; i < end; ++i) {
+        neighbourColors[i - first] = newRow->nodeColors[adjacency[i].node];
     }
-    zeroOutColors(dec,newRow,startRemoveNode);
+    zeroOutMemberColors(dec,newRow,startRemoveNode);
 
-    {
-        int i = 0;
-        spqr_arc artFirstArc = getFirstNodeArc(dec, articulationNode);
-        spqr_arc artItArc = artFirstArc;
-        do{
-            spqr_node head = findArcHead(dec, artItArc);
-            spqr_node tail = findArcTail(dec, artItArc);
-            spqr_node otherNode = articulationNode == head ? tail : head;
-            newRow->nodeColors[otherNode] = neighbourColors[i];
-            i++;
-            assert(i <= degree);
-            artItArc = getNextNodeArc(dec,artItArc,articulationNode);
-        }while(artItArc != artFirstArc);
+    for (MATREC_index i = first; i < end; ++i) {
+        newRow->nodeColors[adjacency[i].node] = neighbourColors[i - first];
     }
 
     MATRECfreeBlockArray(dec->env,&neighbourColors);
@@ -5117,9 +7606,10 @@ static MATREC_ERROR zeroOutColorsExceptNeighbourhood(MATRECNetworkDecomposition
 }
 
 static void intersectionOfAllPaths(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition *newRow,
-                                   const reduced_member_id toCheck, int * const nodeNumPaths){
-    int * intersectionPathDepth = newRow->intersectionPathDepth;
+                                   const reduced_member_id toCheck, MATREC_index * const nodeNumPaths){
+    MATREC_index * intersectionPathDepth = newRow->intersectionPathDepth;
     spqr_node * intersectionPathParent = newRow->intersectionPathParent;
+    const MATRECNetworkAdjacencyEntry * adjacency = dec->adjacencyEntries;
 
     //First do a dfs over the tree, storing all the tree-parents and depths for each node
     //TODO: maybe cache this tree and also update it so we can prevent this DFS call?
@@ -5133,29 +7623,28 @@ static void intersectionOfAllPaths(MATRECNetworkDecomposition * dec, MATRECNetwo
         assert(intersectionPathDepth[root] == -1);
         assert(intersectionPathParent[root] == SPQR_INVALID_NODE);
 
-        int pathSearchCallStackSize = 0;
+        MATREC_index pathSearchCallStackSize = 0;
 
         intersectionPathDepth[root] = 0;
         intersectionPathParent[root] = SPQR_INVALID_NODE;
 
         pathSearchCallStack[0].node = root;
-        pathSearchCallStack[0].nodeArc = getFirstNodeArc(dec, root);
+        pathSearchCallStack[0].position = getFirstNodeAdjacency(dec, root);
         pathSearchCallStackSize++;
         while (pathSearchCallStackSize > 0) {
             assert(pathSearchCallStackSize <= newRow->memIntersectionDFSData);
             DFSCallData *dfsData = &pathSearchCallStack[pathSearchCallStackSize - 1];
+            const MATRECNetworkAdjacencyEntry *entry = &adjacency[dfsData->position];
             //cannot be a tree arc which is its parent
-            if (arcIsTree(dec, dfsData->nodeArc) &&
+            if (arcIsTree(dec, entry->arc) &&
                 (pathSearchCallStackSize <= 1 ||
-                 dfsData->nodeArc != pathSearchCallStack[pathSearchCallStackSize - 2].nodeArc)) {
-                spqr_node head = findArcHeadNoCompression(dec, dfsData->nodeArc);
-                spqr_node tail = findArcTailNoCompression(dec, dfsData->nodeArc);
-                spqr_node other = head == dfsData->node ? tail : head;
+                 entry->arc != adjacency[pathSearchCallStack[pathSearchCallStackSize - 2].position].arc)) {
+                spqr_node other = entry->node;
                 assert(other != dfsData->node);
 
                 //We go up a level: add new node to the call stack
                 pathSearchCallStack[pathSearchCallStackSize].node = other;
-                pathSearchCallStack[pathSearchCallStackSize].nodeArc = getFirstNodeArc(dec, other);
+                pathSearchCallStack[pathSearchCallStackSize].position = getFirstNodeAdjacency(dec, other);
                 //Every time a new node is discovered/added, we update its parent and depth information
                 assert(intersectionPathDepth[other] == -1);
                 assert(intersectionPathParent[other] == SPQR_INVALID_NODE);
@@ -5165,8 +7654,8 @@ static void intersectionOfAllPaths(MATRECNetworkDecomposition * dec, MATRECNetwo
                 continue;
             }
             do {
-                dfsData->nodeArc = getNextNodeArc(dec, dfsData->nodeArc, dfsData->node);
-                if (dfsData->nodeArc == getFirstNodeArc(dec, dfsData->node)) {
+                ++dfsData->position;
+                if (dfsData->position == getNodeAdjacencyEnd(dec, dfsData->node)) {
                     --pathSearchCallStackSize;
                     dfsData = &pathSearchCallStack[pathSearchCallStackSize - 1];
                 } else {
@@ -5185,8 +7674,8 @@ static void intersectionOfAllPaths(MATRECNetworkDecomposition * dec, MATRECNetwo
         //Iteratively jump up to the parents until they reach a common parent
         spqr_node source = findArcHead(dec, arc);
         spqr_node target = findArcTail(dec, arc);
-        int sourceDepth = intersectionPathDepth[source];
-        int targetDepth = intersectionPathDepth[target];
+        MATREC_index sourceDepth = intersectionPathDepth[source];
+        MATREC_index targetDepth = intersectionPathDepth[target];
         nodeNumPaths[source]++;
         nodeNumPaths[target]++;
 
@@ -5220,7 +7709,7 @@ static void intersectionOfAllPaths(MATRECNetworkDecomposition * dec, MATRECNetwo
 
 static void addArticulationNode(MATRECNetworkRowAddition *newRow, spqr_node articulationNode){
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->numArticulationNodes; ++i) {
+    for (MATREC_index i = 0; i < newRow->numArticulationNodes; ++i) {
         assert(newRow->articulationNodes[i] != articulationNode);
     }
 #endif
@@ -5229,16 +7718,17 @@ static void addArticulationNode(MATRECNetworkRowAddition *newRow, spqr_node arti
 }
 static void articulationPoints(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition * newRow, ArticulationNodeInformation *nodeInfo, reduced_member_id reducedMember){
     const bool * arcRemoved = newRow->isArcCut;
+    const MATRECNetworkAdjacencyEntry * adjacency = dec->adjacencyEntries;
 
-    int rootChildren = 0;
+    MATREC_index rootChildren = 0;
     spqr_node root_node = findArcHead(dec, getFirstMemberArc(dec, newRow->reducedMembers[reducedMember].member));;
 
     ArticulationPointCallStack * callStack = newRow->artDFSData;
 
-    int depth = 0;
-    int time = 1;
+    MATREC_index depth = 0;
+    MATREC_index time = 1;
 
-    callStack[depth].arc = getFirstNodeArc(dec,root_node);
+    callStack[depth].position = getFirstNodeAdjacency(dec,root_node);
     callStack[depth].node = root_node;
     callStack[depth].parent = SPQR_INVALID_NODE;
     callStack[depth].isAP = false;
@@ -5247,11 +7737,10 @@ static void articulationPoints(MATRECNetworkDecomposition *dec, MATRECNetworkRow
     nodeInfo[root_node].discoveryTime = time;
 
     while(depth >= 0){
-        if(!arcRemoved[callStack[depth].arc]){
+        const MATRECNetworkAdjacencyEntry * entry = &adjacency[callStack[depth].position];
+        if(!arcRemoved[entry->arc]){
             spqr_node node = callStack[depth].node;
-            spqr_node head = findArcHead(dec, callStack[depth].arc);
-            spqr_node tail = findArcTail(dec, callStack[depth].arc);
-            spqr_node otherNode = node == head ? tail : head;
+            spqr_node otherNode = entry->node;
             if(otherNode != callStack[depth].parent){
                 if(nodeInfo[otherNode].discoveryTime == 0){
                     if(depth == 0){
@@ -5262,7 +7751,7 @@ static void articulationPoints(MATRECNetworkDecomposition *dec, MATRECNetworkRow
                     assert(depth < newRow->memArtDFSData);
                     callStack[depth].parent = node;
                     callStack[depth].node = otherNode;
-                    callStack[depth].arc = getFirstNodeArc(dec,otherNode);
+                    callStack[depth].position = getFirstNodeAdjacency(dec,otherNode);
                     callStack[depth].isAP = false;
 
                     ++time;
@@ -5277,8 +7766,8 @@ static void articulationPoints(MATRECNetworkDecomposition *dec, MATRECNetworkRow
         }
 
         while(true){
-            callStack[depth].arc = getNextNodeArc(dec,callStack[depth].arc,callStack[depth].node);
-            if(callStack[depth].arc != getFirstNodeArc(dec,callStack[depth].node)) break;
+            ++callStack[depth].position;
+            if(callStack[depth].position != getNodeAdjacencyEnd(dec,callStack[depth].node)) break;
             --depth;
             if (depth < 0) break;
 
@@ -5306,26 +7795,26 @@ static void rigidConnectedColoringRecursive(MATRECNetworkDecomposition *dec, MAT
     const bool * isArcCut = newRow->isArcCut;
     COLOR_STATUS * nodeColors = newRow->nodeColors;
     ColorDFSCallData * data = newRow->colorDFSData;
+    const MATRECNetworkAdjacencyEntry * adjacency = dec->adjacencyEntries;
 
     data[0].node = firstProcessNode;
-    data[0].arc = getFirstNodeArc(dec,firstProcessNode);
+    data[0].position = getFirstNodeAdjacency(dec,firstProcessNode);
     newRow->nodeColors[firstProcessNode] = firstColor;
 
-    int depth = 0;
+    MATREC_index depth = 0;
     while(depth >= 0){
         assert(depth < newRow->memColorDFSData);
         assert(newRow->nodeColors[articulationNode] == UNCOLORED);
 
         ColorDFSCallData * callData = &data[depth];
-        spqr_node head = findArcHead(dec, callData->arc);
-        spqr_node tail = findArcTail(dec, callData->arc);
-        spqr_node otherNode = callData->node == head ? tail : head;
+        spqr_arc arc = adjacency[callData->position].arc;
+        spqr_node otherNode = adjacency[callData->position].node;
         COLOR_STATUS currentColor = nodeColors[callData->node];
         COLOR_STATUS otherColor = nodeColors[otherNode];
         //Checks the direction of the arc; in the rest of the algorithm, we just need to check partition
-        if(isArcCut[callData->arc] && currentColor != otherColor){
-            bool otherIsTail = callData->node == head;
-            bool arcReversed = findArcSign(dec,callData->arc).reversed != newRow->isArcCutReversed[callData->arc];
+        if(isArcCut[arc] && currentColor != otherColor){
+            bool otherIsTail = callData->node == findArcHead(dec,arc);
+            bool arcReversed = findArcSign(dec,arc).reversed != newRow->isArcCutReversed[arc];
             bool good = (currentColor == COLOR_SOURCE) == (otherIsTail == arcReversed);
             if(!good){
                 *isGood = false;
@@ -5334,26 +7823,26 @@ static void rigidConnectedColoringRecursive(MATRECNetworkDecomposition *dec, MAT
         }
         if(otherNode != articulationNode){
             if(otherColor == UNCOLORED){
-                if(isArcCut[callData->arc]){
+                if(isArcCut[arc]){
                     nodeColors[otherNode] = currentColor == COLOR_SOURCE ? COLOR_SINK : COLOR_SOURCE; //reverse the colors
                 }else{
                     nodeColors[otherNode] = currentColor;
                 }
-                callData->arc = getNextNodeArc(dec,callData->arc,callData->node);
+                ++callData->position;
 
                 depth++;
                 assert(depth < newRow->memColorDFSData);
                 data[depth].node = otherNode;
-                data[depth].arc = getFirstNodeArc(dec,otherNode);
+                data[depth].position = getFirstNodeAdjacency(dec,otherNode);
                 continue;
             }
-            if(isArcCut[callData->arc] != (currentColor != otherColor)){
+            if(isArcCut[arc] != (currentColor != otherColor)){
                 *isGood = false;
                 break;
             }
         }
-        callData->arc = getNextNodeArc(dec,callData->arc,callData->node);
-        while(depth >= 0 && data[depth].arc == getFirstNodeArc(dec,data[depth].node)){
+        ++callData->position;
+        while(depth >= 0 && data[depth].position == getNodeAdjacencyEnd(dec,data[depth].node)){
             --depth;
         }
     }
@@ -5407,7 +7896,7 @@ static void rigidConnectedColoring(MATRECNetworkDecomposition *dec, MATRECNetwor
 
     // Need to zero all colors for next attempts if we failed
     if(!(*isGood)){
-        zeroOutColors(dec,newRow,firstProcessNode);
+        zeroOutMemberColors(dec,newRow,firstProcessNode);
         newRow->reducedMembers[reducedMember].coloredNode = SPQR_INVALID_NODE;
     }else{
         //Otherwise, we zero out all colors but the ones which we need
@@ -5422,15 +7911,14 @@ static spqr_node checkNeighbourColoringArticulationNode(MATRECNetworkDecompositi
     spqr_node secondSideCandidate = SPQR_INVALID_NODE;
     spqr_arc firstSideArc = SPQR_INVALID_ARC;
     spqr_arc secondSideArc = SPQR_INVALID_ARC;
-    int numFirstSide = 0;
-    int numSecondSide = 0;
-
-    spqr_arc firstArc = getFirstNodeArc(dec, articulationNode);
-    spqr_arc moveArc = firstArc;
-    do{
-        spqr_node head = findArcHead(dec, moveArc);
-        spqr_node tail = findArcTail(dec, moveArc);
-        spqr_node otherNode = articulationNode == head ? tail : head;
+    MATREC_index numFirstSide = 0;
+    MATREC_index numSecondSide = 0;
+
+    const MATRECNetworkAdjacencyEntry * adjacency = dec->adjacencyEntries;
+    MATREC_index end = getNodeAdjacencyEnd(dec,articulationNode);
+    for (MATREC_index position = getFirstNodeAdjacency(dec,articulationNode); position < end; ++position) {
+        spqr_arc moveArc = adjacency[position].arc;
+        spqr_node otherNode = adjacency[position].node;
         assert(newRow->nodeColors[otherNode] != UNCOLORED);
         if((newRow->nodeColors[otherNode] == COLOR_SOURCE) != newRow->isArcCut[moveArc] ){
             if(numFirstSide == 0 && arcIsTree(dec,moveArc)){
@@ -5449,8 +7937,7 @@ static spqr_node checkNeighbourColoringArticulationNode(MATRECNetworkDecompositi
             }
             ++numSecondSide;
         }
-        moveArc = getNextNodeArc(dec,moveArc,articulationNode);
-    }while(moveArc != firstArc);
+    }
 
     if(numFirstSide == 1){
         *adjacentSplittingArc = firstSideArc;
@@ -5468,13 +7955,16 @@ static void rigidGetSplittableArticulationPointsOnPath(MATRECNetworkDecompositio
                                                        spqr_node firstNode, spqr_node secondNode){
     assert(newRow->reducedMembers[toCheck].numCutArcs > 1);
 
-    int totalNumNodes = getNumNodes(dec);
-    int * nodeNumPaths = newRow->crossingPathCount;
+    MATREC_index totalNumNodes = getNumNodes(dec);
+    MATREC_index * nodeNumPaths = newRow->crossingPathCount;
 
-    for (int i = 0; i < totalNumNodes; ++i) {
+    for (MATREC_index i = 0; i < totalNumNodes; ++i) {
         nodeNumPaths[i] = 0;
     }
 
+    //The searches below all run over the adjacency snapshot of the member
+    buildMemberAdjacency(dec,newRow->reducedMembers[toCheck].member);
+
     intersectionOfAllPaths(dec,newRow,toCheck,nodeNumPaths);
 
     newRow->numArticulationNodes = 0;
@@ -5482,15 +7972,15 @@ static void rigidGetSplittableArticulationPointsOnPath(MATRECNetworkDecompositio
     ArticulationNodeInformation * artNodeInfo = newRow->articulationNodeSearchInfo;
     //TODO: ugly; we clean up over all decomposition nodes for every component
     //clean up can not easily be done in the search, unfortunately
-    for (int i = 0; i < totalNumNodes; ++i) {
+    for (MATREC_index i = 0; i < totalNumNodes; ++i) {
         artNodeInfo[i].low = 0 ;
         artNodeInfo[i].discoveryTime = 0;
     }
 
     articulationPoints(dec,newRow,artNodeInfo,toCheck);
 
-    int numCutArcs = newRow->reducedMembers[toCheck].numCutArcs;
-    for (int i = 0; i < newRow->numArticulationNodes; i++) {
+    MATREC_index numCutArcs = newRow->reducedMembers[toCheck].numCutArcs;
+    for (MATREC_index i = 0; i < newRow->numArticulationNodes; i++) {
         spqr_node articulationNode = newRow->articulationNodes[i];
         assert(nodeIsRepresentative(dec, articulationNode));
         bool isOnPath = nodeNumPaths[articulationNode] == numCutArcs;
@@ -5515,7 +8005,7 @@ static void rigidGetSplittableArticulationPointsOnPath(MATRECNetworkDecompositio
             if(SPQRnodeIsValid(adjacentSplittingNode) && ((SPQRnodeIsInvalid(firstNode) && SPQRnodeIsInvalid(secondNode))
                || adjacentSplittingNode == firstNode || adjacentSplittingNode == secondNode)){
                 bool isArticulationNode = false;
-                for (int j = 0; j < newRow->numArticulationNodes; ++j) {
+                for (MATREC_index j = 0; j < newRow->numArticulationNodes; ++j) {
                     if (newRow->articulationNodes[j] == adjacentSplittingNode) {
                         isArticulationNode = true;
                         break;
@@ -5527,17 +8017,9 @@ static void rigidGetSplittableArticulationPointsOnPath(MATRECNetworkDecompositio
                     newRow->reducedMembers[toCheck].otherIsSource = newRow->nodeColors[adjacentSplittingNode] == COLOR_SOURCE;
 
                     //Cleaning up the colors
-                    {
-                        spqr_arc firstNodeArc = getFirstNodeArc(dec, articulationNode);
-                        spqr_arc itArc = firstNodeArc;
-                        do {
-                            spqr_node head = findArcHead(dec, itArc);
-                            spqr_node tail = findArcTail(dec, itArc);
-                            spqr_node otherNode = articulationNode == head ? tail : head;
-                            newRow->nodeColors[otherNode] = UNCOLORED;
-                            itArc = getNextNodeArc(dec, itArc, articulationNode);
-                        } while (itArc != firstNodeArc);
-
+                    MATREC_index end = getNodeAdjacencyEnd(dec,articulationNode);
+                    for (MATREC_index position = getFirstNodeAdjacency(dec,articulationNode); position < end; ++position) {
+                        newRow->nodeColors[dec->adjacencyEntries[position].node] = UNCOLORED;
                     }
                 }
             }
@@ -5558,7 +8040,7 @@ static void determineParallelType(MATRECNetworkDecomposition *dec, MATRECNetwork
 
     bool good = true;
     bool isReversed = true;
-    int countedCutArcs = 0;
+    MATREC_index countedCutArcs = 0;
     for (cut_arc_id cutArc = member->firstCutArc; cutArcIsValid(cutArc);
          cutArc = newRow->cutArcs[cutArc].nextMember){
         spqr_arc arc = newRow->cutArcs[cutArc].arc;
@@ -5681,7 +8163,7 @@ static RowReducedMemberType determineType(MATRECNetworkDecomposition *dec, MATRE
 }
 
 static void propagateComponents(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow){
-    int leafArrayIndex = 0;
+    MATREC_index leafArrayIndex = 0;
 
     reduced_member_id leaf;
     reduced_member_id next;
@@ -5714,7 +8196,7 @@ static void propagateComponents(MATRECNetworkDecomposition *dec, MATRECNetworkRo
 
     }
 
-    for (int j = 0; j < newRow->numReducedComponents; ++j) {
+    for (MATREC_index j = 0; j < newRow->numReducedComponents; ++j) {
         //The reduced root might be a leaf as well: we propagate it last
         reduced_member_id root = newRow->reducedComponents[j].root;
 
@@ -5811,7 +8293,7 @@ rigidDetermineCandidateNodesFromAdjacentComponents(MATRECNetworkDecomposition *d
 }
 
 static MATREC_ERROR allocateTreeSearchMemory(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow){
-    int necessarySpace = newRow->numReducedMembers;
+    MATREC_index necessarySpace = newRow->numReducedMembers;
     if( necessarySpace > newRow->memMergeTreeCallData ){
         newRow->memMergeTreeCallData = max(2*newRow->memMergeTreeCallData,necessarySpace);
         MATREC_CALL(MATRECreallocBlockArray(dec->env,&newRow->mergeTreeCallData,(size_t) newRow->memMergeTreeCallData));
@@ -5846,7 +8328,7 @@ static void determineSingleParallelType(MATRECNetworkDecomposition *dec, MATRECN
 
     bool good = true;
     bool isReversed = true;
-    int countedCutArcs = 0;
+    MATREC_index countedCutArcs = 0;
     for (cut_arc_id cutArc = redMember->firstCutArc; cutArcIsValid(cutArc);
          cutArc = newRow->cutArcs[cutArc].nextMember){
         spqr_arc arc = newRow->cutArcs[cutArc].arc;
@@ -5947,7 +8429,7 @@ static void determineSplitTypeFirstLeaf(MATRECNetworkDecomposition *dec, MATRECN
 
         bool good = true;
         bool isReversed = true;
-        int countedCutArcs = 0;
+        MATREC_index countedCutArcs = 0;
         for (cut_arc_id cutArc = redMember->firstCutArc; cutArcIsValid(cutArc);
              cutArc = newRow->cutArcs[cutArc].nextMember){
             spqr_arc arc = newRow->cutArcs[cutArc].arc;
@@ -6119,7 +8601,7 @@ static SplitOrientation getRelativeOrientation(MATRECNetworkDecomposition *dec,
 static void determineSplitTypeSeries(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow,
                                      reduced_member_id reducedId, spqr_arc marker,
                                      SplitOrientation previousOrientation){
-    int numAdjacentMembers = newRow->reducedMembers[reducedId].numChildren-newRow->reducedMembers[reducedId].numPropagatedChildren;
+    MATREC_index numAdjacentMembers = newRow->reducedMembers[reducedId].numChildren-newRow->reducedMembers[reducedId].numPropagatedChildren;
     if(reducedMemberIsValid(newRow->reducedMembers[reducedId].parent) &&
        newRow->reducedMembers[newRow->reducedMembers[reducedId].parent].type != TYPE_PROPAGATED){
         ++numAdjacentMembers;
@@ -6160,7 +8642,7 @@ static void determineSplitTypeParallel(MATRECNetworkDecomposition *dec, MATRECNe
 
     bool good = true;
     bool isReversed = true;
-    int countedCutArcs = 0;
+    MATREC_index countedCutArcs = 0;
     for (cut_arc_id cutArc = redMember->firstCutArc; cutArcIsValid(cutArc);
          cutArc = newRow->cutArcs[cutArc].nextMember){
         spqr_arc arc = newRow->cutArcs[cutArc].arc;
@@ -6326,7 +8808,7 @@ static void determineTypesChildrenNodes(MATRECNetworkDecomposition *dec, MATRECN
         return;
     }
     //merge all children
-    for (int i = 0; i < newRow->reducedMembers[node].numChildren; ++i) {
+    for (MATREC_index i = 0; i < newRow->reducedMembers[node].numChildren; ++i) {
         children_idx idx = newRow->reducedMembers[node].firstChild + i;
         reduced_member_id child = newRow->childrenStorage[idx];
         determineTypesChildrenNodes(dec,newRow,node,child,skipNode);
@@ -6362,7 +8844,7 @@ static void determineMergeableTypes(MATRECNetworkDecomposition *dec, MATRECNetwo
     //in members which have no cut arcs; otherwise, we might choose the wrong one
     reduced_member_id leaf = root;
     while(newRow->reducedMembers[leaf].numChildren != newRow->reducedMembers[leaf].numPropagatedChildren){
-        for(int i = 0; i < newRow->reducedMembers[leaf].numChildren;++i){
+        for(MATREC_index i = 0; i < newRow->reducedMembers[leaf].numChildren;++i){
             children_idx idx = newRow->reducedMembers[leaf].firstChild + i;
             reduced_member_id child = newRow->childrenStorage[idx];
             if(newRow->reducedMembers[child].type != TYPE_PROPAGATED){
@@ -6386,7 +8868,7 @@ static void determineMergeableTypes(MATRECNetworkDecomposition *dec, MATRECNetwo
             return;
         }
         //Add other nodes in the subtree
-        for (int i = 0; i < newRow->reducedMembers[nextNode].numChildren; ++i) {
+        for (MATREC_index i = 0; i < newRow->reducedMembers[nextNode].numChildren; ++i) {
             children_idx idx = newRow->reducedMembers[nextNode].firstChild + i;
             reduced_member_id child = newRow->childrenStorage[idx];
             determineTypesChildrenNodes(dec,newRow,nextNode,child,baseNode);
@@ -6404,12 +8886,12 @@ static void determineMergeableTypes(MATRECNetworkDecomposition *dec, MATRECNetwo
 static void cleanUpRowMemberInformation(MATRECNetworkRowAddition * newRow){
     //This loop is at the end as memberInformation is also used to assign the cut arcs during propagation
     //Clean up the memberInformation array
-    for (int i = 0; i < newRow->numReducedMembers; ++i) {
-        newRow->memberInformation[newRow->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
+        newRow->scratch->memberInformation[newRow->reducedMembers[i].member].reducedMember = INVALID_REDUCED_MEMBER;
     }
 #ifndef NDEBUG
-    for (int i = 0; i < newRow->memMemberInformation; ++i) {
-        assert(reducedMemberIsInvalid(newRow->memberInformation[i].reducedMember));
+    for (MATREC_index i = 0; i < newRow->scratch->memMemberInformation; ++i) {
+        assert(reducedMemberIsInvalid(newRow->scratch->memberInformation[i].reducedMember));
     }
 #endif
 }
@@ -6469,8 +8951,8 @@ static MATREC_ERROR rigidTransformArcIntoCycle(MATRECNetworkDecomposition *dec,
     }else{
         //create child marker
         MATREC_CALL(createChildMarker(dec,newCycle,adjacentMember,arcIsTree(dec,arc),&duplicate,true));
-        dec->members[adjacentMember].parentMember = newCycle;
-        dec->members[adjacentMember].markerOfParent = duplicate;
+        setMemberParent(dec,adjacentMember,newCycle);
+        MEMBER(dec, adjacentMember).markerOfParent = duplicate;
     }
         //Create the other marker edge
     spqr_arc cycleMarker = SPQR_INVALID_ARC;
@@ -6484,16 +8966,16 @@ static MATREC_ERROR rigidTransformArcIntoCycle(MATRECNetworkDecomposition *dec,
     //Change the existing edge to a marker
     if(isParent){
         assert(markerToParent(dec,member) == arc);
-        dec->arcs[markerOfParent(dec,member)].childMember = newCycle;
-        dec->members[member].parentMember = newCycle;
-        dec->members[member].markerToParent = arc;
-        dec->members[member].markerOfParent = cycleMarker;
-        dec->arcs[arc].element =  arcIsTree(dec,arc) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;;
-        dec->arcs[arc].childMember = SPQR_INVALID_MEMBER;
+        ARC(dec, markerOfParent(dec,member)).childMember = newCycle;
+        setMemberParent(dec,member,newCycle);
+        MEMBER(dec, member).markerToParent = arc;
+        MEMBER(dec, member).markerOfParent = cycleMarker;
+        ARC(dec, arc).element =  arcIsTree(dec,arc) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;;
+        ARC(dec, arc).childMember = SPQR_INVALID_MEMBER;
 
     }else{
-        dec->arcs[arc].element = arcIsTree(dec,arc) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
-        dec->arcs[arc].childMember = newCycle;
+        ARC(dec, arc).element = arcIsTree(dec,arc) ? MARKER_ROW_ELEMENT : MARKER_COLUMN_ELEMENT;
+        ARC(dec, arc).childMember = newCycle;
     }
     newRowInformation->member = newCycle;
     newRowInformation->reversed = !reverseArcDirection;
@@ -6617,8 +9099,8 @@ static MATREC_ERROR splitParallelRowAddition(MATRECNetworkDecomposition *dec, MA
                                            NewRowInformation * newRowInfo){
     assert(newRow->reducedMembers[reducedMember].numCutArcs > 0);
 
-    int numCutArcs = newRow->reducedMembers[reducedMember].numCutArcs;
-    int numParallelArcs = getNumMemberArcs(dec,member);
+    MATREC_index numCutArcs = newRow->reducedMembers[reducedMember].numCutArcs;
+    MATREC_index numParallelArcs = getNumMemberArcs(dec,member);
 
     //TODO: also account for different tree arc orientation; if treeArc is reversed, everything is wrong.
 
@@ -6866,15 +9348,15 @@ static MATREC_ERROR splitParallelMerging(MATRECNetworkDecomposition *dec, MATREC
     //When merging, we cannot have propagated members;
     assert(newRow->reducedMembers[reducedMember].numCutArcs < (getNumMemberArcs(dec,member)-1));
 
-    int numMergeableAdjacent = newRow->reducedMembers[reducedMember].numChildren - newRow->reducedMembers[reducedMember].numPropagatedChildren;
+    MATREC_index numMergeableAdjacent = newRow->reducedMembers[reducedMember].numChildren - newRow->reducedMembers[reducedMember].numPropagatedChildren;
     if(reducedMemberIsValid(newRow->reducedMembers[reducedMember].parent) &&
        newRow->reducedMembers[newRow->reducedMembers[reducedMember].parent].type == TYPE_MERGED){
         numMergeableAdjacent++;
     }
 
-    int numCutArcs = newRow->reducedMembers[reducedMember].numCutArcs;
+    MATREC_index numCutArcs = newRow->reducedMembers[reducedMember].numCutArcs;
     //All arcs which are not in the mergeable decomposition or cut
-    int numBaseSplitAwayArcs = getNumMemberArcs(dec,member) - numMergeableAdjacent - numCutArcs ;
+    MATREC_index numBaseSplitAwayArcs = getNumMemberArcs(dec,member) - numMergeableAdjacent - numCutArcs ;
 
     bool createCutParallel = numCutArcs > 1;
     bool keepOriginalParallel = numBaseSplitAwayArcs  <= 1;
@@ -7561,7 +10043,7 @@ static MATREC_ERROR mergeChildrenNodes(MATRECNetworkDecomposition *dec, MATRECNe
     MATREC_CALL(splitAndMerge(dec,newRow,node,true,newRowInformation));
 
     //merge all children
-    for (int i = 0; i < newRow->reducedMembers[node].numChildren; ++i) {
+    for (MATREC_index i = 0; i < newRow->reducedMembers[node].numChildren; ++i) {
         children_idx idx = newRow->reducedMembers[node].firstChild + i;
         reduced_member_id child = newRow->childrenStorage[idx];
         MATREC_CALL(mergeChildrenNodes(dec,newRow,child,skipNode,newRowInformation));
@@ -7576,7 +10058,7 @@ static MATREC_ERROR mergeTree(MATRECNetworkDecomposition *dec, MATRECNetworkRowA
     //in members which have no cut arcs; otherwise, we might choose the wrong one
     reduced_member_id leaf = root;
     while(newRow->reducedMembers[leaf].numChildren != newRow->reducedMembers[leaf].numPropagatedChildren){
-        for(int i = 0; i < newRow->reducedMembers[leaf].numChildren;++i){
+        for(MATREC_index i = 0; i < newRow->reducedMembers[leaf].numChildren;++i){
             children_idx idx = newRow->reducedMembers[leaf].firstChild + i;
             reduced_member_id child = newRow->childrenStorage[idx];
             if(newRow->reducedMembers[child].type != TYPE_PROPAGATED){
@@ -7595,7 +10077,7 @@ static MATREC_ERROR mergeTree(MATRECNetworkDecomposition *dec, MATRECNetworkRowA
         MATREC_CALL(splitAndMerge(dec,newRow,nextNode,false,newRowInformation));
 
         //Add other nodes in the subtree
-        for (int i = 0; i < newRow->reducedMembers[nextNode].numChildren; ++i) {
+        for (MATREC_index i = 0; i < newRow->reducedMembers[nextNode].numChildren; ++i) {
             children_idx idx = newRow->reducedMembers[nextNode].firstChild + i;
             reduced_member_id child = newRow->childrenStorage[idx];
             MATREC_CALL(mergeChildrenNodes(dec,newRow,child,baseNode,newRowInformation));
@@ -7656,13 +10138,7 @@ static MATREC_ERROR transformComponentRowAddition(MATRECNetworkDecomposition *de
 }
 
 
-MATREC_ERROR MATRECcreateNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition** pNewRow ){
-    assert(env);
-    MATREC_CALL(MATRECallocBlock(env,pNewRow));
-    MATRECNetworkRowAddition * newRow = *pNewRow;
-
-    newRow->remainsNetwork = true;
-
+static void initializeRowAdditionArrays(MATRECNetworkRowAddition *newRow){
     newRow->reducedMembers = NULL;
     newRow->memReducedMembers = 0;
     newRow->numReducedMembers = 0;
@@ -7671,10 +10147,6 @@ MATREC_ERROR MATRECcreateNetworkRowAddition(MATREC* env, MATRECNetworkRowAdditio
     newRow->memReducedComponents = 0;
     newRow->numReducedComponents = 0;
 
-    newRow->memberInformation = NULL;
-    newRow->memMemberInformation = 0;
-    newRow->numMemberInformation = 0;
-
     newRow->cutArcs = NULL;
     newRow->memCutArcs = 0;
     newRow->numCutArcs = 0;
@@ -7684,8 +10156,6 @@ MATREC_ERROR MATRECcreateNetworkRowAddition(MATREC* env, MATRECNetworkRowAdditio
     newRow->memChildrenStorage = 0;
     newRow->numChildrenStorage = 0;
 
-    newRow->newRowIndex = MATREC_INVALID_ROW;
-
     newRow->newColumnArcs = NULL;
     newRow->newColumnReversed = NULL;
     newRow->memColumnArcs = 0;
@@ -7727,9 +10197,6 @@ MATREC_ERROR MATRECcreateNetworkRowAddition(MATREC* env, MATRECNetworkRowAdditio
     newRow->artDFSData = NULL;
     newRow->memArtDFSData = 0;
 
-    newRow->createReducedMembersCallstack = NULL;
-    newRow->memCreateReducedMembersCallstack = 0;
-
     newRow->intersectionPathDepth = NULL;
     newRow->memIntersectionPathDepth = 0;
 
@@ -7738,17 +10205,11 @@ MATREC_ERROR MATRECcreateNetworkRowAddition(MATREC* env, MATRECNetworkRowAdditio
 
     newRow->mergeTreeCallData = NULL;
     newRow->memMergeTreeCallData = 0;
-
-    return MATREC_OKAY;
 }
 
-void MATRECfreeNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition ** pNewRow){
-    assert(*pNewRow);
-
-    MATRECNetworkRowAddition * newRow = *pNewRow;
+static void freeRowAdditionArrays(MATREC *env, MATRECNetworkRowAddition *newRow){
     //TODO: check if everything is truly freed in reverse order
 
-    MATRECfreeBlockArray(env,&newRow->createReducedMembersCallstack);
     MATRECfreeBlockArray(env,&newRow->artDFSData);
     MATRECfreeBlockArray(env,&newRow->colorDFSData);
     MATRECfreeBlockArray(env,&newRow->mergeTreeCallData);
@@ -7775,9 +10236,6 @@ void MATRECfreeNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition ** pNewR
     if(newRow->cutArcs){
         MATRECfreeBlockArray(env,&newRow->cutArcs);
     }
-    if(newRow->memberInformation){
-        MATRECfreeBlockArray(env,&newRow->memberInformation);
-    }
     if(newRow->reducedComponents){
         MATRECfreeBlockArray(env,&newRow->reducedComponents);
     }
@@ -7785,33 +10243,138 @@ void MATRECfreeNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition ** pNewR
         MATRECfreeBlockArray(env,&newRow->reducedMembers);
     }
     MATRECfreeBlockArray(env,&newRow->leafMembers);
+}
+
+MATREC_ERROR MATRECcreateNetworkRowAddition(MATREC *env, MATRECNetworkRowAddition **pNewRow) {
+    return MATRECcreateNetworkRowAdditionWithScratch(env, pNewRow, NULL);
+}
+
+MATREC_ERROR MATRECcreateNetworkRowAdditionWithScratch(MATREC *env, MATRECNetworkRowAddition **pNewRow, MATRECNetworkAdditionScratch *scratch) {
+    assert(env);
+    MATREC_CALL(MATRECallocBlock(env,pNewRow));
+    MATRECNetworkRowAddition * newRow = *pNewRow;
+
+    newRow->ownsScratch = scratch == NULL;
+    if(newRow->ownsScratch){
+        MATREC_CALL(MATRECcreateNetworkAdditionScratch(env, &scratch));
+    }
+    newRow->scratch = scratch;
+
+    newRow->remainsNetwork = true;
+    newRow->newRowIndex = MATREC_INVALID_ROW;
+    initializeRowAdditionArrays(newRow);
+
+    newRow->peakMemory = 0;
+    newRow->autoShrinkCalls = 0;
+    newRow->numUnderusedCalls = 0;
+    MATRECtraceIdInit(&newRow->traceId);
+    return MATREC_OKAY;
+}
+
+void MATRECfreeNetworkRowAddition(MATREC* env, MATRECNetworkRowAddition ** pNewRow){
+    assert(*pNewRow);
+
+    MATRECNetworkRowAddition * newRow = *pNewRow;
+    traceFreeAddition(env, &newRow->traceId);
+    freeRowAdditionArrays(env, newRow);
+    if(newRow->ownsScratch){
+        MATRECfreeNetworkAdditionScratch(env, &newRow->scratch);
+    }
     MATRECfreeBlock(env,pNewRow);
 }
 
-MATREC_ERROR MATRECNetworkRowAdditionCheck(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow,
-                                           const MATREC_row row, const MATREC_col * columns, const double * columnValues,
-                                           size_t numColumns){
-    assert(dec);
+void MATRECNetworkRowAdditionMemory(const MATRECNetworkRowAddition *newRow, MATRECMemoryReport *report){
     assert(newRow);
-    assert(numColumns == 0 || columns );
+    assert(report);
+    MATRECmemoryReportInit(report);
+    MATRECmemoryReportAddBytes(report, "rowAddition", sizeof(MATRECNetworkRowAddition),
+                               sizeof(MATRECNetworkRowAddition));
+    MATRECmemoryReportAdd(report, "reducedMembers", sizeof(MATRECRowReducedMember), newRow->memReducedMembers,
+                          newRow->numReducedMembers);
+    MATRECmemoryReportAdd(report, "reducedComponents", sizeof(MATRECRowReducedComponent),
+                          newRow->memReducedComponents, newRow->numReducedComponents);
+    MATRECmemoryReportAdd(report, "childrenStorage", sizeof(reduced_member_id), newRow->memChildrenStorage,
+                          newRow->numChildrenStorage);
+    MATRECmemoryReportAdd(report, "cutArcs", sizeof(CutArcListNode), newRow->memCutArcs, newRow->numCutArcs);
+    MATRECmemoryReportAdd(report, "newColumnArcs", sizeof(MATREC_col) + sizeof(bool), newRow->memColumnArcs,
+                          newRow->numColumnArcs);
+    MATRECmemoryReportAdd(report, "leafMembers", sizeof(reduced_member_id), newRow->memLeafMembers,
+                          newRow->numLeafMembers);
+    MATRECmemoryReportAdd(report, "decompositionColumnArcs", sizeof(spqr_arc) + sizeof(bool),
+                          newRow->memDecompositionColumnArcs, newRow->numDecompositionColumnArcs);
+    MATRECmemoryReportAdd(report, "isArcCut", 2 * sizeof(bool), newRow->memIsArcCut, newRow->numIsArcCut);
+    MATRECmemoryReportAdd(report, "articulationNodes", sizeof(spqr_node), newRow->memArticulationNodes,
+                          newRow->numArticulationNodes);
+    //Arrays indexed by the nodes of the decomposition are always fully in use, and call stacks are only in use
+    //within the Check functions
+    MATRECmemoryReportAdd(report, "nodeColors", sizeof(COLOR_STATUS), newRow->memNodeColors, newRow->memNodeColors);
+    MATRECmemoryReportAdd(report, "crossingPathCount", sizeof(MATREC_index), newRow->memCrossingPathCount,
+                          newRow->memCrossingPathCount);
+    MATRECmemoryReportAdd(report, "intersectionPathDepth", sizeof(MATREC_index), newRow->memIntersectionPathDepth,
+                          newRow->memIntersectionPathDepth);
+    MATRECmemoryReportAdd(report, "intersectionPathParent", sizeof(spqr_node), newRow->memIntersectionPathParent,
+                          newRow->memIntersectionPathParent);
+    MATRECmemoryReportAdd(report, "articulationNodeSearchInfo", sizeof(ArticulationNodeInformation),
+                          newRow->memNodeSearchInfo, 0);
+    MATRECmemoryReportAdd(report, "intersectionDFSData", sizeof(DFSCallData), newRow->memIntersectionDFSData, 0);
+    MATRECmemoryReportAdd(report, "colorDFSData", sizeof(ColorDFSCallData), newRow->memColorDFSData, 0);
+    MATRECmemoryReportAdd(report, "artDFSData", sizeof(ArticulationPointCallStack), newRow->memArtDFSData, 0);
+    MATRECmemoryReportAdd(report, "mergeTreeCallData", sizeof(MergeTreeCallData), newRow->memMergeTreeCallData, 0);
+    if(newRow->ownsScratch){
+        addScratchMemory(newRow->scratch, report);
+    }
+    MATRECmemoryReportFinish(report, newRow->peakMemory);
+}
+
+void MATRECNetworkRowAdditionShrink(MATREC *env, MATRECNetworkRowAddition *newRow){
+    assert(env);
+    assert(newRow);
+    MATRECMemoryReport report;
+    MATRECNetworkRowAdditionMemory(newRow, &report);
+    newRow->peakMemory = report.peakBytes;
+    freeRowAdditionArrays(env, newRow);
+    initializeRowAdditionArrays(newRow);
+    newRow->numUnderusedCalls = 0;
+    shrinkScratch(env, newRow->scratch);
+}
 
-    newRow->remainsNetwork = true;
-    cleanUpPreviousIteration(dec,newRow);
+void MATRECNetworkRowAdditionSetAutoShrink(MATRECNetworkRowAddition *newRow, size_t numCalls){
+    assert(newRow);
+    newRow->autoShrinkCalls = numCalls;
+    newRow->numUnderusedCalls = 0;
+}
+
+///Counts the consecutive checks on a decomposition with fewer than a quarter of the arcs that the arrays were grown
+///for, and shrinks the addition once there are enough of them
+static void autoShrinkRowAddition(const MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow){
+    if(4 * largestArcID(dec) >= newRow->memIsArcCut){
+        newRow->numUnderusedCalls = 0;
+        return;
+    }
+    ++newRow->numUnderusedCalls;
+    if(newRow->numUnderusedCalls >= newRow->autoShrinkCalls){
+        MATRECNetworkRowAdditionShrink(dec->env, newRow);
+    }
+}
 
-    MATREC_CALL(newRowUpdateRowInformation(dec,newRow,row,columns,columnValues,numColumns));
+static MATREC_ERROR checkRow(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow,
+                             const MATREC_row row, const MATREC_col * columns, const uint64_t * negativeBits,
+                             MATREC_matrix_size numColumns){
+    MATREC_CALL(newRowUpdateRowInformation(dec,newRow,row,columns,negativeBits,numColumns));
     MATREC_CALL(constructRowReducedDecomposition(dec,newRow));
     MATREC_CALL(createReducedDecompositionCutArcs(dec,newRow));
 
     MATREC_CALL(determineLeafReducedMembers(dec,newRow));
     MATREC_CALL(allocateRigidSearchMemory(dec,newRow));
     MATREC_CALL(allocateTreeSearchMemory(dec,newRow));
+    MATREC_CALL(reserveAdjacencySnapshots(dec));
     //Check for each component if the cut arcs propagate through a row tree marker to a cut arc in another component
     //From the leafs inward.
     propagateComponents(dec,newRow);
     //It can happen that we are not graphic by some of the checked components.
     //In that case, further checking may lead to errors as some invariants that the code assumes will be broken.
     if(newRow->remainsNetwork){
-        for (int i = 0; i < newRow->numReducedComponents; ++i) {
+        for (MATREC_index i = 0; i < newRow->numReducedComponents; ++i) {
             determineMergeableTypes(dec,newRow,newRow->reducedComponents[i].root);
             //exit early if one is not graphic
             if(!newRow->remainsNetwork){
@@ -7825,15 +10388,71 @@ MATREC_ERROR MATRECNetworkRowAdditionCheck(MATRECNetworkDecomposition * dec, MAT
     return MATREC_OKAY;
 }
 
-MATREC_ERROR MATRECNetworkRowAdditionAdd(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow){
+static MATREC_ERROR rowAdditionCheck(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow,
+                                     const MATREC_row row, const MATREC_col * columns, const NonzeroSigns * columnSigns,
+                                     MATREC_matrix_size numColumns){
+    assert(dec);
+    assert(newRow);
+    assert(numColumns == 0 || columns );
+
+    newRow->remainsNetwork = true;
+    cleanUpPreviousIteration(dec,newRow);
+    if(newRow->autoShrinkCalls > 0){
+        autoShrinkRowAddition(dec, newRow);
+    }
+
+    //Shrinking frees the scratch memory, so the signs are packed afterwards
+    const uint64_t * negativeBits;
+    MATREC_CALL(packNonzeroSigns(dec->env, newRow->scratch, columnSigns, numColumns, &negativeBits));
+    MATREC_CALL(checkRow(dec,newRow,row,columns,negativeBits,numColumns));
+    traceCheck(dec, MATREC_TRACE_ROW_CHECK, &newRow->traceId, row, columns, negativeBits, numColumns, newRow->remainsNetwork);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkRowAdditionCheck(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow,
+                                           const MATREC_row row, const MATREC_col * columns, const double * columnValues,
+                                           MATREC_matrix_size numColumns){
+    assert(numColumns == 0 || columnValues);
+    NonzeroSigns signs = {columnValues, NULL, NULL};
+    return rowAdditionCheck(dec,newRow,row,columns,&signs,numColumns);
+}
+
+MATREC_ERROR MATRECNetworkRowAdditionCheckSigns(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow,
+                                                const MATREC_row row, const MATREC_col * columns, const int8_t * columnSigns,
+                                                MATREC_matrix_size numColumns){
+    assert(numColumns == 0 || columnSigns);
+    NonzeroSigns signs = {NULL, columnSigns, NULL};
+    return rowAdditionCheck(dec,newRow,row,columns,&signs,numColumns);
+}
+
+MATREC_ERROR MATRECNetworkRowAdditionCheckPacked(MATRECNetworkDecomposition * dec, MATRECNetworkRowAddition * newRow,
+                                                 const MATREC_row row, const MATREC_col * columns, const uint64_t * negativeBits,
+                                                 MATREC_matrix_size numColumns){
+    assert(numColumns == 0 || negativeBits);
+    NonzeroSigns signs = {NULL, NULL, negativeBits};
+    return rowAdditionCheck(dec,newRow,row,columns,&signs,numColumns);
+}
+
+static MATREC_ERROR rowAdditionAdd(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow){
     assert(newRow->remainsNetwork);
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
+        invalidateMemberAdjacency(dec,newRow->reducedMembers[i].member);
+        recordMemberChanges(dec,newRow->reducedMembers[i].member);
+    }
+    MATREC_index numMembersBefore = dec->numMembers;
+    //The addition only changes the members below the parent of the reduced root, unless it joins trees
+    spqr_member unchangedParent = SPQR_INVALID_MEMBER;
+    spqr_member changedMember = SPQR_INVALID_MEMBER;
+    if(newRow->numReducedComponents == 1){
+        unchangedParent = findMemberParent(dec,newRow->reducedMembers[newRow->reducedComponents[0].root].member);
+    }
     if(newRow->numReducedComponents == 0){
-        spqr_member newMember = SPQR_INVALID_MEMBER;
         MATREC_CALL(createStandaloneParallel(dec,newRow->newColumnArcs, newRow->newColumnReversed,
-                                           newRow->numColumnArcs,newRow->newRowIndex,&newMember));
+                                           newRow->numColumnArcs,newRow->newRowIndex,&changedMember));
     }else if (newRow->numReducedComponents == 1){
         NewRowInformation information = emptyNewRowInformation();
         MATREC_CALL(transformComponentRowAddition(dec,newRow,&newRow->reducedComponents[0],&information));
+        changedMember = information.member;
 
         if(newRow->numColumnArcs == 0){
             spqr_arc rowArc = SPQR_INVALID_ARC;
@@ -7872,12 +10491,13 @@ MATREC_ERROR MATRECNetworkRowAdditionAdd(MATRECNetworkDecomposition *dec, MATREC
         }
     }else{
 #ifndef NDEBUG
-        int numDecComponentsBefore = numConnectedComponents(dec);
+        MATREC_index numDecComponentsBefore = numConnectedComponents(dec);
 #endif
         spqr_member new_row_parallel = SPQR_INVALID_MEMBER;
         MATREC_CALL(createConnectedParallel(dec,newRow->newColumnArcs,newRow->newColumnReversed,newRow->numColumnArcs,
                                           newRow->newRowIndex,&new_row_parallel));
-        for (int i = 0; i < newRow->numReducedComponents; ++i) {
+        changedMember = new_row_parallel;
+        for (MATREC_index i = 0; i < newRow->numReducedComponents; ++i) {
             NewRowInformation information = emptyNewRowInformation();
 
             MATREC_CALL(transformComponentRowAddition(dec,newRow,&newRow->reducedComponents[i],&information));
@@ -7887,7 +10507,7 @@ MATREC_ERROR MATRECNetworkRowAdditionAdd(MATRECNetworkDecomposition *dec, MATREC
                 assert(newRow->isArcCut[arc]);
                 moveArcToNewMember(dec, arc,information.member,new_row_parallel);
                 arcSetReversed(dec,arc,newRow->isArcCutReversed[arc]);
-                dec->members[information.member].type = SPQR_MEMBERTYPE_UNASSIGNED;
+                MEMBER(dec, information.member).type = SPQR_MEMBERTYPE_UNASSIGNED;
             }else{
                 reorderComponent(dec,information.member); //Make sure the new component is the root of the local decomposition tree
                 spqr_arc markerArc = SPQR_INVALID_ARC;
@@ -7908,9 +10528,450 @@ MATREC_ERROR MATRECNetworkRowAdditionAdd(MATRECNetworkDecomposition *dec, MATREC
         decreaseNumConnectedComponents(dec,newRow->numReducedComponents-1);
         assert(numConnectedComponents(dec) == (numDecComponentsBefore - newRow->numReducedComponents + 1));
     }
+    //The new row extends the fundamental cycles of the existing columns it has nonzeros in
+    if(newRow->numReducedComponents > 0){
+        MATRECcolumnTableClear(&dec->columns);
+    }
+    repairMemberAncestorIndex(dec,unchangedParent,changedMember);
+    for (MATREC_index i = 0; i < newRow->numReducedMembers; ++i) {
+        recordMemberChanges(dec,newRow->reducedMembers[i].member);
+    }
+    for (spqr_member member = numMembersBefore; member < dec->numMembers; ++member) {
+        recordMemberChanges(dec,member);
+    }
+    autoFlatten(dec);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECNetworkRowAdditionAdd(MATRECNetworkDecomposition *dec, MATRECNetworkRowAddition *newRow){
+    MATREC_CALL(rowAdditionAdd(dec,newRow));
+    traceAdd(dec, MATREC_TRACE_ROW_ADD, &newRow->traceId);
+    if(readersEnabled(dec)){
+        MATREC_CALL(publishReplica(dec));
+    }
     return MATREC_OKAY;
 }
 
 bool MATRECNetworkRowAdditionRemainsNetwork(const MATRECNetworkRowAddition *newRow){
     return newRow->remainsNetwork;
 }
+
+typedef struct BatchWorkerImpl BatchWorker;
+
+///The matrices of a batch recognition. Either matrices is set, or matrix and subMatrices are
+typedef struct {
+    const MATRECCSMatrixInt * const *matrices;
+    const MATRECCSMatrixInt *matrix;
+    const MATRECSubMatrix * const *subMatrices;
+    MATREC_matrix_size numMatrices;
+    uint64_t *isNetwork;
+
+    BatchWorker *workers;
+    MATREC_index numWorkers;
+} Batch;
+
+///A thread of a batch recognition, with the decomposition and row addition that it reuses for all of its matrices
+struct BatchWorkerImpl {
+    Batch *batch;
+    MATREC_index index;
+
+    //The words of the result which the worker still has to compute. A word holds the results of 64 matrices and is the
+    //unit of work, so that each word is written by a single thread
+    size_t firstWord;
+    size_t endWord;
+    pthread_mutex_t lock;
+
+    MATRECNetworkDecomposition *dec;
+    MATRECNetworkRowAddition *newRow;
+    MATREC_col *columns;
+    int8_t *signs;
+    MATREC_matrix_size memNonzeros;
+    MATREC_index *localColumn; ///For submatrices, the index of each column of the matrix in the current submatrix
+    MATREC_ERROR error;
+};
+
+///Recognizes a matrix by adding its rows one by one. Row i of the matrix is given by row rows[i] of rowMatrix, or by
+///row i if rows is NULL. If the worker maps columns to a submatrix, entries in other columns are skipped
+static MATREC_ERROR batchRecognizeMatrix(BatchWorker *worker, const MATRECCSMatrixInt *rowMatrix,
+                                         const MATREC_row *rows, MATREC_matrix_size numRows, bool *isNetwork){
+    MATRECNetworkDecompositionReset(worker->dec);
+    *isNetwork = true;
+    for (MATREC_matrix_size i = 0; i < numRows; ++i) {
+        MATREC_row row = rows ? rows[i] : i;
+        MATREC_matrix_size first = rowMatrix->firstRowIndex[row];
+        MATREC_matrix_size end = rowMatrix->firstRowIndex[row + 1];
+        if(end - first > worker->memNonzeros){
+            worker->memNonzeros = 2 * worker->memNonzeros > end - first ? 2 * worker->memNonzeros : end - first;
+            MATREC_CALL(MATRECreallocBlockArray(worker->dec->env, &worker->columns, (size_t) worker->memNonzeros));
+            MATREC_CALL(MATRECreallocBlockArray(worker->dec->env, &worker->signs, (size_t) worker->memNonzeros));
+        }
+        MATREC_matrix_size numNonzeros = 0;
+        for (MATREC_matrix_size entry = first; entry < end; ++entry) {
+            MATREC_col column = rowMatrix->entryColumns[entry];
+            if(worker->localColumn){
+                if(worker->localColumn[column] < 0){
+                    continue;
+                }
+                column = (MATREC_col) worker->localColumn[column];
+            }
+            int value = rowMatrix->entryValues[entry];
+            if(value != 1 && value != -1){
+                *isNetwork = false;
+                return MATREC_OKAY;
+            }
+            worker->columns[numNonzeros] = column;
+            worker->signs[numNonzeros] = (int8_t) value;
+            ++numNonzeros;
+        }
+        //A row without nonzeros does not change whether the matrix is network
+        if(numNonzeros == 0){
+            continue;
+        }
+        MATREC_CALL(MATRECNetworkRowAdditionCheckSigns(worker->dec, worker->newRow, i, worker->columns, worker->signs,
+                                                       numNonzeros));
+        if(!MATRECNetworkRowAdditionRemainsNetwork(worker->newRow)){
+            *isNetwork = false;
+            return MATREC_OKAY;
+        }
+        MATREC_CALL(MATRECNetworkRowAdditionAdd(worker->dec, worker->newRow));
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR batchRecognizeWord(BatchWorker *worker, size_t word){
+    Batch *batch = worker->batch;
+    MATREC_matrix_size first = (MATREC_matrix_size) word * 64;
+    MATREC_matrix_size end = batch->numMatrices - first < 64 ? batch->numMatrices : first + 64;
+    uint64_t bits = 0;
+    for (MATREC_matrix_size i = first; i < end; ++i) {
+        bool isNetwork = false;
+        if(batch->matrices){
+            const MATRECCSMatrixInt *matrix = batch->matrices[i];
+            MATREC_CALL(batchRecognizeMatrix(worker, matrix, NULL, matrix->numRows, &isNetwork));
+        }else{
+            const MATRECSubMatrix *subMatrix = batch->subMatrices[i];
+            for (MATREC_matrix_size j = 0; j < subMatrix->numColumns; ++j) {
+                worker->localColumn[subMatrix->columns[j]] = (MATREC_index) j;
+            }
+            MATREC_ERROR error = batchRecognizeMatrix(worker, batch->matrix, subMatrix->rows, subMatrix->numRows,
+                                                      &isNetwork);
+            for (MATREC_matrix_size j = 0; j < subMatrix->numColumns; ++j) {
+                worker->localColumn[subMatrix->columns[j]] = -1;
+            }
+            MATREC_CALL(error);
+        }
+        if(isNetwork){
+            bits |= (uint64_t) 1 << (i - first);
+        }
+    }
+    batch->isNetwork[word] = bits;
+    return MATREC_OKAY;
+}
+
+///Takes the next word of the worker, or steals the back half of the remaining words of another worker
+static bool batchNextWord(BatchWorker *worker, size_t *word){
+    pthread_mutex_lock(&worker->lock);
+    if(worker->firstWord < worker->endWord){
+        *word = worker->firstWord;
+        ++worker->firstWord;
+        pthread_mutex_unlock(&worker->lock);
+        return true;
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    Batch *batch = worker->batch;
+    for (MATREC_index i = 1; i < batch->numWorkers; ++i) {
+        BatchWorker *victim = &batch->workers[(worker->index + i) % batch->numWorkers];
+        pthread_mutex_lock(&victim->lock);
+        size_t numRemaining = victim->endWord - victim->firstWord;
+        if(numRemaining == 0){
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        size_t stolenEnd = victim->endWord;
+        size_t stolenFirst = stolenEnd - (numRemaining + 1) / 2;
+        victim->endWord = stolenFirst;
+        pthread_mutex_unlock(&victim->lock);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->firstWord = stolenFirst + 1;
+        worker->endWord = stolenEnd;
+        pthread_mutex_unlock(&worker->lock);
+        *word = stolenFirst;
+        return true;
+    }
+    return false;
+}
+
+static void * batchWorkerRun(void *data){
+    BatchWorker *worker = (BatchWorker *) data;
+    size_t word = 0;
+    while(worker->error == MATREC_OKAY && batchNextWord(worker, &word)){
+        worker->error = batchRecognizeWord(worker, word);
+    }
+    return NULL;
+}
+
+static MATREC_ERROR createBatchWorker(MATREC *env, Batch *batch, BatchWorker *worker){
+    MATREC_CALL(MATRECNetworkDecompositionCreate(env, &worker->dec, 0, 0));
+    MATREC_CALL(MATRECcreateNetworkRowAddition(env, &worker->newRow));
+    if(batch->subMatrices){
+        size_t numColumns = batch->matrix->numColumns > 0 ? (size_t) batch->matrix->numColumns : 1;
+        MATREC_CALL(MATRECallocBlockArray(env, &worker->localColumn, numColumns));
+        for (size_t i = 0; i < numColumns; ++i) {
+            worker->localColumn[i] = -1;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+static void freeBatchWorker(MATREC *env, BatchWorker *worker){
+    MATRECfreeBlockArray(env, &worker->localColumn);
+    MATRECfreeBlockArray(env, &worker->signs);
+    MATRECfreeBlockArray(env, &worker->columns);
+    if(worker->newRow){
+        MATRECfreeNetworkRowAddition(env, &worker->newRow);
+    }
+    if(worker->dec){
+        MATRECNetworkDecompositionFree(&worker->dec);
+    }
+}
+
+static MATREC_ERROR recognizeBatch(MATREC *env, Batch *batch, MATREC_index numThreads){
+    assert(numThreads > 0);
+    size_t numWords = MATREC_SIGN_WORDS(batch->numMatrices);
+    if(numWords == 0){
+        return MATREC_OKAY;
+    }
+    batch->numWorkers = (size_t) numThreads < numWords ? numThreads : (MATREC_index) numWords;
+    MATREC_CALL(MATRECallocBlockArray(env, &batch->workers, (size_t) batch->numWorkers));
+
+    MATREC_ERROR error = MATREC_OKAY;
+    MATREC_index numCreated = 0;
+    for (; numCreated < batch->numWorkers && error == MATREC_OKAY; ++numCreated) {
+        BatchWorker *worker = &batch->workers[numCreated];
+        worker->batch = batch;
+        worker->index = numCreated;
+        worker->firstWord = numWords * (size_t) numCreated / (size_t) batch->numWorkers;
+        worker->endWord = numWords * (size_t) (numCreated + 1) / (size_t) batch->numWorkers;
+        worker->dec = NULL;
+        worker->newRow = NULL;
+        worker->columns = NULL;
+        worker->signs = NULL;
+        worker->memNonzeros = 0;
+        worker->localColumn = NULL;
+        worker->error = MATREC_OKAY;
+        pthread_mutex_init(&worker->lock, NULL);
+        error = createBatchWorker(env, batch, worker);
+    }
+
+    if(error == MATREC_OKAY){
+        //The calling thread is the first worker. If a thread can not be started, its words are stolen by the others
+        pthread_t *threads = NULL;
+        MATREC_index numStarted = 0;
+        if(batch->numWorkers > 1){
+            error = MATRECallocBlockArray(env, &threads, (size_t) (batch->numWorkers - 1));
+        }
+        for (; error == MATREC_OKAY && numStarted < batch->numWorkers - 1; ++numStarted) {
+            if(pthread_create(&threads[numStarted], NULL, batchWorkerRun, &batch->workers[numStarted + 1]) != 0){
+                break;
+            }
+        }
+        if(error == MATREC_OKAY){
+            batchWorkerRun(&batch->workers[0]);
+        }
+        for (MATREC_index i = 0; i < numStarted; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        MATRECfreeBlockArray(env, &threads);
+        for (MATREC_index i = 0; i < batch->numWorkers && error == MATREC_OKAY; ++i) {
+            error = batch->workers[i].error;
+        }
+    }
+
+    for (MATREC_index i = 0; i < numCreated; ++i) {
+        freeBatchWorker(env, &batch->workers[i]);
+        pthread_mutex_destroy(&batch->workers[i].lock);
+    }
+    MATRECfreeBlockArray(env, &batch->workers);
+    return error;
+}
+
+MATREC_ERROR MATRECNetworkRecognizeMatrices(MATREC *env, const MATRECCSMatrixInt * const *matrices,
+                                            MATREC_matrix_size numMatrices, MATREC_index numThreads,
+                                            uint64_t *isNetwork){
+    assert(env);
+    assert(matrices || numMatrices == 0);
+    assert(isNetwork || numMatrices == 0);
+    Batch batch;
+    batch.matrices = matrices;
+    batch.matrix = NULL;
+    batch.subMatrices = NULL;
+    batch.numMatrices = numMatrices;
+    batch.isNetwork = isNetwork;
+    batch.workers = NULL;
+    batch.numWorkers = 0;
+    return recognizeBatch(env, &batch, numThreads);
+}
+
+MATREC_ERROR MATRECNetworkRecognizeSubMatrices(MATREC *env, const MATRECCSMatrixInt *matrix,
+                                               const MATRECSubMatrix * const *subMatrices,
+                                               MATREC_matrix_size numSubMatrices, MATREC_index numThreads,
+                                               uint64_t *isNetwork){
+    assert(env);
+    assert(matrix);
+    assert(subMatrices || numSubMatrices == 0);
+    assert(isNetwork || numSubMatrices == 0);
+    Batch batch;
+    batch.matrices = NULL;
+    batch.matrix = matrix;
+    batch.subMatrices = subMatrices;
+    batch.numMatrices = numSubMatrices;
+    batch.isNetwork = isNetwork;
+    batch.workers = NULL;
+    batch.numWorkers = 0;
+    return recognizeBatch(env, &batch, numThreads);
+}
+
+MATREC_ERROR MATRECNetworkRecognizeSubMatrix(MATREC *env, const MATRECCompressedSparseMatrixPairInt *matrix,
+                                             const MATRECSubMatrix *subMatrix, bool *isNetwork){
+    assert(env);
+    assert(matrix);
+    assert(subMatrix);
+    assert(isNetwork);
+    const MATRECCSMatrixInt *colMat = matrix->colMat;
+
+    //Membership bitmap of the rows of the submatrix, which filters the nonzeros of the columns
+    size_t numWords = MATREC_SIGN_WORDS(colMat->numColumns) > 0 ? MATREC_SIGN_WORDS(colMat->numColumns) : 1;
+    uint64_t *rowBits = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env, &rowBits, numWords));
+    for (size_t i = 0; i < numWords; ++i) {
+        rowBits[i] = 0;
+    }
+    for (MATREC_matrix_size i = 0; i < subMatrix->numRows; ++i) {
+        assert(subMatrix->rows[i] < colMat->numColumns);
+        rowBits[subMatrix->rows[i] / 64] |= (uint64_t) 1 << (subMatrix->rows[i] % 64);
+    }
+    MATREC_matrix_size memNonzeros = 0;
+    for (MATREC_matrix_size i = 0; i < subMatrix->numColumns; ++i) {
+        MATREC_col column = subMatrix->columns[i];
+        MATREC_matrix_size numColumnNonzeros = colMat->firstRowIndex[column + 1] - colMat->firstRowIndex[column];
+        memNonzeros = numColumnNonzeros > memNonzeros ? numColumnNonzeros : memNonzeros;
+    }
+
+    //The decomposition uses the indices of the matrix, so hashed storage keeps it proportional to the submatrix
+    MATRECNetworkDecomposition *dec = NULL;
+    MATRECNetworkColumnAddition *newCol = NULL;
+    MATREC_row *rows = NULL;
+    int8_t *signs = NULL;
+    MATREC_ERROR error = MATRECNetworkDecompositionCreateWithStorage(env, &dec, subMatrix->numRows,
+                                                                     subMatrix->numColumns, MATREC_IDS_HASHED,
+                                                                     MATREC_IDS_HASHED);
+    if(error == MATREC_OKAY){
+        error = MATRECcreateNetworkColumnAddition(env, &newCol);
+    }
+    if(error == MATREC_OKAY){
+        error = MATRECallocBlockArray(env, &rows, (size_t) (memNonzeros > 0 ? memNonzeros : 1));
+    }
+    if(error == MATREC_OKAY){
+        error = MATRECallocBlockArray(env, &signs, (size_t) (memNonzeros > 0 ? memNonzeros : 1));
+    }
+
+    *isNetwork = true;
+    for (MATREC_matrix_size i = 0; i < subMatrix->numColumns && error == MATREC_OKAY && *isNetwork; ++i) {
+        MATREC_col column = subMatrix->columns[i];
+        MATREC_matrix_size numNonzeros = 0;
+        for (MATREC_matrix_size entry = colMat->firstRowIndex[column]; entry < colMat->firstRowIndex[column + 1];
+             ++entry) {
+            MATREC_row row = colMat->entryColumns[entry];
+            if(!((rowBits[row / 64] >> (row % 64)) & 1)){
+                continue;
+            }
+            int value = colMat->entryValues[entry];
+            if(value != 1 && value != -1){
+                *isNetwork = false;
+                break;
+            }
+            rows[numNonzeros] = row;
+            signs[numNonzeros] = (int8_t) value;
+            ++numNonzeros;
+        }
+        //A column without nonzeros does not change whether the submatrix is network
+        if(!*isNetwork || numNonzeros == 0){
+            continue;
+        }
+        error = MATRECNetworkColumnAdditionCheckSigns(dec, newCol, column, rows, signs, numNonzeros);
+        if(error != MATREC_OKAY){
+            break;
+        }
+        if(!MATRECNetworkColumnAdditionRemainsNetwork(newCol)){
+            *isNetwork = false;
+            break;
+        }
+        error = MATRECNetworkColumnAdditionAdd(dec, newCol);
+    }
+
+    MATRECfreeBlockArray(env, &signs);
+    MATRECfreeBlockArray(env, &rows);
+    if(newCol){
+        MATRECfreeNetworkColumnAddition(env, &newCol);
+    }
+    if(dec){
+        MATRECNetworkDecompositionFree(&dec);
+    }
+    MATRECfreeBlockArray(env, &rowBits);
+    return error;
+}
+
+static spqr_arc getElementArc(const MATRECNetworkDecomposition *dec, MATRECElement element){
+    return element.isRow ? getDecompositionRowArc(dec, element.index) : getDecompositionColumnArc(dec, element.index);
+}
+
+///The lookups of the queries below only write to the decomposition to compress paths, which does not change what it
+///represents, and which is skipped if the decomposition is read-only, such as a replica
+static MATRECNetworkDecomposition * queryDecomposition(const MATRECNetworkDecomposition *dec){
+    return (MATRECNetworkDecomposition *) dec;
+}
+
+MATRECMemberType MATRECNetworkDecompositionMemberType(const MATRECNetworkDecomposition *dec, MATRECElement element){
+    assert(dec);
+    spqr_arc arc = getElementArc(dec, element);
+    if(SPQRarcIsInvalid(arc)){
+        return MATREC_MEMBER_NOT_CONTAINED;
+    }
+    return (MATRECMemberType) getMemberType(dec, findArcMember(queryDecomposition(dec), arc));
+}
+
+bool MATRECNetworkDecompositionSameComponent(const MATRECNetworkDecomposition *dec, MATRECElement first,
+                                             MATRECElement second){
+    assert(dec);
+    spqr_arc firstArc = getElementArc(dec, first);
+    spqr_arc secondArc = getElementArc(dec, second);
+    if(SPQRarcIsInvalid(firstArc) || SPQRarcIsInvalid(secondArc)){
+        return false;
+    }
+    MATRECNetworkDecomposition *lookup = queryDecomposition(dec);
+    return findMemberComponent(lookup, findArcMember(lookup, firstArc)) ==
+           findMemberComponent(lookup, findArcMember(lookup, secondArc));
+}
+
+bool MATRECNetworkDecompositionRelativeOrientation(const MATRECNetworkDecomposition *dec, MATRECElement first,
+                                                   MATRECElement second, bool *reversed){
+    assert(dec);
+    assert(reversed);
+    spqr_arc firstArc = getElementArc(dec, first);
+    spqr_arc secondArc = getElementArc(dec, second);
+    if(SPQRarcIsInvalid(firstArc) || SPQRarcIsInvalid(secondArc)){
+        return false;
+    }
+    MATRECNetworkDecomposition *lookup = queryDecomposition(dec);
+    spqr_member member = findArcMember(lookup, firstArc);
+    if(member != findArcMember(lookup, secondArc) || getMemberType(dec, member) != SPQR_MEMBERTYPE_RIGID){
+        return false;
+    }
+    ArcSign firstSign = findArcSign(lookup, firstArc);
+    ArcSign secondSign = findArcSign(lookup, secondArc);
+    assert(firstSign.representative == secondSign.representative);
+    *reversed = firstSign.reversed != secondSign.reversed;
+    return true;
+}
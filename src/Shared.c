@@ -1,9 +1,7 @@
 #include "matrec/Shared.h"
+#include "matrec/Trace.h"
 
-#ifndef NDEBUG
-//Only necessary for overflow check assertions
-#include <limits.h>
-#endif
+#include <stdint.h>
 
 MATREC_ERROR MATRECcreateEnvironment(MATREC** pSpqr){
     *pSpqr = (MATREC*) malloc(sizeof(MATREC));
@@ -12,6 +10,10 @@ MATREC_ERROR MATRECcreateEnvironment(MATREC** pSpqr){
         return MATREC_ERROR_MEMORY;
     }
     env->output = stdout;
+    env->trace = NULL;
+    env->memoryInUse = 0;
+    env->memoryPeak = 0;
+    env->memoryLimit = 0;
     return MATREC_OKAY;
 }
 MATREC_ERROR MATRECfreeEnvironment(MATREC** pSpqr){
@@ -22,54 +24,145 @@ MATREC_ERROR MATRECfreeEnvironment(MATREC** pSpqr){
     if(!env){
         return MATREC_ERROR_MEMORY;
     }
+    MATREC_ERROR error = MATREC_OKAY;
+    if(env->trace){
+        error = MATRECtraceStop(env);
+    }
 
     free(*pSpqr);
     *pSpqr = NULL;
-    return MATREC_OKAY;
+    return error;
 }
 
 
-//TODO: implement other malloc-type functions such as reallocarray and calloc throughout the codebase?
+size_t MATRECmemoryInUse(const MATREC * env){
+    assert(env);
+    return __atomic_load_n(&env->memoryInUse, __ATOMIC_RELAXED);
+}
+
+size_t MATRECmemoryPeak(const MATREC * env){
+    assert(env);
+    return __atomic_load_n(&env->memoryPeak, __ATOMIC_RELAXED);
+}
 
-MATREC_ERROR MATRECimplAllocBlockArray(__attribute__((unused)) MATREC * env, void** ptr, size_t size, size_t length){
+void MATRECsetMemoryLimit(MATREC * env, size_t limit){
+    assert(env);
+    __atomic_store_n(&env->memoryLimit, limit, __ATOMIC_RELAXED);
+}
+
+///Every allocation starts with a header which stores its size, so that the memory in use can be updated when it is
+///freed. The union makes sure that the memory after the header is aligned for any type.
+typedef union{
+    size_t size;
+    long double alignLongDouble;
+    void * alignPointer;
+    uint64_t alignInteger;
+} MATRECAllocationHeader;
+
+///Adds the bytes to the memory in use of the environment. Returns false if this exceeds the memory limit
+static bool reserveMemory(MATREC * env, size_t bytes){
+    size_t inUse = __atomic_add_fetch(&env->memoryInUse, bytes, __ATOMIC_RELAXED);
+    size_t limit = __atomic_load_n(&env->memoryLimit, __ATOMIC_RELAXED);
+    if(limit != 0 && inUse > limit){
+        __atomic_sub_fetch(&env->memoryInUse, bytes, __ATOMIC_RELAXED);
+        return false;
+    }
+    size_t peak = __atomic_load_n(&env->memoryPeak, __ATOMIC_RELAXED);
+    while(inUse > peak &&
+          !__atomic_compare_exchange_n(&env->memoryPeak, &peak, inUse, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+    }
+    return true;
+}
+
+static void releaseMemory(MATREC * env, size_t bytes){
+    __atomic_sub_fetch(&env->memoryInUse, bytes, __ATOMIC_RELAXED);
+}
+
+static void * allocate(MATREC * env, size_t bytes){
+    if(bytes > SIZE_MAX - sizeof(MATRECAllocationHeader) || !reserveMemory(env, bytes)){
+        return NULL;
+    }
+    MATRECAllocationHeader * header = malloc(sizeof(MATRECAllocationHeader) + bytes);
+    if(!header){
+        releaseMemory(env, bytes);
+        return NULL;
+    }
+    header->size = bytes;
+    return header + 1;
+}
+
+static void deallocate(MATREC * env, void * ptr){
+    if(ptr){
+        MATRECAllocationHeader * header = ((MATRECAllocationHeader *) ptr) - 1;
+        releaseMemory(env, header->size);
+        free(header);
+    }
+}
+
+MATREC_ERROR MATRECimplAllocBlockArray(MATREC * env, void** ptr, size_t size, size_t length){
     assert(env);
     assert(ptr);
     //assert(*ptr == NULL); //TODO: why is this check here, is it necessary?
-    assert(!(size > 0 && length > UINT_MAX / size)); //overflow check
+    if(size > 0 && length > SIZE_MAX / size){
+        *ptr = NULL;
+        return MATREC_ERROR_MEMORY;
+    }
 
-    *ptr = malloc(size * length); //TODO check for overflows, possibly use realloc here?
+    *ptr = allocate(env, size * length);
 
     return *ptr ? MATREC_OKAY : MATREC_ERROR_MEMORY;
 }
-MATREC_ERROR MATRECimplReallocBlockArray(__attribute__((unused)) MATREC* env, void** ptr, size_t size, size_t length)
+MATREC_ERROR MATRECimplReallocBlockArray(MATREC* env, void** ptr, size_t size, size_t length)
 {
     assert(env);
     assert(ptr);
-    assert(!(size > 0 && length > UINT_MAX / size)); //overflow check
-    *ptr = realloc(*ptr, size * length);
-    //*ptr = reallocarray(*ptr,length,size); //reallocarray can also work and is a bit safer, but is non-standard...
-    return *ptr ? MATREC_OKAY : MATREC_ERROR_MEMORY;
+    //On failure, the old array is kept, so that it can still be freed
+    if(size > 0 && length > SIZE_MAX / size){
+        return MATREC_ERROR_MEMORY;
+    }
+    size_t bytes = size * length;
+    if(!*ptr){
+        *ptr = allocate(env, bytes);
+        return *ptr ? MATREC_OKAY : MATREC_ERROR_MEMORY;
+    }
+    MATRECAllocationHeader * header = ((MATRECAllocationHeader *) *ptr) - 1;
+    size_t oldBytes = header->size;
+    if(bytes > SIZE_MAX - sizeof(MATRECAllocationHeader) || (bytes > oldBytes && !reserveMemory(env, bytes - oldBytes))){
+        return MATREC_ERROR_MEMORY;
+    }
+    MATRECAllocationHeader * newHeader = realloc(header, sizeof(MATRECAllocationHeader) + bytes);
+    if(!newHeader){
+        if(bytes > oldBytes){
+            releaseMemory(env, bytes - oldBytes);
+        }
+        return MATREC_ERROR_MEMORY;
+    }
+    if(bytes < oldBytes){
+        releaseMemory(env, oldBytes - bytes);
+    }
+    newHeader->size = bytes;
+    *ptr = newHeader + 1;
+    return MATREC_OKAY;
 }
-void MATRECimplFreeBlockArray(__attribute__((unused)) MATREC* env, void ** ptr){
+void MATRECimplFreeBlockArray(MATREC* env, void ** ptr){
     assert(env);
     assert(ptr);
-    free(*ptr);
+    deallocate(env, *ptr);
     *ptr = NULL;
 }
 
-MATREC_ERROR MATRECimplAllocBlock(__attribute__((unused)) MATREC * env, void **ptr, size_t size){
+MATREC_ERROR MATRECimplAllocBlock(MATREC * env, void **ptr, size_t size){
     assert(env);
     assert(ptr);
-    *ptr = malloc(size);
+    *ptr = allocate(env, size);
 
     return *ptr ? MATREC_OKAY : MATREC_ERROR_MEMORY;
 }
 
-void MATRECimplFreeBlock(__attribute__((unused)) MATREC * env, void **ptr){
+void MATRECimplFreeBlock(MATREC * env, void **ptr){
     assert(env);
     assert(ptr);
     assert(*ptr);
-    free(*ptr);
+    deallocate(env, *ptr);
     *ptr = NULL;
 }
-
@@ -1,6 +1,6 @@
 #include "matrec/SignCheckRowAddition.h"
 typedef struct {
-    size_t predecessorNode;
+    MATREC_matrix_size predecessorNode;
     int predecessorValue;
     int targetValue;
     char status;
@@ -9,7 +9,7 @@ typedef struct {
 struct MATRECSignCheckRowAdditionImpl{
     MATRECCompressedSparseMatrixPairInt * matrix;
     ScaGraphNode * graphNodes;
-    size_t * bfsCallStack;
+    MATREC_matrix_size * bfsCallStack;
     bool * isRowAdded;
 };
 
@@ -25,7 +25,7 @@ MATREC_ERROR MATRECcreateSignCheckRowAddition(MATREC * env, MATRECSignCheckRowAd
     MATREC_CALL(MATRECallocBlockArray(env,&sca->graphNodes, matrix->rowMat->numRows + matrix->rowMat->numColumns));
     MATREC_CALL(MATRECallocBlockArray(env,&sca->bfsCallStack, matrix->rowMat->numRows + matrix->rowMat->numColumns));
     MATREC_CALL(MATRECallocBlockArray(env,&sca->isRowAdded,matrix->rowMat->numRows));
-    for (size_t i = 0; i < matrix->rowMat->numRows; ++i) {
+    for (MATREC_matrix_size i = 0; i < matrix->rowMat->numRows; ++i) {
         sca->isRowAdded[i] = false;
     }
     return MATREC_OKAY;
@@ -43,45 +43,45 @@ bool MATRECcheckSigningNewRow(MATRECSignCheckRowAddition * sca, MATREC_row row){
     MATRECCSMatrixInt * rowMat = sca->matrix->rowMat;
     MATRECCSMatrixInt * colMat = sca->matrix->colMat;
 
-    size_t first = rowMat->firstRowIndex[row];
-    size_t beyond = rowMat->firstRowIndex[row + 1];
+    MATREC_matrix_size first = rowMat->firstRowIndex[row];
+    MATREC_matrix_size beyond = rowMat->firstRowIndex[row + 1];
     if(first == beyond){
         //row is empty
         return true;
     }
-    for (size_t i = 0; i < rowMat->numRows + rowMat->numColumns; ++i) {
+    for (MATREC_matrix_size i = 0; i < rowMat->numRows + rowMat->numColumns; ++i) {
         sca->graphNodes[i].targetValue = 0;
         sca->graphNodes[i].predecessorNode = MATREC_INVALID_ROW;
         sca->graphNodes[i].status = 0;
     }
-    const size_t firstRowGraphNode = rowMat->numColumns;
+    const MATREC_matrix_size firstRowGraphNode = rowMat->numColumns;
 
-    for (size_t i = first; i < beyond; ++i) {
+    for (MATREC_matrix_size i = first; i < beyond; ++i) {
         assert(abs(rowMat->entryValues[i]) == 1);
         sca->graphNodes[rowMat->entryColumns[i]].targetValue = rowMat->entryValues[i];
     }
 
-    for (size_t rootIndex = first; rootIndex < beyond; ++rootIndex) {
-        size_t rootSearchNode = rowMat->entryColumns[rootIndex];
+    for (MATREC_matrix_size rootIndex = first; rootIndex < beyond; ++rootIndex) {
+        MATREC_matrix_size rootSearchNode = rowMat->entryColumns[rootIndex];
         //Bfs marks the predecessors; if it is not marked, The entry is in a different component of the matrix
         //So we need to do BFS with that entry as a root again.
         if(sca->graphNodes[rootSearchNode].status != 0) continue;
 
         sca->bfsCallStack[0] = rootSearchNode;
         sca->graphNodes[rootSearchNode].status = 1;
-        int bfsBegin = 0;
-        int bfsEnd = 1;
+        MATREC_matrix_size bfsBegin = 0;
+        MATREC_matrix_size bfsEnd = 1;
         while(bfsBegin < bfsEnd){
-            size_t currentNode = sca->bfsCallStack[bfsBegin];
+            MATREC_matrix_size currentNode = sca->bfsCallStack[bfsBegin];
             assert(sca->graphNodes[currentNode].status == 1);
             sca->graphNodes[currentNode].status = 2;
             if(currentNode >= firstRowGraphNode){
-                size_t nodeRow = currentNode-firstRowGraphNode;
+                MATREC_matrix_size nodeRow = currentNode-firstRowGraphNode;
 
-                size_t firstRow = rowMat->firstRowIndex[nodeRow];
-                size_t beyondRow = rowMat->firstRowIndex[nodeRow + 1];
-                for (size_t i = firstRow; i < beyondRow ; ++i) {
-                    size_t entryCol = rowMat->entryColumns[i];
+                MATREC_matrix_size firstRow = rowMat->firstRowIndex[nodeRow];
+                MATREC_matrix_size beyondRow = rowMat->firstRowIndex[nodeRow + 1];
+                for (MATREC_matrix_size i = firstRow; i < beyondRow ; ++i) {
+                    MATREC_matrix_size entryCol = rowMat->entryColumns[i];
                     if(sca->graphNodes[entryCol].status == 0){
                         //If column is new, push it onto the bfs stack
                         sca->graphNodes[entryCol].status = 1;
@@ -94,7 +94,7 @@ bool MATRECcheckSigningNewRow(MATRECSignCheckRowAddition * sca, MATREC_row row){
                         //If we reach a target column for the first time, trace back to the previous target column
                         if(sca->graphNodes[entryCol].targetValue != 0){
                             int sum = sca->graphNodes[entryCol].targetValue;
-                            size_t pathNode = entryCol;
+                            MATREC_matrix_size pathNode = entryCol;
                             do{
                                 sum += sca->graphNodes[pathNode].predecessorValue;
                                 pathNode = sca->graphNodes[pathNode].predecessorNode;
@@ -111,16 +111,16 @@ bool MATRECcheckSigningNewRow(MATRECSignCheckRowAddition * sca, MATREC_row row){
                 }
             }
             else{
-                size_t nodeColumn = currentNode;
+                MATREC_matrix_size nodeColumn = currentNode;
 
                 //Iterate over outgoing edges (rows of the column)
-                size_t firstCol = colMat->firstRowIndex[nodeColumn];
-                size_t beyondCol = colMat->firstRowIndex[nodeColumn + 1];
-                for (size_t i = firstCol; i < beyondCol ; ++i) {
-                    size_t entryRow = colMat->entryColumns[i];
+                MATREC_matrix_size firstCol = colMat->firstRowIndex[nodeColumn];
+                MATREC_matrix_size beyondCol = colMat->firstRowIndex[nodeColumn + 1];
+                for (MATREC_matrix_size i = firstCol; i < beyondCol ; ++i) {
+                    MATREC_matrix_size entryRow = colMat->entryColumns[i];
                     if(!sca->isRowAdded[entryRow]) continue;
 
-                    size_t nodeIndex = firstRowGraphNode + entryRow;
+                    MATREC_matrix_size nodeIndex = firstRowGraphNode + entryRow;
                     //If row is new, push it onto the bfs stack
                     if(sca->graphNodes[nodeIndex].status == 0){
                         sca->graphNodes[nodeIndex].status = 1;
@@ -0,0 +1,152 @@
+#include "Storage.h"
+#include <string.h>
+
+#ifdef MATREC_SEGMENTED_STORAGE
+
+static void freeChunks(MATREC * env, MATRECStorage * storage, MATREC_index first, MATREC_index last){
+    for (MATREC_index i = first; i < last; ++i) {
+        if(storage->chunks[i]){
+            MATRECimplFreeBlockArray(env, &storage->chunks[i]);
+        }
+    }
+}
+
+MATREC_ERROR MATRECstorageCreate(MATREC * env, MATRECStorage * storage, size_t elementSize, MATREC_index * pSize,
+                                 MATREC_index size){
+    assert(env);
+    assert(storage);
+    storage->chunks = NULL;
+    storage->numChunks = 0;
+    storage->memChunks = 0;
+    *pSize = 0;
+    return MATRECstorageResize(env, storage, elementSize, pSize, size);
+}
+
+void MATRECstorageFree(MATREC * env, MATRECStorage * storage){
+    assert(env);
+    assert(storage);
+    if(storage->chunks){
+        freeChunks(env, storage, 0, storage->numChunks);
+        MATRECfreeBlockArray(env, &storage->chunks);
+    }
+    storage->numChunks = 0;
+    storage->memChunks = 0;
+}
+
+MATREC_index MATRECstorageGrowSize(MATREC_index size){
+    if(size < MATREC_CHUNK_SIZE){
+        return 2 * size < MATREC_CHUNK_SIZE ? 2 * size : MATREC_CHUNK_SIZE;
+    }
+    return size + MATREC_CHUNK_SIZE;
+}
+
+MATREC_ERROR MATRECstorageResize(MATREC * env, MATRECStorage * storage, size_t elementSize, MATREC_index * pSize,
+                                 MATREC_index size){
+    assert(env);
+    assert(storage);
+    assert(size > 0);
+    MATREC_index numChunks = (size + MATREC_CHUNK_SIZE - 1) / MATREC_CHUNK_SIZE;
+    if(numChunks > storage->memChunks){
+        MATREC_index memChunks = 2 * storage->memChunks > numChunks ? 2 * storage->memChunks : numChunks;
+        MATREC_CALL(MATRECreallocBlockArray(env, &storage->chunks, (size_t) memChunks));
+        for (MATREC_index i = storage->memChunks; i < memChunks; ++i) {
+            storage->chunks[i] = NULL;
+        }
+        storage->memChunks = memChunks;
+    }
+
+    //New chunks are allocated in full. The first chunk is the only one which is resized in place
+    MATREC_index firstNewChunk = storage->numChunks > 1 ? storage->numChunks : 1;
+    for (MATREC_index i = firstNewChunk; i < numChunks; ++i) {
+        MATREC_ERROR error = MATRECimplAllocBlockArray(env, &storage->chunks[i], elementSize,
+                                                       (size_t) MATREC_CHUNK_SIZE);
+        if(error != MATREC_OKAY){
+            freeChunks(env, storage, firstNewChunk, i);
+            return error;
+        }
+    }
+    MATREC_index firstChunkSize = storage->numChunks == 0 ? 0 : (storage->numChunks == 1 ? *pSize : MATREC_CHUNK_SIZE);
+    MATREC_index newFirstChunkSize = numChunks == 1 ? size : MATREC_CHUNK_SIZE;
+    if(newFirstChunkSize != firstChunkSize){
+        MATREC_ERROR error = MATRECimplReallocBlockArray(env, &storage->chunks[0], elementSize,
+                                                         (size_t) newFirstChunkSize);
+        if(error != MATREC_OKAY){
+            freeChunks(env, storage, firstNewChunk, numChunks);
+            return error;
+        }
+    }
+    freeChunks(env, storage, numChunks, storage->numChunks);
+    storage->numChunks = numChunks;
+    *pSize = numChunks == 1 ? size : numChunks * MATREC_CHUNK_SIZE;
+    return MATREC_OKAY;
+}
+
+void MATRECstorageCopy(MATRECStorage * target, const MATRECStorage * source, size_t elementSize,
+                       MATREC_index numElements){
+    assert(target);
+    assert(source);
+    for (MATREC_index chunk = 0; chunk * MATREC_CHUNK_SIZE < numElements; ++chunk) {
+        MATREC_index remaining = numElements - chunk * MATREC_CHUNK_SIZE;
+        MATREC_index numCopied = remaining < MATREC_CHUNK_SIZE ? remaining : MATREC_CHUNK_SIZE;
+        memcpy(target->chunks[chunk], source->chunks[chunk], (size_t) numCopied * elementSize);
+    }
+}
+
+void MATRECstorageMemory(const MATRECStorage * storage, const char * name, size_t elementSize, MATREC_index size,
+                         MATREC_index numUsed, MATRECMemoryReport * report){
+    assert(storage);
+    assert(size >= numUsed);
+    size_t tableBytes = (size_t) storage->memChunks * sizeof(void *);
+    MATRECmemoryReportAddBytes(report, name, (size_t) size * elementSize + tableBytes,
+                               (size_t) numUsed * elementSize + (size_t) storage->numChunks * sizeof(void *));
+}
+
+#else
+
+MATREC_ERROR MATRECstorageCreate(MATREC * env, MATRECStorage * storage, size_t elementSize, MATREC_index * pSize,
+                                 MATREC_index size){
+    assert(env);
+    assert(storage);
+    assert(size > 0);
+    MATREC_CALL(MATRECimplAllocBlockArray(env, &storage->elements, elementSize, (size_t) size));
+    *pSize = size;
+    return MATREC_OKAY;
+}
+
+void MATRECstorageFree(MATREC * env, MATRECStorage * storage){
+    assert(env);
+    assert(storage);
+    if(storage->elements){
+        MATRECimplFreeBlockArray(env, &storage->elements);
+    }
+}
+
+MATREC_index MATRECstorageGrowSize(MATREC_index size){
+    return 2 * size;
+}
+
+MATREC_ERROR MATRECstorageResize(MATREC * env, MATRECStorage * storage, size_t elementSize, MATREC_index * pSize,
+                                 MATREC_index size){
+    assert(env);
+    assert(storage);
+    assert(size > 0);
+    MATREC_CALL(MATRECimplReallocBlockArray(env, &storage->elements, elementSize, (size_t) size));
+    *pSize = size;
+    return MATREC_OKAY;
+}
+
+void MATRECstorageCopy(MATRECStorage * target, const MATRECStorage * source, size_t elementSize,
+                       MATREC_index numElements){
+    assert(target);
+    assert(source);
+    memcpy(target->elements, source->elements, (size_t) numElements * elementSize);
+}
+
+void MATRECstorageMemory(const MATRECStorage * storage, const char * name, size_t elementSize, MATREC_index size,
+                         MATREC_index numUsed, MATRECMemoryReport * report){
+    assert(storage);
+    (void) storage;
+    MATRECmemoryReportAdd(report, name, elementSize, size, numUsed);
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef MATREC_STORAGE_H
+#define MATREC_STORAGE_H
+
+#include "matrec/Shared.h"
+#include "Memory.h"
+
+///Storage of the arcs, edges, members and nodes of the decompositions. Not part of the public interface.
+///By default, the elements are stored in one array, which doubles in size when it is full.
+///If MATREC_SEGMENTED_STORAGE is defined, they are stored in chunks of MATREC_CHUNK_SIZE elements instead, and the
+///element with index i is at position i % MATREC_CHUNK_SIZE of chunk i / MATREC_CHUNK_SIZE. The first chunk grows like
+///an array until it is full, so that small decompositions stay small. After that, the storage grows by one chunk at a
+///time, so that growing never copies the existing elements and only allocates a little more than is used.
+///The storage does not know its size; the decompositions keep track of it, and pass it to the functions below.
+
+#ifdef MATREC_SEGMENTED_STORAGE
+
+#ifndef MATREC_CHUNK_BITS
+#define MATREC_CHUNK_BITS 16
+#endif
+#define MATREC_CHUNK_SIZE ((MATREC_index) 1 << MATREC_CHUNK_BITS)
+
+typedef struct {
+    void ** chunks;
+    MATREC_index numChunks;
+    MATREC_index memChunks;
+} MATRECStorage;
+
+#define MATRECstorageAt(type, storage, index) \
+    (((type *) (storage).chunks[(index) >> MATREC_CHUNK_BITS])[(index) & (MATREC_CHUNK_SIZE - 1)])
+
+#else
+
+typedef struct {
+    void * elements;
+} MATRECStorage;
+
+#define MATRECstorageAt(type, storage, index) (((type *) (storage).elements)[index])
+
+#endif
+
+///Allocates room for at least the given number of elements, and sets *pSize to the size of the storage
+MATREC_ERROR MATRECstorageCreate(MATREC * env, MATRECStorage * storage, size_t elementSize, MATREC_index * pSize,
+                                 MATREC_index size);
+
+void MATRECstorageFree(MATREC * env, MATRECStorage * storage);
+
+///Returns the size to grow to when the storage of the given size is full
+MATREC_index MATRECstorageGrowSize(MATREC_index size);
+
+///Grows or shrinks the storage to at least the given size, and updates *pSize to the new size, which may be larger in
+///segmented storage. The first min(*pSize, size) elements are kept. On failure, the storage is left unchanged
+MATREC_ERROR MATRECstorageResize(MATREC * env, MATRECStorage * storage, size_t elementSize, MATREC_index * pSize,
+                                 MATREC_index size);
+
+///Copies the first numElements elements of source to target, which must both have room for them
+void MATRECstorageCopy(MATRECStorage * target, const MATRECStorage * source, size_t elementSize,
+                       MATREC_index numElements);
+
+///Adds the storage to a memory report
+void MATRECstorageMemory(const MATRECStorage * storage, const char * name, size_t elementSize, MATREC_index size,
+                         MATREC_index numUsed, MATRECMemoryReport * report);
+
+#endif //MATREC_STORAGE_H
@@ -0,0 +1,290 @@
+#include "matrec/Stream.h"
+
+#include <pthread.h>
+
+typedef struct{
+    MATREC_matrix_size index;
+    MATREC_matrix_size numNonzeros;
+    MATREC_matrix_size memNonzeros;
+    MATREC_matrix_size * nonzeroIndices;
+    double * nonzeroValues;
+} StreamVector;
+
+///Bounded ring buffer between the thread parsing the stream and the thread adding the vectors to the decomposition
+typedef struct{
+    MATREC * env;
+    FILE * stream;
+    MATRECStreamOrientation orientation;
+    MATREC_matrix_size numRows;
+    MATREC_matrix_size numColumns;
+    MATREC_matrix_size numNonzeros;
+
+    StreamVector * slots;
+    MATREC_matrix_size numSlots;
+    MATREC_matrix_size head; ///The oldest filled slot
+    MATREC_matrix_size count; ///The number of filled slots
+
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    bool producerDone;
+    bool consumerStopped;
+    MATREC_ERROR producerError;
+} StreamBuffer;
+
+///Waits until a slot is free, and returns NULL if the consumer stopped
+static StreamVector * acquireFreeSlot(StreamBuffer * buffer){
+    StreamVector * slot = NULL;
+    pthread_mutex_lock(&buffer->lock);
+    while(buffer->count == buffer->numSlots && !buffer->consumerStopped){
+        pthread_cond_wait(&buffer->notFull,&buffer->lock);
+    }
+    if(!buffer->consumerStopped){
+        slot = &buffer->slots[(buffer->head + buffer->count) % buffer->numSlots];
+    }
+    pthread_mutex_unlock(&buffer->lock);
+    return slot;
+}
+
+static void publishSlot(StreamBuffer * buffer){
+    pthread_mutex_lock(&buffer->lock);
+    ++buffer->count;
+    pthread_cond_signal(&buffer->notEmpty);
+    pthread_mutex_unlock(&buffer->lock);
+}
+
+///Waits until a slot is filled, and returns NULL if the producer is done and all slots have been processed
+static StreamVector * acquireFilledSlot(StreamBuffer * buffer){
+    StreamVector * slot = NULL;
+    pthread_mutex_lock(&buffer->lock);
+    while(buffer->count == 0 && !buffer->producerDone){
+        pthread_cond_wait(&buffer->notEmpty,&buffer->lock);
+    }
+    if(buffer->count > 0){
+        slot = &buffer->slots[buffer->head];
+    }
+    pthread_mutex_unlock(&buffer->lock);
+    return slot;
+}
+
+static void releaseFilledSlot(StreamBuffer * buffer){
+    pthread_mutex_lock(&buffer->lock);
+    buffer->head = (buffer->head + 1) % buffer->numSlots;
+    --buffer->count;
+    pthread_cond_signal(&buffer->notFull);
+    pthread_mutex_unlock(&buffer->lock);
+}
+
+static MATREC_ERROR appendNonzero(MATREC * env, StreamVector * slot, MATREC_matrix_size index, double value){
+    if(slot->numNonzeros == slot->memNonzeros){
+        slot->memNonzeros = slot->memNonzeros == 0 ? 16 : 2 * slot->memNonzeros;
+        MATREC_CALL(MATRECreallocBlockArray(env,&slot->nonzeroIndices,slot->memNonzeros));
+        MATREC_CALL(MATRECreallocBlockArray(env,&slot->nonzeroValues,slot->memNonzeros));
+    }
+    slot->nonzeroIndices[slot->numNonzeros] = index;
+    slot->nonzeroValues[slot->numNonzeros] = value;
+    ++slot->numNonzeros;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR parseVectors(StreamBuffer * buffer, bool * seen){
+    bool byColumn = buffer->orientation == MATREC_STREAM_COLUMNS;
+    StreamVector * slot = NULL;
+    char valueString[1024];
+    for (MATREC_matrix_size i = 0; i < buffer->numNonzeros; ++i) {
+        MATREC_matrix_size row;
+        MATREC_matrix_size column;
+        if(fscanf(buffer->stream,"%" MATREC_SCNsize " %" MATREC_SCNsize " %1023s",&row,&column,valueString) != 3 ||
+           row == 0 || column == 0 || row > buffer->numRows || column > buffer->numColumns){
+            return MATREC_ERROR_INPUT;
+        }
+        double value = strtod(valueString,NULL);
+        if(value == 0.0){
+            continue;
+        }
+        MATREC_matrix_size key = byColumn ? column - 1 : row - 1;
+        MATREC_matrix_size index = byColumn ? row - 1 : column - 1;
+        if(!slot || slot->index != key){
+            if(slot){
+                publishSlot(buffer);
+            }
+            if(seen[key]){
+                return MATREC_ERROR_INPUT; //The nonzeros of a column must be consecutive
+            }
+            seen[key] = true;
+            slot = acquireFreeSlot(buffer);
+            if(!slot){
+                return MATREC_OKAY;
+            }
+            slot->index = key;
+            slot->numNonzeros = 0;
+        }
+        MATREC_CALL(appendNonzero(buffer->env,slot,index,value));
+    }
+    if(slot){
+        publishSlot(buffer);
+    }
+    return MATREC_OKAY;
+}
+
+static void * produceVectors(void * data){
+    StreamBuffer * buffer = (StreamBuffer *) data;
+    bool * seen = NULL;
+    MATREC_matrix_size numVectors = buffer->orientation == MATREC_STREAM_COLUMNS ? buffer->numColumns : buffer->numRows;
+    MATREC_ERROR error = MATRECallocBlockArray(buffer->env,&seen,numVectors + 1);
+    if(error == MATREC_OKAY){
+        for (MATREC_matrix_size i = 0; i < numVectors; ++i) {
+            seen[i] = false;
+        }
+        error = parseVectors(buffer,seen);
+        MATRECfreeBlockArray(buffer->env,&seen);
+    }
+
+    pthread_mutex_lock(&buffer->lock);
+    buffer->producerDone = true;
+    buffer->producerError = error;
+    pthread_cond_signal(&buffer->notEmpty);
+    pthread_mutex_unlock(&buffer->lock);
+    return NULL;
+}
+
+static MATREC_ERROR consumeVectors(StreamBuffer * buffer, MATRECNetworkDecomposition * dec, MATRECStreamResult * result){
+    MATREC * env = buffer->env;
+    MATRECNetworkColumnAddition * newCol = NULL;
+    MATRECNetworkRowAddition * newRow = NULL;
+    if(buffer->orientation == MATREC_STREAM_COLUMNS){
+        MATREC_CALL(MATRECcreateNetworkColumnAddition(env,&newCol));
+    }else{
+        MATREC_CALL(MATRECcreateNetworkRowAddition(env,&newRow));
+    }
+
+    //On errors, we still free the additions before returning
+    MATREC_ERROR error = MATREC_OKAY;
+    StreamVector * slot;
+    while((slot = acquireFilledSlot(buffer)) != NULL){
+        bool remainsNetwork;
+        if(newCol){
+            error = MATRECNetworkColumnAdditionCheck(dec,newCol,slot->index,slot->nonzeroIndices,
+                                                     slot->nonzeroValues,slot->numNonzeros);
+            if(error != MATREC_OKAY){
+                goto cleanup;
+            }
+            remainsNetwork = MATRECNetworkColumnAdditionRemainsNetwork(newCol);
+            if(remainsNetwork){
+                error = MATRECNetworkColumnAdditionAdd(dec,newCol);
+            }
+        }else{
+            error = MATRECNetworkRowAdditionCheck(dec,newRow,slot->index,slot->nonzeroIndices,
+                                                  slot->nonzeroValues,slot->numNonzeros);
+            if(error != MATREC_OKAY){
+                goto cleanup;
+            }
+            remainsNetwork = MATRECNetworkRowAdditionRemainsNetwork(newRow);
+            if(remainsNetwork){
+                error = MATRECNetworkRowAdditionAdd(dec,newRow);
+            }
+        }
+        if(error != MATREC_OKAY){
+            goto cleanup;
+        }
+        if(!remainsNetwork){
+            result->isNetwork = false;
+            result->failedIndex = slot->index;
+            break;
+        }
+        ++result->numAdded;
+        releaseFilledSlot(buffer);
+    }
+
+cleanup:
+    if(newCol){
+        MATRECfreeNetworkColumnAddition(env,&newCol);
+    }
+    if(newRow){
+        MATRECfreeNetworkRowAddition(env,&newRow);
+    }
+    return error;
+}
+
+static MATREC_ERROR runStream(StreamBuffer * buffer, MATRECStreamResult * result,
+                              MATRECNetworkDecomposition ** pDecomposition){
+    MATRECNetworkDecomposition * dec = NULL;
+    MATREC_CALL(MATRECNetworkDecompositionCreate(buffer->env,&dec,buffer->numRows,buffer->numColumns));
+
+    pthread_t producer;
+    if(pthread_create(&producer,NULL,produceVectors,buffer) != 0){
+        MATRECNetworkDecompositionFree(&dec);
+        return MATREC_ERROR_MEMORY;
+    }
+    MATREC_ERROR error = consumeVectors(buffer,dec,result);
+
+    //Wakes up the producer if it is waiting for a free slot
+    pthread_mutex_lock(&buffer->lock);
+    buffer->consumerStopped = true;
+    pthread_cond_signal(&buffer->notFull);
+    pthread_mutex_unlock(&buffer->lock);
+    pthread_join(producer,NULL);
+
+    //If we stopped early, the producer may not have read the remaining stream, which is not an error
+    if(error == MATREC_OKAY && result->isNetwork){
+        error = buffer->producerError;
+    }
+    if(error == MATREC_OKAY && pDecomposition){
+        *pDecomposition = dec;
+    }else{
+        MATRECNetworkDecompositionFree(&dec);
+    }
+    return error;
+}
+
+MATREC_ERROR MATRECNetworkStreamRecognize(MATREC * env, FILE * stream, MATRECStreamOrientation orientation,
+                                          MATREC_matrix_size bufferCapacity, MATRECStreamResult * result,
+                                          MATRECNetworkDecomposition ** pDecomposition){
+    assert(env);
+    assert(stream);
+    assert(result);
+    assert(!pDecomposition || !*pDecomposition);
+
+    result->isNetwork = true;
+    result->numAdded = 0;
+    result->failedIndex = MATREC_INVALID;
+
+    StreamBuffer buffer;
+    buffer.env = env;
+    buffer.stream = stream;
+    buffer.orientation = orientation;
+    if(fscanf(stream,"%" MATREC_SCNsize " %" MATREC_SCNsize " %" MATREC_SCNsize,&buffer.numRows,&buffer.numColumns,&buffer.numNonzeros) != 3){
+        return MATREC_ERROR_INPUT;
+    }
+
+    buffer.numSlots = bufferCapacity > 0 ? bufferCapacity : 1;
+    buffer.head = 0;
+    buffer.count = 0;
+    buffer.producerDone = false;
+    buffer.consumerStopped = false;
+    buffer.producerError = MATREC_OKAY;
+    buffer.slots = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&buffer.slots,buffer.numSlots));
+    for (MATREC_matrix_size i = 0; i < buffer.numSlots; ++i) {
+        buffer.slots[i].index = MATREC_INVALID;
+        buffer.slots[i].numNonzeros = 0;
+        buffer.slots[i].memNonzeros = 0;
+        buffer.slots[i].nonzeroIndices = NULL;
+        buffer.slots[i].nonzeroValues = NULL;
+    }
+    pthread_mutex_init(&buffer.lock,NULL);
+    pthread_cond_init(&buffer.notEmpty,NULL);
+    pthread_cond_init(&buffer.notFull,NULL);
+
+    MATREC_ERROR error = runStream(&buffer,result,pDecomposition);
+
+    pthread_cond_destroy(&buffer.notFull);
+    pthread_cond_destroy(&buffer.notEmpty);
+    pthread_mutex_destroy(&buffer.lock);
+    for (MATREC_matrix_size i = 0; i < buffer.numSlots; ++i) {
+        MATRECfreeBlockArray(env,&buffer.slots[i].nonzeroIndices);
+        MATRECfreeBlockArray(env,&buffer.slots[i].nonzeroValues);
+    }
+    MATRECfreeBlockArray(env,&buffer.slots);
+    return error;
+}
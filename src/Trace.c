@@ -0,0 +1,688 @@
+#include "Trace.h"
+#include "matrec/Network.h"
+#include "matrec/Graphic.h"
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+///A trace starts with the magic bytes and a version byte, which are followed by the records. Every record starts with
+///its call as a byte, which is followed by its arguments. Numbers are written as unsigned LEB128 integers, so that
+///small indices take a single byte. The arguments of each call are:
+///  CREATE: decomposition, numRows, numColumns, row storage, column storage
+///  CREATE_FROM_GRAPH: decomposition, numNodes, numEdges, and for every edge its tail, head and 2 * index + isRow
+///  FREE, RESET, FLATTEN: decomposition
+///  SET_AUTO_FLATTEN: decomposition, and the threshold as 8 little-endian bytes
+///  COLUMN_CHECK, ROW_CHECK: decomposition, addition, row or column, numNonzeros, and the nonzeros. For network
+///    decompositions, these are followed by the signs, where bit i % 8 of byte i / 8 is set if nonzero i is negative.
+///    The last byte is 1 if the row or column can be added, and 0 otherwise
+///  COLUMN_ADD, ROW_ADD: decomposition, addition
+///  FREE_ADDITION: addition
+static const unsigned char traceMagic[8] = {'M', 'A', 'T', 'R', 'E', 'C', 'T', 'R'};
+#define TRACE_VERSION 1
+
+struct MATRECTraceImpl{
+    FILE * file;
+    uint64_t session;
+    pthread_mutex_t lock;
+    MATREC_index numDecompositions;
+    MATREC_index numAdditions;
+};
+
+///Distinguishes the traces, so that ids from an earlier trace are not used in a later one
+static uint64_t numSessions = 0;
+
+MATREC_ERROR MATRECtraceStart(MATREC * env, FILE * file){
+    assert(env);
+    assert(file);
+    assert(!env->trace);
+
+    MATRECTrace * trace = NULL;
+    MATREC_CALL(MATRECallocBlock(env, &trace));
+    trace->file = file;
+    trace->session = __atomic_add_fetch(&numSessions, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_init(&trace->lock, NULL);
+    trace->numDecompositions = 0;
+    trace->numAdditions = 0;
+
+    fwrite(traceMagic, 1, sizeof(traceMagic), file);
+    fputc(TRACE_VERSION, file);
+    env->trace = trace;
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECtraceStop(MATREC * env){
+    assert(env);
+    assert(env->trace);
+    MATRECTrace * trace = env->trace;
+    bool failed = fflush(trace->file) != 0 || ferror(trace->file);
+    pthread_mutex_destroy(&trace->lock);
+    MATRECfreeBlock(env, &env->trace);
+    return failed ? MATREC_ERROR_INPUT : MATREC_OKAY;
+}
+
+void MATRECtraceIdInit(MATRECTraceId * id){
+    id->session = 0;
+    id->id = -1;
+}
+
+bool MATRECtraceIsActive(const MATREC * env){
+    return env->trace != NULL;
+}
+
+bool MATRECtraceContains(const MATREC * env, const MATRECTraceId * id){
+    return env->trace != NULL && id->session == env->trace->session;
+}
+
+void MATRECtraceBegin(MATREC * env, MATRECTraceWriter * writer, MATRECTraceCall call){
+    assert(MATRECtraceIsActive(env));
+    writer->trace = env->trace;
+    writer->size = 0;
+    pthread_mutex_lock(&writer->trace->lock);
+    MATRECtraceWriteByte(writer, (unsigned char) call);
+}
+
+void MATRECtraceWriteByte(MATRECTraceWriter * writer, unsigned char byte){
+    if(writer->size == sizeof(writer->data)){
+        fwrite(writer->data, 1, writer->size, writer->trace->file);
+        writer->size = 0;
+    }
+    writer->data[writer->size] = byte;
+    ++writer->size;
+}
+
+void MATRECtraceWriteNumber(MATRECTraceWriter * writer, uint64_t number){
+    while(number >= 0x80U){
+        MATRECtraceWriteByte(writer, (unsigned char) ((number & 0x7FU) | 0x80U));
+        number >>= 7;
+    }
+    MATRECtraceWriteByte(writer, (unsigned char) number);
+}
+
+void MATRECtraceWriteDouble(MATRECTraceWriter * writer, double number){
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        MATRECtraceWriteByte(writer, (unsigned char) (bits >> (8 * i)));
+    }
+}
+
+void MATRECtraceWriteGraph(MATRECTraceWriter * writer, MATREC_matrix_size numNodes, MATREC_matrix_size numEdges,
+                           const MATREC_matrix_size * edgeTails, const MATREC_matrix_size * edgeHeads,
+                           const MATRECElement * edgeElements){
+    MATRECtraceWriteNumber(writer, numNodes);
+    MATRECtraceWriteNumber(writer, numEdges);
+    for (MATREC_matrix_size i = 0; i < numEdges; ++i) {
+        MATRECtraceWriteNumber(writer, edgeTails[i]);
+        MATRECtraceWriteNumber(writer, edgeHeads[i]);
+        MATRECtraceWriteNumber(writer, 2 * (uint64_t) edgeElements[i].index + edgeElements[i].isRow);
+    }
+}
+
+static void writeObject(MATRECTraceWriter * writer, MATRECTraceId * id, MATREC_index * numObjects){
+    if(id->session != writer->trace->session){
+        id->session = writer->trace->session;
+        id->id = *numObjects;
+        ++*numObjects;
+    }
+    MATRECtraceWriteNumber(writer, (uint64_t) id->id);
+}
+
+void MATRECtraceWriteDecomposition(MATRECTraceWriter * writer, MATRECTraceId * decomposition){
+    writeObject(writer, decomposition, &writer->trace->numDecompositions);
+}
+
+void MATRECtraceWriteAddition(MATRECTraceWriter * writer, MATRECTraceId * addition){
+    writeObject(writer, addition, &writer->trace->numAdditions);
+}
+
+void MATRECtraceEnd(MATRECTraceWriter * writer){
+    fwrite(writer->data, 1, writer->size, writer->trace->file);
+    pthread_mutex_unlock(&writer->trace->lock);
+    writer->size = 0;
+}
+
+const char * MATRECtraceCallName(MATRECTraceCall call){
+    static const char * names[MATREC_TRACE_NUM_CALLS] = {
+            "network create", "graphic create", "network create from graph", "graphic create from graph",
+            "free", "reset", "flatten", "set auto flatten", "column check", "column add", "row check", "row add",
+            "free addition"
+    };
+    assert(call < MATREC_TRACE_NUM_CALLS);
+    return names[call];
+}
+
+typedef struct{
+    bool isNetwork;
+    union{
+        MATRECNetworkDecomposition * network;
+        MATRECGraphicDecomposition * graphic;
+    } object; //Is NULL once the decomposition is freed
+} ReplayDecomposition;
+
+typedef enum{
+    ADDITION_NETWORK_COLUMN = 0,
+    ADDITION_NETWORK_ROW = 1,
+    ADDITION_GRAPHIC_COLUMN = 2,
+    ADDITION_GRAPHIC_ROW = 3
+} AdditionType;
+
+typedef struct{
+    AdditionType type;
+    union{
+        MATRECNetworkColumnAddition * networkColumn;
+        MATRECNetworkRowAddition * networkRow;
+        MATRECGraphicColumnAddition * graphicColumn;
+        MATRECGraphicRowAddition * graphicRow;
+    } object; //Is NULL once the addition is freed
+    MATREC_index lastDecomposition; ///The decomposition of the last check, or -1 if the addition was not checked
+} ReplayAddition;
+
+typedef struct{
+    MATREC * env;
+    FILE * file;
+    FILE * callTimes;
+    MATRECTraceStatistics * statistics;
+
+    ReplayDecomposition * decompositions;
+    MATREC_index numDecompositions;
+    MATREC_index memDecompositions;
+
+    ReplayAddition * additions;
+    MATREC_index numAdditions;
+    MATREC_index memAdditions;
+
+    MATREC_matrix_size * nonzeros;
+    uint64_t * negativeBits;
+    size_t memNonzeros;
+
+    MATREC_matrix_size * edgeTails;
+    MATREC_matrix_size * edgeHeads;
+    MATRECElement * edgeElements;
+    size_t memEdges;
+} Replay;
+
+static MATREC_ERROR readByte(Replay * replay, unsigned char * byte){
+    int read = getc(replay->file);
+    if(read == EOF){
+        return MATREC_ERROR_INPUT;
+    }
+    *byte = (unsigned char) read;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readNumber(Replay * replay, uint64_t * number){
+    *number = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        unsigned char byte;
+        MATREC_CALL(readByte(replay, &byte));
+        *number |= (uint64_t) (byte & 0x7FU) << shift;
+        if(!(byte & 0x80U)){
+            return MATREC_OKAY;
+        }
+    }
+    return MATREC_ERROR_INPUT;
+}
+
+///Reads a number which must fit in a matrix size and may not be MATREC_INVALID
+static MATREC_ERROR readSize(Replay * replay, MATREC_matrix_size * size){
+    uint64_t number;
+    MATREC_CALL(readNumber(replay, &number));
+    if(number >= (uint64_t) MATREC_INVALID){
+        return MATREC_ERROR_INPUT;
+    }
+    *size = (MATREC_matrix_size) number;
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR readDecomposition(Replay * replay, ReplayDecomposition ** decomposition){
+    uint64_t id;
+    MATREC_CALL(readNumber(replay, &id));
+    if(id >= (uint64_t) replay->numDecompositions || !replay->decompositions[id].object.network){
+        return MATREC_ERROR_INPUT;
+    }
+    *decomposition = &replay->decompositions[id];
+    return MATREC_OKAY;
+}
+
+///Reads the id of a decomposition which is created by the record
+static MATREC_ERROR readNewDecomposition(Replay * replay, bool isNetwork, ReplayDecomposition ** decomposition){
+    uint64_t id;
+    MATREC_CALL(readNumber(replay, &id));
+    if(id != (uint64_t) replay->numDecompositions){
+        return MATREC_ERROR_INPUT;
+    }
+    if(replay->numDecompositions == replay->memDecompositions){
+        replay->memDecompositions = 2 * replay->memDecompositions + 8;
+        MATREC_CALL(MATRECreallocBlockArray(replay->env, &replay->decompositions, (size_t) replay->memDecompositions));
+    }
+    *decomposition = &replay->decompositions[replay->numDecompositions];
+    ++replay->numDecompositions;
+    (*decomposition)->isNetwork = isNetwork;
+    (*decomposition)->object.network = NULL;
+    (*decomposition)->object.graphic = NULL;
+    return MATREC_OKAY;
+}
+
+///Reads the id of an addition, and creates the addition if it appears for the first time
+static MATREC_ERROR readAddition(Replay * replay, AdditionType type, ReplayAddition ** addition){
+    uint64_t id;
+    MATREC_CALL(readNumber(replay, &id));
+    if(id < (uint64_t) replay->numAdditions){
+        *addition = &replay->additions[id];
+        if((*addition)->type != type || !(*addition)->object.networkColumn){
+            return MATREC_ERROR_INPUT;
+        }
+        return MATREC_OKAY;
+    }
+    if(id != (uint64_t) replay->numAdditions){
+        return MATREC_ERROR_INPUT;
+    }
+    if(replay->numAdditions == replay->memAdditions){
+        replay->memAdditions = 2 * replay->memAdditions + 8;
+        MATREC_CALL(MATRECreallocBlockArray(replay->env, &replay->additions, (size_t) replay->memAdditions));
+    }
+    *addition = &replay->additions[replay->numAdditions];
+    ++replay->numAdditions;
+    (*addition)->type = type;
+    (*addition)->object.networkColumn = NULL;
+    (*addition)->lastDecomposition = -1;
+    switch(type){
+        case ADDITION_NETWORK_COLUMN:
+            MATREC_CALL(MATRECcreateNetworkColumnAddition(replay->env, &(*addition)->object.networkColumn));
+            break;
+        case ADDITION_NETWORK_ROW:
+            MATREC_CALL(MATRECcreateNetworkRowAddition(replay->env, &(*addition)->object.networkRow));
+            break;
+        case ADDITION_GRAPHIC_COLUMN:
+            MATREC_CALL(MATRECcreateGraphicColumnAddition(replay->env, &(*addition)->object.graphicColumn));
+            break;
+        case ADDITION_GRAPHIC_ROW:
+            MATREC_CALL(MATRECcreateGraphicRowAddition(replay->env, &(*addition)->object.graphicRow));
+            break;
+    }
+    return MATREC_OKAY;
+}
+
+static void freeAddition(Replay * replay, ReplayAddition * addition){
+    switch(addition->type){
+        case ADDITION_NETWORK_COLUMN:
+            MATRECfreeNetworkColumnAddition(replay->env, &addition->object.networkColumn);
+            break;
+        case ADDITION_NETWORK_ROW:
+            MATRECfreeNetworkRowAddition(replay->env, &addition->object.networkRow);
+            break;
+        case ADDITION_GRAPHIC_COLUMN:
+            MATRECfreeGraphicColumnAddition(replay->env, &addition->object.graphicColumn);
+            break;
+        case ADDITION_GRAPHIC_ROW:
+            MATRECfreeGraphicRowAddition(replay->env, &addition->object.graphicRow);
+            break;
+    }
+    addition->object.networkColumn = NULL;
+}
+
+static void freeDecomposition(ReplayDecomposition * decomposition){
+    if(decomposition->isNetwork){
+        MATRECNetworkDecompositionFree(&decomposition->object.network);
+    }else{
+        MATRECGraphicDecompositionFree(&decomposition->object.graphic);
+    }
+    decomposition->object.network = NULL;
+}
+
+static double currentSeconds(void){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + 1e-9 * (double) time.tv_nsec;
+}
+
+static void recordTime(Replay * replay, MATRECTraceCall call, double start){
+    double seconds = currentSeconds() - start;
+    MATRECTraceStatistics * statistics = replay->statistics;
+    ++statistics->numCalls[call];
+    statistics->totalSeconds[call] += seconds;
+    if(seconds > statistics->maxSeconds[call]){
+        statistics->maxSeconds[call] = seconds;
+    }
+    if(replay->callTimes){
+        fprintf(replay->callTimes, "%s,%.9f\n", MATRECtraceCallName(call), seconds);
+    }
+}
+
+static MATREC_ERROR replayCreate(Replay * replay, MATRECTraceCall call){
+    ReplayDecomposition * decomposition = NULL;
+    MATREC_CALL(readNewDecomposition(replay, call == MATREC_TRACE_NETWORK_CREATE, &decomposition));
+    MATREC_matrix_size numRows;
+    MATREC_matrix_size numColumns;
+    uint64_t rowStorage;
+    uint64_t columnStorage;
+    MATREC_CALL(readSize(replay, &numRows));
+    MATREC_CALL(readSize(replay, &numColumns));
+    MATREC_CALL(readNumber(replay, &rowStorage));
+    MATREC_CALL(readNumber(replay, &columnStorage));
+    if(rowStorage > MATREC_IDS_HASHED || columnStorage > MATREC_IDS_HASHED){
+        return MATREC_ERROR_INPUT;
+    }
+    double start = currentSeconds();
+    if(decomposition->isNetwork){
+        MATREC_CALL(MATRECNetworkDecompositionCreateWithStorage(replay->env, &decomposition->object.network, numRows,
+                                                                numColumns, (MATRECIdStorage) rowStorage,
+                                                                (MATRECIdStorage) columnStorage));
+    }else{
+        MATREC_CALL(MATRECGraphicDecompositionCreateWithStorage(replay->env, &decomposition->object.graphic, numRows,
+                                                                numColumns, (MATRECIdStorage) rowStorage,
+                                                                (MATRECIdStorage) columnStorage));
+    }
+    recordTime(replay, call, start);
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR replayCreateFromGraph(Replay * replay, MATRECTraceCall call){
+    ReplayDecomposition * decomposition = NULL;
+    MATREC_CALL(readNewDecomposition(replay, call == MATREC_TRACE_NETWORK_CREATE_FROM_GRAPH, &decomposition));
+    MATREC_matrix_size numNodes;
+    MATREC_matrix_size numEdges;
+    MATREC_CALL(readSize(replay, &numNodes));
+    MATREC_CALL(readSize(replay, &numEdges));
+    if(numEdges > replay->memEdges){
+        replay->memEdges = numEdges;
+        MATREC_CALL(MATRECreallocBlockArray(replay->env, &replay->edgeTails, replay->memEdges));
+        MATREC_CALL(MATRECreallocBlockArray(replay->env, &replay->edgeHeads, replay->memEdges));
+        MATREC_CALL(MATRECreallocBlockArray(replay->env, &replay->edgeElements, replay->memEdges));
+    }
+    for (MATREC_matrix_size i = 0; i < numEdges; ++i) {
+        uint64_t element;
+        MATREC_CALL(readSize(replay, &replay->edgeTails[i]));
+        MATREC_CALL(readSize(replay, &replay->edgeHeads[i]));
+        MATREC_CALL(readNumber(replay, &element));
+        if(element / 2 >= (uint64_t) MATREC_INVALID){
+            return MATREC_ERROR_INPUT;
+        }
+        replay->edgeElements[i].index = (MATREC_matrix_size) (element / 2);
+        replay->edgeElements[i].isRow = element % 2 == 1;
+    }
+    double start = currentSeconds();
+    if(decomposition->isNetwork){
+        MATREC_CALL(MATRECNetworkDecompositionCreateFromGraph(replay->env, &decomposition->object.network, numNodes, numEdges,
+                                                              replay->edgeTails, replay->edgeHeads,
+                                                              replay->edgeElements));
+    }else{
+        MATREC_CALL(MATRECGraphicDecompositionCreateFromGraph(replay->env, &decomposition->object.graphic, numNodes, numEdges,
+                                                              replay->edgeTails, replay->edgeHeads,
+                                                              replay->edgeElements));
+    }
+    recordTime(replay, call, start);
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR replayDecompositionCall(Replay * replay, MATRECTraceCall call){
+    ReplayDecomposition * decomposition = NULL;
+    MATREC_CALL(readDecomposition(replay, &decomposition));
+    double threshold = 0.0;
+    if(call == MATREC_TRACE_SET_AUTO_FLATTEN){
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            unsigned char byte;
+            MATREC_CALL(readByte(replay, &byte));
+            bits |= (uint64_t) byte << (8 * i);
+        }
+        memcpy(&threshold, &bits, sizeof(threshold));
+        if(!(threshold >= 0.0)){
+            return MATREC_ERROR_INPUT;
+        }
+    }
+    if(call == MATREC_TRACE_RESET && !decomposition->isNetwork){
+        return MATREC_ERROR_INPUT;
+    }
+
+    double start = currentSeconds();
+    switch(call){
+        case MATREC_TRACE_FREE:
+            freeDecomposition(decomposition);
+            break;
+        case MATREC_TRACE_RESET:
+            MATRECNetworkDecompositionReset(decomposition->object.network);
+            break;
+        case MATREC_TRACE_FLATTEN:
+            if(decomposition->isNetwork){
+                MATRECNetworkDecompositionFlatten(decomposition->object.network);
+            }else{
+                MATRECGraphicDecompositionFlatten(decomposition->object.graphic);
+            }
+            break;
+        default:
+            assert(call == MATREC_TRACE_SET_AUTO_FLATTEN);
+            if(decomposition->isNetwork){
+                MATRECNetworkDecompositionSetAutoFlatten(decomposition->object.network, threshold);
+            }else{
+                MATRECGraphicDecompositionSetAutoFlatten(decomposition->object.graphic, threshold);
+            }
+            break;
+    }
+    recordTime(replay, call, start);
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR replayCheck(Replay * replay, MATRECTraceCall call){
+    ReplayDecomposition * decomposition = NULL;
+    MATREC_CALL(readDecomposition(replay, &decomposition));
+    bool isColumn = call == MATREC_TRACE_COLUMN_CHECK;
+    AdditionType type = decomposition->isNetwork ?
+                        (isColumn ? ADDITION_NETWORK_COLUMN : ADDITION_NETWORK_ROW) :
+                        (isColumn ? ADDITION_GRAPHIC_COLUMN : ADDITION_GRAPHIC_ROW);
+    ReplayAddition * addition = NULL;
+    MATREC_CALL(readAddition(replay, type, &addition));
+    addition->lastDecomposition = (MATREC_index) (decomposition - replay->decompositions);
+
+    MATREC_matrix_size element;
+    MATREC_matrix_size numNonzeros;
+    MATREC_CALL(readSize(replay, &element));
+    MATREC_CALL(readSize(replay, &numNonzeros));
+    if(numNonzeros > replay->memNonzeros){
+        replay->memNonzeros = numNonzeros;
+        MATREC_CALL(MATRECreallocBlockArray(replay->env, &replay->nonzeros, replay->memNonzeros));
+        MATREC_CALL(MATRECreallocBlockArray(replay->env, &replay->negativeBits, MATREC_SIGN_WORDS(replay->memNonzeros)));
+    }
+    for (MATREC_matrix_size i = 0; i < numNonzeros; ++i) {
+        MATREC_CALL(readSize(replay, &replay->nonzeros[i]));
+    }
+    if(decomposition->isNetwork){
+        for (size_t i = 0; i < MATREC_SIGN_WORDS(numNonzeros); ++i) {
+            replay->negativeBits[i] = 0;
+        }
+        for (size_t i = 0; i < (numNonzeros + 7) / 8; ++i) {
+            unsigned char byte;
+            MATREC_CALL(readByte(replay, &byte));
+            replay->negativeBits[i / 8] |= (uint64_t) byte << (8 * (i % 8));
+        }
+    }
+    unsigned char outcome;
+    MATREC_CALL(readByte(replay, &outcome));
+    if(outcome > 1){
+        return MATREC_ERROR_INPUT;
+    }
+
+    double start = currentSeconds();
+    bool canBeAdded;
+    switch(type){
+        case ADDITION_NETWORK_COLUMN:
+            MATREC_CALL(MATRECNetworkColumnAdditionCheckPacked(decomposition->object.network, addition->object.networkColumn, element,
+                                                               replay->nonzeros, replay->negativeBits, numNonzeros));
+            canBeAdded = MATRECNetworkColumnAdditionRemainsNetwork(addition->object.networkColumn);
+            break;
+        case ADDITION_NETWORK_ROW:
+            MATREC_CALL(MATRECNetworkRowAdditionCheckPacked(decomposition->object.network, addition->object.networkRow, element,
+                                                            replay->nonzeros, replay->negativeBits, numNonzeros));
+            canBeAdded = MATRECNetworkRowAdditionRemainsNetwork(addition->object.networkRow);
+            break;
+        case ADDITION_GRAPHIC_COLUMN:
+            MATREC_CALL(MATRECGraphicColumnAdditionCheck(decomposition->object.graphic, addition->object.graphicColumn, element,
+                                                         replay->nonzeros, numNonzeros));
+            canBeAdded = MATRECGraphicColumnAdditionRemainsGraphic(addition->object.graphicColumn);
+            break;
+        default:
+            assert(type == ADDITION_GRAPHIC_ROW);
+            MATREC_CALL(MATRECGraphicRowAdditionCheck(decomposition->object.graphic, addition->object.graphicRow, element,
+                                                      replay->nonzeros, numNonzeros));
+            canBeAdded = MATRECGraphicRowAdditionRemainsGraphic(addition->object.graphicRow);
+            break;
+    }
+    recordTime(replay, call, start);
+    if(canBeAdded != (outcome == 1)){
+        ++replay->statistics->numMismatches;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR replayAdd(Replay * replay, MATRECTraceCall call){
+    ReplayDecomposition * decomposition = NULL;
+    MATREC_CALL(readDecomposition(replay, &decomposition));
+    bool isColumn = call == MATREC_TRACE_COLUMN_ADD;
+    AdditionType type = decomposition->isNetwork ?
+                        (isColumn ? ADDITION_NETWORK_COLUMN : ADDITION_NETWORK_ROW) :
+                        (isColumn ? ADDITION_GRAPHIC_COLUMN : ADDITION_GRAPHIC_ROW);
+    ReplayAddition * addition = NULL;
+    MATREC_CALL(readAddition(replay, type, &addition));
+    if(addition->lastDecomposition != (MATREC_index) (decomposition - replay->decompositions)){
+        return MATREC_ERROR_INPUT;
+    }
+
+    //If the check had a different outcome than in the trace, the addition is not possible
+    double start = currentSeconds();
+    switch(type){
+        case ADDITION_NETWORK_COLUMN:
+            if(!MATRECNetworkColumnAdditionRemainsNetwork(addition->object.networkColumn)){
+                return MATREC_OKAY;
+            }
+            MATREC_CALL(MATRECNetworkColumnAdditionAdd(decomposition->object.network, addition->object.networkColumn));
+            break;
+        case ADDITION_NETWORK_ROW:
+            if(!MATRECNetworkRowAdditionRemainsNetwork(addition->object.networkRow)){
+                return MATREC_OKAY;
+            }
+            MATREC_CALL(MATRECNetworkRowAdditionAdd(decomposition->object.network, addition->object.networkRow));
+            break;
+        case ADDITION_GRAPHIC_COLUMN:
+            if(!MATRECGraphicColumnAdditionRemainsGraphic(addition->object.graphicColumn)){
+                return MATREC_OKAY;
+            }
+            MATREC_CALL(MATRECGraphicColumnAdditionAdd(decomposition->object.graphic, addition->object.graphicColumn));
+            break;
+        default:
+            assert(type == ADDITION_GRAPHIC_ROW);
+            if(!MATRECGraphicRowAdditionRemainsGraphic(addition->object.graphicRow)){
+                return MATREC_OKAY;
+            }
+            MATREC_CALL(MATRECGraphicRowAdditionAdd(decomposition->object.graphic, addition->object.graphicRow));
+            break;
+    }
+    recordTime(replay, call, start);
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR replayFreeAddition(Replay * replay){
+    uint64_t id;
+    MATREC_CALL(readNumber(replay, &id));
+    if(id >= (uint64_t) replay->numAdditions || !replay->additions[id].object.networkColumn){
+        return MATREC_ERROR_INPUT;
+    }
+    double start = currentSeconds();
+    freeAddition(replay, &replay->additions[id]);
+    recordTime(replay, MATREC_TRACE_FREE_ADDITION, start);
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR replayRecords(Replay * replay){
+    unsigned char header[sizeof(traceMagic) + 1];
+    if(fread(header, 1, sizeof(header), replay->file) != sizeof(header) ||
+       memcmp(header, traceMagic, sizeof(traceMagic)) != 0 || header[sizeof(traceMagic)] != TRACE_VERSION){
+        return MATREC_ERROR_INPUT;
+    }
+    int read;
+    while((read = getc(replay->file)) != EOF){
+        MATRECTraceCall call = (MATRECTraceCall) read;
+        switch(call){
+            case MATREC_TRACE_NETWORK_CREATE:
+            case MATREC_TRACE_GRAPHIC_CREATE:
+                MATREC_CALL(replayCreate(replay, call));
+                break;
+            case MATREC_TRACE_NETWORK_CREATE_FROM_GRAPH:
+            case MATREC_TRACE_GRAPHIC_CREATE_FROM_GRAPH:
+                MATREC_CALL(replayCreateFromGraph(replay, call));
+                break;
+            case MATREC_TRACE_FREE:
+            case MATREC_TRACE_RESET:
+            case MATREC_TRACE_FLATTEN:
+            case MATREC_TRACE_SET_AUTO_FLATTEN:
+                MATREC_CALL(replayDecompositionCall(replay, call));
+                break;
+            case MATREC_TRACE_COLUMN_CHECK:
+            case MATREC_TRACE_ROW_CHECK:
+                MATREC_CALL(replayCheck(replay, call));
+                break;
+            case MATREC_TRACE_COLUMN_ADD:
+            case MATREC_TRACE_ROW_ADD:
+                MATREC_CALL(replayAdd(replay, call));
+                break;
+            case MATREC_TRACE_FREE_ADDITION:
+                MATREC_CALL(replayFreeAddition(replay));
+                break;
+            default:
+                return MATREC_ERROR_INPUT;
+        }
+    }
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECtraceReplay(MATREC * env, FILE * trace, FILE * callTimes, MATRECTraceStatistics * statistics){
+    assert(env);
+    assert(trace);
+    assert(statistics);
+
+    for (int i = 0; i < MATREC_TRACE_NUM_CALLS; ++i) {
+        statistics->numCalls[i] = 0;
+        statistics->totalSeconds[i] = 0.0;
+        statistics->maxSeconds[i] = 0.0;
+    }
+    statistics->numMismatches = 0;
+
+    Replay replay;
+    replay.env = env;
+    replay.file = trace;
+    replay.callTimes = callTimes;
+    replay.statistics = statistics;
+    replay.decompositions = NULL;
+    replay.numDecompositions = 0;
+    replay.memDecompositions = 0;
+    replay.additions = NULL;
+    replay.numAdditions = 0;
+    replay.memAdditions = 0;
+    replay.nonzeros = NULL;
+    replay.negativeBits = NULL;
+    replay.memNonzeros = 0;
+    replay.edgeTails = NULL;
+    replay.edgeHeads = NULL;
+    replay.edgeElements = NULL;
+    replay.memEdges = 0;
+
+    MATREC_ERROR error = replayRecords(&replay);
+
+    for (MATREC_index i = 0; i < replay.numAdditions; ++i) {
+        if(replay.additions[i].object.networkColumn){
+            freeAddition(&replay, &replay.additions[i]);
+        }
+    }
+    for (MATREC_index i = 0; i < replay.numDecompositions; ++i) {
+        if(replay.decompositions[i].object.network){
+            freeDecomposition(&replay.decompositions[i]);
+        }
+    }
+    MATRECfreeBlockArray(env, &replay.edgeElements);
+    MATRECfreeBlockArray(env, &replay.edgeHeads);
+    MATRECfreeBlockArray(env, &replay.edgeTails);
+    MATRECfreeBlockArray(env, &replay.negativeBits);
+    MATRECfreeBlockArray(env, &replay.nonzeros);
+    MATRECfreeBlockArray(env, &replay.additions);
+    MATRECfreeBlockArray(env, &replay.decompositions);
+    return error;
+}
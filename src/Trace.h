@@ -0,0 +1,54 @@
+#ifndef MATREC_TRACE_INTERNAL_H
+#define MATREC_TRACE_INTERNAL_H
+
+#include "matrec/Trace.h"
+
+///Records calls to the trace of an environment. Not part of the public interface.
+///A record is written between MATRECtraceBegin() and MATRECtraceEnd(), which hold the lock of the trace, so that the
+///records of different threads do not interleave. Decompositions and additions are numbered in the order in which
+///they first appear in the trace.
+
+///Identifies a decomposition or an addition in a trace
+typedef struct{
+    uint64_t session; ///The trace in which the object has an id, or 0 if it never appeared in a trace
+    MATREC_index id;
+} MATRECTraceId;
+
+typedef struct{
+    MATRECTrace * trace;
+    size_t size;
+    unsigned char data[256];
+} MATRECTraceWriter;
+
+void MATRECtraceIdInit(MATRECTraceId * id);
+
+///Returns true if the environment is recording a trace
+bool MATRECtraceIsActive(const MATREC * env);
+
+///Returns true if the environment is recording a trace in which the object appears
+bool MATRECtraceContains(const MATREC * env, const MATRECTraceId * id);
+
+///Starts a record of the given call. The trace must be active
+void MATRECtraceBegin(MATREC * env, MATRECTraceWriter * writer, MATRECTraceCall call);
+
+///Writes the id of the decomposition, and gives it a new id if it does not appear in the trace yet
+void MATRECtraceWriteDecomposition(MATRECTraceWriter * writer, MATRECTraceId * decomposition);
+
+///Writes the id of the addition, and gives it a new id if it does not appear in the trace yet
+void MATRECtraceWriteAddition(MATRECTraceWriter * writer, MATRECTraceId * addition);
+
+void MATRECtraceWriteNumber(MATRECTraceWriter * writer, uint64_t number);
+
+void MATRECtraceWriteByte(MATRECTraceWriter * writer, unsigned char byte);
+
+void MATRECtraceWriteDouble(MATRECTraceWriter * writer, double number);
+
+///Writes the graph of a decomposition which is created from a graph
+void MATRECtraceWriteGraph(MATRECTraceWriter * writer, MATREC_matrix_size numNodes, MATREC_matrix_size numEdges,
+                           const MATREC_matrix_size * edgeTails, const MATREC_matrix_size * edgeHeads,
+                           const MATRECElement * edgeElements);
+
+///Writes the record and releases the lock of the trace
+void MATRECtraceEnd(MATRECTraceWriter * writer);
+
+#endif //MATREC_TRACE_INTERNAL_H
@@ -0,0 +1,1543 @@
+#include "Triconnected.h"
+
+#define SPLIT_INVALID (-1)
+
+typedef enum{
+    EDGE_UNSEEN = 0,
+    EDGE_TREE = 1,
+    EDGE_FROND = 2,
+    EDGE_REMOVED = 3
+} EdgeType;
+
+///A node on the stack of the iterative depth first searches, with the adjacency slot which is being processed
+typedef struct{
+    MATREC_index node;
+    MATREC_index slot;
+    MATREC_index nextSlot;
+    MATREC_index edge;
+    MATREC_index outDegree;
+} PathFrame;
+
+///The state of the path search on a single block. The nodes and edges of the block are numbered from 0, and the
+///arrays are reused for all blocks of the graph.
+typedef struct{
+    MATREC * env;
+    MATREC_index numNodes;
+    MATREC_index memNodes;
+    MATREC_index numEdges;
+    MATREC_index memEdges;
+
+    MATREC_index * globalNode;
+    MATREC_index * number; //Depth first search number, starting at 1. Is 0 for nodes which are not yet visited
+    MATREC_index * newNumber;
+    MATREC_index * father;
+    MATREC_index * treeArc;
+    MATREC_index * descendants;
+    MATREC_index * lowpt1;
+    MATREC_index * lowpt2;
+    MATREC_index * degree;
+    MATREC_index * nodeAt;
+    MATREC_index * firstIncidence;
+    MATREC_index * position;
+    MATREC_index * adjFirst;
+    MATREC_index * adjLast;
+    MATREC_index * adjSize;
+    MATREC_index * highFirst;
+    MATREC_index * cycleFirst;
+    MATREC_index * cycleSecond;
+    MATREC_index * buckets;
+    PathFrame * frames;
+
+    MATREC_index * globalEdge;
+    MATREC_index * source;
+    MATREC_index * target;
+    EdgeType * type;
+    bool * start;
+    MATREC_index * adjSlot;
+    MATREC_index * highSlot;
+    MATREC_index * order;
+    MATREC_index * sorted;
+    MATREC_index * incidence;
+    MATREC_index * edgeEntry1;
+    MATREC_index * edgeEntry2;
+
+    //Adjacency lists, which hold the outgoing tree arcs and fronds of each node
+    MATREC_index * slotEdge;
+    MATREC_index * slotNext;
+    MATREC_index * slotPrevious;
+
+    //Lists of the high points of each node, in the order in which the fronds are visited
+    MATREC_index numHighs;
+    MATREC_index * highValue;
+    MATREC_index * highNext;
+    MATREC_index * highPrevious;
+
+    MATREC_index numEStack;
+    MATREC_index * eStack;
+    MATREC_index tStackTop;
+    MATREC_index * tStackH;
+    MATREC_index * tStackA;
+    MATREC_index * tStackB;
+
+    //Split components. Components are contiguous while they are created, and are linked lists while merging
+    MATREC_index numComponents;
+    MATRECSplitComponentType * componentType;
+    MATREC_index * componentStart;
+    MATREC_index * componentFirst;
+    MATREC_index * componentLast;
+    MATREC_index * componentRepresentative;
+    MATREC_index numEntries;
+    MATREC_index * entryEdge;
+    MATREC_index * entryComponent;
+    MATREC_index * entryNext;
+    MATREC_index * entryPrevious;
+} SplitGraph;
+
+static MATREC_index maxIndex(MATREC_index a, MATREC_index b){
+    return a > b ? a : b;
+}
+
+static MATREC_index minIndex(MATREC_index a, MATREC_index b){
+    return a < b ? a : b;
+}
+
+static MATREC_ERROR reserveNodes(SplitGraph * graph, MATREC_index size){
+    if(size <= graph->memNodes){
+        return MATREC_OKAY;
+    }
+    MATREC_index newSize = maxIndex(2 * graph->memNodes, size);
+    MATREC * env = graph->env;
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->globalNode,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->number,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->newNumber,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->father,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->treeArc,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->descendants,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->lowpt1,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->lowpt2,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->degree,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->nodeAt,(size_t) (newSize + 1)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->firstIncidence,(size_t) (newSize + 1)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->position,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->adjFirst,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->adjLast,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->adjSize,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->highFirst,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->cycleFirst,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->cycleSecond,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->buckets,(size_t) (3 * newSize + 3)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->frames,(size_t) newSize));
+    for (MATREC_index i = graph->memNodes; i < newSize; ++i) {
+        graph->cycleFirst[i] = SPLIT_INVALID;
+        graph->cycleSecond[i] = SPLIT_INVALID;
+    }
+    graph->memNodes = newSize;
+    return MATREC_OKAY;
+}
+
+///Every edge is in at most two split components and has at most one high point entry, so all edge related arrays are
+///bounded by the number of edges
+static MATREC_ERROR reserveEdges(SplitGraph * graph, MATREC_index size){
+    if(size <= graph->memEdges){
+        return MATREC_OKAY;
+    }
+    MATREC_index newSize = maxIndex(2 * graph->memEdges, size);
+    MATREC * env = graph->env;
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->globalEdge,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->source,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->target,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->type,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->start,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->adjSlot,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->highSlot,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->order,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->sorted,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->incidence,(size_t) (2 * newSize)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->edgeEntry1,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->edgeEntry2,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->slotEdge,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->slotNext,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->slotPrevious,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->highValue,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->highNext,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->highPrevious,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->eStack,(size_t) newSize));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->tStackH,(size_t) (2 * newSize + 2)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->tStackA,(size_t) (2 * newSize + 2)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->tStackB,(size_t) (2 * newSize + 2)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->componentType,(size_t) (newSize + 1)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->componentStart,(size_t) (newSize + 2)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->componentFirst,(size_t) (newSize + 1)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->componentLast,(size_t) (newSize + 1)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->componentRepresentative,(size_t) (newSize + 1)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->entryEdge,(size_t) (2 * newSize)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->entryComponent,(size_t) (2 * newSize)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->entryNext,(size_t) (2 * newSize)));
+    MATREC_CALL(MATRECreallocBlockArray(env,&graph->entryPrevious,(size_t) (2 * newSize)));
+    graph->memEdges = newSize;
+    return MATREC_OKAY;
+}
+
+static void freeSplitGraph(SplitGraph * graph){
+    MATREC * env = graph->env;
+    if(graph->memNodes > 0){
+        MATRECfreeBlockArray(env,&graph->frames);
+        MATRECfreeBlockArray(env,&graph->buckets);
+        MATRECfreeBlockArray(env,&graph->cycleSecond);
+        MATRECfreeBlockArray(env,&graph->cycleFirst);
+        MATRECfreeBlockArray(env,&graph->highFirst);
+        MATRECfreeBlockArray(env,&graph->adjSize);
+        MATRECfreeBlockArray(env,&graph->adjLast);
+        MATRECfreeBlockArray(env,&graph->adjFirst);
+        MATRECfreeBlockArray(env,&graph->position);
+        MATRECfreeBlockArray(env,&graph->firstIncidence);
+        MATRECfreeBlockArray(env,&graph->nodeAt);
+        MATRECfreeBlockArray(env,&graph->degree);
+        MATRECfreeBlockArray(env,&graph->lowpt2);
+        MATRECfreeBlockArray(env,&graph->lowpt1);
+        MATRECfreeBlockArray(env,&graph->descendants);
+        MATRECfreeBlockArray(env,&graph->treeArc);
+        MATRECfreeBlockArray(env,&graph->father);
+        MATRECfreeBlockArray(env,&graph->newNumber);
+        MATRECfreeBlockArray(env,&graph->number);
+        MATRECfreeBlockArray(env,&graph->globalNode);
+    }
+    if(graph->memEdges > 0){
+        MATRECfreeBlockArray(env,&graph->entryPrevious);
+        MATRECfreeBlockArray(env,&graph->entryNext);
+        MATRECfreeBlockArray(env,&graph->entryComponent);
+        MATRECfreeBlockArray(env,&graph->entryEdge);
+        MATRECfreeBlockArray(env,&graph->componentRepresentative);
+        MATRECfreeBlockArray(env,&graph->componentLast);
+        MATRECfreeBlockArray(env,&graph->componentFirst);
+        MATRECfreeBlockArray(env,&graph->componentStart);
+        MATRECfreeBlockArray(env,&graph->componentType);
+        MATRECfreeBlockArray(env,&graph->tStackB);
+        MATRECfreeBlockArray(env,&graph->tStackA);
+        MATRECfreeBlockArray(env,&graph->tStackH);
+        MATRECfreeBlockArray(env,&graph->eStack);
+        MATRECfreeBlockArray(env,&graph->highPrevious);
+        MATRECfreeBlockArray(env,&graph->highNext);
+        MATRECfreeBlockArray(env,&graph->highValue);
+        MATRECfreeBlockArray(env,&graph->slotPrevious);
+        MATRECfreeBlockArray(env,&graph->slotNext);
+        MATRECfreeBlockArray(env,&graph->slotEdge);
+        MATRECfreeBlockArray(env,&graph->edgeEntry2);
+        MATRECfreeBlockArray(env,&graph->edgeEntry1);
+        MATRECfreeBlockArray(env,&graph->incidence);
+        MATRECfreeBlockArray(env,&graph->sorted);
+        MATRECfreeBlockArray(env,&graph->order);
+        MATRECfreeBlockArray(env,&graph->highSlot);
+        MATRECfreeBlockArray(env,&graph->adjSlot);
+        MATRECfreeBlockArray(env,&graph->start);
+        MATRECfreeBlockArray(env,&graph->type);
+        MATRECfreeBlockArray(env,&graph->target);
+        MATRECfreeBlockArray(env,&graph->source);
+        MATRECfreeBlockArray(env,&graph->globalEdge);
+    }
+}
+
+static MATREC_ERROR newEdge(SplitGraph * graph, MATREC_index source, MATREC_index target, MATREC_index * pEdge){
+    MATREC_CALL(reserveEdges(graph,graph->numEdges + 1));
+    MATREC_index edge = graph->numEdges;
+    ++graph->numEdges;
+    graph->globalEdge[edge] = SPLIT_INVALID;
+    graph->source[edge] = source;
+    graph->target[edge] = target;
+    graph->type[edge] = EDGE_UNSEEN;
+    graph->start[edge] = false;
+    graph->adjSlot[edge] = SPLIT_INVALID;
+    graph->highSlot[edge] = SPLIT_INVALID;
+    *pEdge = edge;
+    return MATREC_OKAY;
+}
+
+static void newComponent(SplitGraph * graph, MATRECSplitComponentType type){
+    graph->componentType[graph->numComponents] = type;
+    graph->componentStart[graph->numComponents] = graph->numEntries;
+    ++graph->numComponents;
+}
+
+///Adds the edge to the most recently created component
+static void addComponentEdge(SplitGraph * graph, MATREC_index edge){
+    graph->entryEdge[graph->numEntries] = edge;
+    ++graph->numEntries;
+}
+
+///Adds the virtual edge which closes the most recently created component, which is a triangle or a rigid component
+static void finishTriangleOrRigid(SplitGraph * graph, MATREC_index edge){
+    addComponentEdge(graph,edge);
+    MATREC_index component = graph->numComponents - 1;
+    MATREC_index size = graph->numEntries - graph->componentStart[component];
+    graph->componentType[component] = size >= 4 ? MATREC_SPLIT_RIGID : MATREC_SPLIT_POLYGON;
+}
+
+static void deleteSlot(SplitGraph * graph, MATREC_index edge){
+    MATREC_index slot = graph->adjSlot[edge];
+    if(slot == SPLIT_INVALID){
+        return;
+    }
+    MATREC_index node = graph->source[edge];
+    MATREC_index previous = graph->slotPrevious[slot];
+    MATREC_index next = graph->slotNext[slot];
+    if(previous == SPLIT_INVALID){
+        graph->adjFirst[node] = next;
+    }else{
+        graph->slotNext[previous] = next;
+    }
+    if(next == SPLIT_INVALID){
+        graph->adjLast[node] = previous;
+    }else{
+        graph->slotPrevious[next] = previous;
+    }
+    --graph->adjSize[node];
+    graph->adjSlot[edge] = SPLIT_INVALID;
+}
+
+static void deleteHigh(SplitGraph * graph, MATREC_index edge){
+    MATREC_index entry = graph->highSlot[edge];
+    if(entry == SPLIT_INVALID){
+        return;
+    }
+    MATREC_index node = graph->target[edge];
+    MATREC_index previous = graph->highPrevious[entry];
+    MATREC_index next = graph->highNext[entry];
+    if(previous == SPLIT_INVALID){
+        graph->highFirst[node] = next;
+    }else{
+        graph->highNext[previous] = next;
+    }
+    if(next != SPLIT_INVALID){
+        graph->highPrevious[next] = previous;
+    }
+    graph->highSlot[edge] = SPLIT_INVALID;
+}
+
+static MATREC_index high(const SplitGraph * graph, MATREC_index node){
+    MATREC_index first = graph->highFirst[node];
+    return first == SPLIT_INVALID ? 0 : graph->highValue[first];
+}
+
+static void pushTStack(SplitGraph * graph, MATREC_index h, MATREC_index a, MATREC_index b){
+    ++graph->tStackTop;
+    graph->tStackH[graph->tStackTop] = h;
+    graph->tStackA[graph->tStackTop] = a;
+    graph->tStackB[graph->tStackTop] = b;
+}
+
+///Pushes the end-of-stack marker, which separates the triples of different paths
+static void pushTStackEnd(SplitGraph * graph){
+    pushTStack(graph,SPLIT_INVALID,SPLIT_INVALID,SPLIT_INVALID);
+}
+
+static bool tStackNotEnd(const SplitGraph * graph){
+    return graph->tStackA[graph->tStackTop] != SPLIT_INVALID;
+}
+
+static MATREC_index otherEndpoint(const SplitGraph * graph, MATREC_index edge, MATREC_index node){
+    return graph->source[edge] == node ? graph->target[edge] : graph->source[edge];
+}
+
+///Replaces every set of parallel edges by a bond, and a single virtual edge in the graph
+static MATREC_ERROR splitMultipleEdges(SplitGraph * graph){
+    MATREC_index numNodes = graph->numNodes;
+    MATREC_index numEdges = graph->numEdges;
+    //Two passes of bucket sort, such that edges with the same endpoints are consecutive
+    for (MATREC_index pass = 0; pass < 2; ++pass) {
+        for (MATREC_index i = 0; i <= numNodes; ++i) {
+            graph->buckets[i] = 0;
+        }
+        for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+            MATREC_index key = pass == 0 ? maxIndex(graph->source[edge],graph->target[edge]) :
+                               minIndex(graph->source[edge],graph->target[edge]);
+            ++graph->buckets[key + 1];
+        }
+        for (MATREC_index i = 0; i < numNodes; ++i) {
+            graph->buckets[i + 1] += graph->buckets[i];
+        }
+        for (MATREC_index i = 0; i < numEdges; ++i) {
+            MATREC_index edge = pass == 0 ? i : graph->order[i];
+            MATREC_index key = pass == 0 ? maxIndex(graph->source[edge],graph->target[edge]) :
+                               minIndex(graph->source[edge],graph->target[edge]);
+            graph->sorted[graph->buckets[key]] = edge;
+            ++graph->buckets[key];
+        }
+        for (MATREC_index i = 0; i < numEdges; ++i) {
+            graph->order[i] = graph->sorted[i];
+        }
+    }
+    MATREC_index groupStart = 0;
+    while(groupStart < numEdges){
+        MATREC_index first = graph->order[groupStart];
+        MATREC_index low = minIndex(graph->source[first],graph->target[first]);
+        MATREC_index highNode = maxIndex(graph->source[first],graph->target[first]);
+        MATREC_index groupEnd = groupStart + 1;
+        while(groupEnd < numEdges){
+            MATREC_index edge = graph->order[groupEnd];
+            if(minIndex(graph->source[edge],graph->target[edge]) != low ||
+               maxIndex(graph->source[edge],graph->target[edge]) != highNode){
+                break;
+            }
+            ++groupEnd;
+        }
+        if(groupEnd - groupStart >= 2){
+            MATREC_index virtualEdge = SPLIT_INVALID;
+            MATREC_CALL(newEdge(graph,low,highNode,&virtualEdge));
+            newComponent(graph,MATREC_SPLIT_BOND);
+            for (MATREC_index i = groupStart; i < groupEnd; ++i) {
+                MATREC_index edge = graph->order[i];
+                graph->type[edge] = EDGE_REMOVED;
+                addComponentEdge(graph,edge);
+            }
+            addComponentEdge(graph,virtualEdge);
+        }
+        groupStart = groupEnd;
+    }
+    return MATREC_OKAY;
+}
+
+///Computes the depth first search numbers, the lowpoints and the number of descendants, and orients the edges into
+///tree arcs and fronds
+static void depthFirstSearch(SplitGraph * graph){
+    MATREC_index numNodes = graph->numNodes;
+    for (MATREC_index i = 0; i <= numNodes; ++i) {
+        graph->firstIncidence[i] = 0;
+    }
+    for (MATREC_index edge = 0; edge < graph->numEdges; ++edge) {
+        if(graph->type[edge] == EDGE_REMOVED){
+            continue;
+        }
+        ++graph->firstIncidence[graph->source[edge] + 1];
+        ++graph->firstIncidence[graph->target[edge] + 1];
+    }
+    for (MATREC_index i = 0; i < numNodes; ++i) {
+        graph->degree[i] = graph->firstIncidence[i + 1];
+        graph->firstIncidence[i + 1] += graph->firstIncidence[i];
+        graph->position[i] = graph->firstIncidence[i];
+        graph->number[i] = 0;
+    }
+    for (MATREC_index edge = 0; edge < graph->numEdges; ++edge) {
+        if(graph->type[edge] == EDGE_REMOVED){
+            continue;
+        }
+        graph->incidence[graph->position[graph->source[edge]]++] = edge;
+        graph->incidence[graph->position[graph->target[edge]]++] = edge;
+    }
+    for (MATREC_index i = 0; i < numNodes; ++i) {
+        graph->position[i] = graph->firstIncidence[i];
+    }
+
+    MATREC_index count = 1;
+    MATREC_index numFrames = 1;
+    graph->frames[0].node = 0;
+    graph->number[0] = count;
+    graph->father[0] = SPLIT_INVALID;
+    graph->treeArc[0] = SPLIT_INVALID;
+    graph->lowpt1[0] = count;
+    graph->lowpt2[0] = count;
+    graph->descendants[0] = 1;
+    while(numFrames > 0){
+        MATREC_index v = graph->frames[numFrames - 1].node;
+        if(graph->position[v] == graph->firstIncidence[v + 1]){
+            --numFrames;
+            MATREC_index u = graph->father[v];
+            if(u == SPLIT_INVALID){
+                continue;
+            }
+            graph->descendants[u] += graph->descendants[v];
+            if(graph->lowpt1[v] < graph->lowpt1[u]){
+                graph->lowpt2[u] = minIndex(graph->lowpt1[u],graph->lowpt2[v]);
+                graph->lowpt1[u] = graph->lowpt1[v];
+            }else if(graph->lowpt1[v] == graph->lowpt1[u]){
+                graph->lowpt2[u] = minIndex(graph->lowpt2[u],graph->lowpt2[v]);
+            }else{
+                graph->lowpt2[u] = minIndex(graph->lowpt2[u],graph->lowpt1[v]);
+            }
+            continue;
+        }
+        MATREC_index edge = graph->incidence[graph->position[v]];
+        ++graph->position[v];
+        if(graph->type[edge] != EDGE_UNSEEN){
+            continue;
+        }
+        MATREC_index w = otherEndpoint(graph,edge,v);
+        graph->source[edge] = v;
+        graph->target[edge] = w;
+        if(graph->number[w] == 0){
+            graph->type[edge] = EDGE_TREE;
+            ++count;
+            graph->number[w] = count;
+            graph->father[w] = v;
+            graph->treeArc[w] = edge;
+            graph->lowpt1[w] = count;
+            graph->lowpt2[w] = count;
+            graph->descendants[w] = 1;
+            graph->frames[numFrames].node = w;
+            ++numFrames;
+        }else{
+            //As the graph has no parallel edges, an unseen edge to a visited node always goes to an ancestor
+            graph->type[edge] = EDGE_FROND;
+            MATREC_index wnum = graph->number[w];
+            if(wnum < graph->lowpt1[v]){
+                graph->lowpt2[v] = graph->lowpt1[v];
+                graph->lowpt1[v] = wnum;
+            }else if(wnum > graph->lowpt1[v] && wnum < graph->lowpt2[v]){
+                graph->lowpt2[v] = wnum;
+            }
+        }
+    }
+}
+
+///Orders the outgoing edges of every node by their lowpoints, so that the path search finds the separation pairs
+static void buildAdjacency(SplitGraph * graph){
+    MATREC_index numNodes = graph->numNodes;
+    MATREC_index numBuckets = 3 * numNodes + 3;
+    for (MATREC_index i = 0; i < numBuckets; ++i) {
+        graph->buckets[i] = 0;
+    }
+    MATREC_index numSorted = 0;
+    for (MATREC_index edge = 0; edge < graph->numEdges; ++edge) {
+        if(graph->type[edge] == EDGE_REMOVED){
+            continue;
+        }
+        MATREC_index v = graph->source[edge];
+        MATREC_index w = graph->target[edge];
+        MATREC_index phi;
+        if(graph->type[edge] == EDGE_FROND){
+            phi = 3 * graph->number[w] + 1;
+        }else if(graph->lowpt2[w] < graph->number[v]){
+            phi = 3 * graph->lowpt1[w];
+        }else{
+            phi = 3 * graph->lowpt1[w] + 2;
+        }
+        graph->order[edge] = phi;
+        ++graph->buckets[phi];
+        ++numSorted;
+    }
+    MATREC_index sum = 0;
+    for (MATREC_index i = 0; i < numBuckets; ++i) {
+        MATREC_index size = graph->buckets[i];
+        graph->buckets[i] = sum;
+        sum += size;
+    }
+    for (MATREC_index edge = 0; edge < graph->numEdges; ++edge) {
+        if(graph->type[edge] == EDGE_REMOVED){
+            continue;
+        }
+        graph->sorted[graph->buckets[graph->order[edge]]++] = edge;
+    }
+    for (MATREC_index i = 0; i < numNodes; ++i) {
+        graph->adjFirst[i] = SPLIT_INVALID;
+        graph->adjLast[i] = SPLIT_INVALID;
+        graph->adjSize[i] = 0;
+    }
+    for (MATREC_index slot = 0; slot < numSorted; ++slot) {
+        MATREC_index edge = graph->sorted[slot];
+        MATREC_index node = graph->source[edge];
+        graph->slotEdge[slot] = edge;
+        graph->slotNext[slot] = SPLIT_INVALID;
+        graph->slotPrevious[slot] = graph->adjLast[node];
+        if(graph->adjLast[node] == SPLIT_INVALID){
+            graph->adjFirst[node] = slot;
+        }else{
+            graph->slotNext[graph->adjLast[node]] = slot;
+        }
+        graph->adjLast[node] = slot;
+        ++graph->adjSize[node];
+        graph->adjSlot[edge] = slot;
+    }
+}
+
+///Renumbers the nodes in the order in which the paths are found, marks the edges which start a path and builds the
+///lists of high points
+static void findPaths(SplitGraph * graph){
+    MATREC_index numNodes = graph->numNodes;
+    for (MATREC_index i = 0; i < numNodes; ++i) {
+        graph->highFirst[i] = SPLIT_INVALID;
+    }
+    graph->numHighs = 0;
+    MATREC_index numCount = numNodes;
+    bool newPath = true;
+    MATREC_index numFrames = 1;
+    graph->frames[0].node = 0;
+    graph->frames[0].slot = graph->adjFirst[0];
+    graph->newNumber[0] = numCount - graph->descendants[0] + 1;
+    //The high point lists are appended to, so the last entry of each list is kept in the position array
+    for (MATREC_index i = 0; i < numNodes; ++i) {
+        graph->position[i] = SPLIT_INVALID;
+    }
+    while(numFrames > 0){
+        PathFrame * frame = &graph->frames[numFrames - 1];
+        if(frame->slot == SPLIT_INVALID){
+            --numFrames;
+            if(numFrames > 0){
+                --numCount;
+            }
+            continue;
+        }
+        MATREC_index v = frame->node;
+        MATREC_index edge = graph->slotEdge[frame->slot];
+        frame->slot = graph->slotNext[frame->slot];
+        MATREC_index w = graph->target[edge];
+        if(newPath){
+            newPath = false;
+            graph->start[edge] = true;
+        }
+        if(graph->type[edge] == EDGE_TREE){
+            graph->newNumber[w] = numCount - graph->descendants[w] + 1;
+            graph->frames[numFrames].node = w;
+            graph->frames[numFrames].slot = graph->adjFirst[w];
+            ++numFrames;
+        }else{
+            MATREC_index entry = graph->numHighs;
+            ++graph->numHighs;
+            graph->highValue[entry] = graph->newNumber[v];
+            graph->highNext[entry] = SPLIT_INVALID;
+            graph->highPrevious[entry] = graph->position[w];
+            if(graph->position[w] == SPLIT_INVALID){
+                graph->highFirst[w] = entry;
+            }else{
+                graph->highNext[graph->position[w]] = entry;
+            }
+            graph->position[w] = entry;
+            graph->highSlot[edge] = entry;
+            newPath = true;
+        }
+    }
+}
+
+///Performs the steps of the path search after the tree arc from frame->node to its child has been searched, which
+///finds the separation pairs of type 2 and type 1 which involve the tree arc
+static MATREC_ERROR finishTreeArc(SplitGraph * graph, PathFrame * frame){
+    MATREC_index v = frame->node;
+    MATREC_index vnum = graph->newNumber[v];
+    MATREC_index e = frame->edge;
+    MATREC_index slot = frame->slot;
+    MATREC_index w = graph->target[e];
+    MATREC_index wnum = graph->newNumber[w];
+
+    graph->eStack[graph->numEStack++] = graph->treeArc[w];
+
+    //Type 2 separation pairs
+    while(vnum != 1){
+        bool typeA = graph->tStackA[graph->tStackTop] == vnum;
+        bool degreeTwo = graph->degree[w] == 2 && graph->adjFirst[w] != SPLIT_INVALID &&
+                         graph->newNumber[graph->target[graph->slotEdge[graph->adjFirst[w]]]] > wnum;
+        if(!typeA && !degreeTwo){
+            break;
+        }
+        MATREC_index a = graph->tStackA[graph->tStackTop];
+        MATREC_index b = graph->tStackB[graph->tStackTop];
+        if(a == vnum && graph->father[graph->nodeAt[b]] == graph->nodeAt[a]){
+            --graph->tStackTop;
+            continue;
+        }
+        MATREC_index eab = SPLIT_INVALID;
+        MATREC_index virtualEdge = SPLIT_INVALID;
+        MATREC_index x;
+        if(degreeTwo){
+            MATREC_index e1 = graph->eStack[--graph->numEStack];
+            MATREC_index e2 = graph->eStack[--graph->numEStack];
+            deleteSlot(graph,e2);
+            x = graph->target[e2];
+            MATREC_CALL(newEdge(graph,v,x,&virtualEdge));
+            --graph->degree[x];
+            --graph->degree[v];
+            newComponent(graph,MATREC_SPLIT_POLYGON);
+            addComponentEdge(graph,e1);
+            addComponentEdge(graph,e2);
+            addComponentEdge(graph,virtualEdge);
+            if(graph->numEStack > 0){
+                MATREC_index top = graph->eStack[graph->numEStack - 1];
+                if(graph->source[top] == x && graph->target[top] == v){
+                    eab = top;
+                    --graph->numEStack;
+                    deleteSlot(graph,eab);
+                    deleteHigh(graph,eab);
+                }
+            }
+        }else{
+            MATREC_index h = graph->tStackH[graph->tStackTop];
+            --graph->tStackTop;
+            newComponent(graph,MATREC_SPLIT_POLYGON);
+            while(graph->numEStack > 0){
+                MATREC_index xy = graph->eStack[graph->numEStack - 1];
+                MATREC_index xnum = graph->newNumber[graph->source[xy]];
+                MATREC_index ynum = graph->newNumber[graph->target[xy]];
+                if(!(vnum <= xnum && xnum <= h && vnum <= ynum && ynum <= h)){
+                    break;
+                }
+                --graph->numEStack;
+                if((xnum == a && ynum == b) || (ynum == a && xnum == b)){
+                    eab = xy;
+                    deleteSlot(graph,eab);
+                    deleteHigh(graph,eab);
+                }else{
+                    if(graph->adjSlot[xy] != slot){
+                        deleteSlot(graph,xy);
+                        deleteHigh(graph,xy);
+                    }
+                    addComponentEdge(graph,xy);
+                    --graph->degree[graph->source[xy]];
+                    --graph->degree[graph->target[xy]];
+                }
+            }
+            x = graph->nodeAt[b];
+            MATREC_CALL(newEdge(graph,v,x,&virtualEdge));
+            finishTriangleOrRigid(graph,virtualEdge);
+        }
+        if(eab != SPLIT_INVALID){
+            newComponent(graph,MATREC_SPLIT_BOND);
+            addComponentEdge(graph,eab);
+            addComponentEdge(graph,virtualEdge);
+            MATREC_CALL(newEdge(graph,v,x,&virtualEdge));
+            addComponentEdge(graph,virtualEdge);
+            --graph->degree[x];
+            --graph->degree[v];
+        }
+        graph->eStack[graph->numEStack++] = virtualEdge;
+        graph->slotEdge[slot] = virtualEdge;
+        graph->adjSlot[virtualEdge] = slot;
+        ++graph->degree[x];
+        ++graph->degree[v];
+        graph->father[x] = v;
+        graph->treeArc[x] = virtualEdge;
+        graph->type[virtualEdge] = EDGE_TREE;
+        w = x;
+        wnum = graph->newNumber[w];
+    }
+
+    //Type 1 separation pairs
+    MATREC_index root = graph->nodeAt[1];
+    if(graph->lowpt2[w] >= vnum && graph->lowpt1[w] < vnum && (graph->father[v] != root || frame->outDegree >= 2)){
+        newComponent(graph,MATREC_SPLIT_POLYGON);
+        MATREC_index xnum = 0;
+        MATREC_index ynum = 0;
+        MATREC_index end = wnum + graph->descendants[w];
+        while(graph->numEStack > 0){
+            MATREC_index xy = graph->eStack[graph->numEStack - 1];
+            xnum = graph->newNumber[graph->source[xy]];
+            ynum = graph->newNumber[graph->target[xy]];
+            if(!((wnum <= xnum && xnum < end) || (wnum <= ynum && ynum < end))){
+                break;
+            }
+            --graph->numEStack;
+            addComponentEdge(graph,xy);
+            deleteHigh(graph,xy);
+            --graph->degree[graph->source[xy]];
+            --graph->degree[graph->target[xy]];
+        }
+        MATREC_index lowNode = graph->nodeAt[graph->lowpt1[w]];
+        MATREC_index virtualEdge = SPLIT_INVALID;
+        MATREC_CALL(newEdge(graph,v,lowNode,&virtualEdge));
+        finishTriangleOrRigid(graph,virtualEdge);
+
+        if((xnum == vnum && ynum == graph->lowpt1[w]) || (ynum == vnum && xnum == graph->lowpt1[w])){
+            newComponent(graph,MATREC_SPLIT_BOND);
+            MATREC_index eh = graph->eStack[--graph->numEStack];
+            if(graph->adjSlot[eh] != slot){
+                deleteSlot(graph,eh);
+            }
+            addComponentEdge(graph,eh);
+            addComponentEdge(graph,virtualEdge);
+            MATREC_CALL(newEdge(graph,v,lowNode,&virtualEdge));
+            addComponentEdge(graph,virtualEdge);
+            //The high point of the removed edge is taken over by the new virtual edge
+            graph->highSlot[virtualEdge] = graph->highSlot[eh];
+            graph->highSlot[eh] = SPLIT_INVALID;
+            --graph->degree[v];
+            --graph->degree[lowNode];
+        }
+
+        if(lowNode != graph->father[v]){
+            graph->eStack[graph->numEStack++] = virtualEdge;
+            graph->slotEdge[slot] = virtualEdge;
+            graph->adjSlot[virtualEdge] = slot;
+            if(graph->highSlot[virtualEdge] == SPLIT_INVALID && high(graph,lowNode) < vnum){
+                MATREC_index entry = graph->numHighs;
+                ++graph->numHighs;
+                graph->highValue[entry] = vnum;
+                graph->highPrevious[entry] = SPLIT_INVALID;
+                graph->highNext[entry] = graph->highFirst[lowNode];
+                if(graph->highFirst[lowNode] != SPLIT_INVALID){
+                    graph->highPrevious[graph->highFirst[lowNode]] = entry;
+                }
+                graph->highFirst[lowNode] = entry;
+                graph->highSlot[virtualEdge] = entry;
+            }
+            ++graph->degree[v];
+            ++graph->degree[lowNode];
+        }else{
+            //The separation pair is v and its father, so the tree arc to v is replaced by a bond
+            deleteSlot(graph,graph->slotEdge[slot]);
+
+            newComponent(graph,MATREC_SPLIT_BOND);
+            addComponentEdge(graph,virtualEdge);
+            MATREC_CALL(newEdge(graph,lowNode,v,&virtualEdge));
+            addComponentEdge(graph,virtualEdge);
+            MATREC_index eh = graph->treeArc[v];
+            addComponentEdge(graph,eh);
+
+            graph->treeArc[v] = virtualEdge;
+            graph->type[virtualEdge] = EDGE_TREE;
+            graph->adjSlot[virtualEdge] = graph->adjSlot[eh];
+            graph->slotEdge[graph->adjSlot[eh]] = virtualEdge;
+            graph->adjSlot[eh] = SPLIT_INVALID;
+        }
+    }
+
+    if(graph->start[e]){
+        while(tStackNotEnd(graph)){
+            --graph->tStackTop;
+        }
+        --graph->tStackTop;
+    }
+    while(tStackNotEnd(graph) && graph->tStackB[graph->tStackTop] != vnum &&
+          high(graph,v) > graph->tStackH[graph->tStackTop]){
+        --graph->tStackTop;
+    }
+    --frame->outDegree;
+    return MATREC_OKAY;
+}
+
+///Searches the paths of the palm tree and splits off the components of all separation pairs
+static MATREC_ERROR searchPaths(SplitGraph * graph){
+    graph->numEStack = 0;
+    graph->tStackTop = -1;
+    pushTStackEnd(graph);
+
+    MATREC_index root = graph->nodeAt[1];
+    MATREC_index numFrames = 1;
+    graph->frames[0].node = root;
+    graph->frames[0].slot = graph->adjFirst[root];
+    graph->frames[0].outDegree = graph->adjSize[root];
+    while(numFrames > 0){
+        PathFrame * frame = &graph->frames[numFrames - 1];
+        if(frame->slot == SPLIT_INVALID){
+            --numFrames;
+            if(numFrames > 0){
+                PathFrame * parent = &graph->frames[numFrames - 1];
+                MATREC_CALL(finishTreeArc(graph,parent));
+                parent->slot = parent->nextSlot;
+            }
+            continue;
+        }
+        MATREC_index v = frame->node;
+        MATREC_index vnum = graph->newNumber[v];
+        MATREC_index e = graph->slotEdge[frame->slot];
+        frame->nextSlot = graph->slotNext[frame->slot];
+        frame->edge = e;
+        MATREC_index w = graph->target[e];
+        MATREC_index wnum = graph->newNumber[w];
+        if(graph->type[e] == EDGE_TREE){
+            if(graph->start[e]){
+                MATREC_index y = 0;
+                if(graph->tStackA[graph->tStackTop] > graph->lowpt1[w]){
+                    MATREC_index b;
+                    do{
+                        y = maxIndex(y,graph->tStackH[graph->tStackTop]);
+                        b = graph->tStackB[graph->tStackTop];
+                        --graph->tStackTop;
+                    }while(graph->tStackA[graph->tStackTop] > graph->lowpt1[w]);
+                    pushTStack(graph,y,graph->lowpt1[w],b);
+                }else{
+                    pushTStack(graph,wnum + graph->descendants[w] - 1,graph->lowpt1[w],vnum);
+                }
+                pushTStackEnd(graph);
+            }
+            PathFrame * child = &graph->frames[numFrames];
+            child->node = w;
+            child->slot = graph->adjFirst[w];
+            child->outDegree = graph->adjSize[w];
+            ++numFrames;
+        }else{
+            if(graph->start[e]){
+                MATREC_index y = 0;
+                if(graph->tStackA[graph->tStackTop] > wnum){
+                    MATREC_index b;
+                    do{
+                        y = maxIndex(y,graph->tStackH[graph->tStackTop]);
+                        b = graph->tStackB[graph->tStackTop];
+                        --graph->tStackTop;
+                    }while(graph->tStackA[graph->tStackTop] > wnum);
+                    pushTStack(graph,y,wnum,b);
+                }else{
+                    pushTStack(graph,vnum,wnum,vnum);
+                }
+            }
+            graph->eStack[graph->numEStack++] = e;
+            frame->slot = frame->nextSlot;
+        }
+    }
+
+    //The remaining edges form the last component
+    if(graph->numEStack > 0){
+        newComponent(graph,MATREC_SPLIT_POLYGON);
+        MATREC_index component = graph->numComponents - 1;
+        while(graph->numEStack > 0){
+            addComponentEdge(graph,graph->eStack[--graph->numEStack]);
+        }
+        MATREC_index size = graph->numEntries - graph->componentStart[component];
+        graph->componentType[component] = size >= 4 ? MATREC_SPLIT_RIGID : MATREC_SPLIT_POLYGON;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_index findComponent(SplitGraph * graph, MATREC_index component){
+    MATREC_index root = component;
+    while(graph->componentRepresentative[root] != SPLIT_INVALID){
+        root = graph->componentRepresentative[root];
+    }
+    while(component != root){
+        MATREC_index next = graph->componentRepresentative[component];
+        graph->componentRepresentative[component] = root;
+        component = next;
+    }
+    return root;
+}
+
+static void unlinkEntry(SplitGraph * graph, MATREC_index component, MATREC_index entry){
+    MATREC_index previous = graph->entryPrevious[entry];
+    MATREC_index next = graph->entryNext[entry];
+    if(previous == SPLIT_INVALID){
+        graph->componentFirst[component] = next;
+    }else{
+        graph->entryNext[previous] = next;
+    }
+    if(next == SPLIT_INVALID){
+        graph->componentLast[component] = previous;
+    }else{
+        graph->entryPrevious[next] = previous;
+    }
+}
+
+///Merges bonds which share a virtual edge into a single bond, and likewise for polygons
+static void mergeComponents(SplitGraph * graph){
+    for (MATREC_index edge = 0; edge < graph->numEdges; ++edge) {
+        graph->edgeEntry1[edge] = SPLIT_INVALID;
+        graph->edgeEntry2[edge] = SPLIT_INVALID;
+    }
+    graph->componentStart[graph->numComponents] = graph->numEntries;
+    for (MATREC_index component = 0; component < graph->numComponents; ++component) {
+        MATREC_index first = graph->componentStart[component];
+        MATREC_index last = graph->componentStart[component + 1];
+        graph->componentFirst[component] = first;
+        graph->componentLast[component] = last - 1;
+        graph->componentRepresentative[component] = SPLIT_INVALID;
+        for (MATREC_index entry = first; entry < last; ++entry) {
+            graph->entryComponent[entry] = component;
+            graph->entryPrevious[entry] = entry == first ? SPLIT_INVALID : entry - 1;
+            graph->entryNext[entry] = entry + 1 == last ? SPLIT_INVALID : entry + 1;
+            MATREC_index edge = graph->entryEdge[entry];
+            if(graph->edgeEntry1[edge] == SPLIT_INVALID){
+                graph->edgeEntry1[edge] = entry;
+            }else{
+                graph->edgeEntry2[edge] = entry;
+            }
+        }
+    }
+    for (MATREC_index component = 0; component < graph->numComponents; ++component) {
+        if(graph->componentFirst[component] == SPLIT_INVALID ||
+           graph->componentType[component] == MATREC_SPLIT_RIGID){
+            continue;
+        }
+        MATREC_index entry = graph->componentFirst[component];
+        while(entry != SPLIT_INVALID){
+            MATREC_index edge = graph->entryEdge[entry];
+            MATREC_index other = graph->edgeEntry1[edge] == entry ? graph->edgeEntry2[edge] : graph->edgeEntry1[edge];
+            if(other == SPLIT_INVALID){
+                entry = graph->entryNext[entry];
+                continue;
+            }
+            MATREC_index otherComponent = findComponent(graph,graph->entryComponent[other]);
+            if(otherComponent == component ||
+               graph->componentType[otherComponent] != graph->componentType[component]){
+                entry = graph->entryNext[entry];
+                continue;
+            }
+            MATREC_index previous = graph->entryPrevious[entry];
+            unlinkEntry(graph,component,entry);
+            unlinkEntry(graph,otherComponent,other);
+
+            assert(graph->componentFirst[otherComponent] != SPLIT_INVALID);
+            graph->entryNext[graph->componentLast[component]] = graph->componentFirst[otherComponent];
+            graph->entryPrevious[graph->componentFirst[otherComponent]] = graph->componentLast[component];
+            graph->componentLast[component] = graph->componentLast[otherComponent];
+            graph->componentFirst[otherComponent] = SPLIT_INVALID;
+            graph->componentLast[otherComponent] = SPLIT_INVALID;
+            graph->componentRepresentative[otherComponent] = component;
+
+            entry = previous == SPLIT_INVALID ? graph->componentFirst[component] : graph->entryNext[previous];
+        }
+    }
+}
+
+static MATREC_ERROR reserveOutputEdges(MATREC * env, MATRECSplitComponents * components, MATREC_index size){
+    if(size > components->memEdges){
+        MATREC_index newSize = maxIndex(2 * components->memEdges, size);
+        MATREC_CALL(MATRECreallocBlockArray(env,&components->edgeTails,(size_t) newSize));
+        MATREC_CALL(MATRECreallocBlockArray(env,&components->edgeHeads,(size_t) newSize));
+        components->memEdges = newSize;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR reserveOutputComponents(MATREC * env, MATRECSplitComponents * components, MATREC_index size){
+    if(size > components->memComponents){
+        MATREC_index newSize = maxIndex(2 * components->memComponents, size);
+        MATREC_CALL(MATRECreallocBlockArray(env,&components->componentTypes,(size_t) newSize));
+        MATREC_CALL(MATRECreallocBlockArray(env,&components->componentStarts,(size_t) (newSize + 1)));
+        components->memComponents = newSize;
+    }
+    return MATREC_OKAY;
+}
+
+static MATREC_ERROR reserveOutputComponentEdges(MATREC * env, MATRECSplitComponents * components, MATREC_index size){
+    if(size > components->memComponentEdges){
+        MATREC_index newSize = maxIndex(2 * components->memComponentEdges, size);
+        MATREC_CALL(MATRECreallocBlockArray(env,&components->componentEdges,(size_t) newSize));
+        components->memComponentEdges = newSize;
+    }
+    return MATREC_OKAY;
+}
+
+///Adds a component to the output, whose edges are given by the edges of the graph
+static MATREC_ERROR outputComponent(MATREC * env, MATRECSplitComponents * components, MATRECSplitComponentType type,
+                                    const MATREC_index * edges, MATREC_index numEdges){
+    MATREC_CALL(reserveOutputComponents(env,components,components->numComponents + 1));
+    MATREC_CALL(reserveOutputComponentEdges(env,components,components->numComponentEdges + numEdges));
+    for (MATREC_index i = 0; i < numEdges; ++i) {
+        components->componentEdges[components->numComponentEdges + i] = edges[i];
+    }
+    components->numComponentEdges += numEdges;
+    components->componentTypes[components->numComponents] = type;
+    ++components->numComponents;
+    components->componentStarts[components->numComponents] = components->numComponentEdges;
+    return MATREC_OKAY;
+}
+
+///Returns the output edge of an edge of the block, which is created for virtual edges
+static MATREC_ERROR outputEdge(MATREC * env, MATRECSplitComponents * components, SplitGraph * graph,
+                               MATREC_index edge, MATREC_index * pEdge){
+    if(graph->globalEdge[edge] == SPLIT_INVALID){
+        MATREC_CALL(reserveOutputEdges(env,components,components->numEdges + 1));
+        components->edgeTails[components->numEdges] = graph->globalNode[graph->source[edge]];
+        components->edgeHeads[components->numEdges] = graph->globalNode[graph->target[edge]];
+        graph->globalEdge[edge] = components->numEdges;
+        ++components->numEdges;
+    }
+    *pEdge = graph->globalEdge[edge];
+    return MATREC_OKAY;
+}
+
+///Writes the merged components of the block to the output, with the edges of polygons in order along the cycle
+static MATREC_ERROR outputBlockComponents(MATREC * env, MATRECSplitComponents * components, SplitGraph * graph){
+    for (MATREC_index component = 0; component < graph->numComponents; ++component) {
+        if(graph->componentFirst[component] == SPLIT_INVALID){
+            continue;
+        }
+        MATREC_index numEdges = 0;
+        for (MATREC_index entry = graph->componentFirst[component]; entry != SPLIT_INVALID;
+             entry = graph->entryNext[entry]) {
+            graph->order[numEdges] = graph->entryEdge[entry];
+            ++numEdges;
+        }
+        if(graph->componentType[component] == MATREC_SPLIT_POLYGON){
+            for (MATREC_index i = 0; i < numEdges; ++i) {
+                MATREC_index edge = graph->order[i];
+                MATREC_index endpoints[2] = {graph->source[edge],graph->target[edge]};
+                for (int j = 0; j < 2; ++j) {
+                    if(graph->cycleFirst[endpoints[j]] == SPLIT_INVALID){
+                        graph->cycleFirst[endpoints[j]] = edge;
+                    }else{
+                        graph->cycleSecond[endpoints[j]] = edge;
+                    }
+                }
+            }
+            MATREC_index edge = graph->order[0];
+            MATREC_index node = graph->target[edge];
+            graph->sorted[0] = edge;
+            for (MATREC_index i = 1; i < numEdges; ++i) {
+                edge = graph->cycleFirst[node] == edge ? graph->cycleSecond[node] : graph->cycleFirst[node];
+                node = otherEndpoint(graph,edge,node);
+                graph->sorted[i] = edge;
+            }
+            for (MATREC_index i = 0; i < numEdges; ++i) {
+                graph->order[i] = graph->sorted[i];
+                graph->cycleFirst[graph->source[graph->order[i]]] = SPLIT_INVALID;
+                graph->cycleSecond[graph->source[graph->order[i]]] = SPLIT_INVALID;
+                graph->cycleFirst[graph->target[graph->order[i]]] = SPLIT_INVALID;
+                graph->cycleSecond[graph->target[graph->order[i]]] = SPLIT_INVALID;
+            }
+        }
+        for (MATREC_index i = 0; i < numEdges; ++i) {
+            MATREC_CALL(outputEdge(env,components,graph,graph->order[i],&graph->order[i]));
+        }
+        MATREC_CALL(outputComponent(env,components,graph->componentType[component],graph->order,numEdges));
+    }
+    return MATREC_OKAY;
+}
+
+///Splits a biconnected block with at least three nodes, whose edges have been stored in the graph
+static MATREC_ERROR splitBlock(MATREC * env, MATRECSplitComponents * components, SplitGraph * graph){
+    graph->numComponents = 0;
+    graph->numEntries = 0;
+    MATREC_CALL(splitMultipleEdges(graph));
+    //Virtual edges are created at most once per edge in the path search, and every edge is in at most two components
+    MATREC_CALL(reserveEdges(graph,4 * graph->numEdges + 4));
+
+    depthFirstSearch(graph);
+    buildAdjacency(graph);
+    findPaths(graph);
+
+    //Use the new numbering for the lowpoints, too
+    for (MATREC_index v = 0; v < graph->numNodes; ++v) {
+        graph->nodeAt[graph->number[v]] = v;
+    }
+    for (MATREC_index i = 1; i <= graph->numNodes; ++i) {
+        graph->position[i - 1] = graph->newNumber[graph->nodeAt[i]];
+    }
+    for (MATREC_index v = 0; v < graph->numNodes; ++v) {
+        graph->lowpt1[v] = graph->position[graph->lowpt1[v] - 1];
+        graph->lowpt2[v] = graph->position[graph->lowpt2[v] - 1];
+    }
+    for (MATREC_index v = 0; v < graph->numNodes; ++v) {
+        graph->nodeAt[graph->newNumber[v]] = v;
+    }
+
+    MATREC_CALL(searchPaths(graph));
+    mergeComponents(graph);
+    MATREC_CALL(outputBlockComponents(env,components,graph));
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECsplitComponentsCreate(MATREC * env, MATRECSplitComponents ** pComponents, MATREC_index numNodes,
+                                         MATREC_index numEdges, const MATREC_matrix_size * graphTails,
+                                         const MATREC_matrix_size * graphHeads){
+    assert(env);
+    assert(pComponents && !*pComponents);
+    assert(numNodes >= 0 && numEdges >= 0);
+    for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+        if(graphTails[edge] >= (MATREC_matrix_size) numNodes || graphHeads[edge] >= (MATREC_matrix_size) numNodes){
+            return MATREC_ERROR_INPUT;
+        }
+    }
+
+    MATREC_CALL(MATRECallocBlock(env,pComponents));
+    MATRECSplitComponents * components = *pComponents;
+    components->numNodes = numNodes;
+    components->numGraphEdges = numEdges;
+    components->numEdges = numEdges;
+    components->memEdges = maxIndex(2 * numEdges,1);
+    components->numComponents = 0;
+    components->memComponents = maxIndex(numEdges,1);
+    components->numComponentEdges = 0;
+    components->memComponentEdges = maxIndex(3 * numEdges,1);
+    MATREC_CALL(MATRECallocBlockArray(env,&components->edgeTails,(size_t) components->memEdges));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->edgeHeads,(size_t) components->memEdges));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->componentTypes,(size_t) components->memComponents));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->componentStarts,(size_t) (components->memComponents + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->componentEdges,(size_t) components->memComponentEdges));
+    components->componentStarts[0] = 0;
+    components->componentOrder = NULL;
+    components->componentParent = NULL;
+    components->componentParentEdge = NULL;
+    components->componentTreeInParent = NULL;
+    components->edgeChild = NULL;
+    for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+        components->edgeTails[edge] = (MATREC_index) graphTails[edge];
+        components->edgeHeads[edge] = (MATREC_index) graphHeads[edge];
+    }
+    //The output edges grow when virtual edges are added, so the blocks are found on a copy of the graph
+    MATREC_index * edgeTails = NULL;
+    MATREC_index * edgeHeads = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&edgeTails,(size_t) maxIndex(numEdges,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&edgeHeads,(size_t) maxIndex(numEdges,1)));
+    for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+        edgeTails[edge] = components->edgeTails[edge];
+        edgeHeads[edge] = components->edgeHeads[edge];
+    }
+
+    SplitGraph graph;
+    graph.env = env;
+    graph.memNodes = 0;
+    graph.memEdges = 0;
+    //Setting every array to NULL allows reallocating all of them
+    graph.globalNode = NULL; graph.number = NULL; graph.newNumber = NULL; graph.father = NULL; graph.treeArc = NULL;
+    graph.descendants = NULL; graph.lowpt1 = NULL; graph.lowpt2 = NULL; graph.degree = NULL; graph.nodeAt = NULL;
+    graph.firstIncidence = NULL; graph.position = NULL; graph.adjFirst = NULL; graph.adjLast = NULL;
+    graph.adjSize = NULL; graph.highFirst = NULL; graph.cycleFirst = NULL; graph.cycleSecond = NULL;
+    graph.buckets = NULL; graph.frames = NULL;
+    graph.globalEdge = NULL; graph.source = NULL; graph.target = NULL; graph.type = NULL; graph.start = NULL;
+    graph.adjSlot = NULL; graph.highSlot = NULL; graph.order = NULL; graph.sorted = NULL; graph.incidence = NULL;
+    graph.edgeEntry1 = NULL; graph.edgeEntry2 = NULL; graph.slotEdge = NULL; graph.slotNext = NULL;
+    graph.slotPrevious = NULL; graph.highValue = NULL; graph.highNext = NULL; graph.highPrevious = NULL;
+    graph.eStack = NULL; graph.tStackH = NULL; graph.tStackA = NULL; graph.tStackB = NULL;
+    graph.componentType = NULL; graph.componentStart = NULL; graph.componentFirst = NULL; graph.componentLast = NULL;
+    graph.componentRepresentative = NULL; graph.entryEdge = NULL; graph.entryComponent = NULL;
+    graph.entryNext = NULL; graph.entryPrevious = NULL;
+    MATREC_CALL(reserveNodes(&graph,maxIndex(numNodes,1)));
+    MATREC_CALL(reserveEdges(&graph,maxIndex(4 * numEdges + 4,1)));
+
+    //Find the blocks with the biconnected components algorithm of Tarjan. Self-loops are blocks by themselves
+    MATREC_index * firstIncidence = NULL;
+    MATREC_index * incidence = NULL;
+    MATREC_index * discovery = NULL;
+    MATREC_index * low = NULL;
+    MATREC_index * parentEdge = NULL;
+    MATREC_index * position = NULL;
+    MATREC_index * nodeStack = NULL;
+    MATREC_index * edgeStack = NULL;
+    MATREC_index * localNode = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&firstIncidence,(size_t) (numNodes + 1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&incidence,(size_t) maxIndex(2 * numEdges,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&discovery,(size_t) maxIndex(numNodes,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&low,(size_t) maxIndex(numNodes,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&parentEdge,(size_t) maxIndex(numNodes,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&position,(size_t) maxIndex(numNodes,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeStack,(size_t) maxIndex(numNodes,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&edgeStack,(size_t) maxIndex(numEdges,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&localNode,(size_t) maxIndex(numNodes,1)));
+
+    for (MATREC_index i = 0; i <= numNodes; ++i) {
+        firstIncidence[i] = 0;
+    }
+    for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+        if(edgeTails[edge] == edgeHeads[edge]){
+            MATREC_CALL(outputComponent(env,components,MATREC_SPLIT_POLYGON,&edge,1));
+            continue;
+        }
+        ++firstIncidence[edgeTails[edge] + 1];
+        ++firstIncidence[edgeHeads[edge] + 1];
+    }
+    for (MATREC_index i = 0; i < numNodes; ++i) {
+        firstIncidence[i + 1] += firstIncidence[i];
+        position[i] = firstIncidence[i];
+        discovery[i] = 0;
+        localNode[i] = SPLIT_INVALID;
+    }
+    for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+        if(edgeTails[edge] != edgeHeads[edge]){
+            incidence[position[edgeTails[edge]]++] = edge;
+            incidence[position[edgeHeads[edge]]++] = edge;
+        }
+    }
+    for (MATREC_index i = 0; i < numNodes; ++i) {
+        position[i] = firstIncidence[i];
+    }
+
+    MATREC_index time = 0;
+    for (MATREC_index start = 0; start < numNodes; ++start) {
+        if(discovery[start] != 0){
+            continue;
+        }
+        ++time;
+        discovery[start] = time;
+        low[start] = time;
+        parentEdge[start] = SPLIT_INVALID;
+        MATREC_index numNodeStack = 1;
+        MATREC_index numEdgeStack = 0;
+        nodeStack[0] = start;
+        while(numNodeStack > 0){
+            MATREC_index v = nodeStack[numNodeStack - 1];
+            if(position[v] < firstIncidence[v + 1]){
+                MATREC_index edge = incidence[position[v]];
+                ++position[v];
+                if(edge == parentEdge[v]){
+                    continue;
+                }
+                MATREC_index w = edgeTails[edge] == v ? edgeHeads[edge] : edgeTails[edge];
+                if(discovery[w] == 0){
+                    edgeStack[numEdgeStack++] = edge;
+                    parentEdge[w] = edge;
+                    ++time;
+                    discovery[w] = time;
+                    low[w] = time;
+                    nodeStack[numNodeStack++] = w;
+                }else if(discovery[w] < discovery[v]){
+                    edgeStack[numEdgeStack++] = edge;
+                    low[v] = minIndex(low[v],discovery[w]);
+                }
+                continue;
+            }
+            --numNodeStack;
+            if(parentEdge[v] == SPLIT_INVALID){
+                continue;
+            }
+            MATREC_index u = edgeTails[parentEdge[v]] == v ? edgeHeads[parentEdge[v]] : edgeTails[parentEdge[v]];
+            low[u] = minIndex(low[u],low[v]);
+            if(low[v] < discovery[u]){
+                continue;
+            }
+            //The edges above the tree edge to v form a block
+            graph.numNodes = 0;
+            graph.numEdges = 0;
+            MATREC_index edge;
+            do{
+                edge = edgeStack[--numEdgeStack];
+                MATREC_index endpoints[2] = {edgeTails[edge],edgeHeads[edge]};
+                for (int j = 0; j < 2; ++j) {
+                    if(localNode[endpoints[j]] == SPLIT_INVALID){
+                        localNode[endpoints[j]] = graph.numNodes;
+                        graph.globalNode[graph.numNodes] = endpoints[j];
+                        ++graph.numNodes;
+                    }
+                }
+                MATREC_index blockEdge = SPLIT_INVALID;
+                MATREC_CALL(newEdge(&graph,localNode[edgeTails[edge]],localNode[edgeHeads[edge]],&blockEdge));
+                graph.globalEdge[blockEdge] = edge;
+            }while(edge != parentEdge[v]);
+            for (MATREC_index i = 0; i < graph.numNodes; ++i) {
+                localNode[graph.globalNode[i]] = SPLIT_INVALID;
+            }
+
+            if(graph.numEdges <= 2){
+                for (MATREC_index i = 0; i < graph.numEdges; ++i) {
+                    graph.order[i] = graph.globalEdge[i];
+                }
+                MATREC_CALL(outputComponent(env,components,MATREC_SPLIT_POLYGON,graph.order,graph.numEdges));
+            }else if(graph.numNodes == 2){
+                for (MATREC_index i = 0; i < graph.numEdges; ++i) {
+                    graph.order[i] = graph.globalEdge[i];
+                }
+                MATREC_CALL(outputComponent(env,components,MATREC_SPLIT_BOND,graph.order,graph.numEdges));
+            }else{
+                MATREC_CALL(splitBlock(env,components,&graph));
+            }
+        }
+    }
+
+    MATRECfreeBlockArray(env,&localNode);
+    MATRECfreeBlockArray(env,&edgeStack);
+    MATRECfreeBlockArray(env,&nodeStack);
+    MATRECfreeBlockArray(env,&position);
+    MATRECfreeBlockArray(env,&parentEdge);
+    MATRECfreeBlockArray(env,&low);
+    MATRECfreeBlockArray(env,&discovery);
+    MATRECfreeBlockArray(env,&incidence);
+    MATRECfreeBlockArray(env,&firstIncidence);
+    MATRECfreeBlockArray(env,&edgeHeads);
+    MATRECfreeBlockArray(env,&edgeTails);
+    freeSplitGraph(&graph);
+    return MATREC_OKAY;
+}
+
+MATREC_ERROR MATRECsplitComponentsBuildTree(MATREC * env, MATRECSplitComponents * components,
+                                            const MATRECElement * edgeElements){
+    assert(env);
+    assert(components);
+    assert(!components->componentOrder);
+    MATREC_index numComponents = components->numComponents;
+    MATREC_index numEdges = components->numEdges;
+    MATREC_index numGraphEdges = components->numGraphEdges;
+    MATREC_CALL(MATRECallocBlockArray(env,&components->componentOrder,(size_t) maxIndex(numComponents,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->componentParent,(size_t) maxIndex(numComponents,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->componentParentEdge,(size_t) maxIndex(numComponents,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->componentTreeInParent,(size_t) maxIndex(numComponents,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&components->edgeChild,(size_t) maxIndex(numEdges,1)));
+
+    //The two components of each virtual edge
+    MATREC_index * edgeFirst = NULL;
+    MATREC_index * edgeSecond = NULL;
+    MATREC_index * nodeStamp = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&edgeFirst,(size_t) maxIndex(numEdges,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&edgeSecond,(size_t) maxIndex(numEdges,1)));
+    MATREC_CALL(MATRECallocBlockArray(env,&nodeStamp,(size_t) maxIndex(components->numNodes,1)));
+    for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+        edgeFirst[edge] = SPLIT_INVALID;
+        edgeSecond[edge] = SPLIT_INVALID;
+        components->edgeChild[edge] = SPLIT_INVALID;
+    }
+    for (MATREC_index node = 0; node < components->numNodes; ++node) {
+        nodeStamp[node] = SPLIT_INVALID;
+    }
+    for (MATREC_index component = 0; component < numComponents; ++component) {
+        components->componentParent[component] = SPLIT_INVALID;
+        components->componentParentEdge[component] = SPLIT_INVALID;
+        for (MATREC_index i = components->componentStarts[component]; i < components->componentStarts[component + 1]; ++i) {
+            MATREC_index edge = components->componentEdges[i];
+            if(edge < numGraphEdges){
+                continue;
+            }
+            if(edgeFirst[edge] == SPLIT_INVALID){
+                edgeFirst[edge] = component;
+            }else{
+                edgeSecond[edge] = component;
+            }
+        }
+    }
+
+    //Breadth first search over the components, where the queue is the order itself
+    MATREC_index numOrdered = 0;
+    for (MATREC_index root = 0; root < numComponents; ++root) {
+        //Components which are found from an earlier root have a parent
+        if(components->componentParent[root] != SPLIT_INVALID){
+            continue;
+        }
+        components->componentOrder[numOrdered] = root;
+        MATREC_index queueStart = numOrdered;
+        ++numOrdered;
+        while(queueStart < numOrdered){
+            MATREC_index component = components->componentOrder[queueStart];
+            ++queueStart;
+            for (MATREC_index i = components->componentStarts[component]; i < components->componentStarts[component + 1]; ++i) {
+                MATREC_index edge = components->componentEdges[i];
+                if(edge < numGraphEdges || edge == components->componentParentEdge[component]){
+                    continue;
+                }
+                MATREC_index child = edgeFirst[edge] == component ? edgeSecond[edge] : edgeFirst[edge];
+                components->componentParent[child] = component;
+                components->componentParentEdge[child] = edge;
+                components->edgeChild[edge] = child;
+                components->componentOrder[numOrdered] = child;
+                ++numOrdered;
+            }
+        }
+    }
+    assert(numOrdered == numComponents);
+
+    //Going from the leaves up, the virtual edge to the parent is a row edge in the parent if the other row edges of
+    //the component already form a spanning tree of it
+    for (MATREC_index index = numComponents - 1; index >= 0; --index) {
+        MATREC_index component = components->componentOrder[index];
+        MATREC_index numRowEdges = 0;
+        MATREC_index numNodes = 0;
+        MATREC_index start = components->componentStarts[component];
+        MATREC_index end = components->componentStarts[component + 1];
+        for (MATREC_index i = start; i < end; ++i) {
+            MATREC_index edge = components->componentEdges[i];
+            if(edge < numGraphEdges){
+                if(edgeElements[edge].isRow){
+                    ++numRowEdges;
+                }
+            }else if(edge != components->componentParentEdge[component] &&
+                     components->componentTreeInParent[components->edgeChild[edge]]){
+                ++numRowEdges;
+            }
+            if(components->componentTypes[component] == MATREC_SPLIT_RIGID){
+                MATREC_index endpoints[2] = {components->edgeTails[edge],components->edgeHeads[edge]};
+                for (int j = 0; j < 2; ++j) {
+                    if(nodeStamp[endpoints[j]] != component){
+                        nodeStamp[endpoints[j]] = component;
+                        ++numNodes;
+                    }
+                }
+            }
+        }
+        if(components->componentTypes[component] == MATREC_SPLIT_BOND){
+            numNodes = 2;
+        }else if(components->componentTypes[component] == MATREC_SPLIT_POLYGON){
+            numNodes = end - start;
+        }
+        if(components->componentParent[component] == SPLIT_INVALID){
+            components->componentTreeInParent[component] = false;
+            assert(numRowEdges == numNodes - 1 || (end - start == 1 && numRowEdges == 1));
+        }else{
+            components->componentTreeInParent[component] = numRowEdges == numNodes - 1;
+            assert(numRowEdges == numNodes - 1 || numRowEdges == numNodes - 2);
+        }
+    }
+
+    MATRECfreeBlockArray(env,&nodeStamp);
+    MATRECfreeBlockArray(env,&edgeSecond);
+    MATRECfreeBlockArray(env,&edgeFirst);
+    return MATREC_OKAY;
+}
+
+static MATREC_index findNode(MATREC_index * representative, MATREC_index node){
+    MATREC_index root = node;
+    while(representative[root] != SPLIT_INVALID){
+        root = representative[root];
+    }
+    while(node != root){
+        MATREC_index next = representative[node];
+        representative[node] = root;
+        node = next;
+    }
+    return root;
+}
+
+MATREC_ERROR MATRECcheckGraphRealization(MATREC * env, MATREC_index numNodes, MATREC_index numEdges,
+                                         const MATREC_matrix_size * edgeTails, const MATREC_matrix_size * edgeHeads,
+                                         const MATRECElement * edgeElements){
+    assert(env);
+    MATREC_matrix_size numRows = 0;
+    MATREC_matrix_size numColumns = 0;
+    for (MATREC_index edge = 0; edge < numEdges; ++edge) {
+        if(edgeTails[edge] >= (MATREC_matrix_size) numNodes || edgeHeads[edge] >= (MATREC_matrix_size) numNodes ||
+           edgeElements[edge].index >= (MATREC_matrix_size) MATREC_INDEX_MAX){
+            return MATREC_ERROR_INPUT;
+        }
+        if(edgeElements[edge].isRow){
+            numRows = edgeElements[edge].index + 1 > numRows ? edgeElements[edge].index + 1 : numRows;
+        }else{
+            numColumns = edgeElements[edge].index + 1 > numColumns ? edgeElements[edge].index + 1 : numColumns;
+        }
+    }
+    bool * rowUsed = NULL;
+    bool * columnUsed = NULL;
+    MATREC_index * representative = NULL;
+    MATREC_CALL(MATRECallocBlockArray(env,&rowUsed,(size_t) numRows + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&columnUsed,(size_t) numColumns + 1));
+    MATREC_CALL(MATRECallocBlockArray(env,&representative,(size_t) maxIndex(numNodes,1)));
+    for (MATREC_matrix_size i = 0; i < numRows; ++i) {
+        rowUsed[i] = false;
+    }
+    for (MATREC_matrix_size i = 0; i < numColumns; ++i) {
+        columnUsed[i] = false;
+    }
+    for (MATREC_index node = 0; node < numNodes; ++node) {
+        representative[node] = SPLIT_INVALID;
+    }
+
+    MATREC_ERROR result = MATREC_OKAY;
+    for (MATREC_index edge = 0; edge < numEdges && result == MATREC_OKAY; ++edge) {
+        bool * used = edgeElements[edge].isRow ? rowUsed : columnUsed;
+        if(used[edgeElements[edge].index]){
+            result = MATREC_ERROR_INPUT;
+            break;
+        }
+        used[edgeElements[edge].index] = true;
+        if(!edgeElements[edge].isRow){
+            continue;
+        }
+        MATREC_index tail = findNode(representative,(MATREC_index) edgeTails[edge]);
+        MATREC_index head = findNode(representative,(MATREC_index) edgeHeads[edge]);
+        if(tail == head){
+            result = MATREC_ERROR_INPUT;
+        }else{
+            representative[tail] = head;
+        }
+    }
+    for (MATREC_index edge = 0; edge < numEdges && result == MATREC_OKAY; ++edge) {
+        if(!edgeElements[edge].isRow && findNode(representative,(MATREC_index) edgeTails[edge]) !=
+                                        findNode(representative,(MATREC_index) edgeHeads[edge])){
+            result = MATREC_ERROR_INPUT;
+        }
+    }
+
+    MATRECfreeBlockArray(env,&representative);
+    MATRECfreeBlockArray(env,&columnUsed);
+    MATRECfreeBlockArray(env,&rowUsed);
+    return result;
+}
+
+void MATRECsplitComponentsFree(MATREC * env, MATRECSplitComponents ** pComponents){
+    assert(env);
+    assert(pComponents);
+    MATRECSplitComponents * components = *pComponents;
+    if(!components){
+        return;
+    }
+    MATRECfreeBlockArray(env,&components->edgeChild);
+    MATRECfreeBlockArray(env,&components->componentTreeInParent);
+    MATRECfreeBlockArray(env,&components->componentParentEdge);
+    MATRECfreeBlockArray(env,&components->componentParent);
+    MATRECfreeBlockArray(env,&components->componentOrder);
+    MATRECfreeBlockArray(env,&components->componentEdges);
+    MATRECfreeBlockArray(env,&components->componentStarts);
+    MATRECfreeBlockArray(env,&components->componentTypes);
+    MATRECfreeBlockArray(env,&components->edgeHeads);
+    MATRECfreeBlockArray(env,&components->edgeTails);
+    MATRECfreeBlock(env,pComponents);
+}
@@ -0,0 +1,62 @@
+#ifndef MATREC_TRICONNECTED_H
+#define MATREC_TRICONNECTED_H
+
+#include "matrec/Shared.h"
+
+///Splits an undirected multigraph into its triconnected components, in time linear in the size of the graph. Not part
+///of the public interface. Uses the path search of Hopcroft and Tarjan, with the corrections of Gutwenger and Mutzel.
+///Every block is split separately. Blocks of one or two edges, such as self-loops and bridges, form a single polygon.
+
+typedef enum{
+    MATREC_SPLIT_BOND = 0, ///Parallel edges between two nodes
+    MATREC_SPLIT_POLYGON = 1, ///A cycle, whose edges are given in order along the cycle
+    MATREC_SPLIT_RIGID = 2 ///A simple 3-connected graph
+} MATRECSplitComponentType;
+
+///Edges 0 to numGraphEdges - 1 are the edges of the graph, and each of these is in exactly one component.
+///The edges after those are virtual edges, which are each in exactly two components
+typedef struct{
+    MATREC_index numNodes;
+    MATREC_index numGraphEdges;
+    MATREC_index numEdges;
+    MATREC_index memEdges;
+    MATREC_index * edgeTails;
+    MATREC_index * edgeHeads;
+
+    MATREC_index numComponents;
+    MATREC_index memComponents;
+    MATRECSplitComponentType * componentTypes;
+    MATREC_index * componentStarts; ///The edges of component i are componentEdges[componentStarts[i]] up to componentEdges[componentStarts[i+1]]
+
+    MATREC_index numComponentEdges;
+    MATREC_index memComponentEdges;
+    MATREC_index * componentEdges;
+
+    ///The tree of the components, which is computed by MATRECsplitComponentsBuildTree()
+    MATREC_index * componentOrder; ///Every component comes after its parent
+    MATREC_index * componentParent; ///Is -1 for the first component of each block
+    MATREC_index * componentParentEdge; ///The virtual edge which the component shares with its parent
+    bool * componentTreeInParent; ///If the virtual edge to the parent is a row edge in the parent
+    MATREC_index * edgeChild; ///The component below each virtual edge, and -1 for the edges of the graph
+} MATRECSplitComponents;
+
+///Computes the triconnected components of the graph. Returns MATREC_ERROR_INPUT if an edge has an endpoint outside
+///of 0 to numNodes - 1
+MATREC_ERROR MATRECsplitComponentsCreate(MATREC * env, MATRECSplitComponents ** pComponents, MATREC_index numNodes,
+                                         MATREC_index numEdges, const MATREC_matrix_size * graphTails,
+                                         const MATREC_matrix_size * graphHeads);
+
+///Roots the components of each block at a component, and decides which virtual edges are row edges such that the row
+///edges of every component form a spanning tree of it. The row edges of the graph must form a spanning forest.
+MATREC_ERROR MATRECsplitComponentsBuildTree(MATREC * env, MATRECSplitComponents * components,
+                                            const MATRECElement * edgeElements);
+
+void MATRECsplitComponentsFree(MATREC * env, MATRECSplitComponents ** pComponents);
+
+///Returns MATREC_ERROR_INPUT unless the graph realizes a matrix: every edge must have valid endpoints and a distinct
+///element, the row edges may not contain a cycle and the endpoints of every column edge must be joined by row edges
+MATREC_ERROR MATRECcheckGraphRealization(MATREC * env, MATREC_index numNodes, MATREC_index numEdges,
+                                         const MATREC_matrix_size * edgeTails, const MATREC_matrix_size * edgeHeads,
+                                         const MATRECElement * edgeElements);
+
+#endif //MATREC_TRICONNECTED_H
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "Generators.h"
+#include <matrec/Network.h>
+#include <matrec/Graphic.h>
+
+///Counts the rows and columns in members of each type
+struct MemberTypeCounts {
+    std::size_t rigid = 0;
+    std::size_t parallel = 0;
+    std::size_t series = 0;
+};
+
+///Adds all columns of the matrix to a network and a graphic decomposition, which must both accept them
+static MemberTypeCounts addColumns(MATREC * env, const DirectedTestCase & testCase){
+    DirectedColTestCase colTestCase(testCase);
+    MATRECNetworkDecomposition * dec = NULL;
+    MATRECNetworkColumnAddition * newCol = NULL;
+    MATRECGraphicDecomposition * graphicDec = NULL;
+    MATRECGraphicColumnAddition * graphicCol = NULL;
+    EXPECT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+    EXPECT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+    EXPECT_EQ(MATRECGraphicDecompositionCreate(env,&graphicDec,testCase.rows,testCase.cols),MATREC_OKAY);
+    EXPECT_EQ(MATRECcreateGraphicColumnAddition(env,&graphicCol),MATREC_OKAY);
+    for(std::size_t col = 0; col < colTestCase.cols; ++col){
+        std::vector<MATREC_row> rows;
+        std::vector<double> values;
+        for(const auto & nonzero : colTestCase.matrix[col]){
+            rows.push_back(nonzero.index);
+            values.push_back(nonzero.value);
+        }
+        EXPECT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+        EXPECT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+        EXPECT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+        EXPECT_EQ(MATRECGraphicColumnAdditionCheck(graphicDec,graphicCol,col,rows.data(),rows.size()),MATREC_OKAY);
+        EXPECT_TRUE(MATRECGraphicColumnAdditionRemainsGraphic(graphicCol));
+        EXPECT_EQ(MATRECGraphicColumnAdditionAdd(graphicDec,graphicCol),MATREC_OKAY);
+    }
+    EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+
+    MemberTypeCounts counts;
+    for(std::size_t index = 0; index < testCase.rows + testCase.cols; ++index){
+        MATRECElement element = index < testCase.rows ? MATRECElement{MATREC_matrix_size(index),true} :
+                                MATRECElement{MATREC_matrix_size(index - testCase.rows),false};
+        MATRECMemberType type = MATRECNetworkDecompositionMemberType(dec,element);
+        EXPECT_EQ(MATRECGraphicDecompositionMemberType(graphicDec,element),type);
+        if(type == MATREC_MEMBER_RIGID){
+            ++counts.rigid;
+        }else if(type == MATREC_MEMBER_PARALLEL){
+            ++counts.parallel;
+        }else if(type == MATREC_MEMBER_SERIES){
+            ++counts.series;
+        }
+    }
+    MATRECfreeGraphicColumnAddition(env,&graphicCol);
+    MATRECGraphicDecompositionFree(&graphicDec);
+    MATRECfreeNetworkColumnAddition(env,&newCol);
+    MATRECNetworkDecompositionFree(&dec);
+    return counts;
+}
+
+///Adds all rows of the matrix to a network and a graphic decomposition, which must both accept them
+static void addRows(MATREC * env, const DirectedTestCase & testCase){
+    MATRECNetworkDecomposition * dec = NULL;
+    MATRECNetworkRowAddition * newRow = NULL;
+    MATRECGraphicDecomposition * graphicDec = NULL;
+    MATRECGraphicRowAddition * graphicRow = NULL;
+    EXPECT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+    EXPECT_EQ(MATRECcreateNetworkRowAddition(env,&newRow),MATREC_OKAY);
+    EXPECT_EQ(MATRECGraphicDecompositionCreate(env,&graphicDec,testCase.rows,testCase.cols),MATREC_OKAY);
+    EXPECT_EQ(MATRECcreateGraphicRowAddition(env,&graphicRow),MATREC_OKAY);
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        std::vector<MATREC_col> columns;
+        std::vector<double> values;
+        for(const auto & nonzero : testCase.matrix[row]){
+            columns.push_back(nonzero.index);
+            values.push_back(nonzero.value);
+        }
+        EXPECT_EQ(MATRECNetworkRowAdditionCheck(dec,newRow,row,columns.data(),values.data(),columns.size()),MATREC_OKAY);
+        EXPECT_TRUE(MATRECNetworkRowAdditionRemainsNetwork(newRow));
+        EXPECT_EQ(MATRECNetworkRowAdditionAdd(dec,newRow),MATREC_OKAY);
+        EXPECT_EQ(MATRECGraphicRowAdditionCheck(graphicDec,graphicRow,row,columns.data(),columns.size()),MATREC_OKAY);
+        EXPECT_TRUE(MATRECGraphicRowAdditionRemainsGraphic(graphicRow));
+        EXPECT_EQ(MATRECGraphicRowAdditionAdd(graphicDec,graphicRow),MATREC_OKAY);
+    }
+    EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+    MATRECfreeGraphicRowAddition(env,&graphicRow);
+    MATRECGraphicDecompositionFree(&graphicDec);
+    MATRECfreeNetworkRowAddition(env,&newRow);
+    MATRECNetworkDecompositionFree(&dec);
+}
+
+TEST(Generators,StructuredGraphs){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    const SpanningTree trees[] = {SpanningTree::RANDOM,SpanningTree::BFS,SpanningTree::DFS};
+    const TestOrdering orderings[] = {TestOrdering::ORIGINAL,TestOrdering::REVERSED,TestOrdering::SHUFFLED,
+                                      TestOrdering::SHORT_FIRST,TestOrdering::LONG_FIRST};
+    for(std::size_t seed = 0; seed < 3; ++seed){
+        for(SpanningTree tree : trees){
+            for(TestOrdering ordering : orderings){
+                auto generate = [&](const TestGraph & graph){
+                    DirectedTestCase testCase = graphToDirectedTestCase(graph,tree,seed);
+                    return reorderTestCase(testCase,ordering,ordering,seed);
+                };
+
+                DirectedTestCase grid = generate(gridGraph(8,6));
+                EXPECT_EQ(grid.rows,47);
+                EXPECT_EQ(grid.cols,35);
+                MemberTypeCounts counts = addColumns(env,grid);
+                //Only the edges at the four corners are not in the rigid member
+                EXPECT_EQ(counts.rigid,82 - 8);
+                EXPECT_EQ(counts.series,8);
+                addRows(env,grid);
+
+                DirectedTestCase wheel = generate(wheelGraph(30));
+                EXPECT_EQ(addColumns(env,wheel).rigid,60);
+                addRows(env,wheel);
+
+                DirectedTestCase planar = generate(planarTriangulationGraph(40,seed));
+                EXPECT_EQ(planar.rows + planar.cols,3 * 40 - 6);
+                EXPECT_EQ(addColumns(env,planar).rigid,3 * 40 - 6);
+                addRows(env,planar);
+
+                DirectedTestCase chain = generate(seriesParallelChainGraph(40));
+                counts = addColumns(env,chain);
+                EXPECT_EQ(counts.rigid,0);
+                EXPECT_EQ(counts.series,2 + 40);
+                EXPECT_EQ(counts.parallel,40 - 1);
+                addRows(env,chain);
+
+                DirectedTestCase components = generate(tinyComponentsGraph(30,seed));
+                counts = addColumns(env,components);
+                EXPECT_EQ(counts.rigid + counts.parallel + counts.series,components.rows + components.cols);
+                EXPECT_GT(counts.rigid,0);
+                EXPECT_GT(counts.parallel,0);
+                EXPECT_GT(counts.series,0);
+                addRows(env,components);
+            }
+        }
+    }
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Generators,SpanningTrees){
+    //The breadth first search tree of a wheel is the star at the hub, and the depth first search tree is a path
+    TestGraph wheel = wheelGraph(50);
+    DirectedTestCase star = graphToDirectedTestCase(wheel,SpanningTree::BFS,0);
+    for(std::size_t row = 0; row < star.rows; ++row){
+        EXPECT_EQ(star.matrix[row].size(),2);
+    }
+    std::size_t pathLength = 0;
+    for(const auto & row : graphToDirectedTestCase(wheel,SpanningTree::DFS,0).matrix){
+        pathLength += row.size();
+    }
+    EXPECT_GT(pathLength,10 * 2 * star.rows);
+
+    DirectedTestCase testCase = graphToDirectedTestCase(gridGraph(20,20),SpanningTree::RANDOM,0);
+    DirectedTestCase shortFirst = reorderTestCase(testCase,TestOrdering::SHORT_FIRST,TestOrdering::ORIGINAL,0);
+    for(std::size_t row = 1; row < shortFirst.rows; ++row){
+        EXPECT_LE(shortFirst.matrix[row - 1].size(),shortFirst.matrix[row].size());
+    }
+    EXPECT_EQ(toTestCase(testCase).matrix[3].size(),testCase.matrix[3].size());
+}
+
+TEST(Generators,Large){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    //A large rigid member built along long paths, and a deep chain of series and parallel members
+    DirectedTestCase grid = graphToDirectedTestCase(gridGraph(40,40),SpanningTree::DFS,1);
+    EXPECT_EQ(addColumns(env,grid).rigid,2 * 40 * 39 - 8);
+    DirectedTestCase planar = reorderTestCase(graphToDirectedTestCase(planarTriangulationGraph(2000,1),
+                                                                      SpanningTree::RANDOM,1),
+                                              TestOrdering::SHUFFLED,TestOrdering::SHUFFLED,1);
+    addRows(env,planar);
+    DirectedTestCase chain = reorderTestCase(graphToDirectedTestCase(seriesParallelChainGraph(1000),SpanningTree::BFS,1),
+                                             TestOrdering::LONG_FIRST,TestOrdering::REVERSED,1);
+    EXPECT_EQ(addColumns(env,chain).parallel,1000 - 1);
+    addRows(env,chain);
+    MATRECfreeEnvironment(&env);
+}
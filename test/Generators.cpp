@@ -0,0 +1,318 @@
+#include "Generators.h"
+
+#include <numeric>
+#include <queue>
+
+TestGraph gridGraph(std::size_t width, std::size_t height){
+    TestGraph graph{width * height, {}};
+    for(std::size_t y = 0; y < height; ++y){
+        for(std::size_t x = 0; x < width; ++x){
+            std::size_t node = y * width + x;
+            if(x + 1 < width){
+                graph.edges.push_back(Edge{.head = node + 1, .tail = node});
+            }
+            if(y + 1 < height){
+                graph.edges.push_back(Edge{.head = node + width, .tail = node});
+            }
+        }
+    }
+    return graph;
+}
+
+TestGraph wheelGraph(std::size_t spokes){
+    assert(spokes >= 3);
+    TestGraph graph{spokes + 1, {}};
+    for(std::size_t i = 1; i <= spokes; ++i){
+        graph.edges.push_back(Edge{.head = i, .tail = 0});
+        graph.edges.push_back(Edge{.head = i == spokes ? 1 : i + 1, .tail = i});
+    }
+    return graph;
+}
+
+TestGraph planarTriangulationGraph(std::size_t nodes, std::size_t seed){
+    assert(nodes >= 4);
+    std::minstd_rand gen(seed);
+    TestGraph graph{nodes, {Edge{.head = 1, .tail = 0}, Edge{.head = 2, .tail = 1}, Edge{.head = 0, .tail = 2}}};
+    struct Face{
+        std::size_t first;
+        std::size_t second;
+        std::size_t third;
+    };
+    //Both sides of the initial triangle are faces
+    std::vector<Face> faces = {{0, 1, 2}, {0, 1, 2}};
+    for(std::size_t node = 3; node < nodes; ++node){
+        //Stack the node into a random face, which keeps the graph a 3-connected triangulation
+        std::size_t index = std::uniform_int_distribution<std::size_t>(0, faces.size() - 1)(gen);
+        Face face = faces[index];
+        graph.edges.push_back(Edge{.head = node, .tail = face.first});
+        graph.edges.push_back(Edge{.head = node, .tail = face.second});
+        graph.edges.push_back(Edge{.head = node, .tail = face.third});
+        faces[index] = Face{face.first, face.second, node};
+        faces.push_back(Face{face.second, face.third, node});
+        faces.push_back(Face{face.first, face.third, node});
+    }
+    return graph;
+}
+
+TestGraph seriesParallelChainGraph(std::size_t depth){
+    TestGraph graph{2, {Edge{.head = 1, .tail = 0}}};
+    std::size_t first = 0;
+    std::size_t second = 1;
+    for(std::size_t i = 0; i < depth; ++i){
+        //Glue a triangle onto the last edge, and continue from one of its new edges
+        std::size_t node = graph.nodes++;
+        graph.edges.push_back(Edge{.head = node, .tail = first});
+        graph.edges.push_back(Edge{.head = second, .tail = node});
+        if(i % 2 == 0){
+            first = node;
+        }else{
+            second = node;
+        }
+    }
+    return graph;
+}
+
+TestGraph tinyComponentsGraph(std::size_t components, std::size_t seed){
+    std::minstd_rand gen(seed);
+    std::uniform_int_distribution<int> dist(0, 2);
+    TestGraph graph{0, {}};
+    for(std::size_t i = 0; i < components; ++i){
+        std::size_t node = graph.nodes;
+        switch(dist(gen)){
+            case 0:
+                graph.nodes += 3;
+                graph.edges.push_back(Edge{.head = node + 1, .tail = node});
+                graph.edges.push_back(Edge{.head = node + 2, .tail = node + 1});
+                graph.edges.push_back(Edge{.head = node, .tail = node + 2});
+                break;
+            case 1:
+                graph.nodes += 4;
+                for(std::size_t j = 1; j < 4; ++j){
+                    for(std::size_t k = 0; k < j; ++k){
+                        graph.edges.push_back(Edge{.head = node + j, .tail = node + k});
+                    }
+                }
+                break;
+            default:
+                graph.nodes += 2;
+                for(std::size_t j = 0; j < 3; ++j){
+                    graph.edges.push_back(Edge{.head = node + 1, .tail = node});
+                }
+                break;
+        }
+    }
+    return graph;
+}
+
+///Returns for every edge whether it is in the spanning tree
+static std::vector<bool> spanningTree(const TestGraph & graph, SpanningTree tree, std::minstd_rand & gen){
+    std::vector<bool> inTree(graph.edges.size(), false);
+    if(tree == SpanningTree::RANDOM){
+        std::vector<std::size_t> order(graph.edges.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), gen);
+        std::vector<int> nodeRepresentative(graph.nodes, -1);
+        for(std::size_t edge : order){
+            int firstRep = findRepresentative(graph.edges[edge].head, nodeRepresentative);
+            int secondRep = findRepresentative(graph.edges[edge].tail, nodeRepresentative);
+            if(firstRep != secondRep){
+                makeUnion(nodeRepresentative, firstRep, secondRep);
+                inTree[edge] = true;
+            }
+        }
+        return inTree;
+    }
+    std::vector<std::vector<std::size_t>> adjacentEdges(graph.nodes);
+    for(std::size_t edge = 0; edge < graph.edges.size(); ++edge){
+        adjacentEdges[graph.edges[edge].head].push_back(edge);
+        adjacentEdges[graph.edges[edge].tail].push_back(edge);
+    }
+    std::vector<bool> visited(graph.nodes, false);
+    for(std::size_t root = 0; root < graph.nodes; ++root){
+        if(visited[root]) continue;
+        visited[root] = true;
+        if(tree == SpanningTree::BFS){
+            std::queue<std::size_t> queue;
+            queue.push(root);
+            while(!queue.empty()){
+                std::size_t node = queue.front();
+                queue.pop();
+                for(std::size_t edge : adjacentEdges[node]){
+                    std::size_t other = graph.edges[edge].head == node ? graph.edges[edge].tail : graph.edges[edge].head;
+                    if(!visited[other]){
+                        visited[other] = true;
+                        inTree[edge] = true;
+                        queue.push(other);
+                    }
+                }
+            }
+        }else{
+            struct CallStackInfo{
+                std::size_t node;
+                std::size_t adjacencyPos;
+            };
+            std::vector<CallStackInfo> callStack = {{root, 0}};
+            while(!callStack.empty()){
+                CallStackInfo & info = callStack.back();
+                if(info.adjacencyPos == adjacentEdges[info.node].size()){
+                    callStack.pop_back();
+                    continue;
+                }
+                std::size_t edge = adjacentEdges[info.node][info.adjacencyPos];
+                ++info.adjacencyPos;
+                std::size_t other = graph.edges[edge].head == info.node ? graph.edges[edge].tail : graph.edges[edge].head;
+                if(!visited[other]){
+                    visited[other] = true;
+                    inTree[edge] = true;
+                    callStack.push_back({other, 0});
+                }
+            }
+        }
+    }
+    return inTree;
+}
+
+DirectedTestCase graphToDirectedTestCase(const TestGraph & graph, SpanningTree tree, std::size_t seed){
+    std::minstd_rand gen(seed);
+    std::vector<Edge> arcs = graph.edges;
+    std::bernoulli_distribution flip(0.5);
+    for(Edge & arc : arcs){
+        if(flip(gen)){
+            std::swap(arc.head, arc.tail);
+        }
+    }
+    TestGraph directed{graph.nodes, arcs};
+    std::vector<bool> inTree = spanningTree(directed, tree, gen);
+
+    std::vector<std::vector<std::size_t>> treeArcs(graph.nodes);
+    std::vector<MATREC_row> arcRow(arcs.size(), 0);
+    std::size_t numRows = 0;
+    for(std::size_t arc = 0; arc < arcs.size(); ++arc){
+        if(!inTree[arc]) continue;
+        arcRow[arc] = numRows++;
+        treeArcs[arcs[arc].head].push_back(arc);
+        treeArcs[arcs[arc].tail].push_back(arc);
+    }
+
+    //Root every tree, so that the fundamental cycles can be found by walking up to the common ancestor
+    const std::size_t noArc = arcs.size();
+    std::vector<std::size_t> parentArc(graph.nodes, noArc);
+    std::vector<std::size_t> depth(graph.nodes, 0);
+    std::vector<bool> visited(graph.nodes, false);
+    std::vector<std::size_t> stack;
+    for(std::size_t root = 0; root < graph.nodes; ++root){
+        if(visited[root]) continue;
+        visited[root] = true;
+        stack.push_back(root);
+        while(!stack.empty()){
+            std::size_t node = stack.back();
+            stack.pop_back();
+            for(std::size_t arc : treeArcs[node]){
+                std::size_t other = arcs[arc].head == node ? arcs[arc].tail : arcs[arc].head;
+                if(!visited[other]){
+                    visited[other] = true;
+                    parentArc[other] = arc;
+                    depth[other] = depth[node] + 1;
+                    stack.push_back(other);
+                }
+            }
+        }
+    }
+    auto parent = [&](std::size_t node){
+        const Edge & arc = arcs[parentArc[node]];
+        return arc.head == node ? arc.tail : arc.head;
+    };
+
+    std::vector<std::vector<Nonzero>> matrix(numRows);
+    MATREC_col column = 0;
+    for(std::size_t arc = 0; arc < arcs.size(); ++arc){
+        if(inTree[arc]) continue;
+        //The cycle runs along the tree from the tail to the head of the arc; tree arcs in that direction are positive
+        std::size_t source = arcs[arc].tail;
+        std::size_t target = arcs[arc].head;
+        while(source != target){
+            if(depth[source] >= depth[target]){
+                std::size_t treeArc = parentArc[source];
+                double value = arcs[treeArc].tail == source ? 1.0 : -1.0;
+                matrix[arcRow[treeArc]].push_back(Nonzero{.index = column, .value = value});
+                source = parent(source);
+            }else{
+                std::size_t treeArc = parentArc[target];
+                double value = arcs[treeArc].head == target ? 1.0 : -1.0;
+                matrix[arcRow[treeArc]].push_back(Nonzero{.index = column, .value = value});
+                target = parent(target);
+            }
+        }
+        ++column;
+    }
+    return {matrix, numRows, column};
+}
+
+///Returns the new index of every row or column
+static std::vector<MATREC_matrix_size> ordering(const std::vector<std::size_t> & lengths, TestOrdering order,
+                                               std::minstd_rand & gen){
+    std::vector<MATREC_matrix_size> byPosition(lengths.size());
+    std::iota(byPosition.begin(), byPosition.end(), 0);
+    switch(order){
+        case TestOrdering::ORIGINAL:
+            break;
+        case TestOrdering::REVERSED:
+            std::reverse(byPosition.begin(), byPosition.end());
+            break;
+        case TestOrdering::SHUFFLED:
+            std::shuffle(byPosition.begin(), byPosition.end(), gen);
+            break;
+        case TestOrdering::SHORT_FIRST:
+            std::stable_sort(byPosition.begin(), byPosition.end(), [&](MATREC_matrix_size first, MATREC_matrix_size second){
+                return lengths[first] < lengths[second];
+            });
+            break;
+        case TestOrdering::LONG_FIRST:
+            std::stable_sort(byPosition.begin(), byPosition.end(), [&](MATREC_matrix_size first, MATREC_matrix_size second){
+                return lengths[first] > lengths[second];
+            });
+            break;
+    }
+    std::vector<MATREC_matrix_size> newIndex(lengths.size());
+    for(std::size_t position = 0; position < byPosition.size(); ++position){
+        newIndex[byPosition[position]] = position;
+    }
+    return newIndex;
+}
+
+DirectedTestCase reorderTestCase(const DirectedTestCase & testCase, TestOrdering rowOrder, TestOrdering columnOrder,
+                                 std::size_t seed){
+    std::minstd_rand gen(seed);
+    std::vector<std::size_t> rowLengths(testCase.rows);
+    std::vector<std::size_t> columnLengths(testCase.cols, 0);
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        rowLengths[row] = testCase.matrix[row].size();
+        for(const Nonzero & nonzero : testCase.matrix[row]){
+            ++columnLengths[nonzero.index];
+        }
+    }
+    std::vector<MATREC_matrix_size> newRow = ordering(rowLengths, rowOrder, gen);
+    std::vector<MATREC_matrix_size> newColumn = ordering(columnLengths, columnOrder, gen);
+
+    std::vector<std::vector<Nonzero>> matrix(testCase.rows);
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        std::vector<Nonzero> & nonzeros = matrix[newRow[row]];
+        for(const Nonzero & nonzero : testCase.matrix[row]){
+            nonzeros.push_back(Nonzero{.index = newColumn[nonzero.index], .value = nonzero.value});
+        }
+        std::sort(nonzeros.begin(), nonzeros.end(), [](const Nonzero & first, const Nonzero & second){
+            return first.index < second.index;
+        });
+    }
+    return {matrix, testCase.rows, testCase.cols};
+}
+
+TestCase toTestCase(const DirectedTestCase & testCase, std::size_t seed){
+    std::vector<std::vector<MATREC_col>> matrix(testCase.rows);
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        for(const Nonzero & nonzero : testCase.matrix[row]){
+            matrix[row].push_back(nonzero.index);
+        }
+    }
+    return {matrix, testCase.rows, testCase.cols, seed};
+}
@@ -0,0 +1,56 @@
+#ifndef MATREC_GENERATORS_H
+#define MATREC_GENERATORS_H
+
+#include "TestHelpers.h"
+
+///Structured graphs for stress tests and benchmarks. Each graph is turned into a (network) matrix by picking a
+///spanning tree: the tree edges are the rows, and the remaining edges are the columns whose nonzeros form the
+///fundamental cycle of the edge. The undirected variants are obtained with toTestCase().
+
+struct TestGraph {
+    std::size_t nodes;
+    std::vector<Edge> edges; ///Arcs go from tail to head in the directed variant
+};
+
+///A width x height grid. Apart from the four corners, which lie in small series members, this is one large rigid member
+TestGraph gridGraph(std::size_t width, std::size_t height);
+
+///A wheel with the given number of spokes (at least 3), which is a single rigid member
+TestGraph wheelGraph(std::size_t spokes);
+
+///A random stacked triangulation, which is a random 3-connected planar graph on the given number of nodes (at least 4)
+TestGraph planarTriangulationGraph(std::size_t nodes, std::size_t seed);
+
+///A strip of triangles glued along edges. Its decomposition is a chain of alternating series and parallel members of
+///the given depth
+TestGraph seriesParallelChainGraph(std::size_t depth);
+
+///Many disjoint copies of tiny graphs: triangles (series), K4's (rigid) and triples of parallel edges (parallel)
+TestGraph tinyComponentsGraph(std::size_t components, std::size_t seed);
+
+enum class SpanningTree {
+    RANDOM, ///A random spanning tree
+    BFS,    ///A breadth first search tree from the first node, which is shallow
+    DFS     ///A depth first search tree from the first node, which has long paths
+};
+
+///Creates the network matrix of the graph with respect to the given spanning tree. The seed is used for the random
+///spanning tree and to randomly flip the direction of the arcs
+DirectedTestCase graphToDirectedTestCase(const TestGraph & graph, SpanningTree tree, std::size_t seed);
+
+enum class TestOrdering {
+    ORIGINAL,
+    REVERSED,
+    SHUFFLED,
+    SHORT_FIRST, ///By increasing number of nonzeros
+    LONG_FIRST   ///By decreasing number of nonzeros
+};
+
+///Renumbers the rows and the columns, which changes the order in which they are added when iterating over them
+DirectedTestCase reorderTestCase(const DirectedTestCase & testCase, TestOrdering rowOrder, TestOrdering columnOrder,
+                                 std::size_t seed);
+
+///Drops the signs of a directed test case
+TestCase toTestCase(const DirectedTestCase & testCase, std::size_t seed = 0);
+
+#endif //MATREC_GENERATORS_H
@@ -57,10 +57,13 @@ namespace GraphicTest {
         MATREC_CALL(MATRECcreateEnvironment(&env));
         MATRECGraphicDecomposition *dec = NULL;
         MATREC_CALL(MATRECGraphicDecompositionCreate(env, &dec, testCase.rows, testCase.cols));
+        //The row and column additions share their scratch memory, as they are interleaved
+        MATRECGraphicAdditionScratch *scratch = NULL;
+        MATREC_CALL(MATRECcreateGraphicAdditionScratch(env, &scratch));
         MATRECGraphicRowAddition *newRow = NULL;
-        MATREC_CALL(MATRECcreateGraphicRowAddition(env, &newRow));
+        MATREC_CALL(MATRECcreateGraphicRowAdditionWithScratch(env, &newRow, scratch));
         MATRECGraphicColumnAddition *newCol = NULL;
-        MATREC_CALL(MATRECcreateGraphicColumnAddition(env, &newCol));
+        MATREC_CALL(MATRECcreateGraphicColumnAdditionWithScratch(env, &newCol, scratch));
 
         std::vector<std::vector<MATREC_row>> column_cycles(testCase.cols, std::vector<MATREC_row>());
 
@@ -162,6 +165,7 @@ namespace GraphicTest {
         }
         MATRECfreeGraphicColumnAddition(env, &newCol);
         MATRECfreeGraphicRowAddition(env, &newRow);
+        MATRECfreeGraphicAdditionScratch(env, &scratch);
         MATRECGraphicDecompositionFree(&dec);
         MATREC_CALL(MATRECfreeEnvironment(&env));
         return MATREC_OKAY;
@@ -278,4 +282,467 @@ namespace GraphicTest {
     {
         randomlySample(7,7,100'000,19);
     }
+
+    TEST(GraphicColAddition,DuplicateColumns){
+        //Copies of earlier columns are placed in parallel after comparing them with the fundamental cycles
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            TestCase testCase = createErdosRenyiTestcase(20,0.3,seed);
+            ColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECGraphicDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&dec,testCase.rows,2 * testCase.cols),MATREC_OKAY);
+            MATRECGraphicColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+
+            std::vector<std::vector<MATREC_row>> addedColumns;
+            auto addColumn = [&](const std::vector<MATREC_row> & column){
+                ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,addedColumns.size(),column.data(),column.size()),
+                          MATREC_OKAY);
+                ASSERT_TRUE(MATRECGraphicColumnAdditionRemainsGraphic(newCol));
+                ASSERT_EQ(MATRECGraphicColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+                addedColumns.push_back(column);
+            };
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                addColumn(colTestCase.matrix[col]);
+                if(rng() % 2 == 0){
+                    std::vector<MATREC_row> duplicate = addedColumns[rng() % addedColumns.size()];
+                    std::shuffle(duplicate.begin(),duplicate.end(),rng);
+                    addColumn(duplicate);
+                }
+            }
+            EXPECT_TRUE(MATRECGraphicDecompositionIsMinimal(dec));
+
+            std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+            for(std::size_t col = 0; col < addedColumns.size(); ++col){
+                std::vector<MATREC_row> rows = addedColumns[col];
+                EXPECT_TRUE(MATRECGraphicDecompositionVerifyCycle(dec,col,rows.data(),rows.size(),rowStorage.data()));
+            }
+            MATRECfreeGraphicColumnAddition(env,&newCol);
+            MATRECGraphicDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+    TEST(GraphicColAddition,RepeatedChecks){
+        //The ancestor index which is built by the repeated checks is repaired by each addition
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            TestCase testCase = createErdosRenyiTestcase(20,0.3,seed);
+            ColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECGraphicDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&dec,testCase.rows,2 * testCase.cols),MATREC_OKAY);
+            MATRECGraphicColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+            std::vector<MATREC_row> randomRows;
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                //A random column, which is checked but never added
+                randomRows.clear();
+                for(std::size_t row = 0; row < testCase.rows; ++row){
+                    if(rng() % 4 == 0){
+                        randomRows.push_back(row);
+                    }
+                }
+                ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,colTestCase.cols + col,randomRows.data(),
+                                                           randomRows.size()),MATREC_OKAY);
+                bool randomIsGraphic = MATRECGraphicColumnAdditionRemainsGraphic(newCol);
+                for(int repetition = 0; repetition < 10; ++repetition){
+                    ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,colTestCase.cols + col,randomRows.data(),
+                                                               randomRows.size()),MATREC_OKAY);
+                    EXPECT_EQ(MATRECGraphicColumnAdditionRemainsGraphic(newCol),randomIsGraphic);
+                }
+
+                const std::vector<MATREC_row> & rows = colTestCase.matrix[col];
+                ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,col,rows.data(),rows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECGraphicColumnAdditionRemainsGraphic(newCol));
+                ASSERT_EQ(MATRECGraphicColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+            }
+            EXPECT_TRUE(MATRECGraphicDecompositionIsMinimal(dec));
+
+            std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                std::vector<MATREC_row> rows = colTestCase.matrix[col];
+                EXPECT_TRUE(MATRECGraphicDecompositionVerifyCycle(dec,col,rows.data(),rows.size(),rowStorage.data()));
+            }
+            MATRECfreeGraphicColumnAddition(env,&newCol);
+            MATRECGraphicDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+    TEST(GraphicColAddition,SparseHashedIds){
+        //Rows and columns get large, sparse ids, which hashed storage maps without growing to the largest id
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            TestCase testCase = createErdosRenyiTestcase(20,0.3,seed);
+            ColTestCase colTestCase(testCase);
+            const MATREC_matrix_size idOffset = MATREC_matrix_size(1) << 30;
+            const MATREC_matrix_size idStride = 1'000'003;
+            auto rowId = [&](MATREC_row row){ return idOffset + row * idStride; };
+            auto columnId = [&](MATREC_col col){ return idOffset + col * idStride + 7; };
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECGraphicDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreateWithStorage(env,&dec,0,0,MATREC_IDS_HASHED,MATREC_IDS_HASHED),
+                      MATREC_OKAY);
+            MATRECGraphicColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+            std::vector<MATREC_row> rows;
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                rows.clear();
+                for(MATREC_row row : colTestCase.matrix[col]){
+                    rows.push_back(rowId(row));
+                }
+                ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,columnId(col),rows.data(),rows.size()),
+                          MATREC_OKAY);
+                ASSERT_TRUE(MATRECGraphicColumnAdditionRemainsGraphic(newCol));
+                ASSERT_EQ(MATRECGraphicColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+                EXPECT_TRUE(MATRECGraphicDecompositionContainsColumn(dec,columnId(col)));
+                EXPECT_FALSE(MATRECGraphicDecompositionContainsColumn(dec,columnId(col) + 1));
+            }
+            EXPECT_TRUE(MATRECGraphicDecompositionIsMinimal(dec));
+            for(std::size_t row = 0; row < testCase.rows; ++row){
+                bool inColumn = std::any_of(colTestCase.matrix.begin(),colTestCase.matrix.end(),
+                                            [&](const std::vector<MATREC_row> & column){
+                    return std::find(column.begin(),column.end(),row) != column.end();
+                });
+                EXPECT_EQ(MATRECGraphicDecompositionContainsRow(dec,rowId(row)),inColumn);
+                EXPECT_FALSE(MATRECGraphicDecompositionContainsRow(dec,row));
+            }
+
+            std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                rows.clear();
+                for(MATREC_row row : colTestCase.matrix[col]){
+                    rows.push_back(rowId(row));
+                }
+                EXPECT_TRUE(MATRECGraphicDecompositionVerifyCycle(dec,columnId(col),rows.data(),rows.size(),
+                                                                  rowStorage.data()));
+            }
+            //A dense mapping would need memory for about 2^30 ids
+            MATRECMemoryReport report;
+            MATRECGraphicDecompositionMemory(dec,&report);
+            EXPECT_LT(report.allocatedBytes,1'000'000);
+
+            MATRECfreeGraphicColumnAddition(env,&newCol);
+            MATRECGraphicDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+    TEST(GraphicColAddition,FlattenKeepsResults){
+        //Flattening only shortens the union-find paths, so flattening after every addition, or automatically, gives the
+        //same results as not flattening at all
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            TestCase testCase = createErdosRenyiTestcase(20,0.3,seed);
+            ColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+            //Each graphic column is followed by a random column, which is only added if it keeps the matrix graphic
+            std::vector<std::vector<MATREC_row>> columns;
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                columns.push_back(colTestCase.matrix[col]);
+                std::vector<MATREC_row> randomRows;
+                for(std::size_t row = 0; row < testCase.rows; ++row){
+                    if(rng() % 4 == 0){
+                        randomRows.push_back(row);
+                    }
+                }
+                columns.push_back(randomRows);
+            }
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            std::vector<bool> expectedResults;
+            for(int flattening = 0; flattening < 3; ++flattening){
+                MATRECGraphicDecomposition * dec = NULL;
+                ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&dec,testCase.rows,columns.size()),MATREC_OKAY);
+                if(flattening == 1){
+                    MATRECGraphicDecompositionSetAutoFlatten(dec,0.05);
+                }
+                MATRECGraphicColumnAddition * newCol = NULL;
+                ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+                std::vector<bool> results;
+                for(std::size_t col = 0; col < columns.size(); ++col){
+                    ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,col,columns[col].data(),columns[col].size()),
+                              MATREC_OKAY);
+                    results.push_back(MATRECGraphicColumnAdditionRemainsGraphic(newCol));
+                    if(results.back()){
+                        ASSERT_EQ(MATRECGraphicColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+                        if(flattening == 2){
+                            MATRECGraphicDecompositionFlatten(dec);
+                        }
+                    }
+                }
+                if(flattening == 0){
+                    expectedResults = results;
+                    EXPECT_NE(std::count(results.begin(),results.end(),false),0);
+                }else{
+                    EXPECT_EQ(results,expectedResults);
+                }
+                EXPECT_TRUE(MATRECGraphicDecompositionIsMinimal(dec));
+
+                std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+                for(std::size_t col = 0; col < columns.size(); ++col){
+                    EXPECT_EQ(MATRECGraphicDecompositionContainsColumn(dec,col),bool(results[col]));
+                    if(results[col]){
+                        std::vector<MATREC_row> rows = columns[col];
+                        EXPECT_TRUE(MATRECGraphicDecompositionVerifyCycle(dec,col,rows.data(),rows.size(),
+                                                                          rowStorage.data()));
+                    }
+                }
+                MATRECfreeGraphicColumnAddition(env,&newCol);
+                MATRECGraphicDecompositionFree(&dec);
+            }
+            MATRECfreeEnvironment(&env);
+        }
+    }
+    TEST(GraphicQueries,ComponentsAndTypes){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            TestCase testCase = createErdosRenyiTestcase(25,0.08,seed);
+            ColTestCase colTestCase(testCase);
+            MATRECGraphicDecomposition * dec = NULL;
+            MATRECGraphicColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+            ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+
+            //Components of the added columns and their rows, where column i is element rows + i
+            std::vector<int> representative(testCase.rows + testCase.cols,-1);
+            auto element = [&](std::size_t index){
+                return index < testCase.rows ? MATRECElement{MATREC_matrix_size(index),true} : MATRECElement{MATREC_matrix_size(index - testCase.rows),false};
+            };
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                const std::vector<MATREC_row> & rows = colTestCase.matrix[col];
+                for(MATREC_row row : rows){
+                    int first = findRepresentative(int(row),representative);
+                    int second = findRepresentative(int(testCase.rows + col),representative);
+                    if(first != second){
+                        makeUnion(representative,first,second);
+                    }
+                }
+                ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,col,rows.data(),rows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECGraphicColumnAdditionRemainsGraphic(newCol));
+                ASSERT_EQ(MATRECGraphicColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+
+                const MATRECGraphicDecomposition * query = dec;
+                for(std::size_t first = 0; first < representative.size(); ++first){
+                    MATRECElement firstElement = element(first);
+                    bool contained = firstElement.isRow ? MATRECGraphicDecompositionContainsRow(query,firstElement.index) :
+                                     MATRECGraphicDecompositionContainsColumn(query,firstElement.index);
+                    EXPECT_EQ(MATRECGraphicDecompositionMemberType(query,firstElement) == MATREC_MEMBER_NOT_CONTAINED,
+                              !contained);
+                    for(std::size_t second = first; second < representative.size(); ++second){
+                        MATRECElement secondElement = element(second);
+                        bool secondContained = secondElement.isRow ?
+                                MATRECGraphicDecompositionContainsRow(query,secondElement.index) :
+                                MATRECGraphicDecompositionContainsColumn(query,secondElement.index);
+                        bool expected = contained && secondContained &&
+                                        findRepresentative(int(first),representative) ==
+                                        findRepresentative(int(second),representative);
+                        EXPECT_EQ(MATRECGraphicDecompositionSameComponent(query,firstElement,secondElement),expected);
+                    }
+                }
+            }
+            MATRECfreeGraphicColumnAddition(env,&newCol);
+            MATRECGraphicDecompositionFree(&dec);
+        }
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(GraphicQueries,CreateMatrix){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            TestCase testCase = createErdosRenyiTestcase(30,seed % 2 == 0 ? 0.05 : 0.2,seed);
+            ColTestCase colTestCase(testCase);
+            MATRECGraphicDecomposition * dec = NULL;
+            MATRECGraphicColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+            ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+
+            std::vector<MATRECIntMatrixTriplet> expected;
+            MATREC_matrix_size largestRow = 0;
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                const std::vector<MATREC_row> & rows = colTestCase.matrix[col];
+                for(MATREC_row row : rows){
+                    expected.push_back({row,MATREC_col(col),1});
+                    largestRow = std::max(largestRow,row + 1);
+                }
+                ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,col,rows.data(),rows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECGraphicColumnAdditionRemainsGraphic(newCol));
+                ASSERT_EQ(MATRECGraphicColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+            }
+            std::sort(expected.begin(),expected.end(),[](const MATRECIntMatrixTriplet& a, const MATRECIntMatrixTriplet& b){
+                return a.row < b.row || (a.row == b.row && a.column < b.column);
+            });
+
+            MATRECCSMatrixInt * matrix = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreateMatrix(dec,&matrix),MATREC_OKAY);
+            ASSERT_EQ(matrix->numRows,largestRow);
+            ASSERT_EQ(matrix->numNonzeros,expected.size());
+            for(MATREC_row row = 0; row < matrix->numRows; ++row){
+                for(MATREC_matrix_size i = matrix->firstRowIndex[row]; i < matrix->firstRowIndex[row + 1]; ++i){
+                    EXPECT_EQ(expected[i].row,row);
+                    EXPECT_EQ(expected[i].column,matrix->entryColumns[i]);
+                    EXPECT_EQ(matrix->entryValues[i],1);
+                }
+            }
+            MATRECfreeIntMatrix(env,&matrix);
+            MATRECfreeGraphicColumnAddition(env,&newCol);
+            MATRECGraphicDecompositionFree(&dec);
+        }
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(GraphicQueries,CreateFromGraph){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        std::size_t numRigid = 0;
+        for(std::size_t seed = 0; seed < 60; ++seed){
+            //A random graph, whose row edges form a spanning forest with some isolated nodes
+            std::minstd_rand gen(seed);
+            std::size_t numNodes = 2 + seed % 25;
+            std::vector<std::size_t> parent(numNodes,0);
+            std::vector<std::size_t> depth(numNodes,0);
+            std::vector<std::size_t> root(numNodes,0);
+            std::vector<MATREC_matrix_size> tails;
+            std::vector<MATREC_matrix_size> heads;
+            std::vector<MATRECElement> elements;
+            std::vector<MATREC_row> parentRow(numNodes,0);
+            for(std::size_t node = 0; node < numNodes; ++node){
+                root[node] = node;
+                if(node == 0 || gen() % 10 == 0){
+                    continue;
+                }
+                std::size_t other = gen() % node;
+                parent[node] = other;
+                depth[node] = depth[other] + 1;
+                root[node] = root[other];
+                parentRow[node] = tails.size();
+                tails.push_back(node);
+                heads.push_back(other);
+                elements.push_back({parentRow[node],true});
+            }
+            std::size_t numRows = tails.size();
+            std::size_t numColumns = numNodes * (1 + seed % 3);
+            std::vector<std::vector<MATREC_row>> columns;
+            for(std::size_t col = 0; col < numColumns; ++col){
+                std::size_t tail = gen() % numNodes;
+                std::size_t head = gen() % numNodes;
+                if(root[head] != root[tail]){
+                    head = root[tail];
+                }
+                //The rows on the path between the endpoints in the forest
+                std::vector<MATREC_row> column;
+                std::size_t first = tail;
+                std::size_t second = head;
+                while(first != second){
+                    std::size_t & deeper = depth[first] >= depth[second] ? first : second;
+                    column.push_back(parentRow[deeper]);
+                    deeper = parent[deeper];
+                }
+                columns.push_back(column);
+                tails.push_back(tail);
+                heads.push_back(head);
+                elements.push_back({MATREC_matrix_size(col),false});
+            }
+            //Mix the rows and columns
+            std::vector<std::size_t> order(tails.size());
+            std::iota(order.begin(),order.end(),0);
+            std::shuffle(order.begin(),order.end(),gen);
+            std::vector<MATREC_matrix_size> shuffledTails;
+            std::vector<MATREC_matrix_size> shuffledHeads;
+            std::vector<MATRECElement> shuffledElements;
+            for(std::size_t index : order){
+                shuffledTails.push_back(tails[index]);
+                shuffledHeads.push_back(heads[index]);
+                shuffledElements.push_back(elements[index]);
+            }
+
+            MATRECGraphicDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreateFromGraph(env,&dec,numNodes,shuffledTails.size(),
+                                                                shuffledTails.data(),shuffledHeads.data(),
+                                                                shuffledElements.data()),MATREC_OKAY);
+            EXPECT_TRUE(MATRECGraphicDecompositionIsMinimal(dec));
+
+            //The same matrix, built one column at a time
+            MATRECGraphicDecomposition * incremental = NULL;
+            MATRECGraphicColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&incremental,numRows,numColumns),MATREC_OKAY);
+            ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+            std::vector<MATRECIntMatrixTriplet> expected;
+            std::vector<bool> rowUsed(numRows,false);
+            for(std::size_t col = 0; col < numColumns; ++col){
+                for(MATREC_row row : columns[col]){
+                    rowUsed[row] = true;
+                    expected.push_back({row,MATREC_col(col),1});
+                }
+                ASSERT_EQ(MATRECGraphicColumnAdditionCheck(incremental,newCol,col,columns[col].data(),
+                                                           columns[col].size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECGraphicColumnAdditionRemainsGraphic(newCol));
+                ASSERT_EQ(MATRECGraphicColumnAdditionAdd(incremental,newCol),MATREC_OKAY);
+            }
+            std::sort(expected.begin(),expected.end(),[](const MATRECIntMatrixTriplet& a, const MATRECIntMatrixTriplet& b){
+                return a.row < b.row || (a.row == b.row && a.column < b.column);
+            });
+
+            MATRECCSMatrixInt * matrix = NULL;
+            ASSERT_EQ(MATRECGraphicDecompositionCreateMatrix(dec,&matrix),MATREC_OKAY);
+            ASSERT_EQ(matrix->numRows,numRows);
+            ASSERT_EQ(matrix->numNonzeros,expected.size());
+            for(MATREC_row row = 0; row < matrix->numRows; ++row){
+                for(MATREC_matrix_size i = matrix->firstRowIndex[row]; i < matrix->firstRowIndex[row + 1]; ++i){
+                    EXPECT_EQ(expected[i].row,row);
+                    EXPECT_EQ(expected[i].column,matrix->entryColumns[i]);
+                    EXPECT_EQ(matrix->entryValues[i],1);
+                }
+            }
+            MATRECfreeIntMatrix(env,&matrix);
+
+            //Rows without nonzeros are bridges of the graph, which form a loop by themselves
+            auto element = [&](std::size_t index){
+                return index < numRows ? MATRECElement{MATREC_matrix_size(index),true} : MATRECElement{MATREC_matrix_size(index - numRows),false};
+            };
+            auto isBridge = [&](std::size_t index){
+                return index < numRows && !rowUsed[index];
+            };
+            for(std::size_t first = 0; first < numRows + numColumns; ++first){
+                MATRECMemberType type = MATRECGraphicDecompositionMemberType(dec,element(first));
+                EXPECT_EQ(type,isBridge(first) ? MATREC_MEMBER_LOOP :
+                               MATRECGraphicDecompositionMemberType(incremental,element(first)));
+                numRigid += type == MATREC_MEMBER_RIGID;
+                for(std::size_t second = 0; second < numRows + numColumns; ++second){
+                    bool same = MATRECGraphicDecompositionSameComponent(dec,element(first),element(second));
+                    if(isBridge(first) || isBridge(second)){
+                        EXPECT_EQ(same,first == second);
+                    }else{
+                        EXPECT_EQ(same,MATRECGraphicDecompositionSameComponent(incremental,element(first),
+                                                                               element(second)));
+                    }
+                }
+            }
+            MATRECfreeGraphicColumnAddition(env,&newCol);
+            MATRECGraphicDecompositionFree(&incremental);
+            MATRECGraphicDecompositionFree(&dec);
+        }
+        EXPECT_GT(numRigid,0);
+
+        //Rows which contain a cycle and columns whose endpoints are not joined by rows do not form a realization
+        MATRECGraphicDecomposition * dec = NULL;
+        std::vector<MATREC_matrix_size> tails = {0,1,2};
+        std::vector<MATREC_matrix_size> heads = {1,2,0};
+        std::vector<MATRECElement> cycle = {{0,true},{1,true},{2,true}};
+        EXPECT_EQ(MATRECGraphicDecompositionCreateFromGraph(env,&dec,3,3,tails.data(),heads.data(),cycle.data()),
+                  MATREC_ERROR_INPUT);
+        std::vector<MATRECElement> disconnected = {{0,true},{0,false},{1,false}};
+        tails = {0,0,2};
+        heads = {1,1,1};
+        EXPECT_EQ(MATRECGraphicDecompositionCreateFromGraph(env,&dec,3,3,tails.data(),heads.data(),disconnected.data()),
+                  MATREC_ERROR_INPUT);
+        EXPECT_EQ(dec,nullptr);
+        MATRECfreeEnvironment(&env);
+    }
 }
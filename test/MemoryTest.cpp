@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+#include "TestHelpers.h"
+#include <matrec/Network.h>
+#include <matrec/Graphic.h>
+
+///Checks that the totals of the report are the sums over its arrays
+static void checkReport(const MATRECMemoryReport & report){
+    std::size_t allocated = 0;
+    std::size_t used = 0;
+    for(std::size_t i = 0; i < report.numArrays; ++i){
+        EXPECT_LE(report.arrays[i].usedBytes,report.arrays[i].allocatedBytes);
+        allocated += report.arrays[i].allocatedBytes;
+        used += report.arrays[i].usedBytes;
+    }
+    EXPECT_EQ(report.allocatedBytes,allocated);
+    EXPECT_EQ(report.usedBytes,used);
+    EXPECT_LE(report.allocatedBytes,report.peakBytes);
+}
+
+static std::size_t arrayBytes(const MATRECMemoryReport & report, const std::string & name){
+    for(std::size_t i = 0; i < report.numArrays; ++i){
+        if(name == report.arrays[i].name){
+            return report.arrays[i].allocatedBytes;
+        }
+    }
+    ADD_FAILURE() << "No array " << name;
+    return 0;
+}
+
+TEST(Memory, Reports){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    EXPECT_EQ(MATRECmemoryInUse(env),0);
+
+    DirectedTestCase testCase = erdosRenyiDirectedTestCase(60,0.2,3);
+    MATRECNetworkDecomposition * dec = NULL;
+    ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+    MATRECNetworkRowAddition * newRow = NULL;
+    ASSERT_EQ(MATRECcreateNetworkRowAddition(env,&newRow),MATREC_OKAY);
+    MATRECMemoryReport initialReport;
+    MATRECNetworkDecompositionMemory(dec,&initialReport);
+    checkReport(initialReport);
+
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        std::vector<MATREC_col> columns;
+        std::vector<double> values;
+        for(const auto & nonzero : testCase.matrix[row]){
+            columns.push_back(nonzero.index);
+            values.push_back(nonzero.value);
+        }
+        ASSERT_EQ(MATRECNetworkRowAdditionCheck(dec,newRow,row,columns.data(),values.data(),columns.size()),MATREC_OKAY);
+        if(MATRECNetworkRowAdditionRemainsNetwork(newRow)){
+            ASSERT_EQ(MATRECNetworkRowAdditionAdd(dec,newRow),MATREC_OKAY);
+        }
+    }
+    MATRECMemoryReport report;
+    MATRECNetworkDecompositionMemory(dec,&report);
+    checkReport(report);
+    EXPECT_GT(report.allocatedBytes,initialReport.allocatedBytes);
+    EXPECT_GT(report.usedBytes,initialReport.usedBytes);
+    EXPECT_GT(arrayBytes(report,"arcs"),arrayBytes(initialReport,"arcs"));
+
+    MATRECMemoryReport rowReport;
+    MATRECNetworkRowAdditionMemory(newRow,&rowReport);
+    checkReport(rowReport);
+    EXPECT_GT(arrayBytes(rowReport,"memberInformation"),0);
+
+    //The reports cover all allocations, apart from the size headers of the environment
+    EXPECT_GE(MATRECmemoryInUse(env),report.allocatedBytes + rowReport.allocatedBytes);
+    EXPECT_GE(MATRECmemoryPeak(env),MATRECmemoryInUse(env));
+
+    //Resetting keeps the memory, but it is no longer in use
+    MATRECNetworkDecompositionReset(dec);
+    MATRECMemoryReport resetReport;
+    MATRECNetworkDecompositionMemory(dec,&resetReport);
+    checkReport(resetReport);
+    EXPECT_EQ(resetReport.allocatedBytes,report.allocatedBytes);
+    EXPECT_LT(resetReport.usedBytes,report.usedBytes);
+
+    MATRECfreeNetworkRowAddition(env,&newRow);
+    MATRECNetworkDecompositionFree(&dec);
+
+    //A shared scratch object is reported separately from the additions
+    MATRECGraphicDecomposition * graphicDec = NULL;
+    ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&graphicDec,10,10),MATREC_OKAY);
+    MATRECGraphicAdditionScratch * scratch = NULL;
+    ASSERT_EQ(MATRECcreateGraphicAdditionScratch(env,&scratch),MATREC_OKAY);
+    MATRECGraphicColumnAddition * newCol = NULL;
+    ASSERT_EQ(MATRECcreateGraphicColumnAdditionWithScratch(env,&newCol,scratch),MATREC_OKAY);
+    MATREC_row rows[2] = {0,1};
+    ASSERT_EQ(MATRECGraphicColumnAdditionCheck(graphicDec,newCol,0,rows,2),MATREC_OKAY);
+    ASSERT_EQ(MATRECGraphicColumnAdditionAdd(graphicDec,newCol),MATREC_OKAY);
+    MATRECMemoryReport colReport;
+    MATRECGraphicColumnAdditionMemory(newCol,&colReport);
+    checkReport(colReport);
+    MATRECMemoryReport scratchReport;
+    MATRECGraphicAdditionScratchMemory(scratch,&scratchReport);
+    checkReport(scratchReport);
+    EXPECT_GT(scratchReport.allocatedBytes,0);
+    EXPECT_EQ(scratchReport.usedBytes,0);
+    for(std::size_t i = 0; i < colReport.numArrays; ++i){
+        EXPECT_STRNE(colReport.arrays[i].name,"memberInformation");
+    }
+    MATRECGraphicDecompositionMemory(graphicDec,&report);
+    checkReport(report);
+    EXPECT_GT(arrayBytes(report,"edges"),0);
+    EXPECT_GT(arrayBytes(report,"columnEdges"),0);
+
+    MATRECfreeGraphicColumnAddition(env,&newCol);
+    MATRECfreeGraphicAdditionScratch(env,&scratch);
+    MATRECGraphicDecompositionFree(&graphicDec);
+
+    EXPECT_EQ(MATRECmemoryInUse(env),0);
+    EXPECT_GT(MATRECmemoryPeak(env),0);
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Memory, Limit){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    DirectedTestCase testCase = erdosRenyiDirectedTestCase(200,0.2,1);
+    DirectedColTestCase colTestCase(testCase);
+
+    MATRECNetworkDecomposition * dec = NULL;
+    ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+    MATRECNetworkColumnAddition * newCol = NULL;
+    ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+
+    //The decomposition outgrows the limit, so that one of the calls has to fail
+    std::size_t limit = MATRECmemoryInUse(env) + 2000;
+    MATRECsetMemoryLimit(env,limit);
+    MATREC_ERROR error = MATREC_OKAY;
+    for(std::size_t column = 0; column < colTestCase.cols && error == MATREC_OKAY; ++column){
+        std::vector<MATREC_row> rows;
+        std::vector<double> values;
+        for(const auto & nonzero : colTestCase.matrix[column]){
+            rows.push_back(nonzero.index);
+            values.push_back(nonzero.value);
+        }
+        error = MATRECNetworkColumnAdditionCheck(dec,newCol,column,rows.data(),values.data(),rows.size());
+        if(error == MATREC_OKAY && MATRECNetworkColumnAdditionRemainsNetwork(newCol)){
+            error = MATRECNetworkColumnAdditionAdd(dec,newCol);
+        }
+    }
+    EXPECT_EQ(error,MATREC_ERROR_MEMORY);
+    EXPECT_LE(MATRECmemoryPeak(env),limit);
+
+    //Objects on which a call failed can still be freed, without leaking memory
+    MATRECfreeNetworkColumnAddition(env,&newCol);
+    MATRECNetworkDecompositionFree(&dec);
+    EXPECT_EQ(MATRECmemoryInUse(env),0);
+
+    MATRECsetMemoryLimit(env,16);
+    EXPECT_EQ(MATRECNetworkDecompositionCreate(env,&dec,10,10),MATREC_ERROR_MEMORY);
+    EXPECT_EQ(dec,nullptr);
+
+    MATRECsetMemoryLimit(env,0);
+    ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,1000000,1000000),MATREC_OKAY);
+    MATRECNetworkDecompositionFree(&dec);
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Memory, LimitSweep){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    DirectedTestCase testCase = erdosRenyiDirectedTestCase(60,0.2,2);
+    DirectedColTestCase colTestCase(testCase);
+
+    //Whichever allocation fails, the objects can be freed without leaking memory
+    for(std::size_t extra = 0; extra < 40000; extra += 16){
+        MATRECNetworkDecomposition * dec = NULL;
+        ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+        MATRECNetworkColumnAddition * newCol = NULL;
+        ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+        MATRECsetMemoryLimit(env,MATRECmemoryInUse(env) + extra);
+        MATREC_ERROR error = MATREC_OKAY;
+        for(std::size_t column = 0; column < colTestCase.cols && error == MATREC_OKAY; ++column){
+            std::vector<MATREC_row> rows;
+            std::vector<double> values;
+            for(const auto & nonzero : colTestCase.matrix[column]){
+                rows.push_back(nonzero.index);
+                values.push_back(nonzero.value);
+            }
+            error = MATRECNetworkColumnAdditionCheck(dec,newCol,column,rows.data(),values.data(),rows.size());
+            if(error == MATREC_OKAY && MATRECNetworkColumnAdditionRemainsNetwork(newCol)){
+                error = MATRECNetworkColumnAdditionAdd(dec,newCol);
+            }
+        }
+        EXPECT_TRUE(error == MATREC_OKAY || error == MATREC_ERROR_MEMORY);
+        MATRECsetMemoryLimit(env,0);
+        MATRECfreeNetworkColumnAddition(env,&newCol);
+        MATRECNetworkDecompositionFree(&dec);
+        EXPECT_EQ(MATRECmemoryInUse(env),0);
+    }
+    MATRECfreeEnvironment(&env);
+}
+
+///Adds the columns of the test case to the decomposition, and returns whether all of them kept it a network matrix
+static bool addColumns(MATRECNetworkDecomposition * dec, MATRECNetworkColumnAddition * newCol,
+                       const DirectedColTestCase & testCase){
+    bool isNetwork = true;
+    for(std::size_t column = 0; column < testCase.cols; ++column){
+        std::vector<MATREC_row> rows;
+        std::vector<double> values;
+        for(const auto & nonzero : testCase.matrix[column]){
+            rows.push_back(nonzero.index);
+            values.push_back(nonzero.value);
+        }
+        EXPECT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,column,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+        if(MATRECNetworkColumnAdditionRemainsNetwork(newCol)){
+            EXPECT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+        }else{
+            isNetwork = false;
+        }
+    }
+    return isNetwork;
+}
+
+TEST(Memory, Shrink){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    DirectedColTestCase large(erdosRenyiDirectedTestCase(400,0.05,1));
+    DirectedColTestCase small(erdosRenyiDirectedTestCase(20,0.2,2));
+
+    MATRECNetworkDecomposition * dec = NULL;
+    ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,large.rows,large.cols),MATREC_OKAY);
+    MATRECNetworkColumnAddition * newCol = NULL;
+    ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+    addColumns(dec,newCol,large);
+    MATRECMemoryReport largeReport;
+    MATRECNetworkDecompositionMemory(dec,&largeReport);
+    MATRECMemoryReport largeColReport;
+    MATRECNetworkColumnAdditionMemory(newCol,&largeColReport);
+
+    //Shrinking after a reset releases the arrays, and the decomposition can be used as before
+    MATRECNetworkDecompositionReset(dec);
+    ASSERT_EQ(MATRECNetworkDecompositionShrink(dec),MATREC_OKAY);
+    MATRECMemoryReport report;
+    MATRECNetworkDecompositionMemory(dec,&report);
+    checkReport(report);
+    EXPECT_LT(4 * report.allocatedBytes,largeReport.allocatedBytes);
+    EXPECT_GE(report.peakBytes,largeReport.allocatedBytes);
+
+    MATRECNetworkColumnAdditionShrink(env,newCol);
+    MATRECMemoryReport colReport;
+    MATRECNetworkColumnAdditionMemory(newCol,&colReport);
+    checkReport(colReport);
+    EXPECT_LT(4 * colReport.allocatedBytes,largeColReport.allocatedBytes);
+    EXPECT_GE(colReport.peakBytes,largeColReport.allocatedBytes);
+
+    bool isNetwork = addColumns(dec,newCol,small);
+    MATRECNetworkDecompositionReset(dec);
+    ASSERT_EQ(MATRECNetworkDecompositionShrink(dec),MATREC_OKAY);
+    EXPECT_EQ(addColumns(dec,newCol,small),isNetwork);
+
+    //Automatic shrinking: a few small problems after a large one
+    MATRECNetworkDecompositionReset(dec);
+    addColumns(dec,newCol,large);
+    MATRECNetworkDecompositionSetAutoShrink(dec,2);
+    MATRECNetworkColumnAdditionSetAutoShrink(newCol,5);
+    for(int i = 0; i < 3; ++i){
+        MATRECNetworkDecompositionReset(dec);
+        EXPECT_EQ(addColumns(dec,newCol,small),isNetwork);
+    }
+    MATRECNetworkDecompositionMemory(dec,&report);
+    EXPECT_LT(4 * report.allocatedBytes,largeReport.allocatedBytes);
+    MATRECNetworkColumnAdditionMemory(newCol,&colReport);
+    EXPECT_LT(4 * colReport.allocatedBytes,largeColReport.allocatedBytes);
+
+    MATRECfreeNetworkColumnAddition(env,&newCol);
+    MATRECNetworkDecompositionFree(&dec);
+
+    //A graphic decomposition keeps working after it is shrunk
+    MATRECGraphicDecomposition * graphicDec = NULL;
+    ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&graphicDec,1000,1000),MATREC_OKAY);
+    MATRECGraphicRowAddition * newRow = NULL;
+    ASSERT_EQ(MATRECcreateGraphicRowAddition(env,&newRow),MATREC_OKAY);
+    MATRECGraphicDecompositionMemory(graphicDec,&largeReport);
+    ASSERT_EQ(MATRECGraphicDecompositionShrink(graphicDec),MATREC_OKAY);
+    MATRECGraphicDecompositionMemory(graphicDec,&report);
+    checkReport(report);
+    EXPECT_LT(report.allocatedBytes,largeReport.allocatedBytes);
+    for(MATREC_row row = 0; row < 3; ++row){
+        MATREC_col columns[2] = {0,1};
+        ASSERT_EQ(MATRECGraphicRowAdditionCheck(graphicDec,newRow,row,columns,2),MATREC_OKAY);
+        EXPECT_TRUE(MATRECGraphicRowAdditionRemainsGraphic(newRow));
+        ASSERT_EQ(MATRECGraphicRowAdditionAdd(graphicDec,newRow),MATREC_OKAY);
+        MATRECGraphicRowAdditionShrink(env,newRow);
+    }
+    EXPECT_TRUE(MATRECGraphicDecompositionIsMinimal(graphicDec));
+
+    MATRECfreeGraphicRowAddition(env,&newRow);
+    MATRECGraphicDecompositionFree(&graphicDec);
+    EXPECT_EQ(MATRECmemoryInUse(env),0);
+    MATRECfreeEnvironment(&env);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <matrec/Mps.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+MATREC_ERROR stringToMps(MATREC * env,
+                         MATRECMpsModel ** model,
+                         std::string string,
+                         MATRECMpsFormat format,
+                         int parts){
+    FILE * file = fmemopen(string.data(),string.size(),"r");
+    MATREC_ERROR error = MATRECreadMpsFromStream(env,model,file,format,parts);
+    fclose(file);
+    return error;
+}
+
+const std::string freeModel =
+        "* A small transportation model\n"
+        "NAME transport\n"
+        "ROWS\n"
+        " N cost\n"
+        " L supply1\n"
+        " L supply2\n"
+        " N unused\n"
+        " G demand\n"
+        "COLUMNS\n"
+        "    x11 cost 1.0 supply1 1.0\n"
+        "    x11 demand 1.0\n"
+        "    MARKER 'MARKER' 'INTORG'\n"
+        "    x21 cost 2.5 supply2 1.0\n"
+        "    x21 unused 3.0 demand 1.0\n"
+        "    MARKER 'MARKER' 'INTEND'\n"
+        "    y supply1 -1.0 supply2 0.0\n"
+        "RHS\n"
+        "    RHS supply1 4.0 supply2 5.0\n"
+        "    RHS demand 3.0\n"
+        "BOUNDS\n"
+        " UP BND x11 4.0\n"
+        " MI BND x21\n"
+        " FR y\n"
+        "ENDATA\n";
+
+TEST(Mps, FreeFormatMatrix){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    MATRECMpsModel * model = NULL;
+    ASSERT_EQ(stringToMps(env,&model,freeModel,MATREC_MPS_FREE,MATREC_MPS_READ_MATRIX),MATREC_OKAY);
+
+    EXPECT_STREQ(model->name,"transport");
+    MATRECCSMatrixDouble * matrix = model->matrix;
+    ASSERT_EQ(matrix->numRows,3);
+    ASSERT_EQ(matrix->numColumns,3);
+    ASSERT_EQ(matrix->numNonzeros,5);
+    EXPECT_STREQ(model->rowNames[0],"supply1");
+    EXPECT_STREQ(model->rowNames[1],"supply2");
+    EXPECT_STREQ(model->rowNames[2],"demand");
+    EXPECT_EQ(model->rowSenses[0],'L');
+    EXPECT_EQ(model->rowSenses[2],'G');
+    EXPECT_STREQ(model->columnNames[0],"x11");
+    EXPECT_STREQ(model->columnNames[2],"y");
+    EXPECT_EQ(model->objective,nullptr);
+    EXPECT_EQ(model->lowerBounds,nullptr);
+
+    //supply1: x11 and y, supply2: x21, demand: x11 and x21
+    EXPECT_EQ(MATRECdoubleMatrixRowNumNonzeros(matrix,0),2);
+    EXPECT_EQ(MATRECdoubleMatrixRowColumnIndices(matrix,0)[0],0);
+    EXPECT_EQ(MATRECdoubleMatrixRowColumnIndices(matrix,0)[1],2);
+    EXPECT_EQ(MATRECdoubleMatrixRowColumnValues(matrix,0)[1],-1.0);
+    EXPECT_EQ(MATRECdoubleMatrixRowNumNonzeros(matrix,1),1);
+    EXPECT_EQ(MATRECdoubleMatrixRowNumNonzeros(matrix,2),2);
+    EXPECT_EQ(MATRECdoubleMatrixRowColumnIndices(matrix,2)[1],1);
+
+    MATRECfreeMpsModel(env,&model);
+    EXPECT_EQ(model,nullptr);
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Mps, ObjectiveAndBounds){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    MATRECMpsModel * model = NULL;
+    ASSERT_EQ(stringToMps(env,&model,freeModel,MATREC_MPS_FREE,
+                          MATREC_MPS_READ_OBJECTIVE | MATREC_MPS_READ_BOUNDS),MATREC_OKAY);
+
+    EXPECT_EQ(model->objective[0],1.0);
+    EXPECT_EQ(model->objective[1],2.5);
+    EXPECT_EQ(model->objective[2],0.0);
+    EXPECT_EQ(model->lowerBounds[0],0.0);
+    EXPECT_EQ(model->upperBounds[0],4.0);
+    EXPECT_TRUE(std::isinf(model->lowerBounds[1]) && model->lowerBounds[1] < 0.0);
+    EXPECT_TRUE(std::isinf(model->upperBounds[1]));
+    EXPECT_TRUE(std::isinf(model->lowerBounds[2]) && std::isinf(model->upperBounds[2]));
+    EXPECT_FALSE(model->isInteger[0]);
+    EXPECT_TRUE(model->isInteger[1]);
+    EXPECT_FALSE(model->isInteger[2]);
+
+    MATRECfreeMpsModel(env,&model);
+    MATRECfreeEnvironment(&env);
+}
+
+///Places the given fields at the column positions of the fixed MPS format
+std::string fixedLine(const std::vector<std::string> & fields){
+    const std::size_t positions[] = {1, 4, 14, 24, 39, 49};
+    std::string line;
+    for(std::size_t i = 0; i < fields.size(); ++i){
+        line.resize(positions[i],' ');
+        line += fields[i];
+    }
+    return line + "\n";
+}
+
+TEST(Mps, FixedFormat){
+    const std::string fixedModel =
+            "NAME          FIXED\n"
+            "ROWS\n" +
+            fixedLine({"N","OBJ"}) +
+            fixedLine({"E","ROW ONE"}) +
+            fixedLine({"L","ROW TWO"}) +
+            "COLUMNS\n" +
+            fixedLine({"","COL A","OBJ","1.","ROW ONE","1."}) +
+            fixedLine({"","COL A","ROW TWO","-1."}) +
+            fixedLine({"","COL B","ROW TWO","2."}) +
+            "RHS\n" +
+            fixedLine({"","RHS","ROW ONE","1."}) +
+            "BOUNDS\n" +
+            fixedLine({"UP","BND","COL B","3."}) +
+            "ENDATA\n";
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    MATRECMpsModel * model = NULL;
+    ASSERT_EQ(stringToMps(env,&model,fixedModel,MATREC_MPS_FIXED,MATREC_MPS_READ_BOUNDS),MATREC_OKAY);
+
+    EXPECT_STREQ(model->name,"FIXED");
+    ASSERT_EQ(model->matrix->numRows,2);
+    ASSERT_EQ(model->matrix->numColumns,2);
+    ASSERT_EQ(model->matrix->numNonzeros,3);
+    EXPECT_STREQ(model->rowNames[0],"ROW ONE");
+    EXPECT_STREQ(model->rowNames[1],"ROW TWO");
+    EXPECT_STREQ(model->columnNames[1],"COL B");
+    EXPECT_EQ(model->rowSenses[0],'E');
+    EXPECT_EQ(MATRECdoubleMatrixRowNumNonzeros(model->matrix,1),2);
+    EXPECT_EQ(MATRECdoubleMatrixRowColumnValues(model->matrix,1)[1],2.0);
+    EXPECT_EQ(model->upperBounds[1],3.0);
+    EXPECT_EQ(model->objective,nullptr);
+
+    MATRECfreeMpsModel(env,&model);
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Mps, InvalidInput){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    const std::string unknownRow =
+            "ROWS\n N obj\n E c1\nCOLUMNS\n x c2 1\nENDATA\n";
+    const std::string splitColumn =
+            "ROWS\n N obj\n E c1\n E c2\nCOLUMNS\n x c1 1\n y c1 1\n x c2 1\nENDATA\n";
+    const std::string duplicateEntry =
+            "ROWS\n N obj\n E c1\nCOLUMNS\n x c1 1\n x c1 2\nENDATA\n";
+    const std::string missingEnd =
+            "ROWS\n N obj\n E c1\nCOLUMNS\n x c1 1\n";
+    const std::string badValue =
+            "ROWS\n N obj\n E c1\nCOLUMNS\n x c1 one\nENDATA\n";
+    for(const std::string & input : {unknownRow,splitColumn,duplicateEntry,missingEnd,badValue}){
+        MATRECMpsModel * model = NULL;
+        EXPECT_EQ(stringToMps(env,&model,input,MATREC_MPS_FREE,MATREC_MPS_READ_MATRIX),MATREC_ERROR_INPUT);
+        EXPECT_EQ(model,nullptr);
+    }
+    MATRECfreeEnvironment(&env);
+}
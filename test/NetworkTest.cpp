@@ -3,6 +3,11 @@
 #include <matrec/Network.h>
 #include <matrec/Graphic.h>
 #include <matrec/SignCheckRowAddition.h>
+#include <memory>
+#include <climits>
+#include <numeric>
+#include <atomic>
+#include <thread>
 
 MATREC_ERROR runGraphicCheck(MATREC * env,
         const DirectedColTestCase& testCase,
@@ -40,7 +45,7 @@ MATREC_ERROR runSignedCheck(MATREC * env,
     std::vector<MATRECIntMatrixTriplet> triplets;
     for(std::size_t i = 0 ; i < testCase.cols; ++i){
         for(const auto& entry : testCase.matrix[i]){
-            triplets.push_back(MATRECIntMatrixTriplet{.row = entry.index,.column = i,.value = (entry.value > 0.0 ) ? 1 : -1});
+            triplets.push_back(MATRECIntMatrixTriplet{.row = entry.index,.column = MATREC_col(i),.value = (entry.value > 0.0 ) ? 1 : -1});
         }
     }
     std::sort(triplets.begin(),triplets.end(),
@@ -109,7 +114,7 @@ MATREC_ERROR runRowSignedCheck(MATREC * env,
     std::vector<MATRECIntMatrixTriplet> triplets;
     for(std::size_t i = 0 ; i < testCase.rows; ++i){
         for(const auto& entry : testCase.matrix[i]){
-            triplets.push_back(MATRECIntMatrixTriplet{.row = i,.column = entry.index,
+            triplets.push_back(MATRECIntMatrixTriplet{.row = MATREC_row(i),.column = entry.index,
                                                 .value = ( entry.value > 0.0 ) ? 1 : -1});
         }
     }
@@ -336,10 +341,13 @@ MATREC_ERROR runInterleavedNetworkDecomposition(const DirectedTestCase& testCase
     std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
     MATRECNetworkDecomposition *dec = NULL;
     MATREC_CALL(MATRECNetworkDecompositionCreate(env, &dec, testCase.rows, testCase.cols));
+    //The row and column additions share their scratch memory, as they are interleaved
+    MATRECNetworkAdditionScratch *scratch = NULL;
+    MATREC_CALL(MATRECcreateNetworkAdditionScratch(env, &scratch));
     MATRECNetworkRowAddition *newRow = NULL;
-    MATREC_CALL(MATRECcreateNetworkRowAddition(env, &newRow));
+    MATREC_CALL(MATRECcreateNetworkRowAdditionWithScratch(env, &newRow, scratch));
     MATRECNetworkColumnAddition *newCol = NULL;
-    MATREC_CALL(MATRECcreateNetworkColumnAddition(env,&newCol));
+    MATREC_CALL(MATRECcreateNetworkColumnAdditionWithScratch(env,&newCol, scratch));
     std::vector<std::vector<MATREC_row>> columnCycles(testCase.cols,std::vector<MATREC_col>());
     std::vector<std::vector<double>> columnCycleValues(testCase.cols,std::vector<double>());
 
@@ -453,6 +461,7 @@ MATREC_ERROR runInterleavedNetworkDecomposition(const DirectedTestCase& testCase
     }
     MATRECfreeNetworkColumnAddition(env,&newCol);
     MATRECfreeNetworkRowAddition(env, &newRow);
+    MATRECfreeNetworkAdditionScratch(env, &scratch);
     MATRECNetworkDecompositionFree(&dec);
     MATREC_CALL(MATRECfreeEnvironment(&env));
     return MATREC_OKAY;
@@ -1551,4 +1560,1347 @@ namespace NetworkAdditionTest{
             runInterleavedTestCase(testCase,seed,true);
         }
     }
-}
\ No newline at end of file
+    TEST(NetworkColumnAddition,SparseColumnIds){
+        //Columns get large, sparse ids, and the decomposition is created without any row or column capacity
+        for(MATRECIdStorage storage : {MATREC_IDS_DENSE,MATREC_IDS_HASHED}){
+            for(std::size_t seed = 0; seed < 20; ++seed){
+                auto testCase = erdosRenyiDirectedTestCase(20,0.3,seed);
+                DirectedColTestCase colTestCase(testCase);
+                const std::size_t idStride = storage == MATREC_IDS_HASHED ? 1'000'003 : 7;
+                auto columnId = [&](std::size_t col){ return col * idStride + 5; };
+
+                MATREC * env = NULL;
+                ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+                MATRECNetworkDecomposition * dec = NULL;
+                ASSERT_EQ(MATRECNetworkDecompositionCreateWithStorage(env,&dec,0,0,MATREC_IDS_DENSE,storage),MATREC_OKAY);
+                MATRECNetworkColumnAddition * newCol = NULL;
+                ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+                std::vector<MATREC_row> rows;
+                std::vector<double> values;
+                for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                    rows.clear();
+                    values.clear();
+                    for(const auto & nonzero : colTestCase.matrix[col]){
+                        rows.push_back(nonzero.index);
+                        values.push_back(nonzero.value);
+                    }
+                    ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,columnId(col),rows.data(),values.data(),rows.size()),MATREC_OKAY);
+                    ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                    ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+                    EXPECT_TRUE(MATRECNetworkDecompositionContainsColumn(dec,columnId(col)));
+                    EXPECT_FALSE(MATRECNetworkDecompositionContainsColumn(dec,columnId(col) + 1));
+                }
+                EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+
+                std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+                std::unique_ptr<bool[]> signStorage(new bool[testCase.rows]);
+                for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                    rows.clear();
+                    values.clear();
+                    for(const auto & nonzero : colTestCase.matrix[col]){
+                        rows.push_back(nonzero.index);
+                        values.push_back(nonzero.value);
+                    }
+                    EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(dec,columnId(col),rows.data(),values.data(),rows.size(),
+                                                                      rowStorage.data(),signStorage.get()));
+                }
+                MATRECfreeNetworkColumnAddition(env,&newCol);
+                MATRECNetworkDecompositionFree(&dec);
+                MATRECfreeEnvironment(&env);
+            }
+        }
+    }
+    TEST(NetworkRowAddition,Flatten){
+        //Flattening, both automatic and explicit, must not change the decomposition
+        for(double autoFlatten : {0.0,0.05}){
+            for(std::size_t seed = 0; seed < 20; ++seed){
+                auto testCase = erdosRenyiDirectedTestCase(20,0.3,seed);
+                DirectedColTestCase colTestCase(testCase);
+
+                MATREC * env = NULL;
+                ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+                MATRECNetworkDecomposition * dec = NULL;
+                ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+                MATRECNetworkDecompositionSetAutoFlatten(dec,autoFlatten);
+                MATRECNetworkRowAddition * newRow = NULL;
+                ASSERT_EQ(MATRECcreateNetworkRowAddition(env,&newRow),MATREC_OKAY);
+                std::vector<MATREC_col> cols;
+                std::vector<double> values;
+                for(std::size_t row = 0; row < testCase.rows; ++row){
+                    cols.clear();
+                    values.clear();
+                    for(const auto & nonzero : testCase.matrix[row]){
+                        cols.push_back(nonzero.index);
+                        values.push_back(nonzero.value);
+                    }
+                    ASSERT_EQ(MATRECNetworkRowAdditionCheck(dec,newRow,row,cols.data(),values.data(),cols.size()),MATREC_OKAY);
+                    ASSERT_TRUE(MATRECNetworkRowAdditionRemainsNetwork(newRow));
+                    ASSERT_EQ(MATRECNetworkRowAdditionAdd(dec,newRow),MATREC_OKAY);
+                }
+                MATRECNetworkDecompositionFlatten(dec);
+                EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+
+                std::vector<MATREC_row> rows;
+                std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+                std::unique_ptr<bool[]> signStorage(new bool[testCase.rows]);
+                for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                    rows.clear();
+                    values.clear();
+                    for(const auto & nonzero : colTestCase.matrix[col]){
+                        rows.push_back(nonzero.index);
+                        values.push_back(nonzero.value);
+                    }
+                    EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(dec,col,rows.data(),values.data(),rows.size(),
+                                                                      rowStorage.data(),signStorage.get()));
+                }
+                MATRECfreeNetworkRowAddition(env,&newRow);
+                MATRECNetworkDecompositionFree(&dec);
+                MATRECfreeEnvironment(&env);
+            }
+        }
+    }
+    TEST(NetworkColAddition,RepeatedChecks){
+        //Checking the same columns many times between additions builds the ancestor index of the member tree,
+        //which must give the same results as walking the tree
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            auto testCase = erdosRenyiDirectedTestCase(20,0.3,seed);
+            DirectedColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,2 * testCase.cols),MATREC_OKAY);
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+            std::vector<MATREC_row> rows;
+            std::vector<double> values;
+            std::vector<MATREC_row> randomRows;
+            std::vector<double> randomValues;
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                //A random column, which is checked but never added
+                randomRows.clear();
+                randomValues.clear();
+                for(std::size_t row = 0; row < testCase.rows; ++row){
+                    if(rng() % 4 == 0){
+                        randomRows.push_back(row);
+                        randomValues.push_back(rng() % 2 == 0 ? 1.0 : -1.0);
+                    }
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,testCase.cols + col,randomRows.data(),
+                                                           randomValues.data(),randomRows.size()),MATREC_OKAY);
+                bool randomIsNetwork = MATRECNetworkColumnAdditionRemainsNetwork(newCol);
+                for(int repetition = 0; repetition < 10; ++repetition){
+                    ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,testCase.cols + col,randomRows.data(),
+                                                               randomValues.data(),randomRows.size()),MATREC_OKAY);
+                    EXPECT_EQ(MATRECNetworkColumnAdditionRemainsNetwork(newCol),randomIsNetwork);
+                }
+
+                rows.clear();
+                values.clear();
+                for(const auto & nonzero : colTestCase.matrix[col]){
+                    rows.push_back(nonzero.index);
+                    values.push_back(nonzero.value);
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+            }
+            EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+
+            std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+            std::unique_ptr<bool[]> signStorage(new bool[testCase.rows]);
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                rows.clear();
+                values.clear();
+                for(const auto & nonzero : colTestCase.matrix[col]){
+                    rows.push_back(nonzero.index);
+                    values.push_back(nonzero.value);
+                }
+                EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(dec,col,rows.data(),values.data(),rows.size(),
+                                                                  rowStorage.data(),signStorage.get()));
+            }
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+    TEST(NetworkRowAddition,RepeatedChecks){
+        //Checking the same rows many times between additions reuses the adjacency snapshots of the rigid members,
+        //which must give the same results as searching the node arc lists
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            auto testCase = erdosRenyiDirectedTestCase(20,0.3,seed);
+            std::mt19937 rng(seed);
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,2 * testCase.rows,testCase.cols),MATREC_OKAY);
+            MATRECNetworkRowAddition * newRow = NULL;
+            ASSERT_EQ(MATRECcreateNetworkRowAddition(env,&newRow),MATREC_OKAY);
+            std::vector<MATREC_col> cols;
+            std::vector<double> values;
+            std::vector<MATREC_col> randomCols;
+            std::vector<double> randomValues;
+            for(std::size_t row = 0; row < testCase.rows; ++row){
+                //A random row, which is checked but never added
+                randomCols.clear();
+                randomValues.clear();
+                for(std::size_t col = 0; col < testCase.cols; ++col){
+                    if(rng() % 4 == 0){
+                        randomCols.push_back(col);
+                        randomValues.push_back(rng() % 2 == 0 ? 1.0 : -1.0);
+                    }
+                }
+                ASSERT_EQ(MATRECNetworkRowAdditionCheck(dec,newRow,testCase.rows + row,randomCols.data(),
+                                                        randomValues.data(),randomCols.size()),MATREC_OKAY);
+                bool randomIsNetwork = MATRECNetworkRowAdditionRemainsNetwork(newRow);
+                for(int repetition = 0; repetition < 10; ++repetition){
+                    ASSERT_EQ(MATRECNetworkRowAdditionCheck(dec,newRow,testCase.rows + row,randomCols.data(),
+                                                            randomValues.data(),randomCols.size()),MATREC_OKAY);
+                    EXPECT_EQ(MATRECNetworkRowAdditionRemainsNetwork(newRow),randomIsNetwork);
+                }
+
+                cols.clear();
+                values.clear();
+                for(const auto & nonzero : testCase.matrix[row]){
+                    cols.push_back(nonzero.index);
+                    values.push_back(nonzero.value);
+                }
+                ASSERT_EQ(MATRECNetworkRowAdditionCheck(dec,newRow,row,cols.data(),values.data(),cols.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkRowAdditionRemainsNetwork(newRow));
+                ASSERT_EQ(MATRECNetworkRowAdditionAdd(dec,newRow),MATREC_OKAY);
+            }
+            EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+            MATRECfreeNetworkRowAddition(env,&newRow);
+            MATRECNetworkDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+    TEST(NetworkColAddition,TrivialAndDuplicateColumns){
+        //Empty columns, columns with a single nonzero and (negated) copies of earlier columns take the fast paths
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            auto testCase = erdosRenyiDirectedTestCase(20,0.3,seed);
+            DirectedColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,4 * testCase.cols),MATREC_OKAY);
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+
+            std::vector<std::vector<Nonzero>> addedColumns;
+            auto addColumn = [&](const std::vector<Nonzero> & column){
+                std::vector<MATREC_row> rows;
+                std::vector<double> values;
+                for(const auto & nonzero : column){
+                    rows.push_back(nonzero.index);
+                    values.push_back(nonzero.value);
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,addedColumns.size(),rows.data(),values.data(),
+                                                           rows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+                addedColumns.push_back(column);
+            };
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                addColumn(colTestCase.matrix[col]);
+                switch(rng() % 4){
+                    case 0:
+                        addColumn({});
+                        break;
+                    case 1:
+                        addColumn({Nonzero{MATREC_matrix_size(rng() % testCase.rows), rng() % 2 == 0 ? 1.0 : -1.0}});
+                        break;
+                    default: {
+                        std::vector<Nonzero> duplicate = addedColumns[rng() % addedColumns.size()];
+                        std::shuffle(duplicate.begin(),duplicate.end(),rng);
+                        if(rng() % 2 == 0){
+                            for(auto & nonzero : duplicate){
+                                nonzero.value = -nonzero.value;
+                            }
+                        }
+                        addColumn(duplicate);
+                        break;
+                    }
+                }
+            }
+            EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+
+            std::vector<MATREC_row> rows;
+            std::vector<double> values;
+            std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+            std::unique_ptr<bool[]> signStorage(new bool[testCase.rows]);
+            for(std::size_t col = 0; col < addedColumns.size(); ++col){
+                rows.clear();
+                values.clear();
+                for(const auto & nonzero : addedColumns[col]){
+                    rows.push_back(nonzero.index);
+                    values.push_back(nonzero.value);
+                }
+                EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(dec,col,rows.data(),values.data(),rows.size(),
+                                                                  rowStorage.data(),signStorage.get()));
+            }
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+    TEST(NetworkAddition,SignFormats){
+        std::vector<double> values = {1.0,-1.0,1.0 + 1e-12,-1.0 + 1e-12};
+        std::vector<uint64_t> bits(MATREC_SIGN_WORDS(values.size()));
+        EXPECT_TRUE(MATRECpackSigns(values.data(),values.size(),1e-9,bits.data()));
+        EXPECT_EQ(bits[0],0b1010u);
+        values.push_back(0.5);
+        EXPECT_FALSE(MATRECpackSigns(values.data(),values.size(),1e-9,bits.data()));
+
+        //Checks with signed bytes and with packed signs must give the same results as checks with doubles
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            auto testCase = erdosRenyiDirectedTestCase(20,0.3,seed);
+            DirectedColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECNetworkDecomposition * colDec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&colDec,testCase.rows,2 * testCase.cols),MATREC_OKAY);
+            MATRECNetworkDecomposition * rowDec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&rowDec,2 * testCase.rows,testCase.cols),MATREC_OKAY);
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+            MATRECNetworkRowAddition * newRow = NULL;
+            ASSERT_EQ(MATRECcreateNetworkRowAddition(env,&newRow),MATREC_OKAY);
+
+            std::vector<MATREC_matrix_size> indices;
+            std::vector<double> doubles;
+            std::vector<int8_t> signs;
+            std::vector<uint64_t> packed;
+            auto setVector = [&](const std::vector<Nonzero> & vector){
+                indices.clear();
+                doubles.clear();
+                signs.clear();
+                for(const auto & nonzero : vector){
+                    indices.push_back(nonzero.index);
+                    doubles.push_back(nonzero.value);
+                    signs.push_back(nonzero.value < 0.0 ? -1 : 1);
+                }
+                packed.assign(MATREC_SIGN_WORDS(doubles.size()),0);
+                ASSERT_TRUE(MATRECpackSigns(doubles.data(),doubles.size(),0.0,packed.data()));
+            };
+            auto randomVector = [&](std::size_t size){
+                std::vector<Nonzero> vector;
+                for(std::size_t i = 0; i < size; ++i){
+                    if(rng() % 4 == 0){
+                        vector.push_back(Nonzero{MATREC_matrix_size(i),rng() % 2 == 0 ? 1.0 : -1.0});
+                    }
+                }
+                return vector;
+            };
+
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                setVector(randomVector(testCase.rows));
+                MATREC_col random = testCase.cols + col;
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(colDec,newCol,random,indices.data(),doubles.data(),indices.size()),MATREC_OKAY);
+                bool isNetwork = MATRECNetworkColumnAdditionRemainsNetwork(newCol);
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheckSigns(colDec,newCol,random,indices.data(),signs.data(),indices.size()),MATREC_OKAY);
+                EXPECT_EQ(MATRECNetworkColumnAdditionRemainsNetwork(newCol),isNetwork);
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheckPacked(colDec,newCol,random,indices.data(),packed.data(),indices.size()),MATREC_OKAY);
+                EXPECT_EQ(MATRECNetworkColumnAdditionRemainsNetwork(newCol),isNetwork);
+
+                setVector(colTestCase.matrix[col]);
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheckPacked(colDec,newCol,col,indices.data(),packed.data(),indices.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(colDec,newCol),MATREC_OKAY);
+            }
+            for(std::size_t row = 0; row < testCase.rows; ++row){
+                setVector(randomVector(testCase.cols));
+                MATREC_row random = testCase.rows + row;
+                ASSERT_EQ(MATRECNetworkRowAdditionCheck(rowDec,newRow,random,indices.data(),doubles.data(),indices.size()),MATREC_OKAY);
+                bool isNetwork = MATRECNetworkRowAdditionRemainsNetwork(newRow);
+                ASSERT_EQ(MATRECNetworkRowAdditionCheckSigns(rowDec,newRow,random,indices.data(),signs.data(),indices.size()),MATREC_OKAY);
+                EXPECT_EQ(MATRECNetworkRowAdditionRemainsNetwork(newRow),isNetwork);
+                ASSERT_EQ(MATRECNetworkRowAdditionCheckPacked(rowDec,newRow,random,indices.data(),packed.data(),indices.size()),MATREC_OKAY);
+                EXPECT_EQ(MATRECNetworkRowAdditionRemainsNetwork(newRow),isNetwork);
+
+                setVector(testCase.matrix[row]);
+                ASSERT_EQ(MATRECNetworkRowAdditionCheckSigns(rowDec,newRow,row,indices.data(),signs.data(),indices.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkRowAdditionRemainsNetwork(newRow));
+                ASSERT_EQ(MATRECNetworkRowAdditionAdd(rowDec,newRow),MATREC_OKAY);
+            }
+
+            std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+            std::unique_ptr<bool[]> signStorage(new bool[testCase.rows]);
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                setVector(colTestCase.matrix[col]);
+                EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(colDec,col,indices.data(),doubles.data(),indices.size(),
+                                                                  rowStorage.data(),signStorage.get()));
+                EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(rowDec,col,indices.data(),doubles.data(),indices.size(),
+                                                                  rowStorage.data(),signStorage.get()));
+            }
+            MATRECfreeNetworkRowAddition(env,&newRow);
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&rowDec);
+            MATRECNetworkDecompositionFree(&colDec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+
+    TEST(NetworkCandidatePool,MatchesFreshChecks){
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            auto testCase = erdosRenyiDirectedTestCase(30,0.2,seed);
+            DirectedColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+
+            //The columns of a network matrix, mixed with random columns which may or may not fit in
+            std::vector<std::vector<Nonzero>> columns = colTestCase.matrix;
+            for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                std::vector<Nonzero> random;
+                for(std::size_t row = 0; row < testCase.rows; ++row){
+                    if(rng() % 8 == 0){
+                        random.push_back(Nonzero{MATREC_matrix_size(row),rng() % 2 == 0 ? 1.0 : -1.0});
+                    }
+                }
+                columns.push_back(random);
+            }
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,columns.size()),MATREC_OKAY);
+            MATRECNetworkCandidatePool * pool = NULL;
+            ASSERT_EQ(MATRECcreateNetworkCandidatePool(env,&pool,dec),MATREC_OKAY);
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+
+            std::vector<std::vector<MATREC_row>> rows;
+            std::vector<std::vector<double>> values;
+            for(std::size_t col = 0; col < columns.size(); ++col){
+                rows.emplace_back();
+                values.emplace_back();
+                for(const auto & nonzero : columns[col]){
+                    rows[col].push_back(nonzero.index);
+                    values[col].push_back(nonzero.value);
+                }
+                ASSERT_EQ(MATRECNetworkCandidatePoolInsert(pool,col,rows[col].data(),values[col].data(),rows[col].size()),MATREC_OKAY);
+            }
+
+            std::vector<bool> added(columns.size(),false);
+            std::size_t numFreshChecks = 0;
+            while(true){
+                //The cached outcomes must equal those of checking every remaining candidate again
+                std::vector<MATREC_col> addable;
+                for(std::size_t col = 0; col < columns.size(); ++col){
+                    if(added[col]){
+                        continue;
+                    }
+                    bool isAddable = false;
+                    ASSERT_EQ(MATRECNetworkCandidatePoolIsAddable(pool,col,&isAddable),MATREC_OKAY);
+                    ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,rows[col].data(),values[col].data(),rows[col].size()),MATREC_OKAY);
+                    ++numFreshChecks;
+                    ASSERT_EQ(isAddable,MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                    if(isAddable){
+                        addable.push_back(col);
+                    }
+                }
+                if(addable.empty()){
+                    break;
+                }
+                MATREC_col col = addable[rng() % addable.size()];
+                ASSERT_EQ(MATRECNetworkCandidatePoolAdd(pool,col),MATREC_OKAY);
+                added[col] = true;
+            }
+            EXPECT_LT(MATRECNetworkCandidatePoolNumChecks(pool),numFreshChecks);
+
+            std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+            std::unique_ptr<bool[]> signStorage(new bool[testCase.rows]);
+            for(std::size_t col = 0; col < columns.size(); ++col){
+                if(added[col]){
+                    EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(dec,col,rows[col].data(),values[col].data(),rows[col].size(),
+                                                                      rowStorage.data(),signStorage.get()));
+                }
+            }
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECfreeNetworkCandidatePool(env,&pool);
+            MATRECNetworkDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+
+    TEST(NetworkCandidatePool,JoiningAdditions){
+        //Additions which join components re-root them, while the candidates within a single component stay cached
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            std::mt19937 rng(seed);
+            const std::size_t numBlocks = 4;
+            std::vector<std::size_t> blockStart;
+            std::vector<std::vector<Nonzero>> initialColumns;
+            std::vector<std::vector<Nonzero>> columns;
+            std::size_t numRows = 0;
+            for(std::size_t block = 0; block < numBlocks; ++block){
+                auto testCase = erdosRenyiDirectedTestCase(8,0.4,numBlocks * seed + block);
+                DirectedColTestCase colTestCase(testCase);
+                for(std::size_t col = 0; col < colTestCase.cols; ++col){
+                    std::vector<Nonzero> column;
+                    for(const auto & nonzero : colTestCase.matrix[col]){
+                        column.push_back(Nonzero{nonzero.index + MATREC_matrix_size(numRows),nonzero.value});
+                    }
+                    (col % 2 == 0 ? initialColumns : columns).push_back(column);
+                }
+                //Random columns within the block, which may or may not fit in
+                for(std::size_t i = 0; i < 4; ++i){
+                    std::vector<Nonzero> random;
+                    for(std::size_t row = 0; row < testCase.rows; ++row){
+                        if(rng() % 3 == 0){
+                            random.push_back(Nonzero{MATREC_matrix_size(row + numRows),rng() % 2 == 0 ? 1.0 : -1.0});
+                        }
+                    }
+                    columns.push_back(random);
+                }
+                blockStart.push_back(numRows);
+                numRows += testCase.rows;
+            }
+            blockStart.push_back(numRows);
+            //Columns which join two blocks
+            std::vector<bool> joining(columns.size(),false);
+            for(std::size_t i = 0; i < 2 * numBlocks; ++i){
+                std::size_t first = rng() % numBlocks;
+                std::size_t second = (first + 1 + rng() % (numBlocks - 1)) % numBlocks;
+                std::vector<Nonzero> column;
+                for(std::size_t block : {first,second}){
+                    std::size_t size = blockStart[block + 1] - blockStart[block];
+                    column.push_back(Nonzero{MATREC_matrix_size(blockStart[block] + rng() % size),rng() % 2 == 0 ? 1.0 : -1.0});
+                }
+                columns.push_back(column);
+                joining.push_back(true);
+            }
+            std::size_t numInitial = initialColumns.size();
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,numRows,numInitial + columns.size()),MATREC_OKAY);
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+            std::vector<MATREC_row> initialRows;
+            std::vector<double> initialValues;
+            for(std::size_t col = 0; col < numInitial; ++col){
+                initialRows.clear();
+                initialValues.clear();
+                for(const auto & nonzero : initialColumns[col]){
+                    initialRows.push_back(nonzero.index);
+                    initialValues.push_back(nonzero.value);
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,initialRows.data(),initialValues.data(),
+                                                           initialRows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+            }
+
+            MATRECNetworkCandidatePool * pool = NULL;
+            ASSERT_EQ(MATRECcreateNetworkCandidatePool(env,&pool,dec),MATREC_OKAY);
+            std::vector<std::vector<MATREC_row>> rows(columns.size());
+            std::vector<std::vector<double>> values(columns.size());
+            for(std::size_t i = 0; i < columns.size(); ++i){
+                for(const auto & nonzero : columns[i]){
+                    rows[i].push_back(nonzero.index);
+                    values[i].push_back(nonzero.value);
+                }
+                ASSERT_EQ(MATRECNetworkCandidatePoolInsert(pool,numInitial + i,rows[i].data(),values[i].data(),
+                                                           rows[i].size()),MATREC_OKAY);
+            }
+
+            std::vector<bool> added(columns.size(),false);
+            std::size_t numJoins = 0;
+            while(true){
+                //The cached outcomes must equal those of checking every remaining candidate again
+                std::vector<std::size_t> addable;
+                std::vector<std::size_t> addableJoining;
+                for(std::size_t i = 0; i < columns.size(); ++i){
+                    if(added[i]){
+                        continue;
+                    }
+                    bool isAddable = false;
+                    ASSERT_EQ(MATRECNetworkCandidatePoolIsAddable(pool,numInitial + i,&isAddable),MATREC_OKAY);
+                    ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,numInitial + i,rows[i].data(),
+                                                               values[i].data(),rows[i].size()),MATREC_OKAY);
+                    ASSERT_EQ(isAddable,MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                    if(isAddable){
+                        (joining[i] ? addableJoining : addable).push_back(i);
+                    }
+                }
+                if(addable.empty() && addableJoining.empty()){
+                    break;
+                }
+                //Join components whenever possible, so that many cached candidates are re-rooted
+                std::size_t i;
+                if(!addableJoining.empty()){
+                    i = addableJoining[rng() % addableJoining.size()];
+                    ++numJoins;
+                }else{
+                    i = addable[rng() % addable.size()];
+                }
+                ASSERT_EQ(MATRECNetworkCandidatePoolAdd(pool,numInitial + i),MATREC_OKAY);
+                added[i] = true;
+            }
+            EXPECT_GT(numJoins,0);
+
+            std::vector<MATREC_row> rowStorage(numRows,MATREC_INVALID_ROW);
+            std::unique_ptr<bool[]> signStorage(new bool[numRows]);
+            for(std::size_t i = 0; i < columns.size(); ++i){
+                if(added[i]){
+                    EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(dec,numInitial + i,rows[i].data(),values[i].data(),
+                                                                      rows[i].size(),rowStorage.data(),
+                                                                      signStorage.get()));
+                }
+            }
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECfreeNetworkCandidatePool(env,&pool);
+            MATRECNetworkDecompositionFree(&dec);
+            MATRECfreeEnvironment(&env);
+        }
+    }
+
+    TEST(NetworkColAddition,SpeculativeMatchesSequential){
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            auto testCase = erdosRenyiDirectedTestCase(40,0.1,seed);
+            DirectedColTestCase colTestCase(testCase);
+            std::mt19937 rng(seed);
+
+            //Odd seeds get a random column halfway, which may or may not be addable
+            std::vector<std::vector<Nonzero>> columns = colTestCase.matrix;
+            if(seed % 2 == 1){
+                std::vector<Nonzero> random;
+                for(std::size_t row = 0; row < testCase.rows; ++row){
+                    if(rng() % 4 == 0){
+                        random.push_back(Nonzero{MATREC_matrix_size(row),rng() % 2 == 0 ? 1.0 : -1.0});
+                    }
+                }
+                columns.insert(columns.begin() + columns.size() / 2,random);
+            }
+            std::vector<MATREC_matrix_size> starts = {0};
+            std::vector<MATREC_row> rows;
+            std::vector<double> values;
+            for(const auto & column : columns){
+                for(const auto & nonzero : column){
+                    rows.push_back(nonzero.index);
+                    values.push_back(nonzero.value);
+                }
+                starts.push_back(rows.size());
+            }
+
+            MATREC * env = NULL;
+            ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,columns.size()),MATREC_OKAY);
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+            MATREC_matrix_size numSequential = 0;
+            for(; numSequential < columns.size(); ++numSequential){
+                MATREC_matrix_size start = starts[numSequential];
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,numSequential,&rows[start],&values[start],
+                                                           starts[numSequential + 1] - start),MATREC_OKAY);
+                if(!MATRECNetworkColumnAdditionRemainsNetwork(newCol)){
+                    break;
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+            }
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&dec);
+
+            for(MATREC_index windowSize : {1,4,16}){
+                for(MATREC_index numThreads : {1,4}){
+                    ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,columns.size()),MATREC_OKAY);
+                    MATREC_matrix_size numAdded = 0;
+                    ASSERT_EQ(MATRECNetworkSpeculativeColumnAddition(dec,columns.size(),starts.data(),rows.data(),values.data(),
+                                                                     windowSize,numThreads,&numAdded),MATREC_OKAY);
+                    EXPECT_EQ(numAdded,numSequential);
+
+                    std::vector<MATREC_row> rowStorage(testCase.rows,MATREC_INVALID_ROW);
+                    std::unique_ptr<bool[]> signStorage(new bool[testCase.rows]);
+                    for(MATREC_matrix_size col = 0; col < numAdded; ++col){
+                        EXPECT_TRUE(MATRECNetworkDecompositionVerifyCycle(dec,col,&rows[starts[col]],&values[starts[col]],
+                                                                          starts[col + 1] - starts[col],
+                                                                          rowStorage.data(),signStorage.get()));
+                    }
+                    EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+                    MATRECNetworkDecompositionFree(&dec);
+                }
+            }
+            MATRECfreeEnvironment(&env);
+        }
+    }
+
+    TEST(NetworkBatch,MatchesSingleRecognition){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        //Recognizes the matrix column by column on a fresh decomposition, whereas the batch adds rows
+        auto isNetwork = [&](const DirectedTestCase& testCase){
+            DirectedColTestCase colCase(testCase);
+            MATRECNetworkDecomposition * dec = NULL;
+            MATRECNetworkColumnAddition * newCol = NULL;
+            EXPECT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+            EXPECT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+            bool network = true;
+            for(std::size_t col = 0; col < colCase.cols && network; ++col){
+                std::vector<MATREC_row> rows;
+                std::vector<double> values;
+                for(const auto& nonz : colCase.matrix[col]){
+                    rows.push_back(nonz.index);
+                    values.push_back(nonz.value);
+                }
+                EXPECT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+                network = MATRECNetworkColumnAdditionRemainsNetwork(newCol);
+                if(network){
+                    EXPECT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+                }
+            }
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&dec);
+            return network;
+        };
+        auto toIntMatrix = [&](const DirectedTestCase& testCase){
+            std::vector<MATRECIntMatrixTriplet> triplets;
+            for(std::size_t row = 0; row < testCase.rows; ++row){
+                for(const auto& nonz : testCase.matrix[row]){
+                    triplets.push_back({MATREC_row(row),nonz.index,int(nonz.value)});
+                }
+            }
+            std::sort(triplets.begin(),triplets.end(),[](const auto& a, const auto& b){
+                return a.row < b.row || (a.row == b.row && a.column < b.column);
+            });
+            MATRECCSMatrixInt * matrix = NULL;
+            EXPECT_EQ(MATRECcreateIntMatrixWithNonzeros(env,&matrix,testCase.rows,testCase.cols,triplets.size(),
+                                                        triplets.data()),MATREC_OKAY);
+            return matrix;
+        };
+
+        std::vector<DirectedTestCase> testCases;
+        for(std::size_t seed = 0; seed < 300; ++seed){
+            if(seed % 3 == 0){
+                testCases.push_back(erdosRenyiDirectedTestCase(6 + seed % 10,0.3,seed));
+            }else{
+                testCases.push_back(seedToDirectedTestCase(seed,2 + seed % 5,2 + seed % 6));
+            }
+        }
+        std::vector<MATRECCSMatrixInt *> matrices;
+        std::vector<uint64_t> expected(MATREC_SIGN_WORDS(testCases.size()),0);
+        for(std::size_t i = 0; i < testCases.size(); ++i){
+            matrices.push_back(toIntMatrix(testCases[i]));
+            if(isNetwork(testCases[i])){
+                expected[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+        for(MATREC_index threads : {1,3,8}){
+            std::vector<uint64_t> result(expected.size(),0);
+            ASSERT_EQ(MATRECNetworkRecognizeMatrices(env,matrices.data(),matrices.size(),threads,result.data()),MATREC_OKAY);
+            EXPECT_EQ(result,expected);
+        }
+
+        //Small submatrices of a random matrix, of which only some are network
+        DirectedTestCase large = seedToDirectedTestCase(99,40,40);
+        MATRECCSMatrixInt * largeMatrix = toIntMatrix(large);
+        std::mt19937 gen(1);
+        std::vector<MATRECSubMatrix *> subMatrices;
+        std::vector<uint64_t> expectedSub(MATREC_SIGN_WORDS(200),0);
+        for(std::size_t i = 0; i < 200; ++i){
+            std::vector<MATREC_matrix_size> rows(40);
+            std::vector<MATREC_matrix_size> cols(40);
+            std::iota(rows.begin(),rows.end(),0);
+            std::iota(cols.begin(),cols.end(),0);
+            std::shuffle(rows.begin(),rows.end(),gen);
+            std::shuffle(cols.begin(),cols.end(),gen);
+            rows.resize(i % 6);
+            cols.resize(1 + i % 5);
+            MATRECSubMatrix * subMatrix = NULL;
+            ASSERT_EQ(MATRECcreateSubMatrix(env,rows.size(),cols.size(),&subMatrix),MATREC_OKAY);
+            std::copy(rows.begin(),rows.end(),subMatrix->rows);
+            std::copy(cols.begin(),cols.end(),subMatrix->columns);
+            subMatrices.push_back(subMatrix);
+
+            std::vector<std::vector<Nonzero>> subRows(rows.size());
+            for(std::size_t row = 0; row < rows.size(); ++row){
+                for(const auto& nonz : large.matrix[rows[row]]){
+                    auto it = std::find(cols.begin(),cols.end(),nonz.index);
+                    if(it != cols.end()){
+                        subRows[row].push_back(Nonzero{.index = MATREC_matrix_size(it - cols.begin()),.value = nonz.value});
+                    }
+                }
+            }
+            if(isNetwork(DirectedTestCase(subRows,rows.size(),cols.size()))){
+                expectedSub[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+        EXPECT_NE(expectedSub[0],0);
+        EXPECT_NE(expectedSub[0],~uint64_t(0));
+        for(MATREC_index threads : {1,4}){
+            std::vector<uint64_t> result(expectedSub.size(),0);
+            ASSERT_EQ(MATRECNetworkRecognizeSubMatrices(env,largeMatrix,subMatrices.data(),subMatrices.size(),threads,
+                                                        result.data()),MATREC_OKAY);
+            EXPECT_EQ(result,expectedSub);
+        }
+
+        MATRECCompressedSparseMatrixPairInt * pair = NULL;
+        ASSERT_EQ(MATRECcreateIntMatrixPair(env,largeMatrix,&pair),MATREC_OKAY);
+        for(std::size_t i = 0; i < subMatrices.size(); ++i){
+            bool network = false;
+            ASSERT_EQ(MATRECNetworkRecognizeSubMatrix(env,pair,subMatrices[i],&network),MATREC_OKAY);
+            EXPECT_EQ(network,bool((expectedSub[i / 64] >> (i % 64)) & 1));
+        }
+
+        for(auto * subMatrix : subMatrices){
+            MATRECfreeSubMatrix(env,&subMatrix);
+        }
+        MATRECfreeIntMatrixPair(env,&pair);
+        for(auto * matrix : matrices){
+            MATRECfreeIntMatrix(env,&matrix);
+        }
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(NetworkReaders,ConsistentWhileAdding){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        DirectedColTestCase testCase(erdosRenyiDirectedTestCase(40,0.1,5));
+        MATRECNetworkDecomposition * dec = NULL;
+        ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+        ASSERT_EQ(MATRECNetworkDecompositionEnableReaders(dec),MATREC_OKAY);
+
+        //Readers check that every column in a published replica has the correct cycle, and that replicas only grow
+        std::atomic<bool> done = false;
+        std::atomic<std::size_t> numFailures = 0;
+        auto reader = [&](std::size_t seed){
+            std::mt19937 gen(seed);
+            std::vector<MATREC_row> rows(testCase.rows);
+            std::unique_ptr<bool[]> reversed(new bool[testCase.rows]);
+            std::size_t lastNumColumns = 0;
+            while(!done){
+                const MATRECNetworkDecomposition * replica = MATRECNetworkDecompositionBeginRead(dec);
+                std::size_t numColumns = 0;
+                for(std::size_t col = 0; col < testCase.cols; ++col){
+                    numColumns += MATRECNetworkDecompositionContainsColumn(replica,col);
+                }
+                MATREC_col col = gen() % testCase.cols;
+                if(MATRECNetworkDecompositionContainsColumn(replica,col)){
+                    MATREC_matrix_size numRows = 0;
+                    if(MATRECNetworkDecompositionFundamentalCycle(replica,col,rows.data(),reversed.get(),&numRows) != MATREC_OKAY ||
+                       numRows != testCase.matrix[col].size()){
+                        ++numFailures;
+                    }
+                    for(MATREC_matrix_size i = 0; i < numRows; ++i){
+                        auto it = std::find_if(testCase.matrix[col].begin(),testCase.matrix[col].end(),
+                                               [&](const Nonzero& nonz){return nonz.index == rows[i];});
+                        if(it == testCase.matrix[col].end() || (it->value < 0.0) != reversed[i]){
+                            ++numFailures;
+                        }
+                    }
+                }
+                MATRECNetworkDecompositionEndRead(dec,replica);
+                if(numColumns < lastNumColumns){
+                    ++numFailures;
+                }
+                lastNumColumns = numColumns;
+            }
+        };
+        std::vector<std::thread> readers;
+        for(std::size_t i = 0; i < 3; ++i){
+            readers.emplace_back(reader,i);
+        }
+        MATRECNetworkColumnAddition * newCol = NULL;
+        ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+        for(std::size_t col = 0; col < testCase.cols; ++col){
+            std::vector<MATREC_row> rows;
+            std::vector<double> values;
+            for(const auto& nonz : testCase.matrix[col]){
+                rows.push_back(nonz.index);
+                values.push_back(nonz.value);
+            }
+            ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+            ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+            ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+        }
+        done = true;
+        for(auto& thread : readers){
+            thread.join();
+        }
+        EXPECT_EQ(numFailures,0);
+
+        const MATRECNetworkDecomposition * replica = MATRECNetworkDecompositionBeginRead(dec);
+        for(std::size_t col = 0; col < testCase.cols; ++col){
+            EXPECT_TRUE(MATRECNetworkDecompositionContainsColumn(replica,col));
+        }
+        MATRECNetworkDecompositionEndRead(dec,replica);
+        MATRECfreeNetworkColumnAddition(env,&newCol);
+        MATRECNetworkDecompositionFree(&dec);
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(NetworkReaders,MatchesAfterRowAdditions){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        //Row additions split and merge members throughout the decomposition, so the replicas, which only receive the
+        //changed elements, are compared to the decomposition after every addition, also after a reset
+        auto compareReplica = [&](MATRECNetworkDecomposition * dec, std::size_t numRows, std::size_t numColumns){
+            const MATRECNetworkDecomposition * replica = MATRECNetworkDecompositionBeginRead(dec);
+            std::vector<MATREC_row> rows(numRows);
+            std::vector<MATREC_row> replicaRows(numRows);
+            std::unique_ptr<bool[]> reversed(new bool[numRows]);
+            std::unique_ptr<bool[]> replicaReversed(new bool[numRows]);
+            for(MATREC_col col = 0; col < numColumns; ++col){
+                ASSERT_EQ(MATRECNetworkDecompositionContainsColumn(replica,col),
+                          MATRECNetworkDecompositionContainsColumn(dec,col));
+                if(!MATRECNetworkDecompositionContainsColumn(dec,col)){
+                    continue;
+                }
+                MATRECElement element = {col,false};
+                MATRECElement first = {0,false};
+                EXPECT_EQ(MATRECNetworkDecompositionMemberType(replica,element),
+                          MATRECNetworkDecompositionMemberType(dec,element));
+                EXPECT_EQ(MATRECNetworkDecompositionSameComponent(replica,first,element),
+                          MATRECNetworkDecompositionSameComponent(dec,first,element));
+                MATREC_matrix_size numCycleRows = 0;
+                MATREC_matrix_size numReplicaRows = 0;
+                ASSERT_EQ(MATRECNetworkDecompositionFundamentalCycle(dec,col,rows.data(),reversed.get(),&numCycleRows),
+                          MATREC_OKAY);
+                ASSERT_EQ(MATRECNetworkDecompositionFundamentalCycle(replica,col,replicaRows.data(),
+                                                                     replicaReversed.get(),&numReplicaRows),MATREC_OKAY);
+                ASSERT_EQ(numCycleRows,numReplicaRows);
+                for(MATREC_matrix_size i = 0; i < numCycleRows; ++i){
+                    EXPECT_EQ(rows[i],replicaRows[i]);
+                    EXPECT_EQ(reversed[i],replicaReversed[i]);
+                }
+            }
+            MATRECNetworkDecompositionEndRead(dec,replica);
+        };
+        for(std::size_t seed = 0; seed < 10; ++seed){
+            auto testCase = erdosRenyiDirectedTestCase(20,0.3,seed);
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+            ASSERT_EQ(MATRECNetworkDecompositionEnableReaders(dec),MATREC_OKAY);
+            MATRECNetworkRowAddition * newRow = NULL;
+            ASSERT_EQ(MATRECcreateNetworkRowAddition(env,&newRow),MATREC_OKAY);
+            std::vector<MATREC_col> cols;
+            std::vector<double> values;
+            for(std::size_t round = 0; round < 2; ++round){
+                for(std::size_t row = 0; row < testCase.rows; ++row){
+                    cols.clear();
+                    values.clear();
+                    for(const auto & nonzero : testCase.matrix[row]){
+                        cols.push_back(nonzero.index);
+                        values.push_back(nonzero.value);
+                    }
+                    ASSERT_EQ(MATRECNetworkRowAdditionCheck(dec,newRow,row,cols.data(),values.data(),cols.size()),
+                              MATREC_OKAY);
+                    ASSERT_TRUE(MATRECNetworkRowAdditionRemainsNetwork(newRow));
+                    ASSERT_EQ(MATRECNetworkRowAdditionAdd(dec,newRow),MATREC_OKAY);
+                    compareReplica(dec,testCase.rows,testCase.cols);
+                }
+                MATRECNetworkDecompositionReset(dec);
+            }
+            MATRECfreeNetworkRowAddition(env,&newRow);
+            MATRECNetworkDecompositionFree(&dec);
+        }
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(NetworkQueries,ComponentsTypesAndOrientations){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        std::size_t numRigidChecks = 0;
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            DirectedColTestCase testCase(erdosRenyiDirectedTestCase(25,0.08,seed));
+            MATRECNetworkDecomposition * dec = NULL;
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+
+            //Components of the added columns and their rows, where column i is element rows + i
+            std::vector<int> representative(testCase.rows + testCase.cols,-1);
+            auto element = [&](std::size_t index){
+                return index < testCase.rows ? MATRECElement{MATREC_matrix_size(index),true} : MATRECElement{MATREC_matrix_size(index - testCase.rows),false};
+            };
+            for(std::size_t col = 0; col < testCase.cols; ++col){
+                std::vector<MATREC_row> rows;
+                std::vector<double> values;
+                for(const auto& nonz : testCase.matrix[col]){
+                    rows.push_back(nonz.index);
+                    values.push_back(nonz.value);
+                    int first = findRepresentative(int(nonz.index),representative);
+                    int second = findRepresentative(int(testCase.rows + col),representative);
+                    if(first != second){
+                        makeUnion(representative,first,second);
+                    }
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+
+                for(std::size_t first = 0; first < representative.size(); ++first){
+                    MATRECElement firstElement = element(first);
+                    bool contained = firstElement.isRow ? MATRECNetworkDecompositionContainsRow(dec,firstElement.index) :
+                                     MATRECNetworkDecompositionContainsColumn(dec,firstElement.index);
+                    MATRECMemberType type = MATRECNetworkDecompositionMemberType(dec,firstElement);
+                    EXPECT_EQ(type == MATREC_MEMBER_NOT_CONTAINED,!contained);
+                    for(std::size_t second = first; second < representative.size(); ++second){
+                        MATRECElement secondElement = element(second);
+                        bool secondContained = secondElement.isRow ?
+                                MATRECNetworkDecompositionContainsRow(dec,secondElement.index) :
+                                MATRECNetworkDecompositionContainsColumn(dec,secondElement.index);
+                        bool expected = contained && secondContained &&
+                                        findRepresentative(int(first),representative) ==
+                                        findRepresentative(int(second),representative);
+                        EXPECT_EQ(MATRECNetworkDecompositionSameComponent(dec,firstElement,secondElement),expected);
+
+                        bool reversed = false;
+                        if(!MATRECNetworkDecompositionRelativeOrientation(dec,firstElement,secondElement,&reversed)){
+                            continue;
+                        }
+                        EXPECT_EQ(type,MATREC_MEMBER_RIGID);
+                        EXPECT_EQ(MATRECNetworkDecompositionMemberType(dec,secondElement),MATREC_MEMBER_RIGID);
+                        bool backwards = false;
+                        EXPECT_TRUE(MATRECNetworkDecompositionRelativeOrientation(dec,secondElement,firstElement,&backwards));
+                        EXPECT_EQ(reversed,backwards);
+                        EXPECT_EQ(reversed && first == second,false);
+                        //Orientations relative to a third arc of the member must compose
+                        for(std::size_t third = 0; third < representative.size(); ++third){
+                            bool firstThird = false;
+                            bool secondThird = false;
+                            if(MATRECNetworkDecompositionRelativeOrientation(dec,firstElement,element(third),&firstThird)){
+                                EXPECT_TRUE(MATRECNetworkDecompositionRelativeOrientation(dec,secondElement,element(third),
+                                                                                          &secondThird));
+                                EXPECT_EQ(firstThird != secondThird,reversed);
+                                ++numRigidChecks;
+                            }
+                        }
+                    }
+                }
+            }
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&dec);
+        }
+        EXPECT_GT(numRigidChecks,0);
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(NetworkQueries,CreateMatrix){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        for(std::size_t seed = 0; seed < 20; ++seed){
+            DirectedColTestCase testCase(erdosRenyiDirectedTestCase(30,seed % 2 == 0 ? 0.05 : 0.2,seed));
+            MATRECNetworkDecomposition * dec = NULL;
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+
+            std::vector<MATRECIntMatrixTriplet> expected;
+            MATREC_matrix_size largestRow = 0;
+            for(std::size_t col = 0; col < testCase.cols; ++col){
+                std::vector<MATREC_row> rows;
+                std::vector<double> values;
+                for(const auto& nonz : testCase.matrix[col]){
+                    rows.push_back(nonz.index);
+                    values.push_back(nonz.value);
+                    expected.push_back({nonz.index,MATREC_col(col),nonz.value < 0.0 ? -1 : 1});
+                    largestRow = std::max(largestRow,nonz.index + 1);
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,col,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+            }
+            std::sort(expected.begin(),expected.end(),[](const MATRECIntMatrixTriplet& a, const MATRECIntMatrixTriplet& b){
+                return a.row < b.row || (a.row == b.row && a.column < b.column);
+            });
+
+            MATRECCSMatrixInt * matrix = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreateMatrix(dec,&matrix),MATREC_OKAY);
+            ASSERT_EQ(matrix->numRows,largestRow);
+            ASSERT_EQ(matrix->numNonzeros,expected.size());
+            for(MATREC_row row = 0; row < matrix->numRows; ++row){
+                for(MATREC_matrix_size i = matrix->firstRowIndex[row]; i < matrix->firstRowIndex[row + 1]; ++i){
+                    EXPECT_EQ(expected[i].row,row);
+                    EXPECT_EQ(expected[i].column,matrix->entryColumns[i]);
+                    EXPECT_EQ(expected[i].value,matrix->entryValues[i]);
+                }
+            }
+            MATRECfreeIntMatrix(env,&matrix);
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&dec);
+        }
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(NetworkQueries,CreateFromGraph){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        std::size_t numRigid = 0;
+        for(std::size_t seed = 0; seed < 60; ++seed){
+            //A random directed graph, whose row edges form a spanning forest with some isolated nodes
+            std::minstd_rand gen(seed);
+            std::size_t numNodes = 2 + seed % 25;
+            std::vector<std::size_t> parent(numNodes,0);
+            std::vector<std::size_t> depth(numNodes,0);
+            std::vector<std::size_t> root(numNodes,0);
+            std::vector<MATREC_matrix_size> tails;
+            std::vector<MATREC_matrix_size> heads;
+            std::vector<MATRECElement> elements;
+            std::vector<MATREC_row> parentRow(numNodes,0);
+            for(std::size_t node = 0; node < numNodes; ++node){
+                root[node] = node;
+                if(node == 0 || gen() % 10 == 0){
+                    continue;
+                }
+                std::size_t other = gen() % node;
+                parent[node] = other;
+                depth[node] = depth[other] + 1;
+                root[node] = root[other];
+                parentRow[node] = tails.size();
+                bool down = gen() % 2 == 0;
+                tails.push_back(down ? other : node);
+                heads.push_back(down ? node : other);
+                elements.push_back({parentRow[node],true});
+            }
+            std::size_t numRows = tails.size();
+            std::size_t numColumns = numNodes * (1 + seed % 3);
+            std::vector<std::vector<std::pair<MATREC_row,int>>> columns;
+            for(std::size_t col = 0; col < numColumns; ++col){
+                std::size_t tail = gen() % numNodes;
+                std::size_t head = gen() % numNodes;
+                if(root[head] != root[tail]){
+                    head = root[tail];
+                }
+                //The path from the tail to the head, where edges from a node to its parent are forwards if the
+                //node is their tail
+                std::vector<std::pair<MATREC_row,int>> column;
+                std::size_t first = tail;
+                std::size_t second = head;
+                while(first != second){
+                    if(depth[first] >= depth[second]){
+                        MATREC_row row = parentRow[first];
+                        column.push_back({row,tails[row] == first ? 1 : -1});
+                        first = parent[first];
+                    }else{
+                        MATREC_row row = parentRow[second];
+                        column.push_back({row,heads[row] == second ? 1 : -1});
+                        second = parent[second];
+                    }
+                }
+                columns.push_back(column);
+                tails.push_back(tail);
+                heads.push_back(head);
+                elements.push_back({MATREC_matrix_size(col),false});
+            }
+            //Mix the rows and columns
+            std::vector<std::size_t> order(tails.size());
+            std::iota(order.begin(),order.end(),0);
+            std::shuffle(order.begin(),order.end(),gen);
+            std::vector<MATREC_matrix_size> shuffledTails;
+            std::vector<MATREC_matrix_size> shuffledHeads;
+            std::vector<MATRECElement> shuffledElements;
+            for(std::size_t index : order){
+                shuffledTails.push_back(tails[index]);
+                shuffledHeads.push_back(heads[index]);
+                shuffledElements.push_back(elements[index]);
+            }
+
+            MATRECNetworkDecomposition * dec = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreateFromGraph(env,&dec,numNodes,shuffledTails.size(),shuffledTails.data(),
+                                                                shuffledHeads.data(),shuffledElements.data()),MATREC_OKAY);
+            EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+
+            //The same matrix, built one column at a time
+            MATRECNetworkDecomposition * incremental = NULL;
+            MATRECNetworkColumnAddition * newCol = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&incremental,numRows,numColumns),MATREC_OKAY);
+            ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+            std::vector<MATRECIntMatrixTriplet> expected;
+            std::vector<bool> rowUsed(numRows,false);
+            for(std::size_t col = 0; col < numColumns; ++col){
+                std::vector<MATREC_row> rows;
+                std::vector<double> values;
+                for(const auto& [row, value] : columns[col]){
+                    rows.push_back(row);
+                    values.push_back(value);
+                    rowUsed[row] = true;
+                    expected.push_back({row,MATREC_col(col),value});
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(incremental,newCol,col,rows.data(),values.data(),rows.size()),
+                          MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(incremental,newCol),MATREC_OKAY);
+            }
+            std::sort(expected.begin(),expected.end(),[](const MATRECIntMatrixTriplet& a, const MATRECIntMatrixTriplet& b){
+                return a.row < b.row || (a.row == b.row && a.column < b.column);
+            });
+
+            MATRECCSMatrixInt * matrix = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreateMatrix(dec,&matrix),MATREC_OKAY);
+            ASSERT_EQ(matrix->numRows,numRows);
+            ASSERT_EQ(matrix->numNonzeros,expected.size());
+            for(MATREC_row row = 0; row < matrix->numRows; ++row){
+                for(MATREC_matrix_size i = matrix->firstRowIndex[row]; i < matrix->firstRowIndex[row + 1]; ++i){
+                    EXPECT_EQ(expected[i].row,row);
+                    EXPECT_EQ(expected[i].column,matrix->entryColumns[i]);
+                    EXPECT_EQ(expected[i].value,matrix->entryValues[i]);
+                }
+            }
+            MATRECfreeIntMatrix(env,&matrix);
+
+            //Rows without nonzeros are bridges of the graph, which form a loop by themselves
+            auto element = [&](std::size_t index){
+                return index < numRows ? MATRECElement{MATREC_matrix_size(index),true} : MATRECElement{MATREC_matrix_size(index - numRows),false};
+            };
+            auto isBridge = [&](std::size_t index){
+                return index < numRows && !rowUsed[index];
+            };
+            for(std::size_t first = 0; first < numRows + numColumns; ++first){
+                MATRECMemberType type = MATRECNetworkDecompositionMemberType(dec,element(first));
+                EXPECT_EQ(type,isBridge(first) ? MATREC_MEMBER_LOOP :
+                               MATRECNetworkDecompositionMemberType(incremental,element(first)));
+                numRigid += type == MATREC_MEMBER_RIGID;
+                for(std::size_t second = 0; second < numRows + numColumns; ++second){
+                    bool same = MATRECNetworkDecompositionSameComponent(dec,element(first),element(second));
+                    bool expectedReversed = false;
+                    bool expectedOriented = false;
+                    if(isBridge(first) || isBridge(second)){
+                        EXPECT_EQ(same,first == second);
+                    }else{
+                        EXPECT_EQ(same,MATRECNetworkDecompositionSameComponent(incremental,element(first),element(second)));
+                        expectedOriented = MATRECNetworkDecompositionRelativeOrientation(incremental,element(first),
+                                                                                         element(second),&expectedReversed);
+                    }
+                    //The relative orientations themselves depend on how the arcs of a rigid member are stored
+                    bool reversed = false;
+                    EXPECT_EQ(MATRECNetworkDecompositionRelativeOrientation(dec,element(first),element(second),&reversed),
+                              expectedOriented);
+                }
+            }
+
+            //A decomposition of some of the columns can be extended with the others
+            std::size_t numGraphColumns = numColumns / 2;
+            MATRECNetworkDecomposition * partial = NULL;
+            ASSERT_EQ(MATRECNetworkDecompositionCreateFromGraph(env,&partial,numNodes,numRows + numGraphColumns,
+                                                                tails.data(),heads.data(),elements.data()),MATREC_OKAY);
+            for(std::size_t col = numGraphColumns; col < numColumns; ++col){
+                std::vector<MATREC_row> rows;
+                std::vector<double> values;
+                for(const auto& [row, value] : columns[col]){
+                    rows.push_back(row);
+                    values.push_back(value);
+                }
+                ASSERT_EQ(MATRECNetworkColumnAdditionCheck(partial,newCol,col,rows.data(),values.data(),rows.size()),
+                          MATREC_OKAY);
+                ASSERT_TRUE(MATRECNetworkColumnAdditionRemainsNetwork(newCol));
+                ASSERT_EQ(MATRECNetworkColumnAdditionAdd(partial,newCol),MATREC_OKAY);
+            }
+            ASSERT_EQ(MATRECNetworkDecompositionCreateMatrix(partial,&matrix),MATREC_OKAY);
+            ASSERT_EQ(matrix->numNonzeros,expected.size());
+            for(MATREC_matrix_size i = 0; i < matrix->numNonzeros; ++i){
+                EXPECT_EQ(expected[i].column,matrix->entryColumns[i]);
+                EXPECT_EQ(expected[i].value,matrix->entryValues[i]);
+            }
+            MATRECfreeIntMatrix(env,&matrix);
+            MATRECNetworkDecompositionFree(&partial);
+
+            MATRECfreeNetworkColumnAddition(env,&newCol);
+            MATRECNetworkDecompositionFree(&incremental);
+            MATRECNetworkDecompositionFree(&dec);
+        }
+        EXPECT_GT(numRigid,0);
+
+        //Rows which contain a cycle and columns whose endpoints are not joined by rows do not form a realization
+        MATRECNetworkDecomposition * dec = NULL;
+        std::vector<MATREC_matrix_size> tails = {0,1,2};
+        std::vector<MATREC_matrix_size> heads = {1,2,0};
+        std::vector<MATRECElement> cycle = {{0,true},{1,true},{2,true}};
+        EXPECT_EQ(MATRECNetworkDecompositionCreateFromGraph(env,&dec,3,3,tails.data(),heads.data(),cycle.data()),
+                  MATREC_ERROR_INPUT);
+        std::vector<MATRECElement> disconnected = {{0,true},{0,false},{1,false}};
+        tails = {0,0,2};
+        heads = {1,1,1};
+        EXPECT_EQ(MATRECNetworkDecompositionCreateFromGraph(env,&dec,3,3,tails.data(),heads.data(),disconnected.data()),
+                  MATREC_ERROR_INPUT);
+        EXPECT_EQ(dec,nullptr);
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(Matrix,CountSubMatrixNonzeros){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        DirectedTestCase testCase = seedToDirectedTestCase(3,20,70);
+        std::vector<MATRECIntMatrixTriplet> triplets;
+        std::vector<MATRECMatrixTripletDouble> doubleTriplets;
+        for(std::size_t row = 0; row < testCase.rows; ++row){
+            for(const auto& nonz : testCase.matrix[row]){
+                triplets.push_back({MATREC_row(row),nonz.index,int(nonz.value)});
+                doubleTriplets.push_back({MATREC_row(row),nonz.index,nonz.value});
+            }
+        }
+        MATRECCSMatrixInt * matrix = NULL;
+        ASSERT_EQ(MATRECcreateIntMatrixWithNonzeros(env,&matrix,testCase.rows,testCase.cols,triplets.size(),
+                                                    triplets.data()),MATREC_OKAY);
+        MATRECCSMatrixDouble * doubleMatrix = NULL;
+        ASSERT_EQ(MATRECcreateDoubleMatrixWithNonzeros(env,&doubleMatrix,testCase.rows,testCase.cols,
+                                                       doubleTriplets.size(),doubleTriplets.data()),MATREC_OKAY);
+        //The marks are reused for all submatrices, so they must be zero again after each count
+        std::vector<uint64_t> columnMarks(MATREC_SIGN_WORDS(testCase.cols),0);
+        std::mt19937 gen(2);
+        for(std::size_t i = 0; i < 50; ++i){
+            std::vector<MATREC_matrix_size> rows(testCase.rows);
+            std::vector<MATREC_matrix_size> cols(testCase.cols);
+            std::iota(rows.begin(),rows.end(),0);
+            std::iota(cols.begin(),cols.end(),0);
+            std::shuffle(rows.begin(),rows.end(),gen);
+            std::shuffle(cols.begin(),cols.end(),gen);
+            rows.resize(i % testCase.rows);
+            cols.resize(i % testCase.cols);
+            MATRECSubMatrix * subMatrix = NULL;
+            ASSERT_EQ(MATRECcreateSubMatrix(env,rows.size(),cols.size(),&subMatrix),MATREC_OKAY);
+            std::copy(rows.begin(),rows.end(),subMatrix->rows);
+            std::copy(cols.begin(),cols.end(),subMatrix->columns);
+
+            MATREC_matrix_size expected = 0;
+            for(auto row : rows){
+                for(const auto& nonz : testCase.matrix[row]){
+                    expected += std::count(cols.begin(),cols.end(),nonz.index);
+                }
+            }
+            EXPECT_EQ(MATRECcountIntSubMatrixNonzerosMarked(subMatrix,matrix,columnMarks.data()),expected);
+            EXPECT_EQ(MATRECcountDoubleSubMatrixNonzerosMarked(subMatrix,doubleMatrix,columnMarks.data()),expected);
+            EXPECT_TRUE(std::all_of(columnMarks.begin(),columnMarks.end(),[](uint64_t word){ return word == 0; }));
+
+            std::sort(subMatrix->columns,subMatrix->columns + subMatrix->numColumns);
+            EXPECT_EQ(MATRECcountIntSubMatrixNonzeros(subMatrix,matrix),expected);
+            EXPECT_EQ(MATRECcountDoubleSubMatrixNonzeros(subMatrix,doubleMatrix),expected);
+            MATRECfreeSubMatrix(env,&subMatrix);
+        }
+        MATRECfreeDoubleMatrix(env,&doubleMatrix);
+        MATRECfreeIntMatrix(env,&matrix);
+        MATRECfreeEnvironment(&env);
+    }
+
+    TEST(Matrix,TernaryAndBinary){
+        MATREC * env = NULL;
+        ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+        //The lengths cover the vectorized blocks and the remainders after them
+        for(MATREC_matrix_size size = 0; size < 70; ++size){
+            MATRECCSMatrixInt * matrix = NULL;
+            ASSERT_EQ(MATRECcreateIntMatrix(env,&matrix,1,size,size),MATREC_OKAY);
+            std::fill(matrix->entryValues,matrix->entryValues + size,1);
+            EXPECT_TRUE(MATRECintMatrixIsBinary(matrix));
+            EXPECT_TRUE(MATRECintMatrixIsTernary(matrix));
+            for(MATREC_matrix_size position = 0; position < size; ++position){
+                matrix->entryValues[position] = -1;
+                EXPECT_FALSE(MATRECintMatrixIsBinary(matrix));
+                EXPECT_TRUE(MATRECintMatrixIsTernary(matrix));
+                for(int value : {0,2,-2,INT_MIN}){
+                    matrix->entryValues[position] = value;
+                    EXPECT_FALSE(MATRECintMatrixIsBinary(matrix));
+                    EXPECT_FALSE(MATRECintMatrixIsTernary(matrix));
+                }
+                matrix->entryValues[position] = 1;
+            }
+            MATRECfreeIntMatrix(env,&matrix);
+        }
+        MATRECfreeEnvironment(&env);
+    }
+}
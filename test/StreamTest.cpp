@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "TestHelpers.h"
+#include <matrec/Stream.h>
+
+///Writes the matrix in the text format, grouping the nonzeros by row or by column
+FILE * writeTestCase(const DirectedTestCase & testCase, bool byColumn){
+    std::vector<std::vector<Nonzero>> columns(testCase.cols);
+    std::size_t numNonzeros = 0;
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        for(const auto & nonzero : testCase.matrix[row]){
+            columns[nonzero.index].push_back(Nonzero{.index = MATREC_matrix_size(row), .value = nonzero.value});
+            ++numNonzeros;
+        }
+    }
+    FILE * file = tmpfile();
+    fprintf(file,"%lu %lu %lu\n\n",testCase.rows,testCase.cols,numNonzeros);
+    if(byColumn){
+        for(std::size_t column = 0; column < testCase.cols; ++column){
+            for(const auto & nonzero : columns[column]){
+                fprintf(file,"%lu %lu %f\n",nonzero.index + 1,column + 1,nonzero.value);
+            }
+        }
+    }else{
+        for(std::size_t row = 0; row < testCase.rows; ++row){
+            for(const auto & nonzero : testCase.matrix[row]){
+                fprintf(file,"%lu %lu %f\n",row + 1,nonzero.index + 1,nonzero.value);
+            }
+        }
+    }
+    rewind(file);
+    return file;
+}
+
+TEST(Stream, NetworkMatrices){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    for(std::size_t seed = 0; seed < 20; ++seed){
+        auto testCase = erdosRenyiDirectedTestCase(30,0.2,seed);
+        for(auto orientation : {MATREC_STREAM_COLUMNS,MATREC_STREAM_ROWS}){
+            for(MATREC_matrix_size capacity : {1,4,64}){
+                FILE * file = writeTestCase(testCase,orientation == MATREC_STREAM_COLUMNS);
+                MATRECStreamResult result;
+                MATRECNetworkDecomposition * dec = NULL;
+                ASSERT_EQ(MATRECNetworkStreamRecognize(env,file,orientation,capacity,&result,&dec),MATREC_OKAY);
+                fclose(file);
+                EXPECT_TRUE(result.isNetwork);
+                EXPECT_EQ(result.failedIndex,MATREC_INVALID);
+                EXPECT_EQ(result.numAdded,orientation == MATREC_STREAM_COLUMNS ? testCase.cols : testCase.rows);
+                ASSERT_NE(dec,nullptr);
+                EXPECT_TRUE(MATRECNetworkDecompositionIsMinimal(dec));
+                MATRECNetworkDecompositionFree(&dec);
+            }
+        }
+    }
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Stream, NonNetworkMatrix){
+    //The 3x3 matrix with all off-diagonal entries 1 has determinant 2, so it is not totally unimodular
+    DirectedTestCase testCase({{{1,1.0},{2,1.0}},{{0,1.0},{2,1.0}},{{0,1.0},{1,1.0}}},3,3);
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    for(auto orientation : {MATREC_STREAM_COLUMNS,MATREC_STREAM_ROWS}){
+        FILE * file = writeTestCase(testCase,orientation == MATREC_STREAM_COLUMNS);
+        MATRECStreamResult result;
+        ASSERT_EQ(MATRECNetworkStreamRecognize(env,file,orientation,1,&result,NULL),MATREC_OKAY);
+        fclose(file);
+        EXPECT_FALSE(result.isNetwork);
+        EXPECT_EQ(result.numAdded,2);
+        EXPECT_EQ(result.failedIndex,2);
+    }
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Stream, NonConsecutiveColumn){
+    std::string input = "2 2 3\n1 1 1\n2 2 1\n2 1 1\n";
+    FILE * file = fmemopen(input.data(),input.size(),"r");
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    MATRECStreamResult result;
+    EXPECT_EQ(MATRECNetworkStreamRecognize(env,file,MATREC_STREAM_COLUMNS,2,&result,NULL),MATREC_ERROR_INPUT);
+    fclose(file);
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Stream, FailedAddition){
+    //With a memory limit, the additions fail partway through the stream, but nothing is leaked
+    auto testCase = erdosRenyiDirectedTestCase(200,0.05,1);
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    for(auto orientation : {MATREC_STREAM_COLUMNS,MATREC_STREAM_ROWS}){
+        FILE * file = writeTestCase(testCase,orientation == MATREC_STREAM_COLUMNS);
+        MATRECsetMemoryLimit(env,40000);
+        MATRECStreamResult result;
+        MATRECNetworkDecomposition * dec = NULL;
+        EXPECT_EQ(MATRECNetworkStreamRecognize(env,file,orientation,4,&result,&dec),MATREC_ERROR_MEMORY);
+        fclose(file);
+        EXPECT_GT(result.numAdded,0);
+        EXPECT_EQ(dec,nullptr);
+        EXPECT_EQ(MATRECmemoryInUse(env),0);
+        MATRECsetMemoryLimit(env,0);
+    }
+    MATRECfreeEnvironment(&env);
+}
@@ -219,7 +219,7 @@ DirectedTestCase stringToDirectedTestCase(std::string mat, uint64_t rows, uint64
     for(const auto& string : splitString){
         double value = std::stod(string);
         if(value != 0.0){
-            buffer.push_back(Nonzero{.index = column,.value = value});
+            buffer.push_back(Nonzero{.index = MATREC_matrix_size(column),.value = value});
         }
         ++column;
         if(column == cols){
@@ -248,7 +248,7 @@ DirectedTestCase seedToDirectedTestCase(std::size_t seed, uint64_t rows, uint64_
             int x = dist(gen);
 //            std::cout<<x<<" ";
             if( x == 0) continue;
-            buffer.push_back(Nonzero{.index = j, .value = double(x)});
+            buffer.push_back(Nonzero{.index = MATREC_matrix_size(j), .value = double(x)});
         }
 //        std::cout<<"\"\n";
         matrix.push_back(buffer);
@@ -265,7 +265,7 @@ DirectedColTestCase::DirectedColTestCase(const DirectedTestCase &testCase) :  ro
                                                                               matrix(testCase.cols,std::vector<Nonzero>()){
     for(std::size_t row = 0; row < testCase.rows; ++row){
         for(auto nonzero : testCase.matrix[row]){
-            matrix[nonzero.index].push_back(Nonzero{.index = row, .value = nonzero.value});
+            matrix[nonzero.index].push_back(Nonzero{.index = MATREC_matrix_size(row), .value = nonzero.value});
         }
     }
 }
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "TestHelpers.h"
+#include <matrec/Trace.h>
+#include <matrec/Network.h>
+#include <matrec/Graphic.h>
+
+static std::vector<unsigned char> readAll(FILE * file){
+    rewind(file);
+    std::vector<unsigned char> bytes;
+    int read;
+    while((read = getc(file)) != EOF){
+        bytes.push_back((unsigned char) read);
+    }
+    rewind(file);
+    return bytes;
+}
+
+///Adds the columns of the matrix to a network decomposition, and then resets it and adds the rows of the matrix
+static void addNetwork(MATREC * env, const DirectedTestCase & testCase, std::size_t & numChecks){
+    DirectedColTestCase colTestCase(testCase);
+    MATRECNetworkDecomposition * dec = NULL;
+    ASSERT_EQ(MATRECNetworkDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+    MATRECNetworkDecompositionSetAutoFlatten(dec,2.0);
+    MATRECNetworkColumnAddition * newCol = NULL;
+    ASSERT_EQ(MATRECcreateNetworkColumnAddition(env,&newCol),MATREC_OKAY);
+    for(std::size_t column = 0; column < colTestCase.cols; ++column){
+        std::vector<MATREC_row> rows;
+        std::vector<double> values;
+        for(const auto & nonzero : colTestCase.matrix[column]){
+            rows.push_back(nonzero.index);
+            values.push_back(nonzero.value);
+        }
+        ASSERT_EQ(MATRECNetworkColumnAdditionCheck(dec,newCol,column,rows.data(),values.data(),rows.size()),MATREC_OKAY);
+        ++numChecks;
+        if(MATRECNetworkColumnAdditionRemainsNetwork(newCol)){
+            ASSERT_EQ(MATRECNetworkColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+        }
+    }
+    MATRECNetworkDecompositionFlatten(dec);
+    MATRECfreeNetworkColumnAddition(env,&newCol);
+    MATRECNetworkDecompositionReset(dec);
+
+    MATRECNetworkRowAddition * newRow = NULL;
+    ASSERT_EQ(MATRECcreateNetworkRowAddition(env,&newRow),MATREC_OKAY);
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        std::vector<MATREC_col> columns;
+        std::vector<int8_t> signs;
+        for(const auto & nonzero : testCase.matrix[row]){
+            columns.push_back(nonzero.index);
+            signs.push_back(nonzero.value < 0.0 ? -1 : 1);
+        }
+        ASSERT_EQ(MATRECNetworkRowAdditionCheckSigns(dec,newRow,row,columns.data(),signs.data(),columns.size()),
+                  MATREC_OKAY);
+        ++numChecks;
+        if(MATRECNetworkRowAdditionRemainsNetwork(newRow)){
+            ASSERT_EQ(MATRECNetworkRowAdditionAdd(dec,newRow),MATREC_OKAY);
+        }
+    }
+    MATRECfreeNetworkRowAddition(env,&newRow);
+    MATRECNetworkDecompositionFree(&dec);
+}
+
+///Adds the columns of the matrix to a graphic decomposition, and checks the rows of the matrix against another one
+static void addGraphic(MATREC * env, const TestCase & testCase, std::size_t & numChecks){
+    ColTestCase colTestCase(testCase);
+    MATRECGraphicDecomposition * dec = NULL;
+    ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&dec,testCase.rows,testCase.cols),MATREC_OKAY);
+    MATRECGraphicColumnAddition * newCol = NULL;
+    ASSERT_EQ(MATRECcreateGraphicColumnAddition(env,&newCol),MATREC_OKAY);
+    for(std::size_t column = 0; column < colTestCase.cols; ++column){
+        const auto & rows = colTestCase.matrix[column];
+        ASSERT_EQ(MATRECGraphicColumnAdditionCheck(dec,newCol,column,rows.data(),rows.size()),MATREC_OKAY);
+        ++numChecks;
+        if(MATRECGraphicColumnAdditionRemainsGraphic(newCol)){
+            ASSERT_EQ(MATRECGraphicColumnAdditionAdd(dec,newCol),MATREC_OKAY);
+        }
+    }
+    MATRECfreeGraphicColumnAddition(env,&newCol);
+
+    MATRECGraphicDecomposition * rowDec = NULL;
+    ASSERT_EQ(MATRECGraphicDecompositionCreate(env,&rowDec,testCase.rows,testCase.cols),MATREC_OKAY);
+    MATRECGraphicRowAddition * newRow = NULL;
+    ASSERT_EQ(MATRECcreateGraphicRowAddition(env,&newRow),MATREC_OKAY);
+    for(std::size_t row = 0; row < testCase.rows; ++row){
+        const auto & columns = testCase.matrix[row];
+        ASSERT_EQ(MATRECGraphicRowAdditionCheck(rowDec,newRow,row,columns.data(),columns.size()),MATREC_OKAY);
+        ++numChecks;
+        if(MATRECGraphicRowAdditionRemainsGraphic(newRow)){
+            ASSERT_EQ(MATRECGraphicRowAdditionAdd(rowDec,newRow),MATREC_OKAY);
+        }
+    }
+    MATRECfreeGraphicRowAddition(env,&newRow);
+    MATRECGraphicDecompositionFree(&rowDec);
+    MATRECGraphicDecompositionFree(&dec);
+}
+
+TEST(Trace, ReplayReproducesCalls){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    FILE * trace = tmpfile();
+    ASSERT_EQ(MATRECtraceStart(env,trace),MATREC_OKAY);
+
+    std::size_t numChecks = 0;
+    for(std::size_t seed = 0; seed < 10; ++seed){
+        addNetwork(env,erdosRenyiDirectedTestCase(20,0.3,seed),numChecks);
+        addNetwork(env,seedToDirectedTestCase(seed,7,8),numChecks);
+        addGraphic(env,createErdosRenyiTestcase(20,0.3,seed),numChecks);
+        addGraphic(env,seedToTestCase(seed,7,8),numChecks);
+    }
+    //A triangle with two row edges and a column edge
+    MATREC_matrix_size tails[3] = {0,1,0};
+    MATREC_matrix_size heads[3] = {1,2,2};
+    MATRECElement elements[3] = {{0,true},{1,true},{0,false}};
+    MATRECNetworkDecomposition * dec = NULL;
+    ASSERT_EQ(MATRECNetworkDecompositionCreateFromGraph(env,&dec,3,3,tails,heads,elements),MATREC_OKAY);
+    MATRECNetworkDecompositionFree(&dec);
+    ASSERT_EQ(MATRECtraceStop(env),MATREC_OKAY);
+
+    //Replaying the trace while recording it again must give the same trace
+    FILE * replayTrace = tmpfile();
+    ASSERT_EQ(MATRECtraceStart(env,replayTrace),MATREC_OKAY);
+    rewind(trace);
+    MATRECTraceStatistics statistics;
+    ASSERT_EQ(MATRECtraceReplay(env,trace,NULL,&statistics),MATREC_OKAY);
+    ASSERT_EQ(MATRECtraceStop(env),MATREC_OKAY);
+    EXPECT_EQ(statistics.numMismatches,0);
+    EXPECT_EQ(statistics.numCalls[MATREC_TRACE_COLUMN_CHECK] + statistics.numCalls[MATREC_TRACE_ROW_CHECK],numChecks);
+    EXPECT_EQ(statistics.numCalls[MATREC_TRACE_NETWORK_CREATE],20);
+    EXPECT_EQ(statistics.numCalls[MATREC_TRACE_GRAPHIC_CREATE],40);
+    EXPECT_EQ(statistics.numCalls[MATREC_TRACE_NETWORK_CREATE_FROM_GRAPH],1);
+    EXPECT_EQ(statistics.numCalls[MATREC_TRACE_FREE],61);
+    EXPECT_EQ(statistics.numCalls[MATREC_TRACE_RESET],20);
+    EXPECT_GT(statistics.numCalls[MATREC_TRACE_COLUMN_ADD],0);
+    EXPECT_GT(statistics.numCalls[MATREC_TRACE_ROW_ADD],0);
+    EXPECT_EQ(readAll(trace),readAll(replayTrace));
+
+    fclose(replayTrace);
+    fclose(trace);
+    MATRECfreeEnvironment(&env);
+}
+
+TEST(Trace, InvalidTrace){
+    MATREC * env = NULL;
+    ASSERT_EQ(MATRECcreateEnvironment(&env),MATREC_OKAY);
+    MATRECTraceStatistics statistics;
+
+    std::string notATrace = "MATRECXX";
+    FILE * file = fmemopen(notATrace.data(),notATrace.size(),"rb");
+    EXPECT_EQ(MATRECtraceReplay(env,file,NULL,&statistics),MATREC_ERROR_INPUT);
+    fclose(file);
+
+    //A trace which is cut off in the middle of a record
+    FILE * trace = tmpfile();
+    ASSERT_EQ(MATRECtraceStart(env,trace),MATREC_OKAY);
+    std::size_t numChecks = 0;
+    addNetwork(env,erdosRenyiDirectedTestCase(10,0.3,1),numChecks);
+    ASSERT_EQ(MATRECtraceStop(env),MATREC_OKAY);
+    std::vector<unsigned char> bytes = readAll(trace);
+    fclose(trace);
+    ASSERT_GT(bytes.size(),20);
+    file = fmemopen(bytes.data(),bytes.size() - 3,"rb");
+    EXPECT_EQ(MATRECtraceReplay(env,file,NULL,&statistics),MATREC_ERROR_INPUT);
+    fclose(file);
+
+    MATRECfreeEnvironment(&env);
+}
@@ -0,0 +1,56 @@
+#include <matrec/Trace.h>
+
+///Replays a trace which was recorded with MATRECtraceStart(), and prints the time spent in each type of call.
+///If a second file is given, the time of every call is written to it as CSV.
+int main(int argc, char ** argv){
+    if(argc < 2 || argc > 3){
+        fprintf(stderr, "Usage: %s TRACE [CALL_TIMES_CSV]\n", argv[0]);
+        return 2;
+    }
+    FILE * trace = fopen(argv[1], "rb");
+    if(!trace){
+        fprintf(stderr, "Could not open trace %s\n", argv[1]);
+        return 2;
+    }
+    FILE * callTimes = NULL;
+    if(argc == 3){
+        callTimes = fopen(argv[2], "w");
+        if(!callTimes){
+            fprintf(stderr, "Could not open %s\n", argv[2]);
+            fclose(trace);
+            return 2;
+        }
+        fprintf(callTimes, "call,seconds\n");
+    }
+
+    MATREC * env = NULL;
+    MATRECTraceStatistics statistics;
+    MATREC_ERROR error = MATRECcreateEnvironment(&env);
+    if(error == MATREC_OKAY){
+        error = MATRECtraceReplay(env, trace, callTimes, &statistics);
+        MATRECfreeEnvironment(&env);
+    }
+    fclose(trace);
+    if(callTimes){
+        fclose(callTimes);
+    }
+    if(error != MATREC_OKAY){
+        fprintf(stderr, "Replaying %s failed with error %d\n", argv[1], (int) error);
+        return 1;
+    }
+
+    printf("%-26s %10s %14s %14s %14s\n", "call", "count", "total (s)", "mean (us)", "max (us)");
+    for (int i = 0; i < MATREC_TRACE_NUM_CALLS; ++i) {
+        if(statistics.numCalls[i] == 0){
+            continue;
+        }
+        printf("%-26s %10zu %14.6f %14.3f %14.3f\n", MATRECtraceCallName((MATRECTraceCall) i), statistics.numCalls[i],
+               statistics.totalSeconds[i], 1e6 * statistics.totalSeconds[i] / (double) statistics.numCalls[i],
+               1e6 * statistics.maxSeconds[i]);
+    }
+    if(statistics.numMismatches > 0){
+        printf("%zu checks had a different outcome than in the trace\n", statistics.numMismatches);
+        return 1;
+    }
+    return 0;
+}